@@ -43,6 +43,7 @@ int bench_baseline_save(const char *dir, const bench_result_t *result)
         case BENCH_WL_006: wl_name = "WL-006"; break;
         case BENCH_WL_007: wl_name = "WL-007"; break;
         case BENCH_WL_008: wl_name = "WL-008"; break;
+        case BENCH_WL_009: wl_name = "WL-009"; break;
         default: break;
     }
 
@@ -319,6 +319,65 @@ static void gen_mixed(bench_corpus_t *c)
     }
 }
 
+/* =========================================================================
+ * WL-009 — Phase Drift (128 bytes)
+ *
+ * A 128-byte game packet whose content follows the session phase, which
+ * changes every WL009_PHASE_LEN packets:
+ *   lobby    — idle state plus chat text
+ *   combat   — the WL-002 game-state layout
+ *   looting  — dense inventory item ids
+ *   spectate — camera transform, everything else zero
+ * Each phase has its own byte distribution, so a model trained on the mix
+ * or learned during one phase fits the next one poorly; an adaptive
+ * context has to track the drift.  Not part of the RFC-002 set.
+ * ========================================================================= */
+#define WL009_PHASE_LEN 4096u
+
+static void gen_drift(bench_corpus_t *c)
+{
+    uint8_t *p = c->packet;
+    uint32_t phase = (uint32_t)((c->pkt_index / WL009_PHASE_LEN) % 4u);
+
+    if (phase == 1) {
+        gen_game_state(c, 128);
+        return;
+    }
+
+    memset(p, 0, 128);
+    uint32_t player_id = sm64_range(&c->rng, 1, 1000);
+    memcpy(p + 0, &player_id, 4);
+    uint32_t seq = (uint32_t)(c->pkt_index & 0x00FFFFFFu);
+    memcpy(p + 4, &seq, 4);
+
+    if (phase == 0) {
+        /* lobby: ready flag, team, then lower-case chat */
+        p[8] = (uint8_t)sm64_range(&c->rng, 0, 1);
+        p[9] = (uint8_t)sm64_range(&c->rng, 0, 3);
+        uint32_t len = sm64_range(&c->rng, 8, 100);
+        for (uint32_t i = 0; i < len; i++) {
+            p[16 + i] = (sm64_range(&c->rng, 0, 5) == 0)
+                      ? (uint8_t)' ' : (uint8_t)sm64_range(&c->rng, 'a', 'z');
+        }
+    } else if (phase == 2) {
+        /* looting: 56 item ids, mostly from a small pool */
+        for (int i = 0; i < 56; i++) {
+            uint16_t item = (uint16_t)(sm64_range(&c->rng, 0, 3) == 0
+                                       ? sm64_range(&c->rng, 1, 4000)
+                                       : sm64_range(&c->rng, 200, 263));
+            memcpy(p + 16 + i * 2, &item, 2);
+        }
+    } else {
+        /* spectate: camera position and yaw/pitch only */
+        float cam[5];
+        for (int i = 0; i < 5; i++) {
+            cam[i] = (float)((sm64_f64(&c->rng) - 0.5) * 2000.0);
+        }
+        memcpy(p + 16, cam, sizeof(cam));
+    }
+    c->pkt_len = 128;
+}
+
 /* =========================================================================
  * Public API
  * ========================================================================= */
@@ -352,10 +411,12 @@ size_t bench_corpus_next(bench_corpus_t *c)
         case BENCH_WL_006: gen_random(c);          break;
         case BENCH_WL_007: gen_repetitive(c);      break;
         case BENCH_WL_008: gen_mixed(c);           break;
+        case BENCH_WL_009: gen_drift(c);           break;
         default:
             c->pkt_len = 0;
             break;
     }
+    c->pkt_index++;
     return c->pkt_len;
 }
 
@@ -383,6 +444,7 @@ const char *bench_workload_name(bench_workload_t wl)
         case BENCH_WL_006: return "WL-006 Random 128B";
         case BENCH_WL_007: return "WL-007 Repetitive 128B";
         case BENCH_WL_008: return "WL-008 Mixed Traffic";
+        case BENCH_WL_009: return "WL-009 Phase Drift 128B";
         default:           return "WL-??? Unknown";
     }
 }
@@ -398,6 +460,7 @@ size_t bench_workload_pkt_size(bench_workload_t wl)
         case BENCH_WL_006: return 128;
         case BENCH_WL_007: return 128;
         case BENCH_WL_008: return 0;   /* variable */
+        case BENCH_WL_009: return 128;
         default:           return 0;
     }
 }
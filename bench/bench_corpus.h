@@ -1,7 +1,8 @@
 /**
  * bench_corpus.h — Deterministic workload corpus generators.
  *
- * Implements WL-001 through WL-008 per RFC-002 §3.
+ * Implements WL-001 through WL-008 per RFC-002 §3, plus the opt-in WL-009
+ * (a distribution that drifts over the session, for adaptive mode).
  * All generators are seeded with a uint64_t seed so that the same seed
  * produces byte-for-byte identical packet sequences across runs.
  *
@@ -39,6 +40,7 @@ typedef enum {
     BENCH_WL_006 = 6,   /* Random 128 B     — entropy ~8 bits/byte    */
     BENCH_WL_007 = 7,   /* Repetitive 128 B — entropy ~0.5 bits/byte  */
     BENCH_WL_008 = 8,   /* Mixed traffic 32–512 B, weighted           */
+    BENCH_WL_009 = 9,   /* Phase drift 128 B — distribution shifts (opt-in) */
     BENCH_WL_ALL = 0,   /* Sentinel (run all workloads)               */
 } bench_workload_t;
 
@@ -65,6 +67,9 @@ typedef struct {
 
     /* Simulated moving-average price for WL-004 */
     double           wl004_price;
+
+    /* Packets generated so far (WL-009 session phase) */
+    uint64_t         pkt_index;
 } bench_corpus_t;
 
 /* =========================================================================
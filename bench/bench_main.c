@@ -3,9 +3,14 @@
  *
  * Usage: bench [OPTIONS]
  *
- *   --workload=WL-001..008         Run specific workload(s) (default: all)
+ *   --workload=WL-001..009         Run specific workload(s) (default: WL-001..008)
  *   --compressor=NAME              Select compressor(s) (default: netc)
- *   --mode=latency|throughput|mpps|scaling  Benchmark mode (default: latency)
+ *   --mode=latency|throughput|mpps|scaling|batch|levels|simd|rans|conns|storm|train|tail|lzp  Benchmark mode (default: latency)
+ *   --level=N                      netc compression level 0..9 (default: 5)
+ *   --batch=N                      Packets per batch call in batch mode (default: 64)
+ *   --frame=N                      Frame size in simd/rans mode (default: 4096)
+ *   --conns=N                      Connections in conns/storm mode (default: 256)
+ *   --threads=N                    Max training threads in train mode (default: 8)
  *   --count=N                      Measurement iterations (default: 100000)
  *   --warmup=N                     Warmup iterations (default: 1000)
  *   --seed=N                       PRNG seed (default: 42)
@@ -70,6 +75,15 @@ typedef enum {
     BENCH_MODE_THROUGHPUT = 1,  /* sustained MB/s */
     BENCH_MODE_MPPS       = 2,  /* millions of packets per second */
     BENCH_MODE_SCALING    = 3,  /* multi-core scaling */
+    BENCH_MODE_BATCH      = 4,  /* netc batch API vs per-call Mpps */
+    BENCH_MODE_LEVELS     = 5,  /* netc compression level sweep 0..9 */
+    BENCH_MODE_SIMD       = 6,  /* netc wide-frame MB/s per SIMD level */
+    BENCH_MODE_RANS       = 7,  /* static rANS vs tANS PCTX entropy stage */
+    BENCH_MODE_CONNS      = 8,  /* many contexts on one thread, shared scratch */
+    BENCH_MODE_STORM      = 9,  /* adaptive context creation time and RSS */
+    BENCH_MODE_TRAIN      = 10, /* netc_dict_train_ex thread scaling */
+    BENCH_MODE_TAIL       = 11, /* adaptive per-packet latency tail */
+    BENCH_MODE_LZP        = 12, /* LZP table layouts: cache lines and misses */
 } bench_mode_t;
 
 typedef struct {
@@ -84,6 +98,11 @@ typedef struct {
     size_t   warmup;
     uint64_t seed;
     size_t   train_count;
+    size_t   batch_size;
+    size_t   frame_size;
+    size_t   conns;
+    uint32_t threads;
+    uint8_t  level;
 
     bench_format_t format;
     const char    *output_file;
@@ -94,6 +113,9 @@ typedef struct {
     int compact_hdr;
     int fast_compress;
     int adaptive;
+    int delta_refs;
+    int loss_pct;           /* -1 = acked-baseline mode off */
+    uint8_t decay;          /* netc_cfg_t.adaptive_decay (0 = default) */
     uint8_t simd_level;
 
     /* Baseline options */
@@ -114,10 +136,17 @@ static void usage(const char *prog)
         "Usage: %s [OPTIONS]\n"
         "\n"
         "Options:\n"
-        "  --workload=WL-NNN         Run workload(s); may repeat (default: all)\n"
+        "  --workload=WL-NNN         Run workload(s); may repeat (default: WL-001..008)\n"
         "  --compressor=NAME         netc|zlib-1|zlib-6|lz4|lz4-hc|zstd-1|zstd-3|\n"
         "                              zstd-1-dict|huffman|snappy|oodle-udp|oodle-tcp|all\n"
-        "  --mode=MODE               latency|throughput|mpps|scaling [default: latency]\n"
+        "  --mode=MODE               latency|throughput|mpps|scaling|batch|levels|simd|rans|\n"
+        "                              conns|storm|train|tail|lzp\n"
+        "                              [default: latency]\n"
+        "  --level=N                 netc compression level 0..9 [default: %u]\n"
+        "  --batch=N                 Packets per batch call in batch mode [default: %u]\n"
+        "  --frame=N                 Frame size in simd/rans mode [default: %u]\n"
+        "  --conns=N                 Connections in conns/storm mode [default: %u]\n"
+        "  --threads=N               Max training threads in train mode [default: %u]\n"
         "  --count=N                 Measurement iterations [default: %u]\n"
         "  --warmup=N                Warmup iterations [default: %u]\n"
         "  --seed=N                  PRNG seed [default: %u]\n"
@@ -129,6 +158,9 @@ static void usage(const char *prog)
         "  --no-delta                Disable delta encoding (netc only)\n"
         "  --compact-hdr             Use compact packet headers (netc only)\n"
         "  --fast                    Speed mode: skip trial passes, ~2-5%% ratio cost (netc only)\n"
+        "  --delta-refs              Delta from the best of the last 8 packets (netc only)\n"
+        "  --decay=N                 Adaptive count decay 1..15, 255=none [default: %u]\n"
+        "  --loss=PCT                Acked-baseline delta, PCT%% of acks lost (netc only)\n"
         "  --simd=LEVEL              auto|generic|sse42|avx2 [default: auto]\n"
         "  --baseline-dir=DIR        Directory for baseline JSON files\n"
         "  --save-baseline           Save results as new baseline\n"
@@ -140,10 +172,16 @@ static void usage(const char *prog)
         "  --help                    Show this help\n"
         "\n",
         prog,
+        (unsigned)BENCH_NETC_DEFAULT_LEVEL,
+        (unsigned)BENCH_DEFAULT_BATCH,
+        (unsigned)BENCH_DEFAULT_FRAME,
+        (unsigned)BENCH_DEFAULT_CONNS,
+        (unsigned)BENCH_DEFAULT_THREADS,
         (unsigned)BENCH_DEFAULT_COUNT,
         (unsigned)BENCH_DEFAULT_WARMUP,
         (unsigned)BENCH_DEFAULT_SEED,
-        (unsigned)BENCH_CORPUS_TRAIN_N);
+        (unsigned)BENCH_CORPUS_TRAIN_N,
+        (unsigned)NETC_ADAPTIVE_DECAY_DEFAULT);
 }
 
 static bench_workload_t parse_workload(const char *s)
@@ -153,7 +191,7 @@ static bench_workload_t parse_workload(const char *s)
     const char *p = s;
     if (strncmp(p, "WL-", 3) == 0) p += 3;
     int n = atoi(p);
-    if (n >= 1 && n <= 8) return (bench_workload_t)n;
+    if (n >= 1 && n <= (int)BENCH_WL_009) return (bench_workload_t)n;
     return BENCH_WL_ALL;
 }
 
@@ -172,6 +210,15 @@ static bench_mode_t parse_mode(const char *s)
     if (       strcmp(s, "throughput") == 0) return BENCH_MODE_THROUGHPUT;
     if (       strcmp(s, "mpps")      == 0) return BENCH_MODE_MPPS;
     if (       strcmp(s, "scaling")   == 0) return BENCH_MODE_SCALING;
+    if (       strcmp(s, "batch")     == 0) return BENCH_MODE_BATCH;
+    if (       strcmp(s, "levels")    == 0) return BENCH_MODE_LEVELS;
+    if (       strcmp(s, "simd")      == 0) return BENCH_MODE_SIMD;
+    if (       strcmp(s, "rans")      == 0) return BENCH_MODE_RANS;
+    if (       strcmp(s, "conns")     == 0) return BENCH_MODE_CONNS;
+    if (       strcmp(s, "storm")     == 0) return BENCH_MODE_STORM;
+    if (       strcmp(s, "train")     == 0) return BENCH_MODE_TRAIN;
+    if (       strcmp(s, "tail")      == 0) return BENCH_MODE_TAIL;
+    if (       strcmp(s, "lzp")       == 0) return BENCH_MODE_LZP;
     return BENCH_MODE_LATENCY;
 }
 
@@ -200,10 +247,16 @@ static int parse_args(int argc, char **argv, bench_args_t *a)
     a->warmup         = BENCH_DEFAULT_WARMUP;
     a->seed           = BENCH_DEFAULT_SEED;
     a->train_count    = BENCH_CORPUS_TRAIN_N;
+    a->batch_size     = BENCH_DEFAULT_BATCH;
+    a->frame_size     = BENCH_DEFAULT_FRAME;
+    a->conns          = BENCH_DEFAULT_CONNS;
+    a->threads        = BENCH_DEFAULT_THREADS;
+    a->level          = BENCH_NETC_DEFAULT_LEVEL;
     a->workload_mask  = 0;   /* 0 = all */
     a->compressor_mask = 0;  /* 0 → default to netc only */
     a->mode           = BENCH_MODE_LATENCY;
     a->oodle_htbits   = 17;
+    a->loss_pct       = -1;
 
     for (int i = 1; i < argc; i++) {
         const char *arg = argv[i];
@@ -218,6 +271,7 @@ static int parse_args(int argc, char **argv, bench_args_t *a)
         if (strcmp(arg, "--compact-hdr")    == 0) { a->compact_hdr    = 1; continue; }
         if (strcmp(arg, "--fast")           == 0) { a->fast_compress  = 1; continue; }
         if (strcmp(arg, "--adaptive")       == 0) { a->adaptive       = 1; continue; }
+        if (strcmp(arg, "--delta-refs")     == 0) { a->delta_refs     = 1; continue; }
         if (strcmp(arg, "--save-baseline")  == 0) { a->save_baseline  = 1; continue; }
         if (strcmp(arg, "--check-baseline") == 0) { a->check_baseline = 1; continue; }
         if (strcmp(arg, "--with-oodle")     == 0) { a->with_oodle     = 1; continue; }
@@ -255,9 +309,16 @@ static int parse_args(int argc, char **argv, bench_args_t *a)
         else if   (strcmp(key, "--warmup")       == 0) { a->warmup       = (size_t)atol(val); }
         else if   (strcmp(key, "--seed")         == 0) { a->seed         = (uint64_t)atoll(val); }
         else if   (strcmp(key, "--train")        == 0) { a->train_count  = (size_t)atol(val); }
+        else if   (strcmp(key, "--batch")        == 0) { a->batch_size   = (size_t)atol(val); }
+        else if   (strcmp(key, "--frame")        == 0) { a->frame_size   = (size_t)atol(val); }
+        else if   (strcmp(key, "--conns")        == 0) { a->conns        = (size_t)atol(val); }
+        else if   (strcmp(key, "--threads")      == 0) { a->threads      = (uint32_t)atoi(val); }
+        else if   (strcmp(key, "--level")        == 0) { a->level        = (uint8_t)atoi(val); }
         else if   (strcmp(key, "--format")       == 0) { a->format       = bench_format_parse(val); }
         else if   (strcmp(key, "--output")       == 0) { a->output_file  = val; }
         else if   (strcmp(key, "--simd")         == 0) { a->simd_level   = parse_simd(val); }
+        else if   (strcmp(key, "--loss")         == 0) { a->loss_pct     = atoi(val); }
+        else if   (strcmp(key, "--decay")        == 0) { a->decay        = (uint8_t)atoi(val); }
         else if   (strcmp(key, "--baseline-dir") == 0) { a->baseline_dir = val; }
         else if   (strcmp(key, "--oodle-sdk")    == 0) { a->oodle_sdk    = val; }
         else if   (strcmp(key, "--oodle-htbits") == 0) { a->oodle_htbits = atoi(val); }
@@ -269,6 +330,7 @@ static int parse_args(int argc, char **argv, bench_args_t *a)
 
     /* Defaults */
     if (a->workload_mask  == 0) {
+        /* RFC-002 set only: WL-009 must be asked for */
         for (int w = 1; w <= 8; w++) a->workload_mask |= (1u << (unsigned)w);
     }
     if (a->compressor_mask == 0) a->compressor_mask = BENCH_COMP_NETC;
@@ -383,6 +445,8 @@ int main(int argc, char **argv)
     if (args.compact_hdr)  flags |= NETC_CFG_FLAG_COMPACT_HDR;
     if (args.fast_compress) flags |= NETC_CFG_FLAG_FAST_COMPRESS;
     if (args.adaptive)      flags |= NETC_CFG_FLAG_ADAPTIVE;
+    if (args.delta_refs)    flags |= NETC_CFG_FLAG_DELTA_REFS;
+    if (args.loss_pct >= 0) flags |= NETC_CFG_FLAG_BASELINE;
 
     /* Allocate result storage */
     bench_result_t *results = (bench_result_t *)calloc(BENCH_MAX_RESULTS,
@@ -395,12 +459,55 @@ int main(int argc, char **argv)
     memset(&netc_wl001, 0, sizeof(netc_wl001));
     int            have_netc_wl001 = 0;
 
-    for (int wl_id = 1; wl_id <= 8; wl_id++) {
+    for (int wl_id = 1; wl_id <= (int)BENCH_WL_009; wl_id++) {
         if (!(args.workload_mask & (1u << (unsigned)wl_id))) continue;
         bench_workload_t wl = (bench_workload_t)wl_id;
         fprintf(stderr, "=== %s ===\n", bench_workload_name(wl));
 
         /* --- netc --- */
+        if ((args.compressor_mask & BENCH_COMP_NETC) &&
+            args.mode == BENCH_MODE_SIMD) {
+            /* SIMD comparison trains its own dict on wide frames */
+            bench_throughput_cfg_t tcfg;
+            tcfg.warmup = args.warmup;
+            tcfg.count  = args.count;
+            tcfg.seed   = args.seed;
+            bench_simd_result_t sr;
+            if (bench_simd_run(&tcfg, wl, flags, args.frame_size, &sr) == 0) {
+                bench_simd_print(&sr);
+            } else {
+                fprintf(stderr, "  [netc] FAILED (simd) on %s\n",
+                        bench_workload_name(wl));
+            }
+            continue;  /* simd mode is netc-only */
+        }
+        if ((args.compressor_mask & BENCH_COMP_NETC) &&
+            args.mode == BENCH_MODE_RANS) {
+            bench_throughput_cfg_t tcfg;
+            tcfg.warmup = args.warmup;
+            tcfg.count  = args.count;
+            tcfg.seed   = args.seed;
+            bench_rans_result_t rr;
+            if (bench_rans_run(&tcfg, wl, args.frame_size, &rr) == 0) {
+                bench_rans_print(&rr);
+            } else {
+                fprintf(stderr, "  [netc] FAILED (rans) on %s\n",
+                        bench_workload_name(wl));
+            }
+            continue;  /* rans mode is netc-only */
+        }
+        if ((args.compressor_mask & BENCH_COMP_NETC) &&
+            args.mode == BENCH_MODE_TRAIN) {
+            bench_train_result_t tr;
+            if (bench_train_run(wl, args.seed, args.train_count,
+                                args.threads, &tr) == 0) {
+                bench_train_print(&tr);
+            } else {
+                fprintf(stderr, "  [netc] FAILED (train) on %s\n",
+                        bench_workload_name(wl));
+            }
+            continue;  /* train mode is netc-only */
+        }
         if (args.compressor_mask & BENCH_COMP_NETC) {
             bench_netc_t netc_adapter;
             if (bench_netc_init(&netc_adapter, NULL, flags, args.simd_level,
@@ -411,6 +518,114 @@ int main(int argc, char **argv)
                             args.train_count);
                     bench_netc_train(&netc_adapter, wl, args.seed, args.train_count);
                 }
+                if (args.level != BENCH_NETC_DEFAULT_LEVEL)
+                    bench_netc_set_level(&netc_adapter, args.level);
+                if (args.loss_pct >= 0)
+                    bench_netc_set_loss(&netc_adapter, (uint32_t)args.loss_pct);
+                if (args.decay != 0)
+                    bench_netc_set_decay(&netc_adapter, args.decay);
+
+                if (args.mode == BENCH_MODE_LEVELS) {
+                    /* Sweep every level on the same trained dictionary:
+                     * one reporter row per level (ratio vs c.MB/s). */
+                    bench_run_cfg_t rcfg = { args.warmup, args.count, args.seed };
+                    for (uint8_t lvl = 0; lvl <= 9; lvl++) {
+                        if (bench_netc_set_level(&netc_adapter, lvl) != 0) break;
+                        bench_result_t res;
+                        memset(&res, 0, sizeof(res));
+                        if (bench_run(&rcfg, wl, &netc_adapter, &res) == 0) {
+                            bench_reporter_write(reporter, &res);
+                        } else {
+                            fprintf(stderr, "  [netc] FAILED (level %u) on %s\n",
+                                    (unsigned)lvl, bench_workload_name(wl));
+                        }
+                    }
+                    bench_netc_destroy(&netc_adapter);
+                    continue;  /* level sweep is netc-only */
+                }
+
+                if (args.mode == BENCH_MODE_BATCH) {
+                    bench_throughput_cfg_t tcfg;
+                    tcfg.warmup = args.warmup;
+                    tcfg.count  = args.count;
+                    tcfg.seed   = args.seed;
+                    bench_batch_result_t br;
+                    if (bench_batch_run(&tcfg, wl, &netc_adapter,
+                                        args.batch_size, &br) == 0) {
+                        bench_batch_print(&br);
+                    } else {
+                        fprintf(stderr, "  [netc] FAILED (batch) on %s\n",
+                                bench_workload_name(wl));
+                    }
+                    bench_netc_destroy(&netc_adapter);
+                    continue;  /* batch mode is netc-only */
+                }
+
+                if (args.mode == BENCH_MODE_CONNS) {
+                    bench_throughput_cfg_t tcfg;
+                    tcfg.warmup = args.warmup;
+                    tcfg.count  = args.count;
+                    tcfg.seed   = args.seed;
+                    bench_conns_result_t cr;
+                    if (bench_conns_run(&tcfg, wl, &netc_adapter,
+                                        args.conns, &cr) == 0) {
+                        bench_conns_print(&cr);
+                    } else {
+                        fprintf(stderr, "  [netc] FAILED (conns) on %s\n",
+                                bench_workload_name(wl));
+                    }
+                    bench_netc_destroy(&netc_adapter);
+                    continue;  /* conns mode is netc-only */
+                }
+
+                if (args.mode == BENCH_MODE_TAIL) {
+                    bench_throughput_cfg_t tcfg;
+                    tcfg.warmup = args.warmup;
+                    tcfg.count  = args.count;
+                    tcfg.seed   = args.seed;
+                    bench_tail_result_t tr;
+                    if (bench_tail_run(&tcfg, wl, &netc_adapter, &tr) == 0) {
+                        bench_tail_print(&tr);
+                    } else {
+                        fprintf(stderr, "  [netc] FAILED (tail) on %s\n",
+                                bench_workload_name(wl));
+                    }
+                    bench_netc_destroy(&netc_adapter);
+                    continue;  /* tail mode is netc-only */
+                }
+
+                if (args.mode == BENCH_MODE_LZP) {
+                    bench_throughput_cfg_t tcfg;
+                    tcfg.warmup = args.warmup;
+                    tcfg.count  = args.count;
+                    tcfg.seed   = args.seed;
+                    bench_lzp_result_t lr;
+                    if (bench_lzp_run(&tcfg, wl, &netc_adapter, &lr) == 0) {
+                        bench_lzp_print(&lr);
+                    } else {
+                        fprintf(stderr, "  [netc] FAILED (lzp) on %s\n",
+                                bench_workload_name(wl));
+                    }
+                    bench_netc_destroy(&netc_adapter);
+                    continue;  /* lzp mode is netc-only */
+                }
+
+                if (args.mode == BENCH_MODE_STORM) {
+                    bench_throughput_cfg_t tcfg;
+                    tcfg.warmup = args.warmup;
+                    tcfg.count  = args.count;
+                    tcfg.seed   = args.seed;
+                    bench_storm_result_t sr;
+                    if (bench_storm_run(&tcfg, wl, &netc_adapter,
+                                        args.conns, &sr) == 0) {
+                        bench_storm_print(&sr);
+                    } else {
+                        fprintf(stderr, "  [netc] FAILED (storm) on %s\n",
+                                bench_workload_name(wl));
+                    }
+                    bench_netc_destroy(&netc_adapter);
+                    continue;  /* storm mode is netc-only */
+                }
 
                 bench_run_cfg_t rcfg = { args.warmup, args.count, args.seed };
                 bench_result_t res;
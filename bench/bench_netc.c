@@ -20,8 +20,10 @@ static int create_ctx_pair(bench_netc_t *n)
 {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
-    cfg.flags      = n->flags;
-    cfg.simd_level = n->simd_level;
+    cfg.flags             = n->flags;
+    cfg.simd_level        = n->simd_level;
+    cfg.compression_level = n->level;
+    cfg.adaptive_decay    = n->decay;
 
     n->enc_ctx = netc_ctx_create(n->dict, &cfg);
     n->dec_ctx = netc_ctx_create(n->dict, &cfg);
@@ -33,6 +35,35 @@ static int create_ctx_pair(bench_netc_t *n)
     return 0;
 }
 
+/* =========================================================================
+ * Internal: build human-readable config name
+ *
+ * Uses the actual detected SIMD level, not the configured value.  The level
+ * suffix is omitted at the default level so baseline names stay stable.
+ * ========================================================================= */
+static void build_name(bench_netc_t *n)
+{
+    const char *mode  = n->stateless ? "stateless" : "stateful";
+    const char *delta = (n->flags & NETC_CFG_FLAG_DELTA) ? "+delta" : "";
+    const char *dct   = n->dict ? "+dict" : "";
+    const char *fast  = (n->flags & NETC_CFG_FLAG_FAST_COMPRESS) ? " fast=1" : "";
+    const char *adapt = (n->flags & NETC_CFG_FLAG_ADAPTIVE) ? "+adaptive" : "";
+    const char *acked = (n->flags & NETC_CFG_FLAG_BASELINE) ? "+acked" : "";
+    uint8_t     det   = n->enc_ctx ? netc_ctx_simd_level(n->enc_ctx) : n->simd_level;
+    char        lvl[32] = "";
+    char        loss[24] = "";
+    if (n->level != BENCH_NETC_DEFAULT_LEVEL)
+        snprintf(lvl, sizeof(lvl), " level=%u", (unsigned)n->level);
+    if (n->decay != 0 && (n->flags & NETC_CFG_FLAG_ADAPTIVE))
+        snprintf(lvl + strlen(lvl), sizeof(lvl) - strlen(lvl),
+                 " decay=%u", (unsigned)n->decay);
+    if ((n->flags & NETC_CFG_FLAG_BASELINE) && n->loss_pct)
+        snprintf(loss, sizeof(loss), " loss=%u%%", (unsigned)n->loss_pct);
+    snprintf(n->name, sizeof(n->name), "netc/%s%s%s%s%s simd=%s%s%s%s",
+             mode, delta, dct, adapt, acked, netc_simd_level_name(det),
+             fast, lvl, loss);
+}
+
 /* =========================================================================
  * bench_netc_init
  * ========================================================================= */
@@ -48,6 +79,7 @@ int bench_netc_init(bench_netc_t *n,
     n->dict       = dict;
     n->flags      = flags;
     n->simd_level = simd_level;
+    n->level      = BENCH_NETC_DEFAULT_LEVEL;
     n->stateless  = (flags & NETC_CFG_FLAG_STATELESS) ? 1 : 0;
 
     /* Scratch buffer for compressed output */
@@ -66,16 +98,7 @@ int bench_netc_init(bench_netc_t *n,
         }
     }
 
-    /* Build context name — use actual detected SIMD level, not configured value */
-    const char *mode  = n->stateless ? "stateless" : "stateful";
-    const char *delta = (flags & NETC_CFG_FLAG_DELTA) ? "+delta" : "";
-    const char *dct   = dict ? "+dict" : "";
-    const char *fast  = (flags & NETC_CFG_FLAG_FAST_COMPRESS) ? " fast=1" : "";
-    const char *adapt = (flags & NETC_CFG_FLAG_ADAPTIVE) ? "+adaptive" : "";
-    uint8_t     det   = n->enc_ctx ? netc_ctx_simd_level(n->enc_ctx) : simd_level;
-    snprintf(n->name, sizeof(n->name), "netc/%s%s%s%s simd=%s%s",
-             mode, delta, dct, adapt, netc_simd_level_name(det), fast);
-
+    build_name(n);
     return 0;
 }
 
@@ -123,18 +146,54 @@ int bench_netc_train(bench_netc_t *n,
         if (create_ctx_pair(n) != 0) return -1;
     }
 
-    /* Update name to reflect dict — use actual detected SIMD level */
-    const char *mode  = n->stateless ? "stateless" : "stateful";
-    const char *delta = (n->flags & NETC_CFG_FLAG_DELTA) ? "+delta" : "";
-    const char *fast  = (n->flags & NETC_CFG_FLAG_FAST_COMPRESS) ? " fast=1" : "";
-    const char *adapt = (n->flags & NETC_CFG_FLAG_ADAPTIVE) ? "+adaptive" : "";
-    uint8_t     det   = n->enc_ctx ? netc_ctx_simd_level(n->enc_ctx) : n->simd_level;
-    snprintf(n->name, sizeof(n->name), "netc/%s%s+dict%s simd=%s%s",
-             mode, delta, adapt, netc_simd_level_name(det), fast);
+    /* Update name to reflect dict */
+    build_name(n);
+    return 0;
+}
 
+/* =========================================================================
+ * bench_netc_set_level
+ * ========================================================================= */
+int bench_netc_set_level(bench_netc_t *n, uint8_t level)
+{
+    if (!n) return -1;
+    n->level = level;
+    if (!n->stateless) {
+        netc_ctx_destroy(n->enc_ctx); n->enc_ctx = NULL;
+        netc_ctx_destroy(n->dec_ctx); n->dec_ctx = NULL;
+        if (create_ctx_pair(n) != 0) return -1;
+    }
+    build_name(n);
+    return 0;
+}
+
+/* =========================================================================
+ * bench_netc_set_decay
+ * ========================================================================= */
+int bench_netc_set_decay(bench_netc_t *n, uint8_t decay)
+{
+    if (!n) return -1;
+    n->decay = decay;
+    if (!n->stateless) {
+        netc_ctx_destroy(n->enc_ctx); n->enc_ctx = NULL;
+        netc_ctx_destroy(n->dec_ctx); n->dec_ctx = NULL;
+        if (create_ctx_pair(n) != 0) return -1;
+    }
+    build_name(n);
     return 0;
 }
 
+/* =========================================================================
+ * bench_netc_set_loss
+ * ========================================================================= */
+void bench_netc_set_loss(bench_netc_t *n, uint32_t loss_pct)
+{
+    if (!n) return;
+    n->loss_pct = (loss_pct > 100u) ? 100u : loss_pct;
+    bench_netc_reset(n);
+    build_name(n);
+}
+
 /* =========================================================================
  * bench_netc_compress
  * ========================================================================= */
@@ -152,6 +211,12 @@ size_t bench_netc_compress(bench_netc_t *n,
         rc = netc_compress_stateless(n->dict, src, src_len, dst, dst_cap, &out_size);
     } else {
         if (!n->enc_ctx) return 0;
+        if (n->flags & NETC_CFG_FLAG_BASELINE) {
+            /* Deliver the ack for the packet decoded ACK_LAG packets ago */
+            size_t slot = (size_t)(n->pkt_index % BENCH_NETC_ACK_LAG);
+            if (n->ack_live[slot]) netc_ack(n->enc_ctx, n->ack_seq[slot]);
+            n->ack_live[slot] = 0;
+        }
         rc = netc_compress(n->enc_ctx, src, src_len, dst, dst_cap, &out_size);
     }
 
@@ -176,6 +241,19 @@ size_t bench_netc_decompress(bench_netc_t *n,
     } else {
         if (!n->dec_ctx) return 0;
         rc = netc_decompress(n->dec_ctx, src, src_len, dst, dst_cap, &out_size);
+        if (rc == NETC_OK && (n->flags & NETC_CFG_FLAG_BASELINE)) {
+            /* The decoder still sees "lost" packets (the runner verifies
+             * every roundtrip); only their acks are dropped, which is what
+             * the encoder observes of a loss. */
+            size_t slot = (size_t)(n->pkt_index % BENCH_NETC_ACK_LAG);
+            n->loss_rng = n->loss_rng * 6364136223846793005ULL
+                        + 1442695040888963407ULL;
+            uint32_t roll = (uint32_t)(n->loss_rng >> 33) % 100u;
+            if (roll >= n->loss_pct &&
+                netc_ctx_last_seq(n->dec_ctx, &n->ack_seq[slot]) == NETC_OK)
+                n->ack_live[slot] = 1;
+            n->pkt_index++;
+        }
     }
 
     return (rc == NETC_OK) ? out_size : 0;
@@ -189,6 +267,9 @@ void bench_netc_reset(bench_netc_t *n)
     if (!n) return;
     if (n->enc_ctx) netc_ctx_reset(n->enc_ctx);
     if (n->dec_ctx) netc_ctx_reset(n->dec_ctx);
+    n->loss_rng  = 0x9E3779B97F4A7C15ULL;
+    n->pkt_index = 0;
+    memset(n->ack_live, 0, sizeof(n->ack_live));
 }
 
 /* =========================================================================
@@ -22,6 +22,12 @@
 extern "C" {
 #endif
 
+/* Compression level used unless overridden (matches the library default) */
+#define BENCH_NETC_DEFAULT_LEVEL 5u
+
+/* Packets between a decode and its ack reaching the encoder (baseline mode) */
+#define BENCH_NETC_ACK_LAG 4u
+
 /* =========================================================================
  * Adapter handle
  * ========================================================================= */
@@ -32,11 +38,20 @@ typedef struct {
     int          stateless;
     uint32_t     flags;      /* saved cfg flags for re-init after train */
     uint8_t      simd_level;
+    uint8_t      level;      /* netc_cfg_t.compression_level (0..9) */
+    uint8_t      decay;      /* netc_cfg_t.adaptive_decay (0 = default) */
     char         name[64];   /* human-readable config string */
 
     /* Scratch buffers (allocated once at init) */
     uint8_t     *comp_buf;
     size_t       comp_buf_cap;
+
+    /* Simulated ack channel (NETC_CFG_FLAG_BASELINE only) */
+    uint32_t     loss_pct;   /* percent of packets whose ack never arrives */
+    uint64_t     loss_rng;
+    uint64_t     pkt_index;
+    uint8_t      ack_seq[BENCH_NETC_ACK_LAG];
+    uint8_t      ack_live[BENCH_NETC_ACK_LAG];
 } bench_netc_t;
 
 /* =========================================================================
@@ -65,6 +80,25 @@ int bench_netc_train(bench_netc_t *n,
                      uint64_t seed,
                      size_t train_count);
 
+/**
+ * Change the compression level and re-create the context pair.
+ * The trained dictionary is kept.
+ */
+int bench_netc_set_level(bench_netc_t *n, uint8_t level);
+
+/**
+ * Change the adaptive decay (netc_cfg_t.adaptive_decay) and re-create the
+ * context pair.  The trained dictionary is kept.
+ */
+int bench_netc_set_decay(bench_netc_t *n, uint8_t decay);
+
+/**
+ * Simulate a lossy channel in acknowledged-baseline mode: each decoded
+ * packet is acked BENCH_NETC_ACK_LAG packets later unless it falls in the
+ * loss_pct% that are dropped.  Only meaningful with NETC_CFG_FLAG_BASELINE.
+ */
+void bench_netc_set_loss(bench_netc_t *n, uint32_t loss_pct);
+
 /** Compress one packet. Returns compressed size, or 0 on error. */
 size_t bench_netc_compress(bench_netc_t *n,
                            const uint8_t *src, size_t src_len,
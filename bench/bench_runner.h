@@ -39,6 +39,10 @@ typedef struct {
 #define BENCH_DEFAULT_WARMUP  1000u
 #define BENCH_DEFAULT_COUNT   100000u
 #define BENCH_DEFAULT_SEED    42u
+#define BENCH_DEFAULT_BATCH   64u
+#define BENCH_DEFAULT_FRAME   4096u
+#define BENCH_DEFAULT_CONNS   256u
+#define BENCH_DEFAULT_THREADS 8u
 
 /* Evaluation seed offset: test packets come from seed + OFFSET so they are
  * from the same distribution but unseen during training.  This prevents
@@ -2,15 +2,27 @@
  * bench_throughput.c — Sustained throughput and Mpps benchmarks (RFC-002 §5 tasks 4.2–4.3).
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE  /* syscall() for perf_event_open */
+#endif
+
 #include "bench_throughput.h"
 #include "bench_runner.h"
 #include "bench_corpus.h"
 #include "bench_timer.h"
+#include "../src/core/netc_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
 /* Scratch buffer size — must accommodate any workload packet */
 #define SCRATCH_CAP (BENCH_CORPUS_MAX_PKT * 2u + 256u)
 
@@ -170,3 +182,1267 @@ void bench_throughput_print(const bench_throughput_result_t *r)
            r->compress_mbs,   r->compress_mpps,   r->compress_elapsed_s,
            r->decompress_mbs, r->decompress_mpps, r->decompress_elapsed_s);
 }
+
+/* =========================================================================
+ * Public: bench_batch_run
+ * ========================================================================= */
+
+int bench_batch_run(const bench_throughput_cfg_t *cfg,
+                    bench_workload_t               wl,
+                    bench_netc_t                  *n,
+                    size_t                         batch_size,
+                    bench_batch_result_t          *out)
+{
+    if (!cfg || !n || !out || n->stateless || !n->enc_ctx || !n->dec_ctx)
+        return -1;
+    if (batch_size == 0) batch_size = 1;
+
+    bench_timer_init();
+
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+
+    size_t   max_n    = cfg->count;
+    size_t   cmp_cap  = max_n * (BENCH_CORPUS_MAX_PKT + NETC_MAX_OVERHEAD);
+    uint8_t *pkt_buf  = (uint8_t *)malloc(max_n * BENCH_CORPUS_MAX_PKT);
+    uint8_t *ref_out  = (uint8_t *)malloc(cmp_cap);
+    uint8_t *bat_out  = (uint8_t *)malloc(cmp_cap);
+    uint8_t *dec_out  = (uint8_t *)malloc(max_n * BENCH_CORPUS_MAX_PKT);
+    size_t  *pkt_len  = (size_t  *)malloc(max_n * sizeof(size_t));
+    size_t  *ref_off  = (size_t  *)malloc((max_n + 1) * sizeof(size_t));
+    size_t  *bat_off  = (size_t  *)malloc((max_n + 1) * sizeof(size_t));
+    size_t  *cmp_len  = (size_t  *)malloc(max_n * sizeof(size_t));
+    const void **srcs = (const void **)malloc(max_n * sizeof(void *));
+    int rc = -1;
+
+    if (!pkt_buf || !ref_out || !bat_out || !dec_out || !pkt_len ||
+        !ref_off || !bat_off || !cmp_len || !srcs)
+        goto done;
+
+    uint64_t total_orig = 0;
+    for (size_t i = 0; i < max_n; i++) {
+        size_t plen = bench_corpus_next(&corpus);
+        if (plen == 0) plen = bench_corpus_next(&corpus);  /* retry once */
+        pkt_len[i] = plen;
+        memcpy(pkt_buf + i * BENCH_CORPUS_MAX_PKT, corpus.packet, plen);
+        srcs[i] = pkt_buf + i * BENCH_CORPUS_MAX_PKT;
+        total_orig += plen;
+    }
+
+    /* ---- Per-call compression ---- */
+    bench_netc_reset(n);
+    size_t pos = 0;
+    ref_off[0] = 0;
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < max_n; i++) {
+        size_t clen = 0;
+        if (netc_compress(n->enc_ctx, srcs[i], pkt_len[i], ref_out + pos,
+                          cmp_cap - pos, &clen) != NETC_OK)
+            goto done;
+        pos += clen;
+        ref_off[i + 1] = pos;
+    }
+    uint64_t t1 = bench_now_ns();
+
+    /* ---- Per-call decompression ---- */
+    size_t dpos = 0;
+    uint64_t t2 = bench_now_ns();
+    for (size_t i = 0; i < max_n; i++) {
+        size_t dlen = 0;
+        if (netc_decompress(n->dec_ctx, ref_out + ref_off[i],
+                            ref_off[i + 1] - ref_off[i], dec_out + dpos,
+                            BENCH_CORPUS_MAX_PKT, &dlen) != NETC_OK)
+            goto done;
+        dpos += dlen;
+    }
+    uint64_t t3 = bench_now_ns();
+
+    /* ---- Batch compression ---- */
+    bench_netc_reset(n);
+    bat_off[0] = 0;
+    uint64_t t4 = bench_now_ns();
+    for (size_t i = 0; i < max_n; i += batch_size) {
+        size_t cnt  = (max_n - i < batch_size) ? max_n - i : batch_size;
+        size_t base = bat_off[i];
+        if (netc_compress_batch(n->enc_ctx, srcs + i, pkt_len + i, cnt,
+                                bat_out + base, cmp_cap - base,
+                                bat_off + i, NULL) != NETC_OK)
+            goto done;
+        /* Batch offsets are relative to the sub-arena start */
+        for (size_t k = 0; k <= cnt; k++) bat_off[i + k] += base;
+    }
+    uint64_t t5 = bench_now_ns();
+
+    if (bat_off[max_n] != ref_off[max_n] ||
+        memcmp(bat_out, ref_out, ref_off[max_n]) != 0) {
+        fprintf(stderr, "  [batch] compressed output differs from per-call\n");
+        goto done;
+    }
+
+    /* ---- Batch decompression ---- */
+    const void **csrcs = srcs;  /* reuse the pointer array */
+    for (size_t i = 0; i < max_n; i++) {
+        csrcs[i]   = bat_out + bat_off[i];
+        cmp_len[i] = bat_off[i + 1] - bat_off[i];
+    }
+    size_t *dec_off = ref_off;  /* per-call offsets no longer needed */
+    uint64_t t6 = bench_now_ns();
+    for (size_t i = 0; i < max_n; i += batch_size) {
+        size_t cnt = (max_n - i < batch_size) ? max_n - i : batch_size;
+        if (netc_decompress_batch(n->dec_ctx, csrcs + i, cmp_len + i, cnt,
+                                  dec_out, max_n * BENCH_CORPUS_MAX_PKT,
+                                  dec_off, NULL) != NETC_OK)
+            goto done;
+    }
+    uint64_t t7 = bench_now_ns();
+
+    double pkt_m = (double)max_n / 1e6;
+    double e_pc  = (double)(t1 - t0) * 1e-9;
+    double e_pd  = (double)(t3 - t2) * 1e-9;
+    double e_bc  = (double)(t5 - t4) * 1e-9;
+    double e_bd  = (double)(t7 - t6) * 1e-9;
+
+    out->compressor       = n->name;
+    out->workload         = wl;
+    out->batch_size       = batch_size;
+    out->packets          = max_n;
+    out->original_bytes   = total_orig;
+    out->compressed_bytes = bat_off[max_n];
+    out->percall_compress_mpps   = e_pc > 0 ? pkt_m / e_pc : 0.0;
+    out->percall_decompress_mpps = e_pd > 0 ? pkt_m / e_pd : 0.0;
+    out->batch_compress_mpps     = e_bc > 0 ? pkt_m / e_bc : 0.0;
+    out->batch_decompress_mpps   = e_bd > 0 ? pkt_m / e_bd : 0.0;
+    rc = 0;
+
+done:
+    free(pkt_buf); free(ref_out); free(bat_out); free(dec_out);
+    free(pkt_len); free(ref_off); free(bat_off); free(cmp_len);
+    free((void *)srcs);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_batch_print
+ * ========================================================================= */
+
+void bench_batch_print(const bench_batch_result_t *r)
+{
+    double pc = r->percall_compress_mpps, pd = r->percall_decompress_mpps;
+    printf("%-40s %.6s  packets=%7llu  batch=%zu  ratio=%.3f\n"
+           "  compress:   per-call %6.3f Mpps  batch %6.3f Mpps  (x%.2f)\n"
+           "  decompress: per-call %6.3f Mpps  batch %6.3f Mpps  (x%.2f)\n",
+           r->compressor, bench_workload_name(r->workload),
+           (unsigned long long)r->packets, r->batch_size,
+           r->original_bytes > 0
+               ? (double)r->compressed_bytes / (double)r->original_bytes : 1.0,
+           pc, r->batch_compress_mpps,   pc > 0 ? r->batch_compress_mpps / pc : 0.0,
+           pd, r->batch_decompress_mpps, pd > 0 ? r->batch_decompress_mpps / pd : 0.0);
+}
+
+/* =========================================================================
+ * Public: bench_simd_run
+ * ========================================================================= */
+
+#define BENCH_SIMD_TRAIN_FRAMES 256u
+#define BENCH_SIMD_PASSES       3
+
+/* Concatenate up to count corpus packets into whole frames of frame_size. */
+static size_t pack_frames(bench_corpus_t *corpus, size_t count,
+                          uint8_t *frames, size_t max_frames, size_t frame_size)
+{
+    size_t n_frames = 0, fill = 0;
+    for (size_t i = 0; i < count && n_frames < max_frames; i++) {
+        size_t plen = bench_corpus_next(corpus);
+        uint8_t *f  = frames + n_frames * frame_size;
+        size_t take = (plen < frame_size - fill) ? plen : frame_size - fill;
+        memcpy(f + fill, corpus->packet, take);
+        fill += take;
+        if (fill == frame_size) { n_frames++; fill = 0; }
+    }
+    return n_frames;
+}
+
+/* Train a dictionary on the first BENCH_SIMD_TRAIN_FRAMES frames. */
+static int train_frames(const uint8_t *frames, size_t n_frames, size_t frame_size,
+                        const uint8_t **train, size_t *train_sz,
+                        netc_dict_t **dict)
+{
+    size_t n_train = (n_frames < BENCH_SIMD_TRAIN_FRAMES) ? n_frames
+                                                         : BENCH_SIMD_TRAIN_FRAMES;
+    for (size_t i = 0; i < n_train; i++) {
+        train[i]    = frames + i * frame_size;
+        train_sz[i] = frame_size;
+    }
+    return netc_dict_train(train, train_sz, n_train, 1, dict) == NETC_OK ? 0 : -1;
+}
+
+int bench_simd_run(const bench_throughput_cfg_t *cfg,
+                   bench_workload_t               wl,
+                   uint32_t                       flags,
+                   size_t                         frame_size,
+                   bench_simd_result_t           *out)
+{
+    if (!cfg || !out || frame_size == 0 || frame_size > NETC_MAX_PACKET_SIZE)
+        return -1;
+    memset(out, 0, sizeof(*out));
+    flags = (flags & ~(uint32_t)(NETC_CFG_FLAG_STATELESS |
+                                 NETC_CFG_FLAG_COMPACT_HDR))
+          | NETC_CFG_FLAG_STATEFUL;
+
+    bench_timer_init();
+
+    /* ---- Pack cfg->count corpus packets into frames ---- */
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+    size_t max_frames = cfg->count * BENCH_CORPUS_MAX_PKT / frame_size + 1u;
+    size_t cmp_stride = frame_size + NETC_MAX_OVERHEAD;
+    uint8_t *frames   = (uint8_t *)malloc(max_frames * frame_size);
+    uint8_t *cmp      = (uint8_t *)malloc(max_frames * cmp_stride);
+    uint8_t *back     = (uint8_t *)malloc(frame_size);
+    size_t  *cmp_len  = (size_t  *)malloc(max_frames * sizeof(size_t));
+    const uint8_t **train = (const uint8_t **)malloc(BENCH_SIMD_TRAIN_FRAMES *
+                                                     sizeof(*train));
+    size_t  *train_sz = (size_t  *)malloc(BENCH_SIMD_TRAIN_FRAMES * sizeof(size_t));
+    netc_dict_t *dict = NULL;
+    int rc = -1;
+    if (!frames || !cmp || !back || !cmp_len || !train || !train_sz) goto done;
+
+    size_t n_frames = pack_frames(&corpus, cfg->count, frames, max_frames,
+                                  frame_size);
+    if (n_frames == 0) goto done;
+    if (train_frames(frames, n_frames, frame_size, train, train_sz, &dict) != 0)
+        goto done;
+
+    out->workload       = wl;
+    out->frame_size     = frame_size;
+    out->frames         = n_frames;
+    out->original_bytes = (uint64_t)n_frames * frame_size;
+
+    static const uint8_t levels[] = {
+        NETC_SIMD_LEVEL_GENERIC, NETC_SIMD_LEVEL_SSE42, NETC_SIMD_LEVEL_AVX2
+    };
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        netc_cfg_t ncfg;
+        memset(&ncfg, 0, sizeof(ncfg));
+        ncfg.flags      = flags;
+        ncfg.simd_level = levels[l];
+        netc_ctx_t *enc = netc_ctx_create(dict, &ncfg);
+        netc_ctx_t *dec = netc_ctx_create(dict, &ncfg);
+        if (!enc || !dec) {
+            netc_ctx_destroy(enc); netc_ctx_destroy(dec);
+            goto done;
+        }
+        /* Levels the CPU lacks fall back; report each actual level once */
+        uint8_t actual = netc_ctx_simd_level(dec);
+        if (out->n_levels > 0 && out->level[out->n_levels - 1] == actual) {
+            netc_ctx_destroy(enc);
+            netc_ctx_destroy(dec);
+            continue;
+        }
+
+        int ok = 1;
+        uint64_t total_cmp = 0, x8 = 0;
+        uint64_t t0 = bench_now_ns();
+        for (size_t i = 0; i < n_frames && ok; i++) {
+            ok = netc_compress(enc, frames + i * frame_size, frame_size,
+                               cmp + i * cmp_stride, cmp_stride,
+                               &cmp_len[i]) == NETC_OK;
+            total_cmp += cmp_len[i];
+        }
+        uint64_t t1 = bench_now_ns();
+
+        /* Verified warm-up pass, then the best of BENCH_SIMD_PASSES timed
+         * passes, each from a reset context */
+        uint64_t best = 0;
+        for (int pass = 0; pass <= BENCH_SIMD_PASSES && ok; pass++) {
+            netc_ctx_reset(dec);
+            uint64_t t2 = bench_now_ns();
+            for (size_t i = 0; i < n_frames && ok; i++) {
+                size_t dlen = 0;
+                ok = netc_decompress(dec, cmp + i * cmp_stride, cmp_len[i],
+                                     back, frame_size, &dlen) == NETC_OK &&
+                     dlen == frame_size &&
+                     (pass > 0 ||
+                      memcmp(back, frames + i * frame_size, frame_size) == 0);
+            }
+            uint64_t t3 = bench_now_ns();
+            if (pass > 0 && (best == 0 || t3 - t2 < best)) best = t3 - t2;
+        }
+        netc_ctx_destroy(enc);
+        netc_ctx_destroy(dec);
+        if (!ok) {
+            fprintf(stderr, "  [simd] %s round-trip failed\n",
+                    netc_simd_level_name(actual));
+            goto done;
+        }
+
+        for (size_t i = 0; i < n_frames; i++) {
+            uint8_t alg = cmp[i * cmp_stride + 5];
+            if ((alg & 0x0Fu) == NETC_ALG_TANS_PCTX &&
+                netc_pctx_alg_states(alg) == 8u)
+                x8++;
+        }
+        double mb = (double)out->original_bytes / 1e6;
+        int    k  = out->n_levels++;
+        out->level[k]          = actual;
+        out->compress_mbs[k]   = (t1 > t0) ? mb / ((double)(t1 - t0) * 1e-9) : 0.0;
+        out->decompress_mbs[k] = (best > 0) ? mb / ((double)best * 1e-9) : 0.0;
+        out->compressed_bytes  = total_cmp;
+        out->x8_frames         = x8;
+    }
+    rc = 0;
+
+done:
+    netc_dict_free(dict);
+    free(frames); free(cmp); free(back); free(cmp_len);
+    free((void *)train); free(train_sz);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_simd_print
+ * ========================================================================= */
+
+void bench_simd_print(const bench_simd_result_t *r)
+{
+    printf("netc simd levels %.6s  frame=%zuB  frames=%llu  ratio=%.3f  x8=%llu\n",
+           bench_workload_name(r->workload), r->frame_size,
+           (unsigned long long)r->frames,
+           r->original_bytes > 0
+               ? (double)r->compressed_bytes / (double)r->original_bytes : 1.0,
+           (unsigned long long)r->x8_frames);
+    double base = r->n_levels > 0 ? r->decompress_mbs[0] : 0.0;
+    for (int k = 0; k < r->n_levels; k++) {
+        printf("  %-8s compress %8.1f MB/s  decompress %8.1f MB/s  (x%.2f)\n",
+               netc_simd_level_name(r->level[k]), r->compress_mbs[k],
+               r->decompress_mbs[k],
+               base > 0 ? r->decompress_mbs[k] / base : 0.0);
+    }
+}
+
+/* =========================================================================
+ * Public: bench_rans_run
+ * ========================================================================= */
+
+/* tANS PCTX payload: 2-byte final state + bitstream (compact layout) */
+static size_t rans_bench_tans_encode(const netc_dict_t *dict, const uint8_t *src,
+                                     size_t n, uint8_t *dst, size_t cap)
+{
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, dst + 2, cap - 2);
+    uint32_t state = netc_tans_encode_pctx(dict->tables, &dict->buckets, src, n,
+                                           &bsw, NETC_TANS_TABLE_SIZE);
+    if (state == 0) return (size_t)-1;
+    size_t bs = netc_bsw_flush(&bsw);
+    if (bs == (size_t)-1) return (size_t)-1;
+    netc_write_u16_le(dst, (uint16_t)state);
+    return 2 + bs;
+}
+
+static int rans_bench_tans_decode(const netc_dict_t *dict, const uint8_t *src,
+                                  size_t len, uint8_t *dst, size_t n)
+{
+    netc_bsr_t bsr;
+    netc_bsr_init(&bsr, src + 2, len - 2);
+    return netc_tans_decode_pctx(dict->tables, &dict->buckets, &bsr, dst, n,
+                                 netc_read_u16_le(src));
+}
+
+int bench_rans_run(const bench_throughput_cfg_t *cfg,
+                   bench_workload_t               wl,
+                   size_t                         frame_size,
+                   bench_rans_result_t           *out)
+{
+    if (!cfg || !out || frame_size == 0 || frame_size > NETC_MAX_PACKET_SIZE)
+        return -1;
+    memset(out, 0, sizeof(*out));
+
+    bench_timer_init();
+
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+    size_t max_frames = cfg->count * BENCH_CORPUS_MAX_PKT / frame_size + 1u;
+    size_t cmp_stride = frame_size + NETC_MAX_OVERHEAD;
+    uint8_t *frames   = (uint8_t *)malloc(max_frames * frame_size);
+    uint8_t *cmp      = (uint8_t *)malloc(max_frames * cmp_stride);
+    uint8_t *back     = (uint8_t *)malloc(frame_size);
+    size_t  *cmp_len  = (size_t  *)malloc(max_frames * sizeof(size_t));
+    const uint8_t **train = (const uint8_t **)malloc(BENCH_SIMD_TRAIN_FRAMES *
+                                                     sizeof(*train));
+    size_t  *train_sz = (size_t  *)malloc(BENCH_SIMD_TRAIN_FRAMES * sizeof(size_t));
+    netc_dict_t *dict = NULL;
+    int rc = -1;
+    if (!frames || !cmp || !back || !cmp_len || !train || !train_sz) goto done;
+
+    size_t n_frames = pack_frames(&corpus, cfg->count, frames, max_frames,
+                                  frame_size);
+    if (n_frames == 0) goto done;
+    if (train_frames(frames, n_frames, frame_size, train, train_sz, &dict) != 0)
+        goto done;
+
+    out->workload       = wl;
+    out->frame_size     = frame_size;
+    out->frames         = n_frames;
+    out->original_bytes = (uint64_t)n_frames * frame_size;
+    double mb = (double)out->original_bytes / 1e6;
+
+    for (int codec = 0; codec < 2; codec++) {
+        bench_codec_row_t *row = codec ? &out->rans : &out->tans;
+        row->table_bytes = codec ? sizeof(netc_rans_table_t)
+                                 : sizeof(netc_tans_table_t);
+
+        /* Pass 0 verifies; the best of the timed passes is reported */
+        uint64_t best_c = 0, best_d = 0, total = 0;
+        for (int pass = 0; pass <= BENCH_SIMD_PASSES; pass++) {
+            uint64_t t0 = bench_now_ns();
+            total = 0;
+            for (size_t i = 0; i < n_frames; i++) {
+                const uint8_t *f = frames + i * frame_size;
+                uint8_t       *c = cmp + i * cmp_stride;
+                cmp_len[i] = codec
+                    ? netc_rans_encode_pctx(dict->rans_tables, &dict->buckets,
+                                            f, frame_size, c, cmp_stride)
+                    : rans_bench_tans_encode(dict, f, frame_size, c, cmp_stride);
+                if (cmp_len[i] == (size_t)-1) {
+                    fprintf(stderr, "  [rans] %s encode failed\n",
+                            codec ? "rANS" : "tANS");
+                    goto done;
+                }
+                total += cmp_len[i];
+            }
+            uint64_t t1 = bench_now_ns();
+            for (size_t i = 0; i < n_frames; i++) {
+                const uint8_t *c = cmp + i * cmp_stride;
+                int bad = codec
+                    ? netc_rans_decode_pctx(dict->rans_tables, &dict->buckets,
+                                            c, cmp_len[i], back, frame_size)
+                    : rans_bench_tans_decode(dict, c, cmp_len[i], back, frame_size);
+                if (bad != 0 || (pass == 0 &&
+                    memcmp(back, frames + i * frame_size, frame_size) != 0)) {
+                    fprintf(stderr, "  [rans] %s round-trip failed\n",
+                            codec ? "rANS" : "tANS");
+                    goto done;
+                }
+            }
+            uint64_t t2 = bench_now_ns();
+            if (pass == 0) continue;
+            if (best_c == 0 || t1 - t0 < best_c) best_c = t1 - t0;
+            if (best_d == 0 || t2 - t1 < best_d) best_d = t2 - t1;
+        }
+        row->payload_bytes  = total;
+        row->compress_mbs   = (best_c > 0) ? mb / ((double)best_c * 1e-9) : 0.0;
+        row->decompress_mbs = (best_d > 0) ? mb / ((double)best_d * 1e-9) : 0.0;
+    }
+    rc = 0;
+
+done:
+    netc_dict_free(dict);
+    free(frames); free(cmp); free(back); free(cmp_len);
+    free((void *)train); free(train_sz);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_rans_print
+ * ========================================================================= */
+
+void bench_rans_print(const bench_rans_result_t *r)
+{
+    printf("netc rans vs tans %.6s  frame=%zuB  frames=%llu\n",
+           bench_workload_name(r->workload), r->frame_size,
+           (unsigned long long)r->frames);
+    const bench_codec_row_t *rows[2] = { &r->tans, &r->rans };
+    static const char *const names[2] = { "tANS", "rANS" };
+    for (int k = 0; k < 2; k++) {
+        printf("  %-5s compress %8.1f MB/s  decompress %8.1f MB/s  "
+               "ratio=%.4f  table=%zuB\n",
+               names[k], rows[k]->compress_mbs, rows[k]->decompress_mbs,
+               r->original_bytes > 0
+                   ? (double)rows[k]->payload_bytes / (double)r->original_bytes
+                   : 1.0,
+               rows[k]->table_bytes);
+    }
+}
+
+/* =========================================================================
+ * Internal: many-connections helpers
+ * ========================================================================= */
+
+static void conns_destroy(netc_ctx_t **ctxs, size_t n)
+{
+    if (!ctxs) return;
+    for (size_t i = 0; i < n; i++) netc_ctx_destroy(ctxs[i]);
+    free(ctxs);
+}
+
+static netc_ctx_t **conns_create(const bench_netc_t *n, uint32_t flags,
+                                 size_t conns)
+{
+    netc_ctx_t **ctxs = (netc_ctx_t **)calloc(conns, sizeof(*ctxs));
+    if (!ctxs) return NULL;
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags             = flags;
+    cfg.simd_level        = n->simd_level;
+    cfg.compression_level = n->level;
+    cfg.adaptive_decay    = n->decay;
+    for (size_t i = 0; i < conns; i++) {
+        ctxs[i] = netc_ctx_create(n->dict, &cfg);
+        if (!ctxs[i]) { conns_destroy(ctxs, i); return NULL; }
+    }
+    return ctxs;
+}
+
+/* Mean netc_ctx_memory_usage().total over both sides of every connection. */
+static size_t conns_mean_bytes(netc_ctx_t **enc, netc_ctx_t **dec, size_t conns)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < conns; i++) {
+        netc_mem_usage_t mu;
+        if (netc_ctx_memory_usage(enc[i], &mu) == NETC_OK) total += mu.total;
+        if (netc_ctx_memory_usage(dec[i], &mu) == NETC_OK) total += mu.total;
+    }
+    return total / (2 * conns);
+}
+
+/* =========================================================================
+ * Public: bench_conns_run
+ * ========================================================================= */
+
+int bench_conns_run(const bench_throughput_cfg_t *cfg,
+                    bench_workload_t               wl,
+                    bench_netc_t                  *n,
+                    size_t                         conns,
+                    bench_conns_result_t          *out)
+{
+    if (!cfg || !n || !out || n->stateless || cfg->count == 0) return -1;
+    if (conns == 0) conns = 1;
+
+    bench_timer_init();
+
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+
+    size_t   max_n   = cfg->count;
+    size_t   pkt_cap = BENCH_CORPUS_MAX_PKT + NETC_MAX_OVERHEAD;
+    uint8_t *pkt_buf = (uint8_t *)malloc(max_n * BENCH_CORPUS_MAX_PKT);
+    uint8_t *ref_out = (uint8_t *)malloc(max_n * pkt_cap);
+    size_t  *pkt_len = (size_t  *)malloc(max_n * sizeof(size_t));
+    size_t  *cmp_len = (size_t  *)malloc(max_n * sizeof(size_t));
+    uint8_t  cbuf[BENCH_CORPUS_MAX_PKT + NETC_MAX_OVERHEAD];
+    uint8_t  dbuf[BENCH_CORPUS_MAX_PKT];
+    netc_ctx_t   **enc[2] = { NULL, NULL };
+    netc_ctx_t   **dec[2] = { NULL, NULL };
+    netc_scratch_t *scratch = NULL;
+    uint64_t elapsed[2] = { 0, 0 };
+    int rc = -1;
+
+    if (!pkt_buf || !ref_out || !pkt_len || !cmp_len) goto done;
+
+    uint64_t total_orig = 0, total_comp = 0;
+    for (size_t i = 0; i < max_n; i++) {
+        size_t plen = bench_corpus_next(&corpus);
+        if (plen == 0) plen = bench_corpus_next(&corpus);  /* retry once */
+        pkt_len[i] = plen;
+        memcpy(pkt_buf + i * BENCH_CORPUS_MAX_PKT, corpus.packet, plen);
+        total_orig += plen;
+    }
+
+    /* Pass 0: private arena per context.  Pass 1: one shared scratch. */
+    scratch = netc_scratch_create(0);
+    if (!scratch) goto done;
+    for (int pass = 0; pass < 2; pass++) {
+        uint32_t flags = n->flags | (pass ? NETC_CFG_FLAG_EXTERNAL_SCRATCH : 0U);
+        netc_scratch_t *s = pass ? scratch : NULL;
+        enc[pass] = conns_create(n, flags, conns);
+        dec[pass] = conns_create(n, flags, conns);
+        if (!enc[pass] || !dec[pass]) goto done;
+
+        uint64_t t0 = bench_now_ns();
+        for (size_t i = 0; i < max_n; i++) {
+            size_t c = i % conns, clen = 0, dlen = 0;
+            const uint8_t *src = pkt_buf + i * BENCH_CORPUS_MAX_PKT;
+            if (netc_compress_ex(enc[pass][c], s, src, pkt_len[i],
+                                 cbuf, sizeof(cbuf), &clen) != NETC_OK ||
+                netc_decompress_ex(dec[pass][c], s, cbuf, clen,
+                                   dbuf, sizeof(dbuf), &dlen) != NETC_OK)
+                goto done;
+            if (dlen != pkt_len[i] || memcmp(dbuf, src, dlen) != 0) {
+                fprintf(stderr, "  [conns] round-trip mismatch at packet %zu\n", i);
+                goto done;
+            }
+            uint8_t *ref = ref_out + i * pkt_cap;
+            if (pass == 0) {
+                memcpy(ref, cbuf, clen);
+                cmp_len[i]  = clen;
+                total_comp += clen;
+            } else if (clen != cmp_len[i] || memcmp(ref, cbuf, clen) != 0) {
+                fprintf(stderr, "  [conns] shared-scratch output differs at packet %zu\n", i);
+                goto done;
+            }
+        }
+        elapsed[pass] = bench_now_ns() - t0;
+    }
+
+    double pkt_m = (double)max_n / 1e6;
+    double e_p   = (double)elapsed[0] * 1e-9;
+    double e_s   = (double)elapsed[1] * 1e-9;
+
+    out->compressor        = n->name;
+    out->workload          = wl;
+    out->conns             = conns;
+    out->packets           = max_n;
+    out->original_bytes    = total_orig;
+    out->compressed_bytes  = total_comp;
+    out->private_ctx_bytes = conns_mean_bytes(enc[0], dec[0], conns);
+    out->shared_ctx_bytes  = conns_mean_bytes(enc[1], dec[1], conns);
+    out->scratch_bytes     = scratch->arena_size;
+    out->private_mpps      = e_p > 0 ? pkt_m / e_p : 0.0;
+    out->shared_mpps       = e_s > 0 ? pkt_m / e_s : 0.0;
+    rc = 0;
+
+done:
+    for (int pass = 0; pass < 2; pass++) {
+        conns_destroy(enc[pass], conns);
+        conns_destroy(dec[pass], conns);
+    }
+    netc_scratch_destroy(scratch);
+    free(pkt_buf); free(ref_out); free(pkt_len); free(cmp_len);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_conns_print
+ * ========================================================================= */
+
+void bench_conns_print(const bench_conns_result_t *r)
+{
+    size_t pb = r->private_ctx_bytes * 2 * r->conns;
+    size_t sb = r->shared_ctx_bytes  * 2 * r->conns + r->scratch_bytes;
+    printf("%-40s %.6s  packets=%7llu  conns=%zu  ratio=%.3f\n"
+           "  private arena:  %6.3f Mpps  %8zu B/ctx  %10zu B total\n"
+           "  shared scratch: %6.3f Mpps  %8zu B/ctx  %10zu B total  (scratch %zu B)\n",
+           r->compressor, bench_workload_name(r->workload),
+           (unsigned long long)r->packets, r->conns,
+           r->original_bytes > 0
+               ? (double)r->compressed_bytes / (double)r->original_bytes : 1.0,
+           r->private_mpps, r->private_ctx_bytes, pb,
+           r->shared_mpps,  r->shared_ctx_bytes,  sb, r->scratch_bytes);
+}
+
+/* =========================================================================
+ * Internal: resident set size (Linux /proc; 0 elsewhere)
+ * ========================================================================= */
+
+static size_t bench_rss_bytes(void)
+{
+#if defined(__linux__)
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    int ok = fscanf(f, "%lu %lu", &size, &resident) == 2;
+    fclose(f);
+    return ok ? (size_t)resident * 4096u : 0;
+#else
+    return 0;
+#endif
+}
+
+/* =========================================================================
+ * Public: bench_storm_run
+ * ========================================================================= */
+
+int bench_storm_run(const bench_throughput_cfg_t *cfg,
+                    bench_workload_t               wl,
+                    bench_netc_t                  *n,
+                    size_t                         conns,
+                    bench_storm_result_t          *out)
+{
+    if (!cfg || !n || !out || !n->dict) return -1;
+    if (conns == 0) conns = 1;
+
+    bench_timer_init();
+
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+
+    uint32_t flags = n->flags | NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_ADAPTIVE;
+    flags &= ~(uint32_t)NETC_CFG_FLAG_STATELESS;
+    uint8_t  cbuf[BENCH_CORPUS_MAX_PKT + NETC_MAX_OVERHEAD];
+    uint8_t  dbuf[BENCH_CORPUS_MAX_PKT];
+    netc_ctx_t **enc = NULL, **dec = NULL;
+    int rc = -1;
+
+    memset(out, 0, sizeof(*out));
+    size_t rss0 = bench_rss_bytes();
+
+    uint64_t t0 = bench_now_ns();
+    enc = conns_create(n, flags, conns);
+    dec = conns_create(n, flags, conns);
+    uint64_t t1 = bench_now_ns();
+    if (!enc || !dec) goto done;
+
+    /* Phase 0: created.  Phase 1: one packet per connection.  Phase 2: a
+     * full rebuild interval per connection. */
+    for (int phase = 0; phase < BENCH_STORM_PHASES; phase++) {
+        size_t rounds = (phase == 0) ? 0 : (phase == 1) ? 1 : NETC_ADAPTIVE_INTERVAL - 1;
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t c = 0; c < conns; c++) {
+                size_t plen = bench_corpus_next(&corpus);
+                if (plen == 0) plen = bench_corpus_next(&corpus);  /* retry once */
+                size_t clen = 0, dlen = 0;
+                if (netc_compress(enc[c], corpus.packet, plen,
+                                  cbuf, sizeof(cbuf), &clen) != NETC_OK ||
+                    netc_decompress(dec[c], cbuf, clen,
+                                    dbuf, sizeof(dbuf), &dlen) != NETC_OK)
+                    goto done;
+                if (dlen != plen || memcmp(dbuf, corpus.packet, plen) != 0) {
+                    fprintf(stderr, "  [storm] round-trip mismatch\n");
+                    goto done;
+                }
+            }
+        }
+        size_t rss = bench_rss_bytes();
+        out->rss_bytes[phase] = (rss > rss0) ? (rss - rss0) / (2 * conns) : 0;
+        out->ctx_bytes[phase] = conns_mean_bytes(enc, dec, conns);
+    }
+
+    uint64_t t2 = bench_now_ns();
+    conns_destroy(enc, conns);
+    conns_destroy(dec, conns);
+    uint64_t t3 = bench_now_ns();
+    enc = dec = NULL;
+
+    out->compressor = n->name;
+    out->workload   = wl;
+    out->conns      = conns;
+    out->create_ns  = (double)(t1 - t0) / (double)(2 * conns);
+    out->destroy_ns = (double)(t3 - t2) / (double)(2 * conns);
+    rc = 0;
+
+done:
+    conns_destroy(enc, conns);
+    conns_destroy(dec, conns);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_storm_print
+ * ========================================================================= */
+
+void bench_storm_print(const bench_storm_result_t *r)
+{
+    static const char *const phase[BENCH_STORM_PHASES] = {
+        "created", "1 packet", "rebuilt"
+    };
+    printf("%-40s %.6s  conns=%zu  (adaptive)\n"
+           "  create %8.1f us/ctx  destroy %8.1f us/ctx\n",
+           r->compressor, bench_workload_name(r->workload), r->conns,
+           r->create_ns / 1e3, r->destroy_ns / 1e3);
+    for (int p = 0; p < BENCH_STORM_PHASES; p++) {
+        printf("  %-8s  RSS %8zu B/ctx  netc %8zu B/ctx\n",
+               phase[p], r->rss_bytes[p], r->ctx_bytes[p]);
+    }
+}
+
+/* =========================================================================
+ * Public: bench_tail_run
+ * ========================================================================= */
+
+int bench_tail_run(const bench_throughput_cfg_t *cfg,
+                   bench_workload_t               wl,
+                   bench_netc_t                  *n,
+                   bench_tail_result_t           *out)
+{
+    if (!cfg || !n || !out || !n->dict) return -1;
+    size_t count = cfg->count ? cfg->count : BENCH_DEFAULT_COUNT;
+
+    bench_timer_init();
+
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+
+    uint32_t flags = n->flags | NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_ADAPTIVE;
+    flags &= ~(uint32_t)NETC_CFG_FLAG_STATELESS;
+    uint8_t  cbuf[BENCH_CORPUS_MAX_PKT + NETC_MAX_OVERHEAD];
+    uint8_t  dbuf[BENCH_CORPUS_MAX_PKT];
+    uint64_t *c_ns = (uint64_t *)malloc(count * sizeof(uint64_t));
+    uint64_t *d_ns = (uint64_t *)malloc(count * sizeof(uint64_t));
+    netc_ctx_t **enc = conns_create(n, flags, 1);
+    netc_ctx_t **dec = conns_create(n, flags, 1);
+    double   win_sum = 0.0, steady_sum = 0.0;
+    size_t   win_n = 0;
+    int      rc = -1;
+
+    memset(out, 0, sizeof(*out));
+    if (!c_ns || !d_ns || !enc || !dec) goto done;
+
+    for (size_t i = 0; i < cfg->warmup + count; i++) {
+        size_t plen = bench_corpus_next(&corpus);
+        if (plen == 0) { bench_corpus_reset(&corpus); plen = bench_corpus_next(&corpus); }
+        size_t clen = 0, dlen = 0;
+
+        uint64_t t0 = bench_now_ns();
+        netc_result_t crc = netc_compress(enc[0], corpus.packet, plen,
+                                          cbuf, sizeof(cbuf), &clen);
+        uint64_t t1 = bench_now_ns();
+        netc_result_t drc = (crc == NETC_OK)
+            ? netc_decompress(dec[0], cbuf, clen, dbuf, sizeof(dbuf), &dlen)
+            : crc;
+        uint64_t t2 = bench_now_ns();
+
+        if (drc != NETC_OK || dlen != plen ||
+            memcmp(dbuf, corpus.packet, plen) != 0) {
+            fprintf(stderr, "  [tail] round-trip mismatch\n");
+            goto done;
+        }
+        if (i < cfg->warmup) continue;
+
+        size_t j = i - cfg->warmup;
+        c_ns[j] = t1 - t0;
+        d_ns[j] = t2 - t1;
+        /* Rebuilds happen on the packets that end each interval */
+        if (i % NETC_ADAPTIVE_INTERVAL >= NETC_ADAPTIVE_INTERVAL - NETC_CTX_COUNT) {
+            win_sum += (double)c_ns[j];
+            win_n++;
+        } else {
+            steady_sum += (double)c_ns[j];
+        }
+    }
+
+    bench_stats_compute(&out->compress,   c_ns, count);   /* sorts in place */
+    bench_stats_compute(&out->decompress, d_ns, count);
+    out->compress_p9999_ns   = c_ns[(count * 9999u) / 10000u];
+    out->decompress_p9999_ns = d_ns[(count * 9999u) / 10000u];
+    out->compressor = n->name;
+    out->workload   = wl;
+    out->packets    = count;
+    out->window_ns  = win_n ? win_sum / (double)win_n : 0.0;
+    out->steady_ns  = (count > win_n) ? steady_sum / (double)(count - win_n) : 0.0;
+    rc = 0;
+
+done:
+    conns_destroy(enc, 1);
+    conns_destroy(dec, 1);
+    free(c_ns);
+    free(d_ns);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_tail_print
+ * ========================================================================= */
+
+void bench_tail_print(const bench_tail_result_t *r)
+{
+    printf("%-40s %.6s  packets=%zu  (adaptive)\n"
+           "  %-10s %8s %8s %8s %8s %8s\n",
+           r->compressor, bench_workload_name(r->workload), r->packets,
+           "ns", "p50", "p99", "p99.9", "p99.99", "max");
+    printf("  %-10s %8llu %8llu %8llu %8llu %8llu\n", "compress",
+           (unsigned long long)r->compress.p50_ns,
+           (unsigned long long)r->compress.p99_ns,
+           (unsigned long long)r->compress.p999_ns,
+           (unsigned long long)r->compress_p9999_ns,
+           (unsigned long long)r->compress.max_ns);
+    printf("  %-10s %8llu %8llu %8llu %8llu %8llu\n", "decompress",
+           (unsigned long long)r->decompress.p50_ns,
+           (unsigned long long)r->decompress.p99_ns,
+           (unsigned long long)r->decompress.p999_ns,
+           (unsigned long long)r->decompress_p9999_ns,
+           (unsigned long long)r->decompress.max_ns);
+    printf("  compress mean: rebuild window %.0f ns, rest %.0f ns\n",
+           r->window_ns, r->steady_ns);
+}
+
+/* =========================================================================
+ * Internal: CPU cache-miss counters (Linux perf events; unavailable elsewhere)
+ * ========================================================================= */
+
+typedef struct {
+    int fd[2];  /* L1D read misses, last-level cache misses; -1 if unavailable */
+} bench_perf_t;
+
+#if defined(__linux__)
+static int bench_perf_open(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr a;
+    memset(&a, 0, sizeof(a));
+    a.size           = sizeof(a);
+    a.type           = type;
+    a.config         = config;
+    a.disabled       = 1;
+    a.exclude_kernel = 1;
+    a.exclude_hv     = 1;
+    return (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+}
+#endif
+
+static int bench_perf_init(bench_perf_t *p)
+{
+    p->fd[0] = p->fd[1] = -1;
+#if defined(__linux__)
+    p->fd[0] = bench_perf_open(PERF_TYPE_HW_CACHE,
+                               PERF_COUNT_HW_CACHE_L1D |
+                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    p->fd[1] = bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    return p->fd[0] >= 0 && p->fd[1] >= 0;
+}
+
+static void bench_perf_enable(const bench_perf_t *p, int on)
+{
+#if defined(__linux__)
+    for (int k = 0; k < 2; k++) {
+        if (p->fd[k] >= 0)
+            ioctl(p->fd[k], on ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+    }
+#else
+    (void)p; (void)on;
+#endif
+}
+
+/* Read counter k and reset it to zero. */
+static uint64_t bench_perf_take(const bench_perf_t *p, int k)
+{
+    uint64_t v = 0;
+#if defined(__linux__)
+    if (p->fd[k] < 0 || read(p->fd[k], &v, sizeof(v)) != (ssize_t)sizeof(v)) v = 0;
+    if (p->fd[k] >= 0) ioctl(p->fd[k], PERF_EVENT_IOC_RESET, 0);
+#else
+    (void)p; (void)k;
+#endif
+    return v;
+}
+
+static void bench_perf_close(bench_perf_t *p)
+{
+#if defined(__linux__)
+    for (int k = 0; k < 2; k++) {
+        if (p->fd[k] >= 0) close(p->fd[k]);
+    }
+#endif
+    p->fd[0] = p->fd[1] = -1;
+}
+
+/* =========================================================================
+ * Public: bench_lzp_run
+ * ========================================================================= */
+
+#define BENCH_LZP_MAX_PKTS    4096u       /* distinct packets held in memory */
+#define BENCH_LZP_EVICT_BYTES (4u << 20)  /* at least a core's L2 */
+#define BENCH_LZP_LINES       8192u       /* modelled line ids, both layouts */
+
+/* Modelled 64-byte lines slot h reads: one dense line, or a map line plus
+ * an entry line (line ids past the map's 512). */
+static void lzp_slot_lines(const netc_lzp_table_t *t, uint32_t h, uint32_t *line, int *n)
+{
+    if (t->blk == NULL) {
+        line[0] = h >> 5;
+        *n = 1;
+        return;
+    }
+    netc_lzp_blk_t b = t->blk[h >> NETC_LZP_BLK_SHIFT];
+    uint32_t idx = b.base + netc_popcount32(b.bits & (((uint32_t)1 << (h & 31u)) - 1u));
+    line[0] = h >> 8;
+    line[1] = (NETC_LZP_BLK_COUNT * (uint32_t)sizeof(netc_lzp_blk_t) + idx * 2u) >> 6;
+    *n = 2;
+}
+
+/* Distinct lines per packet (stamp[] marks the packet that last read a
+ * line) and over the run (seen[]). */
+static double lzp_model_lines(const netc_lzp_table_t *t, int order2,
+                              uint8_t *const *pkts, const size_t *lens, size_t np,
+                              size_t *ws_lines)
+{
+    uint32_t *stamp = (uint32_t *)calloc(BENCH_LZP_LINES, sizeof(uint32_t));
+    uint8_t  *seen  = (uint8_t *)calloc(BENCH_LZP_LINES, 1);
+    uint64_t  total = 0;
+    *ws_lines = 0;
+    if (!stamp || !seen) { free(stamp); free(seen); return 0.0; }
+
+    for (size_t p = 0; p < np; p++) {
+        const uint8_t *s = pkts[p];
+        for (size_t i = 0; i < lens[p]; i++) {
+            uint8_t  prev  = (i > 0) ? s[i - 1] : 0x00u;
+            uint8_t  prev2 = (i > 1) ? s[i - 2] : 0x00u;
+            uint32_t h[2]  = { netc_lzp_hash(prev, (uint32_t)i),
+                               netc_lzp_hash2(prev2, prev, (uint32_t)i) };
+            for (int o = 0; o <= order2; o++) {
+                uint32_t line[2];
+                int      nl = 0;
+                lzp_slot_lines(t, h[o], line, &nl);
+                for (int k = 0; k < nl; k++) {
+                    if (stamp[line[k]] != (uint32_t)p + 1u) {
+                        stamp[line[k]] = (uint32_t)p + 1u;
+                        total++;
+                    }
+                    if (!seen[line[k]]) {
+                        seen[line[k]] = 1;
+                        (*ws_lines)++;
+                    }
+                }
+            }
+        }
+    }
+    free(stamp);
+    free(seen);
+    return np ? (double)total / (double)np : 0.0;
+}
+
+int bench_lzp_run(const bench_throughput_cfg_t *cfg,
+                  bench_workload_t               wl,
+                  bench_netc_t                  *n,
+                  bench_lzp_result_t            *out)
+{
+    if (!cfg || !n || !out || !n->dict) return -1;
+    memset(out, 0, sizeof(*out));
+    const netc_lzp_table_t dict_lzp = netc_dict_lzp(n->dict);
+    if (dict_lzp.ent == NULL) {
+        fprintf(stderr, "  [lzp] dictionary has no LZP table\n");
+        return -1;
+    }
+    size_t count = cfg->count ? cfg->count : BENCH_DEFAULT_COUNT;
+    size_t np    = count < BENCH_LZP_MAX_PKTS ? count : BENCH_LZP_MAX_PKTS;
+
+    bench_timer_init();
+
+    bench_corpus_t corpus;
+    bench_corpus_init(&corpus, wl, cfg->seed + BENCH_EVAL_SEED_OFFSET);
+
+    netc_simd_ops_t   ops;
+    bench_perf_t      perf;
+    netc_lzp_table_t  view[2];
+    netc_lzp_entry_t *dense  = (netc_lzp_entry_t *)malloc(NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+    uint8_t          *packed = NULL;
+    uint8_t          *store  = (uint8_t *)malloc(np * BENCH_CORPUS_MAX_PKT);
+    uint8_t          *filt   = (uint8_t *)malloc(np * BENCH_CORPUS_MAX_PKT);
+    uint8_t         **pkts   = (uint8_t **)malloc(np * sizeof(uint8_t *));
+    size_t           *lens   = (size_t *)malloc(np * sizeof(size_t));
+    uint8_t          *evict  = (uint8_t *)malloc(BENCH_LZP_EVICT_BYTES);
+    uint8_t           fbuf[BENCH_CORPUS_MAX_PKT];
+    int               rc = -1;
+
+    netc_simd_ops_init(&ops, n->simd_level);
+    int have_perf = bench_perf_init(&perf);
+    if (!dense || !store || !filt || !pkts || !lens || !evict) goto done;
+
+    /* Both layouts of the same table */
+    for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) dense[h] = netc_lzp_get(&dict_lzp, h);
+    out->entries = netc_lzp_count(dense);
+    packed = (uint8_t *)calloc(1, netc_lzp_pack_size(out->entries));
+    if (!packed) goto done;
+    view[0].blk = NULL;
+    view[0].ent = dense;
+    view[1].blk = (const netc_lzp_blk_t *)(const void *)packed;
+    view[1].ent = (const netc_lzp_entry_t *)(const void *)
+                  (packed + NETC_LZP_BLK_COUNT * sizeof(netc_lzp_blk_t));
+    netc_lzp_pack(dense, (netc_lzp_blk_t *)(void *)packed,
+                  (netc_lzp_entry_t *)(void *)(packed + NETC_LZP_BLK_COUNT * sizeof(netc_lzp_blk_t)));
+
+    for (size_t p = 0; p < np; p++) {
+        size_t plen = bench_corpus_next(&corpus);
+        if (plen == 0) { bench_corpus_reset(&corpus); plen = bench_corpus_next(&corpus); }
+        pkts[p] = store + p * BENCH_CORPUS_MAX_PKT;
+        lens[p] = plen;
+        memcpy(pkts[p], corpus.packet, plen);
+    }
+
+    out->compressor     = n->name;
+    out->workload       = wl;
+    out->packets        = count;
+    out->order2         = netc_lzp_order2(n->dict);
+    out->dict_packed    = dict_lzp.blk != NULL;
+    out->table_bytes[0] = NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t);
+    out->table_bytes[1] = netc_lzp_pack_size(out->entries);
+    out->hw_counters    = have_perf;
+
+    for (int v = 0; v < 2; v++) {
+        const netc_lzp_table_t *t = &view[v];
+        out->lines_per_pkt[v] = lzp_model_lines(t, out->order2, pkts, lens, np,
+                                                &out->ws_lines[v]);
+
+        for (size_t i = 0; i < cfg->warmup; i++) {
+            size_t p = i % np;
+            ops.lzp_filter(t, out->order2, pkts[p], fbuf, lens[p]);
+        }
+
+        /* Filter and unfilter timed as separate passes, table in cache */
+        uint64_t t0 = bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            size_t p = i % np;
+            ops.lzp_filter(t, out->order2, pkts[p], filt + p * BENCH_CORPUS_MAX_PKT, lens[p]);
+        }
+        uint64_t t1 = bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            size_t p = i % np;
+            ops.lzp_unfilter(t, out->order2, filt + p * BENCH_CORPUS_MAX_PKT, NULL,
+                             fbuf, lens[p]);
+        }
+        uint64_t t2 = bench_now_ns();
+        out->filter_ns[v]   = (double)(t1 - t0) / (double)count;
+        out->unfilter_ns[v] = (double)(t2 - t1) / (double)count;
+
+        for (size_t p = 0; p < np; p++) {
+            ops.lzp_unfilter(t, out->order2, filt + p * BENCH_CORPUS_MAX_PKT, NULL,
+                             fbuf, lens[p]);
+            if (memcmp(fbuf, pkts[p], lens[p]) != 0) {
+                fprintf(stderr, "  [lzp] round-trip mismatch\n");
+                goto done;
+            }
+        }
+
+        /* Time and misses with the caches refilled by other work (other
+         * connections) between packets */
+        uint64_t cold_ns = 0;
+        bench_perf_take(&perf, 0);
+        bench_perf_take(&perf, 1);
+        for (size_t p = 0; p < np; p++) {
+            for (size_t k = 0; k < BENCH_LZP_EVICT_BYTES; k += 64) evict[k]++;
+            bench_perf_enable(&perf, 1);
+            uint64_t c0 = bench_now_ns();
+            ops.lzp_filter(t, out->order2, pkts[p], fbuf, lens[p]);
+            ops.lzp_unfilter(t, out->order2, fbuf, NULL, fbuf, lens[p]);
+            cold_ns += bench_now_ns() - c0;
+            bench_perf_enable(&perf, 0);
+        }
+        out->cold_ns[v]  = (double)cold_ns / (double)np;
+        out->l1d_miss[v] = (double)bench_perf_take(&perf, 0) / (double)np;
+        out->llc_miss[v] = (double)bench_perf_take(&perf, 1) / (double)np;
+    }
+    rc = 0;
+
+done:
+    bench_perf_close(&perf);
+    free(evict);
+    free(lens);
+    free(pkts);
+    free(filt);
+    free(store);
+    free(packed);
+    free(dense);
+    return rc;
+}
+
+/* =========================================================================
+ * Public: bench_lzp_print
+ * ========================================================================= */
+
+void bench_lzp_print(const bench_lzp_result_t *r)
+{
+    static const char *const layout[2] = { "dense", "packed" };
+    printf("%-40s %.6s  packets=%zu  entries=%u (%.1f%%)  %s  dict=%s\n"
+           "  %-7s %9s %10s %9s %10s %11s %9s %9s %9s\n",
+           r->compressor, bench_workload_name(r->workload), r->packets,
+           r->entries, 100.0 * (double)r->entries / (double)NETC_LZP_HT_SIZE,
+           r->order2 ? "order-2" : "order-1", layout[r->dict_packed ? 1 : 0],
+           "layout", "bytes", "lines/pkt", "ws lines", "filter ns", "unfilter ns",
+           "cold ns", "L1D/pkt", "LLC/pkt");
+    for (int v = 0; v < 2; v++) {
+        printf("  %-7s %9zu %10.1f %9zu %10.1f %11.1f %9.1f",
+               layout[v], r->table_bytes[v], r->lines_per_pkt[v], r->ws_lines[v],
+               r->filter_ns[v], r->unfilter_ns[v], r->cold_ns[v]);
+        if (r->hw_counters) printf(" %9.1f %9.1f\n", r->l1d_miss[v], r->llc_miss[v]);
+        else                printf(" %9s %9s\n", "n.a.", "n.a.");
+    }
+}
+
+/* =========================================================================
+ * Dictionary training scaling
+ * ========================================================================= */
+
+#define BENCH_TRAIN_REPS 3
+
+/* Train once with the given thread count; *blob receives the saved dict. */
+static int train_timed(const uint8_t * const *pkts, const size_t *lens, size_t n,
+                       uint32_t threads, double *ms, void **blob, size_t *blob_sz)
+{
+    netc_train_cfg_t tc;
+    memset(&tc, 0, sizeof(tc));
+    tc.threads = threads;
+    netc_dict_t *d = NULL;
+    uint64_t t0 = bench_now_ns();
+    netc_result_t rc = netc_dict_train_ex(pkts, lens, n, 1, &tc, &d);
+    uint64_t t1 = bench_now_ns();
+    if (rc != NETC_OK) return -1;
+    *ms = (double)(t1 - t0) / 1e6;
+    rc = netc_dict_save(d, blob, blob_sz);
+    netc_dict_free(d);
+    return rc == NETC_OK ? 0 : -1;
+}
+
+int bench_train_run(bench_workload_t      wl,
+                    uint64_t              seed,
+                    size_t                n_train,
+                    uint32_t              max_threads,
+                    bench_train_result_t *out)
+{
+    if (!out || n_train == 0) return -1;
+    memset(out, 0, sizeof(*out));
+    out->workload = wl;
+    if (max_threads == 0) max_threads = 1;
+
+    uint8_t  *storage = (uint8_t *)malloc(n_train * BENCH_CORPUS_MAX_PKT);
+    uint8_t **bufs    = (uint8_t **)malloc(n_train * sizeof(uint8_t *));
+    size_t   *lens    = (size_t *)malloc(n_train * sizeof(size_t));
+    void     *ref     = NULL;
+    size_t    ref_sz  = 0;
+    int       ret     = -1;
+    if (!storage || !bufs || !lens) goto done;
+
+    bench_corpus_train(wl, seed, bufs, lens, n_train, storage);
+    out->packets = n_train;
+    for (size_t i = 0; i < n_train; i++) out->original_bytes += lens[i];
+
+    for (uint32_t t = 1; out->n_rows < BENCH_TRAIN_MAX_ROWS; t *= 2) {
+        if (t > max_threads) t = max_threads;
+        double best = 0.0;
+        for (int rep = 0; rep < BENCH_TRAIN_REPS; rep++) {
+            double ms = 0.0;
+            void  *blob = NULL;
+            size_t blob_sz = 0;
+            if (train_timed((const uint8_t * const *)bufs, lens, n_train, t,
+                            &ms, &blob, &blob_sz) != 0) goto done;
+            if (ref == NULL) {
+                ref = blob;
+                ref_sz = blob_sz;
+            } else {
+                int same = (blob_sz == ref_sz && memcmp(blob, ref, ref_sz) == 0);
+                netc_dict_free_blob(blob);
+                if (!same) {
+                    fprintf(stderr, "  [train] dict mismatch at %u threads\n", t);
+                    goto done;
+                }
+            }
+            if (rep == 0 || ms < best) best = ms;
+        }
+        out->threads[out->n_rows]  = t;
+        out->train_ms[out->n_rows] = best;
+        out->n_rows++;
+        if (t == max_threads) break;
+    }
+    ret = 0;
+
+done:
+    netc_dict_free_blob(ref);
+    free(lens);
+    free(bufs);
+    free(storage);
+    return ret;
+}
+
+void bench_train_print(const bench_train_result_t *r)
+{
+    printf("netc train %.6s  packets=%llu  bytes=%llu\n",
+           bench_workload_name(r->workload),
+           (unsigned long long)r->packets,
+           (unsigned long long)r->original_bytes);
+    for (int k = 0; k < r->n_rows; k++) {
+        printf("  threads=%-3u %9.1f ms  speedup %5.2fx  %8.1f MB/s\n",
+               r->threads[k], r->train_ms[k],
+               r->train_ms[k] > 0.0 ? r->train_ms[0] / r->train_ms[k] : 0.0,
+               r->train_ms[k] > 0.0
+                   ? (double)r->original_bytes / (r->train_ms[k] * 1e3) : 0.0);
+    }
+}
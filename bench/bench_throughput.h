@@ -13,12 +13,28 @@
  *     (millions of packets per second).
  *
  * Both modes work with any bench_compressor_t adapter.
+ *
+ *   Batch:
+ *     netc only.  Compress/decompress the same packet sequence once through
+ *     per-call netc_compress/netc_decompress and once through
+ *     netc_compress_batch/netc_decompress_batch, and report both Mpps.
+ *
+ *   SIMD:
+ *     netc only.  Pack workload packets into wide frames (default 4 KB, the
+ *     8-state interleaved PCTX range), then compress/decompress the frame
+ *     sequence once per SIMD level and report MB/s per level.
+ *
+ *   Train:
+ *     netc only.  Train a dictionary on the workload's training corpus with
+ *     netc_dict_train_ex at 1, 2, 4, … threads and report time and speedup.
  */
 
 #ifndef BENCH_THROUGHPUT_H
 #define BENCH_THROUGHPUT_H
 
 #include "bench_compressor.h"
+#include "bench_netc.h"
+#include "bench_stats.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -90,6 +106,318 @@ int bench_mpps_run(bench_workload_t           wl,
 /** Print a throughput result to stdout (table format). */
 void bench_throughput_print(const bench_throughput_result_t *r);
 
+/* =========================================================================
+ * Batch vs per-call comparison (netc only)
+ * ========================================================================= */
+
+typedef struct {
+    const char      *compressor;
+    bench_workload_t workload;
+    size_t           batch_size;
+
+    uint64_t  packets;
+    uint64_t  original_bytes;
+    uint64_t  compressed_bytes;
+
+    double    percall_compress_mpps;
+    double    percall_decompress_mpps;
+    double    batch_compress_mpps;
+    double    batch_decompress_mpps;
+} bench_batch_result_t;
+
+/**
+ * Run the per-call vs batch comparison on a stateful netc adapter.
+ *
+ * Both passes process the same cfg->count packets from a freshly reset
+ * context pair, in groups of batch_size for the batch pass.  The batch
+ * output is verified byte-for-byte against the per-call output.
+ *
+ * Returns 0 on success, -1 on error or output mismatch.
+ */
+int bench_batch_run(const bench_throughput_cfg_t *cfg,
+                    bench_workload_t               wl,
+                    bench_netc_t                  *n,
+                    size_t                         batch_size,
+                    bench_batch_result_t          *out);
+
+/** Print a batch comparison result to stdout (table format). */
+void bench_batch_print(const bench_batch_result_t *r);
+
+/* =========================================================================
+ * Per-SIMD-level comparison on wide frames (netc only)
+ * ========================================================================= */
+
+#define BENCH_SIMD_MAX_LEVELS 4
+
+typedef struct {
+    bench_workload_t workload;
+    size_t           frame_size;
+
+    uint64_t  frames;
+    uint64_t  original_bytes;
+    uint64_t  compressed_bytes;
+    uint64_t  x8_frames;          /* frames encoded as 8-state PCTX */
+
+    int       n_levels;
+    uint8_t   level[BENCH_SIMD_MAX_LEVELS];          /* actual level per row */
+    double    compress_mbs[BENCH_SIMD_MAX_LEVELS];
+    double    decompress_mbs[BENCH_SIMD_MAX_LEVELS];
+} bench_simd_result_t;
+
+/**
+ * Run the per-SIMD-level comparison.
+ *
+ * cfg->count workload packets are concatenated into frames of frame_size
+ * bytes; a dictionary is trained on the first frames (wide offsets need
+ * their own buckets).  For each of generic, SSE4.2 and AVX2 that the CPU
+ * supports, a stateful context pair with that simd_level compresses and
+ * decompresses the whole frame sequence; the output is verified.  Forcing
+ * AVX2 also enables the X8 tANS decode kernel, which auto-detect leaves off.
+ *
+ * flags: NETC_CFG_FLAG_* (STATEFUL is implied, COMPACT_HDR is ignored).
+ * Returns 0 on success, -1 on error or round-trip mismatch.
+ */
+int bench_simd_run(const bench_throughput_cfg_t *cfg,
+                   bench_workload_t               wl,
+                   uint32_t                       flags,
+                   size_t                         frame_size,
+                   bench_simd_result_t           *out);
+
+/** Print a per-SIMD-level result to stdout (table format). */
+void bench_simd_print(const bench_simd_result_t *r);
+
+
+/* =========================================================================
+ * Static rANS vs tANS PCTX entropy-stage comparison (netc only)
+ * ========================================================================= */
+
+typedef struct {
+    double   compress_mbs;
+    double   decompress_mbs;
+    uint64_t payload_bytes;      /* states + stream, summed over frames */
+    size_t   table_bytes;        /* one per-bucket table */
+} bench_codec_row_t;
+
+typedef struct {
+    bench_workload_t  workload;
+    size_t            frame_size;
+    uint64_t          frames;
+    uint64_t          original_bytes;
+    bench_codec_row_t tans;      /* netc_tans_encode/decode_pctx */
+    bench_codec_row_t rans;      /* netc_rans_encode/decode_pctx */
+} bench_rans_result_t;
+
+/**
+ * Compare the two static per-position entropy coders on the same tables.
+ *
+ * Frames are packed and a dictionary trained as in bench_simd_run; every
+ * frame is then coded directly (no delta, LZP or header) with the dict's
+ * tANS PCTX tables and with its rANS tables.  Both outputs are verified.
+ * MB/s is the best of several passes.
+ *
+ * Returns 0 on success, -1 on error or round-trip mismatch.
+ */
+int bench_rans_run(const bench_throughput_cfg_t *cfg,
+                   bench_workload_t               wl,
+                   size_t                         frame_size,
+                   bench_rans_result_t           *out);
+
+/** Print a rANS vs tANS result to stdout (table format). */
+void bench_rans_print(const bench_rans_result_t *r);
+
+/* =========================================================================
+ * Many connections on one thread: private arenas vs shared scratch
+ * ========================================================================= */
+
+typedef struct {
+    const char      *compressor;
+    bench_workload_t workload;
+    size_t           conns;
+
+    uint64_t  packets;
+    uint64_t  original_bytes;
+    uint64_t  compressed_bytes;
+
+    size_t    private_ctx_bytes;  /* mean netc_ctx_memory_usage().total */
+    size_t    shared_ctx_bytes;   /* same, EXTERNAL_SCRATCH contexts */
+    size_t    scratch_bytes;      /* the one shared scratch arena */
+
+    double    private_mpps;       /* compress + decompress round trip */
+    double    shared_mpps;
+} bench_conns_result_t;
+
+/**
+ * Run the many-connections comparison on a netc adapter's dictionary.
+ *
+ * Two sets of conns encoder/decoder pairs are created with the adapter's
+ * flags and level: one with private arenas, one with
+ * NETC_CFG_FLAG_EXTERNAL_SCRATCH and a single netc_scratch_t shared by
+ * every context.  cfg->count packets are dealt round-robin across the
+ * connections, compressed and decompressed one at a time; the shared
+ * output is verified byte-for-byte against the private output and the
+ * original packets.
+ *
+ * Returns 0 on success, -1 on error or output mismatch.
+ */
+int bench_conns_run(const bench_throughput_cfg_t *cfg,
+                    bench_workload_t               wl,
+                    bench_netc_t                  *n,
+                    size_t                         conns,
+                    bench_conns_result_t          *out);
+
+/** Print a many-connections result to stdout (table format). */
+void bench_conns_print(const bench_conns_result_t *r);
+
+/* =========================================================================
+ * Connection storm: adaptive context creation cost (netc only)
+ * ========================================================================= */
+
+#define BENCH_STORM_PHASES 3   /* created, first packet, first rebuild */
+
+typedef struct {
+    const char      *compressor;
+    bench_workload_t workload;
+    size_t           conns;
+
+    double    create_ns;        /* mean netc_ctx_create per context */
+    double    destroy_ns;       /* mean netc_ctx_destroy per context */
+    /* Per context, after each phase: RSS growth since before creation
+     * (0 where the platform does not report RSS) and netc_ctx_memory_usage */
+    size_t    rss_bytes[BENCH_STORM_PHASES];
+    size_t    ctx_bytes[BENCH_STORM_PHASES];
+} bench_storm_result_t;
+
+/**
+ * Run the connection-storm benchmark on a netc adapter's dictionary.
+ *
+ * Creates conns adaptive encoder/decoder pairs back to back, then drives
+ * every connection through one packet and through a full adaptive rebuild
+ * interval, recording creation and destruction time and the per-context
+ * footprint after each phase.
+ *
+ * Returns 0 on success, -1 on error or round-trip mismatch.
+ */
+int bench_storm_run(const bench_throughput_cfg_t *cfg,
+                    bench_workload_t               wl,
+                    bench_netc_t                  *n,
+                    size_t                         conns,
+                    bench_storm_result_t          *out);
+
+/** Print a connection-storm result to stdout (table format). */
+void bench_storm_print(const bench_storm_result_t *r);
+
+/* =========================================================================
+ * Adaptive latency tail (netc only)
+ * ========================================================================= */
+
+typedef struct {
+    const char      *compressor;
+    bench_workload_t workload;
+    size_t           packets;
+
+    bench_stats_t    compress;          /* per-packet latency */
+    bench_stats_t    decompress;
+    uint64_t         compress_p9999_ns;
+    uint64_t         decompress_p9999_ns;
+    /* Mean compress latency over the last NETC_CTX_COUNT packets of each
+     * rebuild interval (where table rebuilds happen) and over the rest */
+    double           window_ns;
+    double           steady_ns;
+} bench_tail_result_t;
+
+/**
+ * Run the adaptive latency-tail benchmark on a netc adapter's dictionary.
+ *
+ * One adaptive encoder/decoder pair (the adapter's flags plus
+ * NETC_CFG_FLAG_ADAPTIVE) codes cfg->warmup + cfg->count packets; each of
+ * the last cfg->count is timed individually, so table rebuilds show up in
+ * the p99.9 / p99.99 / max columns.
+ *
+ * Returns 0 on success, -1 on error or round-trip mismatch.
+ */
+int bench_tail_run(const bench_throughput_cfg_t *cfg,
+                   bench_workload_t               wl,
+                   bench_netc_t                  *n,
+                   bench_tail_result_t           *out);
+
+/** Print a latency-tail result to stdout (table format). */
+void bench_tail_print(const bench_tail_result_t *r);
+
+/* =========================================================================
+ * LZP table layout (netc only)
+ * ========================================================================= */
+
+typedef struct {
+    const char      *compressor;
+    bench_workload_t workload;
+    size_t           packets;
+    int              order2;           /* dual-order table */
+    uint32_t         entries;          /* occupied slots */
+    int              dict_packed;      /* layout the dictionary holds */
+
+    /* [0] dense, [1] packed */
+    size_t           table_bytes[2];
+    double           lines_per_pkt[2]; /* distinct 64-byte lines read per packet */
+    size_t           ws_lines[2];      /* distinct lines over the whole run */
+    double           filter_ns[2];     /* per packet, table in cache */
+    double           unfilter_ns[2];
+    /* Per packet, filter + unfilter after an L2-sized eviction */
+    double           cold_ns[2];
+    int              hw_counters;      /* 1 when the miss counts were measured */
+    double           l1d_miss[2];
+    double           llc_miss[2];
+} bench_lzp_result_t;
+
+/**
+ * Compare the dense and the packed layout of a netc adapter's trained LZP
+ * table.  cfg->count workload packets are filtered and unfiltered with
+ * each layout (cfg->warmup passes first); the cache-line counts are
+ * modelled from the slots every lookup reads, the miss counts come from
+ * the CPU's counters where available (Linux perf events).
+ *
+ * Returns 0 on success, -1 on error, round-trip mismatch or a dictionary
+ * without an LZP table.
+ */
+int bench_lzp_run(const bench_throughput_cfg_t *cfg,
+                  bench_workload_t               wl,
+                  bench_netc_t                  *n,
+                  bench_lzp_result_t            *out);
+
+/** Print an LZP layout result to stdout (table format). */
+void bench_lzp_print(const bench_lzp_result_t *r);
+
+/* =========================================================================
+ * Dictionary training scaling (netc only)
+ * ========================================================================= */
+
+#define BENCH_TRAIN_MAX_ROWS 8   /* 1, 2, 4, … 64 threads, plus an odd max */
+
+typedef struct {
+    bench_workload_t workload;
+    uint64_t  packets;
+    uint64_t  original_bytes;
+
+    int       n_rows;
+    uint32_t  threads[BENCH_TRAIN_MAX_ROWS];
+    double    train_ms[BENCH_TRAIN_MAX_ROWS];   /* best of several runs */
+} bench_train_result_t;
+
+/**
+ * Time netc_dict_train_ex on n_train workload packets at 1, 2, 4, … threads
+ * up to max_threads (always including max_threads itself).  Every
+ * dictionary is verified byte-for-byte against the serial one.
+ *
+ * Returns 0 on success, -1 on error or dictionary mismatch.
+ */
+int bench_train_run(bench_workload_t      wl,
+                    uint64_t              seed,
+                    size_t                n_train,
+                    uint32_t              max_threads,
+                    bench_train_result_t *out);
+
+/** Print a training scaling result to stdout (table format). */
+void bench_train_print(const bench_train_result_t *r);
+
 #ifdef __cplusplus
 }
 #endif
@@ -117,7 +117,8 @@ typedef enum netc_result {
 /** tANS (FSE) — primary codec, v0.1+. */
 #define NETC_ALG_TANS     0x01U
 
-/** rANS — secondary codec, deferred to v0.2. */
+/** Static interleaved rANS over the dict's PCTX tables (level >= 6,
+ *  packets >= 1 KB). Upper bit 0x10: LZP pre-filter applied. */
 #define NETC_ALG_RANS     0x02U
 
 /** Cross-packet LZ77 with ring-buffer history (v0.3+).
@@ -126,7 +127,10 @@ typedef enum netc_result {
  *    [10llllll][oooooooo]        short back-ref: len=bits[5:0]+3, offset=byte+1 (within-packet, 1–256)
  *    [11llllll][oo oooooo oooooooo] long back-ref: len=bits[5:0]+3, offset=u16le+1 (ring+dst, 1–65536)
  *  Encoder appends decoded bytes to ring buffer after each packet.
- *  Decoder reads from ring[ring_pos - offset .. ring_pos - 1] for long refs. */
+ *  Decoder reads from ring[ring_pos - offset .. ring_pos - 1] for long refs.
+ *  Upper bit 0x10: the token stream is tANS-coded with the dictionary's
+ *  trained token tables (dict with LZ77X tables only), payload
+ *  [2B initial state][bitstream]; literals are coded as PCTX codes them. */
 #define NETC_ALG_LZ77X    0x03U
 
 /** Per-position context-adaptive tANS (PCTX, v0.4+).
@@ -135,7 +139,10 @@ typedef enum netc_result {
  *  This gives per-position entropy specialization (like MREG) with ZERO
  *  descriptor overhead — wire format is just [4B initial_state][bitstream].
  *  Preferred over MREG for packets < 512B where MREG descriptor overhead
- *  exceeds the benefit of separate per-region streams. */
+ *  exceeds the benefit of separate per-region streams.
+ *  Upper nibble: 0x10 = LZP pre-filter; 0x20 / 0x40 = 4 / 8 interleaved
+ *  ANS states (packets >= 1 KB / 4 KB), payload [packed 12-bit states]
+ *  [bitstream] — decodes ~2.5x faster on wide packets. */
 #define NETC_ALG_TANS_PCTX 0x04U
 
 /** LZP (Lempel-Ziv Prediction) — hash-context byte prediction (v0.5+).
@@ -197,6 +204,7 @@ typedef enum netc_result {
  *    - Skips the delta-vs-LZP trial (always uses delta when available).
  *    - Skips single-region vs PCTX comparison (always uses PCTX for multi-bucket).
  *    - Skips LZ77 for packets < 512B (instead of the default < 256B threshold).
+ *  Equivalent to capping compression_level at 3.
  *
  *  Typical impact: 2-3x compress throughput gain, 2-5% ratio regression.
  *  Decompressor is unaffected — this flag does NOT need to be set on the
@@ -216,6 +224,58 @@ typedef enum netc_result {
  */
 #define NETC_CFG_FLAG_ADAPTIVE    0x200U
 
+/** Disable cross-packet LZ77 (NETC_ALG_LZ77X).
+ *
+ *  Stateful contexts otherwise keep a ring_buffer_size history ring (64 KB
+ *  by default) so that LZ77X packets can reference earlier payloads.  With
+ *  this flag no ring is allocated and the compressor never emits LZ77X.
+ *  Both compressor and decompressor contexts MUST agree on this flag: a
+ *  decompressor without a ring rejects LZ77X packets (NETC_ERR_UNSUPPORTED).
+ *
+ *  Without the flag, compressor-only contexts at levels 0–1 (which never
+ *  try LZ77X) still allocate the ring lazily, on their first decompress.
+ */
+#define NETC_CFG_FLAG_NO_LZ77X    0x400U
+
+/** External scratch: the context allocates no working arena.
+ *
+ *  Every call must then go through netc_compress_ex / netc_decompress_ex
+ *  with a netc_scratch_t; the plain and batch entry points return
+ *  NETC_ERR_INVALID_ARG.  The context keeps only cross-packet state.
+ *  cfg.arena / cfg.arena_size are ignored.
+ */
+#define NETC_CFG_FLAG_EXTERNAL_SCRATCH 0x800U
+
+/** Reference-selection delta (AD-022).
+ *
+ *  The context keeps the last 8 distinct packets instead of only the
+ *  previous one, and each delta packet is predicted from the most similar
+ *  earlier packet of the same size.  When several are eligible, the
+ *  compressor appends a one-byte reference index to the packet.  Helps
+ *  interleaved message types that share a size.
+ *  Requires NETC_CFG_FLAG_STATEFUL and NETC_CFG_FLAG_DELTA (ignored
+ *  otherwise).  Both compressor and decompressor contexts MUST agree on
+ *  this flag.
+ *  Memory overhead: 8 extra packet-sized history buffers.
+ */
+#define NETC_CFG_FLAG_DELTA_REFS 0x1000U
+
+/** Acknowledged baselines for lossy, unordered transports (AD-023).
+ *
+ *  Delta packets are predicted from the most recent packet the receiver
+ *  has acknowledged (netc_ack) instead of the previous packet, so a lost
+ *  or reordered packet never breaks the ones after it.  Each packet has an
+ *  8-bit sequence number (netc_ctx_last_seq); both sides keep their last
+ *  32 packets by sequence.  A delta packet appends its baseline's sequence
+ *  number; with NETC_CFG_FLAG_COMPACT_HDR every packet also appends its own.
+ *  Requires NETC_CFG_FLAG_STATEFUL and NETC_CFG_FLAG_DELTA (ignored
+ *  otherwise) and implies NETC_CFG_FLAG_NO_LZ77X.  netc_ctx_create returns
+ *  NULL when combined with NETC_CFG_FLAG_ADAPTIVE or NETC_CFG_FLAG_DELTA_REFS,
+ *  which need in-order delivery.  Both contexts MUST agree on this flag.
+ *  Memory overhead: 32 extra packet-sized history buffers.
+ */
+#define NETC_CFG_FLAG_BASELINE   0x2000U
+
 /* =========================================================================
  * Opaque types
  * ========================================================================= */
@@ -226,6 +286,12 @@ typedef struct netc_ctx netc_ctx_t;
 /** Opaque trained dictionary. Thread-safe for concurrent reads. */
 typedef struct netc_dict netc_dict_t;
 
+/** Opaque per-thread working memory, shared by every context a thread drives. */
+typedef struct netc_scratch netc_scratch_t;
+
+/** Opaque streaming dictionary trainer (see netc_trainer_create). */
+typedef struct netc_trainer netc_trainer_t;
+
 /* =========================================================================
  * Statistics
  * ========================================================================= */
@@ -242,14 +308,71 @@ typedef struct netc_stats {
  * Configuration — RFC-001 §10.4
  * ========================================================================= */
 
+/** Default netc_cfg_t.adaptive_decay: counts halve at every rebuild. */
+#define NETC_ADAPTIVE_DECAY_DEFAULT 1U
+/** netc_cfg_t.adaptive_decay value that disables decay; counts are only
+ *  halved when they approach overflow. */
+#define NETC_ADAPTIVE_DECAY_NONE    255U
+
 typedef struct netc_cfg {
     uint32_t flags;             /**< NETC_CFG_FLAG_* bitmask */
     size_t   ring_buffer_size;  /**< Stateful history ring buffer (0 = default 64KB) */
-    uint8_t  compression_level; /**< 0=fastest … 9=best ratio (default: 5) */
+    uint8_t  compression_level; /**< 0=fastest … 9=best ratio (default: 5).
+                                     Selects the encoder's trial budget; a
+                                     zeroed cfg runs at level 0. Values > 9
+                                     behave as 9. Decoder ignores it. */
     uint8_t  simd_level;        /**< 0=auto, 1=generic, 2=SSE4.2, 3=AVX2, 4=NEON */
-    size_t   arena_size;        /**< Working memory arena (0 = default 3000 bytes) */
+    uint8_t  adaptive_decay;    /**< Adaptation rate with NETC_CFG_FLAG_ADAPTIVE:
+                                     each bucket's byte counts lose 1/2^n of
+                                     their weight at every table rebuild, so
+                                     the model tracks a window of about 2^n
+                                     rebuild intervals.  1 (halve) tracks
+                                     fastest, 15 slowest; 0 = default
+                                     (NETC_ADAPTIVE_DECAY_DEFAULT);
+                                     NETC_ADAPTIVE_DECAY_NONE keeps all
+                                     history.  Both contexts MUST agree. */
+    size_t   arena_size;        /**< Working memory arena (0 = default
+                                     2 × NETC_MAX_PACKET_SIZE + 64 bytes) */
+    void    *arena;             /**< Caller-owned arena of arena_size bytes,
+                                     or NULL for a private one. Contexts used
+                                     from one thread may share it: it only
+                                     holds scratch data within a call. Must
+                                     outlive every context using it. */
 } netc_cfg_t;
 
+/* =========================================================================
+ * Training configuration
+ * ========================================================================= */
+
+/** Options for netc_dict_train_ex and netc_trainer_create.
+ *  A zeroed struct selects the defaults. */
+typedef struct netc_train_cfg {
+    uint32_t threads;   /**< Worker threads (0 = one per online CPU, 1 = serial).
+                             Capped at 64 and at the packet count. The
+                             dictionary does not depend on this value. */
+    uint32_t reservoir; /**< netc_trainer_*: packets sampled for the LZP
+                             verify and frequency passes (0 = 65536) */
+    uint64_t seed;      /**< netc_trainer_*: reservoir sampling seed
+                             (0 = fixed default) */
+    uint32_t lzp_order; /**< LZP table: 1 = order-1, 2 = dual-order
+                             (NETC_DICT_FLAG_LZP2), 0 = dual-order only if
+                             it predicts more bytes of held-out packets */
+} netc_train_cfg_t;
+
+/* =========================================================================
+ * Memory usage
+ * ========================================================================= */
+
+/** Heap bytes held by a context (see netc_ctx_memory_usage). */
+typedef struct netc_mem_usage {
+    size_t total;     /**< Sum of the fields below */
+    size_t ctx;       /**< Context struct */
+    size_t history;   /**< Delta history (prev / prev2), grows to the largest packet */
+    size_t ring;      /**< LZ77X history ring and its match index (0 until allocated) */
+    size_t arena;     /**< Private working arena (0 when borrowed via cfg.arena) */
+    size_t adaptive;  /**< Adaptive accumulators, rebuilt tables and LZP overlay/clone */
+} netc_mem_usage_t;
+
 /* =========================================================================
  * Context lifecycle — RFC-001 §10.1
  * ========================================================================= */
@@ -293,6 +416,46 @@ netc_result_t netc_ctx_stats(const netc_ctx_t *ctx, netc_stats_t *out);
  */
 uint8_t netc_ctx_simd_level(const netc_ctx_t *ctx);
 
+/**
+ * Report the heap memory currently held by a context, by component.
+ * The shared dictionary and a borrowed cfg.arena are not counted.
+ * Returns NETC_ERR_CTX_NULL if ctx is NULL, NETC_ERR_INVALID_ARG if out is NULL.
+ */
+netc_result_t netc_ctx_memory_usage(const netc_ctx_t *ctx, netc_mem_usage_t *out);
+
+/* =========================================================================
+ * Acknowledged baselines (NETC_CFG_FLAG_BASELINE)
+ *
+ * The receiving application reads the sequence number of each packet it
+ * decompresses and reports it back over its own channel; the sending
+ * application passes it to netc_ack() on the compressing context.  The
+ * compressor then deltas against the newest acknowledged packet that is
+ * at most 16 packets old, and sends packets whole until one is acknowledged.
+ * ========================================================================= */
+
+/**
+ * Mark packet seq as received by the peer, making it eligible as a delta
+ * baseline.  Older acknowledgements than the newest one are accepted and
+ * ignored.  An ack must be passed in before 256 further packets have been
+ * compressed: the 8-bit sequence number would then name a newer packet.
+ *
+ * Returns NETC_ERR_CTX_NULL if ctx is NULL, NETC_ERR_UNSUPPORTED without
+ * NETC_CFG_FLAG_BASELINE, and NETC_ERR_INVALID_ARG if seq is not one of
+ * the last 16 packets compressed.
+ */
+netc_result_t netc_ack(netc_ctx_t *ctx, uint8_t seq);
+
+/**
+ * Sequence number of the packet most recently compressed or decompressed
+ * through ctx (NETC_CFG_FLAG_BASELINE).  The first packet after creation
+ * or netc_ctx_reset() is 0.
+ *
+ * Returns NETC_ERR_CTX_NULL if ctx is NULL, NETC_ERR_INVALID_ARG if seq is
+ * NULL or no packet has gone through ctx yet, and NETC_ERR_UNSUPPORTED
+ * without NETC_CFG_FLAG_BASELINE.
+ */
+netc_result_t netc_ctx_last_seq(const netc_ctx_t *ctx, uint8_t *seq);
+
 /* =========================================================================
  * Dictionary management — RFC-001 §10.2
  * ========================================================================= */
@@ -317,6 +480,62 @@ netc_result_t netc_dict_train(
     netc_dict_t          **out_dict
 );
 
+/**
+ * Train a dictionary, spreading the work across threads.
+ *
+ * Same corpus rules and result as netc_dict_train(): the trained dictionary
+ * is bit-identical for every thread count. cfg may be NULL (threads = 0,
+ * one per online CPU). netc_dict_train() is this call with threads = 1.
+ */
+netc_result_t netc_dict_train_ex(
+    const uint8_t * const  *packets,
+    const size_t           *sizes,
+    size_t                  count,
+    uint8_t                 model_id,
+    const netc_train_cfg_t *cfg,
+    netc_dict_t           **out_dict
+);
+
+/**
+ * Create a streaming dictionary trainer for corpora too large to hold in
+ * memory. Packets are fed one at a time; the bigram class map, LZP votes
+ * and delta statistics see every packet and the LZ77X token counts the
+ * first 4 MB, in arrival order, while the LZP verify and frequency passes
+ * run over a uniform sample of at most cfg->reservoir packets. Memory is
+ * ~1.4 MB of fixed state plus the sampled packets.
+ *
+ * cfg may be NULL for defaults. Returns NULL on allocation failure.
+ */
+netc_trainer_t *netc_trainer_create(const netc_train_cfg_t *cfg);
+
+/** Destroy a trainer. Safe to call with NULL. */
+void netc_trainer_destroy(netc_trainer_t *trainer);
+
+/** Discard everything fed so far; the trainer keeps its buffers. */
+void netc_trainer_reset(netc_trainer_t *trainer);
+
+/**
+ * Feed one packet. NULL or empty packets are skipped and packets longer
+ * than NETC_MAX_PACKET_SIZE are truncated, as by netc_dict_train().
+ * Returns NETC_ERR_NOMEM if the packet could not be sampled; the trainer
+ * is then unchanged.
+ */
+netc_result_t netc_trainer_feed(netc_trainer_t *trainer, const uint8_t *pkt, size_t size);
+
+/** Number of (non-empty) packets fed since creation or the last reset. */
+uint64_t netc_trainer_count(const netc_trainer_t *trainer);
+
+/**
+ * Build a dictionary from everything fed so far, using cfg->threads
+ * workers. The trainer is left intact and may be fed further. While no
+ * more than cfg->reservoir packets have been fed, the result equals
+ * netc_dict_train() over the same packets.
+ *
+ * Returns NETC_OK on success. The caller owns the returned dictionary.
+ */
+netc_result_t netc_trainer_finish(netc_trainer_t *trainer, uint8_t model_id,
+                                  netc_dict_t **out_dict);
+
 /**
  * Load a dictionary from a binary blob (previously produced by netc_dict_save).
  * Validates the embedded CRC32 checksum before accepting.
@@ -337,13 +556,45 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out);
 netc_result_t netc_dict_save(const netc_dict_t *dict, void **out, size_t *out_size);
 
 /**
- * Free a binary blob returned by netc_dict_save.
+ * Serialize a dictionary's built coding tables to a newly allocated image
+ * for netc_dict_map(). Unlike the netc_dict_save() blob, the image stores
+ * the tANS/rANS tables and the LZP table in native in-memory layout, so it
+ * is only portable between builds with the same byte order and table
+ * layout (others reject it with NETC_ERR_VERSION).
+ *
+ * The caller must free *out with netc_dict_free_blob().
+ */
+netc_result_t netc_dict_save_image(const netc_dict_t *dict, void **out, size_t *out_size);
+
+/**
+ * Map a dictionary image file written from netc_dict_save_image().
+ *
+ * The file is mapped read-only and shared; the CRC32 is validated once and
+ * the tables are used in place with no rebuild, so processes mapping the
+ * same file share its pages. The mapping lives until netc_dict_free().
+ * The image is trusted input: the CRC detects corruption, not tampering.
+ *
+ * Returns NETC_ERR_INVALID_ARG if the file cannot be opened and
+ * NETC_ERR_UNSUPPORTED on platforms without memory-mapped files.
+ */
+netc_result_t netc_dict_map(const char *path, netc_dict_t **out);
+
+/**
+ * Same as netc_dict_map() over an image already in memory. The image is
+ * borrowed: it must stay valid and unmodified until netc_dict_free(), and
+ * must be aligned for the tables it holds (any malloc'd buffer is).
+ */
+netc_result_t netc_dict_map_image(const void *image, size_t size, netc_dict_t **out);
+
+/**
+ * Free a binary blob returned by netc_dict_save or netc_dict_save_image.
  * Passing NULL is safe (no-op).
  */
 void netc_dict_free_blob(void *blob);
 
 /**
- * Free a dictionary returned by netc_dict_train or netc_dict_load.
+ * Free a dictionary returned by netc_dict_train, netc_dict_load or
+ * netc_dict_map / netc_dict_map_image (unmapping the file, if any).
  * Passing NULL is safe (no-op).
  */
 void netc_dict_free(netc_dict_t *dict);
@@ -427,6 +678,108 @@ netc_result_t netc_decompress_stateless(
     size_t            *dst_size
 );
 
+/* =========================================================================
+ * Per-thread scratch
+ *
+ * A compress or decompress call needs up to ~128 KB of working memory
+ * that does not outlive the call.  A worker thread multiplexing many
+ * connections creates one netc_scratch_t and passes it to every _ex call;
+ * contexts created with NETC_CFG_FLAG_EXTERNAL_SCRATCH then hold only
+ * cross-packet state, and the thread's scratch stays hot in cache.
+ * ========================================================================= */
+
+/**
+ * Create a scratch of arena_size bytes (0 = default 2 × NETC_MAX_PACKET_SIZE
+ * + 64, enough for every trial on every packet size).
+ * Returns NULL on allocation failure.
+ */
+netc_scratch_t *netc_scratch_create(size_t arena_size);
+
+/** Free a scratch. Passing NULL is safe (no-op). */
+void netc_scratch_destroy(netc_scratch_t *scratch);
+
+/**
+ * netc_compress using scratch as working memory.
+ *
+ * scratch may be NULL for a context with its own arena.  Output is
+ * bit-identical to netc_compress on a context whose arena has the same size.
+ * Not thread-safe: a scratch must not be used by two calls at once.
+ */
+netc_result_t netc_compress_ex(
+    netc_ctx_t     *ctx,
+    netc_scratch_t *scratch,
+    const void     *src,
+    size_t          src_size,
+    void           *dst,
+    size_t          dst_cap,
+    size_t         *dst_size
+);
+
+/** netc_decompress using scratch as working memory (see netc_compress_ex). */
+netc_result_t netc_decompress_ex(
+    netc_ctx_t     *ctx,
+    netc_scratch_t *scratch,
+    const void     *src,
+    size_t          src_size,
+    void           *dst,
+    size_t          dst_cap,
+    size_t         *dst_size
+);
+
+/* =========================================================================
+ * Batch API
+ * ========================================================================= */
+
+/**
+ * Compress count packets in order through one stateful context.
+ *
+ * srcs[i] / src_sizes[i] describe packet i (each ≤ NETC_MAX_PACKET_SIZE).
+ * Compressed packets are written back-to-back into the single arena dst;
+ * offsets must have room for count + 1 entries and receives the start of
+ * each packet, with offsets[count] set to the total bytes written.
+ * Size dst as the sum of netc_compress_bound(src_sizes[i]).
+ *
+ * Argument checks, the header mode and the working arena are resolved
+ * once for the whole batch; the tANS and LZP tables are still looked up
+ * per packet, as adaptive contexts switch to their own copies mid-stream.
+ * Output is bit-identical to calling netc_compress on each packet in turn.
+ *
+ * n_done (optional): receives the number of packets fully written.  On
+ * error, packets [0, *n_done) are valid and the context has advanced past
+ * them; the failing packet leaves the context as netc_compress would.
+ */
+netc_result_t netc_compress_batch(
+    netc_ctx_t        *ctx,
+    const void *const *srcs,
+    const size_t      *src_sizes,
+    size_t             count,
+    void              *dst,
+    size_t             dst_cap,
+    size_t            *offsets,
+    size_t            *n_done
+);
+
+/**
+ * Decompress count packets in order through one stateful context.
+ *
+ * srcs[i] / src_sizes[i] are compressed packets as produced by
+ * netc_compress or netc_compress_batch.  Decompressed packets are written
+ * back-to-back into dst; offsets (count + 1 entries) receives the start of
+ * each packet and offsets[count] the total bytes written.
+ *
+ * n_done (optional): receives the number of packets fully decompressed.
+ */
+netc_result_t netc_decompress_batch(
+    netc_ctx_t        *ctx,
+    const void *const *srcs,
+    const size_t      *src_sizes,
+    size_t             count,
+    void              *dst,
+    size_t             dst_cap,
+    size_t            *offsets,
+    size_t            *n_done
+);
+
 /* =========================================================================
  * Utility
  * ========================================================================= */
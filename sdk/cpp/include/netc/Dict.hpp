@@ -42,6 +42,11 @@ public:
     static Result LoadFromFile(
         const std::string& file_path, Dict& out_dict);
 
+    /// Map a dictionary image file (see SaveImageToFile) read-only and
+    /// shared; the tables are used in place until the Dict is destroyed.
+    static Result MapFromFile(
+        const std::string& file_path, Dict& out_dict);
+
     // -- Serialization --
 
     /// Serialize to a binary blob.
@@ -50,6 +55,10 @@ public:
     /// Save to a file on disk.
     Result SaveToFile(const std::string& file_path) const;
 
+    /// Save the built tables as an image for MapFromFile. Images are only
+    /// portable between builds with the same byte order and table layout.
+    Result SaveImageToFile(const std::string& file_path) const;
+
     // -- Inspection --
 
     /// True if the dictionary holds a valid trained model.
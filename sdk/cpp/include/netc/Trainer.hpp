@@ -1,7 +1,9 @@
 /**
  * netc/Trainer.hpp — Dictionary trainer for the netc C++ SDK.
  *
- * Accumulates a packet corpus and produces a trained Dict.
+ * Wraps the streaming netc_trainer_t: packets are folded into fixed-size
+ * statistics as they are added, plus a bounded reservoir sample, so the
+ * corpus itself is never held in memory.
  */
 
 #pragma once
@@ -12,30 +14,42 @@
 #include <cstddef>
 #include <vector>
 
+struct netc_trainer;
+
 namespace netc {
 
 class Trainer final {
 public:
-    Trainer() = default;
+    /// reservoir: packets sampled for the verify/frequency passes (0 = 65536).
+    /// threads: workers used by Train (0 = one per online CPU).
+    explicit Trainer(uint32_t reservoir = 0, uint32_t threads = 0);
+
+    /// Move-only.
+    Trainer(Trainer&& other) noexcept;
+    Trainer& operator=(Trainer&& other) noexcept;
+    Trainer(const Trainer&) = delete;
+    Trainer& operator=(const Trainer&) = delete;
+
+    ~Trainer();
 
     /// Add a single packet to the training corpus.
-    void AddPacket(const uint8_t* data, size_t size);
+    Result AddPacket(const uint8_t* data, size_t size);
 
     /// Add multiple packets at once.
-    void AddPackets(const std::vector<std::vector<uint8_t>>& packets);
+    Result AddPackets(const std::vector<std::vector<uint8_t>>& packets);
 
-    /// Number of packets in the corpus.
+    /// Number of packets added since construction or the last Reset.
     size_t GetCorpusCount() const noexcept;
 
     /// Train a dictionary from the accumulated corpus.
-    /// model_id: 1-254.
+    /// model_id: 1-254. The trainer is left intact and may keep growing.
     Result Train(uint8_t model_id, Dict& out_dict) const;
 
-    /// Clear all accumulated packets.
+    /// Clear all accumulated statistics.
     void Reset();
 
 private:
-    std::vector<std::vector<uint8_t>> corpus_;
+    netc_trainer* native_ = nullptr;
 };
 
 } // namespace netc
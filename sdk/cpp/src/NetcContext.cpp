@@ -31,7 +31,9 @@ Context::Context(
     cfg.ring_buffer_size  = 0;
     cfg.compression_level = level;
     cfg.simd_level        = 0;
+    cfg.adaptive_decay    = 0;
     cfg.arena_size        = 0;
+    cfg.arena             = nullptr;
 
     native_ = netc_ctx_create(dict.GetNativeDict(), &cfg);
 }
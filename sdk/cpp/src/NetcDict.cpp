@@ -78,8 +78,37 @@ Result Dict::LoadFromFile(
     return LoadFromBytes(buf.data(), buf.size(), out_dict);
 }
 
+Result Dict::MapFromFile(
+    const std::string& file_path, Dict& out_dict)
+{
+    netc_dict_t* raw = nullptr;
+    netc_result_t r = netc_dict_map(file_path.c_str(), &raw);
+    if (r != NETC_OK) {
+        return static_cast<Result>(r);
+    }
+    netc_dict_free(out_dict.native_);
+    out_dict.native_ = raw;
+    return Result::OK;
+}
+
 // -- Serialization --
 
+static Result WriteFile(const std::string& file_path,
+                        const void* data, size_t size)
+{
+    FILE* f = std::fopen(file_path.c_str(), "wb");
+    if (f == nullptr) {
+        return Result::InvalidArg;
+    }
+    size_t written = std::fwrite(data, 1, size, f);
+    std::fclose(f);
+
+    if (written != size) {
+        return Result::InvalidArg;
+    }
+    return Result::OK;
+}
+
 Result Dict::SaveToBytes(std::vector<uint8_t>& out_bytes) const {
     if (native_ == nullptr) {
         return Result::InvalidArg;
@@ -102,18 +131,22 @@ Result Dict::SaveToFile(const std::string& file_path) const {
     if (r != Result::OK) {
         return r;
     }
+    return WriteFile(file_path, blob.data(), blob.size());
+}
 
-    FILE* f = std::fopen(file_path.c_str(), "wb");
-    if (f == nullptr) {
+Result Dict::SaveImageToFile(const std::string& file_path) const {
+    if (native_ == nullptr) {
         return Result::InvalidArg;
     }
-    size_t written = std::fwrite(blob.data(), 1, blob.size(), f);
-    std::fclose(f);
-
-    if (written != blob.size()) {
-        return Result::InvalidArg;
+    void* image = nullptr;
+    size_t image_size = 0;
+    netc_result_t r = netc_dict_save_image(native_, &image, &image_size);
+    if (r != NETC_OK) {
+        return static_cast<Result>(r);
     }
-    return Result::OK;
+    Result w = WriteFile(file_path, image, image_size);
+    netc_dict_free_blob(image);
+    return w;
 }
 
 // -- Inspection --
@@ -10,39 +10,55 @@ extern "C" {
 
 namespace netc {
 
-void Trainer::AddPacket(const uint8_t* data, size_t size) {
-    if (data != nullptr && size > 0) {
-        corpus_.emplace_back(data, data + size);
+Trainer::Trainer(uint32_t reservoir, uint32_t threads) {
+    netc_train_cfg_t cfg = {};
+    cfg.threads   = threads;
+    cfg.reservoir = reservoir;
+    native_ = netc_trainer_create(&cfg);
+}
+
+Trainer::Trainer(Trainer&& other) noexcept : native_(other.native_) {
+    other.native_ = nullptr;
+}
+
+Trainer& Trainer::operator=(Trainer&& other) noexcept {
+    if (this != &other) {
+        netc_trainer_destroy(native_);
+        native_ = other.native_;
+        other.native_ = nullptr;
     }
+    return *this;
+}
+
+Trainer::~Trainer() {
+    netc_trainer_destroy(native_);
 }
 
-void Trainer::AddPackets(const std::vector<std::vector<uint8_t>>& packets) {
+Result Trainer::AddPacket(const uint8_t* data, size_t size) {
+    if (native_ == nullptr) return Result::NoMem;
+    return static_cast<Result>(netc_trainer_feed(native_, data, size));
+}
+
+Result Trainer::AddPackets(const std::vector<std::vector<uint8_t>>& packets) {
     for (const auto& pkt : packets) {
-        if (!pkt.empty()) {
-            corpus_.push_back(pkt);
-        }
+        Result r = AddPacket(pkt.data(), pkt.size());
+        if (r != Result::OK) return r;
     }
+    return Result::OK;
 }
 
 size_t Trainer::GetCorpusCount() const noexcept {
-    return corpus_.size();
+    return static_cast<size_t>(netc_trainer_count(native_));
 }
 
 Result Trainer::Train(uint8_t model_id, Dict& out_dict) const {
-    if (corpus_.empty()) {
+    if (native_ == nullptr) return Result::NoMem;
+    if (netc_trainer_count(native_) == 0) {
         return Result::InvalidArg;
     }
 
-    std::vector<const uint8_t*> ptrs(corpus_.size());
-    std::vector<size_t> sizes(corpus_.size());
-    for (size_t i = 0; i < corpus_.size(); i++) {
-        ptrs[i]  = corpus_[i].data();
-        sizes[i] = corpus_[i].size();
-    }
-
     netc_dict_t* raw = nullptr;
-    netc_result_t r = netc_dict_train(
-        ptrs.data(), sizes.data(), corpus_.size(), model_id, &raw);
+    netc_result_t r = netc_trainer_finish(native_, model_id, &raw);
     if (r != NETC_OK) {
         return static_cast<Result>(r);
     }
@@ -54,7 +70,7 @@ Result Trainer::Train(uint8_t model_id, Dict& out_dict) const {
 }
 
 void Trainer::Reset() {
-    corpus_.clear();
+    netc_trainer_reset(native_);
 }
 
 } // namespace netc
@@ -7,7 +7,7 @@
  *   3. Context lifecycle: construct, move, reset, simd, stats (8 tests)
  *   4. Compress/Decompress round-trip: TCP, UDP, multi-packet (8 tests)
  *   5. Error paths: too big, corrupt, invalid dict, null (6 tests)
- *   6. Trainer: add, train, reset (5 tests)
+ *   6. Trainer: add, train, reset, streaming vs netc_dict_train (6 tests)
  *   7. RAII safety: destructor after move, scope exit (3 tests)
  */
 
@@ -239,6 +239,29 @@ void test_dict_save_load_file_roundtrip(void) {
     remove(path);
 }
 
+void test_dict_save_image_map_file_roundtrip(void) {
+    const char* path = "test_cpp_sdk_dict_image.bin";
+    netc::Dict original;
+    TEST_ASSERT_TRUE(build_test_dict(original, 34));
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(original.SaveImageToFile(path)));
+
+    netc::Dict mapped;
+    netc::Result r = netc::Dict::MapFromFile(path, mapped);
+    remove(path);
+    if (r == netc::Result::Unsupported) {
+        TEST_IGNORE_MESSAGE("no memory-mapped files on this platform");
+    }
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(r));
+    TEST_ASSERT_EQUAL_UINT8(34, mapped.GetModelId());
+
+    /* The mapped dict serializes to the same blob as the original */
+    std::vector<uint8_t> blob_a, blob_b;
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(original.SaveToBytes(blob_a)));
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(mapped.SaveToBytes(blob_b)));
+    TEST_ASSERT_EQUAL_size_t(blob_a.size(), blob_b.size());
+    TEST_ASSERT_EQUAL_MEMORY(blob_a.data(), blob_b.data(), blob_a.size());
+}
+
 void test_dict_load_file_nonexistent(void) {
     netc::Dict dict;
     netc::Result r = netc::Dict::LoadFromFile("nonexistent_path_xyz.bin", dict);
@@ -636,6 +659,44 @@ void test_trainer_reset(void) {
     TEST_ASSERT_EQUAL_size_t(0, trainer.GetCorpusCount());
 }
 
+void test_trainer_matches_dict_train(void) {
+    std::vector<std::vector<uint8_t>> pkts;
+    for (int i = 0; i < 64; i++) {
+        std::vector<uint8_t> p(SAMPLE_GAME_STATE, SAMPLE_GAME_STATE + sizeof(SAMPLE_GAME_STATE));
+        p[0] = static_cast<uint8_t>(i);
+        p[9] = static_cast<uint8_t>(i * 3);
+        pkts.push_back(p);
+    }
+    std::vector<const uint8_t*> ptrs;
+    std::vector<size_t> sizes;
+    for (const auto& p : pkts) {
+        ptrs.push_back(p.data());
+        sizes.push_back(p.size());
+    }
+    netc_dict_t* ref = nullptr;
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_dict_train(ptrs.data(), sizes.data(), pkts.size(), 7, &ref));
+    void* ref_blob = nullptr;
+    size_t ref_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(ref, &ref_blob, &ref_sz));
+    netc_dict_free(ref);
+
+    /* Moved-into trainer with 2 workers: same dictionary */
+    netc::Trainer trainer(0, 2);
+    TEST_ASSERT_TRUE(trainer.AddPackets(pkts) == netc::Result::OK);
+    netc::Trainer moved(std::move(trainer));
+    TEST_ASSERT_EQUAL_size_t(64, moved.GetCorpusCount());
+    TEST_ASSERT_EQUAL_size_t(0, trainer.GetCorpusCount());
+
+    netc::Dict dict;
+    TEST_ASSERT_TRUE(moved.Train(7, dict) == netc::Result::OK);
+    std::vector<uint8_t> blob;
+    TEST_ASSERT_TRUE(dict.SaveToBytes(blob) == netc::Result::OK);
+    TEST_ASSERT_EQUAL_size_t(ref_sz, blob.size());
+    TEST_ASSERT_EQUAL_MEMORY(ref_blob, blob.data(), ref_sz);
+    netc_dict_free_blob(ref_blob);
+}
+
 /* =========================================================================
  * 7. RAII safety tests
  * ========================================================================= */
@@ -710,6 +771,7 @@ int main(void) {
     RUN_TEST(test_dict_save_invalid_dict);
     RUN_TEST(test_dict_get_model_id);
     RUN_TEST(test_dict_save_load_file_roundtrip);
+    RUN_TEST(test_dict_save_image_map_file_roundtrip);
     RUN_TEST(test_dict_load_file_nonexistent);
     RUN_TEST(test_dict_save_file_invalid_dict);
 
@@ -747,6 +809,7 @@ int main(void) {
     RUN_TEST(test_trainer_train_produces_valid_dict);
     RUN_TEST(test_trainer_train_model_id);
     RUN_TEST(test_trainer_reset);
+    RUN_TEST(test_trainer_matches_dict_train);
 
     /* 7. RAII safety */
     RUN_TEST(test_dict_destructor_after_move);
@@ -31,6 +31,8 @@ public sealed class NetcContext : IDisposable
                 | NetcNative.CfgFlagStats
                 | extraFlags,
             compression_level = level,
+            adaptive_decay = 0,
+            arena = 0,
         };
 
         nint handle = NetcNative.netc_ctx_create(dict.Handle, ref cfg);
@@ -25,15 +25,18 @@ internal static class NetcNative
 
     // ── Structs ────────────────────────────────────────────────────────
 
-    // C layout (64-bit): flags(4) pad(4) ring_buffer_size(8) compression_level(1) simd_level(1) pad(6) arena_size(8)
-    [StructLayout(LayoutKind.Explicit, Size = 32)]
+    // C layout (64-bit): flags(4) pad(4) ring_buffer_size(8) compression_level(1) simd_level(1)
+    //                    adaptive_decay(1) pad(5) arena_size(8) arena(8)
+    [StructLayout(LayoutKind.Explicit, Size = 40)]
     internal struct NetcCfg
     {
         [FieldOffset(0)]  public uint flags;
         [FieldOffset(8)]  public nuint ring_buffer_size;
         [FieldOffset(16)] public byte compression_level;
         [FieldOffset(17)] public byte simd_level;
+        [FieldOffset(18)] public byte adaptive_decay;
         [FieldOffset(24)] public nuint arena_size;
+        [FieldOffset(32)] public nint arena;
     }
 
     // NetcStats is defined as a public type (Netc.NetcStats) for external use
@@ -3,7 +3,8 @@
  *
  * Blends accumulated per-bucket byte frequencies with the dictionary
  * baseline to produce new normalized frequency tables, then rebuilds
- * the tANS encode/decode structures.
+ * the tANS encode/decode structures.  Bigram slots are rebuilt the same
+ * way against the dict table of the (bucket, class) pair they track.
  *
  * Blend formula per symbol s in bucket b:
  *   blended[s] = alpha * accum_freq[b][s] + (1-alpha) * dict_freq[b][s]
@@ -11,10 +12,13 @@
  * where alpha = NETC_ADAPTIVE_ALPHA_NUM / NETC_ADAPTIVE_ALPHA_DEN (default 3/4).
  * This weights accumulated (observed) data more heavily than the dict baseline,
  * while keeping the baseline as a stability anchor for rare symbols.
+ *
+ * Also owns the copy-on-write adaptive state (see netc_adaptive.h).
  */
 
 #include "netc_adaptive.h"
 #include "netc_tans.h"
+#include <stdlib.h>
 #include <string.h>
 
 /* =========================================================================
@@ -81,57 +85,287 @@ static void freq_normalize_adaptive(
 }
 
 /* =========================================================================
- * netc_adaptive_tables_rebuild
+ * blend_build -- blend counts with a dict table and build dst from them.
+ *
+ * On a failed build dst becomes a copy of base, so it stays decodable.
  * ========================================================================= */
 
-void netc_adaptive_tables_rebuild(netc_ctx_t *ctx)
+static void blend_build(netc_tans_table_t       *dst,
+                        const uint32_t          *counts,
+                        uint32_t                 counts_total,
+                        const netc_tans_table_t *base)
 {
-    uint32_t b;
-    if (!ctx || !ctx->adapt_freq || !ctx->adapt_tables || !ctx->dict) return;
+    uint64_t blended[NETC_TANS_SYMBOLS];
+    uint64_t blended_total = 0;
+    int s;
 
-    {
-        const uint32_t *accum = ctx->adapt_freq;        /* [NETC_CTX_COUNT][256] flat */
-        const uint32_t *accum_total = ctx->adapt_total;  /* [NETC_CTX_COUNT] */
-        const netc_tans_table_t *dict_tables = ctx->dict->tables;
-
-        for (b = 0; b < NETC_CTX_COUNT; b++) {
-            const uint32_t *bucket_freq = &accum[b * 256];
-            uint32_t bucket_total = accum_total[b];
-
-            /* Blend accumulated frequencies with dict baseline */
-            uint64_t blended[NETC_TANS_SYMBOLS];
-            uint64_t blended_total = 0;
-            int s;
-
-            for (s = 0; s < (int)NETC_TANS_SYMBOLS; s++) {
-                /* accum contribution: weighted by ALPHA_NUM */
-                uint64_t a = (uint64_t)bucket_freq[s] * NETC_ADAPTIVE_ALPHA_NUM;
-                /* dict baseline contribution: weighted by (DEN - NUM).
-                 * Scale dict freq (normalized to 4096) by bucket_total to make
-                 * it comparable to raw counts. If bucket_total is 0, use dict only. */
-                uint64_t d;
-                if (bucket_total > 0) {
-                    d = ((uint64_t)dict_tables[b].freq.freq[s] * bucket_total / NETC_TANS_TABLE_SIZE)
-                        * (NETC_ADAPTIVE_ALPHA_DEN - NETC_ADAPTIVE_ALPHA_NUM);
-                } else {
-                    d = (uint64_t)dict_tables[b].freq.freq[s];
-                    a = 0;
-                }
-                blended[s] = a + d;
-                blended_total += blended[s];
-            }
+    for (s = 0; s < (int)NETC_TANS_SYMBOLS; s++) {
+        /* accum contribution: weighted by ALPHA_NUM */
+        uint64_t a = (uint64_t)counts[s] * NETC_ADAPTIVE_ALPHA_NUM;
+        /* dict baseline contribution: weighted by (DEN - NUM).
+         * Scale dict freq (normalized to 4096) by counts_total to make
+         * it comparable to raw counts. If counts_total is 0, use dict only. */
+        uint64_t d;
+        if (counts_total > 0) {
+            d = ((uint64_t)base->freq.freq[s] * counts_total / NETC_TANS_TABLE_SIZE)
+                * (NETC_ADAPTIVE_ALPHA_DEN - NETC_ADAPTIVE_ALPHA_NUM);
+        } else {
+            d = (uint64_t)base->freq.freq[s];
+            a = 0;
+        }
+        blended[s] = a + d;
+        blended_total += blended[s];
+    }
 
-            /* Normalize and rebuild */
-            {
-                netc_freq_table_t ft;
-                freq_normalize_adaptive(blended, blended_total, ft.freq);
-                int rc = netc_tans_build(&ctx->adapt_tables[b], &ft);
-                if (rc != 0) {
-                    /* Build failed — table is in inconsistent state.
-                     * Re-clone from dict to maintain decodability. */
-                    ctx->adapt_tables[b] = ctx->dict->tables[b];
-                }
-            }
+    netc_freq_table_t ft;
+    freq_normalize_adaptive(blended, blended_total, ft.freq);
+    if (netc_tans_build(dst, &ft) != 0) {
+        /* Build failed — table is in inconsistent state.
+         * Re-clone from dict to maintain decodability. */
+        *dst = *base;
+    }
+}
+
+/* =========================================================================
+ * decay_counts -- age counts[0..n) after a rebuild.
+ *
+ * Each count loses 1/2^shift, so the next rebuild weighs recent packets
+ * more; c - (c >> n) never drops a seen symbol to zero.  shift 0 (no
+ * decay) still halves them once bound, an upper bound on every count,
+ * nears overflow (a bucket gains < 2^24 per interval).  Returns the new
+ * sum, or bound unchanged when nothing was aged.
+ * ========================================================================= */
+
+static uint32_t decay_counts(uint32_t *counts, uint32_t n, uint32_t bound,
+                             uint32_t shift)
+{
+    if (shift == 0) {
+        if (bound < NETC_ADAPTIVE_SAT) return bound;
+        shift = 1;
+    }
+    uint32_t aged = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        counts[i] -= counts[i] >> shift;
+        aged += counts[i];
+    }
+    return aged;
+}
+
+/* =========================================================================
+ * netc_adaptive_bucket_rebuild
+ * ========================================================================= */
+
+void netc_adaptive_bucket_rebuild(netc_ctx_t *ctx, uint32_t b)
+{
+    if (!ctx || !ctx->adapt_freq || !ctx->adapt_tables || !ctx->dict ||
+        b >= NETC_CTX_COUNT) return;
+
+    uint32_t *counts = &ctx->adapt_freq[b * 256];
+    blend_build(&ctx->adapt_tables[b], counts, ctx->adapt_total[b],
+                &ctx->dict->tables[b]);
+    ctx->adapt_total[b] = decay_counts(counts, NETC_TANS_SYMBOLS,
+                                       ctx->adapt_total[b], ctx->adapt_decay);
+}
+
+/* =========================================================================
+ * Adaptive bigram slots
+ * ========================================================================= */
+
+#define BG_PAIRS (NETC_CTX_COUNT * NETC_BIGRAM_CTX_COUNT)
+
+/* A rebuilt slot table replaces the dict table only when it codes the
+ * slot's counts in at least 1/2^GAIN fewer bits */
+#define NETC_ADAPTIVE_BG_GAIN 5U
+
+void netc_adaptive_bigram_rebuild(netc_ctx_t *ctx, uint32_t s)
+{
+    netc_adapt_bigram_t *bg = ctx->adapt_bg;
+    if (!bg || !bg->tables || s >= NETC_ADAPTIVE_BG_SLOTS) return;
+
+    uint32_t p = bg->slot_pair[s];
+    if (p == NETC_ADAPTIVE_BG_NONE || bg->total[s] < NETC_TANS_TABLE_SIZE) return;
+
+    uint32_t b = p / NETC_BIGRAM_CTX_COUNT;
+    uint32_t c = p % NETC_BIGRAM_CTX_COUNT;
+    const netc_tans_table_t *base = &ctx->dict->bigram_tables[b][c];
+    netc_tans_table_t       *tbl  = &bg->tables[s];
+    blend_build(tbl, bg->freq[s], bg->total[s], base);
+
+    /* Switch only when the counts cost clearly less under the rebuilt
+     * table; measured on the counts it was built from, it always looks a
+     * little better, and a pair whose traffic matches the dict keeps the
+     * dict table */
+    uint64_t cost_base = 0, cost_new = 0;
+    for (uint32_t k = 0; k < NETC_TANS_SYMBOLS; k++) {
+        cost_base += (uint64_t)bg->freq[s][k] * base->cost[k];
+        cost_new  += (uint64_t)bg->freq[s][k] * tbl->cost[k];
+    }
+    bg->set.t[b][c] = (cost_new < cost_base - (cost_base >> NETC_ADAPTIVE_BG_GAIN))
+                    ? tbl : base;
+    bg->total[s] = decay_counts(bg->freq[s], NETC_TANS_SYMBOLS, bg->total[s],
+                                ctx->adapt_decay);
+}
+
+void netc_adaptive_bigram_assign(netc_ctx_t *ctx)
+{
+    netc_adapt_bigram_t *bg = ctx->adapt_bg;
+    if (!bg) return;
+    const netc_tans_table_t (*dict_bg)[NETC_BIGRAM_CTX_COUNT] =
+        ctx->dict->bigram_tables;
+
+    /* Busiest pairs first, ties to the lower index; pairs without a dict
+     * table have no baseline to blend with and are never tracked */
+    uint8_t  top[BG_PAIRS] = {0};
+    uint32_t peak = 0;
+    for (uint32_t k = 0; k < NETC_ADAPTIVE_BG_SLOTS; k++) {
+        uint32_t best = BG_PAIRS;
+        for (uint32_t p = 0; p < BG_PAIRS; p++) {
+            if (top[p] || bg->pair_total[p] == 0 ||
+                !dict_bg[p / NETC_BIGRAM_CTX_COUNT][p % NETC_BIGRAM_CTX_COUNT].valid)
+                continue;
+            if (best == BG_PAIRS || bg->pair_total[p] > bg->pair_total[best])
+                best = p;
         }
+        if (best == BG_PAIRS) break;
+        top[best] = 1;
+        if (bg->pair_total[best] > peak) peak = bg->pair_total[best];
+    }
+
+    /* Evict, then fill the freed slots */
+    for (uint32_t s = 0; s < NETC_ADAPTIVE_BG_SLOTS; s++) {
+        uint32_t p = bg->slot_pair[s];
+        if (p == NETC_ADAPTIVE_BG_NONE || top[p]) continue;
+        uint32_t b = p / NETC_BIGRAM_CTX_COUNT;
+        uint32_t c = p % NETC_BIGRAM_CTX_COUNT;
+        bg->set.t[b][c]  = &dict_bg[b][c];
+        bg->pair_slot[p] = NETC_ADAPTIVE_BG_NONE;
+        bg->slot_pair[s] = NETC_ADAPTIVE_BG_NONE;
+    }
+    uint32_t s = 0;
+    for (uint32_t p = 0; p < BG_PAIRS; p++) {
+        if (!top[p] || bg->pair_slot[p] != NETC_ADAPTIVE_BG_NONE) continue;
+        while (bg->slot_pair[s] != NETC_ADAPTIVE_BG_NONE) s++;
+        memset(bg->freq[s], 0, sizeof(bg->freq[s]));
+        bg->total[s]     = 0;
+        bg->slot_pair[s] = (uint8_t)p;
+        bg->pair_slot[p] = (uint8_t)s;
+    }
+
+    /* The ranking ages at the same rate as the counts */
+    (void)decay_counts(bg->pair_total, BG_PAIRS, peak, ctx->adapt_decay);
+}
+
+void netc_adaptive_bigram_init(netc_adapt_bigram_t *bg, const netc_dict_t *dict)
+{
+    netc_tans_table_t *tables = bg->tables;
+    memset(bg, 0, sizeof(*bg));
+    bg->set    = dict->bigram_set;
+    bg->tables = tables;
+    memset(bg->pair_slot, NETC_ADAPTIVE_BG_NONE, sizeof(bg->pair_slot));
+    memset(bg->slot_pair, NETC_ADAPTIVE_BG_NONE, sizeof(bg->slot_pair));
+}
+
+/* =========================================================================
+ * Copy-on-write adaptive state
+ * ========================================================================= */
+
+static void lzp_overlay_free(netc_lzp_overlay_t *ovl)
+{
+    free(ovl->slots);
+    free(ovl->dirty);
+    ovl->slots = NULL;
+    ovl->dirty = NULL;
+    ovl->cap   = 0;
+    ovl->count = 0;
+}
+
+/* Rehash into a table of new_cap slots (power of two, > 2 * count). */
+static netc_result_t lzp_overlay_resize(netc_lzp_overlay_t *ovl, uint32_t new_cap)
+{
+    netc_lzp_ovl_slot_t *slots =
+        (netc_lzp_ovl_slot_t *)calloc(new_cap, sizeof(netc_lzp_ovl_slot_t));
+    if (slots == NULL) return NETC_ERR_NOMEM;
+    if (ovl->dirty == NULL) {
+        ovl->dirty = (uint64_t *)calloc(NETC_LZP_HT_SIZE / 64U, sizeof(uint64_t));
+        if (ovl->dirty == NULL) { free(slots); return NETC_ERR_NOMEM; }
+    }
+    netc_lzp_overlay_t grown = *ovl;
+    grown.slots = slots;
+    grown.cap   = new_cap;
+    for (uint32_t i = 0; i < ovl->cap; i++) {
+        if (ovl->slots[i].key != 0)
+            *netc_lzp_ovl_find(&grown, ovl->slots[i].key - 1U) = ovl->slots[i];
+    }
+    free(ovl->slots);
+    *ovl = grown;
+    return NETC_OK;
+}
+
+netc_result_t netc_adaptive_lzp_densify(netc_ctx_t *ctx)
+{
+    netc_lzp_overlay_t *ovl = &ctx->adapt_lzp_ovl;
+    if (ovl->base.ent == NULL) return NETC_OK;
+
+    netc_lzp_entry_t *dense =
+        (netc_lzp_entry_t *)malloc(NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+    if (dense == NULL) return NETC_ERR_NOMEM;
+    for (uint32_t j = 0; j < NETC_LZP_HT_SIZE; j++) {
+        dense[j] = netc_lzp_get(&ovl->base, j);
+        dense[j].valid = netc_lzp_clone_conf(dense[j].valid);
+    }
+    for (uint32_t i = 0; i < ovl->cap; i++) {
+        if (ovl->slots[i].key != 0)
+            dense[ovl->slots[i].key - 1U] = ovl->slots[i].e;
+    }
+    lzp_overlay_free(ovl);
+    ovl->base.ent  = NULL;
+    ctx->adapt_lzp = dense;
+    return NETC_OK;
+}
+
+netc_result_t netc_adaptive_grow(netc_ctx_t *ctx, size_t n)
+{
+    if (ctx->adapt_tables == NULL &&
+        ctx->adapt_pkt_count + 1U > NETC_ADAPTIVE_REBUILD_START) {
+        /* Filled one bucket per packet by the rebuilds that start with
+         * this packet, and made live by the last of them; until then the
+         * dict tables stay in use */
+        ctx->adapt_tables = (netc_tans_table_t *)malloc(
+            NETC_CTX_COUNT * sizeof(netc_tans_table_t));
+        if (ctx->adapt_tables == NULL) return NETC_ERR_NOMEM;
+    }
+    netc_adapt_bigram_t *bg = ctx->adapt_bg;
+    if (bg != NULL && bg->tables == NULL &&
+        bg->slot_pair[0] != NETC_ADAPTIVE_BG_NONE &&
+        ctx->adapt_pkt_count + 1U > NETC_ADAPTIVE_BG_START) {
+        /* First slot rebuild after the first assignment; a slot's pair
+         * codes with its dict table until then */
+        bg->tables = (netc_tans_table_t *)malloc(
+            NETC_ADAPTIVE_BG_SLOTS * sizeof(netc_tans_table_t));
+        if (bg->tables == NULL) return NETC_ERR_NOMEM;
+    }
+
+    netc_lzp_overlay_t *ovl = &ctx->adapt_lzp_ovl;
+    if (ovl->base.ent == NULL || ovl->count + n <= ovl->cap / 2U) return NETC_OK;
+    if (ovl->count + n > NETC_LZP_OVL_MAX) return netc_adaptive_lzp_densify(ctx);
+
+    uint32_t cap = (ovl->cap != 0) ? ovl->cap : 256U;
+    while (ovl->count + n > cap / 2U) cap <<= 1;
+    return lzp_overlay_resize(ovl, cap);
+}
+
+void netc_adaptive_release(netc_ctx_t *ctx)
+{
+    free(ctx->adapt_tables);
+    ctx->adapt_tables      = NULL;
+    ctx->adapt_tables_live = 0;
+    if (ctx->adapt_bg != NULL) {
+        free(ctx->adapt_bg->tables);
+        ctx->adapt_bg->tables = NULL;
+        netc_adaptive_bigram_init(ctx->adapt_bg, ctx->dict);
     }
+    free(ctx->adapt_lzp);
+    ctx->adapt_lzp = NULL;
+    lzp_overlay_free(&ctx->adapt_lzp_ovl);
+    ctx->adapt_lzp_ovl.base = netc_dict_lzp(ctx->dict);
 }
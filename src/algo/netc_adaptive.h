@@ -5,13 +5,30 @@
  *
  * When NETC_CFG_FLAG_ADAPTIVE is set, both encoder and decoder call
  * netc_adaptive_update() after each packet to accumulate byte
- * frequency statistics. Every NETC_ADAPTIVE_INTERVAL packets,
- * netc_adaptive_tables_rebuild() blends the accumulated frequencies
- * with the dictionary baseline and rebuilds the tANS tables.
+ * frequency statistics. Over the last NETC_CTX_COUNT packets of every
+ * NETC_ADAPTIVE_INTERVAL, netc_adaptive_bucket_rebuild() blends the
+ * accumulated frequencies of one bucket per packet with the dictionary
+ * baseline and rebuilds that bucket's tANS table, so no packet pays for
+ * more than one table build.
+ *
+ * With NETC_CFG_FLAG_BIGRAM the bigram tables adapt the same way, within a
+ * fixed budget: every (bucket, class) pair is ranked by byte count, the
+ * NETC_ADAPTIVE_BG_SLOTS busiest pairs hold symbol counts, and one slot
+ * table is rebuilt per packet just ahead of the bucket rebuilds.  The
+ * 10-bit small-packet tables are derived from the live unigram tables at
+ * coding time, so they follow the bucket rebuilds without state of their
+ * own.
  *
  * Synchronization: both sides see the same decompressed bytes, so
  * both call the same update functions in the same order. No explicit
  * sync protocol is needed.
+ *
+ * Copy-on-write: a new adaptive context shares the dict's tANS and LZP
+ * tables.  adapt_tables is allocated by the first rebuild, and LZP updates
+ * go to a sparse overlay that is folded into a dense clone once it holds
+ * NETC_LZP_OVL_MAX entries.  netc_adaptive_reserve() makes room for both
+ * before a packet touches any state, so updates never allocate and a
+ * NETC_ERR_NOMEM leaves encoder and decoder in step.
  */
 
 #ifndef NETC_ADAPTIVE_H
@@ -26,7 +43,9 @@
  * after each successful compress/decompress. The bytes are the ORIGINAL
  * (uncompressed) packet data -- NOT the delta residuals.
  *
- * Also triggers a table rebuild every NETC_ADAPTIVE_INTERVAL packets.
+ * Also rebuilds one bucket's table on each of the last NETC_CTX_COUNT
+ * packets of every NETC_ADAPTIVE_INTERVAL, and one bigram slot's table on
+ * each of the NETC_ADAPTIVE_BG_SLOTS packets before them.
  *
  * @param ctx   Context with NETC_CFG_FLAG_ADAPTIVE set
  * @param data  Decompressed packet bytes
@@ -36,13 +55,122 @@ static NETC_INLINE void netc_adaptive_update(netc_ctx_t *ctx,
                                               const uint8_t *data,
                                               size_t size);
 
+/* Packet count after which each packet rebuilds one bucket: bucket b is
+ * rebuilt by packet REBUILD_START + 1 + b of the interval, the last one by
+ * packet NETC_ADAPTIVE_INTERVAL. */
+#define NETC_ADAPTIVE_REBUILD_START (NETC_ADAPTIVE_INTERVAL - NETC_CTX_COUNT)
+
 /**
- * Rebuild tANS tables by blending accumulated frequencies with dict baseline.
+ * Rebuild bucket b's tANS table by blending its accumulated frequencies
+ * with the dict baseline.
  *
- * Internal function called by netc_adaptive_update() when the rebuild
- * interval is reached.
+ * Internal function called by netc_adaptive_update().  The first rebuild
+ * after the context starts sharing the dict tables fills adapt_tables
+ * behind them, and netc_adaptive_update() switches all buckets over on the
+ * packet that completes the interval; later rebuilds replace one live
+ * table per packet.  Both sides run the same schedule, so every table
+ * changes at the same packet index on encoder and decoder.
+ */
+void netc_adaptive_bucket_rebuild(netc_ctx_t *ctx, uint32_t b);
+
+/* Packet count after which each packet rebuilds one bigram slot: slot j is
+ * rebuilt by packet BG_START + 1 + j, and the last of them, packet
+ * NETC_ADAPTIVE_REBUILD_START, then reassigns the slots. */
+#define NETC_ADAPTIVE_BG_START (NETC_ADAPTIVE_REBUILD_START - NETC_ADAPTIVE_BG_SLOTS)
+
+/**
+ * Rebuild bigram slot s's table by blending its counts with the dict
+ * table of the pair it tracks.  The pair codes with the rebuilt table only
+ * while that prices the counts at least 1/32 below the dict table.  A slot
+ * with no pair, or under NETC_TANS_TABLE_SIZE counted bytes, is left alone.
+ */
+void netc_adaptive_bigram_rebuild(netc_ctx_t *ctx, uint32_t s);
+
+/**
+ * Hand the slots to the NETC_ADAPTIVE_BG_SLOTS pairs with the highest byte
+ * counts.  A pair that keeps its slot keeps its counts and table; a pair
+ * that loses it goes back to its dict table, and a newly tracked pair
+ * starts from zero counts and is first rebuilt one interval later.
+ */
+void netc_adaptive_bigram_assign(netc_ctx_t *ctx);
+
+/** Point every bigram pair at its dict table and clear all counts. */
+void netc_adaptive_bigram_init(netc_adapt_bigram_t *bg, const netc_dict_t *dict);
+
+/* Overlay entries before the LZP table is cloned densely (64 KB of slots
+ * at half load plus a 16 KB bitmap, against 256 KB for the clone). */
+#define NETC_LZP_OVL_MAX   (NETC_LZP_HT_SIZE / 32U)
+
+/** Slow path of netc_adaptive_reserve: allocate tables, grow or fold the overlay. */
+netc_result_t netc_adaptive_grow(netc_ctx_t *ctx, size_t n);
+
+/** Fold the LZP overlay into a dense clone of the dict table. */
+netc_result_t netc_adaptive_lzp_densify(netc_ctx_t *ctx);
+
+/** Free copy-on-write state so the context shares the dict tables again. */
+void netc_adaptive_release(netc_ctx_t *ctx);
+
+/**
+ * Make room for the adaptive updates an n-byte packet will cause: the
+ * rebuilt unigram or bigram slot tables if this packet starts rebuilding
+ * them, and n new LZP overlay slots (2n for a dual-order table).  Call
+ * before the packet mutates any context state.
+ */
+static NETC_INLINE netc_result_t netc_adaptive_reserve(netc_ctx_t *ctx, size_t n)
+{
+    if (NETC_LIKELY(ctx->adapt_freq == NULL)) return NETC_OK;
+    if (netc_lzp_order2(ctx->dict)) n *= 2U;
+    if ((ctx->adapt_tables == NULL &&
+         ctx->adapt_pkt_count + 1U > NETC_ADAPTIVE_REBUILD_START) ||
+        (ctx->adapt_bg != NULL && ctx->adapt_bg->tables == NULL &&
+         ctx->adapt_bg->slot_pair[0] != NETC_ADAPTIVE_BG_NONE &&
+         ctx->adapt_pkt_count + 1U > NETC_ADAPTIVE_BG_START) ||
+        (ctx->adapt_lzp_ovl.base.ent != NULL &&
+         ctx->adapt_lzp_ovl.count + n > ctx->adapt_lzp_ovl.cap / 2U))
+        return netc_adaptive_grow(ctx, n);
+    return NETC_OK;
+}
+
+/** Feed a packet's raw bytes to the adaptive LZP table (dense or overlay). */
+static NETC_INLINE void netc_adaptive_lzp_update(netc_ctx_t *ctx,
+                                                  const uint8_t *data,
+                                                  size_t size)
+{
+    int order2 = netc_lzp_order2(ctx->dict);
+    if (ctx->adapt_lzp_ovl.base.ent != NULL)
+        netc_lzp_overlay_update(&ctx->adapt_lzp_ovl, data, size, order2);
+    else
+        netc_lzp_adaptive_update(ctx->adapt_lzp, data, size, order2);
+}
+
+/**
+ * Count the bytes a PCTX+BIGRAM packet was coded from against their
+ * (bucket, class) pairs.  These are the delta residuals or LZP-filtered
+ * bytes, not the packet itself: the decoder sees them between the tANS
+ * decode and its post-passes.  Both sides call it for the same packets,
+ * before netc_adaptive_update().
  */
-void netc_adaptive_tables_rebuild(netc_ctx_t *ctx);
+static NETC_INLINE void netc_adaptive_bigram_feed(netc_ctx_t *ctx,
+                                                   const uint8_t *coded,
+                                                   size_t size)
+{
+    netc_adapt_bigram_t *bg = ctx->adapt_bg;
+    if (bg == NULL) return;
+    const netc_dict_t *dict = ctx->dict;
+
+    for (size_t i = 0; i < size; i++) {
+        uint8_t  prev = (i > 0) ? coded[i - 1] : 0x00u;
+        uint32_t b    = netc_bucket_of(&dict->buckets, (uint32_t)i);
+        uint32_t p    = b * NETC_BIGRAM_CTX_COUNT
+                      + netc_bigram_class(prev, dict->bigram_class_map);
+        uint32_t s    = bg->pair_slot[p];
+        bg->pair_total[p]++;
+        if (s != NETC_ADAPTIVE_BG_NONE) {
+            bg->freq[s][coded[i]]++;
+            bg->total[s]++;
+        }
+    }
+}
 
 /* ---- Implementation of the inline update ---- */
 
@@ -55,18 +183,28 @@ static NETC_INLINE void netc_adaptive_update(netc_ctx_t *ctx,
     /* Accumulate byte frequencies per-bucket */
     uint32_t *freq = ctx->adapt_freq;   /* [NETC_CTX_COUNT][256] flat */
     uint32_t *total = ctx->adapt_total; /* [NETC_CTX_COUNT] */
+    const netc_bucket_map_t *bm = ctx->dict ? &ctx->dict->buckets
+                                            : &netc_bucket_map_default;
 
     for (size_t i = 0; i < size; i++) {
-        uint32_t b = netc_ctx_bucket((uint32_t)i);
+        uint32_t b = netc_bucket_of(bm, (uint32_t)i);
         freq[b * 256 + data[i]]++;
         total[b]++;
     }
 
-    /* Check if we should rebuild tables */
-    ctx->adapt_pkt_count++;
-    if (ctx->adapt_pkt_count >= NETC_ADAPTIVE_INTERVAL) {
-        netc_adaptive_tables_rebuild(ctx);
-        ctx->adapt_pkt_count = 0;
+    /* One bigram slot, then one bucket, per packet at the end of the interval */
+    uint32_t pkt = ++ctx->adapt_pkt_count;
+    if (ctx->adapt_bg != NULL && pkt > NETC_ADAPTIVE_BG_START &&
+        pkt <= NETC_ADAPTIVE_REBUILD_START) {
+        netc_adaptive_bigram_rebuild(ctx, pkt - NETC_ADAPTIVE_BG_START - 1U);
+        if (pkt == NETC_ADAPTIVE_REBUILD_START) netc_adaptive_bigram_assign(ctx);
+    }
+    if (pkt > NETC_ADAPTIVE_REBUILD_START) {
+        netc_adaptive_bucket_rebuild(ctx, pkt - NETC_ADAPTIVE_REBUILD_START - 1U);
+        if (pkt >= NETC_ADAPTIVE_INTERVAL) {
+            ctx->adapt_tables_live = 1;
+            ctx->adapt_pkt_count   = 0;
+        }
     }
 }
 
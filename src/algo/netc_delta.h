@@ -1,5 +1,5 @@
 /**
- * netc_delta.h — Field-class-aware delta prediction (AD-002).
+ * netc_delta.h — Field-class-aware delta prediction (AD-002, AD-020).
  *
  * INTERNAL HEADER — not part of the public API.
  *
@@ -9,20 +9,33 @@
  * the structural role inferred from the byte's position (offset) within the
  * packet (AD-002, RFC-001 §6.2).
  *
- * Field-class mapping (by packet byte offset):
+ * Static field-class mapping (by packet byte offset):
  *   [0 .. 15]    HEADER     — XOR  (flag/enum bytes, type fields)
  *   [16 .. 63]   SUBHEADER  — SUB  (sequence numbers, counters)
  *   [64 .. 255]  BODY       — XOR  (float components, vectors)
  *   [256 .. END] TAIL       — SUB  (integer payload, bulk data)
  *
- * This mapping is a heuristic, not schema-derived. It keeps netc
- * schema-agnostic while still being smarter than uniform subtraction.
+ * This mapping is a heuristic, not schema-derived. A trained dictionary may
+ * replace it with a per-offset operator map (netc_delta_map_t, AD-020):
+ * XOR, byte SUB, no prediction, a 16/32-bit little-endian SUB over an
+ * aligned pair/quad of bytes, or a float32 XOR with the exponent split into
+ * its own byte (AD-021). The static mapping is netc_delta_map_default.
+ *
+ * A map may also ask for byte planes (AD-021): after delta, each run of two
+ * or more equal wide lanes is transposed so byte k of every lane is stored
+ * together, and the mostly-zero high bytes form one run for the coder.
  *
  * API:
- *   netc_delta_encode(prev, curr, residual, size)
- *   netc_delta_decode(prev, residual, curr, size)
+ *   netc_delta_encode(prev, curr, residual, size)         — static mapping
+ *   netc_delta_decode(prev, residual, curr, size)         — static mapping
+ *   netc_delta_encode_mapped(map, prev, curr, residual, from, size)
+ *   netc_delta_decode_mapped(map, prev, residual, curr, from, size)
+ *   netc_delta_encode_order2(map, prev2, prev, curr, residual, size)
+ *   netc_delta_decode_order2(map, prev2, prev, residual, curr, size)
+ *   netc_delta_planes_init(planes, map)                   — run list of a map
+ *   netc_delta_planes_split / netc_delta_planes_merge      — one planes run
  *
- * Both functions operate in-place or out-of-place.
+ * All functions operate in-place or out-of-place.
  * For in-place decode: curr == residual is allowed.
  * For in-place encode: not safe (residual overwrites curr during XOR).
  */
@@ -52,6 +65,158 @@
  * ========================================================================= */
 #define NETC_DELTA_MIN_SIZE       8U
 
+/* =========================================================================
+ * Reference history (NETC_CFG_FLAG_DELTA_REFS, AD-022)
+ *
+ * Number of recent packets a DELTA_REFS context keeps as delta references.
+ * ========================================================================= */
+#define NETC_DELTA_REFS           8U
+
+
+/* =========================================================================
+ * Per-offset operator map (AD-020)
+ *
+ * op[i] selects the residual operator for offset i < NETC_DELTA_MAP_LEN;
+ * every offset past the map uses tail. The lane operators SUB16/SUB32 treat
+ * an aligned pair/quad of bytes as one little-endian integer, so a valid map
+ * gives every byte of such a lane the same operator (netc_delta_map_valid).
+ * A lane cut short by the end of the packet is coded as the truncated
+ * integer: its low bytes are exactly the low bytes of the full-width result.
+ * ========================================================================= */
+
+#define NETC_DELTA_OP_XOR    0U  /* residual = curr ^ prev */
+#define NETC_DELTA_OP_SUB    1U  /* residual = curr - prev (byte) */
+#define NETC_DELTA_OP_NONE   2U  /* residual = curr (no prediction) */
+#define NETC_DELTA_OP_SUB16  3U  /* residual = curr - prev (u16 LE, aligned pair) */
+#define NETC_DELTA_OP_SUB32  4U  /* residual = curr - prev (u32 LE, aligned quad) */
+#define NETC_DELTA_OP_FLT32  5U  /* residual = rotl(curr ^ prev, 1) (f32 LE, aligned quad) */
+#define NETC_DELTA_OP_COUNT  6U
+
+/* FLT32 rotates the sign bit below the mantissa, so the top byte of the
+ * residual is exactly the exponent change. A truncated FLT32 lane has no
+ * sign bit to move and is coded as XOR. */
+
+#define NETC_DELTA_MAP_LEN   512U  /* multiple of every SIMD chunk width */
+
+typedef struct netc_delta_map {
+    uint8_t op[NETC_DELTA_MAP_LEN];  /* NETC_DELTA_OP_* per offset */
+    uint8_t tail;                    /* operator for offsets >= NETC_DELTA_MAP_LEN */
+    uint8_t planes;                  /* 1 = byte-transpose wide-lane runs */
+} netc_delta_map_t;
+
+/** The static field-class mapping (defined in netc_simd_generic.c). */
+extern const netc_delta_map_t netc_delta_map_default;
+
+static NETC_INLINE uint32_t netc_delta_op_at(const netc_delta_map_t *m, size_t i) {
+    return (i < NETC_DELTA_MAP_LEN) ? m->op[i] : m->tail;
+}
+
+/* Lane width in bytes of operator op */
+static NETC_INLINE size_t netc_delta_op_width(uint32_t op) {
+    return (op >= NETC_DELTA_OP_SUB32) ? 4U : (op == NETC_DELTA_OP_SUB16) ? 2U : 1U;
+}
+
+/** 1 if every operator is known and every wide lane is whole. */
+static NETC_INLINE int netc_delta_map_valid(const netc_delta_map_t *m) {
+    if (m->tail >= NETC_DELTA_OP_COUNT || m->planes > 1U) return 0;
+    for (size_t i = 0; i < NETC_DELTA_MAP_LEN; i++) {
+        uint32_t op = m->op[i];
+        if (op >= NETC_DELTA_OP_COUNT) return 0;
+        size_t w = netc_delta_op_width(op);
+        size_t lane = i & ~(w - 1U);
+        for (size_t k = lane; k < lane + w; k++) {
+            if (m->op[k] != op) return 0;
+        }
+    }
+    return 1;
+}
+
+/* Little-endian load/store of the first w (1..4) bytes of a lane */
+static NETC_INLINE uint32_t netc_delta_lane_ld(const uint8_t *p, size_t w) {
+    uint32_t v = 0;
+    for (size_t k = 0; k < w; k++) v |= (uint32_t)p[k] << (8U * k);
+    return v;
+}
+static NETC_INLINE void netc_delta_lane_st(uint8_t *p, size_t w, uint32_t v) {
+    for (size_t k = 0; k < w; k++) p[k] = (uint8_t)(v >> (8U * k));
+}
+
+static NETC_INLINE uint32_t netc_delta_rotl1(uint32_t v) { return (v << 1) | (v >> 31); }
+static NETC_INLINE uint32_t netc_delta_rotr1(uint32_t v) { return (v >> 1) | (v << 31); }
+
+/* Residual lane of wide operator op for prediction p (w = lane bytes left) */
+static NETC_INLINE uint32_t netc_delta_lane_enc(uint32_t op, size_t w, uint32_t c, uint32_t p) {
+    if (op != NETC_DELTA_OP_FLT32) return c - p;
+    return (w == 4U) ? netc_delta_rotl1(c ^ p) : c ^ p;
+}
+static NETC_INLINE uint32_t netc_delta_lane_dec(uint32_t op, size_t w, uint32_t r, uint32_t p) {
+    if (op != NETC_DELTA_OP_FLT32) return r + p;
+    return (w == 4U) ? netc_delta_rotr1(r) ^ p : r ^ p;
+}
+
+/* =========================================================================
+ * netc_delta_encode_mapped / netc_delta_decode_mapped
+ *
+ * Scalar reference for the operator map over offsets [from, size). from
+ * must be a multiple of 4 (the SIMD kernels pass the end of their last
+ * whole chunk). The dispatch kernels produce identical bytes.
+ * ========================================================================= */
+static NETC_INLINE void netc_delta_encode_mapped(
+    const netc_delta_map_t *map,
+    const uint8_t          *prev,
+    const uint8_t          *curr,
+    uint8_t                *residual,
+    size_t                  from,
+    size_t                  size)
+{
+    size_t i = from;
+    while (i < size) {
+        uint32_t op = netc_delta_op_at(map, i);
+        switch (op) {
+            case NETC_DELTA_OP_XOR:  residual[i] = curr[i] ^ prev[i]; i++; break;
+            case NETC_DELTA_OP_SUB:  residual[i] = (uint8_t)(curr[i] - prev[i]); i++; break;
+            case NETC_DELTA_OP_NONE: residual[i] = curr[i]; i++; break;
+            default: {
+                size_t w = netc_delta_op_width(op);
+                if (w > size - i) w = size - i;
+                netc_delta_lane_st(residual + i, w,
+                                   netc_delta_lane_enc(op, w, netc_delta_lane_ld(curr + i, w),
+                                                       netc_delta_lane_ld(prev + i, w)));
+                i += w;
+                break;
+            }
+        }
+    }
+}
+
+static NETC_INLINE void netc_delta_decode_mapped(
+    const netc_delta_map_t *map,
+    const uint8_t          *prev,
+    const uint8_t          *residual,
+    uint8_t                *curr,
+    size_t                  from,
+    size_t                  size)
+{
+    size_t i = from;
+    while (i < size) {
+        uint32_t op = netc_delta_op_at(map, i);
+        switch (op) {
+            case NETC_DELTA_OP_XOR:  curr[i] = residual[i] ^ prev[i]; i++; break;
+            case NETC_DELTA_OP_SUB:  curr[i] = (uint8_t)(residual[i] + prev[i]); i++; break;
+            case NETC_DELTA_OP_NONE: curr[i] = residual[i]; i++; break;
+            default: {
+                size_t w = netc_delta_op_width(op);
+                if (w > size - i) w = size - i;
+                netc_delta_lane_st(curr + i, w,
+                                   netc_delta_lane_dec(op, w, netc_delta_lane_ld(residual + i, w),
+                                                       netc_delta_lane_ld(prev + i, w)));
+                i += w;
+                break;
+            }
+        }
+    }
+}
+
 /* =========================================================================
  * netc_delta_encode
  *
@@ -118,26 +283,35 @@ static NETC_INLINE size_t netc_delta_decode(
  * netc_delta_encode_order2
  *
  * Order-2 delta: linear extrapolation prediction.
- *   predicted[i] = 2*prev[i] - prev2[i]  (clamped to uint8_t via wrapping)
- *   residual[i]  = curr[i] - predicted[i] (XOR or SUB per field class)
+ *   predicted = 2*prev - prev2  (wrapping, in the operator's lane width)
+ *   residual  = curr - predicted (or curr ^ predicted, per map operator;
+ *               FLT32 rotates the XOR as in order-1)
  *
  * This captures linear trends (e.g. monotonic counters, smooth position
  * changes) more accurately than order-1, producing smaller residuals.
+ * NETC_DELTA_OP_NONE bytes are stored as-is, as in order-1.
  * ========================================================================= */
 static NETC_INLINE size_t netc_delta_encode_order2(
-    const uint8_t *prev2,
-    const uint8_t *prev,
-    const uint8_t *curr,
-    uint8_t       *residual,
-    size_t         size)
+    const netc_delta_map_t *map,
+    const uint8_t          *prev2,
+    const uint8_t          *prev,
+    const uint8_t          *curr,
+    uint8_t                *residual,
+    size_t                  size)
 {
-    for (size_t i = 0; i < size; i++) {
-        uint8_t predicted = (uint8_t)(2U * prev[i] - prev2[i]);
-        if (i < NETC_DELTA_HEADER_END || (i >= NETC_DELTA_SUBHEADER_END && i < NETC_DELTA_BODY_END)) {
-            residual[i] = curr[i] ^ predicted;
-        } else {
-            residual[i] = (uint8_t)(curr[i] - predicted);
-        }
+    size_t i = 0;
+    while (i < size) {
+        uint32_t op = netc_delta_op_at(map, i);
+        size_t   w  = netc_delta_op_width(op);
+        if (w > size - i) w = size - i;
+        uint32_t predicted = 2U * netc_delta_lane_ld(prev + i, w) -
+                             netc_delta_lane_ld(prev2 + i, w);
+        uint32_t c = netc_delta_lane_ld(curr + i, w);
+        uint32_t r = (op == NETC_DELTA_OP_XOR)  ? c ^ predicted
+                   : (op == NETC_DELTA_OP_NONE) ? c
+                   : netc_delta_lane_enc(op, w, c, predicted);
+        netc_delta_lane_st(residual + i, w, r);
+        i += w;
     }
     return size;
 }
@@ -145,26 +319,100 @@ static NETC_INLINE size_t netc_delta_encode_order2(
 /* =========================================================================
  * netc_delta_decode_order2
  *
- * Inverse of netc_delta_encode_order2.
- *   predicted[i] = 2*prev[i] - prev2[i]
- *   curr[i]      = residual[i] + predicted[i] (XOR or ADD per field class)
+ * Inverse of netc_delta_encode_order2. curr may equal residual.
  * ========================================================================= */
 static NETC_INLINE size_t netc_delta_decode_order2(
-    const uint8_t *prev2,
-    const uint8_t *prev,
-    const uint8_t *residual,
-    uint8_t       *curr,
-    size_t         size)
+    const netc_delta_map_t *map,
+    const uint8_t          *prev2,
+    const uint8_t          *prev,
+    const uint8_t          *residual,
+    uint8_t                *curr,
+    size_t                  size)
 {
-    for (size_t i = 0; i < size; i++) {
-        uint8_t predicted = (uint8_t)(2U * prev[i] - prev2[i]);
-        if (i < NETC_DELTA_HEADER_END || (i >= NETC_DELTA_SUBHEADER_END && i < NETC_DELTA_BODY_END)) {
-            curr[i] = residual[i] ^ predicted;
-        } else {
-            curr[i] = (uint8_t)(residual[i] + predicted);
-        }
+    size_t i = 0;
+    while (i < size) {
+        uint32_t op = netc_delta_op_at(map, i);
+        size_t   w  = netc_delta_op_width(op);
+        if (w > size - i) w = size - i;
+        uint32_t predicted = 2U * netc_delta_lane_ld(prev + i, w) -
+                             netc_delta_lane_ld(prev2 + i, w);
+        uint32_t r = netc_delta_lane_ld(residual + i, w);
+        uint32_t c = (op == NETC_DELTA_OP_XOR)  ? r ^ predicted
+                   : (op == NETC_DELTA_OP_NONE) ? r
+                   : netc_delta_lane_dec(op, w, r, predicted);
+        netc_delta_lane_st(curr + i, w, c);
+        i += w;
     }
     return size;
 }
 
+/* =========================================================================
+ * Byte planes (AD-021)
+ *
+ * With map->planes set, every maximal run of n >= 2 consecutive lanes of
+ * the same wide operator inside the map is stored as w planes of n bytes:
+ * plane k holds byte k of each lane. A packet that ends inside a run
+ * transposes only its whole lanes, and only if there are at least two of
+ * them; offsets past the map are never transposed. The compressor splits
+ * the residual after delta, and the decompressor merges it back before
+ * delta decode.
+ * ========================================================================= */
+
+#define NETC_DELTA_PLANES_MAX (NETC_DELTA_MAP_LEN / 4U)  /* runs are >= 4 bytes */
+
+typedef struct netc_delta_planes {
+    uint16_t start[NETC_DELTA_PLANES_MAX];  /* first offset of the run */
+    uint16_t lanes[NETC_DELTA_PLANES_MAX];  /* lanes in the run (>= 2) */
+    uint8_t  width[NETC_DELTA_PLANES_MAX];  /* lane width: 2 or 4 */
+    uint32_t count;                         /* 0 = no transpose */
+} netc_delta_planes_t;
+
+/** Run list of map (empty unless map->planes). */
+static NETC_INLINE void netc_delta_planes_init(netc_delta_planes_t *pl,
+                                               const netc_delta_map_t *map) {
+    pl->count = 0;
+    if (!map->planes) return;
+    size_t i = 0;
+    while (i < NETC_DELTA_MAP_LEN) {
+        uint32_t op = map->op[i];
+        size_t   w  = netc_delta_op_width(op);
+        size_t   j  = i;
+        while (j < NETC_DELTA_MAP_LEN && map->op[j] == op) j += w;
+        if (w > 1U && (j - i) / w >= 2U) {
+            pl->start[pl->count] = (uint16_t)i;
+            pl->lanes[pl->count] = (uint16_t)((j - i) / w);
+            pl->width[pl->count] = (uint8_t)w;
+            pl->count++;
+        }
+        i = j;
+    }
+}
+
+/* Whole lanes of run r inside a len-byte packet (0 = leave untouched) */
+static NETC_INLINE size_t netc_delta_planes_lanes(const netc_delta_planes_t *pl,
+                                                  uint32_t r, size_t len) {
+    size_t s = pl->start[r];
+    if (s >= len) return 0;
+    size_t n = (len - s) / pl->width[r];
+    if (n > pl->lanes[r]) n = pl->lanes[r];
+    return (n >= 2U) ? n : 0;
+}
+
+/* Transpose n lanes of w bytes at buf into w planes of n bytes, in place.
+ * from is the first lane not yet done (the SIMD kernels finish the rest). */
+static NETC_INLINE void netc_delta_planes_split(uint8_t *buf, const uint8_t *lanes,
+                                                size_t w, size_t n, size_t from) {
+    for (size_t j = from; j < n; j++) {
+        for (size_t k = 0; k < w; k++) buf[k * n + j] = lanes[j * w + k];
+    }
+}
+
+/* Inverse of netc_delta_planes_split: planes (a copy of the run) → lanes. */
+static NETC_INLINE void netc_delta_planes_merge(uint8_t *buf, const uint8_t *planes,
+                                                size_t w, size_t n, size_t from) {
+    for (size_t j = from; j < n; j++) {
+        for (size_t k = 0; k < w; k++) buf[j * w + k] = planes[k * n + j];
+    }
+}
+
 #endif /* NETC_DELTA_H */
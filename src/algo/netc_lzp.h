@@ -13,6 +13,16 @@
  * model learns per-offset byte distributions, which is critical for
  * structured network packets where byte semantics depend on position.
  *
+ * Dual-order dictionaries (NETC_DICT_FLAG_LZP2) also hash an order-2
+ * context, hash(prev2, prev, position), into the same table.  Entries carry
+ * a saturating confidence in `valid`, and each byte is predicted by
+ * whichever of its two entries is more confident (order-2 on a tie).
+ * Two-byte field tags select their payload far better than one byte does.
+ *
+ * A frozen dict table is stored packed (netc_lzp_table_t): a 32 KB map of
+ * occupied slots plus the occupied entries alone, instead of all 2^17.
+ * Lookups give the same entries, so the packing is invisible on the wire.
+ *
  * Wire format (NETC_ALG_LZP payload):
  *   [2B]  n_literals          (uint16 LE)
  *   [FB]  flag_bits           (packed bitstream, MSB-first, FB = ceil(src_size/8))
@@ -45,9 +55,167 @@
 
 typedef struct {
     uint8_t value;  /* Predicted byte for this (prev_byte, position) context */
-    uint8_t valid;  /* 1 = prediction is trained, 0 = empty slot */
+    uint8_t valid;  /* 0 = empty slot, else confidence 1..255 */
 } netc_lzp_entry_t;
 
+/* =========================================================================
+ * Packed table — occupancy map plus the occupied entries
+ *
+ * Trained tables are sparse: only contexts seen in training are filled,
+ * 0.3-8% of the slots on the bench corpora (30% for the densest, a
+ * dual-order table).  blk[h >> 5] covers slots 32*i .. 32*i+31: bit
+ * k of bits is set when slot 32*i+k is occupied, and its entry is
+ * ent[base + number of set bits below k].  One 8-byte block read plus one
+ * entry read replace a read into the 256 KB dense table; the map is 32 KB
+ * and the entries 2 bytes per occupied slot.
+ *
+ * ent[] is followed by NETC_LZP_PACK_PAD zero entries, so the index an
+ * empty slot computes (at most the entry count) and a 4-byte read there
+ * stay inside the allocation.  A table with more than NETC_LZP_PACK_MAX
+ * occupied slots is smaller dense and stays dense (blk == NULL).  Adaptive
+ * contexts that own a mutable copy also use it dense.
+ * ========================================================================= */
+
+#define NETC_LZP_BLK_SHIFT  5U
+#define NETC_LZP_BLK_COUNT  (NETC_LZP_HT_SIZE >> NETC_LZP_BLK_SHIFT)   /* 4096 */
+#define NETC_LZP_PACK_PAD   2U
+#define NETC_LZP_PACK_MAX   (NETC_LZP_HT_SIZE - NETC_LZP_BLK_COUNT * 4U - NETC_LZP_PACK_PAD)
+
+typedef struct {
+    uint32_t bits;  /* occupied slots of this block of 32 */
+    uint32_t base;  /* ent[] index of the block's first occupied slot */
+} netc_lzp_blk_t;
+
+typedef struct {
+    const netc_lzp_blk_t   *blk;  /* NETC_LZP_BLK_COUNT blocks; NULL = dense */
+    const netc_lzp_entry_t *ent;  /* packed entries, or NETC_LZP_HT_SIZE dense
+                                   * ones; NULL when there is no table */
+} netc_lzp_table_t;
+
+/* Bytes of a packed table holding count entries (map, entries, padding). */
+static NETC_INLINE size_t netc_lzp_pack_size(uint32_t count)
+{
+    return (size_t)NETC_LZP_BLK_COUNT * sizeof(netc_lzp_blk_t)
+         + ((size_t)count + NETC_LZP_PACK_PAD) * sizeof(netc_lzp_entry_t);
+}
+
+/* Occupied entries of a packed table. */
+static NETC_INLINE uint32_t netc_lzp_pack_count(const netc_lzp_table_t *t)
+{
+    netc_lzp_blk_t last = t->blk[NETC_LZP_BLK_COUNT - 1U];
+    return last.base + netc_popcount32(last.bits);
+}
+
+/* Occupied slots of a dense table. */
+static NETC_INLINE uint32_t netc_lzp_count(const netc_lzp_entry_t *dense)
+{
+    uint32_t n = 0;
+    for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) n += (dense[h].valid != 0);
+    return n;
+}
+
+/* Pack a dense table into blk[NETC_LZP_BLK_COUNT] and ent[], which has
+ * room for its netc_lzp_count() entries plus the zeroed padding. */
+static NETC_INLINE void netc_lzp_pack(const netc_lzp_entry_t *dense,
+                                      netc_lzp_blk_t *blk, netc_lzp_entry_t *ent)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < NETC_LZP_BLK_COUNT; i++) {
+        blk[i].bits = 0;
+        blk[i].base = n;
+        for (uint32_t k = 0; k < 32u; k++) {
+            netc_lzp_entry_t e = dense[(i << NETC_LZP_BLK_SHIFT) + k];
+            if (e.valid == 0) continue;
+            blk[i].bits |= (uint32_t)1 << k;
+            ent[n++] = e;
+        }
+    }
+}
+
+/* Entry for hash slot h of a packed or dense table. */
+static NETC_INLINE netc_lzp_entry_t netc_lzp_get(const netc_lzp_table_t *t, uint32_t h)
+{
+    netc_lzp_entry_t e;
+    netc_lzp_blk_t   b;
+    uint32_t         bit;
+    uint8_t          keep;
+    if (t->blk == NULL) return t->ent[h];
+    b    = t->blk[h >> NETC_LZP_BLK_SHIFT];
+    bit  = (uint32_t)1 << (h & 31u);
+    e    = t->ent[b.base + netc_popcount32(b.bits & (bit - 1u))];
+    keep = (uint8_t)(0u - ((b.bits & bit) != 0));
+    e.value &= keep;
+    e.valid &= keep;
+    return e;
+}
+
+/* =========================================================================
+ * Sparse copy-on-write overlay
+ *
+ * An adaptive context starts out predicting from the frozen dict table and
+ * records only the entries it has changed.  dirty has one bit per hash
+ * slot; a set bit means the live entry is in slots[], an open-addressing
+ * table keyed by the hash slot itself (already uniformly distributed).
+ * The owner grows slots[] ahead of each packet, so lookups and updates
+ * never allocate.  An overlay with base.ent == NULL is inactive.
+ * ========================================================================= */
+
+typedef struct {
+    uint32_t         key;    /* hash slot + 1 (0 = empty) */
+    netc_lzp_entry_t e;
+} netc_lzp_ovl_slot_t;
+
+typedef struct {
+    netc_lzp_table_t        base;   /* frozen dict table */
+    uint64_t               *dirty;  /* NETC_LZP_HT_SIZE bits */
+    netc_lzp_ovl_slot_t    *slots;  /* cap entries, power of two */
+    uint32_t                cap;
+    uint32_t                count;  /* occupied slots */
+} netc_lzp_overlay_t;
+
+/* Confidence given to dict entries when an adaptive context first learns
+ * from them, so they survive a few misses before being replaced. */
+#define NETC_LZP_DICT_CONFIDENCE 4U
+
+/* Adaptive copy of a dict entry's confidence: DICT_CONFIDENCE, plus a
+ * sixteenth of a dual-order table's trained confidence so the ordering
+ * survives while drift can still replace an entry within ~20 misses. */
+static NETC_INLINE uint8_t netc_lzp_clone_conf(uint8_t valid)
+{
+    return valid ? (uint8_t)(NETC_LZP_DICT_CONFIDENCE + (valid >> 4)) : 0u;
+}
+
+static NETC_INLINE int netc_lzp_ovl_dirty(const netc_lzp_overlay_t *ovl, uint32_t h)
+{
+    return (int)((ovl->dirty[h >> 6] >> (h & 63u)) & 1u);
+}
+
+/* Slot holding h, or the empty slot where h would be inserted. */
+static NETC_INLINE netc_lzp_ovl_slot_t *netc_lzp_ovl_find(const netc_lzp_overlay_t *ovl,
+                                                          uint32_t h)
+{
+    uint32_t mask = ovl->cap - 1u;
+    uint32_t i    = h & mask;
+    while (ovl->slots[i].key != 0 && ovl->slots[i].key != h + 1u)
+        i = (i + 1u) & mask;
+    return &ovl->slots[i];
+}
+
+/* Entry for hash slot h: from the overlay when it owns the slot, else from
+ * the dense table, seen with the confidence a clone would give it.  ovl is
+ * NULL when lzp_table is authoritative. */
+static NETC_INLINE netc_lzp_entry_t netc_lzp_at(const netc_lzp_table_t   *lzp_table,
+                                                const netc_lzp_overlay_t *ovl,
+                                                uint32_t                  h)
+{
+    netc_lzp_entry_t e;
+    if (ovl == NULL) return netc_lzp_get(lzp_table, h);
+    if (netc_lzp_ovl_dirty(ovl, h)) return netc_lzp_ovl_find(ovl, h)->e;
+    e = netc_lzp_get(lzp_table, h);
+    e.valid = netc_lzp_clone_conf(e.valid);
+    return e;
+}
+
 /* =========================================================================
  * LZP hash function — position-aware order-1 context
  *
@@ -68,6 +236,42 @@ static NETC_INLINE uint32_t netc_lzp_hash(uint8_t prev_byte, uint32_t pos)
     return h & NETC_LZP_HT_MASK;
 }
 
+/* Order-2 context (dual-order tables): (prev2, prev, position).  A
+ * different basis keeps it from mirroring the order-1 slot of the same
+ * (prev, position). */
+static NETC_INLINE uint32_t netc_lzp_hash2(uint8_t prev2, uint8_t prev, uint32_t pos)
+{
+    uint32_t h = 0x9E3779B9u;
+    h ^= prev2;            h *= 16777619u;
+    h ^= prev;             h *= 16777619u;
+    h ^= (pos & 0xFFFFu);  h *= 16777619u;
+    h ^= (pos >> 16);      h *= 16777619u;
+    return h & NETC_LZP_HT_MASK;
+}
+
+/* Prediction from a byte's order-1 entry e, or with order2 set whichever
+ * of e and its order-2 entry e2 is more confident.  0x00 (XOR identity)
+ * when neither is trained. */
+static NETC_INLINE uint8_t netc_lzp_pick(netc_lzp_entry_t e, netc_lzp_entry_t e2, int order2)
+{
+    if (order2 && e2.valid >= e.valid) e = e2;
+    return e.valid ? e.value : 0x00u;
+}
+
+/* Prediction for the byte at pos (netc_lzp_pick over its entries). */
+static NETC_INLINE uint8_t netc_lzp_guess(const netc_lzp_table_t   *lzp_table,
+                                          const netc_lzp_overlay_t *ovl,
+                                          int                       order2,
+                                          uint8_t                   prev2,
+                                          uint8_t                   prev,
+                                          uint32_t                  pos)
+{
+    netc_lzp_entry_t e  = netc_lzp_at(lzp_table, ovl, netc_lzp_hash(prev, pos));
+    netc_lzp_entry_t e2 = e;
+    if (order2) e2 = netc_lzp_at(lzp_table, ovl, netc_lzp_hash2(prev2, prev, pos));
+    return netc_lzp_pick(e, e2, order2);
+}
+
 /* Keep netc_lzp_hash3 as a backward-compatible alias for training code
  * that uses 3-byte context without position (unused in current code but
  * preserves the interface). */
@@ -95,11 +299,12 @@ static NETC_INLINE uint32_t netc_lzp_hash3(const uint8_t *p)
  * ========================================================================= */
 
 static NETC_INLINE size_t netc_lzp_predict(
-    const uint8_t          *src,
-    size_t                  src_size,
-    const netc_lzp_entry_t *lzp_table,
-    uint8_t                *dst,
-    size_t                  dst_cap)
+    const uint8_t            *src,
+    size_t                    src_size,
+    const netc_lzp_table_t   *lzp_table,
+    const netc_lzp_overlay_t *ovl,
+    uint8_t                  *dst,
+    size_t                    dst_cap)
 {
     if (src_size < 2) return (size_t)-1;  /* too small for any benefit */
 
@@ -119,7 +324,9 @@ static NETC_INLINE size_t netc_lzp_predict(
         uint8_t prev = (i > 0) ? src[i - 1] : 0x00u;
         uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
 
-        if (lzp_table[h].valid && lzp_table[h].value == src[i]) {
+        netc_lzp_entry_t e = netc_lzp_at(lzp_table, ovl, h);
+
+        if (e.valid && e.value == src[i]) {
             /* Match — set flag bit to 1 */
             flag_dst[i >> 3] |= (uint8_t)(0x80u >> (i & 7u));
         } else {
@@ -151,11 +358,12 @@ static NETC_INLINE size_t netc_lzp_predict(
  * ========================================================================= */
 
 static NETC_INLINE int netc_lzp_reconstruct(
-    const uint8_t          *src,
-    size_t                  src_size,
-    const netc_lzp_entry_t *lzp_table,
-    uint8_t                *dst,
-    size_t                  dst_size)
+    const uint8_t            *src,
+    size_t                    src_size,
+    const netc_lzp_table_t   *lzp_table,
+    const netc_lzp_overlay_t *ovl,
+    uint8_t                  *dst,
+    size_t                    dst_size)
 {
     if (dst_size < 2) return -1;
     if (src_size < 2) return -1;
@@ -178,8 +386,9 @@ static NETC_INLINE int netc_lzp_reconstruct(
 
         if (flag) {
             /* Match — predict from hash table */
-            if (!lzp_table[h].valid) return -1;  /* corrupt: flag=1 but no prediction */
-            dst[i] = lzp_table[h].value;
+            netc_lzp_entry_t e = netc_lzp_at(lzp_table, ovl, h);
+            if (!e.valid) return -1;  /* corrupt: flag=1 but no prediction */
+            dst[i] = e.value;
         } else {
             /* Miss — read literal */
             if (lit_idx >= n_literals) return -1;
@@ -199,23 +408,25 @@ static NETC_INLINE int netc_lzp_reconstruct(
  * unchanged (XOR with 0).
  *
  * This is a composable pre-filter — the output has the same size as
- * src_size and feeds directly into tANS multi-region encoding.
+ * src_size and feeds directly into tANS multi-region encoding.  order2
+ * selects the dual-order prediction of NETC_DICT_FLAG_LZP2 tables.
  *
  * prev_byte_out: if non-NULL, receives the last decoded (original) byte
  * for use in sequential contexts. Not used currently.
  * ========================================================================= */
 
 static NETC_INLINE void netc_lzp_xor_filter(
-    const uint8_t          *src,
-    size_t                  src_size,
-    const netc_lzp_entry_t *lzp_table,
-    uint8_t                *dst)
+    const uint8_t            *src,
+    size_t                    src_size,
+    const netc_lzp_table_t   *lzp_table,
+    const netc_lzp_overlay_t *ovl,
+    int                       order2,
+    uint8_t                  *dst)
 {
     for (size_t i = 0; i < src_size; i++) {
-        uint8_t prev = (i > 0) ? src[i - 1] : 0x00u;
-        uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
-        uint8_t prediction = (lzp_table[h].valid) ? lzp_table[h].value : 0x00u;
-        dst[i] = src[i] ^ prediction;
+        uint8_t prev  = (i > 0) ? src[i - 1] : 0x00u;
+        uint8_t prev2 = (i > 1) ? src[i - 2] : 0x00u;
+        dst[i] = src[i] ^ netc_lzp_guess(lzp_table, ovl, order2, prev2, prev, (uint32_t)i);
     }
 }
 
@@ -232,17 +443,18 @@ static NETC_INLINE void netc_lzp_xor_filter(
  * ========================================================================= */
 
 static NETC_INLINE void netc_lzp_xor_unfilter(
-    const uint8_t          *src,
-    size_t                  src_size,
-    const netc_lzp_entry_t *lzp_table,
-    uint8_t                *dst)
+    const uint8_t            *src,
+    size_t                    src_size,
+    const netc_lzp_table_t   *lzp_table,
+    const netc_lzp_overlay_t *ovl,
+    int                       order2,
+    uint8_t                  *dst)
 {
     for (size_t i = 0; i < src_size; i++) {
-        /* Previous ORIGINAL byte (already reconstructed in dst) */
-        uint8_t prev = (i > 0) ? dst[i - 1] : 0x00u;
-        uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
-        uint8_t prediction = (lzp_table[h].valid) ? lzp_table[h].value : 0x00u;
-        dst[i] = src[i] ^ prediction;
+        /* Previous ORIGINAL bytes (already reconstructed in dst) */
+        uint8_t prev  = (i > 0) ? dst[i - 1] : 0x00u;
+        uint8_t prev2 = (i > 1) ? dst[i - 2] : 0x00u;
+        dst[i] = src[i] ^ netc_lzp_guess(lzp_table, ovl, order2, prev2, prev, (uint32_t)i);
     }
 }
 
@@ -256,43 +468,89 @@ static NETC_INLINE void netc_lzp_xor_unfilter(
  * from the live connection, improving prediction hit rate over time.
  *
  * Called identically on both encoder and decoder with the same raw bytes,
- * keeping the tables in sync without any wire overhead.
+ * keeping the tables in sync without any wire overhead.  With order2 the
+ * byte's order-2 slot learns it as well.
  * ========================================================================= */
 
+static NETC_INLINE void netc_lzp_learn(netc_lzp_entry_t *e, uint8_t byte)
+{
+    if (!e->valid) {
+        /* Empty slot — fill with observed byte */
+        e->value = byte;
+        e->valid = 1;
+    } else if (e->value != byte) {
+        /* Prediction miss on a trained slot.  Use a lightweight
+         * exponential-decay replacement: the `valid` field doubles
+         * as a confidence counter (1-255).  On miss, decrement;
+         * when it reaches 0, overwrite with the new value.  On hit,
+         * saturating-increment toward 255.  This prevents thrashing
+         * from hash collisions while still adapting to distribution
+         * shifts over many packets. */
+        if (e->valid > 1) {
+            e->valid--;
+        } else {
+            /* Confidence depleted — replace prediction */
+            e->value = byte;
+            e->valid = 1;
+        }
+    } else {
+        /* Hit — boost confidence (saturating increment) */
+        if (e->valid < 255)
+            e->valid++;
+    }
+}
+
 static NETC_INLINE void netc_lzp_adaptive_update(
     netc_lzp_entry_t *lzp_table,
     const uint8_t    *data,
-    size_t            data_size)
+    size_t            data_size,
+    int               order2)
 {
     if (!lzp_table || !data || data_size == 0) return;
 
     for (size_t i = 0; i < data_size; i++) {
         uint8_t prev = (i > 0) ? data[i - 1] : 0x00u;
-        uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
+        netc_lzp_learn(&lzp_table[netc_lzp_hash(prev, (uint32_t)i)], data[i]);
+        if (order2) {
+            uint8_t prev2 = (i > 1) ? data[i - 2] : 0x00u;
+            netc_lzp_learn(&lzp_table[netc_lzp_hash2(prev2, prev, (uint32_t)i)], data[i]);
+        }
+    }
+}
 
-        if (!lzp_table[h].valid) {
-            /* Empty slot — fill with observed byte */
-            lzp_table[h].value = data[i];
-            lzp_table[h].valid = 1;
-        } else if (lzp_table[h].value != data[i]) {
-            /* Prediction miss on a trained slot.  Use a lightweight
-             * exponential-decay replacement: the `valid` field doubles
-             * as a confidence counter (1-255).  On miss, decrement;
-             * when it reaches 0, overwrite with the new value.  On hit,
-             * saturating-increment toward 255.  This prevents thrashing
-             * from hash collisions while still adapting to distribution
-             * shifts over many packets. */
-            if (lzp_table[h].valid > 1) {
-                lzp_table[h].valid--;
-            } else {
-                /* Confidence depleted — replace prediction */
-                lzp_table[h].value = data[i];
-                lzp_table[h].valid = 1;
-            }
-        } else {
-            /* Hit — boost confidence (saturating increment) */
-            if (lzp_table[h].valid < 255)
-                lzp_table[h].valid++;
+/* Learn byte in overlay slot h.  A slot is copied from the base on first
+ * write, with dict confidence applied as if the whole table had been
+ * cloned. */
+static NETC_INLINE void netc_lzp_overlay_learn(netc_lzp_overlay_t *ovl, uint32_t h,
+                                               uint8_t byte)
+{
+    netc_lzp_ovl_slot_t *slot = netc_lzp_ovl_find(ovl, h);
+
+    if (slot->key == 0) {
+        slot->key = h + 1u;
+        slot->e   = netc_lzp_get(&ovl->base, h);
+        slot->e.valid = netc_lzp_clone_conf(slot->e.valid);
+        ovl->dirty[h >> 6] |= (uint64_t)1 << (h & 63u);
+        ovl->count++;
+    }
+    netc_lzp_learn(&slot->e, byte);
+}
+
+/* Same as netc_lzp_adaptive_update, but writes go to the overlay.  The
+ * overlay must have room for one new slot per context touched
+ * (count + data_size, twice that with order2, <= cap / 2). */
+static NETC_INLINE void netc_lzp_overlay_update(
+    netc_lzp_overlay_t *ovl,
+    const uint8_t      *data,
+    size_t              data_size,
+    int                 order2)
+{
+    for (size_t i = 0; i < data_size; i++) {
+        uint8_t prev = (i > 0) ? data[i - 1] : 0x00u;
+        netc_lzp_overlay_learn(ovl, netc_lzp_hash(prev, (uint32_t)i), data[i]);
+        if (order2) {
+            uint8_t prev2 = (i > 1) ? data[i - 2] : 0x00u;
+            netc_lzp_overlay_learn(ovl, netc_lzp_hash2(prev2, prev, (uint32_t)i), data[i]);
         }
     }
 }
@@ -0,0 +1,189 @@
+/**
+ * netc_rans.c — static rANS codec implementation.
+ *
+ * Byte-wise range ANS with a 32-bit state (as in ryg_rans "rans_byte"),
+ * driven by the dictionary's 12-bit normalized frequencies.
+ *
+ * Encoding runs backwards over the packet and emits renormalization bytes
+ * backwards from the end of dst; the stream is moved behind the flushed
+ * states once the packet is done, so no scratch buffer is needed.  Every
+ * state starts at L, and the decoder checks that every state has returned
+ * to L and the stream is fully consumed — a cheap integrity check.
+ *
+ * Renormalization bound: the encoder flushes bytes while
+ *   x >= ((L >> PREC_BITS) << 8) · f
+ * so that the coded state stays in [L, 256·L).  With f >= 1 that is at most
+ * two bytes per symbol.
+ */
+
+#include "netc_rans.h"
+#include "../util/netc_platform.h"
+#include <string.h>
+
+/* =========================================================================
+ * netc_rans_build
+ * ========================================================================= */
+
+int netc_rans_build(netc_rans_table_t *tbl, const netc_freq_table_t *freq) {
+    if (!tbl || !freq) return -1;
+    tbl->valid = 0;
+
+    uint32_t cumul = 0;
+    for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
+        uint32_t f = freq->freq[s];
+        if (cumul + f > NETC_RANS_PREC_SIZE) return -1;
+        tbl->sym[s].freq  = (uint16_t)f;
+        tbl->sym[s].cumul = (uint16_t)cumul;
+        if (f > 0) memset(tbl->slot_sym + cumul, (int)s, f);
+        cumul += f;
+    }
+    if (cumul != NETC_RANS_PREC_SIZE) return -1;
+
+    tbl->valid = 1;
+    return 0;
+}
+
+/* =========================================================================
+ * netc_rans_encode_pctx
+ * ========================================================================= */
+
+size_t netc_rans_encode_pctx(
+    const netc_rans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   dst_cap)
+{
+    if (!tables || !src || !dst || src_size == 0) return (size_t)-1;
+    if (dst_cap < NETC_RANS_STATE_SIZE) return (size_t)-1;
+    if (!buckets) buckets = &netc_bucket_map_default;
+
+    uint32_t x[NETC_RANS_STATES];
+    for (uint32_t k = 0; k < NETC_RANS_STATES; k++) x[k] = NETC_RANS_L;
+
+    const uint32_t mask  = NETC_RANS_STATES - 1U;
+    uint8_t *const floor = dst + NETC_RANS_STATE_SIZE;
+    uint8_t       *p     = dst + dst_cap;
+
+    for (size_t i = src_size; i-- > 0; ) {
+        const netc_rans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (!tbl->valid) return (size_t)-1;
+
+        const netc_rans_sym_t e = tbl->sym[src[i]];
+        uint32_t f = e.freq;
+        if (f == 0) return (size_t)-1; /* symbol not in this table */
+
+        uint32_t *xs   = &x[i & mask];
+        uint32_t  xv   = *xs;
+        uint32_t  xmax = ((NETC_RANS_L >> NETC_RANS_PREC_BITS) << 8) * f;
+        while (xv >= xmax) {
+            if (p <= floor) return (size_t)-1;
+            *--p = (uint8_t)xv;
+            xv >>= 8;
+        }
+        *xs = ((xv / f) << NETC_RANS_PREC_BITS) + (xv % f) + e.cumul;
+    }
+
+    size_t stream = (size_t)(dst + dst_cap - p);
+    memmove(floor, p, stream);
+    for (uint32_t k = 0; k < NETC_RANS_STATES; k++)
+        netc_write_u32_le(dst + (size_t)k * NETC_RANS_STATE_BYTES, x[k]);
+    return NETC_RANS_STATE_SIZE + stream;
+}
+
+/* =========================================================================
+ * netc_rans_decode_pctx
+ *
+ * After a decode step x >= 2^11, so renormalization reads at most two bytes.
+ * While two bytes per state remain, a group is decoded without bounds
+ * checks; the last few bytes go through the checked step.  (A branchless
+ * renorm was measured slower: it serializes the four chains through the
+ * shared stream pointer, where the predicted branch lets them overlap.)
+ * ========================================================================= */
+
+/* Decode one symbol from state *X; *p must have two readable bytes. */
+static NETC_INLINE void rans_decode_step(
+    const netc_rans_table_t *tbl, const uint8_t **p, uint32_t *X, uint8_t *out)
+{
+    uint32_t x    = *X;
+    uint32_t slot = x & (NETC_RANS_PREC_SIZE - 1U);
+    uint8_t  s    = tbl->slot_sym[slot];
+    const netc_rans_sym_t e = tbl->sym[s];
+
+    *out = s;
+    x = (uint32_t)e.freq * (x >> NETC_RANS_PREC_BITS) + slot - e.cumul;
+
+    if (x < NETC_RANS_L) {
+        x = (x << 8) | *(*p)++;
+        if (x < NETC_RANS_L) x = (x << 8) | *(*p)++;
+    }
+    *X = x;
+}
+
+/* Bounds-checked variant.  Returns -1 when the stream runs out. */
+static NETC_INLINE int rans_decode_step_checked(
+    const netc_rans_table_t *tbl, const uint8_t **p, const uint8_t *end,
+    uint32_t *X, uint8_t *out)
+{
+    uint32_t x    = *X;
+    uint32_t slot = x & (NETC_RANS_PREC_SIZE - 1U);
+    uint8_t  s    = tbl->slot_sym[slot];
+    const netc_rans_sym_t e = tbl->sym[s];
+
+    *out = s;
+    x = (uint32_t)e.freq * (x >> NETC_RANS_PREC_BITS) + slot - e.cumul;
+    while (x < NETC_RANS_L) {
+        if (*p >= end) return -1;
+        x = (x << 8) | *(*p)++;
+    }
+    *X = x;
+    return 0;
+}
+
+int netc_rans_decode_pctx(
+    const netc_rans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   dst_size)
+{
+    if (!tables || !src || !dst || dst_size == 0) return -1;
+    if (src_size < NETC_RANS_STATE_SIZE) return -1;
+    if (!buckets) buckets = &netc_bucket_map_default;
+
+    uint32_t X[NETC_RANS_STATES];
+    for (uint32_t k = 0; k < NETC_RANS_STATES; k++) {
+        X[k] = netc_read_u32_le(src + (size_t)k * NETC_RANS_STATE_BYTES);
+        if (X[k] < NETC_RANS_L || X[k] >= (NETC_RANS_L << 8)) return -1;
+    }
+
+    const uint32_t N   = NETC_RANS_STATES;
+    const uint8_t *p   = src + NETC_RANS_STATE_SIZE;
+    const uint8_t *end = src + src_size;
+    size_t i = 0;
+
+    /* Whole groups (bucket boundaries are multiples of 8, so a group never
+     * straddles two tables) while every lane can read two bytes */
+    for (; i + N <= dst_size && (size_t)(end - p) >= 2U * N; i += N) {
+        const netc_rans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (!tbl->valid) return -1;
+        rans_decode_step(tbl, &p, &X[0], &dst[i + 0]);
+        rans_decode_step(tbl, &p, &X[1], &dst[i + 1]);
+        rans_decode_step(tbl, &p, &X[2], &dst[i + 2]);
+        rans_decode_step(tbl, &p, &X[3], &dst[i + 3]);
+    }
+
+    for (; i < dst_size; i++) {
+        const netc_rans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (!tbl->valid) return -1;
+        if (rans_decode_step_checked(tbl, &p, end, &X[i & (N - 1U)], &dst[i]) != 0)
+            return -1;
+    }
+
+    if (p != end) return -1;
+    for (uint32_t k = 0; k < N; k++)
+        if (X[k] != NETC_RANS_L) return -1;
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * netc_rans.h — static rANS codec internal types and interface.
+ *
+ * INTERNAL HEADER — not part of the public API.
+ *
+ * Range ANS over the same 12-bit normalized frequencies as tANS
+ * (netc_freq_table_t, sum = 4096), with a 32-bit state and byte-wise
+ * renormalization:
+ *   State range: [L, 256·L) with L = 2^23
+ *   Encode s:    x' = ((x / f) << 12) + (x % f) + cumul[s]
+ *   Decode:      slot = x & 4095, s = slot_sym[slot],
+ *                x' = f · (x >> 12) + slot - cumul[s]
+ *
+ * Compared with a tANS table (16 KB decode + 8 KB encode_state + 2 KB
+ * encode entries), a rANS table is a 4 KB slot→symbol map plus 1 KB of
+ * (freq, cumul) pairs, built in one pass over the frequencies.  The coder
+ * spends exactly -log2(freq/4096) bits per symbol (no spread-function loss)
+ * but pays 4 bytes per flushed state, so it only competes on wide packets.
+ */
+
+#ifndef NETC_RANS_H
+#define NETC_RANS_H
+
+#include "netc_tans.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * rANS parameters
+ * ========================================================================= */
+
+#define NETC_RANS_PREC_BITS  NETC_TANS_TABLE_LOG           /* 12 */
+#define NETC_RANS_PREC_SIZE  (1U << NETC_RANS_PREC_BITS)   /* 4096 */
+#define NETC_RANS_L          (1U << 23)                    /* lower state bound */
+#define NETC_RANS_STATE_BYTES 4U
+
+/* =========================================================================
+ * Per-bucket rANS table
+ *
+ * sym[s]       (freq, cumul) of symbol s; freq == 0 marks an absent symbol.
+ * slot_sym[k]  symbol owning cumulative slot k, i.e. cumul[s] <= k < cumul[s]+freq[s].
+ * ========================================================================= */
+
+typedef struct {
+    uint16_t freq;
+    uint16_t cumul;
+} netc_rans_sym_t;
+
+typedef struct {
+    netc_rans_sym_t sym[NETC_TANS_SYMBOLS];   /*  1 KB */
+    uint8_t         slot_sym[NETC_RANS_PREC_SIZE]; /* 4 KB */
+    uint32_t        valid;
+} netc_rans_table_t;
+
+/**
+ * Build a rANS table from a normalized frequency table.
+ * Returns 0 on success, -1 if the frequencies do not sum to 4096.
+ */
+int netc_rans_build(netc_rans_table_t *tbl, const netc_freq_table_t *freq);
+
+/* =========================================================================
+ * Interleaved per-position rANS (PCTX layout)
+ *
+ * Byte i is coded with tables[netc_bucket_of(buckets, i)] by state i % 4, so the
+ * tables follow the same position buckets as tANS PCTX.  The four states
+ * share one byte stream; their chains are independent, which lets the
+ * decoder overlap four table lookups per group.
+ *
+ * Wire format: [4 × 4B state, LE, state 0 first][renorm bytes].
+ *
+ * The 16 state bytes only pay off on wide packets: the compressor offers
+ * rANS from NETC_RANS_MIN bytes.
+ * ========================================================================= */
+
+#define NETC_RANS_STATES     4U
+#define NETC_RANS_STATE_SIZE (NETC_RANS_STATES * NETC_RANS_STATE_BYTES) /* 16 */
+#define NETC_RANS_MIN        1024U  /* smallest packet worth a rANS trial */
+
+/**
+ * Encode src with per-position rANS tables into dst.
+ * Returns the payload size (states + stream), or (size_t)-1 if a symbol is
+ * absent from its table or dst_cap is too small.
+ */
+size_t netc_rans_encode_pctx(
+    const netc_rans_table_t *tables,   /* array of NETC_CTX_COUNT tables */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   dst_cap
+);
+
+/**
+ * Decode dst_size bytes of a netc_rans_encode_pctx payload.
+ * Returns 0 on success, -1 on corrupt input (truncated stream, trailing
+ * bytes, or final states that do not return to L).
+ */
+int netc_rans_decode_pctx(
+    const netc_rans_table_t *tables,   /* array of NETC_CTX_COUNT tables */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   dst_size
+);
+
+#endif /* NETC_RANS_H */
@@ -40,6 +40,57 @@ static NETC_INLINE int floor_log2_u32(uint32_t v) {
     return n;
 }
 
+/* =========================================================================
+ * Static position bucket layout
+ * ========================================================================= */
+
+const netc_bucket_map_t netc_bucket_map_default = {
+    {
+        /* [0..7]     bucket 0 */ 0,0,0,0,0,0,0,0,
+        /* [8..15]    bucket 1 */ 1,1,1,1,1,1,1,1,
+        /* [16..23]   bucket 2 */ 2,2,2,2,2,2,2,2,
+        /* [24..31]   bucket 3 */ 3,3,3,3,3,3,3,3,
+        /* [32..47]   bucket 4 */ 4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
+        /* [48..63]   bucket 5 */ 5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,
+        /* [64..95]   bucket 6 */ 6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,
+                                  6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,
+        /* [96..127]  bucket 7 */ 7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+                                  7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+        /* [128..191] bucket 8 */ 8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
+                                  8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
+                                  8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
+                                  8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
+        /* [192..255] bucket 9 */ 9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+                                  9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+                                  9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+                                  9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9
+    },
+    {
+        8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512,
+        1024, 4096, 16384, 65536
+    }
+};
+
+/* =========================================================================
+ * netc_tans_log2_q8
+ *
+ * log2(v) in Q8 fixed point: integer part from the highest set bit, then
+ * eight fraction bits by repeated squaring of the normalized mantissa.
+ * Exact to within 1/256 bit; avoids a libm dependency.
+ * ========================================================================= */
+
+uint32_t netc_tans_log2_q8(uint32_t v) {
+    if (v <= 1U) return 0;
+    int      n = floor_log2_u32(v);
+    uint64_t x = ((uint64_t)v << 16) >> (uint32_t)n; /* Q16 in [1, 2) */
+    uint32_t r = (uint32_t)n << NETC_TANS_COST_SHIFT;
+    for (uint32_t b = 1U << (NETC_TANS_COST_SHIFT - 1U); b != 0; b >>= 1) {
+        x = (x * x) >> 16;
+        if (x >= (2ULL << 16)) { x >>= 1; r |= b; }
+    }
+    return r;
+}
+
 /* =========================================================================
  * netc_tans_build
  *
@@ -87,6 +138,14 @@ int netc_tans_build(netc_tans_table_t *tbl, const netc_freq_table_t *freq) {
         tbl->encode[s].cumul = cumul[s];
     }
 
+    /* --- Step 2b: Symbol cost LUT for the size estimators --- */
+    const uint32_t full_q8 = (uint32_t)NETC_TANS_TABLE_LOG << NETC_TANS_COST_SHIFT;
+    for (int s = 0; s < (int)NETC_TANS_SYMBOLS; s++) {
+        uint32_t f = freq->freq[s];
+        tbl->cost[s] = (uint16_t)(f == 0 ? NETC_TANS_COST_ABSENT
+                                         : full_q8 - netc_tans_log2_q8(f));
+    }
+
     /* --- Step 3: Generate spread table using FSE step function ---
      *
      * step = (TABLE_SIZE>>1) + (TABLE_SIZE>>3) + 3 = 2563.
@@ -408,7 +467,7 @@ int netc_tans_decode(
  *
  * Per-position context-adaptive ANS encoder.  Processes bytes in reverse
  * order (standard ANS), switching the probability table per byte offset:
- *   tbl = tables[netc_ctx_bucket(i)]
+ *   tbl = tables[netc_bucket_of(buckets, i)]
  *
  * This gives per-position entropy specialization (like MREG multi-region)
  * with ZERO descriptor overhead — wire format is [4B state][bitstream].
@@ -418,18 +477,20 @@ int netc_tans_decode(
 
 uint32_t netc_tans_encode_pctx(
     const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
     const uint8_t           *src,
     size_t                   src_size,
     netc_bsw_t              *bsw,
     uint32_t                 initial_state)
 {
+    if (!buckets) buckets = &netc_bucket_map_default;
     if (!tables || !src || !bsw || src_size == 0) return 0;
 
     uint32_t X = initial_state;
     if (X < NETC_TANS_TABLE_SIZE) X = NETC_TANS_TABLE_SIZE;
 
     for (size_t i = src_size; i-- > 0; ) {
-        uint32_t bucket = netc_ctx_bucket((uint32_t)i);
+        uint32_t bucket = netc_bucket_of(buckets, (uint32_t)i);
         const netc_tans_table_t *tbl = &tables[bucket];
         if (!tbl->valid) return 0;
 
@@ -460,25 +521,27 @@ uint32_t netc_tans_encode_pctx(
  *
  * Per-position context-adaptive ANS decoder.  Decodes bytes in forward
  * order, switching the decode table per byte offset:
- *   tbl = tables[netc_ctx_bucket(i)]
+ *   tbl = tables[netc_bucket_of(buckets, i)]
  *
  * Returns 0 on success, -1 on corrupt input.
  * ========================================================================= */
 
 int netc_tans_decode_pctx(
     const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
     netc_bsr_t              *bsr,
     uint8_t                 *dst,
     size_t                   dst_size,
     uint32_t                 initial_state)
 {
+    if (!buckets) buckets = &netc_bucket_map_default;
     if (!tables || !bsr || !dst || dst_size == 0) return -1;
 
     uint32_t X = initial_state;
     if (X < NETC_TANS_TABLE_SIZE || X >= 2U * NETC_TANS_TABLE_SIZE) return -1;
 
     for (size_t i = 0; i < dst_size; i++) {
-        uint32_t bucket = netc_ctx_bucket((uint32_t)i);
+        uint32_t bucket = netc_bucket_of(buckets, (uint32_t)i);
         const netc_tans_table_t *tbl = &tables[bucket];
         if (!tbl->valid) return -1;
 
@@ -499,28 +562,61 @@ int netc_tans_decode_pctx(
     return 0;
 }
 
+/* =========================================================================
+ * netc_tans_encode_roles
+ *
+ * Single-state encoder with a caller-chosen table per symbol:
+ *   tbl = tables[role[i]]
+ *
+ * Returns final state (initial state for decoder), or 0 on error.
+ * ========================================================================= */
+
+uint32_t netc_tans_encode_roles(
+    const netc_tans_table_t * const *tables,
+    const uint8_t           *role,
+    const uint8_t           *src,
+    size_t                   src_size,
+    netc_bsw_t              *bsw,
+    uint32_t                 initial_state)
+{
+    if (!tables || !role || !src || !bsw || src_size == 0) return 0;
+
+    uint32_t X = initial_state;
+    if (X < NETC_TANS_TABLE_SIZE) X = NETC_TANS_TABLE_SIZE;
+
+    for (size_t i = src_size; i-- > 0; ) {
+        const netc_tans_table_t *tbl = tables[role[i]];
+        if (!tbl->valid || tbl->encode[src[i]].freq == 0) return 0;
+        if (tans_encode_step(tbl, &X, src[i], bsw) != 0) return 0;
+    }
+
+    return X;
+}
+
 /* =========================================================================
  * netc_tans_encode_pctx_bigram
  *
  * Per-position context-adaptive BIGRAM encoder.  Processes bytes in reverse
  * order (standard ANS), switching the probability table per byte using BOTH
  * position bucket AND bigram class:
- *   bucket = netc_ctx_bucket(i)
+ *   bucket = netc_bucket_of(buckets, i)
  *   bclass = netc_bigram_class(src[i-1], class_map)  (prev_byte at pos 0 = 0x00)
- *   tbl    = bigram_tables[bucket][bclass]  (fallback to unigram if invalid)
+ *   tbl    = bigram_tables->t[bucket][bclass]  (fallback to unigram if invalid)
  *
  * Returns final state (initial state for decoder), or 0 on error.
  * ========================================================================= */
 
 uint32_t netc_tans_encode_pctx_bigram(
-    const netc_tans_table_t bigram_tables[][NETC_BIGRAM_CTX_COUNT],
+    const netc_bigram_set_t *bigram_tables,
     const netc_tans_table_t *unigram_tables,
     const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
     const uint8_t           *src,
     size_t                   src_size,
     netc_bsw_t              *bsw,
     uint32_t                 initial_state)
 {
+    if (!buckets) buckets = &netc_bucket_map_default;
     if (!bigram_tables || !unigram_tables || !src || !bsw || src_size == 0)
         return 0;
 
@@ -528,13 +624,13 @@ uint32_t netc_tans_encode_pctx_bigram(
     if (X < NETC_TANS_TABLE_SIZE) X = NETC_TANS_TABLE_SIZE;
 
     for (size_t i = src_size; i-- > 0; ) {
-        uint32_t bucket = netc_ctx_bucket((uint32_t)i);
+        uint32_t bucket = netc_bucket_of(buckets, (uint32_t)i);
 
         /* Bigram context: previous byte (position i-1), or 0x00 at start */
         uint8_t prev_byte = (i > 0) ? src[i - 1] : 0x00u;
         uint32_t bclass = netc_bigram_class(prev_byte, class_map);
 
-        const netc_tans_table_t *tbl = &bigram_tables[bucket][bclass];
+        const netc_tans_table_t *tbl = bigram_tables->t[bucket][bclass];
         if (!tbl->valid) tbl = &unigram_tables[bucket];
         if (!tbl->valid) return 0;
 
@@ -560,28 +656,99 @@ uint32_t netc_tans_encode_pctx_bigram(
     return X;
 }
 
+/* =========================================================================
+ * Cost estimators (see netc_tans.h)
+ *
+ * Each mirrors the table selection of its encoder exactly, so the ranking
+ * between candidates matches what encoding them would produce up to the
+ * fractional-bit rounding of the ANS state.
+ * ========================================================================= */
+
+uint32_t netc_tans_cost(
+    const netc_tans_table_t *tbl,
+    const uint8_t           *src,
+    size_t                   src_size)
+{
+    if (!tbl || !tbl->valid || !src) return NETC_TANS_COST_INVALID;
+
+    const uint16_t *cost = tbl->cost;
+    uint32_t c0 = 0, c1 = 0;
+    size_t   i  = 0;
+    for (; i + 2 <= src_size; i += 2) {
+        c0 += cost[src[i]];
+        c1 += cost[src[i + 1]];
+    }
+    if (i < src_size) c0 += cost[src[i]];
+    return c0 + c1;
+}
+
+uint32_t netc_tans_cost_pctx(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *src,
+    size_t                   src_size)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (!tables || !src) return NETC_TANS_COST_INVALID;
+
+    uint32_t c = 0;
+    for (size_t i = 0; i < src_size; i++) {
+        const netc_tans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (!tbl->valid) return NETC_TANS_COST_INVALID;
+        c += tbl->cost[src[i]];
+    }
+    return c;
+}
+
+uint32_t netc_tans_cost_pctx_bigram(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *src,
+    size_t                   src_size)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (!bigram_tables || !unigram_tables || !src) return NETC_TANS_COST_INVALID;
+
+    uint32_t c    = 0;
+    uint8_t  prev = 0x00u;
+    for (size_t i = 0; i < src_size; i++) {
+        uint32_t bucket = netc_bucket_of(buckets, (uint32_t)i);
+        uint32_t bclass = netc_bigram_class(prev, class_map);
+        const netc_tans_table_t *tbl = bigram_tables->t[bucket][bclass];
+        if (!tbl->valid) tbl = &unigram_tables[bucket];
+        if (!tbl->valid) return NETC_TANS_COST_INVALID;
+        c   += tbl->cost[src[i]];
+        prev = src[i];
+    }
+    return c;
+}
+
 /* =========================================================================
  * netc_tans_decode_pctx_bigram
  *
  * Per-position context-adaptive BIGRAM decoder.  Decodes bytes in forward
  * order, switching the decode table per byte using BOTH position bucket AND
  * bigram class derived from the previously decoded byte:
- *   bucket = netc_ctx_bucket(i)
+ *   bucket = netc_bucket_of(buckets, i)
  *   bclass = netc_bigram_class(dst[i-1], class_map)  (prev at pos 0 = 0x00)
- *   tbl    = bigram_tables[bucket][bclass]  (fallback to unigram if invalid)
+ *   tbl    = bigram_tables->t[bucket][bclass]  (fallback to unigram if invalid)
  *
  * Returns 0 on success, -1 on corrupt input.
  * ========================================================================= */
 
 int netc_tans_decode_pctx_bigram(
-    const netc_tans_table_t bigram_tables[][NETC_BIGRAM_CTX_COUNT],
+    const netc_bigram_set_t *bigram_tables,
     const netc_tans_table_t *unigram_tables,
     const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
     netc_bsr_t              *bsr,
     uint8_t                 *dst,
     size_t                   dst_size,
     uint32_t                 initial_state)
 {
+    if (!buckets) buckets = &netc_bucket_map_default;
     if (!bigram_tables || !unigram_tables || !bsr || !dst || dst_size == 0)
         return -1;
 
@@ -589,13 +756,13 @@ int netc_tans_decode_pctx_bigram(
     if (X < NETC_TANS_TABLE_SIZE || X >= 2U * NETC_TANS_TABLE_SIZE) return -1;
 
     for (size_t i = 0; i < dst_size; i++) {
-        uint32_t bucket = netc_ctx_bucket((uint32_t)i);
+        uint32_t bucket = netc_bucket_of(buckets, (uint32_t)i);
 
         /* Bigram context: previous decoded byte, or 0x00 at start */
         uint8_t prev_byte = (i > 0) ? dst[i - 1] : 0x00u;
         uint32_t bclass = netc_bigram_class(prev_byte, class_map);
 
-        const netc_tans_table_t *tbl = &bigram_tables[bucket][bclass];
+        const netc_tans_table_t *tbl = bigram_tables->t[bucket][bclass];
         if (!tbl->valid) tbl = &unigram_tables[bucket];
         if (!tbl->valid) return -1;
 
@@ -616,6 +783,349 @@ int netc_tans_decode_pctx_bigram(
     return 0;
 }
 
+/* =========================================================================
+ * Interleaved PCTX (X4 / X8)
+ *
+ * Encoder: right-to-left over the packet, byte i coded by state
+ * X[i & (n_states-1)].  Decoder: left-to-right, same state assignment.
+ * Reversing the symbol order also reverses the bit order, so all states
+ * can share one bitstream exactly as in netc_tans_encode_x2.
+ *
+ * The first step of each chain (the last n_states bytes of the packet)
+ * starts from the fixed state TABLE_SIZE, so its renormalization bits carry
+ * no information: the encoder drops them and the decoder, which never needs
+ * a state past the end of the packet, does not read them.
+ *
+ * The decoders are instantiated for a constant N (4 or 8) so the state
+ * array stays in registers and the per-group loops unroll.  Each group of
+ * 4 symbols needs at most 48 bits; one netc_bsr_refill (>= 57 bits) per
+ * group replaces the per-symbol refill loop of netc_bsr_read.
+ * ========================================================================= */
+
+static NETC_INLINE int xn_states_ok(uint32_t n_states) {
+    return n_states == 4U || n_states == 8U;
+}
+
+/* One encode step with the absent-symbol check the PCTX encoders need;
+ * emit == 0 drops the renormalization bits (first step of a chain). */
+static NETC_INLINE int tans_encode_step_xn(
+    const netc_tans_table_t *tbl, uint32_t *X, uint8_t sym, netc_bsw_t *bsw,
+    int emit)
+{
+    if (!tbl->valid) return -1;
+    const netc_tans_encode_entry_t *e = &tbl->encode[sym];
+    if (e->freq == 0) return -1;
+    int      nb_hi = (int)e->nb_hi;
+    int      nb    = (nb_hi == 0 || *X >= e->lower) ? nb_hi : nb_hi - 1;
+    uint32_t j     = (*X >> (uint32_t)nb) - e->freq;
+    if (emit && nb > 0) {
+        if (netc_bsw_write(bsw, *X & ((1U << (uint32_t)nb) - 1U), nb) != 0)
+            return -1;
+    }
+    *X = (uint32_t)tbl->encode_state[(uint32_t)e->cumul + j];
+    return 0;
+}
+
+int netc_tans_encode_pctx_xn(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *src,
+    size_t                   src_size,
+    netc_bsw_t              *bsw,
+    uint32_t                 n_states,
+    uint32_t                *out_states)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (!tables || !src || !bsw || !out_states || src_size == 0) return -1;
+    if (!xn_states_ok(n_states)) return -1;
+
+    uint32_t X[NETC_TANS_MAX_STATES];
+    const size_t mask = n_states - 1U;
+    for (uint32_t k = 0; k < n_states; k++) X[k] = NETC_TANS_TABLE_SIZE;
+
+    for (size_t i = src_size; i-- > 0; ) {
+        const netc_tans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (tans_encode_step_xn(tbl, &X[i & mask], src[i], bsw,
+                                i + n_states < src_size) != 0)
+            return -1;
+    }
+
+    for (uint32_t k = 0; k < n_states; k++) out_states[k] = X[k];
+    return 0;
+}
+
+int netc_tans_encode_pctx_bigram_xn(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *src,
+    size_t                   src_size,
+    netc_bsw_t              *bsw,
+    uint32_t                 n_states,
+    uint32_t                *out_states)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (!bigram_tables || !unigram_tables || !src || !bsw || !out_states ||
+        src_size == 0)
+        return -1;
+    if (!xn_states_ok(n_states)) return -1;
+
+    uint32_t X[NETC_TANS_MAX_STATES];
+    const size_t mask = n_states - 1U;
+    for (uint32_t k = 0; k < n_states; k++) X[k] = NETC_TANS_TABLE_SIZE;
+
+    for (size_t i = src_size; i-- > 0; ) {
+        uint32_t bucket    = netc_bucket_of(buckets, (uint32_t)i);
+        uint8_t  prev_byte = (i > 0) ? src[i - 1] : 0x00u;
+        const netc_tans_table_t *tbl =
+            bigram_tables->t[bucket][netc_bigram_class(prev_byte, class_map)];
+        if (!tbl->valid) tbl = &unigram_tables[bucket];
+        if (tans_encode_step_xn(tbl, &X[i & mask], src[i], bsw,
+                                i + n_states < src_size) != 0)
+            return -1;
+    }
+
+    for (uint32_t k = 0; k < n_states; k++) out_states[k] = X[k];
+    return 0;
+}
+
+/* Decode one symbol with table tbl into *out, advancing state *X. */
+static NETC_INLINE void xn_decode_step(
+    const netc_tans_table_t *tbl, netc_bsr_t *bsr, uint32_t *X, uint8_t *out)
+{
+    const netc_tans_decode_entry_t *d = &tbl->decode[*X - NETC_TANS_TABLE_SIZE];
+    *out = d->symbol;
+    *X   = (uint32_t)d->next_state_base + netc_bsr_take(bsr, d->nb_bits);
+}
+
+/* Last symbol of a chain: the next state is never used and its bits were
+ * never written. */
+static NETC_INLINE void xn_decode_last(
+    const netc_tans_table_t *tbl, uint32_t X, uint8_t *out)
+{
+    *out = tbl->decode[X - NETC_TANS_TABLE_SIZE].symbol;
+}
+
+static NETC_INLINE int tans_decode_pctx_xn_impl(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    const uint32_t           N,
+    uint32_t                *X,
+    size_t                   i)             /* first offset, multiple of N */
+{
+
+    /* Whole groups that are not the last symbol of any chain */
+    for (; i + 2U * N <= dst_size; i += N) {
+        const netc_tans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (!tbl->valid) return -1;
+        for (uint32_t g = 0; g < N; g += 4U) {
+            netc_bsr_refill(bsr);
+            xn_decode_step(tbl, bsr, &X[g + 0], &dst[i + g + 0]);
+            xn_decode_step(tbl, bsr, &X[g + 1], &dst[i + g + 1]);
+            xn_decode_step(tbl, bsr, &X[g + 2], &dst[i + g + 2]);
+            xn_decode_step(tbl, bsr, &X[g + 3], &dst[i + g + 3]);
+            if (bsr->bits < 0) return -1;
+        }
+    }
+
+    /* Remaining < 2N bytes, one at a time */
+    for (; i < dst_size; i++) {
+        const netc_tans_table_t *tbl = &tables[netc_bucket_of(buckets, (uint32_t)i)];
+        if (!tbl->valid) return -1;
+        uint32_t *Xk = &X[i & (N - 1U)];
+        if (i + N < dst_size) {
+            netc_bsr_refill(bsr);
+            xn_decode_step(tbl, bsr, Xk, &dst[i]);
+            if (bsr->bits < 0) return -1;
+        } else {
+            xn_decode_last(tbl, *Xk, &dst[i]);
+        }
+    }
+    return 0;
+}
+
+/* Bigram variant: the table also depends on the previously decoded byte, so
+ * symbols within a group resolve their table serially, but the state chains
+ * and the bit refills are still batched. */
+static NETC_INLINE const netc_tans_table_t *xn_bigram_table(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
+    const uint8_t           *dst,
+    size_t                   i)
+{
+    uint32_t bucket = netc_bucket_of(buckets, (uint32_t)i);
+    uint8_t  prev   = (i > 0) ? dst[i - 1] : 0x00u;
+    const netc_tans_table_t *tbl =
+        bigram_tables->t[bucket][netc_bigram_class(prev, class_map)];
+    if (!tbl->valid) tbl = &unigram_tables[bucket];
+    return tbl->valid ? tbl : NULL;
+}
+
+static NETC_INLINE int tans_decode_pctx_bigram_xn_impl(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    const uint32_t           N,
+    uint32_t                *X)
+{
+    size_t i = 0;
+
+    for (; i + 2U * N <= dst_size; i += N) {
+        for (uint32_t g = 0; g < N; g += 4U) {
+            netc_bsr_refill(bsr);
+            for (uint32_t k = g; k < g + 4U; k++) {
+                const netc_tans_table_t *tbl = xn_bigram_table(
+                    bigram_tables, unigram_tables, class_map, buckets, dst, i + k);
+                if (tbl == NULL) return -1;
+                xn_decode_step(tbl, bsr, &X[k], &dst[i + k]);
+            }
+            if (bsr->bits < 0) return -1;
+        }
+    }
+
+    for (; i < dst_size; i++) {
+        const netc_tans_table_t *tbl = xn_bigram_table(
+            bigram_tables, unigram_tables, class_map, buckets, dst, i);
+        if (tbl == NULL) return -1;
+        uint32_t *Xk = &X[i & (N - 1U)];
+        if (i + N < dst_size) {
+            netc_bsr_refill(bsr);
+            xn_decode_step(tbl, bsr, Xk, &dst[i]);
+            if (bsr->bits < 0) return -1;
+        } else {
+            xn_decode_last(tbl, *Xk, &dst[i]);
+        }
+    }
+    return 0;
+}
+
+/* Copy and range-check the initial states. */
+static int xn_load_states(uint32_t *X, const uint32_t *initial_states,
+                          uint32_t n_states)
+{
+    for (uint32_t k = 0; k < n_states; k++) {
+        X[k] = initial_states[k];
+        if (X[k] < NETC_TANS_TABLE_SIZE || X[k] >= 2U * NETC_TANS_TABLE_SIZE)
+            return -1;
+    }
+    return 0;
+}
+
+int netc_tans_decode_pctx_xn(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                 n_states,
+    const uint32_t          *initial_states)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (!tables || !bsr || !dst || !initial_states || dst_size == 0) return -1;
+    if (!xn_states_ok(n_states) || bsr->bits < 0) return -1;
+
+    uint32_t X[NETC_TANS_MAX_STATES];
+    if (xn_load_states(X, initial_states, n_states) != 0) return -1;
+
+    if (n_states == 4U)
+        return tans_decode_pctx_xn_impl(tables, buckets, bsr, dst, dst_size, 4U, X, 0);
+    return tans_decode_pctx_xn_impl(tables, buckets, bsr, dst, dst_size, 8U, X, 0);
+}
+
+/* X8 with a vector kernel: each run of whole groups inside one bucket is a
+ * single kernel call; the reader is converted to a bit position for the call
+ * and back afterwards.  The kernel stops short near the start of the stream,
+ * and the scalar loop finishes from wherever it stopped. */
+static int tans_decode_pctx_x8_kernel(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                *X,
+    netc_tans_decode_x8_fn   kernel)
+{
+    size_t i = 0;
+    while (i + 16U <= dst_size) {
+        uint32_t b = netc_bucket_of(buckets, (uint32_t)i);
+        const netc_tans_table_t *tbl = &tables[b];
+        if (!tbl->valid) return -1;
+        size_t run  = (netc_bucket_start(buckets, b + 1U) - i) / 8U;
+        size_t left = (dst_size - 16U - i) / 8U + 1U;
+        size_t want = (run < left) ? run : left;
+
+        size_t pos = netc_bsr_tell(bsr);
+        size_t got = kernel((const uint32_t *)tbl->decode, bsr->start, &pos,
+                            X, dst + i, want);
+        i += 8U * got;
+        if (got > 0) netc_bsr_seek(bsr, pos);
+        if (got < want) break;
+    }
+    return tans_decode_pctx_xn_impl(tables, buckets, bsr, dst, dst_size, 8U, X, i);
+}
+
+int netc_tans_decode_pctx_xn_simd(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                 n_states,
+    const uint32_t          *initial_states,
+    const netc_simd_ops_t   *ops)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (n_states != 8U || ops == NULL || ops->tans_decode_x8 == NULL)
+        return netc_tans_decode_pctx_xn(tables, buckets, bsr, dst, dst_size,
+                                        n_states, initial_states);
+    if (!tables || !bsr || !dst || !initial_states || dst_size == 0) return -1;
+    if (bsr->bits < 0) return -1;
+
+    uint32_t X[NETC_TANS_MAX_STATES];
+    if (xn_load_states(X, initial_states, n_states) != 0) return -1;
+    return tans_decode_pctx_x8_kernel(tables, buckets, bsr, dst, dst_size, X,
+                                      ops->tans_decode_x8);
+}
+
+int netc_tans_decode_pctx_bigram_xn(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                 n_states,
+    const uint32_t          *initial_states)
+{
+    if (!buckets) buckets = &netc_bucket_map_default;
+    if (!bigram_tables || !unigram_tables || !bsr || !dst || !initial_states ||
+        dst_size == 0)
+        return -1;
+    if (!xn_states_ok(n_states) || bsr->bits < 0) return -1;
+
+    uint32_t X[NETC_TANS_MAX_STATES];
+    if (xn_load_states(X, initial_states, n_states) != 0) return -1;
+
+    if (n_states == 4U)
+        return tans_decode_pctx_bigram_xn_impl(bigram_tables, unigram_tables,
+                                               class_map, buckets, bsr, dst, dst_size,
+                                               4U, X);
+    return tans_decode_pctx_bigram_xn_impl(bigram_tables, unigram_tables,
+                                           class_map, buckets, bsr, dst, dst_size,
+                                           8U, X);
+}
+
 /* =========================================================================
  * netc_freq_rescale_12_to_10
  *
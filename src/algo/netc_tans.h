@@ -24,6 +24,7 @@
 
 #include "../util/netc_platform.h"
 #include "../util/netc_bitstream.h"
+#include "../simd/netc_simd.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -83,43 +84,46 @@ static NETC_INLINE uint32_t netc_bigram_class(uint8_t prev_byte,
 #define NETC_CTX_BODY       6U   /* offsets [64..95] — first body block */
 #define NETC_CTX_TAIL      10U   /* offsets [256..383] — first tail block */
 
-/* Map a byte offset to its 16-way context bucket index.
- * Bucket boundaries are chosen to give 8-byte resolution for small packets
- * and progressively coarser resolution for larger offsets.
+/* Position bucket layout: which of the NETC_CTX_COUNT tables codes the
+ * byte at each offset. Buckets are contiguous, ascending offset ranges whose
+ * boundaries are multiples of 8 (the interleaved PCTX decoders rely on every
+ * aligned group of 8 bytes sharing one table).
  *
  * Hot-path optimization: offsets 0-255 (all game packets ≤255B) are resolved
- * via a 256-byte LUT, eliminating up to 16 branch comparisons per call.
- * Offsets ≥256 fall through to a 5-if chain (rare for game packets). */
+ * via a 256-byte LUT; larger offsets walk end[] from the bucket of offset 255
+ * (at most a few steps, and rare for game packets).
+ *
+ * v5 dictionaries use netc_bucket_map_default: 8-byte resolution for small
+ * packets and progressively coarser resolution for larger offsets. Trained
+ * dictionaries may carry learned boundaries (NETC_DICT_FLAG_BUCKETS). */
+typedef struct netc_bucket_map {
+    uint8_t  lut[256];              /* bucket of offsets 0..255 */
+    uint32_t end[NETC_CTX_COUNT];   /* one past the last offset of bucket b;
+                                       strictly ascending, end[15] = 65536 */
+} netc_bucket_map_t;
+
+/* Static layout: [0..7] [8..15] [16..23] [24..31] [32..47] [48..63] [64..95]
+ * [96..127] [128..191] [192..255] [256..383] [384..511] [512..1023]
+ * [1024..4095] [4096..16383] [16384..65535] */
+extern const netc_bucket_map_t netc_bucket_map_default;
+
+/* Bucket of a byte offset under map m. */
+static NETC_INLINE uint32_t netc_bucket_of(const netc_bucket_map_t *m, uint32_t offset) {
+    if (NETC_LIKELY(offset < 256U)) return m->lut[offset];
+    uint32_t b = m->lut[255];
+    while (offset >= m->end[b]) b++;   /* end[15] = 65536 bounds the walk */
+    return b;
+}
+
+/* First offset of bucket b under map m. */
+static NETC_INLINE uint32_t netc_bucket_start(const netc_bucket_map_t *m, uint32_t b) {
+    if (b >= NETC_CTX_COUNT) return 65536U;
+    return (b == 0) ? 0U : m->end[b - 1U];
+}
+
+/* Bucket of a byte offset under the static layout. */
 static NETC_INLINE uint32_t netc_ctx_bucket(uint32_t offset) {
-    /* Pre-computed LUT for offsets 0-255 */
-    static const uint8_t bucket_lut[256] = {
-        /* [0..7]     bucket 0 */ 0,0,0,0,0,0,0,0,
-        /* [8..15]    bucket 1 */ 1,1,1,1,1,1,1,1,
-        /* [16..23]   bucket 2 */ 2,2,2,2,2,2,2,2,
-        /* [24..31]   bucket 3 */ 3,3,3,3,3,3,3,3,
-        /* [32..47]   bucket 4 */ 4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,
-        /* [48..63]   bucket 5 */ 5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,
-        /* [64..95]   bucket 6 */ 6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,
-                                  6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,
-        /* [96..127]  bucket 7 */ 7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
-                                  7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
-        /* [128..191] bucket 8 */ 8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
-                                  8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
-                                  8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
-                                  8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,
-        /* [192..255] bucket 9 */ 9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
-                                  9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
-                                  9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
-                                  9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9
-    };
-    if (NETC_LIKELY(offset < 256U)) return bucket_lut[offset];
-    /* Offsets ≥256 are uncommon in game packets (fallback chain) */
-    if (offset <  384U) return 10U;   /* [256..383]    */
-    if (offset <  512U) return 11U;   /* [384..511]    */
-    if (offset < 1024U) return 12U;   /* [512..1023]   */
-    if (offset < 4096U) return 13U;   /* [1024..4095]  */
-    if (offset <16384U) return 14U;   /* [4096..16383] */
-    return 15U;                        /* [16384..65535]*/
+    return netc_bucket_of(&netc_bucket_map_default, offset);
 }
 
 /* =========================================================================
@@ -178,23 +182,46 @@ typedef struct {
     uint8_t  _pad;
 } netc_tans_encode_entry_t;  /* 8 bytes — 8 entries per 64-byte cache line */
 
+/* =========================================================================
+ * Symbol cost model
+ *
+ * cost[s] = -log2(freq[s] / TABLE_SIZE) in Q8 fixed point (1/256 bit).
+ * An ANS coder spends this many bits per symbol on average, so summing
+ * cost[] over a packet predicts the bitstream size without encoding it.
+ * Symbols absent from the table get NETC_TANS_COST_ABSENT so a candidate
+ * that cannot encode the packet never wins the estimate.
+ * ========================================================================= */
+
+#define NETC_TANS_COST_SHIFT   8U
+#define NETC_TANS_COST_ABSENT  (32U << NETC_TANS_COST_SHIFT)
+#define NETC_TANS_COST_INVALID UINT32_MAX  /* estimator: table not built */
+
 /* =========================================================================
  * Per-bucket tANS table
  *
  * encode_state[TABLE_SIZE]: maps cumul[s]+j → complete next state X.
  *   Stores TABLE_SIZE + slot directly so the hot path assigns X without add.
  *   (the k-th occurrence of symbol s is at encode_state[cumul[s]+k])
+ * cost[SYMBOLS]: per-symbol Q8 bit cost, filled by netc_tans_build.
  * ========================================================================= */
 
 typedef struct {
     netc_tans_decode_entry_t decode[NETC_TANS_TABLE_SIZE]; /* 16 KB */
     uint16_t                 encode_state[NETC_TANS_TABLE_SIZE]; /* 8 KB — stores TABLE_SIZE+slot */
     netc_tans_encode_entry_t encode[NETC_TANS_SYMBOLS];    /* 2 KB (8B per entry) */
+    uint16_t                 cost[NETC_TANS_SYMBOLS];      /* 512 B — Q8 bits per symbol */
     netc_freq_table_t        freq;                          /* 512 B — kept for dict serialization */
     uint8_t                  valid;  /* 1 if tables are built, 0 otherwise */
     uint8_t                  _pad[3];
 } netc_tans_table_t;
 
+/* Bigram table set: one table pointer per (bucket, class).  The indirection
+ * lets an adaptive context retarget single (bucket, class) pairs without
+ * copying the whole 16×8 block (~3.3 MB). */
+typedef struct {
+    const netc_tans_table_t *t[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
+} netc_bigram_set_t;
+
 /* =========================================================================
  * Per-bucket 10-bit tANS table (small-packet optimization)
  *
@@ -222,6 +249,53 @@ typedef struct {
 
 int netc_tans_build(netc_tans_table_t *tbl, const netc_freq_table_t *freq);
 
+/* =========================================================================
+ * tANS cost estimators
+ *
+ * Predict the bitstream size (in Q8 bits, excluding the final state) that
+ * the matching encoder would produce, using only the per-table cost[] LUT.
+ * One load and one add per byte — several times cheaper than encoding, so
+ * the compressor can rank candidates and encode only the winner.  The
+ * prediction ignores the spread loss of the finite table and runs 1-3% low;
+ * the bias is common to all tables, so rankings are unaffected.
+ *
+ * netc_tans_log2_q8(v): log2(v) in Q8 for v >= 1 (integer only).
+ * netc_tans_cost_bytes(c): bitstream bytes for a Q8 estimate, including
+ *   the sentinel bit written by netc_bsw_flush.
+ *
+ * The estimators return NETC_TANS_COST_INVALID when a required table is not
+ * built (the matching encoder would fail outright).
+ * ========================================================================= */
+
+uint32_t netc_tans_log2_q8(uint32_t v);
+
+static NETC_INLINE size_t netc_tans_cost_bytes(uint32_t cost_q8) {
+    uint32_t bits = (cost_q8 + (1U << NETC_TANS_COST_SHIFT) - 1U) >> NETC_TANS_COST_SHIFT;
+    return ((size_t)bits + 1U + 7U) / 8U;
+}
+
+uint32_t netc_tans_cost(
+    const netc_tans_table_t *tbl,
+    const uint8_t           *src,
+    size_t                   src_size
+);
+
+uint32_t netc_tans_cost_pctx(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    const uint8_t           *src,
+    size_t                   src_size
+);
+
+uint32_t netc_tans_cost_pctx_bigram(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    const uint8_t           *src,
+    size_t                   src_size
+);
+
 /* =========================================================================
  * tANS encoder
  *
@@ -292,7 +366,7 @@ int netc_tans_decode_x2(
  * Per-position context-adaptive tANS encoder (PCTX)
  *
  * Encodes src[0..src_size) in a SINGLE ANS stream, switching the
- * probability table per byte offset: tables[netc_ctx_bucket(offset)].
+ * probability table per byte offset: tables[netc_bucket_of(buckets, offset)].
  * This gives per-position entropy specialization with ZERO descriptor
  * overhead compared to MREG's per-region streams.
  *
@@ -301,6 +375,7 @@ int netc_tans_decode_x2(
 
 uint32_t netc_tans_encode_pctx(
     const netc_tans_table_t *tables,   /* array of NETC_CTX_COUNT tables */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
     const uint8_t           *src,
     size_t                   src_size,
     netc_bsw_t              *bsw,
@@ -316,6 +391,7 @@ uint32_t netc_tans_encode_pctx(
 
 int netc_tans_decode_pctx(
     const netc_tans_table_t *tables,   /* array of NETC_CTX_COUNT tables */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
     netc_bsr_t              *bsr,
     uint8_t                 *dst,
     size_t                   dst_size,
@@ -327,7 +403,7 @@ int netc_tans_decode_pctx(
  *
  * Encodes src[0..src_size) in a SINGLE ANS stream, switching the
  * probability table per byte using BOTH position bucket AND bigram class:
- *   tbl = bigram_tables[netc_ctx_bucket(i)][netc_bigram_class(prev_byte, class_map)]
+ *   tbl = bigram_tables->t[netc_bucket_of(buckets, i)][netc_bigram_class(prev_byte, class_map)]
  *
  * Falls back to unigram tables[bucket] if bigram table is invalid.
  * prev_byte at position 0 is implicitly 0x00 (packet start).
@@ -336,9 +412,10 @@ int netc_tans_decode_pctx(
  * ========================================================================= */
 
 uint32_t netc_tans_encode_pctx_bigram(
-    const netc_tans_table_t bigram_tables[][NETC_BIGRAM_CTX_COUNT],
+    const netc_bigram_set_t *bigram_tables,
     const netc_tans_table_t *unigram_tables,  /* fallback: array of NETC_CTX_COUNT */
     const uint8_t           *class_map,        /* 256-byte bigram class map (may be NULL → v4 fallback) */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
     const uint8_t           *src,
     size_t                   src_size,
     netc_bsw_t              *bsw,
@@ -355,15 +432,173 @@ uint32_t netc_tans_encode_pctx_bigram(
  * ========================================================================= */
 
 int netc_tans_decode_pctx_bigram(
-    const netc_tans_table_t bigram_tables[][NETC_BIGRAM_CTX_COUNT],
+    const netc_bigram_set_t *bigram_tables,
     const netc_tans_table_t *unigram_tables,  /* fallback: array of NETC_CTX_COUNT */
     const uint8_t           *class_map,        /* 256-byte bigram class map (may be NULL → v4 fallback) */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
     netc_bsr_t              *bsr,
     uint8_t                 *dst,
     size_t                   dst_size,
     uint32_t                 initial_state
 );
 
+/* =========================================================================
+ * Per-symbol table tANS (entropy-coded LZ77X)
+ *
+ * One ANS stream whose table is chosen per symbol: src[i] is coded with
+ * tables[role[i]].  The decoder has no role array; it derives each table
+ * from the symbols decoded before it and steps with netc_tans_decode_step.
+ *
+ * Returns final state (initial state for decoder), or 0 on error (buffer
+ * overflow, invalid table, or a symbol its table does not hold).
+ * ========================================================================= */
+
+uint32_t netc_tans_encode_roles(
+    const netc_tans_table_t * const *tables,  /* indexed by role */
+    const uint8_t           *role,
+    const uint8_t           *src,
+    size_t                   src_size,
+    netc_bsw_t              *bsw,
+    uint32_t                 initial_state
+);
+
+/** Decode one symbol at state *X with tbl and advance *X.
+ *  Returns 0, or -1 if the bitstream is exhausted. */
+static NETC_INLINE int netc_tans_decode_step(const netc_tans_table_t *tbl,
+                                             netc_bsr_t *bsr, uint32_t *X,
+                                             uint8_t *sym) {
+    const netc_tans_decode_entry_t *d = &tbl->decode[*X - NETC_TANS_TABLE_SIZE];
+    uint32_t bits_val = 0;
+    if (d->nb_bits > 0 && netc_bsr_read(bsr, d->nb_bits, &bits_val) != 0) return -1;
+    *sym = d->symbol;
+    *X   = (uint32_t)d->next_state_base + bits_val;
+    return 0;
+}
+
+/* =========================================================================
+ * Interleaved PCTX tANS (X4 / X8)
+ *
+ * Same tables and bitstream as PCTX, but n_states (4 or 8) independent ANS
+ * states share the stream: state k codes every byte at offset i with
+ * (i % n_states) == k.  The decoder advances n_states independent chains
+ * per step and refills the bit reader once per 4 symbols, instead of one
+ * serial state chain with a refill check per symbol.
+ *
+ * Bucket boundaries are multiples of 8, so every aligned group of n_states
+ * bytes shares one table — the decoder resolves it once per group.
+ *
+ * Wire format: [packed states][bitstream].  States are stored as 12-bit
+ * offsets from TABLE_SIZE, two per 3 bytes (6 bytes for X4, 12 for X8), and
+ * the first step of every chain emits no bits, so X4 costs about 2 bytes
+ * more than a compact single-state PCTX payload and X8 about 8.  The
+ * compressor therefore interleaves only wide packets, see
+ * netc_tans_pctx_states().
+ *
+ * Encoders return 0 and write n_states final states (decoder initial states,
+ * state k first) to out_states; -1 on error.  Decoders return 0 on success,
+ * -1 on corrupt input.
+ * ========================================================================= */
+
+#define NETC_TANS_MAX_STATES 8U
+#define NETC_TANS_X4_MIN     1024U  /* src_size at which PCTX uses X4 */
+#define NETC_TANS_X8_MIN     4096U  /* src_size at which PCTX uses X8 */
+
+/** Number of interleaved PCTX states the compressor uses for src_size. */
+static NETC_INLINE uint32_t netc_tans_pctx_states(size_t src_size) {
+    if (src_size >= NETC_TANS_X8_MIN) return 8U;
+    if (src_size >= NETC_TANS_X4_MIN) return 4U;
+    return 1U;
+}
+
+/** Bytes of packed initial states for n_states (4 or 8). */
+#define NETC_TANS_XN_STATE_BYTES(n) ((size_t)(n) * 3U / 2U)
+
+static NETC_INLINE void netc_tans_xn_states_write(uint8_t *dst,
+                                                  const uint32_t *states,
+                                                  uint32_t n_states) {
+    for (uint32_t k = 0; k < n_states; k += 2U, dst += 3) {
+        uint32_t a = states[k]      - NETC_TANS_TABLE_SIZE;
+        uint32_t b = states[k + 1U] - NETC_TANS_TABLE_SIZE;
+        dst[0] = (uint8_t)a;
+        dst[1] = (uint8_t)((a >> 8) | (b << 4));
+        dst[2] = (uint8_t)(b >> 4);
+    }
+}
+
+/* Unpacked states are always within [TABLE_SIZE, 2*TABLE_SIZE). */
+static NETC_INLINE void netc_tans_xn_states_read(const uint8_t *src,
+                                                 uint32_t *states,
+                                                 uint32_t n_states) {
+    for (uint32_t k = 0; k < n_states; k += 2U, src += 3) {
+        states[k]      = NETC_TANS_TABLE_SIZE +
+                         ((uint32_t)src[0] | (((uint32_t)src[1] & 0x0Fu) << 8));
+        states[k + 1U] = NETC_TANS_TABLE_SIZE +
+                         (((uint32_t)src[1] >> 4) | ((uint32_t)src[2] << 4));
+    }
+}
+
+int netc_tans_encode_pctx_xn(
+    const netc_tans_table_t *tables,   /* array of NETC_CTX_COUNT tables */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    const uint8_t           *src,
+    size_t                   src_size,
+    netc_bsw_t              *bsw,
+    uint32_t                 n_states, /* 4 or 8 */
+    uint32_t                *out_states
+);
+
+int netc_tans_decode_pctx_xn(
+    const netc_tans_table_t *tables,   /* array of NETC_CTX_COUNT tables */
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                 n_states, /* 4 or 8 */
+    const uint32_t          *initial_states
+);
+
+/**
+ * netc_tans_decode_pctx_xn with a SIMD dispatch table: for n_states == 8 the
+ * runs of whole groups that share a context bucket go through
+ * ops->tans_decode_x8 when the selected level provides one; everything else
+ * (X4, the tail, levels without a kernel, ops == NULL) uses the scalar path.
+ * Output is identical to netc_tans_decode_pctx_xn.
+ */
+int netc_tans_decode_pctx_xn_simd(
+    const netc_tans_table_t *tables,
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                 n_states,
+    const uint32_t          *initial_states,
+    const netc_simd_ops_t   *ops
+);
+
+int netc_tans_encode_pctx_bigram_xn(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    const uint8_t           *src,
+    size_t                   src_size,
+    netc_bsw_t              *bsw,
+    uint32_t                 n_states,
+    uint32_t                *out_states
+);
+
+int netc_tans_decode_pctx_bigram_xn(
+    const netc_bigram_set_t *bigram_tables,
+    const netc_tans_table_t *unigram_tables,
+    const uint8_t           *class_map,
+    const netc_bucket_map_t *buckets,  /* position buckets (NULL = static layout) */
+    netc_bsr_t              *bsr,
+    uint8_t                 *dst,
+    size_t                   dst_size,
+    uint32_t                 n_states,
+    const uint32_t          *initial_states
+);
+
 /* =========================================================================
  * 10-bit tANS table builder
  *
@@ -41,32 +41,66 @@
  * Expected ratio regression: <1% (PCTX dominates for structured pre-filtered data). */
 #define NETC_INTERNAL_SKIP_SR (1U << 30)
 
+/* Internal-only flag: skip the bigram-PCTX trial in try_tans_compress().
+ * Set when the compression level's trial budget excludes NETC_TRIAL_BIGRAM;
+ * unigram PCTX is used directly.  Single-region bigram table selection is
+ * unaffected (that is governed by NETC_CFG_FLAG_BIGRAM alone). */
+#define NETC_INTERNAL_NO_BIGRAM_PCTX (1U << 29)
+
+/* Internal-only flag: encode the runner-up of every cost-model ranking too
+ * and keep the smaller actual output (NETC_TRIAL_VERIFY2). */
+#define NETC_INTERNAL_VERIFY2 (1U << 28)
+
+/* Internal-only flag: let static rANS compete with the tANS winner on wide
+ * packets coded with the dictionary's own tables (NETC_TRIAL_RANS). */
+#define NETC_INTERNAL_RANS (1U << 27)
+
 /* =========================================================================
- * Internal: FNV-1a hash of 3 bytes folded to 4096 (for ring_ht)
+ * Internal: rotate prev2/prev packet history for delta prediction
  * ========================================================================= */
-NETC_MAYBE_UNUSED static NETC_INLINE uint32_t ring_ht_hash3(const uint8_t *p)
+static void compress_update_prev(netc_ctx_t *ctx,
+                                  const void *src, size_t src_size)
 {
-    uint32_t h = 2166136261u;
-    h ^= p[0]; h *= 16777619u;
-    h ^= p[1]; h *= 16777619u;
-    h ^= p[2]; h *= 16777619u;
-    return h & 4095u; /* ring_ht_size - 1 */
+    /* Rotate: prev2 = prev, prev = current */
+    netc_ctx_push_history(ctx, src, src_size);
 }
 
 /* =========================================================================
- * Internal: rotate prev2/prev packet history for delta prediction
+ * Internal: link newly appended ring bytes into the LZ77X match index
+ *
+ * Called after the ring copy.  The two positions before the old end only
+ * now have all 3 bytes; positions the window can no longer reach are
+ * skipped.
  * ========================================================================= */
-static void compress_update_prev(netc_ctx_t *ctx,
-                                  const void *src, size_t src_size)
+static void ctx_lzx_insert(netc_ctx_t *ctx, size_t len)
 {
-    if (ctx->prev_pkt != NULL) {
-        /* Rotate: prev2 = prev, prev = current (before overwriting prev) */
-        if (ctx->prev2_pkt != NULL) {
-            memcpy(ctx->prev2_pkt, ctx->prev_pkt, ctx->prev_pkt_size);
-            ctx->prev2_pkt_size = ctx->prev_pkt_size;
-        }
-        memcpy(ctx->prev_pkt, src, src_size);
-        ctx->prev_pkt_size = src_size;
+    netc_lzx_index_t *x = &ctx->lzx;
+    uint32_t rs  = ctx->ring_size;
+    uint32_t end = x->end + (uint32_t)len;   /* stream offset of ring_pos */
+
+    /* q = distance back from the new end; positions q = back .. 3 */
+    size_t back = len + ((x->end < 2u) ? x->end : 2u);
+    uint32_t win = (rs < x->mask) ? rs : x->mask;
+    if (back > win) back = win;
+    x->end = end;
+    if (back < 3u) return;
+
+    uint32_t idx = ctx->ring_pos + rs - (uint32_t)back;
+    if (idx >= rs) idx -= rs;
+    uint8_t b0 = ctx->ring[idx];
+    if (++idx == rs) idx = 0;
+    uint8_t b1 = ctx->ring[idx];
+    if (++idx == rs) idx = 0;
+
+    for (uint32_t p = end - (uint32_t)back; p != end - 2u; p++) {
+        uint8_t  b2 = ctx->ring[idx];
+        if (++idx == rs) idx = 0;
+        uint32_t h  = netc_lzx_hash(b0, b1, b2);
+        uint32_t d  = p - (x->head[h] - 1u);
+        x->prev[p & x->mask] = (x->head[h] != 0 && d <= x->mask) ? (uint16_t)d : 0;
+        x->head[h] = p + 1u;
+        b0 = b1;
+        b1 = b2;
     }
 }
 
@@ -79,6 +113,7 @@ static void ctx_ring_append(netc_ctx_t *ctx,
     if (ctx->ring == NULL || ctx->ring_size == 0 || len == 0) return;
     uint32_t rs  = ctx->ring_size;
     uint32_t pos = ctx->ring_pos;
+    size_t   appended = len;
 
     if (len >= rs) {
         data += len - rs;
@@ -95,6 +130,7 @@ static void ctx_ring_append(netc_ctx_t *ctx,
     }
 
     ctx->ring_pos = (uint32_t)((pos + len) % rs);
+    if (ctx->lzx.head != NULL) ctx_lzx_insert(ctx, appended);
 }
 
 /* =========================================================================
@@ -142,20 +178,6 @@ static netc_result_t emit_passthrough(
     return NETC_OK;
 }
 
-/* =========================================================================
- * Internal: bucket offset boundaries
- *
- * Given a bucket index b, return the first byte offset that falls in it.
- * This mirrors the inverse of netc_ctx_bucket().
- * ========================================================================= */
-NETC_MAYBE_UNUSED static uint32_t bucket_start_offset(uint32_t b) {
-    static const uint32_t starts[NETC_CTX_COUNT] = {
-           0,    8,   16,   24,   32,   48,   64,   96,
-         128,  192,  256,  384,  512, 1024, 4096, 16384
-    };
-    return (b < NETC_CTX_COUNT) ? starts[b] : 65536U;
-}
-
 /* =========================================================================
  * Internal: RLE detection and encoding
  *
@@ -305,6 +327,12 @@ static size_t lz77_encode(const uint8_t *src, size_t src_size,
  * Returns bytes written to dst_lz, or (size_t)-1 if lz >= src_size.
  * ========================================================================= */
 #define LZ77X_MAX_LONG_OFFSET 65536u
+#define LZ77X_MIN_LONG        5u   /* a long ref costs 3 bytes, +1 if it splits a literal run */
+/* After LZ77X_MISS_DENSE positions without a ring match, walk the chains at
+ * every (LZ77X_MISS_STEP + 1)th position only: on data the ring does not
+ * hold, every bucket is full of unrelated positions */
+#define LZ77X_MISS_DENSE      16u
+#define LZ77X_MISS_STEP       7u
 #define LZ77X_HT_SIZE         4096u
 #define LZ77X_HT_MASK         (LZ77X_HT_SIZE - 1u)
 
@@ -317,60 +345,65 @@ static NETC_INLINE uint32_t lz77x_hash3(const uint8_t *p) {
     return h & LZ77X_HT_MASK;
 }
 
+/* Length of the match between src[0..max_m) and the ring from rstart,
+ * reading the ring circularly as the decoder does */
+static NETC_INLINE size_t lz77x_ring_match(const uint8_t *ring, uint32_t ring_size,
+                                           uint32_t rstart,
+                                           const uint8_t *src, size_t max_m)
+{
+    size_t m = 0;
+    if ((size_t)rstart + max_m <= ring_size) {
+        const uint8_t *r = ring + rstart;
+        while (m < max_m && r[m] == src[m]) m++;
+    } else {
+        uint32_t k = rstart;
+        while (m < max_m && ring[k] == src[m]) {
+            m++;
+            if (++k == ring_size) k = 0;
+        }
+    }
+    return m;
+}
+
 /* =========================================================================
- * Internal: cross-packet LZ77 encode with on-demand ring hash table
+ * Internal: cross-packet LZ77 encode over the ring's match index
  *
- * Builds a local ring hash table from the most recent bytes in the ring
- * buffer (up to prev_pkt_size bytes before ring_pos). This avoids O(N)
- * per-packet hash maintenance overhead — cost is only paid when LZ77X
- * is actually attempted.
+ * Long back-refs come from the context's hash chains (netc_lzx_index_t),
+ * which cover every byte still in the ring, not just the last packet; up
+ * to `depth` candidates are compared per position and the longest wins.
+ * Within-packet matches use a local table:
+ *   src_ht[4096]: local stack — maps hash → src position (within-packet)
  *
- * Uses two hash tables:
- *   ring_ht[4096]: local stack — maps hash → absolute ring pos
- *   src_ht[4096]:  local stack — maps hash → src position (within-packet)
+ * Without an index (lzx == NULL or not yet allocated) only within-packet
+ * short refs are produced.
  *
  * Returns bytes written to dst_lz, or (size_t)-1 if lz >= src_size.
  * ========================================================================= */
 static size_t lz77x_encode(
     const uint8_t *src,         size_t src_size,
     const uint8_t *ring,        uint32_t ring_size, uint32_t ring_pos,
-    uint32_t       prev_pkt_size,  /* how many recent ring bytes to hash */
+    const netc_lzx_index_t *lzx, uint32_t depth,
     uint8_t       *dst_lz,      size_t lz_cap)
 {
     if (ring == NULL || ring_size == 0) {
         return lz77_encode(src, src_size, dst_lz, lz_cap);
     }
+    if (lzx != NULL && lzx->head == NULL) lzx = NULL;
 
-    /* Build local ring hash table from the most recent bytes in the ring.
-     * Scan up to prev_pkt_size bytes (the last packet appended to the ring),
-     * capped at ring_size - 3 to avoid scanning the entire 64KB ring. */
-    int32_t ring_ht[LZ77X_HT_SIZE];
-    for (size_t k = 0; k < LZ77X_HT_SIZE; k++) ring_ht[k] = INT32_MIN;
-
-    {
-        uint32_t scan_len = prev_pkt_size;
-        if (scan_len > ring_size - 2) scan_len = ring_size - 2;
-        if (scan_len < 3) scan_len = 0;
-        /* Scan the most recent scan_len bytes ending at ring_pos */
-        uint32_t scan_start = (ring_pos + ring_size - scan_len) % ring_size;
-        for (uint32_t j = 0; j + 2 < scan_len; j++) {
-            uint32_t abs_pos = (scan_start + j) % ring_size;
-            uint8_t b0 = ring[abs_pos];
-            uint8_t b1 = ring[(abs_pos + 1) % ring_size];
-            uint8_t b2 = ring[(abs_pos + 2) % ring_size];
-            uint8_t tmp[3] = {b0, b1, b2};
-            uint32_t h = lz77x_hash3(tmp);
-            ring_ht[h] = (int32_t)abs_pos;
-        }
-    }
+    /* Farthest usable offset: inside the ring, the token's 16-bit range and
+     * the part of the window whose prev[] slots are still current */
+    uint32_t max_off = ring_size;
+    if (max_off > LZ77X_MAX_LONG_OFFSET) max_off = LZ77X_MAX_LONG_OFFSET;
+    if (lzx != NULL && max_off > lzx->mask) max_off = lzx->mask;
 
     /* Local (within-packet) hash table: hash → src position */
     int32_t src_ht[LZ77X_HT_SIZE];
     for (size_t k = 0; k < LZ77X_HT_SIZE; k++) src_ht[k] = INT32_MIN;
 
-    size_t out       = 0;
-    size_t i         = 0;
-    size_t lit_start = 0;
+    size_t   out       = 0;
+    size_t   i         = 0;
+    size_t   lit_start = 0;
+    uint32_t ring_miss = 0;   /* positions since the last ring match */
 
 #define LZ77X_FLUSH_LITS(end) do { \
     size_t _ls = lit_start, _le = (end); \
@@ -386,23 +419,21 @@ static size_t lz77x_encode(
     while (i + 3 <= src_size) {
         uint32_t h = lz77x_hash3(src + i);
 
-        /* Check both hash tables — prefer within-packet (shorter ref token) */
-        int32_t  ring_entry = ring_ht[h];
-        int32_t  src_entry  = src_ht[h];
-
         /* Update local hash table with current position */
+        int32_t src_entry = src_ht[h];
         src_ht[h] = (int32_t)i;
 
         size_t best_len = 0;
         size_t best_off = 0;
         int    is_long  = 0;
+        size_t max_m    = src_size - i;
+        if (max_m > 66) max_m = 66;
 
-        /* 1) Within-packet candidate (short back-ref, offset 1-256) */
+        /* 1) Within-packet candidate (short back-ref, offset 1-256):
+         * preferred, its token is a byte shorter */
         if (src_entry != INT32_MIN) {
             size_t src_off = i - (size_t)src_entry;
             if (src_off >= 1 && src_off <= 256) {
-                size_t max_m = src_size - i;
-                if (max_m > 66) max_m = 66;
                 size_t mlen = 0;
                 const uint8_t *ref = src + src_entry;
                 while (mlen < max_m && ref[mlen] == src[i + mlen]) mlen++;
@@ -410,28 +441,46 @@ static size_t lz77x_encode(
             }
         }
 
-        /* 2) Ring-buffer candidate (long back-ref): only if better than within-packet */
-        if (ring_entry != INT32_MIN) {
-            /* Convert absolute ring position to offset from current ring_pos */
-            uint32_t abs_pos  = (uint32_t)ring_entry;
-            uint32_t ring_off = (ring_pos + ring_size - abs_pos) % ring_size;
-            if (ring_off >= 1 && ring_off <= LZ77X_MAX_LONG_OFFSET) {
-                size_t max_m = src_size - i;
-                if (max_m > 66) max_m = 66;
-                size_t mlen = 0;
-                uint32_t rstart = (ring_pos + ring_size - ring_off) % ring_size;
-                while (mlen < max_m) {
-                    if (ring[(rstart + mlen) % ring_size] != src[i + mlen]) break;
-                    mlen++;
-                }
-                /* Accept ring match if it's longer than within-packet match, OR
-                 * within-packet match wasn't found. */
-                if (mlen >= 3 && mlen > best_len) {
-                    best_len = mlen; best_off = ring_off; is_long = 1;
+        /* 2) Ring candidates (long back-ref): walk the hash chain, newest
+         * first.  A long token is 3 bytes, so a ring match must save more
+         * than the best so far: 5+ bytes alone, 2 more than a short ref. */
+        size_t need = (best_len == 0) ? LZ77X_MIN_LONG : best_len + 2u;
+        if (lzx != NULL && need <= max_m &&
+            (ring_miss < LZ77X_MISS_DENSE || (ring_miss & LZ77X_MISS_STEP) == 0)) {
+            uint32_t cand = lzx->head[netc_lzx_hash(src[i], src[i + 1], src[i + 2])];
+            uint32_t off  = lzx->end - (cand - 1u);
+            for (uint32_t n = depth;
+                 cand != 0 && n > 0 && off != 0 && off <= max_off; n--) {
+                uint32_t rstart = ring_pos + ring_size - off;
+                if (rstart >= ring_size) rstart -= ring_size;
+                size_t mlen = lz77x_ring_match(ring, ring_size, rstart, src + i, max_m);
+                if (mlen >= need) {
+                    best_len = mlen; best_off = off; is_long = 1;
+                    if (mlen == max_m) break;
+                    need = mlen + 1u;
                 }
+                uint32_t d = lzx->prev[(lzx->end - off) & lzx->mask];
+                if (d == 0) break;
+                off += d;
             }
         }
 
+        /* Lazy step: a ring match that a short ref one byte later beats
+         * (a run of one byte starts this way) is emitted as a literal */
+        if (is_long && best_len < max_m && i + 4 <= src_size) {
+            int32_t e1 = src_ht[lz77x_hash3(src + i + 1)];
+            if (e1 != INT32_MIN && i + 1 - (size_t)e1 <= 256) {
+                size_t max_1 = src_size - i - 1;
+                if (max_1 > 66) max_1 = 66;
+                size_t len1 = 0;
+                const uint8_t *ref = src + e1;
+                while (len1 < max_1 && ref[len1] == src[i + 1 + len1]) len1++;
+                if (len1 > best_len + 1) best_len = 0;
+            }
+        }
+
+        ring_miss = is_long ? 0 : ring_miss + 1u;
+
         if (best_len >= 3) {
             LZ77X_FLUSH_LITS(i);
             if (out >= lz_cap) return (size_t)-1;
@@ -464,6 +513,144 @@ static size_t lz77x_encode(
     return (out < src_size) ? out : (size_t)-1;
 }
 
+/* =========================================================================
+ * Internal: LZ77X pre-check — does the ring hold long runs of this packet?
+ *
+ * Probes 4 spots spread over the packet through the match index, walking
+ * up to `depth` candidates each, and counts those with 8 or more matching
+ * bytes anywhere in the ring (not just the previous packet).
+ * ========================================================================= */
+#define LZ77X_PROBES     4u
+#define LZ77X_PROBE_LEN  8u
+
+static unsigned lz77x_probe(const netc_ctx_t *ctx,
+                            const uint8_t *src, size_t src_size, uint32_t depth)
+{
+    const netc_lzx_index_t *x = &ctx->lzx;
+    if (x->head == NULL || src_size < LZ77X_PROBES * LZ77X_PROBE_LEN) return 0;
+    uint32_t rs      = ctx->ring_size;
+    uint32_t max_off = (rs < x->mask) ? rs : x->mask;
+    unsigned hits    = 0;
+    for (unsigned k = 0; k < LZ77X_PROBES; k++) {
+        const uint8_t *p = src + (src_size - LZ77X_PROBE_LEN) * k / (LZ77X_PROBES - 1u);
+        uint32_t cand = x->head[netc_lzx_hash(p[0], p[1], p[2])];
+        uint32_t off  = x->end - (cand - 1u);
+        for (uint32_t n = depth;
+             cand != 0 && n > 0 && off != 0 && off <= max_off; n--) {
+            uint32_t rstart = ctx->ring_pos + rs - off;
+            if (rstart >= rs) rstart -= rs;
+            if (lz77x_ring_match(ctx->ring, rs, rstart, p, LZ77X_PROBE_LEN) == LZ77X_PROBE_LEN) {
+                hits++;
+                break;
+            }
+            uint32_t d = x->prev[(x->end - off) & x->mask];
+            if (d == 0) break;
+            off += d;
+        }
+    }
+    return hits;
+}
+
+/* =========================================================================
+ * netc_lzx_parse — LZ77X tokens for the dictionary trainer
+ * ========================================================================= */
+size_t netc_lzx_parse(netc_ctx_t *ctx, const uint8_t *src, size_t src_size,
+                      uint8_t *dst, size_t cap)
+{
+    if (ctx->ring == NULL || ctx->ring_size == 0) return (size_t)-1;
+    size_t n = lz77x_encode(src, src_size, ctx->ring, ctx->ring_size, ctx->ring_pos,
+                            &ctx->lzx, ctx->plan.lzx_depth, dst, cap);
+    ctx_ring_append(ctx, src, src_size);
+    return n;
+}
+
+/* =========================================================================
+ * Internal: entropy-coded LZ77X (NETC_ALG_LZ77X | NETC_LZ77X_TANS, AD-031)
+ *
+ * Codes an lz77x_encode token stream in one tANS stream, each byte with
+ * the table of its role: headers with NETC_LZX_TBL_CMD, ref offsets with
+ * the NEAR / FAR_LO / FAR_HI tables, and a literal as the PCTX coder would
+ * code the byte at its output position — LZP-filtered when the context has
+ * an LZP table, under tables[bucket].
+ *
+ * Payload: [2B initial state LE][bitstream].  role is tok_len bytes of
+ * scratch.  The literals of tok are filtered in place and restored before
+ * returning.  Returns payload bytes, or (size_t)-1 if they would exceed cap.
+ * ========================================================================= */
+
+/* XOR every literal of a token stream with its LZP prediction (its own
+ * inverse).  Predictions come from src, the packet the tokens encode. */
+static void lz77x_lits_xor(uint8_t *tok, size_t tok_len, const uint8_t *src,
+                           const netc_lzp_table_t   *lzp_table,
+                           const netc_lzp_overlay_t *lzp_ovl, int lzp_order2)
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < tok_len; ) {
+        uint8_t t = tok[i++];
+        if (t & 0x80u) {
+            i   += (t & 0x40u) ? 2u : 1u;
+            pos += (size_t)(t & 0x3Fu) + 3u;
+            continue;
+        }
+        for (size_t end = i + (size_t)(t & 0x7Fu) + 1u; i < end; i++, pos++) {
+            uint8_t prev  = (pos > 0) ? src[pos - 1] : 0x00u;
+            uint8_t prev2 = (pos > 1) ? src[pos - 2] : 0x00u;
+            tok[i] ^= netc_lzp_guess(lzp_table, lzp_ovl, lzp_order2, prev2, prev,
+                                     (uint32_t)pos);
+        }
+    }
+}
+
+static size_t lz77x_tans_encode(
+    const netc_dict_t        *dict,
+    const netc_tans_table_t  *tables,
+    const netc_lzp_table_t   *lzp_table,
+    const netc_lzp_overlay_t *lzp_ovl,
+    int                       lzp_order2,
+    const uint8_t            *src,
+    uint8_t                  *tok,  size_t tok_len,
+    uint8_t                  *role,
+    uint8_t                  *dst,  size_t cap)
+{
+    if (tok_len == 0 || cap < 3u) return (size_t)-1;
+
+    const netc_tans_table_t *tbl[NETC_CTX_COUNT + NETC_LZX_TABLES];
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) tbl[b] = &tables[b];
+    for (uint32_t k = 0; k < NETC_LZX_TABLES; k++)
+        tbl[NETC_CTX_COUNT + k] = &dict->lzx_tables[k];
+
+    size_t pos = 0;
+    for (size_t i = 0; i < tok_len; ) {
+        uint8_t t = tok[i];
+        role[i++] = (uint8_t)(NETC_CTX_COUNT + NETC_LZX_TBL_CMD);
+        if (!(t & 0x80u)) {
+            for (size_t end = i + (size_t)(t & 0x7Fu) + 1u; i < end; i++, pos++)
+                role[i] = (uint8_t)netc_bucket_of(&dict->buckets, (uint32_t)pos);
+        } else if (!(t & 0x40u)) {
+            role[i++] = (uint8_t)(NETC_CTX_COUNT + NETC_LZX_TBL_NEAR);
+            pos += (size_t)(t & 0x3Fu) + 3u;
+        } else {
+            role[i++] = (uint8_t)(NETC_CTX_COUNT + NETC_LZX_TBL_FAR_LO);
+            role[i++] = (uint8_t)(NETC_CTX_COUNT + NETC_LZX_TBL_FAR_HI);
+            pos += (size_t)(t & 0x3Fu) + 3u;
+        }
+    }
+
+    if (lzp_table != NULL)
+        lz77x_lits_xor(tok, tok_len, src, lzp_table, lzp_ovl, lzp_order2);
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, dst + 2, cap - 2u);
+    uint32_t X  = netc_tans_encode_roles(tbl, role, tok, tok_len, &bsw,
+                                         NETC_TANS_TABLE_SIZE);
+    size_t   bs = (X != 0) ? netc_bsw_flush(&bsw) : (size_t)-1;
+    if (lzp_table != NULL)
+        lz77x_lits_xor(tok, tok_len, src, lzp_table, lzp_ovl, lzp_order2);
+    if (bs == (size_t)-1) return (size_t)-1;
+
+    netc_write_u16_le(dst, (uint16_t)X);
+    return 2u + bs;
+}
+
 /* =========================================================================
  * Internal: select tANS table — unigram or bigram sub-table.
  *
@@ -474,12 +661,13 @@ static size_t lz77x_encode(
 static NETC_INLINE const netc_tans_table_t *
 select_tans_table(const netc_dict_t *dict,
                   const netc_tans_table_t *tables,
+                  const netc_bigram_set_t *bigram,
                   uint32_t bucket,
                   uint8_t prev_byte, uint32_t ctx_flags)
 {
     if (ctx_flags & NETC_CFG_FLAG_BIGRAM) {
         uint32_t bclass = netc_bigram_class(prev_byte, dict->bigram_class_map);
-        const netc_tans_table_t *tbl = &dict->bigram_tables[bucket][bclass];
+        const netc_tans_table_t *tbl = bigram->t[bucket][bclass];
         if (tbl->valid) return tbl;
     }
     return &tables[bucket];
@@ -590,16 +778,191 @@ static size_t try_tans_10bit_with_table(
     return state_sz + bs;
 }
 
+/* =========================================================================
+ * Internal: cost-model size prediction
+ *
+ * Every table carries a -log2(p) cost LUT (netc_tans_table_t.cost), so the
+ * bitstream size of a candidate encoding is predicted with one load and one
+ * add per byte.  Candidates are ranked by prediction and only the winner is
+ * encoded; NETC_INTERNAL_VERIFY2 (levels >= 7) also encodes the runner-up
+ * and keeps the smaller actual output, recovering the rare misranking from
+ * ANS state rounding.
+ *
+ * Estimates are kept in Q8 bits (state bytes included) until the final
+ * comparison.  They run slightly low by a bias common to all candidates, so
+ * only near-ties misrank: two candidates predicted within NETC_EST_TIE_BITS
+ * of each other are both encoded and the actual sizes decide.  Secondary
+ * trials compared against an already-encoded incumbent still run when
+ * predicted within NETC_EST_SLACK bytes of it (the low bias errs towards
+ * running them).
+ * ========================================================================= */
+#define NETC_EST_TIE_BITS 4u
+#define NETC_EST_SLACK    1u
+
+/* Q8 bit estimate -> payload bytes ((size_t)-1 stays invalid). */
+static NETC_INLINE size_t est_bytes(size_t est_q8) {
+    return (est_q8 == (size_t)-1) ? (size_t)-1
+                                  : netc_tans_cost_bytes((uint32_t)est_q8);
+}
+
+/* Predicted output of try_tans_single_with_table for tbl, in Q8 bits. */
+static size_t tans_single_estimate(
+    const netc_tans_table_t *tbl,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint32_t                 ctx_flags,
+    int                      compact)
+{
+    uint32_t c = netc_tans_cost(tbl, src, src_size);
+    if (c == NETC_TANS_COST_INVALID) return (size_t)-1;
+    int x2 = !(ctx_flags & NETC_CFG_FLAG_BIGRAM) &&
+             !(ctx_flags & NETC_INTERNAL_NO_X2) && src_size >= 256;
+    size_t state_sz = (compact ? 2u : 4u) << (x2 ? 1 : 0);
+    return ((state_sz * 8u) << NETC_TANS_COST_SHIFT) + c;
+}
+
+/* Predicted output of try_tans_10bit_with_table for a 10-bit freq table. */
+static size_t tans10_estimate(
+    const netc_freq_table_t *freq10,
+    const uint8_t           *src,
+    size_t                   src_size)
+{
+    const uint32_t full_q8 = (uint32_t)NETC_TANS_TABLE_LOG_10 << NETC_TANS_COST_SHIFT;
+    uint32_t c = 0;
+    for (size_t i = 0; i < src_size; i++) {
+        uint32_t f = freq10->freq[src[i]];
+        c += (f == 0) ? NETC_TANS_COST_ABSENT : full_q8 - netc_tans_log2_q8(f);
+    }
+    return 2u + netc_tans_cost_bytes(c);
+}
+
+/* Runner-up worth encoding: always under VERIFY2, else only near-ties. */
+static NETC_INLINE int verify_runner_up(size_t best_est, size_t next_est,
+                                        uint32_t ctx_flags)
+{
+    if (next_est == (size_t)-1) return 0;
+    return (ctx_flags & NETC_INTERNAL_VERIFY2) ||
+           next_est <= best_est + (NETC_EST_TIE_BITS << NETC_TANS_COST_SHIFT);
+}
+
+/* =========================================================================
+ * Internal: single-region table ranking
+ *
+ * Mirrors the table choice of try_tans_single_region: for small multi-bucket
+ * packets every bucket table covering the packet competes; otherwise (or in
+ * bigram mode, which has no prev_byte continuity across tables) the table
+ * for byte offset 0 is used.  est is (size_t)-1 when no table is usable;
+ * next is UINT32_MAX when there is no runner-up.
+ * ========================================================================= */
+typedef struct {
+    uint32_t idx,  next;
+    size_t   est,  next_est;
+} sr_rank_t;
+
+static void single_region_rank(
+    const netc_dict_t       *dict,
+    const netc_tans_table_t *tables,
+    const netc_bigram_set_t *bigram,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint32_t                 ctx_flags,
+    int                      compact,
+    sr_rank_t               *r)
+{
+    uint32_t first_bucket = netc_bucket_of(&dict->buckets, 0);
+    uint32_t last_bucket  = netc_bucket_of(&dict->buckets,
+                                           (uint32_t)(src_size > 0 ? src_size - 1 : 0));
+
+    r->idx = first_bucket;
+    r->next = UINT32_MAX;
+    r->est = r->next_est = (size_t)-1;
+
+    if (!(ctx_flags & NETC_CFG_FLAG_BIGRAM) && src_size <= 512u &&
+        last_bucket > first_bucket)
+    {
+        for (uint32_t b = first_bucket; b <= last_bucket; b++) {
+            size_t est = tans_single_estimate(&tables[b], src, src_size,
+                                              ctx_flags, compact);
+            if (est < r->est) {
+                r->next = r->idx; r->next_est = r->est;
+                r->idx  = b;      r->est      = est;
+            } else if (est < r->next_est) {
+                r->next = b;      r->next_est = est;
+            }
+        }
+        if (r->next_est == (size_t)-1) r->next = UINT32_MAX;
+        return;
+    }
+
+    const netc_tans_table_t *tbl = select_tans_table(dict, tables, bigram, first_bucket,
+                                                     0x00u, ctx_flags);
+    r->est = tans_single_estimate(tbl, src, src_size, ctx_flags, compact);
+}
+
 /* =========================================================================
  * Internal: single-region tANS encode (legacy format: [4B state][bitstream])
  *
- * When MREG is not viable (overhead too large), scans all bucket tables that
- * span the packet's byte-offset range and selects the one that produces the
- * smallest compressed output.  The winning bucket index is returned via
- * *out_table_idx so the caller can encode it into the algorithm byte high nibble.
+ * Encodes with the table chosen by single_region_rank, and also with the
+ * runner-up when verify_runner_up() says so, keeping the smaller output.
+ * The table index is returned via *out_table_idx so the caller can encode
+ * it into the algorithm byte high nibble.
  *
- * When NETC_CFG_FLAG_BIGRAM is set, bigram sub-tables are evaluated for the
- * winning bucket (implicit start-of-packet previous byte 0x00).
+ * Returns 0 on success (sets *compressed_payload_size), -1 on failure.
+ * ========================================================================= */
+static int encode_single_region(
+    const netc_dict_t       *dict,
+    const netc_tans_table_t *tables,
+    const netc_bigram_set_t *bigram,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   dst_payload_cap,
+    size_t                  *compressed_payload_size,
+    int                     *used_x2_flag,
+    uint32_t                *out_table_idx,
+    const sr_rank_t         *rank,
+    uint32_t                 ctx_flags,
+    int                      compact)
+{
+    uint32_t idx = rank->idx;
+    const netc_tans_table_t *tbl = select_tans_table(dict, tables, bigram, idx, 0x00u, ctx_flags);
+    int    x2 = 0;
+    size_t cp = try_tans_single_with_table(tbl, src, src_size, dst,
+                                           dst_payload_cap, &x2, ctx_flags, compact);
+
+    if (verify_runner_up(rank->est, rank->next_est, ctx_flags)) {
+        /* Runner-up only exists for the <=512B multi-scan */
+        uint8_t trial_buf[512u + 8u];
+        size_t  trial_cap = dst_payload_cap < sizeof(trial_buf)
+                          ? dst_payload_cap : sizeof(trial_buf);
+        int     trial_x2  = 0;
+        size_t  trial_cp  = try_tans_single_with_table(
+            &tables[rank->next], src, src_size,
+            trial_buf, trial_cap, &trial_x2, ctx_flags, compact);
+        if (trial_cp < cp) {
+            memcpy(dst, trial_buf, trial_cp);
+            cp  = trial_cp;
+            x2  = trial_x2;
+            idx = rank->next;
+        }
+    }
+
+    if (cp == (size_t)-1) return -1;
+    *compressed_payload_size = cp;
+    *used_x2_flag            = x2;
+    *out_table_idx           = idx;
+    return 0;
+}
+
+/* =========================================================================
+ * Internal: single-region tANS compress
+ *
+ * When MREG is not viable (overhead too large), picks the bucket table that
+ * is predicted to produce the smallest output (see single_region_rank) and
+ * encodes with it.
+ *
+ * When NETC_CFG_FLAG_BIGRAM is set, the bigram sub-table for bucket 0 is
+ * used (implicit start-of-packet previous byte 0x00).
  *
  * Sets *used_mreg_flag = 0.
  * Returns 0 on success (sets *compressed_payload_size), -1 on failure.
@@ -607,6 +970,7 @@ static size_t try_tans_10bit_with_table(
 static int try_tans_single_region(
     const netc_dict_t *dict,
     const netc_tans_table_t *tables,  /* adaptive or dict->tables */
+    const netc_bigram_set_t *bigram,
     const uint8_t     *src,
     size_t             src_size,
     uint8_t           *dst,
@@ -620,83 +984,234 @@ static int try_tans_single_region(
 {
     *used_mreg_flag = 0;
 
-    uint32_t first_bucket = netc_ctx_bucket(0);
-    uint32_t last_bucket  = netc_ctx_bucket((uint32_t)(src_size > 0 ? src_size - 1 : 0));
+    sr_rank_t rank;
+    single_region_rank(dict, tables, bigram, src, src_size, ctx_flags, compact, &rank);
+    if (rank.est == (size_t)-1) return -1;
+    return encode_single_region(dict, tables, bigram, src, src_size, dst, dst_payload_cap,
+                                compressed_payload_size, used_x2_flag, out_table_idx,
+                                &rank, ctx_flags, compact);
+}
 
-    /* For small packets (<=512B) scan all bucket tables covering this packet's
-     * offset range and pick the table that yields smallest output.
-     * Bigram mode is excluded from multi-scan (no prev_byte continuity). */
-    if (!(ctx_flags & NETC_CFG_FLAG_BIGRAM) && src_size <= 512u &&
-        last_bucket > first_bucket)
+/* =========================================================================
+ * Internal: multi-bucket candidate plan
+ *
+ * Candidates are identified by the used_mreg code they produce:
+ *   0 = single-region best-fit, 2 = PCTX, 3 = PCTX+BIGRAM.
+ *
+ * PCTX (v0.4+) encodes all bytes in a SINGLE ANS stream, switching the
+ * probability table per byte offset via netc_bucket_of(&dict->buckets, i).  This gives
+ * per-position entropy specialization (like MREG) with ZERO descriptor
+ * overhead.  Wire format: [state_sz initial_state][bitstream].  Wide packets
+ * (>= NETC_TANS_X4_MIN) carry 4 or 8 packed interleaved states instead
+ * (netc_tans_encode_pctx_xn), trading a few bytes for a decoder with
+ * independent state chains; the estimates below include the state bytes.
+ *
+ * PCTX is always a candidate.  Bigram-PCTX joins when bigram is enabled and
+ * bigram tables exist.  Single-region best-fit joins for small packets
+ * (<=512B) unless NETC_INTERNAL_SKIP_SR is set (pre-filtered data: delta
+ * residuals or LZP XOR output -- PCTX with per-position tables dominates
+ * any single-region table for these inputs).
+ *
+ * Ties keep the order above: PCTX, then bigram-PCTX, then single-region.
+ * ========================================================================= */
+/* PCTX state prefix: packed X4/X8 states, else one 2B (compact) / 4B state. */
+static NETC_INLINE size_t pctx_state_bytes(size_t src_size, int compact)
+{
+    uint32_t n_states = netc_tans_pctx_states(src_size);
+    if (n_states > 1U) return NETC_TANS_XN_STATE_BYTES(n_states);
+    return compact ? 2u : 4u;
+}
+
+typedef struct {
+    int      kind[2];   /* winner, runner-up (-1 = none) */
+    size_t   est[2];    /* predicted payload sizes, Q8 bits */
+    uint32_t pctx_cost; /* unigram PCTX bitstream, Q8 bits (no state bytes) */
+    sr_rank_t sr;       /* single-region table choice */
+} tans_plan_t;
+
+static void tans_plan_rank(
+    const netc_dict_t       *dict,
+    const netc_tans_table_t *tables,
+    const netc_bigram_set_t *bigram,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint32_t                 ctx_flags,
+    int                      compact,
+    tans_plan_t             *plan)
+{
+    const size_t state_q8 = (pctx_state_bytes(src_size, compact) * 8u)
+                            << NETC_TANS_COST_SHIFT;
+    int    kinds[3];
+    size_t ests[3];
+    int    n = 0;
+    uint32_t c;
+
+    c = netc_tans_cost_pctx(tables, &dict->buckets, src, src_size);
+    plan->pctx_cost = c;
+    if (c != NETC_TANS_COST_INVALID) {
+        kinds[n] = 2; ests[n++] = state_q8 + c;
+    }
+    if ((ctx_flags & NETC_CFG_FLAG_BIGRAM) &&
+        !(ctx_flags & NETC_INTERNAL_NO_BIGRAM_PCTX) &&
+        dict->bigram_tables[0][0].valid)
     {
-        /* Temporary buffer for trial encoding (stack, bounded by src_size+8) */
-        uint8_t trial_buf[512u + 8u];
-        size_t  best_cp     = (size_t)-1;
-        uint32_t best_bucket = first_bucket;
-        int      best_x2     = 0;
+        c = netc_tans_cost_pctx_bigram(bigram, tables,
+                                       dict->bigram_class_map, &dict->buckets,
+                                       src, src_size);
+        if (c != NETC_TANS_COST_INVALID) {
+            kinds[n] = 3; ests[n++] = state_q8 + c;
+        }
+    }
+    plan->sr.est = (size_t)-1;
+    if (src_size <= 512u && !(ctx_flags & NETC_INTERNAL_SKIP_SR)) {
+        single_region_rank(dict, tables, bigram, src, src_size, ctx_flags, compact, &plan->sr);
+        if (plan->sr.est != (size_t)-1) { kinds[n] = 0; ests[n++] = plan->sr.est; }
+    }
 
-        for (uint32_t b = first_bucket; b <= last_bucket; b++) {
-            if (!tables[b].valid) continue;
-            int trial_x2 = 0;
-            size_t cp = try_tans_single_with_table(
-                &tables[b], src, src_size,
-                trial_buf, sizeof(trial_buf), &trial_x2, ctx_flags, compact);
-            if (cp != (size_t)-1 && cp < best_cp) {
-                best_cp     = cp;
-                best_bucket = b;
-                best_x2     = trial_x2;
-            }
+    plan->kind[0] = plan->kind[1] = -1;
+    plan->est[0]  = plan->est[1]  = (size_t)-1;
+    for (int i = 0; i < n; i++) {
+        if (ests[i] < plan->est[0]) {
+            plan->kind[1] = plan->kind[0]; plan->est[1] = plan->est[0];
+            plan->kind[0] = kinds[i];      plan->est[0] = ests[i];
+        } else if (ests[i] < plan->est[1]) {
+            plan->kind[1] = kinds[i];      plan->est[1] = ests[i];
         }
+    }
+}
 
-        if (best_cp == (size_t)-1) return -1;
+/* Encode one plan candidate into dst.  Returns payload size or (size_t)-1. */
+static size_t encode_tans_candidate(
+    const netc_dict_t       *dict,
+    const netc_tans_table_t *tables,
+    const netc_bigram_set_t *bigram,
+    const tans_plan_t       *plan,
+    int                      kind,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   dst_payload_cap,
+    int                     *used_x2_flag,
+    uint32_t                *out_table_idx,
+    uint32_t                 ctx_flags,
+    int                      compact)
+{
+    if (kind == 0) {
+        size_t cp = 0;
+        if (encode_single_region(dict, tables, bigram, src, src_size, dst, dst_payload_cap,
+                                 &cp, used_x2_flag, out_table_idx,
+                                 &plan->sr, ctx_flags, compact) != 0)
+            return (size_t)-1;
+        return cp;
+    }
 
-        /* Re-encode with the best table directly into dst */
-        int final_x2 = 0;
-        size_t final_cp = try_tans_single_with_table(
-            &tables[best_bucket], src, src_size,
-            dst, dst_payload_cap, &final_x2, ctx_flags, compact);
-        if (final_cp == (size_t)-1) return -1;
+    const uint32_t n_states = netc_tans_pctx_states(src_size);
+    const size_t   state_sz = pctx_state_bytes(src_size, compact);
+    if (dst_payload_cap < state_sz) return (size_t)-1;
 
-        *compressed_payload_size = final_cp;
-        *out_table_idx           = best_bucket;
-        *used_x2_flag            = final_x2;
-        (void)best_x2; /* deterministic re-encode always matches */
-        return 0;
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, dst + state_sz, dst_payload_cap - state_sz);
+    uint32_t states[NETC_TANS_MAX_STATES];
+    if (n_states > 1U) {
+        int rc = (kind == 3)
+            ? netc_tans_encode_pctx_bigram_xn(bigram, tables,
+                                              dict->bigram_class_map, &dict->buckets,
+                                              src, src_size, &bsw, n_states, states)
+            : netc_tans_encode_pctx_xn(tables, &dict->buckets, src, src_size, &bsw,
+                                       n_states, states);
+        if (rc != 0) return (size_t)-1;
+    } else {
+        states[0] = (kind == 3)
+            ? netc_tans_encode_pctx_bigram(bigram, tables,
+                                           dict->bigram_class_map, &dict->buckets,
+                                           src, src_size, &bsw, NETC_TANS_TABLE_SIZE)
+            : netc_tans_encode_pctx(tables, &dict->buckets, src, src_size, &bsw,
+                                    NETC_TANS_TABLE_SIZE);
+        if (states[0] == 0) return (size_t)-1;
     }
+    size_t bs = netc_bsw_flush(&bsw);
+    if (bs == (size_t)-1) return (size_t)-1;
 
-    /* Default path: use the table for byte offset 0 */
-    uint32_t bucket = first_bucket;
-    *out_table_idx  = bucket;
+    if (n_states > 1U)
+        netc_tans_xn_states_write(dst, states, n_states);
+    else if (compact)
+        netc_write_u16_le(dst, (uint16_t)states[0]);
+    else
+        netc_write_u32_le(dst, states[0]);
+    *used_x2_flag  = 0;
+    *out_table_idx = 0;
+    return state_sz + bs;
+}
 
-    const netc_tans_table_t *tbl = select_tans_table(dict, tables, bucket, 0x00u, ctx_flags);
-    size_t cp = try_tans_single_with_table(tbl, src, src_size, dst,
-                                           dst_payload_cap, used_x2_flag, ctx_flags, compact);
-    if (cp == (size_t)-1) return -1;
-    *compressed_payload_size = cp;
-    return 0;
+/* Algorithm byte for a PCTX payload produced by encode_tans_candidate: the
+ * interleaved state count follows from the packet size. */
+static NETC_INLINE uint8_t pctx_algorithm(size_t src_size, int lzp)
+{
+    return (uint8_t)(NETC_ALG_TANS_PCTX | (lzp ? NETC_PCTX_LZP : 0u) |
+                     netc_pctx_alg_xn(netc_tans_pctx_states(src_size)));
 }
 
 /* =========================================================================
- * Internal: multi-region tANS compress (v0.2)
+ * Internal: static rANS candidate
  *
- * Encodes each contiguous bucket region as an independent ANS stream.
- * Wire format (after the 8-byte packet header):
- *   [1B]      n_regions
- *   [n×8B]    descriptors — per region: {uint32_le state, uint32_le bs_bytes}
- *   [N B]     bitstreams  — concatenated region bitstreams (region 0 first)
+ * rANS codes the unigram PCTX contexts with the dictionary's frequencies at
+ * exactly the cost-model price (no spread-function loss), plus 16 state
+ * bytes.  It is encoded only when that prediction comes within
+ * NETC_EST_SLACK of the tANS result already in dst.  Adaptive contexts code
+ * with their own tables, which have no rANS counterpart, so the candidate
+ * is limited to the frozen dictionary tables.
  *
- * Returns 0 on success (sets *compressed_payload_size, *used_mreg_flag=1).
- * Returns -1 if any table is invalid or output expands.
+ * Returns the rANS payload size when it is smaller than incumbent (and
+ * copies it to dst), else (size_t)-1.
+ * ========================================================================= */
+static size_t try_rans_candidate(
+    const netc_dict_t       *dict,
+    const netc_tans_table_t *tables,
+    const tans_plan_t       *plan,
+    const uint8_t           *src,
+    size_t                   src_size,
+    uint8_t                 *dst,
+    size_t                   incumbent)
+{
+    if (tables != dict->tables || src_size < NETC_RANS_MIN ||
+        plan->pctx_cost == NETC_TANS_COST_INVALID)
+        return (size_t)-1;
+    if (NETC_RANS_STATE_SIZE + netc_tans_cost_bytes(plan->pctx_cost)
+            > incumbent + NETC_EST_SLACK)
+        return (size_t)-1;
+
+    uint8_t trial[NETC_MAX_PACKET_SIZE + 64];
+    size_t  cap = incumbent < sizeof(trial) ? incumbent : sizeof(trial);
+    size_t  cp  = netc_rans_encode_pctx(dict->rans_tables, &dict->buckets,
+                                        src, src_size, trial, cap);
+    if (cp >= incumbent) return (size_t)-1;
+    memcpy(dst, trial, cp);
+    return cp;
+}
+
+/* =========================================================================
+ * Internal: tANS compress (single-region, PCTX or PCTX+BIGRAM)
+ *
+ * Single-bucket packets use the simpler legacy single-region format (less
+ * overhead).  Multi-bucket packets rank the candidates of tans_plan_rank by
+ * predicted size and encode the winner (plus the runner-up under
+ * NETC_INTERNAL_VERIFY2); under NETC_INTERNAL_RANS static rANS then
+ * competes with that result.
+ *
+ * Sets *used_mreg_flag to the winning candidate's code (0, 2, 3, or 4 for
+ * rANS).
+ * Returns 0 on success (sets *compressed_payload_size), -1 on failure.
  * ========================================================================= */
 static int try_tans_compress(
     const netc_dict_t *dict,
     const netc_tans_table_t *tables,  /* adaptive or dict->tables */
+    const netc_bigram_set_t *bigram,
     const uint8_t     *src,
     size_t             src_size,
     uint8_t           *dst,             /* points past the packet header */
     size_t             dst_payload_cap,
     size_t            *compressed_payload_size,
-    int               *used_mreg_flag,  /* out: 1 if MREG format was used */
+    int               *used_mreg_flag,  /* out: used_mreg code of the winner */
     int               *used_x2_flag,   /* out: 1 if dual-state x2 encode was used */
     uint32_t          *out_table_idx,  /* out: table bucket used (single-region) */
     uint32_t           ctx_flags,      /* NETC_CFG_FLAG_* bitmask */
@@ -705,17 +1220,13 @@ static int try_tans_compress(
     if (src_size == 0) return -1;
 
     *used_x2_flag  = 0;
-    *out_table_idx = (uint32_t)netc_ctx_bucket(0);
-
-    uint32_t first_bucket = netc_ctx_bucket(0);
-    uint32_t last_bucket  = netc_ctx_bucket((uint32_t)(src_size - 1));
-    uint32_t n_regions    = last_bucket - first_bucket + 1;
+    *out_table_idx = netc_bucket_of(&dict->buckets, 0);
 
-    const size_t state_sz = compact ? 2u : 4u;
+    uint32_t first_bucket = netc_bucket_of(&dict->buckets, 0);
+    uint32_t last_bucket  = netc_bucket_of(&dict->buckets, (uint32_t)(src_size - 1));
 
-    /* For single-bucket packets use the simpler legacy format (less overhead) */
-    if (n_regions == 1) {
-        return try_tans_single_region(dict, tables, src, src_size, dst, dst_payload_cap,
+    if (last_bucket == first_bucket) {
+        return try_tans_single_region(dict, tables, bigram, src, src_size, dst, dst_payload_cap,
                                       compressed_payload_size, used_mreg_flag,
                                       used_x2_flag, out_table_idx, ctx_flags,
                                       compact);
@@ -726,102 +1237,56 @@ static int try_tans_compress(
         if (!tables[b].valid) return -1;
     }
 
-    /* --- PCTX path: per-position context-adaptive tANS (v0.4+) ---
-     *
-     * Encodes all bytes in a SINGLE ANS stream, switching the probability
-     * table per byte offset via netc_ctx_bucket(i). This gives per-position
-     * entropy specialization (like MREG) with ZERO descriptor overhead.
-     * Wire format: [state_sz initial_state][bitstream].
-     *
-     * Always try PCTX for multi-bucket packets. For small packets (<512B),
-     * also try single-region best-fit and keep the smaller result. */
-    if (dst_payload_cap >= state_sz) {
-        /* --- Unigram PCTX trial --- */
-        netc_bsw_t bsw;
-        netc_bsw_init(&bsw, dst + state_sz, dst_payload_cap - state_sz);
-
-        uint32_t pctx_state = netc_tans_encode_pctx(
-            tables, src, src_size, &bsw, NETC_TANS_TABLE_SIZE);
-
-        if (pctx_state != 0) {
-            size_t pctx_bs = netc_bsw_flush(&bsw);
-            if (pctx_bs != (size_t)-1) {
-                size_t pctx_total = state_sz + pctx_bs;
-                int    pctx_is_bigram = 0;
-
-                /* --- Bigram-PCTX trial: per-position bigram table switching ---
-                 * Only when bigram is enabled and bigram tables exist.
-                 * If bigram-PCTX is smaller, re-encode into dst and use it. */
-                if ((ctx_flags & NETC_CFG_FLAG_BIGRAM) &&
-                    dict->bigram_tables[0][0].valid)
-                {
-                    /* Trial buffer: encode bigram separately so we never
-                     * clobber the unigram bitstream already in dst. */
-                    uint8_t bg_trial[NETC_MAX_PACKET_SIZE + 64];
-                    size_t bg_cap = dst_payload_cap - state_sz;
-                    if (bg_cap > sizeof(bg_trial)) bg_cap = sizeof(bg_trial);
-
-                    netc_bsw_t bsw_bg;
-                    netc_bsw_init(&bsw_bg, bg_trial, bg_cap);
-
-                    uint32_t bg_state = netc_tans_encode_pctx_bigram(
-                        dict->bigram_tables, tables, dict->bigram_class_map,
-                        src, src_size, &bsw_bg, NETC_TANS_TABLE_SIZE);
-
-                    if (bg_state != 0) {
-                        size_t bg_bs = netc_bsw_flush(&bsw_bg);
-                        if (bg_bs != (size_t)-1) {
-                            size_t bg_total = state_sz + bg_bs;
-                            if (bg_total < pctx_total) {
-                                /* Bigram-PCTX wins -- copy to dst */
-                                memcpy(dst + state_sz, bg_trial, bg_bs);
-                                pctx_total    = bg_total;
-                                pctx_state    = bg_state;
-                                pctx_is_bigram = 1;
-                            }
-                            /* Unigram wins: dst already has the correct bitstream,
-                             * no re-encode needed. */
-                        }
-                    }
-                }
-
-                /* For small packets, also try single-region best-fit to compare.
-                 * Skipped when NETC_INTERNAL_SKIP_SR is set (pre-filtered data:
-                 * delta residuals or LZP XOR output) -- PCTX with per-position
-                 * tables dominates any single-region table for these inputs. */
-                if (src_size <= 512u && !(ctx_flags & NETC_INTERNAL_SKIP_SR)) {
-                    uint8_t trial_buf[520];
-                    size_t  sr_cp = 0;
-                    int     sr_mreg = 0, sr_x2 = 0;
-                    uint32_t sr_tbl_idx = 0;
-
-                    if (try_tans_single_region(dict, tables, src, src_size,
-                            trial_buf, sizeof(trial_buf),
-                            &sr_cp, &sr_mreg, &sr_x2, &sr_tbl_idx,
-                            ctx_flags, compact) == 0 && sr_cp < pctx_total)
-                    {
-                        /* Single-region beats PCTX -- copy to dst and use it */
-                        memcpy(dst, trial_buf, sr_cp);
-                        *compressed_payload_size = sr_cp;
-                        *used_mreg_flag  = sr_mreg;
-                        *used_x2_flag    = sr_x2;
-                        *out_table_idx   = sr_tbl_idx;
-                        return 0;
-                    }
-                }
+    tans_plan_t plan;
+    tans_plan_rank(dict, tables, bigram, src, src_size, ctx_flags, compact, &plan);
+
+    if (plan.kind[0] >= 0) {
+        int      x2   = 0;
+        uint32_t tidx = 0;
+        int      kind = plan.kind[0];
+        size_t   cp   = encode_tans_candidate(dict, tables, bigram, &plan, kind,
+                                              src, src_size, dst, dst_payload_cap,
+                                              &x2, &tidx, ctx_flags, compact);
+
+        if (plan.kind[1] >= 0 &&
+            verify_runner_up(plan.est[0], plan.est[1], ctx_flags)) {
+            /* Trial buffer: encode the runner-up separately so we never
+             * clobber the winner already in dst. */
+            uint8_t  trial[NETC_MAX_PACKET_SIZE + 64];
+            size_t   trial_cap = dst_payload_cap < sizeof(trial)
+                               ? dst_payload_cap : sizeof(trial);
+            int      trial_x2  = 0;
+            uint32_t trial_idx = 0;
+            size_t   trial_cp  = encode_tans_candidate(
+                dict, tables, bigram, &plan, plan.kind[1], src, src_size,
+                trial, trial_cap, &trial_x2, &trial_idx, ctx_flags, compact);
+            if (trial_cp < cp) {
+                memcpy(dst, trial, trial_cp);
+                cp   = trial_cp;
+                x2   = trial_x2;
+                tidx = trial_idx;
+                kind = plan.kind[1];
+            }
+        }
 
-                /* PCTX wins -- write initial state */
-                if (compact)
-                    netc_write_u16_le(dst, (uint16_t)pctx_state);
-                else
-                    netc_write_u32_le(dst, pctx_state);
-                *compressed_payload_size = pctx_total;
-                *used_mreg_flag = pctx_is_bigram ? 3 : 2; /* 3 = PCTX+BIGRAM, 2 = PCTX */
-                *used_x2_flag   = 0;
-                *out_table_idx  = 0;
-                return 0;
+        if (cp != (size_t)-1 && (ctx_flags & NETC_INTERNAL_RANS)) {
+            size_t rans_cp = try_rans_candidate(dict, tables, &plan, src,
+                                                src_size, dst, cp);
+            if (rans_cp != (size_t)-1) {
+                cp   = rans_cp;
+                x2   = 0;
+                tidx = 0;
+                kind = 4;
             }
         }
+
+        if (cp != (size_t)-1) {
+            *compressed_payload_size = cp;
+            *used_mreg_flag = kind;
+            *used_x2_flag   = x2;
+            *out_table_idx  = tidx;
+            return 0;
+        }
     }
 
     /* Fallback: single-region best-fit table selection.
@@ -829,44 +1294,169 @@ static int try_tans_compress(
      * valid output format.  If PCTX failed above, return failure so the caller
      * can fall back to raw-tANS or passthrough (which strips the delta flag). */
     if (ctx_flags & NETC_INTERNAL_SKIP_SR) return -1;
-    return try_tans_single_region(dict, tables, src, src_size, dst, dst_payload_cap,
+    return try_tans_single_region(dict, tables, bigram, src, src_size, dst, dst_payload_cap,
                                   compressed_payload_size, used_mreg_flag,
                                   used_x2_flag, out_table_idx, ctx_flags,
                                   compact);
 }
 
 /* =========================================================================
- * netc_compress — stateful context path
+ * Per-context compression environment
+ *
+ * Everything the per-packet path needs from the context that does not change
+ * between packets: the dictionary, the header mode and the working arena
+ * (the context's own, or a caller's netc_scratch_t), so a batch can resolve
+ * them once.  The tANS and LZP tables are not cached: adaptive contexts
+ * switch from the shared dict tables to their own copies mid-stream, so
+ * compress_packet resolves them per packet.
  * ========================================================================= */
 
-netc_result_t netc_compress(
-    netc_ctx_t *ctx,
-    const void *src,
-    size_t      src_size,
-    void       *dst,
-    size_t      dst_cap,
-    size_t     *dst_size)
+typedef struct {
+    const netc_dict_t       *dict;
+    int                      compact_mode;
+    uint8_t                 *arena;      /* per-call working memory */
+    size_t                   arena_size;
+} compress_env_t;
+
+static NETC_INLINE void compress_env_init(const netc_ctx_t *ctx,
+                                          compress_env_t *env)
 {
-    if (NETC_UNLIKELY(ctx == NULL)) {
-        return NETC_ERR_CTX_NULL;
+    env->dict         = ctx->dict;
+    env->compact_mode = (ctx->flags & NETC_CFG_FLAG_COMPACT_HDR) ? 1 : 0;
+    env->arena        = ctx->arena;
+    env->arena_size   = ctx->arena_size;
+}
+
+/* =========================================================================
+ * Internal: LZ77X trial — plain tokens, or tANS-coded ones when smaller
+ *
+ * Parses src against the ring into env->arena and, when the plan and the
+ * dictionary allow it, codes the tokens too (AD-031).  If the ring probe
+ * had hits the parse may run past best, since coding can bring it back
+ * under; tokens with under 1/8 of src in back-refs are not coded.  Returns
+ * the size of the smaller payload when below best, with its algorithm byte
+ * in *alg and its bytes at *out; 0 otherwise.
+ * ========================================================================= */
+
+/* Bytes of a token stream's output that come from back-refs */
+static size_t lz77x_ref_bytes(const uint8_t *tok, size_t tok_len) {
+    size_t refs = 0;
+    for (size_t i = 0; i < tok_len; ) {
+        uint8_t t = tok[i++];
+        if (t & 0x80u) {
+            refs += (size_t)(t & 0x3Fu) + 3u;
+            i    += (t & 0x40u) ? 2u : 1u;
+        } else {
+            i    += (size_t)(t & 0x7Fu) + 1u;
+        }
     }
-    if (NETC_UNLIKELY(src == NULL || dst == NULL || dst_size == NULL)) {
-        return NETC_ERR_INVALID_ARG;
+    return refs;
+}
+
+static size_t lz77x_trial(netc_ctx_t *ctx, const compress_env_t *env,
+                          const netc_tans_table_t  *tables,
+                          const netc_lzp_table_t   *lzp_table,
+                          const netc_lzp_overlay_t *lzp_ovl,
+                          int                       lzp_order2,
+                          const uint8_t *src, size_t src_size,
+                          uint32_t depth, unsigned hits, size_t best,
+                          uint8_t *alg, const uint8_t **out)
+{
+    const netc_dict_t *dict = env->dict;
+    int coded = (ctx->plan.trials & NETC_TRIAL_LZX_TANS) && netc_dict_has_lzx(dict) &&
+                tables != NULL && env->arena_size / 3u >= src_size;
+    size_t cap = best;
+    if (coded && hits > 0) cap = (best < src_size / 2u) ? best * 2u : src_size;
+
+    size_t n = lz77x_encode(src, src_size, ctx->ring, ctx->ring_size, ctx->ring_pos,
+                            &ctx->lzx, depth, env->arena, cap);
+    if (n == (size_t)-1) return 0;
+    size_t len = (n < best) ? n : 0;
+    *alg = NETC_ALG_LZ77X;
+    *out = env->arena;
+
+    if (coded && lz77x_ref_bytes(env->arena, n) * 8u < src_size) coded = 0;
+    if (coded) {
+        size_t   lim   = (len != 0) ? len : best;
+        uint8_t *coded_out = env->arena + 2u * src_size;
+        size_t   c = lz77x_tans_encode(dict, tables, lzp_table, lzp_ovl, lzp_order2,
+                                       src, env->arena, n, env->arena + src_size,
+                                       coded_out, lim - 1u);
+        if (c != (size_t)-1) {
+            len  = c;
+            *alg = (uint8_t)(NETC_ALG_LZ77X | NETC_LZ77X_TANS);
+            *out = coded_out;
+        }
     }
-    if (NETC_UNLIKELY(src_size > NETC_MAX_PACKET_SIZE)) {
-        return NETC_ERR_TOOBIG;
+    return len;
+}
+
+/* =========================================================================
+ * compress_bigram_feed — give an adaptive context's bigram slots the bytes
+ * a PCTX+BIGRAM packet was coded from (netc_adaptive_bigram_feed).  The LZ
+ * trials reuse the arena, so the LZP-filtered bytes or delta residuals are
+ * rebuilt there from src.  Call before the packet history rotates.
+ * ========================================================================= */
+static void compress_bigram_feed(netc_ctx_t               *ctx,
+                                 const compress_env_t     *env,
+                                 const uint8_t            *src,
+                                 size_t                    src_size,
+                                 uint8_t                   pkt_flags,
+                                 int                       did_lzp,
+                                 const netc_lzp_table_t   *lzp_table,
+                                 const netc_lzp_overlay_t *lzp_ovl)
+{
+    if (ctx->adapt_bg == NULL) return;
+    const netc_dict_t *dict  = env->dict;
+    const uint8_t     *coded = src;
+    if (did_lzp) {
+        netc_lzp_filter(&ctx->simd_ops, src, src_size, lzp_table, lzp_ovl,
+                        netc_lzp_order2(ctx->dict), env->arena);
+        coded = env->arena;
+    } else if (pkt_flags & NETC_PKT_FLAG_DELTA) {
+        if (pkt_flags & NETC_PKT_FLAG_RLE)
+            netc_delta_encode_order2(&dict->delta_map, ctx->prev2_pkt, ctx->prev_pkt,
+                                     src, env->arena, src_size);
+        else
+            ctx->simd_ops.delta_encode(&dict->delta_map, ctx->prev_pkt, src,
+                                       env->arena, src_size);
+        if (dict->delta_planes.count > 0)
+            ctx->simd_ops.delta_planes_split(&dict->delta_planes, env->arena, src_size);
+        coded = env->arena;
     }
-    if (NETC_UNLIKELY(dst_cap < NETC_COMPACT_HDR_MIN)) {
-        return NETC_ERR_BUF_SMALL;
+    netc_adaptive_bigram_feed(ctx, coded, src_size);
+}
+
+/* =========================================================================
+ * compress_packet_body — code one packet against prev_pkt.  Arguments are
+ * validated by the caller.
+ * ========================================================================= */
+
+static netc_result_t compress_packet_body(
+    netc_ctx_t           *ctx,
+    const compress_env_t *env,
+    const void           *src,
+    size_t                src_size,
+    void                 *dst,
+    size_t                dst_cap,
+    size_t               *dst_size)
+{
+    if (NETC_UNLIKELY(netc_ctx_reserve_history(ctx, src_size) != NETC_OK ||
+                      netc_ctx_reserve_lzx(ctx) != NETC_OK ||
+                      netc_adaptive_reserve(ctx, src_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
     }
 
     uint8_t seq  = ctx->context_seq++;
-    const netc_dict_t *dict = ctx->dict;
-    /* Adaptive tables (when active) or frozen dict tables */
-    const netc_tans_table_t *tables = (dict != NULL) ? netc_get_tables(ctx) : NULL;
-    /* Adaptive LZP table (when active) or frozen dict LZP table */
-    const netc_lzp_entry_t *lzp_table = netc_get_lzp_table(ctx);
-    const int compact_mode = (ctx->flags & NETC_CFG_FLAG_COMPACT_HDR) ? 1 : 0;
+    const netc_dict_t *dict = env->dict;
+    const netc_tans_table_t  *tables    = (dict != NULL) ? netc_get_tables(ctx) : NULL;
+    const netc_bigram_set_t  *bigram    = (dict != NULL) ? netc_get_bigram(ctx) : NULL;
+    const netc_lzp_table_t    lzp       = netc_get_lzp_table(ctx);
+    const netc_lzp_table_t   *lzp_table = (lzp.ent != NULL) ? &lzp : NULL;
+    const netc_lzp_overlay_t *lzp_ovl   = netc_get_lzp_overlay(ctx);
+    const int                 lzp_order2 = netc_lzp_order2(dict);
+    const int compact_mode = env->compact_mode;
+    const uint32_t trials = ctx->plan.trials;
     const size_t hdr_sz = compact_mode
         ? (src_size <= 127u ? NETC_COMPACT_HDR_MIN : NETC_COMPACT_HDR_MAX)
         : NETC_HEADER_SIZE;
@@ -891,36 +1481,45 @@ netc_result_t netc_compress(
     if ((ctx->flags & NETC_CFG_FLAG_DELTA) &&
         ctx->prev_pkt_size == src_size &&
         src_size >= NETC_DELTA_MIN_SIZE &&
-        ctx->arena_size >= src_size)
+        env->arena_size >= src_size)
     {
-        /* Encode order-1 residuals into arena via SIMD dispatch */
-        ctx->simd_ops.delta_encode(ctx->prev_pkt, (const uint8_t *)src,
-                                   ctx->arena, src_size);
-        compress_src = ctx->arena;
+        /* Encode order-1 residuals into arena via SIMD dispatch, with the
+         * dictionary's per-offset operator map (static layout without one) */
+        const netc_delta_map_t *dmap = (dict != NULL) ? &dict->delta_map
+                                                      : &netc_delta_map_default;
+        ctx->simd_ops.delta_encode(dmap, ctx->prev_pkt, (const uint8_t *)src,
+                                   env->arena, src_size);
+        compress_src = env->arena;
         pkt_flags   |= NETC_PKT_FLAG_DELTA;
         did_delta    = 1;
 
         /* Order-2 delta trial: when prev2 is available with matching size,
          * try linear extrapolation prediction and use it if it produces
          * lower-entropy residuals (more zero bytes). */
-        if (ctx->prev2_pkt != NULL &&
+        if ((trials & NETC_TRIAL_ORDER2) &&
+            ctx->prev2_pkt != NULL &&
             ctx->prev2_pkt_size == src_size)
         {
             uint8_t o2_trial[NETC_MAX_PACKET_SIZE];
-            netc_delta_encode_order2(ctx->prev2_pkt, ctx->prev_pkt,
+            netc_delta_encode_order2(dmap, ctx->prev2_pkt, ctx->prev_pkt,
                                      (const uint8_t *)src, o2_trial, src_size);
             /* Heuristic: count zero bytes — more zeros ≈ lower entropy */
             size_t zeros_o1 = 0, zeros_o2 = 0;
             for (size_t zi = 0; zi < src_size; zi++) {
-                if (ctx->arena[zi] == 0) zeros_o1++;
+                if (env->arena[zi] == 0) zeros_o1++;
                 if (o2_trial[zi] == 0)   zeros_o2++;
             }
             if (zeros_o2 > zeros_o1) {
                 /* Order-2 wins — copy into arena and flag with DELTA+RLE */
-                memcpy(ctx->arena, o2_trial, src_size);
+                memcpy(env->arena, o2_trial, src_size);
                 pkt_flags |= NETC_PKT_FLAG_RLE; /* RLE reused as order-2 signal */
             }
         }
+
+        /* Byte planes (AD-021): transpose the map's wide-lane runs so the
+         * mostly-zero high bytes of the residuals sit together */
+        if (dict != NULL && dict->delta_planes.count > 0)
+            ctx->simd_ops.delta_planes_split(&dict->delta_planes, env->arena, src_size);
     }
 
     /* LZP XOR pre-filter: when the dictionary has a trained LZP table and
@@ -929,11 +1528,11 @@ netc_result_t netc_compress(
      * distribution for much better tANS compression.  The tANS tables in
      * the dictionary were retrained on LZP-filtered data during training. */
     if (!did_delta && dict != NULL && lzp_table != NULL &&
-        ctx->arena_size >= src_size)
+        env->arena_size >= src_size)
     {
-        netc_lzp_xor_filter((const uint8_t *)src, src_size,
-                            lzp_table, ctx->arena);
-        compress_src = ctx->arena;
+        netc_lzp_filter(&ctx->simd_ops, (const uint8_t *)src, src_size,
+                        lzp_table, lzp_ovl, lzp_order2, env->arena);
+        compress_src = env->arena;
         did_lzp      = 1;
     }
 
@@ -954,11 +1553,17 @@ netc_result_t netc_compress(
         /* Skip single-region comparison for pre-filtered data (delta residuals
          * or LZP XOR output).  Both have position-specific distributions where
          * PCTX dominates any single-region table.  Saves 4-10 trial encodes.
-         * FAST_COMPRESS extends this to all paths — PCTX always wins. */
-        if (did_delta || did_lzp || (ctx->flags & NETC_CFG_FLAG_FAST_COMPRESS))
+         * Levels below 5 (and FAST_COMPRESS) extend this to all paths. */
+        if (did_delta || did_lzp || !(trials & NETC_TRIAL_SR))
             tans_ctx_flags |= NETC_INTERNAL_SKIP_SR;
-
-        if (try_tans_compress(dict, tables, compress_src, src_size,
+        if (!(trials & NETC_TRIAL_BIGRAM))
+            tans_ctx_flags |= NETC_INTERNAL_NO_BIGRAM_PCTX;
+        if (trials & NETC_TRIAL_VERIFY2)
+            tans_ctx_flags |= NETC_INTERNAL_VERIFY2;
+        if (trials & NETC_TRIAL_RANS)
+            tans_ctx_flags |= NETC_INTERNAL_RANS;
+
+        if (try_tans_compress(dict, tables, bigram, compress_src, src_size,
                               payload, payload_cap,
                               &compressed_payload, &used_mreg, &used_x2, &tbl_idx,
                               tans_ctx_flags, compact_mode) == 0 &&
@@ -979,14 +1584,20 @@ netc_result_t netc_compress(
              * achieves ratio < 0.5 (compressed_payload < src_size/2), LZP is
              * unlikely to win — skip to save 1 LZP filter + 1 PCTX encode.
              * For ≤256B packets LZP is kept unconditional (predictions accurate
-             * at short range; WL-001/002/003 depend on this for ratio). */
+             * at short range; WL-001/002/003 depend on this for ratio).
+             * Level >= 7 drops the adaptive skip.
+             *
+             * The LZP candidate is only encoded when its cost-model
+             * prediction comes within NETC_EST_SLACK of the delta result
+             * (always under VERIFY2). */
             if (did_delta && lzp_table != NULL && src_size <= 512 &&
-                !(ctx->flags & NETC_CFG_FLAG_FAST_COMPRESS) &&
-                (src_size <= 256u || compressed_payload >= (src_size >> 1))) {
+                (trials & NETC_TRIAL_LZP) &&
+                (src_size <= 256u || compressed_payload >= (src_size >> 1) ||
+                 (trials & NETC_TRIAL_LZP_ALWAYS))) {
                 uint8_t lzp_trial_src[512];
                 uint8_t lzp_trial_dst[520];
-                netc_lzp_xor_filter((const uint8_t *)src, src_size,
-                                    lzp_table, lzp_trial_src);
+                netc_lzp_filter(&ctx->simd_ops, (const uint8_t *)src, src_size,
+                                lzp_table, lzp_ovl, lzp_order2, lzp_trial_src);
 
                 size_t  lzp_cp = 0;
                 int     lzp_mreg = 0, lzp_x2 = 0;
@@ -995,11 +1606,16 @@ netc_result_t netc_compress(
                  * via LZP+BIGRAM compact types (0x90-0xAF).
                  * Also skip SR comparison — LZP-filtered data is optimally
                  * encoded by PCTX (per-position tables trained on LZP output). */
-                uint32_t lzp_ctx = (ctx->flags
+                uint32_t lzp_ctx = (tans_ctx_flags
                     & ~(uint32_t)NETC_CFG_FLAG_DELTA)
                     | (compact_mode ? NETC_INTERNAL_NO_X2 : 0u)
                     | NETC_INTERNAL_SKIP_SR;
-                if (try_tans_compress(dict, tables, lzp_trial_src, src_size,
+                tans_plan_t lzp_plan;
+                tans_plan_rank(dict, tables, bigram, lzp_trial_src, src_size,
+                               lzp_ctx, compact_mode, &lzp_plan);
+                if ((est_bytes(lzp_plan.est[0]) <= compressed_payload + NETC_EST_SLACK ||
+                     (lzp_ctx & NETC_INTERNAL_VERIFY2)) &&
+                    try_tans_compress(dict, tables, bigram, lzp_trial_src, src_size,
                                       lzp_trial_dst, sizeof(lzp_trial_dst),
                                       &lzp_cp, &lzp_mreg, &lzp_x2, &lzp_tbl,
                                       lzp_ctx, compact_mode) == 0 &&
@@ -1030,23 +1646,24 @@ netc_result_t netc_compress(
              *   If LZ77 loses: re-run tANS into dst payload.
              *   Re-run cost is bounded: only attempted for small packets (≤1024B)
              *   where LZ77 probe is fast and tANS re-run is cheap. */
-            /* Skip LZ77 for small packets (<256B, or <512B in FAST_COMPRESS mode):
-             * hash table init (8KB) + scan overhead exceeds the ratio gain.
-             * FAST_COMPRESS raises the threshold to 512B for extra speed. */
+            /* Skip LZ77 for small packets (below the level's lz77_min: 512B
+             * at levels <= 3, 256B at the default level): hash table init
+             * (8KB) + scan overhead exceeds the ratio gain. */
             {
-            size_t lz77_min = (ctx->flags & NETC_CFG_FLAG_FAST_COMPRESS)
-                              ? 512u : 256u;
-            if (src_size >= lz77_min && compressed_payload * 2 > src_size) {
-                if (!did_delta && ctx->arena_size >= src_size) {
+            size_t lz77_min = ctx->plan.lz77_min;
+            if ((trials & NETC_TRIAL_LZ77) && src_size >= lz77_min &&
+                (compressed_payload * 2 > src_size ||
+                 (trials & NETC_TRIAL_LZ77_ALWAYS))) {
+                if (!did_delta && env->arena_size >= src_size) {
                     /* Case A: LZ77 into arena, tANS stays in dst payload.
                      * Always use raw src for LZ77 (not LZP-filtered data)
                      * since LZ77 packets don't carry LZP inverse info. */
                     size_t lz_len = lz77_encode((const uint8_t *)src, src_size,
-                                                ctx->arena, ctx->arena_size);
+                                                env->arena, env->arena_size);
                     if (lz_len < compressed_payload && lz_len < src_size &&
                         hdr_sz + lz_len <= dst_cap) {
                         /* LZ77 wins: copy from arena to dst payload */
-                        memcpy((uint8_t *)dst + hdr_sz, ctx->arena, lz_len);
+                        memcpy((uint8_t *)dst + hdr_sz, env->arena, lz_len);
                         netc_pkt_header_t hdr;
                         hdr.original_size   = (uint16_t)src_size;
                         hdr.compressed_size = (uint16_t)lz_len;
@@ -1066,7 +1683,7 @@ netc_result_t netc_compress(
                             ctx->stats.passthrough_count++;
                         }
                         netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-                        netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+                        netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
                         return NETC_OK;
                     }
                     /* LZ77 didn't beat tANS -- tANS payload in dst is still valid */
@@ -1130,7 +1747,7 @@ netc_result_t netc_compress(
                             ctx->stats.passthrough_count++;
                         }
                         netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-                        netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+                        netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
                         return NETC_OK;
                     }
                     /* LZ77 lost -- restore tANS output from stack */
@@ -1152,17 +1769,24 @@ case_b_skip:;
              * (c) data has low symbol diversity (≤4 distinct values in first
              *     32 bytes) — indicates repetitive/patterned data that likely
              *     has ring-buffer matches from earlier packets, even if the
-             *     immediately preceding packet differs (e.g. cycling patterns).
+             *     immediately preceding packet differs (e.g. cycling patterns), or
+             * (d) the match index finds 8-byte ring matches for 3 of 4 probes
+             *     (lz77x_probe) — an older packet repeats.
+             * Without any probe hit only within-packet refs are searched.
              * Gate on ≥64B to avoid overhead on tiny packets.
              * Encode raw src (not residuals) to use ring-buffer back-refs. */
-            if (ctx->ring != NULL && ctx->ring_size > 0 &&
+            if ((trials & NETC_TRIAL_LZ77X) &&
+                ctx->ring != NULL && ctx->ring_size > 0 &&
                 ctx->prev_pkt_size > 0 &&
                 src_size >= 64u &&
-                ctx->arena_size >= src_size)
+                env->arena_size >= src_size)
             {
                 /* Fast pre-check: skip expensive LZ77X if data is unlikely
-                 * to have cross-packet matches. */
-                int try_lzx = (compressed_payload * 2 > src_size); /* ratio > 0.5 */
+                 * to have cross-packet matches (level >= 8 always tries). */
+                unsigned hits = lz77x_probe(ctx, (const uint8_t *)src, src_size,
+                                            ctx->plan.lzx_depth);
+                int try_lzx = (compressed_payload * 2 > src_size) || /* ratio > 0.5 */
+                              (trials & NETC_TRIAL_LZ77X_ALWAYS) != 0;
                 if (!try_lzx && ctx->prev_pkt != NULL &&
                     ctx->prev_pkt_size == src_size)
                 {
@@ -1192,24 +1816,30 @@ case_b_skip:;
                     }
                     if (!diverse) try_lzx = 1;
                 }
+                /* (d) Older repeats: the index finds long ring matches */
+                if (!try_lzx) try_lzx = (hits + 1u >= LZ77X_PROBES);
 
                 if (try_lzx) {
-                    size_t lzx_len = lz77x_encode(
-                        (const uint8_t *)src, src_size,
-                        ctx->ring, ctx->ring_size, ctx->ring_pos,
-                        (uint32_t)ctx->prev_pkt_size,
-                        ctx->arena, ctx->arena_size);
-                    if (lzx_len != (size_t)-1 && lzx_len < compressed_payload &&
-                        lzx_len < src_size &&
+                    /* No probe hit: the chains would only find short, costly
+                     * matches, so keep to within-packet refs */
+                    uint32_t depth = (hits > 0 || (trials & NETC_TRIAL_LZ77X_ALWAYS))
+                                   ? ctx->plan.lzx_depth : 0u;
+                    uint8_t        lzx_alg;
+                    const uint8_t *lzx_out;
+                    size_t lzx_len = lz77x_trial(
+                        ctx, env, tables, lzp_table, lzp_ovl, lzp_order2,
+                        (const uint8_t *)src, src_size, depth, hits,
+                        compressed_payload, &lzx_alg, &lzx_out);
+                    if (lzx_len != 0 && lzx_len < src_size &&
                         hdr_sz + lzx_len <= dst_cap)
                     {
                         /* Cross-packet LZ77 wins */
-                        memcpy((uint8_t *)dst + hdr_sz, ctx->arena, lzx_len);
+                        memcpy((uint8_t *)dst + hdr_sz, lzx_out, lzx_len);
                         netc_pkt_header_t hdr;
                         hdr.original_size   = (uint16_t)src_size;
                         hdr.compressed_size = (uint16_t)lzx_len;
                         hdr.flags           = NETC_PKT_FLAG_DICT_ID;
-                        hdr.algorithm       = NETC_ALG_LZ77X;
+                        hdr.algorithm       = lzx_alg;
                         hdr.model_id        = dict->model_id;
                         hdr.context_seq     = seq;
                         netc_hdr_emit(dst, &hdr, compact_mode);
@@ -1222,7 +1852,7 @@ case_b_skip:;
                             ctx->stats.bytes_out += *dst_size;
                         }
                         netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-                        netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+                        netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
                         return NETC_OK;
                     }
                 }
@@ -1239,9 +1869,10 @@ case_b_skip:;
              *
              * Only try 10-bit when: single-region (used_mreg==0), no MREG/PCTX,
              * no LZP, no bigram, compact mode, and <=128B.
-             * The 10-bit table is built on-the-fly from the winning 12-bit table. */
+             * The 10-bit table is built on-the-fly from the winning 12-bit table,
+             * and only when its predicted size is competitive. */
             int used_tans_10 = 0;
-            if (src_size <= 128u &&
+            if ((trials & NETC_TRIAL_TANS10) && src_size <= 128u &&
                 used_mreg == 0 && !did_lzp &&
                 !(tans_ctx_flags & NETC_CFG_FLAG_BIGRAM) &&
                 compact_mode)
@@ -1249,7 +1880,9 @@ case_b_skip:;
                 /* Rescale the winning 12-bit freq table to 10-bit (1024-sum) */
                 const netc_tans_table_t *tbl12 = &tables[tbl_idx];
                 netc_freq_table_t freq10;
-                if (netc_freq_rescale_12_to_10(&tbl12->freq, &freq10) == 0) {
+                if (netc_freq_rescale_12_to_10(&tbl12->freq, &freq10) == 0 &&
+                    tans10_estimate(&freq10, compress_src, src_size)
+                        <= compressed_payload + NETC_EST_SLACK) {
                     netc_tans_table_10_t tbl10;
                     if (netc_tans_build_10(&tbl10, &freq10) == 0) {
                         uint8_t trial10[136]; /* 128B + 8B overhead max */
@@ -1267,11 +1900,13 @@ case_b_skip:;
                 }
             }
 
-            /* tANS wins.  used_mreg: 0=single-region, 1=MREG, 2=PCTX, 3=PCTX+BIGRAM.
+            /* tANS wins.  used_mreg: 0=single-region, 1=MREG, 2=PCTX, 3=PCTX+BIGRAM,
+             * 4=static rANS.
              * Single-region: encode table index in upper 4 bits of algorithm byte.
              * MREG: algorithm=NETC_ALG_TANS, flags|=MREG.
              * PCTX: algorithm=NETC_ALG_TANS_PCTX (per-position context).
              * PCTX+BIGRAM: algorithm=NETC_ALG_TANS_PCTX, flags|=BIGRAM.
+             * rANS: algorithm=NETC_ALG_RANS (| NETC_RANS_LZP).
              * 10-bit: algorithm=NETC_ALG_TANS_10 (adaptive small-packet). */
             int bigram_active = (used_mreg == 3) ||
                                 (used_mreg <= 1 && (tans_ctx_flags & NETC_CFG_FLAG_BIGRAM));
@@ -1284,17 +1919,19 @@ case_b_skip:;
             hdr.flags           = pkt_flags | extra_flags;
             if (used_tans_10) {
                 hdr.algorithm = (uint8_t)(NETC_ALG_TANS_10 | (tbl_idx << 4));
+            } else if (used_mreg == 4) {
+                hdr.algorithm = (uint8_t)(NETC_ALG_RANS | (did_lzp ? NETC_RANS_LZP : 0u));
             } else if (did_lzp) {
                 /* LZP XOR pre-filter was applied; signal decompressor to invert.
-                 * For PCTX/PCTX+BIGRAM: use NETC_ALG_TANS_PCTX | 0x10 (upper nibble marks LZP).
+                 * For PCTX/PCTX+BIGRAM: NETC_ALG_TANS_PCTX | NETC_PCTX_LZP.
                  * For single-region/MREG: algorithm = NETC_ALG_LZP. */
                 if (used_mreg == 2 || used_mreg == 3) {
-                    hdr.algorithm = NETC_ALG_TANS_PCTX | 0x10u;
+                    hdr.algorithm = pctx_algorithm(src_size, 1);
                 } else {
                     hdr.algorithm = (uint8_t)(NETC_ALG_LZP | ((used_mreg ? 0u : tbl_idx) << 4));
                 }
             } else if (used_mreg == 2 || used_mreg == 3) {
-                hdr.algorithm = NETC_ALG_TANS_PCTX;
+                hdr.algorithm = pctx_algorithm(src_size, 0);
             } else {
                 hdr.algorithm = (uint8_t)(NETC_ALG_TANS | ((used_mreg ? 0u : tbl_idx) << 4));
             }
@@ -1302,6 +1939,9 @@ case_b_skip:;
             hdr.context_seq     = seq;
             netc_hdr_emit(dst, &hdr, compact_mode);
             *dst_size = hdr_sz + compressed_payload;
+            if (used_mreg == 3)
+                compress_bigram_feed(ctx, env, (const uint8_t *)src, src_size,
+                                     pkt_flags, did_lzp, lzp_table, lzp_ovl);
             ctx_ring_append(ctx, (const uint8_t *)src, src_size);
             compress_update_prev(ctx, src, src_size);
             if (ctx->flags & NETC_CFG_FLAG_STATS) {
@@ -1310,7 +1950,7 @@ case_b_skip:;
                 ctx->stats.bytes_out += *dst_size;
             }
             netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
             return NETC_OK;
         }
     }
@@ -1318,7 +1958,8 @@ case_b_skip:;
     /* --- tANS-raw fallback: if delta was applied but tANS on residuals failed,
      * try tANS on the original (raw) bytes instead.  This helps when the delta
      * residuals have higher entropy than the raw bytes (e.g. random sequences). */
-    if (did_delta && dict != NULL && src_size > 0) {
+    if (did_delta && (trials & NETC_TRIAL_RAW_RETRY) &&
+        dict != NULL && src_size > 0) {
         size_t payload_cap = dst_cap - hdr_sz;
         uint8_t *payload   = (uint8_t *)dst + hdr_sz;
         size_t  raw_payload = 0;
@@ -1327,22 +1968,30 @@ case_b_skip:;
         uint32_t raw_tbl   = 0;
 
         uint32_t raw_ctx_flags = ctx->flags & ~(uint32_t)NETC_CFG_FLAG_DELTA;
+        if (!(trials & NETC_TRIAL_SR))
+            raw_ctx_flags |= NETC_INTERNAL_SKIP_SR;
+        if (!(trials & NETC_TRIAL_BIGRAM))
+            raw_ctx_flags |= NETC_INTERNAL_NO_BIGRAM_PCTX;
+        if (trials & NETC_TRIAL_VERIFY2)
+            raw_ctx_flags |= NETC_INTERNAL_VERIFY2;
+        if (trials & NETC_TRIAL_RANS)
+            raw_ctx_flags |= NETC_INTERNAL_RANS;
         /* When LZP table is available, apply XOR pre-filter to raw bytes
          * before re-trying tANS (reuses arena since delta residuals are
          * no longer needed in this fallback path). */
         const uint8_t *raw_src = (const uint8_t *)src;
         int fallback_lzp = 0;
-        if (lzp_table != NULL && ctx->arena_size >= src_size) {
-            netc_lzp_xor_filter((const uint8_t *)src, src_size,
-                                lzp_table, ctx->arena);
-            raw_src = ctx->arena;
+        if (lzp_table != NULL && env->arena_size >= src_size) {
+            netc_lzp_filter(&ctx->simd_ops, (const uint8_t *)src, src_size,
+                            lzp_table, lzp_ovl, lzp_order2, env->arena);
+            raw_src = env->arena;
             fallback_lzp = 1;
             /* Suppress X2 for LZP compact (no LZP+X2 type).
              * BIGRAM is supported via 0x90-0xAF compact types. */
             if (compact_mode)
                 raw_ctx_flags |= NETC_INTERNAL_NO_X2;
         }
-        if (try_tans_compress(dict, tables, raw_src, src_size,
+        if (try_tans_compress(dict, tables, bigram, raw_src, src_size,
                               payload, payload_cap,
                               &raw_payload, &raw_mreg, &raw_x2, &raw_tbl,
                               raw_ctx_flags, compact_mode) == 0 &&
@@ -1351,11 +2000,15 @@ case_b_skip:;
             /* Cross-packet LZ77X competition on the raw-tANS fallback path.
              * Arena held delta residuals but those are no longer needed — we
              * can reuse it as LZ77X output buffer. */
-            if (ctx->ring != NULL && ctx->ring_size > 0 &&
+            if ((trials & NETC_TRIAL_LZ77X) &&
+                ctx->ring != NULL && ctx->ring_size > 0 &&
                 ctx->prev_pkt_size > 0 && src_size >= 64u &&
-                ctx->arena_size >= src_size)
+                env->arena_size >= src_size)
             {
-                int try_lzx = (raw_payload * 2 > src_size);
+                unsigned hits = lz77x_probe(ctx, (const uint8_t *)src, src_size,
+                                            ctx->plan.lzx_depth);
+                int try_lzx = (raw_payload * 2 > src_size) ||
+                              (trials & NETC_TRIAL_LZ77X_ALWAYS) != 0;
                 if (!try_lzx && ctx->prev_pkt != NULL &&
                     ctx->prev_pkt_size == src_size)
                 {
@@ -1384,23 +2037,26 @@ case_b_skip:;
                     }
                     if (!diverse) try_lzx = 1;
                 }
+                if (!try_lzx) try_lzx = (hits + 1u >= LZ77X_PROBES);
                 if (try_lzx) {
-                    size_t lzx_len = lz77x_encode(
-                        (const uint8_t *)src, src_size,
-                        ctx->ring, ctx->ring_size, ctx->ring_pos,
-                        (uint32_t)ctx->prev_pkt_size,
-                        ctx->arena, ctx->arena_size);
-                    if (lzx_len != (size_t)-1 && lzx_len < raw_payload &&
-                        lzx_len < src_size &&
+                    uint32_t depth = (hits > 0 || (trials & NETC_TRIAL_LZ77X_ALWAYS))
+                                   ? ctx->plan.lzx_depth : 0u;
+                    uint8_t        lzx_alg;
+                    const uint8_t *lzx_out;
+                    size_t lzx_len = lz77x_trial(
+                        ctx, env, tables, lzp_table, lzp_ovl, lzp_order2,
+                        (const uint8_t *)src, src_size, depth, hits,
+                        raw_payload, &lzx_alg, &lzx_out);
+                    if (lzx_len != 0 && lzx_len < src_size &&
                         hdr_sz + lzx_len <= dst_cap)
                     {
                         /* LZ77X beats raw tANS — emit */
-                        memcpy(payload, ctx->arena, lzx_len);
+                        memcpy(payload, lzx_out, lzx_len);
                         netc_pkt_header_t hdr;
                         hdr.original_size   = (uint16_t)src_size;
                         hdr.compressed_size = (uint16_t)lzx_len;
                         hdr.flags           = NETC_PKT_FLAG_DICT_ID;
-                        hdr.algorithm       = NETC_ALG_LZ77X;
+                        hdr.algorithm       = lzx_alg;
                         hdr.model_id        = dict->model_id;
                         hdr.context_seq     = seq;
                         netc_hdr_emit(dst, &hdr, compact_mode);
@@ -1413,7 +2069,7 @@ case_b_skip:;
                             ctx->stats.bytes_out += *dst_size;
                         }
                         netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-                        netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+                        netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
                         return NETC_OK;
                     }
                 }
@@ -1421,14 +2077,16 @@ case_b_skip:;
 
             /* --- 10-bit tANS competition for raw-tANS fallback (small packets) --- */
             int raw_tans_10 = 0;
-            if (src_size <= 128u &&
+            if ((trials & NETC_TRIAL_TANS10) && src_size <= 128u &&
                 raw_mreg == 0 && !fallback_lzp &&
                 !(raw_ctx_flags & NETC_CFG_FLAG_BIGRAM) &&
                 compact_mode)
             {
                 const netc_tans_table_t *tbl12 = &tables[raw_tbl];
                 netc_freq_table_t freq10;
-                if (netc_freq_rescale_12_to_10(&tbl12->freq, &freq10) == 0) {
+                if (netc_freq_rescale_12_to_10(&tbl12->freq, &freq10) == 0 &&
+                    tans10_estimate(&freq10, raw_src, src_size)
+                        <= raw_payload + NETC_EST_SLACK) {
                     netc_tans_table_10_t tbl10;
                     if (netc_tans_build_10(&tbl10, &freq10) == 0) {
                         uint8_t trial10[136];
@@ -1457,14 +2115,16 @@ case_b_skip:;
             hdr.flags           = NETC_PKT_FLAG_DICT_ID | extra_flags;
             if (raw_tans_10) {
                 hdr.algorithm = (uint8_t)(NETC_ALG_TANS_10 | (raw_tbl << 4));
+            } else if (raw_mreg == 4) {
+                hdr.algorithm = (uint8_t)(NETC_ALG_RANS | (fallback_lzp ? NETC_RANS_LZP : 0u));
             } else if (fallback_lzp) {
                 if (raw_mreg == 2 || raw_mreg == 3) {
-                    hdr.algorithm = NETC_ALG_TANS_PCTX | 0x10u;
+                    hdr.algorithm = pctx_algorithm(src_size, 1);
                 } else {
                     hdr.algorithm = (uint8_t)(NETC_ALG_LZP | ((raw_mreg ? 0u : raw_tbl) << 4));
                 }
             } else if (raw_mreg == 2 || raw_mreg == 3) {
-                hdr.algorithm = NETC_ALG_TANS_PCTX;
+                hdr.algorithm = pctx_algorithm(src_size, 0);
             } else {
                 hdr.algorithm = (uint8_t)(NETC_ALG_TANS | ((raw_mreg ? 0u : raw_tbl) << 4));
             }
@@ -1472,6 +2132,9 @@ case_b_skip:;
             hdr.context_seq     = seq;
             netc_hdr_emit(dst, &hdr, compact_mode);
             *dst_size = hdr_sz + raw_payload;
+            if (raw_mreg == 3)
+                compress_bigram_feed(ctx, env, (const uint8_t *)src, src_size,
+                                     0, fallback_lzp, lzp_table, lzp_ovl);
             ctx_ring_append(ctx, (const uint8_t *)src, src_size);
             compress_update_prev(ctx, src, src_size);
             if (ctx->flags & NETC_CFG_FLAG_STATS) {
@@ -1480,7 +2143,7 @@ case_b_skip:;
                 ctx->stats.bytes_out += *dst_size;
             }
             netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
             return NETC_OK;
         }
     }
@@ -1492,7 +2155,7 @@ case_b_skip:;
      * content is no longer delta residuals.  Reset to use raw src bytes and
      * clear the DELTA flag so LZ77/passthrough don't assume delta encoding. */
     if (did_delta && dict != NULL && lzp_table != NULL &&
-        ctx->arena_size >= src_size)
+        env->arena_size >= src_size)
     {
         compress_src = (const uint8_t *)src;
         pkt_flags   &= ~(uint8_t)(NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE);
@@ -1509,7 +2172,8 @@ case_b_skip:;
         size_t   lz_len      = (size_t)-1;
         uint8_t  lz_alg      = NETC_ALG_PASSTHRU;
 
-        /* Within-packet LZ77 (always tried first).
+        /* Within-packet LZ77 (always tried first, at every level: this is
+         * the fallback, not a competing trial).
          * Use raw bytes (not LZP-filtered) since LZ77 packets don't carry
          * LZP inverse info.  When did_delta, compress_src is delta residuals
          * and the DELTA flag propagates to the LZ77 packet (correct). */
@@ -1528,13 +2192,14 @@ case_b_skip:;
          * IMPORTANT: always encode raw src bytes (never delta residuals) so
          * the decoder does not need to apply an inverse delta pass. */
         if (lz_len == (size_t)-1 &&
+            (trials & NETC_TRIAL_LZ77X) &&
             src_size >= 64u &&
             ctx->ring != NULL && ctx->ring_size > 0 &&
             ctx->prev_pkt_size > 0)
         {
             size_t lz_x = lz77x_encode((const uint8_t *)src, src_size,
                                         ctx->ring, ctx->ring_size, ctx->ring_pos,
-                                        (uint32_t)ctx->prev_pkt_size,
+                                        &ctx->lzx, ctx->plan.lzx_depth,
                                         out_payload, out_cap);
             if (lz_x != (size_t)-1 && lz_x < src_size) {
                 lz_len = lz_x;
@@ -1577,7 +2242,7 @@ case_b_skip:;
                 ctx->stats.passthrough_count++;
             }
             netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
             return NETC_OK;
         }
     }
@@ -1595,12 +2260,277 @@ lz77_failed:
                                                dst_size, seq, compact_mode);
         if (pt_r == NETC_OK) {
             netc_adaptive_update(ctx, (const uint8_t *)src, src_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)src, src_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)src, src_size);
         }
         return pt_r;
     }
 }
 
+/* =========================================================================
+ * compress_packet_baseline — NETC_CFG_FLAG_BASELINE path (AD-023)
+ *
+ * The packet is coded against the newest acknowledged packet, if that is
+ * at most NETC_BASELINE_WINDOW packets old and of the same size, else with
+ * no delta reference.  A delta packet appends its baseline's sequence
+ * number; in compact mode every packet then appends its own, which the
+ * legacy header already carries as context_seq.  Trailer layout:
+ * [baseline seq, DELTA only][packet seq, compact only].  The compact
+ * header is at most 4 bytes and a delta payload is smaller than the
+ * input, so the trailer stays within netc_compress_bound.
+ * ========================================================================= */
+
+static netc_result_t compress_packet_baseline(
+    netc_ctx_t           *ctx,
+    const compress_env_t *env,
+    const void           *src,
+    size_t                src_size,
+    void                 *dst,
+    size_t                dst_cap,
+    size_t               *dst_size)
+{
+    if (NETC_UNLIKELY(netc_ctx_reserve_history(ctx, src_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    const uint8_t seq = ctx->context_seq;
+    /* Drop an ack once it leaves the window, before its 8-bit sequence
+     * number can come round to a packet the receiver has not acked */
+    if (ctx->base_acked &&
+        (uint8_t)(seq - ctx->base_ack) > NETC_BASELINE_WINDOW) {
+        ctx->base_acked = 0;
+    }
+    netc_ctx_base_load(ctx, ctx->base_acked
+        ? netc_ctx_base_find(ctx, ctx->base_ack, src_size) : -1);
+
+    netc_result_t r = compress_packet_body(ctx, env, src, src_size,
+                                           dst, dst_cap, dst_size);
+    if (NETC_UNLIKELY(r != NETC_OK)) {
+        return r;
+    }
+
+    netc_pkt_header_t hdr;
+    hdr.flags = 0;
+    if (env->compact_mode) {
+        (void)netc_hdr_read_compact(dst, *dst_size, &hdr);
+    } else {
+        netc_hdr_read(dst, &hdr);
+    }
+    uint8_t trailer[2];
+    size_t  n = 0;
+    if (hdr.flags & NETC_PKT_FLAG_DELTA) trailer[n++] = ctx->base_ack;
+    if (env->compact_mode)               trailer[n++] = seq;
+    if (NETC_UNLIKELY(dst_cap - *dst_size < n)) {
+        return NETC_ERR_BUF_SMALL;
+    }
+    memcpy((uint8_t *)dst + *dst_size, trailer, n);
+    *dst_size += n;
+    if (ctx->flags & NETC_CFG_FLAG_STATS) {
+        ctx->stats.bytes_out += n;
+    }
+    netc_ctx_base_commit(ctx, seq);
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * compress_packet — single-packet path shared by netc_compress and
+ * netc_compress_batch.  Arguments are validated by the caller.
+ *
+ * With NETC_CFG_FLAG_DELTA_REFS (AD-022) the delta reference is picked
+ * among the same-size packets of the reference history by equal-byte count.
+ * When there were two or more to pick from and the packet came out
+ * delta-coded, the candidate's index is appended as a one-byte trailer;
+ * every codec path keeps its payload offsets.  A delta packet's payload is
+ * smaller than the input, so the trailer stays within netc_compress_bound.
+ * ========================================================================= */
+
+static netc_result_t compress_packet(
+    netc_ctx_t           *ctx,
+    const compress_env_t *env,
+    const void           *src,
+    size_t                src_size,
+    void                 *dst,
+    size_t                dst_cap,
+    size_t               *dst_size)
+{
+    if (ctx->flags & NETC_CFG_FLAG_BASELINE) {
+        return compress_packet_baseline(ctx, env, src, src_size, dst, dst_cap, dst_size);
+    }
+    if (!(ctx->flags & NETC_CFG_FLAG_DELTA_REFS) || src_size == 0) {
+        return compress_packet_body(ctx, env, src, src_size, dst, dst_cap, dst_size);
+    }
+    if (NETC_UNLIKELY(netc_ctx_reserve_history(ctx, src_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    uint8_t  cand[NETC_DELTA_REFS];
+    uint32_t n_cand = netc_ctx_ref_candidates(ctx, src_size, cand);
+    uint32_t pick   = 0;
+    if (n_cand >= 2) {
+        uint32_t best = ctx->simd_ops.match_count(ctx->ref_pkt[cand[0]],
+                                                  (const uint8_t *)src, src_size);
+        for (uint32_t k = 1; k < n_cand && best < src_size; k++) {
+            uint32_t m = ctx->simd_ops.match_count(ctx->ref_pkt[cand[k]],
+                                                   (const uint8_t *)src, src_size);
+            if (m > best) {
+                best = m;
+                pick = k;
+            }
+        }
+    }
+    netc_ctx_ref_load(ctx, (n_cand > 0) ? cand[pick] : 0);
+
+    netc_result_t r = compress_packet_body(ctx, env, src, src_size,
+                                           dst, dst_cap, dst_size);
+    if (NETC_UNLIKELY(r != NETC_OK)) {
+        return r;
+    }
+
+    netc_pkt_header_t hdr;
+    hdr.flags = 0;
+    if (env->compact_mode) {
+        (void)netc_hdr_read_compact(dst, *dst_size, &hdr);
+    } else {
+        netc_hdr_read(dst, &hdr);
+    }
+    const int delta = (hdr.flags & NETC_PKT_FLAG_DELTA) != 0;
+    if (!delta && pick != 0 && ctx->prev2_pkt != NULL) {
+        /* No index on the wire: the decoder loaded cand[0], which the
+         * history rotation has just moved to prev2 */
+        memcpy(ctx->prev2_pkt, ctx->ref_pkt[cand[0]], src_size);
+    }
+    if (delta && n_cand >= 2) {
+        if (NETC_UNLIKELY(*dst_size >= dst_cap)) {
+            return NETC_ERR_BUF_SMALL;
+        }
+        ((uint8_t *)dst)[(*dst_size)++] = (uint8_t)pick;
+        if (ctx->flags & NETC_CFG_FLAG_STATS) {
+            ctx->stats.bytes_out++;
+        }
+    }
+    netc_ctx_ref_commit(ctx);
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * netc_compress / netc_compress_ex — stateful context path
+ * ========================================================================= */
+
+netc_result_t netc_compress(
+    netc_ctx_t *ctx,
+    const void *src,
+    size_t      src_size,
+    void       *dst,
+    size_t      dst_cap,
+    size_t     *dst_size)
+{
+    return netc_compress_ex(ctx, NULL, src, src_size, dst, dst_cap, dst_size);
+}
+
+netc_result_t netc_compress_ex(
+    netc_ctx_t     *ctx,
+    netc_scratch_t *scratch,
+    const void     *src,
+    size_t          src_size,
+    void           *dst,
+    size_t          dst_cap,
+    size_t         *dst_size)
+{
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (NETC_UNLIKELY(src == NULL || dst == NULL || dst_size == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    if (NETC_UNLIKELY(src_size > NETC_MAX_PACKET_SIZE)) {
+        return NETC_ERR_TOOBIG;
+    }
+    if (NETC_UNLIKELY(dst_cap < NETC_COMPACT_HDR_MIN)) {
+        return NETC_ERR_BUF_SMALL;
+    }
+
+    compress_env_t env;
+    compress_env_init(ctx, &env);
+    if (scratch != NULL) {
+        env.arena      = scratch->arena;
+        env.arena_size = scratch->arena_size;
+    }
+    if (NETC_UNLIKELY(env.arena == NULL)) {
+        return NETC_ERR_INVALID_ARG;  /* EXTERNAL_SCRATCH context, no scratch */
+    }
+    return compress_packet(ctx, &env, src, src_size, dst, dst_cap, dst_size);
+}
+
+/* =========================================================================
+ * netc_compress_batch — many packets, one context, one output arena
+ *
+ * Argument checks, the header mode and the arena are resolved once for the
+ * whole batch (compress_env_t); the tables are looked up per packet. The
+ * loop body is the same per-packet path as netc_compress, so the output for
+ * packet i is bit-identical to calling netc_compress on the same sequence.
+ * Packets are written back-to-back into dst; offsets[i] is the start of
+ * packet i and offsets[count] the total number of bytes written.
+ * ========================================================================= */
+
+netc_result_t netc_compress_batch(
+    netc_ctx_t        *ctx,
+    const void *const *srcs,
+    const size_t      *src_sizes,
+    size_t             count,
+    void              *dst,
+    size_t             dst_cap,
+    size_t            *offsets,
+    size_t            *n_done)
+{
+    if (n_done != NULL) *n_done = 0;
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (NETC_UNLIKELY(offsets == NULL ||
+                      (count > 0 && (srcs == NULL || src_sizes == NULL ||
+                                     dst == NULL)))) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    compress_env_t env;
+    compress_env_init(ctx, &env);
+    if (NETC_UNLIKELY(env.arena == NULL)) {
+        return NETC_ERR_INVALID_ARG;  /* EXTERNAL_SCRATCH context */
+    }
+
+    uint8_t *out = (uint8_t *)dst;
+    size_t   pos = 0;
+    offsets[0] = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const void *src      = srcs[i];
+        size_t      src_size = src_sizes[i];
+
+        if (NETC_UNLIKELY(src == NULL)) {
+            return NETC_ERR_INVALID_ARG;
+        }
+        if (NETC_UNLIKELY(src_size > NETC_MAX_PACKET_SIZE)) {
+            return NETC_ERR_TOOBIG;
+        }
+        if (NETC_UNLIKELY(dst_cap - pos < NETC_COMPACT_HDR_MIN)) {
+            return NETC_ERR_BUF_SMALL;
+        }
+        if (i + 1 < count) {
+            NETC_PREFETCH(srcs[i + 1]);
+        }
+
+        size_t written = 0;
+        netc_result_t r = compress_packet(ctx, &env, src, src_size,
+                                          out + pos, dst_cap - pos, &written);
+        if (NETC_UNLIKELY(r != NETC_OK)) {
+            return r;
+        }
+        pos += written;
+        offsets[i + 1] = pos;
+        if (n_done != NULL) *n_done = i + 1;
+    }
+    return NETC_OK;
+}
+
 /* =========================================================================
  * netc_compress_stateless
  * ========================================================================= */
@@ -1638,14 +2568,14 @@ netc_result_t netc_compress_stateless(
         const uint8_t *tans_src = (const uint8_t *)src;
         int sl_did_lzp = 0;
         uint8_t lzp_filt_buf[1024];
-        if (dict != NULL && dict->lzp_table != NULL && src_size <= 1024) {
-            netc_lzp_xor_filter((const uint8_t *)src, src_size,
-                                dict->lzp_table, lzp_filt_buf);
+        if (dict != NULL && dict->lzp_table.ent != NULL && src_size <= 1024) {
+            dict->simd_ops.lzp_filter(&dict->lzp_table, netc_lzp_order2(dict),
+                                      (const uint8_t *)src, lzp_filt_buf, src_size);
             tans_src = lzp_filt_buf;
             sl_did_lzp = 1;
         }
 
-        int tans_ok = (try_tans_compress(dict, dict->tables, tans_src, src_size,
+        int tans_ok = (try_tans_compress(dict, dict->tables, &dict->bigram_set, tans_src, src_size,
                                          payload, payload_cap,
                                          &compressed_payload, &used_mreg, &used_x2,
                                          &tbl_idx,
@@ -1688,12 +2618,12 @@ netc_result_t netc_compress_stateless(
             hdr.flags           = NETC_PKT_FLAG_DICT_ID | extra_flags;
             if (sl_did_lzp) {
                 if (used_mreg == 2) {
-                    hdr.algorithm = NETC_ALG_TANS_PCTX | 0x10u;
+                    hdr.algorithm = pctx_algorithm(src_size, 1);
                 } else {
                     hdr.algorithm = (uint8_t)(NETC_ALG_LZP | ((used_mreg ? 0u : tbl_idx) << 4));
                 }
             } else if (used_mreg == 2) {
-                hdr.algorithm = NETC_ALG_TANS_PCTX;
+                hdr.algorithm = pctx_algorithm(src_size, 0);
             } else {
                 hdr.algorithm = (uint8_t)(NETC_ALG_TANS | ((used_mreg ? 0u : tbl_idx) << 4));
             }
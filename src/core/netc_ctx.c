@@ -2,10 +2,13 @@
  * netc_ctx.c — Context lifecycle management.
  *
  * Implements netc_ctx_create, netc_ctx_destroy, netc_ctx_reset, netc_ctx_stats,
- * netc_strerror, and netc_version.
+ * netc_ctx_memory_usage, netc_ack, netc_ctx_last_seq, netc_scratch_create/
+ * destroy, netc_strerror, and netc_version, plus the lazy allocation of
+ * per-context history buffers.
  */
 
 #include "netc_internal.h"
+#include "../algo/netc_adaptive.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -18,9 +21,45 @@ static const netc_cfg_t NETC_CFG_DEFAULT = {
     .ring_buffer_size  = 0,  /* 0 → use NETC_DEFAULT_RING_SIZE */
     .compression_level = 5,
     .simd_level        = 0,  /* 0 → auto-detect */
+    .adaptive_decay    = 0,  /* 0 → NETC_ADAPTIVE_DECAY_DEFAULT */
     .arena_size        = 0,  /* 0 → use NETC_DEFAULT_ARENA_SIZE */
+    .arena             = NULL, /* private arena */
 };
 
+/* =========================================================================
+ * netc_level_plan_init
+ * ========================================================================= */
+
+void netc_level_plan_init(netc_level_plan_t *plan, uint8_t level, uint32_t flags) {
+    if (level > NETC_LEVEL_MAX) level = NETC_LEVEL_MAX;
+    if ((flags & NETC_CFG_FLAG_FAST_COMPRESS) && level > NETC_LEVEL_FAST)
+        level = NETC_LEVEL_FAST;
+
+    uint32_t t = 0;
+    if (level >= 1) t |= NETC_TRIAL_ORDER2 | NETC_TRIAL_RAW_RETRY;
+    if (level >= 2) t |= NETC_TRIAL_BIGRAM | NETC_TRIAL_LZ77X;
+    if (level >= 3) t |= NETC_TRIAL_LZ77 | NETC_TRIAL_TANS10 | NETC_TRIAL_LZX_TANS;
+    if (level >= 4) t |= NETC_TRIAL_LZP;
+    if (level >= 5) t |= NETC_TRIAL_SR;
+    /* rANS tables are static: adaptive contexts keep to their own tANS
+     * tables, including before the first rebuild while they share the
+     * dict's */
+    if (level >= 6 && !(flags & NETC_CFG_FLAG_ADAPTIVE)) t |= NETC_TRIAL_RANS;
+    if (level >= 7) t |= NETC_TRIAL_LZP_ALWAYS | NETC_TRIAL_VERIFY2;
+    if (level >= 8) t |= NETC_TRIAL_LZ77X_ALWAYS;
+    if (level >= 9) t |= NETC_TRIAL_LZ77_ALWAYS;
+    plan->trials = t;
+
+    plan->lz77_min = (level <= 3) ? 512u
+                   : (level <= 5) ? 256u
+                   : (level <= 8) ? 128u
+                   : 64u;
+    plan->lzx_depth = (level <= 3) ? 2u
+                    : (level <= 5) ? 4u
+                    : (level <= 8) ? 16u
+                    : 64u;
+}
+
 /* =========================================================================
  * netc_ctx_create
  * ========================================================================= */
@@ -37,101 +76,235 @@ netc_ctx_t *netc_ctx_create(const netc_dict_t *dict, const netc_cfg_t *cfg) {
 
     ctx->dict              = dict;
     ctx->flags             = cfg->flags;
+    /* The reference history extends stateful delta; without both it is inert */
+    if ((ctx->flags & (NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA)) !=
+        (NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA)) {
+        ctx->flags &= ~(uint32_t)(NETC_CFG_FLAG_DELTA_REFS | NETC_CFG_FLAG_BASELINE);
+    }
+    if (ctx->flags & NETC_CFG_FLAG_BASELINE) {
+        /* Baselines replace in-order history: adaptive tables and the
+         * reference history would diverge on the first lost packet, and
+         * LZ77X would reference bytes the receiver may not have */
+        if (ctx->flags & (NETC_CFG_FLAG_ADAPTIVE | NETC_CFG_FLAG_DELTA_REFS)) {
+            free(ctx);
+            return NULL;
+        }
+        ctx->flags |= NETC_CFG_FLAG_NO_LZ77X;
+    }
     ctx->compression_level = cfg->compression_level;
     ctx->simd_level        = cfg->simd_level;
     ctx->context_seq       = 0;
+    netc_level_plan_init(&ctx->plan, cfg->compression_level, ctx->flags);
 
     /* Initialize SIMD dispatch table (auto-detects best available path) */
     netc_simd_ops_init(&ctx->simd_ops, (uint8_t)cfg->simd_level);
 
-    /* Allocate ring buffer for stateful mode (cross-packet history) */
-    if (cfg->flags & NETC_CFG_FLAG_STATEFUL) {
+    /* Ring buffer for cross-packet LZ77X history (stateful only).  Allocated
+     * now if the compressor may try LZ77X, else on the first decompress. */
+    if ((ctx->flags & NETC_CFG_FLAG_STATEFUL) &&
+        !(ctx->flags & NETC_CFG_FLAG_NO_LZ77X)) {
         ctx->ring_size = (cfg->ring_buffer_size > 0)
             ? (uint32_t)cfg->ring_buffer_size
             : (uint32_t)NETC_DEFAULT_RING_SIZE;
-        ctx->ring = (uint8_t *)calloc(1, ctx->ring_size);
-        if (NETC_UNLIKELY(ctx->ring == NULL)) {
+        if ((ctx->plan.trials & NETC_TRIAL_LZ77X) &&
+            netc_ctx_alloc_ring(ctx) != NETC_OK) {
             free(ctx);
             return NULL;
         }
     }
 
-    /* Allocate working memory arena */
-    ctx->arena_size = (cfg->arena_size > 0)
-        ? cfg->arena_size
-        : NETC_DEFAULT_ARENA_SIZE;
-    ctx->arena = (uint8_t *)malloc(ctx->arena_size);
-    if (NETC_UNLIKELY(ctx->arena == NULL)) {
-        free(ctx->ring);
-        free(ctx);
-        return NULL;
-    }
-
-    /* Allocate previous-packet buffer for delta prediction (stateful only) */
-    if (cfg->flags & NETC_CFG_FLAG_STATEFUL) {
-        ctx->prev_pkt = (uint8_t *)calloc(1, NETC_MAX_PACKET_SIZE);
-        if (NETC_UNLIKELY(ctx->prev_pkt == NULL)) {
-            free(ctx->arena);
+    /* Working memory arena: per call (netc_scratch_t), borrowed from the
+     * caller, or private */
+    if (cfg->flags & NETC_CFG_FLAG_EXTERNAL_SCRATCH) {
+        ctx->arena       = NULL;
+        ctx->arena_size  = 0;
+        ctx->arena_owned = 0;
+    } else if (cfg->arena != NULL) {
+        if (cfg->arena_size == 0) {
             free(ctx->ring);
             free(ctx);
             return NULL;
         }
+        ctx->arena       = (uint8_t *)cfg->arena;
+        ctx->arena_size  = cfg->arena_size;
+        ctx->arena_owned = 0;
+    } else {
+        ctx->arena_size = (cfg->arena_size > 0)
+            ? cfg->arena_size
+            : NETC_DEFAULT_ARENA_SIZE;
+        ctx->arena = (uint8_t *)malloc(ctx->arena_size);
+        if (NETC_UNLIKELY(ctx->arena == NULL)) {
+            free(ctx->ring);
+            free(ctx);
+            return NULL;
+        }
+        ctx->arena_owned = 1;
     }
+
+    /* Delta history (prev_pkt, prev2_pkt in adaptive mode, ref_pkt[] with
+     * DELTA_REFS, base_pkt[] with BASELINE) starts empty and grows to the
+     * largest packet seen (netc_ctx_grow_history) */
     ctx->prev_pkt_size = 0;
 
     /* Allocate adaptive mode state (frequency accumulators + mutable tables) */
     if (cfg->flags & NETC_CFG_FLAG_ADAPTIVE) {
         if (!(cfg->flags & NETC_CFG_FLAG_STATEFUL)) {
             /* Adaptive requires stateful mode */
-            free(ctx->prev_pkt);
-            free(ctx->arena);
+            if (ctx->arena_owned) free(ctx->arena);
             free(ctx->ring);
             free(ctx);
             return NULL;
         }
         ctx->adapt_freq = (uint32_t *)calloc(NETC_CTX_COUNT * 256, sizeof(uint32_t));
         ctx->adapt_total = (uint32_t *)calloc(NETC_CTX_COUNT, sizeof(uint32_t));
-        ctx->adapt_tables = (netc_tans_table_t *)calloc(NETC_CTX_COUNT, sizeof(netc_tans_table_t));
-        /* Order-2 delta: allocate prev2_pkt for linear extrapolation */
-        ctx->prev2_pkt = (uint8_t *)calloc(1, NETC_MAX_PACKET_SIZE);
+        /* Order-2 delta: prev2_pkt grows together with prev_pkt */
         ctx->prev2_pkt_size = 0;
-        if (!ctx->adapt_freq || !ctx->adapt_total || !ctx->adapt_tables || !ctx->prev2_pkt) {
-            free(ctx->prev2_pkt);
-            free(ctx->adapt_tables);
+        if (!ctx->adapt_freq || !ctx->adapt_total) {
             free(ctx->adapt_total);
             free(ctx->adapt_freq);
-            free(ctx->prev_pkt);
-            free(ctx->arena);
+            if (ctx->arena_owned) free(ctx->arena);
             free(ctx->ring);
             free(ctx);
             return NULL;
         }
-        /* Clone initial tables from dict so first packets can encode/decode */
-        if (dict) {
-            memcpy(ctx->adapt_tables, dict->tables, NETC_CTX_COUNT * sizeof(netc_tans_table_t));
-            /* Clone LZP table if present in dict */
-            if (dict->lzp_table != NULL) {
-                ctx->adapt_lzp = (netc_lzp_entry_t *)malloc(
-                    NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
-                if (ctx->adapt_lzp != NULL) {
-                    memcpy(ctx->adapt_lzp, dict->lzp_table,
-                           NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
-                    /* Boost dict entries to confidence 4 so they survive a few
-                     * misses before being replaced by adaptive updates. */
-                    for (uint32_t j = 0; j < NETC_LZP_HT_SIZE; j++) {
-                        if (ctx->adapt_lzp[j].valid)
-                            ctx->adapt_lzp[j].valid = 4;
-                    }
-                }
+        /* The dict tANS and LZP tables are shared copy-on-write: the first
+         * rebuild allocates adapt_tables, and LZP updates start in a sparse
+         * overlay over dict->lzp_table (netc_adaptive_reserve) */
+        ctx->adapt_lzp_ovl.base = netc_dict_lzp(dict);
+        ctx->adapt_pkt_count = 0;
+        ctx->adapt_decay = (cfg->adaptive_decay == 0)
+            ? (uint8_t)NETC_ADAPTIVE_DECAY_DEFAULT
+            : (cfg->adaptive_decay == NETC_ADAPTIVE_DECAY_NONE)
+                ? 0U
+                : (uint8_t)((cfg->adaptive_decay > NETC_ADAPTIVE_DECAY_MAX)
+                            ? NETC_ADAPTIVE_DECAY_MAX : cfg->adaptive_decay);
+        /* Bigram tables adapt too when the context codes with them; the
+         * slot tables are allocated by the first slot rebuild */
+        if ((cfg->flags & NETC_CFG_FLAG_BIGRAM) && dict != NULL &&
+            dict->bigram_tables[0][0].valid) {
+            ctx->adapt_bg = (netc_adapt_bigram_t *)malloc(sizeof(netc_adapt_bigram_t));
+            if (ctx->adapt_bg == NULL) {
+                free(ctx->adapt_total);
+                free(ctx->adapt_freq);
+                if (ctx->arena_owned) free(ctx->arena);
+                free(ctx->ring);
+                free(ctx);
+                return NULL;
             }
+            ctx->adapt_bg->tables = NULL;
+            netc_adaptive_bigram_init(ctx->adapt_bg, dict);
         }
-        ctx->adapt_pkt_count = 0;
     }
 
     memset(&ctx->stats, 0, sizeof(ctx->stats));
     return ctx;
 }
 
+/* =========================================================================
+ * netc_ctx_grow_history / netc_ctx_alloc_ring — lazy per-context buffers
+ *
+ * Most connections carry small packets, so the delta history is sized to
+ * the largest packet seen rather than NETC_MAX_PACKET_SIZE.  Capacity grows
+ * in powers of two from NETC_HIST_MIN_CAP, so a context reallocates at most
+ * ~10 times over its lifetime and the hot path stays malloc-free (AD-005)
+ * once the packet sizes settle.
+ * ========================================================================= */
+
+#define NETC_HIST_MIN_CAP 64u
+
+netc_result_t netc_ctx_grow_history(netc_ctx_t *ctx, size_t need) {
+    if (need <= ctx->hist_cap) return NETC_OK;
+    if (need > NETC_MAX_PACKET_SIZE) return NETC_ERR_TOOBIG;
+
+    size_t cap = (ctx->hist_cap > 0) ? ctx->hist_cap : NETC_HIST_MIN_CAP;
+    while (cap < need) cap *= 2u;
+    if (cap > NETC_MAX_PACKET_SIZE) cap = NETC_MAX_PACKET_SIZE;
+
+    uint8_t *p = (uint8_t *)realloc(ctx->prev_pkt, cap);
+    if (NETC_UNLIKELY(p == NULL)) return NETC_ERR_NOMEM;
+    ctx->prev_pkt = p;
+
+    if (ctx->flags & NETC_CFG_FLAG_ADAPTIVE) {
+        /* prev2 must match: history rotation swaps the two buffers */
+        uint8_t *p2 = (uint8_t *)realloc(ctx->prev2_pkt, cap);
+        if (NETC_UNLIKELY(p2 == NULL)) return NETC_ERR_NOMEM;
+        ctx->prev2_pkt = p2;
+    }
+    if (ctx->flags & NETC_CFG_FLAG_DELTA_REFS) {
+        /* Slots swap buffers with prev_pkt (netc_ctx_ref_commit) */
+        for (uint32_t i = 0; i < NETC_DELTA_REFS; i++) {
+            uint8_t *r = (uint8_t *)realloc(ctx->ref_pkt[i], cap);
+            if (NETC_UNLIKELY(r == NULL)) return NETC_ERR_NOMEM;
+            ctx->ref_pkt[i] = r;
+        }
+    }
+    if (ctx->flags & NETC_CFG_FLAG_BASELINE) {
+        /* Slots swap buffers with prev_pkt (netc_ctx_base_commit) */
+        for (uint32_t i = 0; i < NETC_BASELINE_SLOTS; i++) {
+            uint8_t *b = (uint8_t *)realloc(ctx->base_pkt[i], cap);
+            if (NETC_UNLIKELY(b == NULL)) return NETC_ERR_NOMEM;
+            ctx->base_pkt[i] = b;
+        }
+    }
+    ctx->hist_cap = cap;
+    return NETC_OK;
+}
+
+netc_result_t netc_ctx_alloc_ring(netc_ctx_t *ctx) {
+    if (ctx->ring != NULL || ctx->ring_size == 0) return NETC_OK;
+    ctx->ring = (uint8_t *)calloc(1, ctx->ring_size);
+    if (NETC_UNLIKELY(ctx->ring == NULL)) return NETC_ERR_NOMEM;
+    ctx->ring_pos = 0;
+    return NETC_OK;
+}
+
+/* The index starts empty: ring bytes appended before it exists (a context
+ * that decompressed first) are never matched. */
+netc_result_t netc_ctx_alloc_lzx(netc_ctx_t *ctx) {
+    netc_lzx_index_t *x = &ctx->lzx;
+    if (x->head != NULL || ctx->ring == NULL) return NETC_OK;
+    uint32_t win = 1u;
+    while (win < ctx->ring_size && win < NETC_LZX_WINDOW_MAX) win <<= 1;
+    uint32_t *head = (uint32_t *)calloc(NETC_LZX_HASH_SIZE, sizeof(uint32_t));
+    uint16_t *prev = (uint16_t *)malloc((size_t)win * sizeof(uint16_t));
+    if (NETC_UNLIKELY(head == NULL || prev == NULL)) {
+        free(head);
+        free(prev);
+        return NETC_ERR_NOMEM;
+    }
+    x->head = head;
+    x->prev = prev;
+    x->mask = win - 1u;
+    x->end  = 0;
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * netc_scratch_create / netc_scratch_destroy
+ * ========================================================================= */
+
+netc_scratch_t *netc_scratch_create(size_t arena_size) {
+    netc_scratch_t *s = (netc_scratch_t *)calloc(1, sizeof(netc_scratch_t));
+    if (NETC_UNLIKELY(s == NULL)) {
+        return NULL;
+    }
+    s->arena_size = (arena_size > 0) ? arena_size : NETC_DEFAULT_ARENA_SIZE;
+    s->arena = (uint8_t *)malloc(s->arena_size);
+    if (NETC_UNLIKELY(s->arena == NULL)) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+void netc_scratch_destroy(netc_scratch_t *scratch) {
+    if (scratch == NULL) {
+        return;
+    }
+    free(scratch->arena);
+    free(scratch);
+}
+
 /* =========================================================================
  * netc_ctx_destroy
  * ========================================================================= */
@@ -140,15 +313,23 @@ void netc_ctx_destroy(netc_ctx_t *ctx) {
     if (ctx == NULL) {
         return;
     }
+    for (uint32_t i = 0; i < NETC_DELTA_REFS; i++) {
+        free(ctx->ref_pkt[i]);
+    }
+    for (uint32_t i = 0; i < NETC_BASELINE_SLOTS; i++) {
+        free(ctx->base_pkt[i]);
+    }
     free(ctx->prev2_pkt);
-    free(ctx->adapt_lzp);
-    free(ctx->adapt_tables);
+    netc_adaptive_release(ctx);
+    free(ctx->adapt_bg);
     free(ctx->adapt_total);
     free(ctx->adapt_freq);
     free(ctx->prev_pkt);
+    free(ctx->lzx.head);
+    free(ctx->lzx.prev);
     free(ctx->ring);
-    free(ctx->arena);
-    /* dict is shared and not owned by the context */
+    if (ctx->arena_owned) free(ctx->arena);
+    /* dict and a borrowed arena are not owned by the context */
     free(ctx);
 }
 
@@ -164,8 +345,12 @@ void netc_ctx_reset(netc_ctx_t *ctx) {
         memset(ctx->ring, 0, ctx->ring_size);
         ctx->ring_pos = 0;
     }
+    if (ctx->lzx.head != NULL) {
+        memset(ctx->lzx.head, 0, NETC_LZX_HASH_SIZE * sizeof(uint32_t));
+        ctx->lzx.end = 0;
+    }
     if (ctx->prev_pkt != NULL) {
-        memset(ctx->prev_pkt, 0, NETC_MAX_PACKET_SIZE);
+        memset(ctx->prev_pkt, 0, ctx->hist_cap);
     }
     ctx->prev_pkt_size = 0;
     ctx->context_seq = 0;
@@ -173,27 +358,24 @@ void netc_ctx_reset(netc_ctx_t *ctx) {
 
     /* Reset order-2 delta state */
     if (ctx->prev2_pkt != NULL) {
-        memset(ctx->prev2_pkt, 0, NETC_MAX_PACKET_SIZE);
-        ctx->prev2_pkt_size = 0;
+        memset(ctx->prev2_pkt, 0, ctx->hist_cap);
     }
+    ctx->prev2_pkt_size = 0;
 
-    /* Reset adaptive state: zero accumulators, re-clone dict tables + LZP */
+    /* Reset the reference history: sizes alone mark slots empty */
+    memset(ctx->ref_size, 0, sizeof(ctx->ref_size));
+
+    /* Reset the baselines: no packet kept, none acknowledged */
+    ctx->base_live     = 0;
+    ctx->base_acked    = 0;
+    ctx->last_seq_live = 0;
+
+    /* Reset adaptive state: zero accumulators and drop the copy-on-write
+     * tables so the context shares the dict baseline again */
     if (ctx->adapt_freq) {
         memset(ctx->adapt_freq, 0, NETC_CTX_COUNT * 256 * sizeof(uint32_t));
         memset(ctx->adapt_total, 0, NETC_CTX_COUNT * sizeof(uint32_t));
-        /* Re-clone tables from dict baseline */
-        if (ctx->dict) {
-            memcpy(ctx->adapt_tables, ctx->dict->tables, NETC_CTX_COUNT * sizeof(netc_tans_table_t));
-            /* Re-clone LZP table from dict baseline */
-            if (ctx->adapt_lzp && ctx->dict->lzp_table) {
-                memcpy(ctx->adapt_lzp, ctx->dict->lzp_table,
-                       NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
-                for (uint32_t j = 0; j < NETC_LZP_HT_SIZE; j++) {
-                    if (ctx->adapt_lzp[j].valid)
-                        ctx->adapt_lzp[j].valid = 4;
-                }
-            }
-        }
+        netc_adaptive_release(ctx);
         ctx->adapt_pkt_count = 0;
     }
 }
@@ -225,6 +407,96 @@ uint8_t netc_ctx_simd_level(const netc_ctx_t *ctx) {
     return ctx->simd_ops.level;
 }
 
+/* =========================================================================
+ * netc_ctx_memory_usage
+ * ========================================================================= */
+
+netc_result_t netc_ctx_memory_usage(const netc_ctx_t *ctx, netc_mem_usage_t *out) {
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (NETC_UNLIKELY(out == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(*out));
+    out->ctx     = sizeof(netc_ctx_t);
+    out->history = ctx->hist_cap * ((ctx->prev2_pkt != NULL) ? 2u : 1u);
+    if (ctx->ref_pkt[0] != NULL) {
+        out->history += ctx->hist_cap * NETC_DELTA_REFS;
+    }
+    if (ctx->base_pkt[0] != NULL) {
+        out->history += ctx->hist_cap * NETC_BASELINE_SLOTS;
+    }
+    out->ring    = (ctx->ring != NULL) ? ctx->ring_size : 0;
+    if (ctx->lzx.head != NULL) {
+        out->ring += NETC_LZX_HASH_SIZE * sizeof(uint32_t)
+                   + ((size_t)ctx->lzx.mask + 1u) * sizeof(uint16_t);
+    }
+    out->arena   = ctx->arena_owned ? ctx->arena_size : 0;
+    if (ctx->adapt_freq != NULL) {
+        out->adaptive = NETC_CTX_COUNT * 256u * sizeof(uint32_t)
+                      + NETC_CTX_COUNT * sizeof(uint32_t);
+    }
+    if (ctx->adapt_tables != NULL) {
+        out->adaptive += NETC_CTX_COUNT * sizeof(netc_tans_table_t);
+    }
+    if (ctx->adapt_bg != NULL) {
+        out->adaptive += sizeof(netc_adapt_bigram_t);
+        if (ctx->adapt_bg->tables != NULL)
+            out->adaptive += NETC_ADAPTIVE_BG_SLOTS * sizeof(netc_tans_table_t);
+    }
+    if (ctx->adapt_lzp != NULL) {
+        out->adaptive += NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t);
+    }
+    if (ctx->adapt_lzp_ovl.dirty != NULL) {
+        out->adaptive += NETC_LZP_HT_SIZE / 8u
+                       + ctx->adapt_lzp_ovl.cap * sizeof(netc_lzp_ovl_slot_t);
+    }
+    out->total = out->ctx + out->history + out->ring + out->arena + out->adaptive;
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * netc_ack / netc_ctx_last_seq — acknowledged baselines (AD-023)
+ * ========================================================================= */
+
+netc_result_t netc_ack(netc_ctx_t *ctx, uint8_t seq) {
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (!(ctx->flags & NETC_CFG_FLAG_BASELINE)) {
+        return NETC_ERR_UNSUPPORTED;
+    }
+    /* context_seq is the next sequence: seq must be one of the last
+     * NETC_BASELINE_WINDOW packets compressed */
+    uint8_t  age  = (uint8_t)(ctx->context_seq - seq);
+    uint32_t slot = seq % NETC_BASELINE_SLOTS;
+    if (age == 0 || age > NETC_BASELINE_WINDOW ||
+        !(ctx->base_live & (1u << slot)) || ctx->base_seq[slot] != seq) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    if (!ctx->base_acked ||
+        (uint8_t)(ctx->context_seq - ctx->base_ack) > age) {
+        ctx->base_ack   = seq;
+        ctx->base_acked = 1;
+    }
+    return NETC_OK;
+}
+
+netc_result_t netc_ctx_last_seq(const netc_ctx_t *ctx, uint8_t *seq) {
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (!(ctx->flags & NETC_CFG_FLAG_BASELINE)) {
+        return NETC_ERR_UNSUPPORTED;
+    }
+    if (NETC_UNLIKELY(seq == NULL || !ctx->last_seq_live)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    *seq = ctx->last_seq;
+    return NETC_OK;
+}
+
 /* =========================================================================
  * netc_strerror
  * ========================================================================= */
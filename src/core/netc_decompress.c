@@ -8,6 +8,7 @@
  *   - Validates all security constraints (RFC-001 §15.1).
  *   - NETC_ALG_PASSTHRU: copies payload verbatim.
  *   - NETC_ALG_TANS: reads initial_state (4 bytes LE) then decodes bitstream.
+ *   - NETC_ALG_RANS: reads 4 rANS states then decodes the byte stream.
  *   - If NETC_PKT_FLAG_DELTA is set: applies delta post-pass to reconstruct
  *     the original bytes from residuals + previous packet predictor.
  */
@@ -23,6 +24,7 @@
  *
  * When DELTA+RLE flags are both set, uses order-2 (linear extrapolation).
  * When only DELTA is set, uses order-1 (simple difference).
+ * Byte planes of the dictionary's map (AD-021) are merged back first.
  * ========================================================================= */
 
 static void decomp_delta_postpass(netc_ctx_t *ctx, uint8_t flags,
@@ -30,17 +32,22 @@ static void decomp_delta_postpass(netc_ctx_t *ctx, uint8_t flags,
 {
     if (!(flags & NETC_PKT_FLAG_DELTA)) return;
     if (ctx->prev_pkt == NULL || ctx->prev_pkt_size != dst_sz) return;
+    const netc_delta_map_t *dmap = (ctx->dict != NULL) ? &ctx->dict->delta_map
+                                                       : &netc_delta_map_default;
+
+    if (ctx->dict != NULL && ctx->dict->delta_planes.count > 0)
+        ctx->simd_ops.delta_planes_merge(&ctx->dict->delta_planes, (uint8_t *)dst, dst_sz);
 
     if ((flags & NETC_PKT_FLAG_RLE) &&
         ctx->prev2_pkt != NULL &&
         ctx->prev2_pkt_size == dst_sz)
     {
         /* Order-2 delta: predicted = 2*prev - prev2 */
-        netc_delta_decode_order2(ctx->prev2_pkt, ctx->prev_pkt,
+        netc_delta_decode_order2(dmap, ctx->prev2_pkt, ctx->prev_pkt,
                                  (const uint8_t *)dst, (uint8_t *)dst, dst_sz);
     } else {
         /* Order-1 delta via SIMD dispatch */
-        ctx->simd_ops.delta_decode(ctx->prev_pkt, (const uint8_t *)dst,
+        ctx->simd_ops.delta_decode(dmap, ctx->prev_pkt, (const uint8_t *)dst,
                                    (uint8_t *)dst, dst_sz);
     }
 }
@@ -51,15 +58,8 @@ static void decomp_delta_postpass(netc_ctx_t *ctx, uint8_t flags,
 
 static void decomp_update_prev(netc_ctx_t *ctx, const void *dst, size_t dst_sz)
 {
-    if (ctx->prev_pkt != NULL) {
-        /* Rotate: prev2 = prev, prev = current (before overwriting prev) */
-        if (ctx->prev2_pkt != NULL) {
-            memcpy(ctx->prev2_pkt, ctx->prev_pkt, ctx->prev_pkt_size);
-            ctx->prev2_pkt_size = ctx->prev_pkt_size;
-        }
-        memcpy(ctx->prev_pkt, dst, dst_sz);
-        ctx->prev_pkt_size = dst_sz;
-    }
+    /* Rotate: prev2 = prev, prev = current */
+    netc_ctx_push_history(ctx, dst, dst_sz);
 }
 
 /* =========================================================================
@@ -172,6 +172,40 @@ static netc_result_t lz77_decode(const uint8_t *lz_src, size_t lz_size,
     return NETC_OK;
 }
 
+/* Within-packet ref: match_len bytes from offset (1-based) back in dst */
+static NETC_INLINE netc_result_t lz77x_copy_near(uint8_t *dst, size_t *out,
+                                                 size_t orig_size,
+                                                 size_t match_len, size_t offset)
+{
+    size_t o = *out;
+    if (offset > o || o + match_len > orig_size) return NETC_ERR_CORRUPT;
+    size_t copy_from = o - offset;
+    for (size_t k = 0; k < match_len; k++)
+        dst[o + k] = dst[copy_from + k];
+    *out = o + match_len;
+    return NETC_OK;
+}
+
+/* Ring ref: offset = ring distance from ring_pos back to the match start.
+ * Match: ring[(ring_pos - offset + k) % ring_size] for k=0..match_len-1. */
+static NETC_INLINE netc_result_t lz77x_copy_far(uint8_t *dst, size_t *out,
+                                                size_t orig_size,
+                                                size_t match_len, size_t offset,
+                                                const uint8_t *ring,
+                                                uint32_t ring_size, uint32_t ring_pos)
+{
+    size_t o = *out;
+    if (ring == NULL || ring_size == 0)  return NETC_ERR_CORRUPT;
+    if (offset > ring_size)              return NETC_ERR_CORRUPT;
+    if (o + match_len > orig_size)       return NETC_ERR_CORRUPT;
+
+    uint32_t rstart = (ring_pos + ring_size - (uint32_t)offset) % ring_size;
+    for (size_t k = 0; k < match_len; k++)
+        dst[o + k] = ring[(rstart + k) % ring_size];
+    *out = o + match_len;
+    return NETC_OK;
+}
+
 /* =========================================================================
  * Internal: cross-packet LZ77 decode (NETC_ALG_LZ77X)
  *
@@ -215,35 +249,97 @@ static netc_result_t lz77x_decode(
             if (i >= lz_size)               return NETC_ERR_CORRUPT;
             size_t match_len = (size_t)(tok & 0x3Fu) + 3;
             size_t offset    = (size_t)lz_src[i++] + 1;
-            if (offset > out)               return NETC_ERR_CORRUPT;
-            if (out + match_len > orig_size) return NETC_ERR_CORRUPT;
-            size_t copy_from = out - offset;
-            for (size_t k = 0; k < match_len; k++)
-                dst[out + k] = dst[copy_from + k];
-            out += match_len;
+            if (lz77x_copy_near(dst, &out, orig_size, match_len, offset) != NETC_OK)
+                return NETC_ERR_CORRUPT;
 
         } else {
-            /* Long back-ref: [11llllll][lo][hi]
-             * offset = ring distance from ring_pos back to match start.
-             * Match: ring[(ring_pos - offset + k) % ring_size] for k=0..match_len-1. */
+            /* Long back-ref: [11llllll][lo][hi] */
             if (i + 2 > lz_size)            return NETC_ERR_CORRUPT;
             size_t match_len = (size_t)(tok & 0x3Fu) + 3;
             uint16_t off16   = (uint16_t)lz_src[i] | ((uint16_t)lz_src[i + 1] << 8);
             i += 2;
-            size_t offset = (size_t)off16 + 1;  /* 1-based ring distance */
+            if (lz77x_copy_far(dst, &out, orig_size, match_len, (size_t)off16 + 1,
+                               ring, ring_size, ring_pos) != NETC_OK)
+                return NETC_ERR_CORRUPT;
+        }
+    }
 
-            if (ring == NULL || ring_size == 0)  return NETC_ERR_CORRUPT;
-            if (offset > ring_size)              return NETC_ERR_CORRUPT;
-            if (out + match_len > orig_size)     return NETC_ERR_CORRUPT;
+    if (out != orig_size) return NETC_ERR_CORRUPT;
+    return NETC_OK;
+}
 
-            uint32_t rstart = (ring_pos + ring_size - (uint32_t)offset) % ring_size;
-            for (size_t k = 0; k < match_len; k++) {
-                dst[out++] = ring[(rstart + k) % ring_size];
+/* =========================================================================
+ * Internal: entropy-coded LZ77X decode (NETC_ALG_LZ77X | NETC_LZ77X_TANS)
+ *
+ * Inverse of lz77x_tans_encode in netc_compress.c: the same token stream,
+ * decoded symbol by symbol from one tANS state.  Each header picks the
+ * tables of the bytes after it; literals are decoded with tables[bucket of
+ * their output position] and LZP-unfiltered against the bytes already
+ * written, as PCTX+LZP decodes them.
+ *
+ * Returns NETC_OK on success, NETC_ERR_CORRUPT on malformed input.
+ * ========================================================================= */
+static netc_result_t lz77x_tans_decode(
+    const netc_dict_t        *dict,
+    const netc_tans_table_t  *tables,
+    const netc_lzp_table_t   *lzp_table,
+    const netc_lzp_overlay_t *lzp_ovl,
+    int                       lzp_order2,
+    const uint8_t *payload,   size_t payload_size,
+    uint8_t       *dst,       size_t orig_size,
+    const uint8_t *ring,      uint32_t ring_size, uint32_t ring_pos)
+{
+    if (payload_size < 2) return NETC_ERR_CORRUPT;
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        if (!tables[b].valid) return NETC_ERR_CORRUPT;
+    const netc_tans_table_t *lzx = dict->lzx_tables;
+    for (uint32_t k = 0; k < NETC_LZX_TABLES; k++)
+        if (!lzx[k].valid) return NETC_ERR_CORRUPT;
+
+    uint32_t X = netc_read_u16_le(payload);
+    if (X < NETC_TANS_TABLE_SIZE || X >= 2U * NETC_TANS_TABLE_SIZE) return NETC_ERR_CORRUPT;
+    netc_bsr_t bsr;
+    netc_bsr_init(&bsr, payload + 2, payload_size - 2);
+
+    size_t out = 0;
+    while (out < orig_size) {
+        uint8_t tok;
+        if (netc_tans_decode_step(&lzx[NETC_LZX_TBL_CMD], &bsr, &X, &tok) != 0)
+            return NETC_ERR_CORRUPT;
+
+        if (!(tok & 0x80u)) {
+            size_t lit_len = (size_t)(tok & 0x7Fu) + 1;
+            if (out + lit_len > orig_size) return NETC_ERR_CORRUPT;
+            for (size_t end = out + lit_len; out < end; out++) {
+                const netc_tans_table_t *t =
+                    &tables[netc_bucket_of(&dict->buckets, (uint32_t)out)];
+                uint8_t sym;
+                if (netc_tans_decode_step(t, &bsr, &X, &sym) != 0) return NETC_ERR_CORRUPT;
+                if (lzp_table != NULL) {
+                    uint8_t prev  = (out > 0) ? dst[out - 1] : 0x00u;
+                    uint8_t prev2 = (out > 1) ? dst[out - 2] : 0x00u;
+                    sym ^= netc_lzp_guess(lzp_table, lzp_ovl, lzp_order2, prev2, prev,
+                                          (uint32_t)out);
+                }
+                dst[out] = sym;
             }
+        } else if (!(tok & 0x40u)) {
+            uint8_t off;
+            if (netc_tans_decode_step(&lzx[NETC_LZX_TBL_NEAR], &bsr, &X, &off) != 0 ||
+                lz77x_copy_near(dst, &out, orig_size, (size_t)(tok & 0x3Fu) + 3,
+                                (size_t)off + 1) != NETC_OK)
+                return NETC_ERR_CORRUPT;
+        } else {
+            uint8_t lo, hi;
+            if (netc_tans_decode_step(&lzx[NETC_LZX_TBL_FAR_LO], &bsr, &X, &lo) != 0 ||
+                netc_tans_decode_step(&lzx[NETC_LZX_TBL_FAR_HI], &bsr, &X, &hi) != 0 ||
+                lz77x_copy_far(dst, &out, orig_size, (size_t)(tok & 0x3Fu) + 3,
+                               (((size_t)hi << 8) | lo) + 1,
+                               ring, ring_size, ring_pos) != NETC_OK)
+                return NETC_ERR_CORRUPT;
         }
     }
 
-    if (out != orig_size) return NETC_ERR_CORRUPT;
     return NETC_OK;
 }
 
@@ -272,17 +368,6 @@ static netc_result_t rle_decode(const uint8_t *rle_src, size_t rle_size,
     return NETC_OK;
 }
 
-/* =========================================================================
- * Internal: bucket offset boundaries (mirrors netc_compress.c)
- * ========================================================================= */
-static uint32_t decomp_bucket_start(uint32_t b) {
-    static const uint32_t starts[NETC_CTX_COUNT] = {
-           0,    8,   16,   24,   32,   48,   64,   96,
-         128,  192,  256,  384,  512, 1024, 4096, 16384
-    };
-    return (b < NETC_CTX_COUNT) ? starts[b] : 65536U;
-}
-
 /* =========================================================================
  * Internal: tANS decode path (v0.2: multi-region + RLE support)
  *
@@ -299,12 +384,13 @@ static uint32_t decomp_bucket_start(uint32_t b) {
 static const netc_tans_table_t *
 decomp_select_tbl(const netc_dict_t *dict,
                   const netc_tans_table_t *tables,
+                  const netc_bigram_set_t *bigram,
                   uint32_t bucket,
                   uint8_t prev_byte, uint8_t pkt_flags)
 {
     if (pkt_flags & NETC_PKT_FLAG_BIGRAM) {
         uint32_t bclass = netc_bigram_class(prev_byte, dict->bigram_class_map);
-        const netc_tans_table_t *tbl = &dict->bigram_tables[bucket][bclass];
+        const netc_tans_table_t *tbl = bigram->t[bucket][bclass];
         if (tbl->valid) return tbl;
     }
     return &tables[bucket];
@@ -313,6 +399,7 @@ decomp_select_tbl(const netc_dict_t *dict,
 static netc_result_t decode_tans(
     const netc_dict_t       *dict,
     const netc_tans_table_t *tables,       /* adaptive or dict->tables */
+    const netc_bigram_set_t *bigram,       /* adaptive or dict->bigram_set */
     const netc_pkt_header_t *hdr,
     const uint8_t           *payload,     /* points past the packet header */
     size_t                   payload_size, /* = hdr->compressed_size */
@@ -347,7 +434,7 @@ static netc_result_t decode_tans(
         size_t         bits_avail = payload_size - hdr_bytes;
         size_t         bits_offset = 0;
 
-        uint32_t first_bucket = netc_ctx_bucket(0);
+        uint32_t first_bucket = netc_bucket_of(&dict->buckets, 0);
 
         /* prev_byte tracks the last decoded byte of the previous region,
          * matching what the encoder used for bigram class selection. */
@@ -360,8 +447,8 @@ static netc_result_t decode_tans(
             if (state == 0 && bs_bytes == 0) continue; /* empty region sentinel */
 
             uint32_t bucket     = first_bucket + r;
-            uint32_t rstart     = decomp_bucket_start(bucket);
-            uint32_t rend_bound = decomp_bucket_start(bucket + 1);
+            uint32_t rstart     = netc_bucket_start(&dict->buckets, bucket);
+            uint32_t rend_bound = netc_bucket_start(&dict->buckets, bucket + 1);
 
             size_t region_start = (rstart     < orig) ? (size_t)rstart     : orig;
             size_t region_end   = (rend_bound < orig) ? (size_t)rend_bound : orig;
@@ -374,7 +461,7 @@ static netc_result_t decode_tans(
             if (bits_offset + bs_bytes > bits_avail)
                 return NETC_ERR_CORRUPT;
 
-            const netc_tans_table_t *tbl = decomp_select_tbl(dict, tables, bucket,
+            const netc_tans_table_t *tbl = decomp_select_tbl(dict, tables, bigram, bucket,
                                                               region_prev_byte,
                                                               hdr->flags);
             if (!tbl->valid) return NETC_ERR_DICT_INVALID;
@@ -403,7 +490,7 @@ static netc_result_t decode_tans(
         uint32_t bucket = (uint32_t)(hdr->algorithm >> 4);
         if (bucket >= NETC_CTX_COUNT) bucket = 0; /* safety clamp */
         /* prev_byte at position 0 is implicitly 0x00 (packet start), same as encoder */
-        const netc_tans_table_t *tbl = decomp_select_tbl(dict, tables, bucket, 0x00u, hdr->flags);
+        const netc_tans_table_t *tbl = decomp_select_tbl(dict, tables, bigram, bucket, 0x00u, hdr->flags);
         if (!tbl->valid) return NETC_ERR_DICT_INVALID;
 
         if (hdr->flags & NETC_PKT_FLAG_X2) {
@@ -450,29 +537,134 @@ static netc_result_t decode_tans(
 }
 
 /* =========================================================================
- * netc_decompress — stateful context path
+ * Internal: PCTX decode path (stateful and stateless)
+ *
+ * Wire format: [initial state(s)][bitstream].  The algorithm byte's X4/X8
+ * modifier selects 4 or 8 packed 12-bit states (netc_tans_xn_states_read);
+ * otherwise one 2B (compact) or 4B state.  BIGRAM flag selects the bigram
+ * decoder.
  * ========================================================================= */
 
-netc_result_t netc_decompress(
-    netc_ctx_t *ctx,
-    const void *src,
-    size_t      src_size,
-    void       *dst,
-    size_t      dst_cap,
-    size_t     *dst_size)
+static netc_result_t decode_pctx(
+    const netc_dict_t       *dict,
+    const netc_tans_table_t *tables,       /* adaptive or dict->tables */
+    const netc_bigram_set_t *bigram,       /* adaptive or dict->bigram_set */
+    const netc_pkt_header_t *hdr,
+    const uint8_t           *payload,      /* points past the packet header */
+    void                    *dst,
+    int                      compact,      /* compact mode: 2B ANS state */
+    const netc_simd_ops_t   *ops)          /* X8 kernel dispatch, or NULL */
 {
-    if (NETC_UNLIKELY(ctx == NULL)) {
-        return NETC_ERR_CTX_NULL;
+    if (dict == NULL) return NETC_ERR_DICT_INVALID;
+    const uint32_t n_states = netc_pctx_alg_states(hdr->algorithm);
+    if (n_states == 0U) return NETC_ERR_CORRUPT;
+    const size_t states_sz = (n_states > 1U) ? NETC_TANS_XN_STATE_BYTES(n_states)
+                           : compact ? 2u : 4u;
+    if (hdr->compressed_size < states_sz) return NETC_ERR_CORRUPT;
+
+    uint32_t states[NETC_TANS_MAX_STATES];
+    if (n_states > 1U) {
+        netc_tans_xn_states_read(payload, states, n_states);
+    } else {
+        states[0] = compact ? (uint32_t)netc_read_u16_le(payload)
+                            : netc_read_u32_le(payload);
+        if (states[0] < NETC_TANS_TABLE_SIZE ||
+            states[0] >= 2U * NETC_TANS_TABLE_SIZE)
+            return NETC_ERR_CORRUPT;
     }
-    if (NETC_UNLIKELY(src == NULL || dst == NULL || dst_size == NULL)) {
-        return NETC_ERR_INVALID_ARG;
+
+    netc_bsr_t bsr;
+    netc_bsr_init(&bsr, payload + states_sz, hdr->compressed_size - states_sz);
+
+    int use_bigram = (hdr->flags & NETC_PKT_FLAG_BIGRAM) &&
+                     dict->bigram_tables[0][0].valid;
+    uint8_t *out = (uint8_t *)dst;
+    size_t   n   = hdr->original_size;
+    int rc;
+    if (n_states > 1U) {
+        rc = use_bigram
+            ? netc_tans_decode_pctx_bigram_xn(bigram, tables,
+                                              dict->bigram_class_map,
+                                              &dict->buckets, &bsr,
+                                              out, n, n_states, states)
+            : netc_tans_decode_pctx_xn_simd(tables, &dict->buckets, &bsr,
+                                            out, n, n_states, states, ops);
+    } else {
+        rc = use_bigram
+            ? netc_tans_decode_pctx_bigram(bigram, tables,
+                                           dict->bigram_class_map,
+                                           &dict->buckets, &bsr,
+                                           out, n, states[0])
+            : netc_tans_decode_pctx(tables, &dict->buckets, &bsr, out, n,
+                                    states[0]);
     }
+    return (rc == 0) ? NETC_OK : NETC_ERR_CORRUPT;
+}
+
+/* =========================================================================
+ * Internal: static rANS decode path (stateful and stateless)
+ *
+ * Wire format: [4 × 4B state][byte stream] (netc_rans_decode_pctx), coded
+ * with the rANS tables derived from the dictionary's unigram tables.  The
+ * only algorithm-byte modifier is NETC_RANS_LZP.
+ * ========================================================================= */
+
+static netc_result_t decode_rans(
+    const netc_dict_t       *dict,
+    const netc_pkt_header_t *hdr,
+    const uint8_t           *payload,      /* points past the packet header */
+    void                    *dst)
+{
+    if (dict == NULL) return NETC_ERR_DICT_INVALID;
+    if (hdr->algorithm & ~(uint8_t)(0x0Fu | NETC_RANS_LZP)) return NETC_ERR_CORRUPT;
+    if (hdr->flags & (NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_MREG | NETC_PKT_FLAG_X2))
+        return NETC_ERR_CORRUPT;
+    if (netc_rans_decode_pctx(dict->rans_tables, &dict->buckets,
+                              payload, hdr->compressed_size,
+                              (uint8_t *)dst, hdr->original_size) != 0)
+        return NETC_ERR_CORRUPT;
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * Per-context decompression environment
+ *
+ * Resolved once per netc_decompress call or once per batch.  The arena is
+ * the context's own or the caller's netc_scratch_t.  The tANS and LZP tables
+ * are not cached here: adaptive contexts switch from the shared dict tables
+ * to their own copies mid-stream, so decompress_packet resolves them per
+ * packet.
+ * ========================================================================= */
+
+typedef struct {
+    int                      compact_mode;
+    uint8_t                 *arena;      /* per-call working memory */
+    size_t                   arena_size;
+} decompress_env_t;
+
+static NETC_INLINE void decompress_env_init(const netc_ctx_t *ctx,
+                                            decompress_env_t *env)
+{
+    env->compact_mode = (ctx->flags & NETC_CFG_FLAG_COMPACT_HDR) ? 1 : 0;
+    env->arena        = ctx->arena;
+    env->arena_size   = ctx->arena_size;
+}
 
-    const int compact_mode = (ctx->flags & NETC_CFG_FLAG_COMPACT_HDR) ? 1 : 0;
-    /* Adaptive tables (when active) or frozen dict tables */
-    const netc_tans_table_t *tables = (ctx->dict != NULL) ? netc_get_tables(ctx) : NULL;
-    /* Adaptive LZP table (when active) or frozen dict LZP table */
-    const netc_lzp_entry_t *lzp_table = netc_get_lzp_table(ctx);
+/* =========================================================================
+ * decompress_packet_body — decode one packet against prev_pkt.  Arguments
+ * are validated by the caller.
+ * ========================================================================= */
+
+static netc_result_t decompress_packet_body(
+    netc_ctx_t             *ctx,
+    const decompress_env_t *env,
+    const void             *src,
+    size_t                  src_size,
+    void                   *dst,
+    size_t                  dst_cap,
+    size_t                 *dst_size)
+{
+    const int compact_mode = env->compact_mode;
 
     netc_pkt_header_t hdr;
     size_t pkt_hdr_sz = 0;
@@ -482,6 +674,27 @@ netc_result_t netc_decompress(
         return r;
     }
 
+    /* Lazily allocated state: delta history sized for this packet, and the
+     * LZ77X ring on a context that has not needed it yet */
+    if (NETC_UNLIKELY(netc_ctx_reserve_history(ctx, hdr.original_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
+    }
+    if (NETC_UNLIKELY(ctx->ring == NULL && ctx->ring_size > 0) &&
+        netc_ctx_alloc_ring(ctx) != NETC_OK) {
+        return NETC_ERR_NOMEM;
+    }
+    if (NETC_UNLIKELY(netc_adaptive_reserve(ctx, hdr.original_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    /* Active tables, after any copy-on-write allocation above */
+    const netc_tans_table_t  *tables    = (ctx->dict != NULL) ? netc_get_tables(ctx) : NULL;
+    const netc_bigram_set_t  *bigram    = (ctx->dict != NULL) ? netc_get_bigram(ctx) : NULL;
+    const netc_lzp_table_t    lzp       = netc_get_lzp_table(ctx);
+    const netc_lzp_table_t   *lzp_table = (lzp.ent != NULL) ? &lzp : NULL;
+    const netc_lzp_overlay_t *lzp_ovl   = netc_get_lzp_overlay(ctx);
+    const int                 lzp_order2 = netc_lzp_order2(ctx->dict);
+
     /* In compact mode, model_id/context_seq are not on the wire — fill from ctx */
     if (compact_mode) {
         hdr.model_id    = (ctx->dict != NULL) ? ctx->dict->model_id : 0;
@@ -502,12 +715,15 @@ netc_result_t netc_decompress(
     /* Upper 4 bits of the algorithm byte encode the table bucket index for
      * single-region tANS/LZP packets (set by encoder when using best-fit
      * table selection for small multi-bucket packets).  Normalize when the
-     * low 4 bits are NETC_ALG_TANS, NETC_ALG_LZP, or NETC_ALG_TANS_10. */
+     * low 4 bits are NETC_ALG_TANS, NETC_ALG_LZP, or NETC_ALG_TANS_10.
+     * PCTX and rANS carry modifier bits there instead. */
     uint8_t alg_id = hdr.algorithm;
     if ((alg_id & 0x0Fu) == NETC_ALG_TANS)      alg_id = NETC_ALG_TANS;
     if ((alg_id & 0x0Fu) == NETC_ALG_LZP)       alg_id = NETC_ALG_LZP;
     if ((alg_id & 0x0Fu) == NETC_ALG_TANS_PCTX) alg_id = NETC_ALG_TANS_PCTX;
     if ((alg_id & 0x0Fu) == NETC_ALG_TANS_10)   alg_id = NETC_ALG_TANS_10;
+    if ((alg_id & 0x0Fu) == NETC_ALG_RANS)      alg_id = NETC_ALG_RANS;
+    if (alg_id == (NETC_ALG_LZ77X | NETC_LZ77X_TANS)) alg_id = NETC_ALG_LZ77X;
 
     switch (alg_id) {
         case NETC_ALG_PASSTHRU: {
@@ -546,14 +762,14 @@ netc_result_t netc_decompress(
             }
             ctx->context_seq = (uint8_t)(hdr.context_seq + 1);
             netc_adaptive_update(ctx, (const uint8_t *)dst, hdr.original_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)dst, hdr.original_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)dst, hdr.original_size);
             return NETC_OK;
         }
 
         case NETC_ALG_TANS: {
-            uint8_t *scratch    = ctx->arena;
-            size_t   scratch_cap = ctx->arena_size;
-            r = decode_tans(ctx->dict, tables, &hdr, payload,
+            uint8_t *scratch    = env->arena;
+            size_t   scratch_cap = env->arena_size;
+            r = decode_tans(ctx->dict, tables, bigram, &hdr, payload,
                             hdr.compressed_size, dst, dst_size,
                             scratch, scratch_cap, compact_mode);
             if (r != NETC_OK) return r;
@@ -573,54 +789,34 @@ netc_result_t netc_decompress(
             }
             ctx->context_seq = (uint8_t)(hdr.context_seq + 1);
             netc_adaptive_update(ctx, (const uint8_t *)dst, *dst_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)dst, *dst_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)dst, *dst_size);
             return NETC_OK;
         }
 
-        case NETC_ALG_TANS_PCTX: {
+        case NETC_ALG_TANS_PCTX:
+        case NETC_ALG_RANS: {
             /* Per-position context-adaptive tANS: single stream, table switches
-             * per byte offset.  Wire format: [state_sz initial_state][bitstream].
-             * When BIGRAM flag is set, also switches bigram class per byte. */
-            if (ctx->dict == NULL) return NETC_ERR_DICT_INVALID;
-            const size_t pctx_state_sz = compact_mode ? 2u : 4u;
-            if (hdr.compressed_size < pctx_state_sz) return NETC_ERR_CORRUPT;
-
-            uint32_t initial_state = compact_mode
-                ? (uint32_t)netc_read_u16_le(payload)
-                : netc_read_u32_le(payload);
-            if (initial_state < NETC_TANS_TABLE_SIZE ||
-                initial_state >= 2U * NETC_TANS_TABLE_SIZE)
-                return NETC_ERR_CORRUPT;
-
-            const uint8_t *bits = payload + pctx_state_sz;
-            size_t bits_sz = hdr.compressed_size - pctx_state_sz;
-            netc_bsr_t bsr;
-            netc_bsr_init(&bsr, bits, bits_sz);
-
-            int pctx_rc;
-            if ((hdr.flags & NETC_PKT_FLAG_BIGRAM) &&
-                ctx->dict->bigram_tables[0][0].valid) {
-                pctx_rc = netc_tans_decode_pctx_bigram(
-                    ctx->dict->bigram_tables, tables,
-                    ctx->dict->bigram_class_map,
-                    &bsr, (uint8_t *)dst, hdr.original_size, initial_state);
-            } else {
-                pctx_rc = netc_tans_decode_pctx(
-                    tables, &bsr,
-                    (uint8_t *)dst, hdr.original_size, initial_state);
-            }
-            if (pctx_rc != 0)
-                return NETC_ERR_CORRUPT;
+             * per byte offset (see decode_pctx).  Static rANS codes the same
+             * per-position contexts and shares the post-passes. */
+            r = (alg_id == NETC_ALG_RANS)
+                ? decode_rans(ctx->dict, &hdr, payload, dst)
+                : decode_pctx(ctx->dict, tables, bigram, &hdr, payload, dst, compact_mode,
+                              &ctx->simd_ops);
+            if (r != NETC_OK) return r;
 
             *dst_size = hdr.original_size;
 
-            /* LZP XOR inverse: upper nibble of algorithm byte signals LZP
-             * was applied as a pre-filter before PCTX encoding. */
-            if ((hdr.algorithm & 0xF0u) != 0 &&
+            /* dst holds the coded stream until the post-passes below */
+            if (alg_id == NETC_ALG_TANS_PCTX && (hdr.flags & NETC_PKT_FLAG_BIGRAM))
+                netc_adaptive_bigram_feed(ctx, (const uint8_t *)dst, *dst_size);
+
+            /* LZP XOR inverse: NETC_PCTX_LZP (== NETC_RANS_LZP) in the
+             * algorithm byte signals LZP was applied as a pre-filter. */
+            if ((hdr.algorithm & NETC_PCTX_LZP) != 0 &&
                 lzp_table != NULL)
             {
-                netc_lzp_xor_unfilter((const uint8_t *)dst, *dst_size,
-                                       lzp_table, (uint8_t *)dst);
+                netc_lzp_unfilter(ctx, (uint8_t *)dst, *dst_size,
+                                  lzp_table, lzp_ovl, lzp_order2);
             }
 
             /* Delta post-pass (order-1 or order-2) */
@@ -638,7 +834,7 @@ netc_result_t netc_decompress(
             }
             ctx->context_seq = (uint8_t)(hdr.context_seq + 1);
             netc_adaptive_update(ctx, (const uint8_t *)dst, *dst_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)dst, *dst_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)dst, *dst_size);
             return NETC_OK;
         }
 
@@ -646,9 +842,18 @@ netc_result_t netc_decompress(
             /* Cross-packet LZ77: decode using ring buffer as history.
              * No delta flag — always encodes original (raw) src bytes. */
             if (ctx->ring == NULL || ctx->ring_size == 0) return NETC_ERR_UNSUPPORTED;
-            r = lz77x_decode(payload, hdr.compressed_size,
-                             (uint8_t *)dst, hdr.original_size,
-                             ctx->ring, ctx->ring_size, ctx->ring_pos);
+            if (hdr.algorithm & NETC_LZ77X_TANS) {
+                /* Tokens tANS-coded with the dictionary's tables (AD-031) */
+                if (!netc_dict_has_lzx(ctx->dict)) return NETC_ERR_DICT_INVALID;
+                r = lz77x_tans_decode(ctx->dict, tables, lzp_table, lzp_ovl, lzp_order2,
+                                      payload, hdr.compressed_size,
+                                      (uint8_t *)dst, hdr.original_size,
+                                      ctx->ring, ctx->ring_size, ctx->ring_pos);
+            } else {
+                r = lz77x_decode(payload, hdr.compressed_size,
+                                 (uint8_t *)dst, hdr.original_size,
+                                 ctx->ring, ctx->ring_size, ctx->ring_pos);
+            }
             if (r != NETC_OK) return r;
             *dst_size = hdr.original_size;
 
@@ -664,7 +869,7 @@ netc_result_t netc_decompress(
             }
             ctx->context_seq = (uint8_t)(hdr.context_seq + 1);
             netc_adaptive_update(ctx, (const uint8_t *)dst, *dst_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)dst, *dst_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)dst, *dst_size);
             return NETC_OK;
         }
 
@@ -675,16 +880,15 @@ netc_result_t netc_decompress(
             if (ctx->dict == NULL || lzp_table == NULL)
                 return NETC_ERR_DICT_INVALID;
 
-            r = decode_tans(ctx->dict, tables, &hdr, payload,
+            r = decode_tans(ctx->dict, tables, bigram, &hdr, payload,
                             hdr.compressed_size, dst, dst_size,
-                            ctx->arena, ctx->arena_size, compact_mode);
+                            env->arena, env->arena_size, compact_mode);
             if (r != NETC_OK) return r;
 
             /* LZP XOR inverse: undo the XOR pre-filter applied during
-             * compression.  Operates in-place since netc_lzp_xor_unfilter
-             * reads from src and writes to dst (can alias for in-place). */
-            netc_lzp_xor_unfilter((const uint8_t *)dst, *dst_size,
-                                   lzp_table, (uint8_t *)dst);
+             * compression, in place. */
+            netc_lzp_unfilter(ctx, (uint8_t *)dst, *dst_size,
+                              lzp_table, lzp_ovl, lzp_order2);
 
             /* Delta post-pass (order-1 or order-2) */
             decomp_delta_postpass(ctx, hdr.flags, dst, *dst_size);
@@ -701,7 +905,7 @@ netc_result_t netc_decompress(
             }
             ctx->context_seq = (uint8_t)(hdr.context_seq + 1);
             netc_adaptive_update(ctx, (const uint8_t *)dst, *dst_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)dst, *dst_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)dst, *dst_size);
             return NETC_OK;
         }
 
@@ -757,18 +961,236 @@ netc_result_t netc_decompress(
             }
             ctx->context_seq = (uint8_t)(hdr.context_seq + 1);
             netc_adaptive_update(ctx, (const uint8_t *)dst, *dst_size);
-            netc_lzp_adaptive_update(ctx->adapt_lzp, (const uint8_t *)dst, *dst_size);
+            netc_adaptive_lzp_update(ctx, (const uint8_t *)dst, *dst_size);
             return NETC_OK;
         }
 
-        case NETC_ALG_RANS:
-            return NETC_ERR_UNSUPPORTED;
-
         default:
             return NETC_ERR_CORRUPT;
     }
 }
 
+/* =========================================================================
+ * decompress_packet_baseline — mirror of compress_packet_baseline (AD-023)
+ *
+ * Strips the trailer, decodes a DELTA packet against the kept packet named
+ * by its baseline sequence number, and keeps the result under the packet's
+ * own sequence number (the compact trailer, or the legacy context_seq).  A
+ * baseline that is not kept, or kept with another size, fails the packet
+ * with NETC_ERR_CORRUPT and leaves the context unchanged.
+ * ========================================================================= */
+
+static netc_result_t decompress_packet_baseline(
+    netc_ctx_t             *ctx,
+    const decompress_env_t *env,
+    const void             *src,
+    size_t                  src_size,
+    void                   *dst,
+    size_t                  dst_cap,
+    size_t                 *dst_size)
+{
+    const uint8_t *in = (const uint8_t *)src;
+    netc_pkt_header_t hdr;
+    size_t hdr_sz = 0;
+    if (env->compact_mode) {
+        hdr_sz = netc_hdr_read_compact(src, src_size, &hdr);
+    } else if (src_size >= NETC_HEADER_SIZE) {
+        netc_hdr_read(src, &hdr);
+        hdr_sz = NETC_HEADER_SIZE;
+    }
+    /* Malformed headers are reported by decompress_packet_body */
+    if (hdr_sz == 0) {
+        return decompress_packet_body(ctx, env, src, src_size, dst, dst_cap, dst_size);
+    }
+
+    uint8_t seq = hdr.context_seq;
+    if (env->compact_mode) {
+        if (NETC_UNLIKELY(src_size <= hdr_sz)) return NETC_ERR_CORRUPT;
+        seq = in[--src_size];
+    }
+    if (NETC_UNLIKELY(netc_ctx_reserve_history(ctx, hdr.original_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
+    }
+    int slot = -1;
+    if (hdr.flags & NETC_PKT_FLAG_DELTA) {
+        if (NETC_UNLIKELY(src_size <= hdr_sz)) return NETC_ERR_CORRUPT;
+        slot = netc_ctx_base_find(ctx, in[--src_size], hdr.original_size);
+        if (NETC_UNLIKELY(slot < 0)) return NETC_ERR_CORRUPT;
+    }
+    netc_ctx_base_load(ctx, slot);
+
+    netc_result_t r = decompress_packet_body(ctx, env, src, src_size,
+                                             dst, dst_cap, dst_size);
+    if (NETC_UNLIKELY(r != NETC_OK)) {
+        return r;
+    }
+    netc_ctx_base_commit(ctx, seq);
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * decompress_packet — single-packet path shared by netc_decompress and
+ * netc_decompress_batch.  Arguments are validated by the caller.
+ *
+ * Mirror of compress_packet under NETC_CFG_FLAG_DELTA_REFS (AD-022): a
+ * DELTA packet with two or more same-size candidates in the reference
+ * history ends in the candidate's index, which is stripped before the
+ * packet is decoded.
+ * ========================================================================= */
+
+static netc_result_t decompress_packet(
+    netc_ctx_t             *ctx,
+    const decompress_env_t *env,
+    const void             *src,
+    size_t                  src_size,
+    void                   *dst,
+    size_t                  dst_cap,
+    size_t                 *dst_size)
+{
+    if (ctx->flags & NETC_CFG_FLAG_BASELINE) {
+        return decompress_packet_baseline(ctx, env, src, src_size, dst, dst_cap, dst_size);
+    }
+    netc_pkt_header_t hdr;
+    size_t hdr_sz = 0;
+    if (ctx->flags & NETC_CFG_FLAG_DELTA_REFS) {
+        if (env->compact_mode) {
+            hdr_sz = netc_hdr_read_compact(src, src_size, &hdr);
+        } else if (src_size >= NETC_HEADER_SIZE) {
+            netc_hdr_read(src, &hdr);
+            hdr_sz = NETC_HEADER_SIZE;
+        }
+    }
+    /* Malformed headers are reported by decompress_packet_body */
+    if (hdr_sz == 0 || hdr.original_size == 0) {
+        return decompress_packet_body(ctx, env, src, src_size, dst, dst_cap, dst_size);
+    }
+    if (NETC_UNLIKELY(netc_ctx_reserve_history(ctx, hdr.original_size) != NETC_OK)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    uint8_t  cand[NETC_DELTA_REFS];
+    uint32_t n_cand = netc_ctx_ref_candidates(ctx, hdr.original_size, cand);
+    uint32_t pick   = 0;
+    const int delta = (hdr.flags & NETC_PKT_FLAG_DELTA) != 0;
+    if (delta && n_cand >= 2) {
+        if (NETC_UNLIKELY(src_size <= hdr_sz)) return NETC_ERR_CORRUPT;
+        pick = ((const uint8_t *)src)[--src_size];
+        if (NETC_UNLIKELY(pick >= n_cand)) return NETC_ERR_CORRUPT;
+    }
+    netc_ctx_ref_load(ctx, (n_cand > 0) ? cand[pick] : 0);
+
+    netc_result_t r = decompress_packet_body(ctx, env, src, src_size,
+                                             dst, dst_cap, dst_size);
+    if (NETC_UNLIKELY(r != NETC_OK)) {
+        return r;
+    }
+    netc_ctx_ref_commit(ctx);
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * netc_decompress / netc_decompress_ex — stateful context path
+ * ========================================================================= */
+
+netc_result_t netc_decompress(
+    netc_ctx_t *ctx,
+    const void *src,
+    size_t      src_size,
+    void       *dst,
+    size_t      dst_cap,
+    size_t     *dst_size)
+{
+    return netc_decompress_ex(ctx, NULL, src, src_size, dst, dst_cap, dst_size);
+}
+
+netc_result_t netc_decompress_ex(
+    netc_ctx_t     *ctx,
+    netc_scratch_t *scratch,
+    const void     *src,
+    size_t          src_size,
+    void           *dst,
+    size_t          dst_cap,
+    size_t         *dst_size)
+{
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (NETC_UNLIKELY(src == NULL || dst == NULL || dst_size == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    decompress_env_t env;
+    decompress_env_init(ctx, &env);
+    if (scratch != NULL) {
+        env.arena      = scratch->arena;
+        env.arena_size = scratch->arena_size;
+    }
+    if (NETC_UNLIKELY(env.arena == NULL)) {
+        return NETC_ERR_INVALID_ARG;  /* EXTERNAL_SCRATCH context, no scratch */
+    }
+    return decompress_packet(ctx, &env, src, src_size, dst, dst_cap, dst_size);
+}
+
+/* =========================================================================
+ * netc_decompress_batch — many packets, one context, one output arena
+ *
+ * Mirror of netc_compress_batch.  Decompressed packets are written
+ * back-to-back into dst; offsets[i] is the start of packet i and
+ * offsets[count] the total number of bytes written.
+ * ========================================================================= */
+
+netc_result_t netc_decompress_batch(
+    netc_ctx_t        *ctx,
+    const void *const *srcs,
+    const size_t      *src_sizes,
+    size_t             count,
+    void              *dst,
+    size_t             dst_cap,
+    size_t            *offsets,
+    size_t            *n_done)
+{
+    if (n_done != NULL) *n_done = 0;
+    if (NETC_UNLIKELY(ctx == NULL)) {
+        return NETC_ERR_CTX_NULL;
+    }
+    if (NETC_UNLIKELY(offsets == NULL ||
+                      (count > 0 && (srcs == NULL || src_sizes == NULL ||
+                                     dst == NULL)))) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    decompress_env_t env;
+    decompress_env_init(ctx, &env);
+    if (NETC_UNLIKELY(env.arena == NULL)) {
+        return NETC_ERR_INVALID_ARG;  /* EXTERNAL_SCRATCH context */
+    }
+
+    uint8_t *out = (uint8_t *)dst;
+    size_t   pos = 0;
+    offsets[0] = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const void *src = srcs[i];
+        if (NETC_UNLIKELY(src == NULL)) {
+            return NETC_ERR_INVALID_ARG;
+        }
+        if (i + 1 < count) {
+            NETC_PREFETCH(srcs[i + 1]);
+        }
+
+        size_t written = 0;
+        netc_result_t r = decompress_packet(ctx, &env, src, src_sizes[i],
+                                            out + pos, dst_cap - pos, &written);
+        if (NETC_UNLIKELY(r != NETC_OK)) {
+            return r;
+        }
+        pos += written;
+        offsets[i + 1] = pos;
+        if (n_done != NULL) *n_done = i + 1;
+    }
+    return NETC_OK;
+}
+
 /* =========================================================================
  * netc_decompress_stateless
  * ========================================================================= */
@@ -814,6 +1236,7 @@ netc_result_t netc_decompress_stateless(
     if ((alg_id & 0x0Fu) == NETC_ALG_LZP)       alg_id = NETC_ALG_LZP;
     if ((alg_id & 0x0Fu) == NETC_ALG_TANS_PCTX) alg_id = NETC_ALG_TANS_PCTX;
     if ((alg_id & 0x0Fu) == NETC_ALG_TANS_10)   alg_id = NETC_ALG_TANS_10;
+    if ((alg_id & 0x0Fu) == NETC_ALG_RANS)      alg_id = NETC_ALG_RANS;
 
     switch (alg_id) {
         case NETC_ALG_PASSTHRU: {
@@ -839,57 +1262,41 @@ netc_result_t netc_decompress_stateless(
         }
 
         case NETC_ALG_TANS:
-            return decode_tans(dict, dict->tables, &hdr, payload,
+            return decode_tans(dict, dict->tables, &dict->bigram_set, &hdr, payload,
                                hdr.compressed_size, dst, dst_size,
                                NULL, 0, 0);
 
-        case NETC_ALG_TANS_PCTX: {
-            /* Per-position context-adaptive tANS (stateless path).
-             * When BIGRAM flag is set, also switches bigram class per byte. */
-            if (hdr.compressed_size < 4) return NETC_ERR_CORRUPT;
-            uint32_t initial_state = netc_read_u32_le(payload);
-            if (initial_state < NETC_TANS_TABLE_SIZE ||
-                initial_state >= 2U * NETC_TANS_TABLE_SIZE)
-                return NETC_ERR_CORRUPT;
-            const uint8_t *bits = payload + 4;
-            size_t bits_sz = hdr.compressed_size - 4;
-            netc_bsr_t bsr;
-            netc_bsr_init(&bsr, bits, bits_sz);
-            int sl_pctx_rc;
-            if ((hdr.flags & NETC_PKT_FLAG_BIGRAM) &&
-                dict->bigram_tables[0][0].valid) {
-                sl_pctx_rc = netc_tans_decode_pctx_bigram(
-                    dict->bigram_tables, dict->tables,
-                    dict->bigram_class_map,
-                    &bsr, (uint8_t *)dst, hdr.original_size, initial_state);
-            } else {
-                sl_pctx_rc = netc_tans_decode_pctx(
-                    dict->tables, &bsr,
-                    (uint8_t *)dst, hdr.original_size, initial_state);
-            }
-            if (sl_pctx_rc != 0)
-                return NETC_ERR_CORRUPT;
+        case NETC_ALG_TANS_PCTX:
+        case NETC_ALG_RANS: {
+            /* Per-position context-adaptive tANS or static rANS (stateless path). */
+            r = (alg_id == NETC_ALG_RANS)
+                ? decode_rans(dict, &hdr, payload, dst)
+                : decode_pctx(dict, dict->tables, &dict->bigram_set, &hdr, payload, dst, 0,
+                              &dict->simd_ops);
+            if (r != NETC_OK) return r;
             *dst_size = hdr.original_size;
-            /* LZP XOR inverse: upper nibble of algorithm byte signals LZP */
-            if ((hdr.algorithm & 0xF0u) != 0 &&
-                dict->lzp_table != NULL)
+            /* LZP XOR inverse: NETC_PCTX_LZP (== NETC_RANS_LZP) in the algorithm byte */
+            if ((hdr.algorithm & NETC_PCTX_LZP) != 0 &&
+                dict->lzp_table.ent != NULL)
             {
                 netc_lzp_xor_unfilter((const uint8_t *)dst, *dst_size,
-                                       dict->lzp_table, (uint8_t *)dst);
+                                       &dict->lzp_table, NULL, netc_lzp_order2(dict),
+                                       (uint8_t *)dst);
             }
             return NETC_OK;
         }
 
         case NETC_ALG_LZP: {
             /* LZP XOR + tANS: tANS decode then LZP XOR inverse */
-            if (dict->lzp_table == NULL)
+            if (dict->lzp_table.ent == NULL)
                 return NETC_ERR_DICT_INVALID;
-            r = decode_tans(dict, dict->tables, &hdr, payload,
+            r = decode_tans(dict, dict->tables, &dict->bigram_set, &hdr, payload,
                             hdr.compressed_size, dst, dst_size,
                             NULL, 0, 0);
             if (r != NETC_OK) return r;
             netc_lzp_xor_unfilter((const uint8_t *)dst, *dst_size,
-                                   dict->lzp_table, (uint8_t *)dst);
+                                   &dict->lzp_table, NULL, netc_lzp_order2(dict),
+                                   (uint8_t *)dst);
             return NETC_OK;
         }
 
@@ -926,9 +1333,6 @@ netc_result_t netc_decompress_stateless(
             return NETC_OK;
         }
 
-        case NETC_ALG_RANS:
-            return NETC_ERR_UNSUPPORTED;
-
         default:
             return NETC_ERR_CORRUPT;
     }
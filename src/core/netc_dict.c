@@ -16,10 +16,21 @@
  *   IF NETC_DICT_FLAG_LZP set:
  *     [73992..73995] lzp_ht_size (uint32 LE) = NETC_LZP_HT_SIZE (131072)
  *     [73996..]      LZP entries (2B each) × lzp_ht_size
+ *   IF NETC_DICT_FLAG_BUCKETS set:
+ *     16 × uint16 LE bucket ends in 8-byte units (strictly ascending, last
+ *     = 8192); absent means netc_bucket_map_default
+ *   IF NETC_DICT_FLAG_DELTA_MAP set:
+ *     NETC_DELTA_MAP_LEN operators + tail + planes + 2 reserved (0)
+ *   IF NETC_DICT_FLAG_LZP2 set (requires NETC_DICT_FLAG_LZP):
+ *     [1] LZP order (= 2) + 3 reserved (0); the LZP entries then hold both
+ *     orders with trained confidences
+ *   IF NETC_DICT_FLAG_LZX set:
+ *     LZ77X token freq tables: 4 × 256 × uint16 LE (header, near offset,
+ *     far offset lo, far offset hi) = 2048 bytes
  *   [last 4]   checksum (uint32 LE, CRC32 of all preceding bytes)
  *
  * v5 base (no LZP): 8 + 256 + 8192 + 65536 + 4 = 73996 bytes.
- * v5 with LZP: 73992 + 4 + 131072*2 + 4 = 336144 bytes.
+ * v5 with LZP: 73992 + 4 + 131072*2 + 4 = 336144 bytes (+32 with buckets).
  *
  * v4 blob layout (backward-compat loading):
  *   [0..7]     header (same as v5, version=4)
@@ -27,14 +38,42 @@
  *   [8200..]   bigram freq: 16 × 4 × 256 × 2 = 32768B (4 classes, not 8)
  *   [40968..]  LZP section (if present)
  *   [last 4]   checksum
+ *
+ * Dictionary image (netc_dict_save_image / netc_dict_map), native layout:
+ *   [0..871]   netc_dict_image_hdr_t (byte order, table sizes, buckets,
+ *              class map, delta map)
+ *   [896..]    netc_dict_tables_t verbatim (tANS, bigram tANS, rANS,
+ *              LZ77X token tANS)
+ *   [64-aligned] LZP table as held in memory (if NETC_DICT_FLAG_LZP;
+ *              dual-order when dict_flags has NETC_DICT_FLAG_LZP2): packed,
+ *              netc_lzp_blk_t[NETC_LZP_BLK_COUNT] then lzp_count + pad
+ *              entries, or netc_lzp_entry_t[NETC_LZP_HT_SIZE] when
+ *              lzp_count > NETC_LZP_PACK_MAX
+ *   [last 4]   checksum (CRC32 of all preceding bytes)
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#  define _POSIX_C_SOURCE 200809L  /* open/fstat/mmap under -std=c11 */
+#endif
+
 #include "netc_internal.h"
 #include "../util/netc_crc32.h"
+#include "../util/netc_thread.h"
 #include "../simd/netc_simd.h"
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#  define DICT_HAVE_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 /* =========================================================================
  * Blob layout constants
  * ========================================================================= */
@@ -46,6 +85,17 @@
 /* LZP section: 4B lzp_ht_size + entries (2 bytes each) */
 #define DICT_LZP_ENTRY_BYTES  2U
 #define DICT_LZP_SECTION_SIZE (4U + NETC_LZP_HT_SIZE * DICT_LZP_ENTRY_BYTES)  /* 262148 */
+/* Bucket section: NETC_CTX_COUNT bucket ends as uint16 in 8-byte units */
+#define DICT_BUCKETS_SECTION_SIZE (NETC_CTX_COUNT * 2U)  /* 32 */
+#define DICT_BUCKET_UNIT      8U
+/* Delta map section: NETC_DELTA_MAP_LEN operators + tail + planes + 2 reserved (0) */
+#define DICT_DELTA_MAP_SECTION_SIZE (NETC_DELTA_MAP_LEN + 4U)  /* 516 */
+/* Dual-order LZP section: order (2) + 3 reserved (0).  Its size, not its
+ * content, is what makes older readers reject the blob. */
+#define DICT_LZP2_SECTION_SIZE 4U
+#define DICT_LZP2_ORDER        2U
+/* LZ77X token section: NETC_LZX_TABLES × 256 × uint16 LE frequencies */
+#define DICT_LZX_SECTION_SIZE  (NETC_LZX_TABLES * NETC_TANS_SYMBOLS * 2U)  /* 2048 */
 
 /* ----- v4 layout constants (backward-compat) ----- */
 /* Bigram freq: 16 × 4 × 256 × 2 = 32768 */
@@ -71,6 +121,10 @@ static size_t dict_blob_size_v(uint8_t version, uint8_t dict_flags) {
         sz = DICT_V4_BASE_SIZE;
     }
     if (dict_flags & NETC_DICT_FLAG_LZP) sz += DICT_LZP_SECTION_SIZE;
+    if (dict_flags & NETC_DICT_FLAG_BUCKETS) sz += DICT_BUCKETS_SECTION_SIZE;
+    if (dict_flags & NETC_DICT_FLAG_DELTA_MAP) sz += DICT_DELTA_MAP_SECTION_SIZE;
+    if (dict_flags & NETC_DICT_FLAG_LZP2) sz += DICT_LZP2_SECTION_SIZE;
+    if (dict_flags & NETC_DICT_FLAG_LZX) sz += DICT_LZX_SECTION_SIZE;
     sz += 4U; /* checksum */
     return sz;
 }
@@ -83,6 +137,146 @@ static uint32_t dict_blob_checksum(const uint8_t *blob, size_t blob_size) {
     return netc_crc32(blob, blob_size - 4U);
 }
 
+/* =========================================================================
+ * dict_build_rans — derive the runtime rANS tables from the unigram tables.
+ * Every valid tANS table has a 4096-sum frequency table, so this cannot fail
+ * for a dictionary that trained or loaded successfully.
+ * ========================================================================= */
+
+static void dict_build_rans(netc_dict_tables_t *t) {
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        if (!t->tables[b].valid ||
+            netc_rans_build(&t->rans_tables[b], &t->tables[b].freq) != 0)
+            t->rans_tables[b].valid = 0;
+    }
+}
+
+/* =========================================================================
+ * dict_buckets_set — position bucket map from its NETC_CTX_COUNT bucket ends
+ *
+ * Returns -1 unless the ends are strictly ascending multiples of 8 and the
+ * last is 65536; the interleaved PCTX decoders need every aligned group of
+ * 8 bytes to fall in one bucket.
+ * ========================================================================= */
+
+static int dict_buckets_set(netc_bucket_map_t *m, const uint32_t end[NETC_CTX_COUNT]) {
+    uint32_t prev = 0;
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        if (end[b] <= prev || (end[b] % DICT_BUCKET_UNIT) != 0) return -1;
+        prev = end[b];
+    }
+    if (prev != 65536U) return -1;
+
+    uint32_t b = 0;
+    for (uint32_t off = 0; off < 256U; off++) {
+        while (off >= end[b]) b++;
+        m->lut[off] = (uint8_t)b;
+    }
+    memcpy(m->end, end, sizeof(m->end));
+    return 0;
+}
+
+/* Append the bucket section to a blob under construction. */
+static size_t dict_write_buckets(uint8_t *blob, size_t off, const netc_bucket_map_t *m) {
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        netc_write_u16_le(blob + off, (uint16_t)(m->end[b] / DICT_BUCKET_UNIT));
+        off += 2;
+    }
+    return off;
+}
+
+/* Append the delta map section to a blob under construction. */
+static size_t dict_write_delta_map(uint8_t *blob, size_t off, const netc_delta_map_t *m) {
+    memcpy(blob + off, m->op, NETC_DELTA_MAP_LEN);
+    off += NETC_DELTA_MAP_LEN;
+    blob[off++] = m->tail;
+    blob[off++] = m->planes;
+    blob[off++] = 0;
+    blob[off++] = 0;
+    return off;
+}
+
+static size_t dict_write_lzp2(uint8_t *blob, size_t off) {
+    blob[off++] = DICT_LZP2_ORDER;
+    blob[off++] = 0;
+    blob[off++] = 0;
+    blob[off++] = 0;
+    return off;
+}
+
+static size_t dict_write_lzx(uint8_t *blob, size_t off, const netc_tans_table_t *t) {
+    for (uint32_t k = 0; k < NETC_LZX_TABLES; k++) {
+        for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
+            netc_write_u16_le(blob + off, t[k].freq.freq[s]);
+            off += 2;
+        }
+    }
+    return off;
+}
+
+/* =========================================================================
+ * dict_alloc — heap dictionary with owned, zeroed table storage
+ * ========================================================================= */
+
+static void dict_bigram_set_init(netc_dict_t *d) {
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c++)
+            d->bigram_set.t[b][c] = &d->bigram_tables[b][c];
+}
+
+static netc_dict_t *dict_alloc(void) {
+    netc_dict_t *d = (netc_dict_t *)calloc(1, sizeof(netc_dict_t));
+    if (NETC_UNLIKELY(d == NULL)) {
+        return NULL;
+    }
+    d->owned = (netc_dict_tables_t *)calloc(1, sizeof(netc_dict_tables_t));
+    if (NETC_UNLIKELY(d->owned == NULL)) {
+        free(d);
+        return NULL;
+    }
+    d->tables        = d->owned->tables;
+    d->bigram_tables = (const netc_tans_table_t (*)[NETC_BIGRAM_CTX_COUNT])
+                       d->owned->bigram_tables;
+    d->rans_tables   = d->owned->rans_tables;
+    d->lzx_tables    = d->owned->lzx_tables;
+    dict_bigram_set_init(d);
+    d->buckets       = netc_bucket_map_default;
+    d->delta_map     = netc_delta_map_default;
+    return d;
+}
+
+/* =========================================================================
+ * dict_lzp_pack — owned runtime copy of a dense LZP table
+ *
+ * Packed (netc_lzp_table_t) unless that would be larger than the dense
+ * table.  Empty slots carry no value, so the lookups are unchanged.
+ * ========================================================================= */
+
+static netc_result_t dict_lzp_pack(netc_dict_t *d, const netc_lzp_entry_t *dense) {
+    uint32_t count = netc_lzp_count(dense);
+    if (count > NETC_LZP_PACK_MAX) {
+        netc_lzp_entry_t *ent =
+            (netc_lzp_entry_t *)malloc(NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+        if (NETC_UNLIKELY(ent == NULL)) return NETC_ERR_NOMEM;
+        memcpy(ent, dense, NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+        d->owned_lzp     = ent;
+        d->lzp_table.blk = NULL;
+        d->lzp_table.ent = ent;
+        return NETC_OK;
+    }
+
+    uint8_t *mem = (uint8_t *)calloc(1, netc_lzp_pack_size(count));
+    if (NETC_UNLIKELY(mem == NULL)) return NETC_ERR_NOMEM;
+    netc_lzp_blk_t   *blk = (netc_lzp_blk_t *)(void *)mem;
+    netc_lzp_entry_t *ent =
+        (netc_lzp_entry_t *)(void *)(mem + NETC_LZP_BLK_COUNT * sizeof(netc_lzp_blk_t));
+    netc_lzp_pack(dense, blk, ent);
+    d->owned_lzp     = mem;
+    d->lzp_table.blk = blk;
+    d->lzp_table.ent = ent;
+    return NETC_OK;
+}
+
 /* =========================================================================
  * freq_normalize — scale raw counts to sum exactly to TABLE_SIZE (4096).
  *
@@ -163,363 +357,919 @@ static void freq_normalize(
 }
 
 /* =========================================================================
- * netc_dict_train
+ * Training shards
+ *
+ * Every phase of netc_dict_train_ex() is split into nthreads shards that
+ * produce exactly what the serial loop would:
+ *   - histograms (bigram class map, LZP-filtered frequencies) are sharded by
+ *     packet range into per-thread counters and summed afterwards;
+ *   - the LZP majority vote is order-dependent, so it is sharded by hash
+ *     slot range instead: each shard scans the whole corpus in order but
+ *     only touches its own slots;
+ *   - the bucket boundaries are chosen serially from the summed histograms;
+ *   - delta operator statistics are sharded by offset range: each shard
+ *     walks every consecutive packet pair but only counts its own offsets;
+ *   - the 16 + 16×8 tANS tables (and the 16 rANS tables) are independent
+ *     and built round-robin.
+ * The dictionary is therefore bit-identical for every thread count.
+ *
+ * The streaming trainer (netc_trainer_*) runs the class-map, vote and delta
+ * statistics packet by packet as data is fed, and the rest over its
+ * reservoir.
  * ========================================================================= */
 
-netc_result_t netc_dict_train(
-    const uint8_t * const *packets,
-    const size_t          *sizes,
-    size_t                 count,
-    uint8_t                model_id,
-    netc_dict_t          **out_dict)
-{
-    if (NETC_UNLIKELY(out_dict == NULL)) {
-        return NETC_ERR_INVALID_ARG;
+/* Boyer-Moore majority state per LZP slot */
+typedef struct { uint8_t candidate; int16_t count; } train_vote_t;
+
+/* One LZP slot in the order-1 table (o1) and the dual-order table (o2),
+ * kept side by side so an order-1 context touches one cache line */
+typedef struct { train_vote_t o1, o2; } train_lzp_vote_t;
+/* Phase 2b verification counters for the same slot pair */
+typedef struct { uint16_t seen1, hits1, seen2, hits2; } train_lzp_count_t;
+
+/* Offset granules: the candidate bucket boundaries. 8-byte steps up to 256,
+ * then coarser (32, 256, 2048, 16384) as offsets grow rarer. */
+#define TRAIN_GRANULES 77U
+
+/* One past the last offset of granule g */
+static uint32_t train_granule_end(uint32_t g) {
+    if (g < 32U) return (g + 1U) * 8U;
+    if (g < 56U) return 256U + (g - 31U) * 32U;
+    if (g < 68U) return 1024U + (g - 55U) * 256U;
+    if (g < 74U) return 4096U + (g - 67U) * 2048U;
+    return 16384U + (g - 73U) * 16384U;
+}
+
+/* Per-thread frequencies of the LZP-filtered corpus, per granule. Once the
+ * buckets are chosen, rows 0..NETC_CTX_COUNT-1 of hist[0] hold the
+ * per-bucket sums. */
+typedef struct {
+    uint64_t raw[TRAIN_GRANULES][NETC_TANS_SYMBOLS];
+    uint64_t totals[TRAIN_GRANULES];
+    uint64_t bgram_raw[TRAIN_GRANULES][NETC_BIGRAM_CTX_COUNT][NETC_TANS_SYMBOLS];
+    uint64_t bgram_totals[TRAIN_GRANULES][NETC_BIGRAM_CTX_COUNT];
+    uint8_t  filt[NETC_MAX_PACKET_SIZE];
+} train_hist_t;
+
+#define TRAIN_COND_SIZE   (256U * 256U)   /* prev byte × next byte */
+#define TRAIN_TABLE_COUNT (NETC_CTX_COUNT + NETC_CTX_COUNT * NETC_BIGRAM_CTX_COUNT)
+
+/* Delta operator statistics: for every offset and every NETC_DELTA_OP_*,
+ * the histogram of the residual byte that operator would leave there, over
+ * consecutive same-length packet pairs. Offsets past the map share four
+ * tail rows by offset % 4 (lanes stay aligned, as NETC_DELTA_MAP_LEN is a
+ * multiple of 4). 516 × 6 × 256 counters, ~6.3 MB. */
+#define TRAIN_DELTA_ROWS  (NETC_DELTA_MAP_LEN + 4U)
+#define TRAIN_DELTA_SIZE  ((size_t)TRAIN_DELTA_ROWS * NETC_DELTA_OP_COUNT * 256U)
+
+typedef struct {
+    const uint8_t * const *packets;
+    const size_t          *sizes;
+    size_t                 count;
+    uint32_t               nthreads;
+    uint32_t               lzp_order; /* netc_train_cfg_t.lzp_order */
+    netc_dict_t           *d;
+    uint64_t              *cond;     /* [nthreads][TRAIN_COND_SIZE] */
+    uint64_t              *delta;    /* [TRAIN_DELTA_SIZE], offset-sharded */
+    train_lzp_vote_t      *votes;    /* [NETC_LZP_HT_SIZE] */
+    train_lzp_count_t     *counts;   /* [2][NETC_LZP_HT_SIZE] bytes, candidate
+                                        matches, of the even / odd packets */
+    netc_lzp_entry_t      *lzp1;     /* order-1 candidate table (dense) */
+    netc_lzp_entry_t      *lzp2;     /* dual-order candidate table (dense) */
+    netc_lzp_entry_t      *fold;     /* [2][2][NETC_LZP_HT_SIZE]: the same two
+                                        tables from the even / odd packets,
+                                        NULL when the order is fixed */
+    uint64_t               lzp_hits[NETC_MAX_THREADS][3]; /* held-out bytes
+                                        predicted by each table, and scored */
+    train_hist_t          *hist;     /* [nthreads]; hist[0] holds the sum */
+    uint8_t                failed[NETC_MAX_THREADS];
+} train_job_t;
+
+/* [*lo, *hi) of n items for shard tid of parts */
+static void train_shard(size_t n, uint32_t parts, uint32_t tid, size_t *lo, size_t *hi) {
+    *lo = (size_t)(((uint64_t)n * tid) / parts);
+    *hi = (size_t)(((uint64_t)n * (tid + 1U)) / parts);
+}
+
+/* Usable length of a training packet (0 = skipped) */
+static size_t train_pkt_len(const uint8_t *pkt, size_t size) {
+    if (pkt == NULL || size == 0) return 0;
+    return (size > NETC_MAX_PACKET_SIZE) ? NETC_MAX_PACKET_SIZE : size;
+}
+
+/* Next-byte counts per previous byte, for the bigram class map */
+static void train_cond_packet(uint64_t *cond, const uint8_t *pkt, size_t pkt_size) {
+    for (size_t i = 0; i < pkt_size; i++) {
+        uint8_t prev = (i > 0) ? pkt[i - 1] : 0x00u;
+        cond[(size_t)prev * 256 + pkt[i]]++;
     }
-    if (NETC_UNLIKELY(model_id == 0 || model_id == 255)) {
-        return NETC_ERR_INVALID_ARG;
+}
+
+static void train_vote(train_vote_t *v, uint8_t byte_val) {
+    if (v->count == 0) {
+        v->candidate = byte_val;
+        v->count     = 1;
+    } else if (v->candidate == byte_val) {
+        if (v->count < INT16_MAX) v->count++;
+    } else {
+        v->count--;
     }
-    if (NETC_UNLIKELY(count > 0 && (packets == NULL || sizes == NULL))) {
-        return NETC_ERR_INVALID_ARG;
+}
+
+/* Boyer-Moore majority vote for the LZP slots in [slot_lo, slot_lo + span):
+ * order-1 contexts in both tables, order-2 contexts in the dual-order one. */
+static void train_vote_packet(train_lzp_vote_t *votes, const uint8_t *pkt, size_t pkt_size,
+                              uint32_t slot_lo, uint32_t span) {
+    for (size_t i = 0; i < pkt_size; i++) {
+        uint8_t  prev  = (i > 0) ? pkt[i - 1] : 0x00u;
+        uint8_t  prev2 = (i > 1) ? pkt[i - 2] : 0x00u;
+        uint32_t h  = netc_lzp_hash(prev, (uint32_t)i);
+        uint32_t h2 = netc_lzp_hash2(prev2, prev, (uint32_t)i);
+        if (h - slot_lo < span) {
+            train_vote(&votes[h].o1, pkt[i]);
+            train_vote(&votes[h].o2, pkt[i]);
+        }
+        if (h2 - slot_lo < span) train_vote(&votes[h2].o2, pkt[i]);
     }
+}
 
-    netc_dict_t *d = (netc_dict_t *)calloc(1, sizeof(netc_dict_t));
-    if (NETC_UNLIKELY(d == NULL)) {
-        return NETC_ERR_NOMEM;
+/* Delta residual counts of the quad at offset q (a multiple of 4). The
+ * residuals of all six operators are formed as 32-bit words; byte k of
+ * each word is the residual at offset q + k. */
+static void train_delta_quad(uint64_t *delta, const uint8_t *prev, const uint8_t *curr,
+                             size_t len, size_t q) {
+    size_t   w = (len - q < 4U) ? len - q : 4U;
+    uint32_t c = netc_delta_lane_ld(curr + q, w);
+    uint32_t p = netc_delta_lane_ld(prev + q, w);
+    uint32_t r[NETC_DELTA_OP_COUNT];
+    r[NETC_DELTA_OP_XOR]   = c ^ p;
+    r[NETC_DELTA_OP_SUB]   = ((c | 0x80808080U) - (p & 0x7F7F7F7FU)) ^
+                             ((c ^ ~p) & 0x80808080U);
+    r[NETC_DELTA_OP_NONE]  = c;
+    r[NETC_DELTA_OP_SUB16] = ((c - p) & 0xFFFFU) | (((c >> 16) - (p >> 16)) << 16);
+    r[NETC_DELTA_OP_SUB32] = c - p;
+    r[NETC_DELTA_OP_FLT32] = netc_delta_lane_enc(NETC_DELTA_OP_FLT32, w, c, p);
+    uint64_t *h = delta + (q < NETC_DELTA_MAP_LEN ? q : NETC_DELTA_MAP_LEN) *
+                          NETC_DELTA_OP_COUNT * 256U;
+    for (size_t k = 0; k < w; k++, h += NETC_DELTA_OP_COUNT * 256U) {
+        const uint32_t sh = 8U * (uint32_t)k;
+        h[NETC_DELTA_OP_XOR  * 256U + (uint8_t)(r[NETC_DELTA_OP_XOR]  >> sh)]++;
+        h[NETC_DELTA_OP_SUB  * 256U + (uint8_t)(r[NETC_DELTA_OP_SUB]  >> sh)]++;
+        h[NETC_DELTA_OP_NONE * 256U + (uint8_t)(r[NETC_DELTA_OP_NONE] >> sh)]++;
+        h[NETC_DELTA_OP_FLT32 * 256U + (uint8_t)(r[NETC_DELTA_OP_FLT32] >> sh)]++;
+        /* Lane bytes with no borrow in yet equal a narrower operator's
+         * (see train_delta_map) and are not counted twice */
+        if (k & 1U) h[NETC_DELTA_OP_SUB16 * 256U + (uint8_t)(r[NETC_DELTA_OP_SUB16] >> sh)]++;
+        if (k >= 2U) h[NETC_DELTA_OP_SUB32 * 256U + (uint8_t)(r[NETC_DELTA_OP_SUB32] >> sh)]++;
     }
+}
 
-    d->magic      = NETC_DICT_MAGIC;
-    d->version    = NETC_DICT_VERSION;
-    d->model_id   = model_id;
-    d->ctx_count  = (uint8_t)NETC_CTX_COUNT;
-    d->dict_flags = 0;
-    d->lzp_table  = NULL;
-    d->bigram_class_count = NETC_BIGRAM_CTX_COUNT;  /* 8 */
+/* Delta residual counts of the pair prev -> curr (both len bytes) for rows
+ * [row_lo, row_hi), multiples of 4. The tail rows cover every offset past
+ * the map, so the shard that owns them walks the rest of the packet. */
+static void train_delta_pair(uint64_t *delta, const uint8_t *prev, const uint8_t *curr,
+                             size_t len, uint32_t row_lo, uint32_t row_hi) {
+    size_t end = (row_hi < NETC_DELTA_MAP_LEN) ? row_hi : NETC_DELTA_MAP_LEN;
+    if (end > len) end = len;
+    for (size_t q = row_lo; q < end; q += 4U) train_delta_quad(delta, prev, curr, len, q);
+    if (row_hi > NETC_DELTA_MAP_LEN) {
+        for (size_t q = NETC_DELTA_MAP_LEN; q < len; q += 4U)
+            train_delta_quad(delta, prev, curr, len, q);
+    }
+}
 
-    /* --- Phase 2a: accumulate unigram byte frequencies per context bucket --- */
-    uint64_t raw[NETC_CTX_COUNT][NETC_TANS_SYMBOLS];
-    uint64_t totals[NETC_CTX_COUNT];
-    memset(raw,    0, sizeof(raw));
-    memset(totals, 0, sizeof(totals));
+/* Phase 1: class-map counts over one packet shard */
+static void train_cond_worker(void *arg, uint32_t tid) {
+    train_job_t *job = (train_job_t *)arg;
+    uint64_t *cond = job->cond + (size_t)tid * TRAIN_COND_SIZE;
+    size_t lo, hi;
+    train_shard(job->count, job->nthreads, tid, &lo, &hi);
+    for (size_t p = lo; p < hi; p++) {
+        train_cond_packet(cond, job->packets[p],
+                          train_pkt_len(job->packets[p], job->sizes[p]));
+    }
+}
 
-    /* Bucket boundary table: bucket b covers byte positions [bucket_start[b], bucket_start[b+1]).
-     * Mirrors the netc_ctx_bucket() LUT thresholds exactly. */
-    static const uint32_t bucket_end[NETC_CTX_COUNT] = {
-           8,   16,   24,   32,   48,   64,   96,  128,
-         192,  256,  384,  512, 1024, 4096, 16384, 65536
-    };
+/* Phase 1b: delta statistics over every consecutive pair of usable
+ * packets, one quad-aligned row range. The range is walked in blocks of
+ * TRAIN_DELTA_BLOCK rows (48 KB of counters) so each pass over the corpus
+ * updates a working set that stays in L1. */
+#define TRAIN_DELTA_BLOCK 4U
+
+static void train_delta_worker(void *arg, uint32_t tid) {
+    train_job_t *job = (train_job_t *)arg;
+    size_t lo, hi;
+    train_shard(TRAIN_DELTA_ROWS / 4U, job->nthreads, tid, &lo, &hi);
+    for (uint32_t r = (uint32_t)lo * 4U; r < (uint32_t)hi * 4U; r += TRAIN_DELTA_BLOCK) {
+        uint32_t r_hi = r + TRAIN_DELTA_BLOCK;
+        if (r_hi > (uint32_t)hi * 4U) r_hi = (uint32_t)hi * 4U;
+        const uint8_t *prev = NULL;
+        size_t prev_size = 0;
+        for (size_t p = 0; p < job->count; p++) {
+            size_t pkt_size = train_pkt_len(job->packets[p], job->sizes[p]);
+            if (pkt_size == 0) continue;
+            if (pkt_size == prev_size && r < pkt_size) {
+                train_delta_pair(job->delta, prev, job->packets[p], pkt_size, r, r_hi);
+            }
+            prev      = job->packets[p];
+            prev_size = pkt_size;
+        }
+    }
+}
 
-    /* Use SIMD-dispatched freq_count for each contiguous bucket range within the packet.
-     * tmp_freq accumulates into a uint32_t[256] scratch buffer (fits in L1 cache);
-     * results are promoted to the uint64_t raw table after each bucket. */
-    netc_simd_ops_t simd_ops;
-    netc_simd_ops_init(&simd_ops, NETC_SIMD_LEVEL_AUTO);
+/* Phase 2a: LZP majority vote across all training packets, one slot range,
+ * for the order-1 and the dual-order table */
+static void train_vote_worker(void *arg, uint32_t tid) {
+    train_job_t *job = (train_job_t *)arg;
+    size_t lo, hi;
+    train_shard(NETC_LZP_HT_SIZE, job->nthreads, tid, &lo, &hi);
+    for (size_t p = 0; p < job->count; p++) {
+        size_t pkt_size = train_pkt_len(job->packets[p], job->sizes[p]);
+        train_vote_packet(job->votes, job->packets[p], pkt_size,
+                          (uint32_t)lo, (uint32_t)(hi - lo));
+    }
+}
 
-    uint32_t tmp_freq[NETC_TANS_SYMBOLS];
+/* Confidence of a dual-order entry: its net votes over the corpus, the
+ * value a netc_lzp_learn counter would hold after replaying it from 1,
+ * clamped to 1..255. */
+static uint8_t train_lzp_confidence(uint32_t seen, uint32_t hits) {
+    uint32_t misses = seen - hits;
+    if (hits <= misses) return 1;
+    return (hits - misses >= 255U) ? 255U : (uint8_t)(hits - misses);
+}
 
-    for (size_t p = 0; p < count; p++) {
-        if (packets[p] == NULL || sizes[p] == 0) continue;
-        size_t pkt_size = sizes[p];
-        if (pkt_size > NETC_MAX_PACKET_SIZE) pkt_size = NETC_MAX_PACKET_SIZE;
-        const uint8_t *pkt = packets[p];
+/* Count one byte against a slot's candidate */
+static void train_verify_slot(uint16_t *seen, uint16_t *hits, const train_vote_t *v,
+                              uint8_t byte_val) {
+    if (*seen < 0xFFFFU) (*seen)++;
+    if (byte_val == v->candidate && *hits < 0xFFFFU) (*hits)++;
+}
 
-        uint32_t seg_start = 0;
-        for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
-            if (seg_start >= (uint32_t)pkt_size) break;
-            uint32_t seg_end = bucket_end[b];
-            if (seg_end > (uint32_t)pkt_size) seg_end = (uint32_t)pkt_size;
-            uint32_t seg_len = seg_end - seg_start;
+/* Set slot h of the order-1 table t1 and the dual-order table t2 from its
+ * verification counts: valid only if hit_rate >= 40% and total >= 2 */
+static void train_lzp_fill(netc_lzp_entry_t *t1, netc_lzp_entry_t *t2, uint32_t h,
+                           const train_lzp_vote_t *v, const train_lzp_count_t *c) {
+    if (c->seen1 >= 2 && (uint32_t)c->hits1 * 10u >= (uint32_t)c->seen1 * 4u) {
+        t1[h].value = v->o1.candidate;
+        t1[h].valid = 1;
+    }
+    if (c->seen2 >= 2 && (uint32_t)c->hits2 * 10u >= (uint32_t)c->seen2 * 4u) {
+        t2[h].value = v->o2.candidate;
+        t2[h].valid = train_lzp_confidence(c->seen2, c->hits2);
+    }
+}
 
-            memset(tmp_freq, 0, sizeof(tmp_freq));
-            simd_ops.freq_count(pkt + seg_start, (size_t)seg_len, tmp_freq);
-            for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
-                raw[b][s] += tmp_freq[s];
+/* Saturating sum of two 16-bit counters */
+static uint16_t train_sat_add16(uint16_t a, uint16_t b) {
+    uint32_t s = (uint32_t)a + b;
+    return (s > 0xFFFFU) ? (uint16_t)0xFFFFU : (uint16_t)s;
+}
+
+/* Phase 2b: verify candidates — count actual frequency of the majority
+ * candidate, then fill the LZP tables for one slot range.
+ * Boyer-Moore only guarantees majority if >50%; we verify and set valid
+ * only when the candidate appears in >= 40% of slot occurrences (generous
+ * threshold since even 40% hit rate saves significant bytes).  The
+ * order-1 table marks entries valid = 1; the dual-order table stores
+ * their confidence. Even and odd packets are counted apart, and each half
+ * also fills its own pair of tables for phase 2c when it runs. */
+static void train_verify_worker(void *arg, uint32_t tid) {
+    train_job_t *job = (train_job_t *)arg;
+    size_t lo, hi;
+    train_shard(NETC_LZP_HT_SIZE, job->nthreads, tid, &lo, &hi);
+    const uint32_t slot_lo = (uint32_t)lo, span = (uint32_t)(hi - lo);
+    train_lzp_count_t *c = job->counts;
+    const train_lzp_vote_t *v = job->votes;
+
+    for (size_t p = 0; p < job->count; p++) {
+        size_t pkt_size = train_pkt_len(job->packets[p], job->sizes[p]);
+        const uint8_t *pkt = job->packets[p];
+        train_lzp_count_t *cf = c + (p & 1U) * NETC_LZP_HT_SIZE;
+        for (size_t i = 0; i < pkt_size; i++) {
+            uint8_t  prev  = (i > 0) ? pkt[i - 1] : 0x00u;
+            uint8_t  prev2 = (i > 1) ? pkt[i - 2] : 0x00u;
+            uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
+            if (h - slot_lo < span) {
+                train_verify_slot(&cf[h].seen1, &cf[h].hits1, &v[h].o1, pkt[i]);
+                train_verify_slot(&cf[h].seen2, &cf[h].hits2, &v[h].o2, pkt[i]);
             }
-            totals[b] += seg_len;
-            seg_start = seg_end;
+            h = netc_lzp_hash2(prev2, prev, (uint32_t)i);
+            if (h - slot_lo < span)
+                train_verify_slot(&cf[h].seen2, &cf[h].hits2, &v[h].o2, pkt[i]);
         }
     }
 
-    /* --- Phase 2b: build bigram class_map via frequency-based clustering --- */
-    /* For each prev_byte value (0-255), compute the most-frequent next-symbol
-     * (aggregated across all buckets). Sort prev_bytes by their most-frequent
-     * symbol index, then divide into 8 equal groups of 32. */
-    {
-        /* cond_peak[prev] = the symbol that occurs most often after prev (all buckets) */
-        uint16_t cond_peak[256];
-        /* Per prev_byte, accumulate total next-symbol counts across all buckets */
-        uint64_t *cond_counts = (uint64_t *)calloc(256, 256 * sizeof(uint64_t));
-        if (NETC_UNLIKELY(cond_counts == NULL)) {
-            free(d);
-            return NETC_ERR_NOMEM;
+    netc_lzp_entry_t *fold = job->fold;
+    for (uint32_t h = slot_lo; h < slot_lo + span; h++) {
+        const train_lzp_count_t *even = &c[h], *odd = &c[NETC_LZP_HT_SIZE + h];
+        train_lzp_count_t all = {
+            train_sat_add16(even->seen1, odd->seen1), train_sat_add16(even->hits1, odd->hits1),
+            train_sat_add16(even->seen2, odd->seen2), train_sat_add16(even->hits2, odd->hits2)
+        };
+        train_lzp_fill(job->lzp1, job->lzp2, h, &v[h], &all);
+        if (fold == NULL) continue;
+        train_lzp_fill(fold, fold + NETC_LZP_HT_SIZE, h, &v[h], even);
+        train_lzp_fill(fold + 2U * NETC_LZP_HT_SIZE, fold + 3U * NETC_LZP_HT_SIZE,
+                       h, &v[h], odd);
+    }
+}
+
+/* The dual-order table replaces the order-1 table only when it predicts at
+ * least 1/2^GAIN more held-out bytes: it fills the table faster, and
+ * adaptive contexts learn twice per byte. The gain must also exceed
+ * 1/256 of the bytes scored, the rate at which a guess on random data
+ * hits by chance. */
+#define TRAIN_LZP2_GAIN 6U
+
+/* Phase 2c: bytes each table predicts over one packet shard, scoring every
+ * packet against the tables of the other half of the corpus. In-sample
+ * hits overrate the dual-order table, whose order-2 slots memorise
+ * the corpus and overwrite order-1 slots that generalise. */
+static void train_lzp_eval_worker(void *arg, uint32_t tid) {
+    train_job_t *job = (train_job_t *)arg;
+    size_t lo, hi;
+    train_shard(job->count, job->nthreads, tid, &lo, &hi);
+    uint64_t n1 = 0, n2 = 0, bytes = 0;
+    for (size_t p = lo; p < hi; p++) {
+        size_t pkt_size = train_pkt_len(job->packets[p], job->sizes[p]);
+        const uint8_t *pkt = job->packets[p];
+        bytes += pkt_size;
+        const netc_lzp_entry_t *other = job->fold + ((~p & 1U) * 2U) * NETC_LZP_HT_SIZE;
+        const netc_lzp_table_t t1 = { NULL, other }, t2 = { NULL, other + NETC_LZP_HT_SIZE };
+        for (size_t i = 0; i < pkt_size; i++) {
+            uint8_t prev  = (i > 0) ? pkt[i - 1] : 0x00u;
+            uint8_t prev2 = (i > 1) ? pkt[i - 2] : 0x00u;
+            n1 += netc_lzp_guess(&t1, NULL, 0, prev2, prev, (uint32_t)i) == pkt[i];
+            n2 += netc_lzp_guess(&t2, NULL, 1, prev2, prev, (uint32_t)i) == pkt[i];
         }
+    }
+    job->lzp_hits[tid][0] = n1;
+    job->lzp_hits[tid][1] = n2;
+    job->lzp_hits[tid][2] = bytes;
+}
 
-        for (size_t p = 0; p < count; p++) {
-            if (packets[p] == NULL || sizes[p] == 0) continue;
-            size_t pkt_size = sizes[p];
-            if (pkt_size > NETC_MAX_PACKET_SIZE) pkt_size = NETC_MAX_PACKET_SIZE;
-            const uint8_t *pkt = packets[p];
-            for (size_t i = 0; i < pkt_size; i++) {
-                uint8_t prev = (i > 0) ? pkt[i - 1] : 0x00u;
-                cond_counts[(size_t)prev * 256 + pkt[i]]++;
-            }
+/* Phase 3: unigram + bigram frequencies of the LZP-filtered corpus.
+ * When LZP is trained, the compressor will XOR each byte with its LZP
+ * prediction before tANS encoding.  Correctly-predicted bytes become 0x00.
+ * The tANS tables must match this post-filter distribution. */
+static void train_hist_worker(void *arg, uint32_t tid) {
+    train_job_t  *job = (train_job_t *)arg;
+    train_hist_t *hs  = &job->hist[tid];
+    const netc_dict_t *d = job->d;
+    size_t lo, hi;
+    train_shard(job->count, job->nthreads, tid, &lo, &hi);
+    for (size_t p = lo; p < hi; p++) {
+        size_t pkt_size = train_pkt_len(job->packets[p], job->sizes[p]);
+        if (pkt_size == 0) continue;
+
+        /* Apply LZP XOR filter to this packet */
+        d->simd_ops.lzp_filter(&d->lzp_table, netc_lzp_order2(d), job->packets[p],
+                               hs->filt, pkt_size);
+
+        uint32_t g = 0, g_end = train_granule_end(0);
+        for (size_t i = 0; i < pkt_size; i++) {
+            if (i >= g_end) g_end = train_granule_end(++g);
+            uint8_t sym = hs->filt[i];
+            hs->raw[g][sym]++;
+            hs->totals[g]++;
+            uint8_t prev = (i > 0) ? hs->filt[i - 1] : 0x00u;
+            uint32_t bclass = netc_bigram_class(prev, d->bigram_class_map);
+            hs->bgram_raw[g][bclass][sym]++;
+            hs->bgram_totals[g][bclass]++;
         }
+    }
+}
 
-        /* Find the peak symbol for each prev_byte */
-        for (uint32_t prev = 0; prev < 256; prev++) {
-            uint64_t best = 0;
-            uint16_t best_sym = 0;
-            for (uint32_t s = 0; s < 256; s++) {
-                uint64_t c = cond_counts[(size_t)prev * 256 + s];
-                if (c > best) { best = c; best_sym = (uint16_t)s; }
-            }
-            cond_peak[prev] = best_sym;
-        }
-        free(cond_counts);
-
-        /* Sort prev_byte indices by their peak symbol to cluster similar contexts.
-         * Simple insertion sort on 256 elements (indices 0-255). */
-        uint16_t sorted_prev[256];
-        for (uint32_t i = 0; i < 256; i++) sorted_prev[i] = (uint16_t)i;
-        for (uint32_t i = 1; i < 256; i++) {
-            uint16_t key = sorted_prev[i];
-            uint16_t key_peak = cond_peak[key];
-            int j = (int)i - 1;
-            while (j >= 0 && cond_peak[sorted_prev[j]] > key_peak) {
-                sorted_prev[j + 1] = sorted_prev[j];
-                j--;
+/* Phase 4: normalize the summed frequencies and build the tables.
+ * Table k < NETC_CTX_COUNT is unigram bucket k (plus its rANS twin);
+ * the rest are bigram tables in [bucket][class] order. */
+static void train_build_worker(void *arg, uint32_t tid) {
+    train_job_t  *job = (train_job_t *)arg;
+    const train_hist_t *hs = &job->hist[0];
+    netc_dict_tables_t *t  = job->d->owned;
+    for (uint32_t k = tid; k < TRAIN_TABLE_COUNT; k += job->nthreads) {
+        netc_freq_table_t ft;
+        if (k < NETC_CTX_COUNT) {
+            freq_normalize(hs->raw[k], hs->totals[k], ft.freq);
+            if (netc_tans_build(&t->tables[k], &ft) != 0) {
+                job->failed[tid] = 1;
+                continue;
             }
-            sorted_prev[j + 1] = key;
+            if (netc_rans_build(&t->rans_tables[k], &t->tables[k].freq) != 0)
+                t->rans_tables[k].valid = 0;
+        } else {
+            uint32_t b = (k - NETC_CTX_COUNT) / NETC_BIGRAM_CTX_COUNT;
+            uint32_t c = (k - NETC_CTX_COUNT) % NETC_BIGRAM_CTX_COUNT;
+            freq_normalize(hs->bgram_raw[b][c], hs->bgram_totals[b][c], ft.freq);
+            if (netc_tans_build(&t->bigram_tables[b][c], &ft) != 0)
+                job->failed[tid] = 1;
         }
+    }
+}
 
-        /* Divide sorted prev_bytes into 8 equal groups of 32 */
-        for (uint32_t g = 0; g < NETC_BIGRAM_CTX_COUNT; g++) {
-            for (uint32_t k = 0; k < 32; k++) {
-                uint16_t prev_idx = sorted_prev[g * 32 + k];
-                d->bigram_class_map[prev_idx] = (uint8_t)g;
-            }
+/* Bigram class map from the summed phase-1 counts.
+ * For each prev_byte value (0-255), compute the most-frequent next-symbol
+ * (aggregated across all buckets). Sort prev_bytes by their most-frequent
+ * symbol index, then divide into 8 equal groups of 32. */
+static void train_class_map(netc_dict_t *d, const uint64_t *cond_counts) {
+    /* cond_peak[prev] = the symbol that occurs most often after prev (all buckets) */
+    uint16_t cond_peak[256];
+    for (uint32_t prev = 0; prev < 256; prev++) {
+        uint64_t best = 0;
+        uint16_t best_sym = 0;
+        for (uint32_t s = 0; s < 256; s++) {
+            uint64_t c = cond_counts[(size_t)prev * 256 + s];
+            if (c > best) { best = c; best_sym = (uint16_t)s; }
         }
+        cond_peak[prev] = best_sym;
     }
 
-    /* --- Phase 2c: accumulate bigram frequencies using trained class_map --- */
-    /* Bigram raw counts: [bucket][bigram_class][symbol] — now 8 classes */
-    uint64_t (*bgram_raw)[NETC_BIGRAM_CTX_COUNT][NETC_TANS_SYMBOLS] =
-        (uint64_t (*)[NETC_BIGRAM_CTX_COUNT][NETC_TANS_SYMBOLS])
-        calloc(NETC_CTX_COUNT, sizeof((*bgram_raw)));
-    uint64_t bgram_totals[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
-    if (NETC_UNLIKELY(bgram_raw == NULL)) {
-        free(d);
+    /* Sort prev_byte indices by their peak symbol to cluster similar contexts.
+     * Simple insertion sort on 256 elements (indices 0-255). */
+    uint16_t sorted_prev[256];
+    for (uint32_t i = 0; i < 256; i++) sorted_prev[i] = (uint16_t)i;
+    for (uint32_t i = 1; i < 256; i++) {
+        uint16_t key = sorted_prev[i];
+        uint16_t key_peak = cond_peak[key];
+        int j = (int)i - 1;
+        while (j >= 0 && cond_peak[sorted_prev[j]] > key_peak) {
+            sorted_prev[j + 1] = sorted_prev[j];
+            j--;
+        }
+        sorted_prev[j + 1] = key;
+    }
+
+    /* Divide sorted prev_bytes into 8 equal groups of 32 */
+    for (uint32_t g = 0; g < NETC_BIGRAM_CTX_COUNT; g++) {
+        for (uint32_t k = 0; k < 32; k++) {
+            uint16_t prev_idx = sorted_prev[g * 32 + k];
+            d->bigram_class_map[prev_idx] = (uint8_t)g;
+        }
+    }
+}
+
+/* Coded size (Q8 bits) of counts c[] under the table freq_normalize builds
+ * for them. */
+static uint64_t train_segment_cost(const uint64_t c[NETC_TANS_SYMBOLS], uint64_t total) {
+    if (total == 0) return 0;
+    uint16_t f[NETC_TANS_SYMBOLS];
+    freq_normalize(c, total, f);
+    const uint32_t full = netc_tans_log2_q8(NETC_TANS_TABLE_SIZE);
+    uint64_t bits = 0;
+    for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
+        if (c[s] != 0) bits += c[s] * (uint64_t)(full - netc_tans_log2_q8(f[s]));
+    }
+    return bits;
+}
+
+/* Bucket boundaries from the summed granule histograms: split the
+ * TRAIN_GRANULES granules into exactly NETC_CTX_COUNT contiguous runs so the
+ * unigram coded size of the corpus is minimal (dynamic programming over
+ * prefix splits, O(G^2) segment costs). The static layout is one of the
+ * candidates, so the learned one never codes the corpus larger. Rows
+ * 0..NETC_CTX_COUNT-1 of hs are then replaced by the per-bucket sums. */
+static netc_result_t train_buckets(netc_dict_t *d, train_hist_t *hs) {
+    enum { G = TRAIN_GRANULES, K = NETC_CTX_COUNT };
+    uint64_t *cost = (uint64_t *)malloc(sizeof(uint64_t) * (G + 1U) * (G + 1U));
+    uint64_t *best = (uint64_t *)malloc(sizeof(uint64_t) * (K + 1U) * (G + 1U));
+    uint8_t  *from = (uint8_t *)malloc((K + 1U) * (G + 1U));
+    if (NETC_UNLIKELY(cost == NULL || best == NULL || from == NULL)) {
+        free(cost); free(best); free(from);
         return NETC_ERR_NOMEM;
     }
-    memset(bgram_totals, 0, sizeof(bgram_totals));
 
-    for (size_t p = 0; p < count; p++) {
-        if (packets[p] == NULL || sizes[p] == 0) continue;
-        size_t pkt_size = sizes[p];
-        if (pkt_size > NETC_MAX_PACKET_SIZE) pkt_size = NETC_MAX_PACKET_SIZE;
-        const uint8_t *pkt = packets[p];
-        for (size_t i = 0; i < pkt_size; i++) {
-            uint32_t bucket = netc_ctx_bucket((uint32_t)i);
-            uint8_t sym = pkt[i];
-            /* Use trained class_map for bigram context */
-            uint8_t prev = (i > 0) ? pkt[i - 1] : 0x00u;
-            uint32_t bclass = netc_bigram_class(prev, d->bigram_class_map);
-            bgram_raw[bucket][bclass][sym]++;
-            bgram_totals[bucket][bclass]++;
+    /* cost[a][b]: granules [a, b) coded with one table */
+    for (uint32_t a = 0; a < G; a++) {
+        uint64_t c[NETC_TANS_SYMBOLS] = {0};
+        uint64_t total = 0;
+        for (uint32_t b = a + 1U; b <= G; b++) {
+            for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) c[s] += hs->raw[b - 1U][s];
+            total += hs->totals[b - 1U];
+            cost[a * (G + 1U) + b] = train_segment_cost(c, total);
         }
     }
 
-    /* --- Normalize unigram frequencies and build tANS tables --- */
-    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
-        netc_freq_table_t ft;
-        freq_normalize(raw[b], totals[b], ft.freq);
-        if (netc_tans_build(&d->tables[b], &ft) != 0) {
-            free(bgram_raw);
-            free(d);
-            return NETC_ERR_NOMEM; /* table build failure (should not happen) */
+    /* best[k][b]: cheapest split of granules [0, b) into k runs */
+    for (uint32_t b = 1; b <= G; b++) {
+        best[1U * (G + 1U) + b] = cost[b];
+        from[1U * (G + 1U) + b] = 0;
+    }
+    for (uint32_t k = 2; k <= K; k++) {
+        for (uint32_t b = k; b <= G; b++) {
+            uint64_t bc = UINT64_MAX;
+            uint32_t ba = k - 1U;
+            for (uint32_t a = k - 1U; a < b; a++) {
+                uint64_t v = best[(k - 1U) * (G + 1U) + a] + cost[a * (G + 1U) + b];
+                if (v < bc) { bc = v; ba = a; }
+            }
+            best[k * (G + 1U) + b] = bc;
+            from[k * (G + 1U) + b] = (uint8_t)ba;
         }
     }
 
-    /* --- Normalize bigram frequencies and build bigram tANS sub-tables --- */
-    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+    uint32_t first[K + 1U];     /* bucket k covers granules [first[k], first[k+1]) */
+    uint32_t end[K];
+    first[K] = G;
+    for (uint32_t k = K; k >= 1U; k--) {
+        first[k - 1U] = from[k * (G + 1U) + first[k]];
+        end[k - 1U]   = train_granule_end(first[k] - 1U);
+    }
+
+    /* Keep the static layout unless the learned one is strictly smaller
+     * (an empty or uniform corpus ties everywhere). */
+    uint32_t sfirst[K + 1U];
+    uint64_t scost = 0;
+    sfirst[0] = 0;
+    for (uint32_t k = 0; k < K; k++) {
+        uint32_t g = sfirst[k];
+        while (train_granule_end(g) < netc_bucket_map_default.end[k]) g++;
+        sfirst[k + 1U] = g + 1U;
+        scost += cost[sfirst[k] * (G + 1U) + sfirst[k + 1U]];
+    }
+    if (best[K * (G + 1U) + G] >= scost) {
+        memcpy(first, sfirst, sizeof(first));
+        memcpy(end, netc_bucket_map_default.end, sizeof(end));
+    }
+    free(cost); free(best); free(from);
+
+    if (dict_buckets_set(&d->buckets, end) != 0) return NETC_ERR_NOMEM; /* cannot happen */
+    if (memcmp(d->buckets.end, netc_bucket_map_default.end, sizeof(end)) != 0)
+        d->dict_flags |= NETC_DICT_FLAG_BUCKETS;
+
+    /* Fold granule rows into bucket rows in place: bucket k only reads rows
+     * >= first[k] >= k, none of which an earlier bucket has overwritten. */
+    for (uint32_t k = 0; k < K; k++) {
+        uint32_t ga = first[k], gb = first[k + 1U];
+        if (ga == k && gb == k + 1U) continue;
+        for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
+            uint64_t v = 0;
+            for (uint32_t g = ga; g < gb; g++) v += hs->raw[g][s];
+            hs->raw[k][s] = v;
+        }
+        uint64_t t = 0;
+        for (uint32_t g = ga; g < gb; g++) t += hs->totals[g];
+        hs->totals[k] = t;
         for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c++) {
-            netc_freq_table_t ft;
-            freq_normalize(bgram_raw[b][c], bgram_totals[b][c], ft.freq);
-            if (netc_tans_build(&d->bigram_tables[b][c], &ft) != 0) {
-                free(bgram_raw);
-                free(d);
-                return NETC_ERR_NOMEM;
+            for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
+                uint64_t v = 0;
+                for (uint32_t g = ga; g < gb; g++) v += hs->bgram_raw[g][c][s];
+                hs->bgram_raw[k][c][s] = v;
             }
+            uint64_t bt = 0;
+            for (uint32_t g = ga; g < gb; g++) bt += hs->bgram_totals[g][c];
+            hs->bgram_totals[k][c] = bt;
         }
     }
-    free(bgram_raw);
+    return NETC_OK;
+}
 
-    /* --- Phase 4: LZP hash table training (Boyer-Moore majority vote) --- */
-    /* For each (prev_byte, position) context, find the most common byte.
-     * Uses position-aware order-1 hashing: hash(prev_byte, byte_offset).
-     * Boyer-Moore majority element algorithm: O(1) space per slot.
-     *   - If current candidate matches: increment vote count
-     *   - If vote count is zero: replace candidate, count = 1
-     *   - Otherwise: decrement vote count (cancel one opposite vote)
-     * After all training data, the candidate is the majority element if
-     * one exists (>50% frequency at this hash slot). */
-    {
-        /* Training state: candidate + vote count per hash slot */
-        typedef struct { uint8_t candidate; int16_t count; } lzp_vote_t;
-        lzp_vote_t *votes = (lzp_vote_t *)calloc(NETC_LZP_HT_SIZE, sizeof(lzp_vote_t));
-        /* Total hit count per slot (to compute validity threshold) */
-        uint16_t *slot_total = (uint16_t *)calloc(NETC_LZP_HT_SIZE, sizeof(uint16_t));
-        if (NETC_UNLIKELY(votes == NULL || slot_total == NULL)) {
-            free(votes);
-            free(slot_total);
-            free(d);
-            return NETC_ERR_NOMEM;
+/* Delta operator map from the summed statistics, once the tables are
+ * built. An operator's cost at an offset is what the residuals it leaves
+ * there would cost under the unigram table of the offset's bucket (the
+ * tail rows use the bucket at NETC_DELTA_MAP_LEN): per-offset entropy
+ * alone would favour raw bytes that are rare elsewhere in the bucket. Per
+ * quad, the cheapest of: the best byte operator (XOR / SUB / NONE) for each
+ * byte, SUB16 for either pair, or SUB32 / FLT32 for the whole quad; the tail takes
+ * the single cheapest operator over its four rows. An alternative replaces
+ * the static operator only when strictly cheaper, so a corpus without pairs
+ * (or one where nothing wins) keeps netc_delta_map_default. */
+static void train_delta_map(netc_dict_t *d, const uint64_t *delta) {
+    const netc_delta_map_t *def = &netc_delta_map_default;
+    uint64_t cost[TRAIN_DELTA_ROWS][NETC_DELTA_OP_COUNT];
+    for (uint32_t r = 0; r < TRAIN_DELTA_ROWS; r++) {
+        uint32_t off = (r < NETC_DELTA_MAP_LEN) ? r : NETC_DELTA_MAP_LEN;
+        const uint16_t *sym_cost = d->tables[netc_bucket_of(&d->buckets, off)].cost;
+        for (uint32_t op = 0; op < NETC_DELTA_OP_COUNT; op++) {
+            const uint64_t *c = delta + ((size_t)r * NETC_DELTA_OP_COUNT + op) * 256U;
+            uint64_t bits = 0;
+            for (uint32_t s = 0; s < 256U; s++) bits += c[s] * sym_cost[s];
+            cost[r][op] = bits;
         }
+        /* The low byte of a SUB16/SUB32 lane is a byte SUB, and byte 1 of
+         * a SUB32 lane is byte 1 of a SUB16 lane */
+        if ((r & 1U) == 0) cost[r][NETC_DELTA_OP_SUB16] = cost[r][NETC_DELTA_OP_SUB];
+        if ((r & 3U) == 0) cost[r][NETC_DELTA_OP_SUB32] = cost[r][NETC_DELTA_OP_SUB];
+        if ((r & 3U) == 1) cost[r][NETC_DELTA_OP_SUB32] = cost[r][NETC_DELTA_OP_SUB16];
+    }
 
-        /* Pass 1: Boyer-Moore majority vote across all training packets */
-        for (size_t p = 0; p < count; p++) {
-            if (packets[p] == NULL || sizes[p] == 0) continue;
-            size_t pkt_size = sizes[p];
-            if (pkt_size > NETC_MAX_PACKET_SIZE) pkt_size = NETC_MAX_PACKET_SIZE;
-            const uint8_t *pkt = packets[p];
-            for (size_t i = 0; i < pkt_size; i++) {
-                uint8_t  prev = (i > 0) ? pkt[i - 1] : 0x00u;
-                uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
-                uint8_t  byte_val = pkt[i];
-                if (slot_total[h] < 0xFFFFU) slot_total[h]++;
-                if (votes[h].count == 0) {
-                    votes[h].candidate = byte_val;
-                    votes[h].count     = 1;
-                } else if (votes[h].candidate == byte_val) {
-                    if (votes[h].count < INT16_MAX) votes[h].count++;
-                } else {
-                    votes[h].count--;
-                }
+    netc_delta_map_t m;
+    for (uint32_t q = 0; q < NETC_DELTA_MAP_LEN; q += 4U) {
+        uint8_t  byte_op[4];
+        uint64_t byte_cost[4];
+        for (uint32_t k = 0; k < 4U; k++) {
+            uint32_t best = def->op[q + k];   /* XOR or SUB */
+            for (uint32_t op = NETC_DELTA_OP_XOR; op <= NETC_DELTA_OP_NONE; op++) {
+                if (cost[q + k][op] < cost[q + k][best]) best = op;
             }
+            byte_op[k]   = (uint8_t)best;
+            byte_cost[k] = cost[q + k][best];
         }
-
-        /* Pass 2: verify candidates — count actual frequency of the majority candidate.
-         * Boyer-Moore only guarantees majority if >50%; we verify and set valid
-         * only when the candidate appears in >= 40% of slot occurrences (generous
-         * threshold since even 40% hit rate saves significant bytes). */
-        /* Reset counts for verification pass */
-        uint16_t *hit_count = slot_total; /* reuse for hit counting */
-        uint16_t *total_count = (uint16_t *)calloc(NETC_LZP_HT_SIZE, sizeof(uint16_t));
-        if (NETC_UNLIKELY(total_count == NULL)) {
-            free(votes);
-            free(slot_total);
-            free(d);
-            return NETC_ERR_NOMEM;
+        uint64_t pair_cost[2];
+        for (uint32_t h = 0; h < 2U; h++) {
+            uint32_t i = q + 2U * h;
+            uint64_t c16 = cost[i][NETC_DELTA_OP_SUB16] + cost[i + 1U][NETC_DELTA_OP_SUB16];
+            pair_cost[h] = byte_cost[2U * h] + byte_cost[2U * h + 1U];
+            if (c16 < pair_cost[h]) {
+                byte_op[2U * h] = byte_op[2U * h + 1U] = (uint8_t)NETC_DELTA_OP_SUB16;
+                pair_cost[h] = c16;
+            }
         }
-        memset(hit_count, 0, NETC_LZP_HT_SIZE * sizeof(uint16_t));
-
-        for (size_t p = 0; p < count; p++) {
-            if (packets[p] == NULL || sizes[p] == 0) continue;
-            size_t pkt_size = sizes[p];
-            if (pkt_size > NETC_MAX_PACKET_SIZE) pkt_size = NETC_MAX_PACKET_SIZE;
-            const uint8_t *pkt = packets[p];
-            for (size_t i = 0; i < pkt_size; i++) {
-                uint8_t  prev = (i > 0) ? pkt[i - 1] : 0x00u;
-                uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
-                if (total_count[h] < 0xFFFFU) total_count[h]++;
-                if (pkt[i] == votes[h].candidate) {
-                    if (hit_count[h] < 0xFFFFU) hit_count[h]++;
-                }
+        uint64_t best = pair_cost[0] + pair_cost[1];
+        for (uint32_t op = NETC_DELTA_OP_SUB32; op <= NETC_DELTA_OP_FLT32; op++) {
+            uint64_t c32 = 0;
+            for (uint32_t k = 0; k < 4U; k++) c32 += cost[q + k][op];
+            if (c32 < best) {
+                memset(byte_op, (int)op, sizeof(byte_op));
+                best = c32;
             }
         }
+        memcpy(m.op + q, byte_op, sizeof(byte_op));
+    }
 
-        /* Allocate LZP table */
-        d->lzp_table = (netc_lzp_entry_t *)calloc(NETC_LZP_HT_SIZE, sizeof(netc_lzp_entry_t));
-        if (NETC_UNLIKELY(d->lzp_table == NULL)) {
-            free(total_count);
-            free(votes);
-            free(d);
-            return NETC_ERR_NOMEM;
-        }
+    uint64_t tail_cost[NETC_DELTA_OP_COUNT];
+    uint32_t tail = def->tail;
+    for (uint32_t op = 0; op < NETC_DELTA_OP_COUNT; op++) {
+        tail_cost[op] = 0;
+        for (uint32_t k = 0; k < 4U; k++) tail_cost[op] += cost[NETC_DELTA_MAP_LEN + k][op];
+    }
+    for (uint32_t op = 0; op < NETC_DELTA_OP_COUNT; op++) {
+        if (tail_cost[op] < tail_cost[tail]) tail = op;
+    }
+    m.tail   = (uint8_t)tail;
+    m.planes = 0;
+    d->delta_map = m;
+}
 
-        /* Populate LZP table: valid only if hit_rate >= 40% and total >= 2 */
-        for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
-            if (total_count[h] >= 2 &&
-                (uint32_t)hit_count[h] * 10u >= (uint32_t)total_count[h] * 4u) {
-                d->lzp_table[h].value = votes[h].candidate;
-                d->lzp_table[h].valid = 1;
+/* Byte planes (AD-021) are kept only if they make the delta residuals of
+ * the corpus at least 1/TRAIN_PLANES_GAIN cheaper: the per-position and
+ * bigram tables already see most of the lane structure, and a smaller
+ * estimated gain is within the estimator's noise. Each consecutive
+ * same-length pair (up to TRAIN_PLANES_PAIRS) is delta coded with the
+ * learned map over the mapped prefix, and costed with and without the
+ * transpose under the cheaper of the unigram and bigram tables — the choice
+ * the compressor makes. Runs serially and reads the corpus in order, so the
+ * result does not depend on the thread count. Sets NETC_DICT_FLAG_DELTA_MAP
+ * if the final map differs from netc_delta_map_default. */
+#define TRAIN_PLANES_PAIRS 4096U
+#define TRAIN_PLANES_GAIN  256U
+
+static uint64_t train_planes_cost(const netc_dict_t *d, const uint8_t *res, size_t len) {
+    uint32_t c = netc_tans_cost_pctx(d->tables, &d->buckets, res, len);
+    uint32_t b = netc_tans_cost_pctx_bigram(&d->bigram_set, d->tables, d->bigram_class_map,
+                                            &d->buckets, res, len);
+    return (b < c) ? b : c;
+}
+
+static void train_delta_planes(const train_job_t *job, netc_dict_t *d) {
+    netc_delta_map_t m = d->delta_map;
+    netc_delta_planes_t pl;
+    m.planes = 1;
+    netc_delta_planes_init(&pl, &m);
+
+    if (pl.count > 0) {
+        uint8_t  res[NETC_DELTA_MAP_LEN];
+        uint64_t flat = 0, split = 0;
+        uint32_t pairs = 0;
+        const uint8_t *prev = NULL;
+        size_t prev_size = 0;
+        for (size_t p = 0; p < job->count && pairs < TRAIN_PLANES_PAIRS; p++) {
+            size_t pkt_size = train_pkt_len(job->packets[p], job->sizes[p]);
+            if (pkt_size == 0) continue;
+            if (pkt_size == prev_size && pkt_size >= NETC_DELTA_MIN_SIZE) {
+                size_t n = (pkt_size < NETC_DELTA_MAP_LEN) ? pkt_size : NETC_DELTA_MAP_LEN;
+                netc_delta_encode_mapped(&m, prev, job->packets[p], res, 0, n);
+                flat += train_planes_cost(d, res, n);
+                netc_delta_planes_split_generic(&pl, res, n);
+                split += train_planes_cost(d, res, n);
+                pairs++;
             }
+            prev      = job->packets[p];
+            prev_size = pkt_size;
         }
+        if (split < flat - flat / TRAIN_PLANES_GAIN) {
+            d->delta_map    = m;
+            d->delta_planes = pl;
+        }
+    }
+
+    if (memcmp(&d->delta_map, &netc_delta_map_default, sizeof(netc_delta_map_t)) != 0)
+        d->dict_flags |= NETC_DICT_FLAG_DELTA_MAP;
+}
+
+/* Phase 7: LZ77X token tables. Packets are parsed in arrival order through
+ * a stateful level-5 context — the token streams its compressor would try —
+ * and header, near-offset and far-offset bytes are counted separately.
+ * Packets LZ77X does not shrink are not counted. Sets NETC_DICT_FLAG_LZX
+ * once the corpus yields TRAIN_LZX_MIN_REFS references; below that the
+ * trial would not pay for the section. The streaming trainer counts as
+ * packets are fed, since its reservoir keeps no arrival order. */
+#define TRAIN_LZX_MIN_REFS 16U
+#define TRAIN_LZX_BYTES    (4U << 20)  /* corpus prefix parsed */
+
+typedef struct {
+    netc_ctx_t *ctx;
+    uint8_t    *tok;       /* [NETC_MAX_PACKET_SIZE] */
+    uint64_t    raw[NETC_LZX_TABLES][NETC_TANS_SYMBOLS];
+    uint64_t    totals[NETC_LZX_TABLES];
+    size_t      parsed;
+} train_lzx_t;
+
+static void train_lzx_free(train_lzx_t *lx) {
+    netc_ctx_destroy(lx->ctx);
+    free(lx->tok);
+    lx->ctx = NULL;
+    lx->tok = NULL;
+}
 
-        d->dict_flags |= NETC_DICT_FLAG_LZP;
-        free(total_count);
-        free(votes);
+static netc_result_t train_lzx_init(train_lzx_t *lx) {
+    memset(lx, 0, sizeof(*lx));
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags             = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
+    lx->ctx = netc_ctx_create(NULL, &cfg);
+    lx->tok = (uint8_t *)malloc(NETC_MAX_PACKET_SIZE);
+    if (NETC_UNLIKELY(lx->ctx == NULL || lx->tok == NULL ||
+                      netc_ctx_reserve_lzx(lx->ctx) != NETC_OK)) {
+        train_lzx_free(lx);
+        return NETC_ERR_NOMEM;
     }
+    return NETC_OK;
+}
 
-    /* --- Phase 5: Retrain tANS tables on LZP-filtered data --- */
-    /* When LZP is trained, the compressor will XOR each byte with its LZP
-     * prediction before tANS encoding.  Correctly-predicted bytes become 0x00.
-     * The tANS tables must match this post-filter distribution for optimal
-     * compression.  Re-accumulate frequencies on LZP-filtered packets and
-     * rebuild all unigram + bigram tANS tables. */
-    if (d->dict_flags & NETC_DICT_FLAG_LZP) {
-        /* Reset accumulators */
-        memset(raw,    0, sizeof(raw));
-        memset(totals, 0, sizeof(totals));
-
-        uint64_t (*bgram_raw2)[NETC_BIGRAM_CTX_COUNT][NETC_TANS_SYMBOLS] =
-            (uint64_t (*)[NETC_BIGRAM_CTX_COUNT][NETC_TANS_SYMBOLS])
-            calloc(NETC_CTX_COUNT, sizeof(*bgram_raw2));
-        uint64_t bgram_totals2[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
-        if (NETC_UNLIKELY(bgram_raw2 == NULL)) {
-            free(d->lzp_table);
-            free(d);
-            return NETC_ERR_NOMEM;
-        }
-        memset(bgram_totals2, 0, sizeof(bgram_totals2));
+/* Forget the counts and the parse history, keeping the buffers. */
+static void train_lzx_reset(train_lzx_t *lx) {
+    netc_ctx_reset(lx->ctx);
+    memset(lx->raw, 0, sizeof(lx->raw));
+    memset(lx->totals, 0, sizeof(lx->totals));
+    lx->parsed = 0;
+}
 
-        /* Temp buffer for one filtered packet */
-        uint8_t *filt_buf = (uint8_t *)malloc(NETC_MAX_PACKET_SIZE);
-        if (NETC_UNLIKELY(filt_buf == NULL)) {
-            free(bgram_raw2);
-            free(d->lzp_table);
-            free(d);
-            return NETC_ERR_NOMEM;
+/* Count one packet of n > 0 bytes; a no-op past the TRAIN_LZX_BYTES prefix. */
+static void train_lzx_packet(train_lzx_t *lx, const uint8_t *pkt, size_t n) {
+    if (lx->parsed >= TRAIN_LZX_BYTES) return;
+    lx->parsed += n;
+    size_t len = netc_lzx_parse(lx->ctx, pkt, n, lx->tok, n);
+    if (len == (size_t)-1) return;
+    const uint8_t *tok = lx->tok;
+    for (size_t i = 0; i < len; ) {
+        uint8_t t = tok[i++];
+        lx->raw[NETC_LZX_TBL_CMD][t]++;
+        lx->totals[NETC_LZX_TBL_CMD]++;
+        if (!(t & 0x80u)) {
+            i += (size_t)(t & 0x7Fu) + 1u;
+        } else if (!(t & 0x40u)) {
+            lx->raw[NETC_LZX_TBL_NEAR][tok[i++]]++;
+            lx->totals[NETC_LZX_TBL_NEAR]++;
+        } else {
+            lx->raw[NETC_LZX_TBL_FAR_LO][tok[i++]]++;
+            lx->raw[NETC_LZX_TBL_FAR_HI][tok[i++]]++;
+            lx->totals[NETC_LZX_TBL_FAR_LO]++;
+            lx->totals[NETC_LZX_TBL_FAR_HI]++;
         }
+    }
+}
 
-        for (size_t p = 0; p < count; p++) {
-            if (packets[p] == NULL || sizes[p] == 0) continue;
-            size_t pkt_size = sizes[p];
-            if (pkt_size > NETC_MAX_PACKET_SIZE) pkt_size = NETC_MAX_PACKET_SIZE;
-
-            /* Apply LZP XOR filter to this packet */
-            netc_lzp_xor_filter(packets[p], pkt_size, d->lzp_table, filt_buf);
-
-            /* Accumulate frequencies on filtered data */
-            for (size_t i = 0; i < pkt_size; i++) {
-                uint32_t bucket = netc_ctx_bucket((uint32_t)i);
-                uint8_t sym = filt_buf[i];
-                raw[bucket][sym]++;
-                totals[bucket]++;
-                uint8_t prev = (i > 0) ? filt_buf[i - 1] : 0x00u;
-                uint32_t bclass = netc_bigram_class(prev, d->bigram_class_map);
-                bgram_raw2[bucket][bclass][sym]++;
-                bgram_totals2[bucket][bclass]++;
-            }
-        }
-        free(filt_buf);
+static netc_result_t train_lzx_tables(const train_lzx_t *lx, netc_dict_t *d) {
+    if (lx->totals[NETC_LZX_TBL_NEAR] + lx->totals[NETC_LZX_TBL_FAR_LO] < TRAIN_LZX_MIN_REFS)
+        return NETC_OK;
+    for (uint32_t k = 0; k < NETC_LZX_TABLES; k++) {
+        netc_freq_table_t ft;
+        freq_normalize(lx->raw[k], lx->totals[k], ft.freq);
+        if (netc_tans_build(&d->owned->lzx_tables[k], &ft) != 0)
+            return NETC_ERR_NOMEM;  /* table build failure (should not happen) */
+    }
+    d->dict_flags |= NETC_DICT_FLAG_LZX;
+    return NETC_OK;
+}
 
-        /* Rebuild unigram tANS tables from filtered frequencies */
-        for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
-            netc_freq_table_t ft;
-            freq_normalize(raw[b], totals[b], ft.freq);
-            netc_tans_build(&d->tables[b], &ft);
+/* Worker count for a corpus of count packets: 0 = one per online CPU,
+ * never more than NETC_MAX_THREADS or the packet count. */
+static uint32_t train_thread_count(const netc_train_cfg_t *cfg, size_t count) {
+    uint32_t n = (cfg != NULL) ? cfg->threads : 0U;
+    if (n == 0) n = netc_cpu_count();
+    if (n > NETC_MAX_THREADS) n = NETC_MAX_THREADS;
+    if ((size_t)n > count) n = (count > 0) ? (uint32_t)count : 1U;
+    return n;
+}
+
+/* Phases 2b–7 and the checksum, shared by netc_dict_train_ex and the
+ * streaming trainer. job supplies the corpus, thread count and finished LZP
+ * votes; cond holds the summed class-map counts, delta the delta operator
+ * statistics and lzx the LZ77X token counts. */
+static netc_result_t train_finish(train_job_t *job, const uint64_t *cond,
+                                  const uint64_t *delta, const train_lzx_t *lzx,
+                                  uint8_t model_id, netc_dict_t **out_dict) {
+    netc_dict_t *d = dict_alloc();
+    if (NETC_UNLIKELY(d == NULL)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    d->magic      = NETC_DICT_MAGIC;
+    d->version    = NETC_DICT_VERSION;
+    d->model_id   = model_id;
+    d->ctx_count  = (uint8_t)NETC_CTX_COUNT;
+    d->dict_flags = 0;
+    d->bigram_class_count = NETC_BIGRAM_CTX_COUNT;  /* 8 */
+    netc_simd_ops_init(&d->simd_ops, NETC_SIMD_LEVEL_AUTO);
+    job->d = d;
+    memset(job->failed, 0, sizeof(job->failed));
+
+    train_class_map(d, cond);
+
+    /* --- Phase 2b: LZP verification and table fill --- */
+    job->counts = (train_lzp_count_t *)calloc(2U * NETC_LZP_HT_SIZE, sizeof(train_lzp_count_t));
+    job->lzp1 = (netc_lzp_entry_t *)calloc(NETC_LZP_HT_SIZE, sizeof(netc_lzp_entry_t));
+    job->lzp2 = (netc_lzp_entry_t *)calloc(NETC_LZP_HT_SIZE, sizeof(netc_lzp_entry_t));
+    int pick = job->lzp_order != 1U && job->lzp_order != 2U;
+    job->fold = pick ? (netc_lzp_entry_t *)calloc(4U * NETC_LZP_HT_SIZE,
+                                                  sizeof(netc_lzp_entry_t)) : NULL;
+    if (NETC_UNLIKELY(job->counts == NULL || job->lzp1 == NULL || job->lzp2 == NULL ||
+                      (pick && job->fold == NULL))) {
+        free(job->counts);
+        free(job->lzp1);
+        free(job->lzp2);
+        free(job->fold);
+        netc_dict_free(d);
+        return NETC_ERR_NOMEM;
+    }
+    netc_parallel_run(job->nthreads, train_verify_worker, job);
+    d->dict_flags |= NETC_DICT_FLAG_LZP;
+    free(job->counts);
+
+    /* --- Phase 2c: keep the dual-order table if it predicts clearly more
+     *     of the held-out half --- */
+    int dual = job->lzp_order == 2U;
+    if (pick) {
+        netc_parallel_run(job->nthreads, train_lzp_eval_worker, job);
+        free(job->fold);
+        uint64_t n1 = 0, n2 = 0, bytes = 0;
+        for (uint32_t t = 0; t < job->nthreads; t++) {
+            n1    += job->lzp_hits[t][0];
+            n2    += job->lzp_hits[t][1];
+            bytes += job->lzp_hits[t][2];
         }
+        dual = n2 > n1 + (n1 >> TRAIN_LZP2_GAIN) && n2 - n1 > (bytes >> 8);
+    }
+    if (dual) d->dict_flags |= NETC_DICT_FLAG_LZP2;
+    netc_result_t prc = dict_lzp_pack(d, dual ? job->lzp2 : job->lzp1);
+    free(job->lzp1);
+    free(job->lzp2);
+    if (NETC_UNLIKELY(prc != NETC_OK)) {
+        netc_dict_free(d);
+        return prc;
+    }
 
-        /* Rebuild bigram tANS tables from filtered frequencies */
-        for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+    /* --- Phase 3: frequencies of the LZP-filtered corpus --- */
+    job->hist = (train_hist_t *)calloc(job->nthreads, sizeof(train_hist_t));
+    if (NETC_UNLIKELY(job->hist == NULL)) {
+        netc_dict_free(d);
+        return NETC_ERR_NOMEM;
+    }
+    netc_parallel_run(job->nthreads, train_hist_worker, job);
+    for (uint32_t t = 1; t < job->nthreads; t++) {
+        train_hist_t *dst = &job->hist[0];
+        const train_hist_t *src = &job->hist[t];
+        for (uint32_t b = 0; b < TRAIN_GRANULES; b++) {
+            dst->totals[b] += src->totals[b];
+            for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++)
+                dst->raw[b][s] += src->raw[b][s];
             for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c++) {
-                netc_freq_table_t ft;
-                freq_normalize(bgram_raw2[b][c], bgram_totals2[b][c], ft.freq);
-                netc_tans_build(&d->bigram_tables[b][c], &ft);
+                dst->bgram_totals[b][c] += src->bgram_totals[b][c];
+                for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++)
+                    dst->bgram_raw[b][c][s] += src->bgram_raw[b][c][s];
             }
         }
-        free(bgram_raw2);
+    }
+
+    /* --- Phase 3b: bucket boundaries --- */
+    if (NETC_UNLIKELY(train_buckets(d, &job->hist[0]) != NETC_OK)) {
+        free(job->hist);
+        netc_dict_free(d);
+        return NETC_ERR_NOMEM;
+    }
+
+    /* --- Phase 4: normalize and build unigram + bigram tANS (and rANS) tables --- */
+    netc_parallel_run(job->nthreads, train_build_worker, job);
+    free(job->hist);
+    for (uint32_t t = 0; t < job->nthreads; t++) {
+        if (job->failed[t]) {
+            netc_dict_free(d);
+            return NETC_ERR_NOMEM; /* table build failure (should not happen) */
+        }
+    }
+
+    /* --- Phase 5: delta operators, costed under the built tables --- */
+    train_delta_map(d, delta);
+
+    /* --- Phase 6: byte planes for the wide-lane runs of the map --- */
+    train_delta_planes(job, d);
+
+    /* --- Phase 7: LZ77X token tables --- */
+    if (NETC_UNLIKELY(train_lzx_tables(lzx, d) != NETC_OK)) {
+        netc_dict_free(d);
+        return NETC_ERR_NOMEM;
     }
 
     /* --- Compute checksum over the serialized blob --- */
@@ -528,8 +1278,7 @@ netc_result_t netc_dict_train(
     size_t blob_sz = dict_blob_size_v(d->version, d->dict_flags);
     uint8_t *tmp_blob = (uint8_t *)malloc(blob_sz);
     if (NETC_UNLIKELY(tmp_blob == NULL)) {
-        free(d->lzp_table);
-        free(d);
+        netc_dict_free(d);
         return NETC_ERR_NOMEM;
     }
 
@@ -569,11 +1318,25 @@ netc_result_t netc_dict_train(
         netc_write_u32_le(tmp_blob + off, NETC_LZP_HT_SIZE);
         off += 4;
         for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
-            tmp_blob[off++] = d->lzp_table[h].value;
-            tmp_blob[off++] = d->lzp_table[h].valid;
+            netc_lzp_entry_t e = netc_lzp_get(&d->lzp_table, h);
+            tmp_blob[off++] = e.value;
+            tmp_blob[off++] = e.valid;
         }
     }
 
+    if (d->dict_flags & NETC_DICT_FLAG_BUCKETS) {
+        off = dict_write_buckets(tmp_blob, off, &d->buckets);
+    }
+    if (d->dict_flags & NETC_DICT_FLAG_DELTA_MAP) {
+        off = dict_write_delta_map(tmp_blob, off, &d->delta_map);
+    }
+    if (d->dict_flags & NETC_DICT_FLAG_LZP2) {
+        off = dict_write_lzp2(tmp_blob, off);
+    }
+    if (d->dict_flags & NETC_DICT_FLAG_LZX) {
+        off = dict_write_lzx(tmp_blob, off, d->lzx_tables);
+    }
+
     /* Compute and store checksum */
     d->checksum = netc_crc32(tmp_blob, blob_sz - 4U);
     netc_write_u32_le(tmp_blob + off, d->checksum);
@@ -583,6 +1346,308 @@ netc_result_t netc_dict_train(
     return NETC_OK;
 }
 
+/* =========================================================================
+ * netc_dict_train / netc_dict_train_ex
+ * ========================================================================= */
+
+netc_result_t netc_dict_train(
+    const uint8_t * const *packets,
+    const size_t          *sizes,
+    size_t                 count,
+    uint8_t                model_id,
+    netc_dict_t          **out_dict)
+{
+    netc_train_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads = 1;
+    return netc_dict_train_ex(packets, sizes, count, model_id, &cfg, out_dict);
+}
+
+netc_result_t netc_dict_train_ex(
+    const uint8_t * const  *packets,
+    const size_t           *sizes,
+    size_t                  count,
+    uint8_t                 model_id,
+    const netc_train_cfg_t *cfg,
+    netc_dict_t           **out_dict)
+{
+    if (NETC_UNLIKELY(out_dict == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    if (NETC_UNLIKELY(model_id == 0 || model_id == 255)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    if (NETC_UNLIKELY(count > 0 && (packets == NULL || sizes == NULL))) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    train_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.packets  = packets;
+    job.sizes    = sizes;
+    job.count    = count;
+    job.nthreads = train_thread_count(cfg, count);
+    job.lzp_order = (cfg != NULL) ? cfg->lzp_order : 0U;
+
+    /* --- Phase 1: bigram class_map via frequency-based clustering --- */
+    job.cond = (uint64_t *)calloc((size_t)job.nthreads * TRAIN_COND_SIZE, sizeof(uint64_t));
+    if (NETC_UNLIKELY(job.cond == NULL)) {
+        return NETC_ERR_NOMEM;
+    }
+    netc_parallel_run(job.nthreads, train_cond_worker, &job);
+    for (uint32_t t = 1; t < job.nthreads; t++) {
+        const uint64_t *src = job.cond + (size_t)t * TRAIN_COND_SIZE;
+        for (uint32_t i = 0; i < TRAIN_COND_SIZE; i++) job.cond[i] += src[i];
+    }
+
+    /* --- Phase 1b: delta operator statistics over consecutive packets --- */
+    job.delta = (uint64_t *)calloc(TRAIN_DELTA_SIZE, sizeof(uint64_t));
+    if (NETC_UNLIKELY(job.delta == NULL)) {
+        free(job.cond);
+        return NETC_ERR_NOMEM;
+    }
+    netc_parallel_run(job.nthreads, train_delta_worker, &job);
+
+    /* --- Phase 2a: LZP hash table training (Boyer-Moore majority vote) --- */
+    /* For each (prev_byte, position) context, find the most common byte.
+     * Uses position-aware order-1 hashing: hash(prev_byte, byte_offset).
+     * Boyer-Moore majority element algorithm: O(1) space per slot.
+     *   - If current candidate matches: increment vote count
+     *   - If vote count is zero: replace candidate, count = 1
+     *   - Otherwise: decrement vote count (cancel one opposite vote)
+     * After all training data, the candidate is the majority element if
+     * one exists (>50% frequency at this hash slot).  A second table also
+     * votes in the order-2 slots, hash(prev2, prev, offset); phase 2c
+     * keeps whichever table predicts more held-out bytes. */
+    job.votes = (train_lzp_vote_t *)calloc(NETC_LZP_HT_SIZE, sizeof(train_lzp_vote_t));
+    if (NETC_UNLIKELY(job.votes == NULL)) {
+        free(job.delta);
+        free(job.cond);
+        return NETC_ERR_NOMEM;
+    }
+    netc_parallel_run(job.nthreads, train_vote_worker, &job);
+
+    /* --- Phase 1c: LZ77X token counts, in corpus order --- */
+    train_lzx_t *lzx = (train_lzx_t *)malloc(sizeof(train_lzx_t));
+    if (NETC_UNLIKELY(lzx == NULL || train_lzx_init(lzx) != NETC_OK)) {
+        free(lzx);
+        free(job.votes);
+        free(job.delta);
+        free(job.cond);
+        return NETC_ERR_NOMEM;
+    }
+    for (size_t p = 0; p < count; p++) {
+        size_t n = train_pkt_len(packets[p], sizes[p]);
+        if (n > 0) train_lzx_packet(lzx, packets[p], n);
+    }
+    train_lzx_free(lzx);
+
+    netc_result_t rc = train_finish(&job, job.cond, job.delta, lzx, model_id, out_dict);
+    free(lzx);
+    free(job.votes);
+    free(job.delta);
+    free(job.cond);
+    return rc;
+}
+
+/* =========================================================================
+ * Streaming trainer — netc_trainer_*
+ *
+ * The class-map counts, the LZP majority vote and the delta operator
+ * statistics are order-sensitive or cheap enough to run on every packet as
+ * it is fed; they use fixed state (~7 MB, plus a copy of the last packet
+ * for the delta pair). LZP verification and the filtered histograms need a second look
+ * at the packets once the vote is final, so they run over a reservoir: a
+ * uniform sample (Algorithm R) of at most cfg.reservoir packets. When
+ * every fed packet fits in the reservoir, finish() returns the same
+ * dictionary as netc_dict_train over those packets.
+ * ========================================================================= */
+
+#define NETC_TRAINER_DEFAULT_RESERVOIR 65536U
+#define NETC_TRAINER_DEFAULT_SEED      0x9E3779B97F4A7C15ULL
+
+typedef struct {
+    uint8_t *data;
+    size_t   size;
+    size_t   cap;
+} netc_trainer_slot_t;
+
+struct netc_trainer {
+    uint64_t             cond[TRAIN_COND_SIZE];
+    train_lzp_vote_t     votes[NETC_LZP_HT_SIZE];
+    uint64_t             delta[TRAIN_DELTA_SIZE];
+    train_lzx_t          lzx;         /* counted in arrival order */
+    uint8_t             *last;        /* previous usable packet */
+    size_t               last_size;
+    size_t               last_cap;
+    netc_trainer_slot_t *slots;       /* [reservoir] */
+    uint32_t             reservoir;
+    uint32_t             threads;     /* cfg.threads, resolved at finish */
+    uint32_t             lzp_order;   /* cfg.lzp_order */
+    uint64_t             seen;        /* packets fed (non-empty) */
+    uint64_t             seed;
+    uint64_t             rng;
+};
+
+/* xorshift64* */
+static uint64_t trainer_rand(netc_trainer_t *t) {
+    uint64_t x = t->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    t->rng = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+netc_trainer_t *netc_trainer_create(const netc_train_cfg_t *cfg) {
+    netc_trainer_t *t = (netc_trainer_t *)calloc(1, sizeof(netc_trainer_t));
+    if (NETC_UNLIKELY(t == NULL)) {
+        return NULL;
+    }
+    t->reservoir = (cfg != NULL && cfg->reservoir > 0) ? cfg->reservoir
+                                                       : NETC_TRAINER_DEFAULT_RESERVOIR;
+    t->threads   = (cfg != NULL) ? cfg->threads : 0U;
+    t->lzp_order = (cfg != NULL) ? cfg->lzp_order : 0U;
+    t->seed      = (cfg != NULL && cfg->seed != 0) ? cfg->seed
+                                                   : NETC_TRAINER_DEFAULT_SEED;
+    t->rng       = t->seed;
+    t->slots = (netc_trainer_slot_t *)calloc(t->reservoir, sizeof(netc_trainer_slot_t));
+    if (NETC_UNLIKELY(t->slots == NULL)) {
+        free(t);
+        return NULL;
+    }
+    if (NETC_UNLIKELY(train_lzx_init(&t->lzx) != NETC_OK)) {
+        free(t->slots);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void netc_trainer_destroy(netc_trainer_t *t) {
+    if (t == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < t->reservoir; i++) {
+        free(t->slots[i].data);
+    }
+    free(t->slots);
+    free(t->last);
+    train_lzx_free(&t->lzx);
+    free(t);
+}
+
+void netc_trainer_reset(netc_trainer_t *t) {
+    if (t == NULL) {
+        return;
+    }
+    memset(t->cond, 0, sizeof(t->cond));
+    memset(t->votes, 0, sizeof(t->votes));
+    memset(t->delta, 0, sizeof(t->delta));
+    train_lzx_reset(&t->lzx);
+    t->last_size = 0;
+    for (uint32_t i = 0; i < t->reservoir; i++) {
+        t->slots[i].size = 0;   /* keep the buffers for the next corpus */
+    }
+    t->seen = 0;
+    t->rng  = t->seed;
+}
+
+uint64_t netc_trainer_count(const netc_trainer_t *t) {
+    return (t != NULL) ? t->seen : 0U;
+}
+
+netc_result_t netc_trainer_feed(netc_trainer_t *t, const uint8_t *pkt, size_t size) {
+    if (NETC_UNLIKELY(t == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    size_t pkt_size = train_pkt_len(pkt, size);
+    if (pkt_size == 0) {
+        return NETC_OK;   /* skipped, as by netc_dict_train */
+    }
+
+    /* Reservoir slot first, so a failed allocation leaves no trace */
+    netc_trainer_slot_t *slot = NULL;
+    if (t->seen < t->reservoir) {
+        slot = &t->slots[t->seen];
+    } else {
+        uint64_t j = trainer_rand(t) % (t->seen + 1U);
+        if (j < t->reservoir) slot = &t->slots[j];
+    }
+    if (t->last_cap < pkt_size) {
+        uint8_t *p = (uint8_t *)realloc(t->last, pkt_size);
+        if (NETC_UNLIKELY(p == NULL)) {
+            return NETC_ERR_NOMEM;
+        }
+        t->last     = p;
+        t->last_cap = pkt_size;
+    }
+    if (slot != NULL && slot->cap < pkt_size) {
+        uint8_t *p = (uint8_t *)realloc(slot->data, pkt_size);
+        if (NETC_UNLIKELY(p == NULL)) {
+            return NETC_ERR_NOMEM;
+        }
+        slot->data = p;
+        slot->cap  = pkt_size;
+    }
+    if (slot != NULL) {
+        memcpy(slot->data, pkt, pkt_size);
+        slot->size = pkt_size;
+    }
+
+    train_cond_packet(t->cond, pkt, pkt_size);
+    train_vote_packet(t->votes, pkt, pkt_size, 0, NETC_LZP_HT_SIZE);
+    if (t->last_size == pkt_size) {
+        train_delta_pair(t->delta, t->last, pkt, pkt_size, 0, TRAIN_DELTA_ROWS);
+    }
+    train_lzx_packet(&t->lzx, pkt, pkt_size);
+    memcpy(t->last, pkt, pkt_size);
+    t->last_size = pkt_size;
+    t->seen++;
+    return NETC_OK;
+}
+
+netc_result_t netc_trainer_finish(netc_trainer_t *t, uint8_t model_id,
+                                  netc_dict_t **out_dict) {
+    if (NETC_UNLIKELY(t == NULL || out_dict == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    if (NETC_UNLIKELY(model_id == 0 || model_id == 255)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    size_t n = (t->seen < t->reservoir) ? (size_t)t->seen : (size_t)t->reservoir;
+    const uint8_t **pkts  = (const uint8_t **)malloc((n > 0 ? n : 1U) * sizeof(*pkts));
+    size_t         *sizes = (size_t *)malloc((n > 0 ? n : 1U) * sizeof(*sizes));
+    if (NETC_UNLIKELY(pkts == NULL || sizes == NULL)) {
+        free(pkts);
+        free(sizes);
+        return NETC_ERR_NOMEM;
+    }
+    for (size_t i = 0; i < n; i++) {
+        pkts[i]  = t->slots[i].data;
+        sizes[i] = t->slots[i].size;
+    }
+
+    netc_train_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads = t->threads;
+
+    train_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.packets  = pkts;
+    job.sizes    = sizes;
+    job.count    = n;
+    job.nthreads = train_thread_count(&cfg, n);
+    job.lzp_order = t->lzp_order;
+    job.votes    = t->votes;   /* only read from here on */
+
+    netc_result_t rc = train_finish(&job, t->cond, t->delta, &t->lzx, model_id, out_dict);
+    free(pkts);
+    free(sizes);
+    return rc;
+}
+
 /* =========================================================================
  * netc_dict_save — serialize to blob
  * ========================================================================= */
@@ -638,11 +1703,25 @@ netc_result_t netc_dict_save(const netc_dict_t *dict, void **out, size_t *out_si
         netc_write_u32_le(blob + off, NETC_LZP_HT_SIZE);
         off += 4;
         for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
-            blob[off++] = dict->lzp_table[h].value;
-            blob[off++] = dict->lzp_table[h].valid;
+            netc_lzp_entry_t e = netc_lzp_get(&dict->lzp_table, h);
+            blob[off++] = e.value;
+            blob[off++] = e.valid;
         }
     }
 
+    if (dict->dict_flags & NETC_DICT_FLAG_BUCKETS) {
+        off = dict_write_buckets(blob, off, &dict->buckets);
+    }
+    if (dict->dict_flags & NETC_DICT_FLAG_DELTA_MAP) {
+        off = dict_write_delta_map(blob, off, &dict->delta_map);
+    }
+    if (dict->dict_flags & NETC_DICT_FLAG_LZP2) {
+        off = dict_write_lzp2(blob, off);
+    }
+    if (dict->dict_flags & NETC_DICT_FLAG_LZX) {
+        off = dict_write_lzx(blob, off, dict->lzx_tables);
+    }
+
     netc_write_u32_le(blob + off, dict->checksum);
 
     *out      = blob;
@@ -696,7 +1775,7 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out) {
         return NETC_ERR_DICT_INVALID;
     }
 
-    netc_dict_t *d = (netc_dict_t *)calloc(1, sizeof(netc_dict_t));
+    netc_dict_t *d = dict_alloc();
     if (NETC_UNLIKELY(d == NULL)) {
         return NETC_ERR_NOMEM;
     }
@@ -706,7 +1785,6 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out) {
     d->model_id   = b[5];
     d->ctx_count  = b[6];
     d->dict_flags = dflags;
-    d->lzp_table  = NULL;
     d->checksum   = stored_cksum;
 
     size_t off = 8;
@@ -732,8 +1810,8 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out) {
             ft.freq[s] = netc_read_u16_le(b + off);
             off += 2;
         }
-        if (netc_tans_build(&d->tables[bucket], &ft) != 0) {
-            free(d);
+        if (netc_tans_build(&d->owned->tables[bucket], &ft) != 0) {
+            netc_dict_free(d);
             return NETC_ERR_DICT_INVALID;
         }
     }
@@ -748,8 +1826,8 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out) {
                     ft.freq[s] = netc_read_u16_le(b + off);
                     off += 2;
                 }
-                if (netc_tans_build(&d->bigram_tables[bucket][c], &ft) != 0) {
-                    free(d);
+                if (netc_tans_build(&d->owned->bigram_tables[bucket][c], &ft) != 0) {
+                    netc_dict_free(d);
                     return NETC_ERR_DICT_INVALID;
                 }
             }
@@ -761,20 +1839,446 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out) {
         uint32_t lzp_ht_size = netc_read_u32_le(b + off);
         off += 4;
         if (NETC_UNLIKELY(lzp_ht_size > NETC_LZP_HT_SIZE)) {
-            free(d);
+            netc_dict_free(d);
             return NETC_ERR_DICT_INVALID;
         }
-        d->lzp_table = (netc_lzp_entry_t *)calloc(NETC_LZP_HT_SIZE, sizeof(netc_lzp_entry_t));
-        if (NETC_UNLIKELY(d->lzp_table == NULL)) {
-            free(d);
+        netc_lzp_entry_t *dense =
+            (netc_lzp_entry_t *)calloc(NETC_LZP_HT_SIZE, sizeof(netc_lzp_entry_t));
+        if (NETC_UNLIKELY(dense == NULL)) {
+            netc_dict_free(d);
             return NETC_ERR_NOMEM;
         }
         for (uint32_t h = 0; h < lzp_ht_size; h++) {
-            d->lzp_table[h].value = b[off++];
-            d->lzp_table[h].valid = b[off++];
+            dense[h].value = b[off++];
+            dense[h].valid = b[off++];
+        }
+        netc_result_t prc = dict_lzp_pack(d, dense);
+        free(dense);
+        if (NETC_UNLIKELY(prc != NETC_OK)) {
+            netc_dict_free(d);
+            return prc;
         }
     }
 
+    /* Learned bucket boundaries (absent = static layout from dict_alloc) */
+    if (dflags & NETC_DICT_FLAG_BUCKETS) {
+        uint32_t end[NETC_CTX_COUNT];
+        for (uint32_t k = 0; k < NETC_CTX_COUNT; k++) {
+            end[k] = (uint32_t)netc_read_u16_le(b + off) * DICT_BUCKET_UNIT;
+            off += 2;
+        }
+        if (NETC_UNLIKELY(dict_buckets_set(&d->buckets, end) != 0)) {
+            netc_dict_free(d);
+            return NETC_ERR_DICT_INVALID;
+        }
+    }
+
+    /* Learned delta operators (absent = static layout from dict_alloc) */
+    if (dflags & NETC_DICT_FLAG_DELTA_MAP) {
+        memcpy(d->delta_map.op, b + off, NETC_DELTA_MAP_LEN);
+        d->delta_map.tail   = b[off + NETC_DELTA_MAP_LEN];
+        d->delta_map.planes = b[off + NETC_DELTA_MAP_LEN + 1U];
+        if (NETC_UNLIKELY(!netc_delta_map_valid(&d->delta_map) ||
+                          b[off + NETC_DELTA_MAP_LEN + 2U] != 0 ||
+                          b[off + NETC_DELTA_MAP_LEN + 3U] != 0)) {
+            netc_dict_free(d);
+            return NETC_ERR_DICT_INVALID;
+        }
+        off += DICT_DELTA_MAP_SECTION_SIZE;
+        netc_delta_planes_init(&d->delta_planes, &d->delta_map);
+    }
+
+    /* Dual-order LZP: the entries were read above */
+    if (dflags & NETC_DICT_FLAG_LZP2) {
+        if (NETC_UNLIKELY(!(dflags & NETC_DICT_FLAG_LZP) ||
+                          b[off] != DICT_LZP2_ORDER ||
+                          b[off + 1] != 0 || b[off + 2] != 0 || b[off + 3] != 0)) {
+            netc_dict_free(d);
+            return NETC_ERR_DICT_INVALID;
+        }
+        off += DICT_LZP2_SECTION_SIZE;
+    }
+
+    if (dflags & NETC_DICT_FLAG_LZX) {
+        for (uint32_t k = 0; k < NETC_LZX_TABLES; k++) {
+            netc_freq_table_t ft;
+            for (uint32_t s = 0; s < NETC_TANS_SYMBOLS; s++) {
+                ft.freq[s] = netc_read_u16_le(b + off);
+                off += 2;
+            }
+            if (NETC_UNLIKELY(netc_tans_build(&d->owned->lzx_tables[k], &ft) != 0)) {
+                netc_dict_free(d);
+                return NETC_ERR_DICT_INVALID;
+            }
+        }
+    }
+
+    netc_simd_ops_init(&d->simd_ops, NETC_SIMD_LEVEL_AUTO);
+    dict_build_rans(d->owned);
+    *out = d;
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * Dictionary image — built tables in native layout (netc_dict_map)
+ * ========================================================================= */
+
+/* Image header. Fixed-width fields in the writer's byte order; byte_order,
+ * the table struct sizes and the bucket/class/LZP geometry pin the image to
+ * builds with an identical in-memory layout. */
+typedef struct {
+    uint32_t magic;              /* NETC_DICT_IMAGE_MAGIC */
+    uint32_t byte_order;         /* DICT_IMAGE_BYTE_ORDER as written */
+    uint16_t image_version;      /* NETC_DICT_IMAGE_VERSION */
+    uint16_t header_size;        /* sizeof(netc_dict_image_hdr_t) */
+    uint8_t  version;            /* Source blob version (3..5) */
+    uint8_t  model_id;
+    uint8_t  ctx_count;          /* NETC_CTX_COUNT */
+    uint8_t  dict_flags;
+    uint8_t  bigram_class_count;
+    uint8_t  bigram_ctx_count;   /* NETC_BIGRAM_CTX_COUNT */
+    uint8_t  _pad[2];
+    uint32_t tans_table_size;    /* sizeof(netc_tans_table_t) */
+    uint32_t rans_table_size;    /* sizeof(netc_rans_table_t) */
+    uint32_t lzp_ht_size;        /* NETC_LZP_HT_SIZE, or 0 without LZP */
+    uint32_t blob_checksum;      /* netc_dict_t.checksum (v5 blob CRC) */
+    uint32_t lzp_count;          /* Occupied LZP slots (selects the layout) */
+    uint64_t tables_offset;      /* netc_dict_tables_t */
+    uint64_t lzp_offset;         /* LZP table, or 0 */
+    uint64_t image_size;         /* Including the 4-byte CRC32 trailer */
+    uint16_t bucket_end[NETC_CTX_COUNT]; /* Bucket ends in 8-byte units */
+    uint8_t  bigram_class_map[256];
+    uint8_t  delta_op[NETC_DELTA_MAP_LEN];  /* netc_delta_map_t.op */
+    uint8_t  delta_tail;                    /* netc_delta_map_t.tail */
+    uint8_t  delta_planes;                  /* netc_delta_map_t.planes */
+    uint8_t  _pad2[6];
+} netc_dict_image_hdr_t;
+
+NETC_STATIC_ASSERT(sizeof(netc_dict_image_hdr_t) == 872,
+                   "netc_dict_image_hdr_t layout must be 872 bytes");
+
+#define DICT_IMAGE_BYTE_ORDER  0x01020304U
+/* Section alignment inside the image (cache line) */
+#define DICT_IMAGE_ALIGN       64U
+
+static size_t dict_image_align(size_t off) {
+    return (off + DICT_IMAGE_ALIGN - 1U) & ~(size_t)(DICT_IMAGE_ALIGN - 1U);
+}
+
+/* Bytes of an LZP table with count occupied slots, packed or dense. */
+static size_t dict_image_lzp_size(uint32_t lzp_count) {
+    return (lzp_count > NETC_LZP_PACK_MAX)
+         ? (size_t)NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t)
+         : netc_lzp_pack_size(lzp_count);
+}
+
+/* Section offsets for an image with the given dict_flags and LZP count. */
+static void dict_image_layout(uint8_t dict_flags, uint32_t lzp_count, uint64_t *tables_off,
+                              uint64_t *lzp_off, uint64_t *image_size) {
+    size_t off = dict_image_align(sizeof(netc_dict_image_hdr_t));
+    *tables_off = off;
+    off += sizeof(netc_dict_tables_t);
+    *lzp_off = 0;
+    if (dict_flags & NETC_DICT_FLAG_LZP) {
+        off = dict_image_align(off);
+        *lzp_off = off;
+        off += dict_image_lzp_size(lzp_count);
+    }
+    *image_size = off + 4U;
+}
+
+/* =========================================================================
+ * netc_dict_save_image — serialize the built tables for netc_dict_map
+ * ========================================================================= */
+
+netc_result_t netc_dict_save_image(const netc_dict_t *dict, void **out, size_t *out_size) {
+    if (NETC_UNLIKELY(dict == NULL || out == NULL || out_size == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    netc_dict_image_hdr_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic              = NETC_DICT_IMAGE_MAGIC;
+    hdr.byte_order         = DICT_IMAGE_BYTE_ORDER;
+    hdr.image_version      = NETC_DICT_IMAGE_VERSION;
+    hdr.header_size        = (uint16_t)sizeof(hdr);
+    hdr.version            = dict->version;
+    hdr.model_id           = dict->model_id;
+    hdr.ctx_count          = dict->ctx_count;
+    hdr.dict_flags         = dict->dict_flags;
+    hdr.bigram_class_count = dict->bigram_class_count;
+    hdr.bigram_ctx_count   = (uint8_t)NETC_BIGRAM_CTX_COUNT;
+    hdr.tans_table_size    = (uint32_t)sizeof(netc_tans_table_t);
+    hdr.rans_table_size    = (uint32_t)sizeof(netc_rans_table_t);
+    hdr.lzp_ht_size        = (dict->dict_flags & NETC_DICT_FLAG_LZP) ? NETC_LZP_HT_SIZE : 0U;
+    hdr.blob_checksum      = dict->checksum;
+    if (hdr.lzp_ht_size != 0) {
+        const netc_lzp_table_t *lzp = &dict->lzp_table;
+        if (lzp->blk != NULL) {
+            hdr.lzp_count = netc_lzp_pack_count(lzp);
+        } else {
+            hdr.lzp_count = netc_lzp_count(lzp->ent);
+        }
+    }
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        hdr.bucket_end[b] = (uint16_t)(dict->buckets.end[b] / DICT_BUCKET_UNIT);
+    memcpy(hdr.bigram_class_map, dict->bigram_class_map, 256);
+    memcpy(hdr.delta_op, dict->delta_map.op, NETC_DELTA_MAP_LEN);
+    hdr.delta_tail   = dict->delta_map.tail;
+    hdr.delta_planes = dict->delta_map.planes;
+    dict_image_layout(dict->dict_flags, hdr.lzp_count, &hdr.tables_offset,
+                      &hdr.lzp_offset, &hdr.image_size);
+
+    size_t   img_sz = (size_t)hdr.image_size;
+    uint8_t *img    = (uint8_t *)calloc(1, img_sz);  /* zeroed alignment gaps */
+    if (NETC_UNLIKELY(img == NULL)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    memcpy(img, &hdr, sizeof(hdr));
+    netc_dict_tables_t *t = (netc_dict_tables_t *)(void *)(img + hdr.tables_offset);
+    memcpy(t->tables, dict->tables, sizeof(t->tables));
+    memcpy(t->bigram_tables, dict->bigram_tables, sizeof(t->bigram_tables));
+    memcpy(t->rans_tables, dict->rans_tables, sizeof(t->rans_tables));
+    if (dict->dict_flags & NETC_DICT_FLAG_LZX)
+        memcpy(t->lzx_tables, dict->lzx_tables, sizeof(t->lzx_tables));
+    if (hdr.lzp_offset != 0 && dict->lzp_table.blk != NULL) {
+        size_t blk_sz = NETC_LZP_BLK_COUNT * sizeof(netc_lzp_blk_t);
+        memcpy(img + hdr.lzp_offset, dict->lzp_table.blk, blk_sz);
+        memcpy(img + hdr.lzp_offset + blk_sz, dict->lzp_table.ent,
+               (size_t)hdr.lzp_count * sizeof(netc_lzp_entry_t));  /* pad stays 0 */
+    } else if (hdr.lzp_offset != 0) {
+        memcpy(img + hdr.lzp_offset, dict->lzp_table.ent,
+               (size_t)NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+    }
+    netc_write_u32_le(img + img_sz - 4U, netc_crc32(img, img_sz - 4U));
+
+    *out      = img;
+    *out_size = img_sz;
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * netc_dict_map_image — dictionary whose tables point into an image
+ * ========================================================================= */
+
+netc_result_t netc_dict_map_image(const void *image, size_t size, netc_dict_t **out) {
+    if (NETC_UNLIKELY(image == NULL || out == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    /* Tables are used in place, so the image must satisfy their alignment */
+    if (NETC_UNLIKELY(((uintptr_t)image % _Alignof(netc_dict_tables_t)) != 0)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    if (NETC_UNLIKELY(size < sizeof(netc_dict_image_hdr_t))) {
+        return NETC_ERR_DICT_INVALID;
+    }
+
+    const uint8_t *img = (const uint8_t *)image;
+    netc_dict_image_hdr_t hdr;
+    memcpy(&hdr, img, sizeof(hdr));
+    if (NETC_UNLIKELY(hdr.magic != NETC_DICT_IMAGE_MAGIC)) {
+        return NETC_ERR_DICT_INVALID;
+    }
+    /* Written by a build with a different byte order or table layout */
+    if (NETC_UNLIKELY(hdr.byte_order != DICT_IMAGE_BYTE_ORDER ||
+                      hdr.image_version != NETC_DICT_IMAGE_VERSION ||
+                      hdr.header_size != sizeof(hdr) ||
+                      hdr.ctx_count != (uint8_t)NETC_CTX_COUNT ||
+                      hdr.bigram_ctx_count != (uint8_t)NETC_BIGRAM_CTX_COUNT ||
+                      hdr.tans_table_size != sizeof(netc_tans_table_t) ||
+                      hdr.rans_table_size != sizeof(netc_rans_table_t))) {
+        return NETC_ERR_VERSION;
+    }
+    if (NETC_UNLIKELY(hdr.version < 3 || hdr.version > NETC_DICT_VERSION)) {
+        return NETC_ERR_VERSION;
+    }
+
+    uint64_t tables_off, lzp_off, img_sz;
+    dict_image_layout(hdr.dict_flags, hdr.lzp_count, &tables_off, &lzp_off, &img_sz);
+    if (NETC_UNLIKELY(hdr.tables_offset != tables_off || hdr.lzp_offset != lzp_off ||
+                      hdr.lzp_count > NETC_LZP_HT_SIZE ||
+                      hdr.image_size != img_sz || (uint64_t)size < img_sz ||
+                      hdr.lzp_ht_size != (lzp_off != 0 ? NETC_LZP_HT_SIZE : 0U) ||
+                      ((hdr.dict_flags & NETC_DICT_FLAG_LZP2) && lzp_off == 0))) {
+        return NETC_ERR_DICT_INVALID;
+    }
+
+    /* The only pass over the tables: one CRC32 of the whole image */
+    uint32_t stored_cksum = netc_read_u32_le(img + img_sz - 4U);
+    if (NETC_UNLIKELY(stored_cksum != netc_crc32(img, (size_t)img_sz - 4U))) {
+        return NETC_ERR_DICT_INVALID;
+    }
+
+    netc_bucket_map_t buckets;
+    uint32_t          end[NETC_CTX_COUNT];
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        end[b] = (uint32_t)hdr.bucket_end[b] * DICT_BUCKET_UNIT;
+    if (NETC_UNLIKELY(dict_buckets_set(&buckets, end) != 0)) {
+        return NETC_ERR_DICT_INVALID;
+    }
+
+    netc_delta_map_t delta_map;
+    memcpy(delta_map.op, hdr.delta_op, NETC_DELTA_MAP_LEN);
+    delta_map.tail   = hdr.delta_tail;
+    delta_map.planes = hdr.delta_planes;
+    if (NETC_UNLIKELY(!netc_delta_map_valid(&delta_map))) {
+        return NETC_ERR_DICT_INVALID;
+    }
+
+    /* Each block of a packed table must start where the previous one ends,
+     * and the last end at lzp_count, or lookups could read past ent[] */
+    netc_lzp_table_t lzp = { NULL, NULL };
+    if (lzp_off != 0) {
+        lzp.ent = (const netc_lzp_entry_t *)(const void *)(img + lzp_off);
+        if (hdr.lzp_count <= NETC_LZP_PACK_MAX) {
+            lzp.blk = (const netc_lzp_blk_t *)(const void *)lzp.ent;
+            lzp.ent = (const netc_lzp_entry_t *)(const void *)
+                      (img + lzp_off + NETC_LZP_BLK_COUNT * sizeof(netc_lzp_blk_t));
+            uint32_t n = 0;
+            for (uint32_t i = 0; i < NETC_LZP_BLK_COUNT && n != UINT32_MAX; i++)
+                n = (lzp.blk[i].base == n) ? n + netc_popcount32(lzp.blk[i].bits) : UINT32_MAX;
+            if (NETC_UNLIKELY(n != hdr.lzp_count)) {
+                return NETC_ERR_DICT_INVALID;
+            }
+        }
+    }
+
+    netc_dict_t *d = (netc_dict_t *)calloc(1, sizeof(netc_dict_t));
+    if (NETC_UNLIKELY(d == NULL)) {
+        return NETC_ERR_NOMEM;
+    }
+
+    const netc_dict_tables_t *t = (const netc_dict_tables_t *)(const void *)(img + tables_off);
+    d->magic              = NETC_DICT_MAGIC;
+    d->version            = hdr.version;
+    d->model_id           = hdr.model_id;
+    d->ctx_count          = hdr.ctx_count;
+    d->dict_flags         = hdr.dict_flags;
+    d->tables             = t->tables;
+    d->bigram_tables      = (const netc_tans_table_t (*)[NETC_BIGRAM_CTX_COUNT])
+                            t->bigram_tables;
+    d->rans_tables        = t->rans_tables;
+    d->lzx_tables         = t->lzx_tables;
+    dict_bigram_set_init(d);
+    d->bigram_class_count = hdr.bigram_class_count;
+    d->lzp_table          = lzp;
+    d->checksum           = hdr.blob_checksum;
+    d->buckets            = buckets;
+    d->delta_map          = delta_map;
+    netc_delta_planes_init(&d->delta_planes, &delta_map);
+    memcpy(d->bigram_class_map, hdr.bigram_class_map, 256);
+
+    netc_simd_ops_init(&d->simd_ops, NETC_SIMD_LEVEL_AUTO);
+    *out = d;
+    return NETC_OK;
+}
+
+/* =========================================================================
+ * netc_dict_map — map an image file read-only and shared
+ *
+ * MAP_SHARED / a FILE_MAP_READ view keeps the tables in the page cache, so
+ * every process on the host mapping the same file shares one physical copy.
+ * ========================================================================= */
+
+#if defined(_WIN32)
+
+static void dict_unmap(void *base, size_t size) {
+    (void)size;
+    UnmapViewOfFile(base);
+}
+
+static netc_result_t dict_map_file(const char *path, void **base, size_t *size) {
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    LARGE_INTEGER fsz;
+    if (!GetFileSizeEx(f, &fsz) || fsz.QuadPart <= 0 ||
+        (uint64_t)fsz.QuadPart > (uint64_t)SIZE_MAX) {
+        CloseHandle(f);
+        return NETC_ERR_DICT_INVALID;
+    }
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(f);
+    if (m == NULL) {
+        return NETC_ERR_NOMEM;
+    }
+    /* The view keeps the mapping object alive after its handle is closed */
+    void *p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(m);
+    if (p == NULL) {
+        return NETC_ERR_NOMEM;
+    }
+    *base = p;
+    *size = (size_t)fsz.QuadPart;
+    return NETC_OK;
+}
+
+#elif defined(DICT_HAVE_MMAP)
+
+static void dict_unmap(void *base, size_t size) {
+    munmap(base, size);
+}
+
+static netc_result_t dict_map_file(const char *path, void **base, size_t *size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NETC_ERR_INVALID_ARG;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+        (uint64_t)st.st_size > (uint64_t)SIZE_MAX) {
+        close(fd);
+        return NETC_ERR_DICT_INVALID;
+    }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* the mapping holds its own reference to the file */
+    if (p == MAP_FAILED) {
+        return NETC_ERR_NOMEM;
+    }
+    *base = p;
+    *size = (size_t)st.st_size;
+    return NETC_OK;
+}
+
+#else
+
+static void dict_unmap(void *base, size_t size) {
+    (void)base;
+    (void)size;
+}
+
+static netc_result_t dict_map_file(const char *path, void **base, size_t *size) {
+    (void)path;
+    (void)base;
+    (void)size;
+    return NETC_ERR_UNSUPPORTED;
+}
+
+#endif
+
+netc_result_t netc_dict_map(const char *path, netc_dict_t **out) {
+    if (NETC_UNLIKELY(path == NULL || out == NULL)) {
+        return NETC_ERR_INVALID_ARG;
+    }
+
+    void  *base = NULL;
+    size_t size = 0;
+    netc_result_t rc = dict_map_file(path, &base, &size);
+    if (rc != NETC_OK) {
+        return rc;
+    }
+
+    netc_dict_t *d = NULL;
+    rc = netc_dict_map_image(base, size, &d);
+    if (rc != NETC_OK) {
+        dict_unmap(base, size);
+        return rc;
+    }
+    d->map_base = base;
+    d->map_size = size;
     *out = d;
     return NETC_OK;
 }
@@ -784,9 +2288,14 @@ netc_result_t netc_dict_load(const void *data, size_t size, netc_dict_t **out) {
  * ========================================================================= */
 
 void netc_dict_free(netc_dict_t *dict) {
-    if (dict != NULL) {
-        free(dict->lzp_table);
+    if (dict == NULL) {
+        return;
+    }
+    if (dict->map_base != NULL) {
+        dict_unmap(dict->map_base, dict->map_size);
     }
+    free(dict->owned_lzp);
+    free(dict->owned);
     free(dict);
 }
 
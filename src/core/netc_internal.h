@@ -10,11 +10,13 @@
 #include "../../include/netc.h"
 #include "../util/netc_platform.h"
 #include "../algo/netc_tans.h"
+#include "../algo/netc_rans.h"
 #include "../algo/netc_delta.h"
 #include "../algo/netc_lzp.h"
 #include "../simd/netc_simd.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 /* =========================================================================
  * Limits
@@ -25,22 +27,125 @@
 #define NETC_DICT_MAGIC         0x4E455443U    /* "NETC" */
 #define NETC_DICT_VERSION       5U             /* v0.5: 8-class trained bigram quantization */
 #define NETC_DICT_VERSION_V4    4U             /* v0.4: LZP hash-prediction table (backward compat) */
+#define NETC_DICT_IMAGE_MAGIC   0x4D54454EU    /* "NETM" — built-table image (netc_dict_map) */
+#define NETC_DICT_IMAGE_VERSION 6U             /* v6: LZ77X token tables */
+
+/* Acknowledged baselines (NETC_CFG_FLAG_BASELINE, AD-023) */
+#define NETC_BASELINE_SLOTS      32U    /* Packets kept per side, by sequence */
+#define NETC_BASELINE_WINDOW     16U    /* Oldest baseline the compressor uses */
 
 /* Adaptive mode: rebuild interval and blending parameters */
 #define NETC_ADAPTIVE_INTERVAL   128U   /* Rebuild tables every N packets */
 #define NETC_ADAPTIVE_ALPHA_NUM  3U     /* Blend ratio: alpha = 3/4 (accumulated) */
 #define NETC_ADAPTIVE_ALPHA_DEN  4U     /* Blend ratio: (1-alpha) = 1/4 (dict baseline) */
+#define NETC_ADAPTIVE_DECAY_MAX  15U    /* Slowest decay shift (adaptive_decay) */
+#define NETC_ADAPTIVE_SAT        (1U << 31) /* Bucket total halved above this without decay */
+#define NETC_ADAPTIVE_BG_SLOTS   16U    /* Bigram (bucket, class) pairs adapted at once */
+#define NETC_ADAPTIVE_BG_NONE    0xFFU  /* pair_slot / slot_pair entry: unassigned */
+
+/* =========================================================================
+ * Compression level → encoder trial budget
+ *
+ * netc_cfg_t.compression_level (0..9) selects which candidate encodings the
+ * compressor tries per packet and how aggressively it exits early.  The plan
+ * is resolved once at context creation; the hot path only tests bits.
+ *
+ *   0  PCTX/single-region tANS only; in-packet LZ77 only as the fallback
+ *      when tANS does not compress, then passthrough
+ *   1  + order-2 delta trial, raw-tANS retry when delta residuals fail
+ *   2  + bigram-PCTX trial, cross-packet LZ77X competition
+ *   3  + in-packet LZ77 (>=512B), 10-bit tANS  (== NETC_CFG_FLAG_FAST_COMPRESS)
+ *   4  + LZP-vs-delta trial, in-packet LZ77 from 256B
+ *   5  + single-region vs PCTX compare on raw bytes (default; full pre-level
+ *        behaviour)
+ *   6  in-packet LZ77 from 128B; static rANS vs PCTX on packets >= 1 KB
+ *   7  LZP-vs-delta trial without the ratio<0.5 early exit; cost-model
+ *      rankings also encode the runner-up and keep the smaller output
+ *   8  LZ77X without the similarity/diversity pre-check
+ *   9  in-packet LZ77 from 64B and regardless of the tANS ratio
+ *
+ * Candidates within a trial are ranked by a -log2(p) size prediction and
+ * only the winner is encoded (see netc_tans_cost), so raising the level
+ * mostly adds cheap predictions rather than full encodes.
+ *
+ * NETC_CFG_FLAG_FAST_COMPRESS caps the effective level at 3.
+ * ========================================================================= */
+
+#define NETC_LEVEL_MAX          9U
+#define NETC_LEVEL_FAST         3U
+
+#define NETC_TRIAL_ORDER2       (1U << 0)  /* order-2 delta vs order-1 */
+#define NETC_TRIAL_RAW_RETRY    (1U << 1)  /* raw-tANS retry after delta fails */
+#define NETC_TRIAL_BIGRAM       (1U << 2)  /* bigram-PCTX vs unigram PCTX */
+#define NETC_TRIAL_LZ77X        (1U << 3)  /* cross-packet LZ77X competition */
+#define NETC_TRIAL_LZ77         (1U << 4)  /* in-packet LZ77 competition */
+#define NETC_TRIAL_TANS10       (1U << 5)  /* 10-bit tANS for <=128B packets */
+#define NETC_TRIAL_LZP          (1U << 6)  /* LZP-only vs delta */
+#define NETC_TRIAL_SR           (1U << 7)  /* single-region best-fit vs PCTX */
+#define NETC_TRIAL_LZP_ALWAYS   (1U << 8)  /* no ratio early exit on LZP trial */
+#define NETC_TRIAL_LZ77X_ALWAYS (1U << 9)  /* no pre-check before LZ77X */
+#define NETC_TRIAL_LZ77_ALWAYS  (1U << 10) /* no ratio early exit on LZ77 */
+#define NETC_TRIAL_VERIFY2      (1U << 11) /* encode cost-model runner-up too */
+#define NETC_TRIAL_RANS         (1U << 12) /* static rANS vs PCTX on wide packets */
+#define NETC_TRIAL_LZX_TANS     (1U << 13) /* tANS-coded LZ77X vs its raw tokens */
+
+typedef struct {
+    uint32_t trials;    /* NETC_TRIAL_* bitmask */
+    uint32_t lz77_min;  /* smallest packet that tries in-packet LZ77 */
+    uint32_t lzx_depth; /* LZ77X hash-chain candidates tried per position */
+} netc_level_plan_t;
+
+/** Resolve the trial plan for a compression level and NETC_CFG_FLAG_* set. */
+void netc_level_plan_init(netc_level_plan_t *plan, uint8_t level, uint32_t flags);
 
 /* =========================================================================
  * Dictionary internals
  * ========================================================================= */
 
+/* Token tables of entropy-coded LZ77X (NETC_DICT_FLAG_LZX, AD-031), one
+ * per role a token byte can have */
+#define NETC_LZX_TBL_CMD    0U  /* Literal run / ref header (kind + length) */
+#define NETC_LZX_TBL_NEAR   1U  /* Within-packet ref: offset - 1 */
+#define NETC_LZX_TBL_FAR_LO 2U  /* Ring ref: offset - 1, low byte */
+#define NETC_LZX_TBL_FAR_HI 3U  /* Ring ref: offset - 1, high byte */
+#define NETC_LZX_TABLES     4U
+
+/**
+ * netc_dict_tables_t — the built coding tables of a dictionary.
+ *
+ * Plain data with no pointers, so a dictionary image (netc_dict_save_image)
+ * stores this struct verbatim and netc_dict_map() uses it in place.
+ */
+typedef struct {
+    /* Per-context-bucket tANS tables — 16 tables in v0.2+ */
+    netc_tans_table_t tables[NETC_CTX_COUNT];
+
+    /* Per-bucket bigram sub-tables (v0.3+).
+     * bigram_tables[bucket][class] is the tANS table used when the previous byte
+     * maps to bigram class `class` (via netc_bigram_class(prev_byte, class_map)).
+     * v4 dicts: 4 classes per bucket (static prev>>6).
+     * v5 dicts: 8 classes per bucket (trained class_map).
+     * Only populated when trained with NETC_CFG_FLAG_BIGRAM. */
+    netc_tans_table_t bigram_tables[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
+
+    /* Static rANS tables derived from the unigram frequencies of tables[]
+     * (NETC_ALG_RANS packets). Not part of the v5 blob. */
+    netc_rans_table_t rans_tables[NETC_CTX_COUNT];
+
+    /* LZ77X token tables, indexed by NETC_LZX_TBL_*.  Zeroed (invalid)
+     * unless the dictionary has NETC_DICT_FLAG_LZX. */
+    netc_tans_table_t lzx_tables[NETC_LZX_TABLES];
+} netc_dict_tables_t;
+
 /**
  * netc_dict_t — trained probability model.
  *
  * v0.2: 16 fine-grained context buckets (NETC_CTX_COUNT=16) replacing the
  * original 4 coarse buckets. Each bucket covers a contiguous byte-offset band.
  * The ctx_count field makes the blob format self-describing.
+ *
+ * The table pointers reference either heap storage owned by the dictionary
+ * (train/load) or a read-only image mapped by netc_dict_map().
  */
 struct netc_dict {
     uint32_t magic;      /* NETC_DICT_MAGIC — sanity check */
@@ -49,16 +154,15 @@ struct netc_dict {
     uint8_t  ctx_count;  /* Number of context buckets stored (= NETC_CTX_COUNT) */
     uint8_t  dict_flags; /* NETC_DICT_FLAG_* bitmask (was _pad in v3) */
 
-    /* Per-context-bucket tANS tables — 16 tables in v0.2+ */
-    netc_tans_table_t tables[NETC_CTX_COUNT];
+    /* netc_dict_tables_t members, see above */
+    const netc_tans_table_t  *tables;
+    const netc_tans_table_t (*bigram_tables)[NETC_BIGRAM_CTX_COUNT];
+    const netc_rans_table_t  *rans_tables;
+    const netc_tans_table_t  *lzx_tables;
 
-    /* Per-bucket bigram sub-tables (v0.3+).
-     * bigram_tables[bucket][class] is the tANS table used when the previous byte
-     * maps to bigram class `class` (via netc_bigram_class(prev_byte, class_map)).
-     * v4 dicts: 4 classes per bucket (static prev>>6).
-     * v5 dicts: 8 classes per bucket (trained class_map).
-     * Only populated when trained with NETC_CFG_FLAG_BIGRAM. */
-    netc_tans_table_t bigram_tables[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
+    /* Pointer view of bigram_tables, the form the bigram coders take.
+     * Adaptive contexts start from a copy and retarget single pairs. */
+    netc_bigram_set_t bigram_set;
 
     /* Trained bigram class map (v0.5+): maps each byte value (0-255) to class 0-7.
      * For v4 dicts loaded into v5 code, this is built from prev_byte >> 6. */
@@ -67,22 +171,103 @@ struct netc_dict {
     /* Number of bigram classes actually in use: 4 for v4 dicts, 8 for v5 dicts. */
     uint8_t  bigram_class_count;
 
-    /* LZP hash table (v0.4+, optional).
-     * Maps 3-byte context hashes to predicted next bytes.
-     * NULL when no LZP model is present (v3 backward compat).
-     * Allocated as a separate block of NETC_LZP_HT_SIZE entries. */
-    netc_lzp_entry_t *lzp_table;
+    /* Position bucket layout: netc_bucket_map_default unless the blob carries
+     * learned boundaries (NETC_DICT_FLAG_BUCKETS). */
+    netc_bucket_map_t buckets;
+
+    /* Per-offset delta operators: netc_delta_map_default unless the blob
+     * carries a learned map (NETC_DICT_FLAG_DELTA_MAP). */
+    netc_delta_map_t delta_map;
 
-    uint32_t checksum;   /* CRC32 of all preceding fields */
+    /* Byte-plane runs of delta_map (count 0 unless delta_map.planes). */
+    netc_delta_planes_t delta_planes;
+
+    /* LZP hash table (v0.4+, optional).
+     * Maps (prev, position) hashes, plus (prev2, prev, position) hashes
+     * with NETC_DICT_FLAG_LZP2, to predicted next bytes.
+     * ent is NULL when no LZP model is present (v3 backward compat).
+     * Packed unless it has more than NETC_LZP_PACK_MAX entries. */
+    netc_lzp_table_t lzp_table;
+
+    uint32_t checksum;   /* CRC32 of the serialized v5 blob */
+
+    /* Runtime only, not serialized: best SIMD dispatch on this CPU, resolved
+     * at train/load time for the stateless path (which has no context). */
+    netc_simd_ops_t simd_ops;
+
+    /* Backing storage: owned/owned_lzp for train/load, NULL for an image.
+     * map_base/map_size: the file view netc_dict_map() created, if any. */
+    netc_dict_tables_t *owned;
+    void               *owned_lzp;   /* storage behind lzp_table */
+    void               *map_base;
+    size_t              map_size;
 };
 
 /* Dictionary flags (dict_flags field) */
-#define NETC_DICT_FLAG_LZP   0x01U  /* LZP table is present in blob */
+#define NETC_DICT_FLAG_LZP       0x01U  /* LZP table is present in blob */
+#define NETC_DICT_FLAG_BUCKETS   0x02U  /* learned bucket boundaries in blob */
+#define NETC_DICT_FLAG_DELTA_MAP 0x04U  /* learned delta operator map in blob */
+#define NETC_DICT_FLAG_LZP2      0x08U  /* LZP table holds order-2 contexts too */
+#define NETC_DICT_FLAG_LZX       0x10U  /* LZ77X token frequencies in blob */
+
+/* Whether dict's LZP table is dual-order (netc_lzp_guess order2). */
+static NETC_INLINE int netc_lzp_order2(const netc_dict_t *dict) {
+    return dict != NULL && (dict->dict_flags & NETC_DICT_FLAG_LZP2) != 0;
+}
+
+/* Whether dict can code LZ77X token streams (NETC_LZ77X_TANS). */
+static NETC_INLINE int netc_dict_has_lzx(const netc_dict_t *dict) {
+    return dict != NULL && (dict->dict_flags & NETC_DICT_FLAG_LZX) != 0;
+}
+
+/* =========================================================================
+ * LZ77X match index — hash chains over the compressor's ring (AD-030)
+ *
+ * Each ring position is linked in once its 3 bytes are known.  Positions
+ * are stream offsets (bytes appended so far, mod 2^32): head[] holds the
+ * newest position + 1 per hash (0 = none) and prev[] the distance from a
+ * position back to the previous one with the same hash (0 = none, or too
+ * far back for the window).
+ * ========================================================================= */
+
+#define NETC_LZX_HASH_BITS  13U
+#define NETC_LZX_HASH_SIZE  (1U << NETC_LZX_HASH_BITS)   /* 8192 */
+#define NETC_LZX_WINDOW_MAX 65536U                       /* longest long-ref offset */
+
+typedef struct {
+    uint32_t *head;  /* [NETC_LZX_HASH_SIZE]; NULL until the first compress */
+    uint16_t *prev;  /* [mask + 1], indexed by position & mask */
+    uint32_t  mask;  /* power of two covering the ring (at most the window), minus 1 */
+    uint32_t  end;   /* stream offset of ring_pos */
+} netc_lzx_index_t;
+
+/* Hash of the 3 bytes starting at a position */
+static NETC_INLINE uint32_t netc_lzx_hash(uint8_t b0, uint8_t b1, uint8_t b2) {
+    uint32_t v = (uint32_t)b0 | ((uint32_t)b1 << 8) | ((uint32_t)b2 << 16);
+    return (v * 2654435761u) >> (32U - NETC_LZX_HASH_BITS);
+}
 
 /* =========================================================================
  * Context internals
  * ========================================================================= */
 
+/**
+ * netc_adapt_bigram_t — adaptive bigram state (ADAPTIVE with BIGRAM).
+ *
+ * All 128 (bucket, class) pairs are ranked by byte count, but only the
+ * NETC_ADAPTIVE_BG_SLOTS busiest ones hold symbol counts and a rebuilt
+ * table; every other pair keeps coding with its dict table.
+ */
+typedef struct {
+    netc_bigram_set_t  set;    /* Tables the coders use: dict or slot */
+    uint32_t           pair_total[NETC_CTX_COUNT * NETC_BIGRAM_CTX_COUNT];
+    uint32_t           freq[NETC_ADAPTIVE_BG_SLOTS][NETC_TANS_SYMBOLS];
+    uint32_t           total[NETC_ADAPTIVE_BG_SLOTS];
+    uint8_t            pair_slot[NETC_CTX_COUNT * NETC_BIGRAM_CTX_COUNT];
+    uint8_t            slot_pair[NETC_ADAPTIVE_BG_SLOTS];
+    netc_tans_table_t *tables; /* [NETC_ADAPTIVE_BG_SLOTS], NULL until the first slot rebuild is due */
+} netc_adapt_bigram_t;
+
 /**
  * netc_ctx_t — per-connection compression context.
  *
@@ -94,11 +279,13 @@ struct netc_ctx {
     uint32_t           flags;         /* NETC_CFG_FLAG_* bitmask */
     uint8_t            compression_level;
     uint8_t            simd_level;
+    netc_level_plan_t  plan;          /* Trial budget derived from compression_level */
 
-    /* --- Stateful mode ring buffer --- */
-    uint8_t           *ring;          /* Ring buffer for history (NULL in stateless) */
-    uint32_t           ring_size;     /* Allocated ring buffer size */
+    /* --- Stateful mode ring buffer (LZ77X history) --- */
+    uint8_t           *ring;          /* Ring buffer for history (NULL until allocated) */
+    uint32_t           ring_size;     /* Ring buffer size (0 = LZ77X disabled) */
     uint32_t           ring_pos;      /* Current write position (wraps) */
+    netc_lzx_index_t   lzx;           /* Match index over ring (compressor only) */
 
     /* --- SIMD dispatch table (set at ctx_create, read-only in hot path) --- */
     netc_simd_ops_t    simd_ops;      /* Best available bulk operation implementations */
@@ -108,6 +295,21 @@ struct netc_ctx {
     size_t             prev_pkt_size; /* Size of bytes valid in prev_pkt (0 = no prior packet) */
     uint8_t           *prev2_pkt;     /* Copy of packet before prev (order-2 delta, NULL if not adaptive) */
     size_t             prev2_pkt_size; /* Size of bytes valid in prev2_pkt (0 = no prior-prior packet) */
+    size_t             hist_cap;      /* Capacity of prev_pkt, prev2_pkt and ref_pkt[] (grown on demand) */
+
+    /* --- Reference history (NETC_CFG_FLAG_DELTA_REFS, AD-022) --- */
+    uint8_t           *ref_pkt[NETC_DELTA_REFS];  /* Recent packets, most recent first (NULL without DELTA_REFS) */
+    size_t             ref_size[NETC_DELTA_REFS]; /* Bytes valid in each slot (0 = empty) */
+
+    /* --- Acknowledged baselines (NETC_CFG_FLAG_BASELINE, AD-023) --- */
+    uint8_t           *base_pkt[NETC_BASELINE_SLOTS];  /* Packet with sequence s in slot s % SLOTS (NULL without BASELINE) */
+    size_t             base_size[NETC_BASELINE_SLOTS]; /* Bytes valid in each slot */
+    uint8_t            base_seq[NETC_BASELINE_SLOTS];  /* Sequence number held by each slot */
+    uint32_t           base_live;     /* Bitmask of slots holding a packet */
+    uint8_t            base_ack;      /* Newest acknowledged sequence (compressor) */
+    uint8_t            base_acked;    /* base_ack is valid */
+    uint8_t            last_seq;      /* Sequence of the last packet through the context */
+    uint8_t            last_seq_live; /* last_seq is valid */
 
     /* --- Sequence counter for stateless delta --- */
     uint8_t            context_seq;   /* Rolling 8-bit counter (RFC-001 §9.1) */
@@ -115,6 +317,7 @@ struct netc_ctx {
     /* --- Working memory arena (AD-005: zero malloc in hot path) --- */
     uint8_t           *arena;         /* Pre-allocated scratch buffer */
     size_t             arena_size;    /* Arena capacity */
+    uint8_t            arena_owned;   /* 0 when borrowed from cfg->arena */
 
     /* --- Statistics (only valid if NETC_CFG_FLAG_STATS set) --- */
     netc_stats_t       stats;
@@ -122,11 +325,188 @@ struct netc_ctx {
     /* --- Adaptive mode state (Phase 1: frequency tracking + table rebuild) --- */
     uint32_t          *adapt_freq;       /* [NETC_CTX_COUNT][256] frequency accumulators (NULL if not adaptive) */
     uint32_t          *adapt_total;      /* [NETC_CTX_COUNT] total byte count per bucket */
-    netc_tans_table_t *adapt_tables;     /* [NETC_CTX_COUNT] mutable tANS tables (NULL if not adaptive) */
-    netc_lzp_entry_t  *adapt_lzp;       /* Mutable LZP table (NULL if not adaptive or no LZP in dict) */
+    netc_tans_table_t *adapt_tables;     /* [NETC_CTX_COUNT] rebuilt tANS tables (NULL until the first rebuild is due) */
+    uint8_t            adapt_tables_live; /* adapt_tables holds a rebuild; else the dict tables are in use */
+    netc_lzp_entry_t  *adapt_lzp;       /* Dense mutable LZP table (NULL while changes fit in adapt_lzp_ovl) */
+    netc_lzp_overlay_t adapt_lzp_ovl;    /* Sparse changes over dict->lzp_table (base NULL when inactive) */
     uint32_t           adapt_pkt_count;  /* Packets processed since last table rebuild */
+    uint8_t            adapt_decay;      /* Counts lose 1/2^n after each bucket rebuild (0 = no decay) */
+    netc_adapt_bigram_t *adapt_bg;       /* Adaptive bigram tables (NULL unless ADAPTIVE with BIGRAM) */
 };
 
+/* =========================================================================
+ * Per-thread scratch (netc_scratch_t, netc_ctx.c)
+ * ========================================================================= */
+
+struct netc_scratch {
+    uint8_t *arena;       /* Working memory for one call at a time */
+    size_t   arena_size;
+};
+
+/* =========================================================================
+ * Lazily allocated per-context state (netc_ctx.c)
+ *
+ * prev_pkt / prev2_pkt start empty and grow to the largest packet seen; the
+ * LZ77X ring is allocated at creation only when the compressor may use it,
+ * otherwise on the first decompress, and its match index on the first
+ * compress that may try LZ77X.  All are called before a packet touches any
+ * context state, so a NETC_ERR_NOMEM leaves the context intact.
+ * ========================================================================= */
+
+netc_result_t netc_ctx_grow_history(netc_ctx_t *ctx, size_t need);
+netc_result_t netc_ctx_alloc_ring(netc_ctx_t *ctx);
+netc_result_t netc_ctx_alloc_lzx(netc_ctx_t *ctx);
+
+/** LZ77X tokens of src against ctx's ring, as the compressor's trial emits
+ *  them, then append src to the ring (netc_compress.c).  The dictionary
+ *  trainer counts its token tables on these.  Returns the token bytes
+ *  written to dst, or (size_t)-1 if they would exceed cap or not be fewer
+ *  than src_size (src is appended either way). */
+size_t netc_lzx_parse(netc_ctx_t *ctx, const uint8_t *src, size_t src_size,
+                      uint8_t *dst, size_t cap);
+
+/** Allocate the LZ77X match index if this context's compressor may use it. */
+static NETC_INLINE netc_result_t netc_ctx_reserve_lzx(netc_ctx_t *ctx) {
+    if (NETC_LIKELY(ctx->lzx.head != NULL) || ctx->ring == NULL ||
+        !(ctx->plan.trials & NETC_TRIAL_LZ77X))
+        return NETC_OK;
+    return netc_ctx_alloc_lzx(ctx);
+}
+
+/** Make room for an n-byte packet in the delta history (stateful only). */
+static NETC_INLINE netc_result_t netc_ctx_reserve_history(netc_ctx_t *ctx, size_t n) {
+    if (NETC_LIKELY(n <= ctx->hist_cap) || !(ctx->flags & NETC_CFG_FLAG_STATEFUL))
+        return NETC_OK;
+    return netc_ctx_grow_history(ctx, n);
+}
+
+/** Rotate prev2 <- prev and store the n-byte packet p as prev.
+ *  netc_ctx_reserve_history(ctx, n) must have succeeded. */
+static NETC_INLINE void netc_ctx_push_history(netc_ctx_t *ctx,
+                                              const void *p, size_t n) {
+    if (!(ctx->flags & NETC_CFG_FLAG_STATEFUL)) return;
+    if (ctx->prev2_pkt != NULL) {
+        /* Both buffers have hist_cap bytes: swap instead of copying */
+        uint8_t *t     = ctx->prev2_pkt;
+        ctx->prev2_pkt = ctx->prev_pkt;
+        ctx->prev_pkt  = t;
+        ctx->prev2_pkt_size = ctx->prev_pkt_size;
+    }
+    if (n > 0) memcpy(ctx->prev_pkt, p, n);
+    ctx->prev_pkt_size = n;
+}
+
+/* -------------------------------------------------------------------------
+ * Reference history (NETC_CFG_FLAG_DELTA_REFS, AD-022)
+ *
+ * Each packet is coded against one slot of ref_pkt[]: the slot is copied
+ * into prev_pkt, the packet goes through the normal single-reference path,
+ * and the prev_pkt buffer (now holding the packet) is swapped into the
+ * slot the packet replaces.  The compressor and decompressor run the same
+ * steps, so their histories stay identical.
+ * ------------------------------------------------------------------------- */
+
+/** Slots holding an n-byte packet, most recent first; returns how many. */
+static NETC_INLINE uint32_t netc_ctx_ref_candidates(const netc_ctx_t *ctx,
+                                                    size_t n, uint8_t *cand) {
+    uint32_t c = 0;
+    for (uint32_t i = 0; i < NETC_DELTA_REFS; i++) {
+        if (n > 0 && ctx->ref_size[i] == n) cand[c++] = (uint8_t)i;
+    }
+    return c;
+}
+
+/** Make slot the delta reference of the next packet. */
+static NETC_INLINE void netc_ctx_ref_load(netc_ctx_t *ctx, uint32_t slot) {
+    size_t n = ctx->ref_size[slot];
+    if (n > 0) memcpy(ctx->prev_pkt, ctx->ref_pkt[slot], n);
+    ctx->prev_pkt_size = n;
+}
+
+/**
+ * After a packet: store it (prev_pkt) in place of the same-size slot it
+ * matches best, if at least a quarter (n/4) of its bytes match (the earlier
+ * packet of the same kind), else of the oldest slot, and make that slot the
+ * most recent.
+ * Both sides hold the packet at this point, so the choice needs nothing
+ * from the wire.
+ */
+static NETC_INLINE void netc_ctx_ref_commit(netc_ctx_t *ctx) {
+    const size_t n    = ctx->prev_pkt_size;
+    uint32_t     slot = NETC_DELTA_REFS - 1u;
+    uint32_t     best = (uint32_t)(n / 4u);
+    for (uint32_t i = 0; i < NETC_DELTA_REFS && n > 0; i++) {
+        if (ctx->ref_size[i] != n) continue;
+        uint32_t m = ctx->simd_ops.match_count(ctx->ref_pkt[i], ctx->prev_pkt, n);
+        if (m >= best) {
+            best = m;
+            slot = i;
+            if (m == n) break;
+        }
+    }
+
+    uint8_t *spare      = ctx->ref_pkt[slot];
+    size_t   spare_size = ctx->ref_size[slot];
+    for (uint32_t i = slot; i > 0; i--) {
+        ctx->ref_pkt[i]  = ctx->ref_pkt[i - 1];
+        ctx->ref_size[i] = ctx->ref_size[i - 1];
+    }
+    ctx->ref_pkt[0]    = ctx->prev_pkt;
+    ctx->ref_size[0]   = n;
+    ctx->prev_pkt      = spare;
+    ctx->prev_pkt_size = spare_size;
+}
+
+/* -------------------------------------------------------------------------
+ * Acknowledged baselines (NETC_CFG_FLAG_BASELINE, AD-023)
+ *
+ * Packet s is kept in slot s % NETC_BASELINE_SLOTS on both sides.  A delta
+ * packet is coded against the slot of its baseline, loaded into prev_pkt
+ * as with the reference history; afterwards the prev_pkt buffer (now
+ * holding the packet) is swapped into the packet's own slot.
+ * ------------------------------------------------------------------------- */
+
+/** Slot holding packet seq with n bytes, or -1 if it is not kept. */
+static NETC_INLINE int netc_ctx_base_find(const netc_ctx_t *ctx,
+                                          uint8_t seq, size_t n) {
+    uint32_t slot = seq % NETC_BASELINE_SLOTS;
+    if (!(ctx->base_live & (1u << slot)) || ctx->base_seq[slot] != seq ||
+        ctx->base_size[slot] != n)
+        return -1;
+    return (int)slot;
+}
+
+/** Make slot (or nothing, for -1) the delta reference of the next packet. */
+static NETC_INLINE void netc_ctx_base_load(netc_ctx_t *ctx, int slot) {
+    if (slot < 0) {
+        ctx->prev_pkt_size = 0;
+        return;
+    }
+    size_t n = ctx->base_size[slot];
+    if (n > 0) memcpy(ctx->prev_pkt, ctx->base_pkt[slot], n);
+    ctx->prev_pkt_size = n;
+}
+
+/**
+ * After packet seq: keep it (prev_pkt) in its slot.  The slot always takes
+ * the packet: 8 bits cannot tell a packet 32+ packets late from one after
+ * a long outage, and an evicted baseline only costs the compressor's
+ * fallback to whole packets once the newest ack ages out of its window.
+ */
+static NETC_INLINE void netc_ctx_base_commit(netc_ctx_t *ctx, uint8_t seq) {
+    uint32_t slot = seq % NETC_BASELINE_SLOTS;
+    ctx->last_seq      = seq;
+    ctx->last_seq_live = 1;
+
+    uint8_t *spare      = ctx->base_pkt[slot];
+    ctx->base_pkt[slot]  = ctx->prev_pkt;
+    ctx->base_size[slot] = ctx->prev_pkt_size;
+    ctx->base_seq[slot]  = seq;
+    ctx->base_live      |= 1u << slot;
+    ctx->prev_pkt        = spare;
+    ctx->prev_pkt_size   = 0;
+}
+
 /* =========================================================================
  * Packet header layout helpers — RFC-001 §9.1
  *
@@ -198,7 +578,7 @@ static NETC_INLINE void netc_hdr_read(const void *src, netc_pkt_header_t *h) {
  *   0x04 TANS_PCTX            0x0C TANS_MREG+BIGRAM
  *   0x05 TANS_PCTX+DELTA      0x0D TANS_MREG+BIGRAM+DELTA
  *   0x06 TANS_PCTX+LZP        0x0E LZ77X
- *   0x07 TANS_PCTX+LZP+DELTA  0x0F reserved
+ *   0x07 TANS_PCTX+LZP+DELTA  0x0F LZ77X+TANS
  *
  * Bucketed (base + bucket[0..15]):
  *   0x10-0x1F TANS              0x50-0x5F TANS+X2
@@ -206,9 +586,52 @@ static NETC_INLINE void netc_hdr_read(const void *src, netc_pkt_header_t *h) {
  *   0x30-0x3F TANS+BIGRAM       0x70-0x7F LZP
  *   0x40-0x4F TANS+BIGRAM+DELTA 0x80-0x8F LZP+DELTA
  *
+ * Interleaved PCTX (wide packets, see netc_tans_pctx_states):
+ *   0xD8-0xE3 TANS_PCTX X4      0xE4-0xEF TANS_PCTX X8
+ *   Each block repeats the 12 PCTX variants in the order of 0x04-0x07,
+ *   0xD0-0xD3, 0xD4-0xD7.
+ *
+ * Static rANS (NETC_ALG_RANS, wide packets):
+ *   0xF0 RANS           0xF3 RANS+LZP+DELTA
+ *   0xF1 RANS+DELTA     0xF4 RANS+DELTA2
+ *   0xF2 RANS+LZP       0xF5 RANS+LZP+DELTA2
+ *
+ *   0xF6-0xFE reserved
  *   0xFF = invalid / legacy sentinel
  */
 
+/* Upper-nibble modifiers of NETC_ALG_TANS_PCTX in the algorithm byte.
+ * X4/X8: payload carries 4 or 8 interleaved ANS states instead of one. */
+#define NETC_PCTX_LZP  0x10u   /* LZP XOR pre-filter applied */
+#define NETC_PCTX_X4   0x20u   /* 4 interleaved states */
+#define NETC_PCTX_X8   0x40u   /* 8 interleaved states */
+
+/* Upper-nibble modifier of NETC_ALG_RANS in the algorithm byte.  rANS
+ * payloads always carry NETC_RANS_STATES interleaved states. */
+#define NETC_RANS_LZP  0x10u   /* LZP XOR pre-filter applied */
+
+/* Upper-nibble modifier of NETC_ALG_LZ77X in the algorithm byte (AD-031). */
+#define NETC_LZ77X_TANS 0x10u  /* token stream tANS-coded, [2B state][bitstream] */
+
+/** Interleaved state count signalled by a PCTX algorithm byte (1, 4 or 8);
+ *  0 when both X4 and X8 are set (corrupt). */
+static NETC_INLINE uint32_t netc_pctx_alg_states(uint8_t algorithm)
+{
+    switch (algorithm & (NETC_PCTX_X4 | NETC_PCTX_X8)) {
+        case 0:            return 1U;
+        case NETC_PCTX_X4: return 4U;
+        case NETC_PCTX_X8: return 8U;
+        default:           return 0U;
+    }
+}
+
+/** Algorithm-byte modifier for an interleaved state count (1, 4 or 8). */
+static NETC_INLINE uint8_t netc_pctx_alg_xn(uint32_t n_states)
+{
+    return (n_states == 8U) ? NETC_PCTX_X8
+         : (n_states == 4U) ? NETC_PCTX_X4 : 0u;
+}
+
 typedef struct {
     uint8_t flags;
     uint8_t algorithm;
@@ -226,8 +649,8 @@ static const netc_pkt_type_entry_t netc_pkt_type_table[256] = {
     /* 0x04-0x07: PCTX variants */
     [0x04] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX },
     [0x05] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX },
-    [0x06] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | 0x10u },
-    [0x07] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | 0x10u },
+    [0x06] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP },
+    [0x07] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP },
 
     /* 0x08-0x0D: MREG variants */
     [0x08] = { NETC_PKT_FLAG_MREG | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS },
@@ -240,6 +663,9 @@ static const netc_pkt_type_entry_t netc_pkt_type_table[256] = {
     /* 0x0E: LZ77X */
     [0x0E] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_LZ77X },
 
+    /* 0x0F: LZ77X, tANS-coded tokens */
+    [0x0F] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_LZ77X | NETC_LZ77X_TANS },
+
     /* 0x10-0x1F: TANS + bucket 0-15 */
     [0x10] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS | (0u<<4) },
     [0x11] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS | (1u<<4) },
@@ -459,16 +885,52 @@ static const netc_pkt_type_entry_t netc_pkt_type_table[256] = {
     /* 0xD0-0xD3: PCTX + BIGRAM variants */
     [0xD0] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX },
     [0xD1] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX },
-    [0xD2] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | 0x10u },
-    [0xD3] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | 0x10u },
+    [0xD2] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP },
+    [0xD3] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP },
 
     /* 0xD4-0xD7: PCTX + DELTA2 (order-2 delta) variants */
     [0xD4] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX },
-    [0xD5] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | 0x10u },
+    [0xD5] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP },
     [0xD6] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX },
-    [0xD7] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | 0x10u },
-
-    /* 0xD8-0xFE: reserved (zero-initialized → flags=0, algorithm=0 → invalid) */
+    [0xD7] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP },
+
+    /* 0xD8-0xE3: PCTX X4 (same order as 0x04-0x07, 0xD0-0xD3, 0xD4-0xD7) */
+    [0xD8] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 },
+    [0xD9] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 },
+    [0xDA] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X4 },
+    [0xDB] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X4 },
+    [0xDC] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 },
+    [0xDD] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 },
+    [0xDE] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X4 },
+    [0xDF] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X4 },
+    [0xE0] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 },
+    [0xE1] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X4 },
+    [0xE2] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 },
+    [0xE3] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X4 },
+
+    /* 0xE4-0xEF: PCTX X8 (same order as 0x04-0x07, 0xD0-0xD3, 0xD4-0xD7) */
+    [0xE4] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X8 },
+    [0xE5] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X8 },
+    [0xE6] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X8 },
+    [0xE7] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X8 },
+    [0xE8] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X8 },
+    [0xE9] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X8 },
+    [0xEA] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X8 },
+    [0xEB] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X8 },
+    [0xEC] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X8 },
+    [0xED] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X8 },
+    [0xEE] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X8 },
+    [0xEF] = { NETC_PKT_FLAG_BIGRAM | NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_LZP | NETC_PCTX_X8 },
+
+    /* 0xF0-0xF5: static rANS */
+    [0xF0] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_RANS },
+    [0xF1] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_RANS },
+    [0xF2] = { NETC_PKT_FLAG_DICT_ID, NETC_ALG_RANS | NETC_RANS_LZP },
+    [0xF3] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_DICT_ID, NETC_ALG_RANS | NETC_RANS_LZP },
+    [0xF4] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_RANS },
+    [0xF5] = { NETC_PKT_FLAG_DELTA | NETC_PKT_FLAG_RLE | NETC_PKT_FLAG_DICT_ID, NETC_ALG_RANS | NETC_RANS_LZP },
+
+    /* 0xF6-0xFE: reserved (zero-initialized → flags=0, algorithm=0 → invalid) */
     /* 0xFF: legacy sentinel */
     [0xFF] = { 0xFF, 0xFF },
 };
@@ -492,8 +954,17 @@ static NETC_INLINE uint8_t netc_compact_type_encode(uint8_t flags, uint8_t algor
 
     /* PCTX */
     if (alg_lo == NETC_ALG_TANS_PCTX) {
-        uint8_t lzp    = (bucket != 0) ? 1u : 0u; /* high nibble signals LZP */
+        uint8_t lzp    = (algorithm & NETC_PCTX_LZP) ? 1u : 0u;
         uint8_t delta2 = (flags & NETC_PKT_FLAG_RLE) ? 1u : 0u; /* RLE reused as order-2 delta signal */
+        uint32_t n_states = netc_pctx_alg_states(algorithm);
+        if (n_states == 0U || (bucket & 0x08u)) return 0xFFu;
+        if (n_states > 1U) {
+            /* 0xD8-0xEF: variant index v in the order of the 1-state types */
+            uint8_t v = delta2 ? (uint8_t)(8u + lzp + bigram * 2u)
+                      : bigram ? (uint8_t)(4u + delta + lzp * 2u)
+                      :          (uint8_t)(delta + lzp * 2u);
+            return (uint8_t)((n_states == 4U ? 0xD8u : 0xE4u) + v);
+        }
         if (delta2) {
             /* 0xD4-0xD7: order-2 delta PCTX variants */
             return (uint8_t)(0xD4u + lzp + bigram * 2u);
@@ -502,8 +973,17 @@ static NETC_INLINE uint8_t netc_compact_type_encode(uint8_t flags, uint8_t algor
         return (uint8_t)(0x04u + delta + lzp * 2u);
     }
 
+    /* Static rANS (no bigram variant) */
+    if (alg_lo == NETC_ALG_RANS) {
+        uint8_t lzp    = (algorithm & NETC_RANS_LZP) ? 1u : 0u;
+        uint8_t delta2 = (flags & NETC_PKT_FLAG_RLE) ? 1u : 0u;
+        if (bigram || (algorithm & ~(uint8_t)(0x0Fu | NETC_RANS_LZP))) return 0xFFu;
+        if (delta2) return (uint8_t)(0xF4u + lzp);
+        return (uint8_t)(0xF0u + delta + lzp * 2u);
+    }
+
     /* LZ77X */
-    if (alg_lo == NETC_ALG_LZ77X) return 0x0Eu;
+    if (alg_lo == NETC_ALG_LZ77X) return (algorithm & NETC_LZ77X_TANS) ? 0x0Fu : 0x0Eu;
 
     /* MREG */
     if (flags & NETC_PKT_FLAG_MREG) {
@@ -605,16 +1085,64 @@ static NETC_INLINE size_t netc_hdr_emit(void *dst,
 }
 
 /* Get the tANS tables to use (adaptive or dict static).
- * When adaptive mode is active and adapt_tables is populated, returns the
- * mutable adaptive tables. Otherwise returns the frozen dict tables. */
+ * Adaptive contexts share the frozen dict tables until their first rebuild
+ * populates adapt_tables. */
 static NETC_INLINE const netc_tans_table_t *netc_get_tables(const netc_ctx_t *ctx) {
-    return (ctx->adapt_tables != NULL) ? ctx->adapt_tables : ctx->dict->tables;
+    return ctx->adapt_tables_live ? ctx->adapt_tables : ctx->dict->tables;
+}
+
+/* Get the bigram table set to use (adaptive or dict static). */
+static NETC_INLINE const netc_bigram_set_t *netc_get_bigram(const netc_ctx_t *ctx) {
+    return (ctx->adapt_bg != NULL) ? &ctx->adapt_bg->set : &ctx->dict->bigram_set;
+}
+
+/* The frozen dict LZP table; ent is NULL without a dict or LZP model. */
+static NETC_INLINE netc_lzp_table_t netc_dict_lzp(const netc_dict_t *dict) {
+    netc_lzp_table_t t = { NULL, NULL };
+    if (dict != NULL) t = dict->lzp_table;
+    return t;
+}
+
+/* Return the adaptive LZP table if available, otherwise the frozen dict LZP
+ * table.  ent is NULL when there is neither. */
+static NETC_INLINE netc_lzp_table_t netc_get_lzp_table(const netc_ctx_t *ctx) {
+    netc_lzp_table_t t = { NULL, ctx->adapt_lzp };
+    return (ctx->adapt_lzp != NULL) ? t : netc_dict_lzp(ctx->dict);
+}
+
+/* Sparse adaptive changes to layer over netc_get_lzp_table(), or NULL.  A
+ * reserved but still empty overlay is only needed for a dual-order table,
+ * whose dict confidences it rescales (netc_lzp_clone_conf). */
+static NETC_INLINE const netc_lzp_overlay_t *netc_get_lzp_overlay(const netc_ctx_t *ctx) {
+    const netc_lzp_overlay_t *ovl = &ctx->adapt_lzp_ovl;
+    if (ovl->count != 0) return ovl;
+    return (ovl->dirty != NULL && netc_lzp_order2(ctx->dict)) ? ovl : NULL;
+}
+
+/* LZP XOR filter through the context's SIMD kernel.  Sparse adaptive
+ * changes need the overlay lookup, which stays scalar. */
+static NETC_INLINE void netc_lzp_filter(const netc_simd_ops_t    *ops,
+                                        const uint8_t            *src,
+                                        size_t                    n,
+                                        const netc_lzp_table_t   *table,
+                                        const netc_lzp_overlay_t *ovl,
+                                        int                       order2,
+                                        uint8_t                  *dst) {
+    if (ovl != NULL) netc_lzp_xor_filter(src, n, table, ovl, order2, dst);
+    else             ops->lzp_filter(table, order2, src, dst, n);
 }
 
-/* Return the adaptive LZP table if available, otherwise the frozen dict LZP table. */
-static NETC_INLINE const netc_lzp_entry_t *netc_get_lzp_table(const netc_ctx_t *ctx) {
-    if (ctx->adapt_lzp != NULL) return ctx->adapt_lzp;
-    return (ctx->dict != NULL) ? ctx->dict->lzp_table : NULL;
+/* Inverse of netc_lzp_filter, in place.  The previous packet, when at
+ * least n bytes, steers the unfilter's table prefetches. */
+static NETC_INLINE void netc_lzp_unfilter(const netc_ctx_t        *ctx,
+                                          uint8_t                 *buf,
+                                          size_t                   n,
+                                          const netc_lzp_table_t  *table,
+                                          const netc_lzp_overlay_t *ovl,
+                                          int                      order2) {
+    const uint8_t *hint = (ctx->prev_pkt_size >= n) ? ctx->prev_pkt : NULL;
+    if (ovl != NULL) netc_lzp_xor_unfilter(buf, n, table, ovl, order2, buf);
+    else             ctx->simd_ops.lzp_unfilter(table, order2, buf, hint, buf, n);
 }
 
 #endif /* NETC_INTERNAL_H */
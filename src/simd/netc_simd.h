@@ -8,6 +8,8 @@
  *   - A dispatch table (netc_simd_ops_t) that selects the best implementation
  *     at context creation time — zero overhead in the hot path
  *   - Implementations: generic (C11), SSE4.2, AVX2, NEON
+ *   - LZP XOR filter kernels: SSE4.2 hashes 4 positions per step, AVX2
+ *     hashes 8 and gathers their table entries (NEON uses the generic loop)
  *
  * All implementations produce byte-for-byte identical output.
  * All loads/stores are unaligned-safe (loadu / storeu variants).
@@ -24,6 +26,8 @@
 #define NETC_SIMD_H
 
 #include "../util/netc_platform.h"
+#include "../algo/netc_delta.h"
+#include "../algo/netc_lzp.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -42,23 +46,70 @@
  * ========================================================================= */
 
 /**
- * delta_encode_bulk: encode len bytes of residuals from prev/curr into out.
- * Equivalent to netc_delta_encode but may use wider vector ops.
+ * delta_encode_bulk: encode len bytes of residuals from prev/curr into out
+ * with the per-offset operators of map (NULL = netc_delta_map_default).
+ * Equivalent to netc_delta_encode_mapped but may use wider vector ops.
  * Handles any len (scalar tail for unaligned remainder).
  */
-typedef void (*netc_delta_encode_fn)(const uint8_t *prev,
-                                     const uint8_t *curr,
-                                     uint8_t       *out,
-                                     size_t         len);
+typedef void (*netc_delta_encode_fn)(const netc_delta_map_t *map,
+                                     const uint8_t          *prev,
+                                     const uint8_t          *curr,
+                                     uint8_t                *out,
+                                     size_t                  len);
 
 /**
  * delta_decode_bulk: reconstruct curr bytes from prev + residuals.
  * in-place: out == residual is allowed.
  */
-typedef void (*netc_delta_decode_fn)(const uint8_t *prev,
-                                     const uint8_t *residual,
-                                     uint8_t       *out,
-                                     size_t         len);
+typedef void (*netc_delta_decode_fn)(const netc_delta_map_t *map,
+                                     const uint8_t          *prev,
+                                     const uint8_t          *residual,
+                                     uint8_t                *out,
+                                     size_t                  len);
+
+/**
+ * delta_planes_split / delta_planes_merge: byte-transpose the planes runs
+ * of a len-byte residual in place (AD-021), and undo it. A planes list with
+ * count == 0 leaves buf untouched.
+ */
+typedef void (*netc_delta_planes_fn)(const netc_delta_planes_t *planes,
+                                     uint8_t                   *buf,
+                                     size_t                     len);
+
+/**
+ * match_count: number of positions i < len where a[i] == b[i]. Scores the
+ * candidate references of NETC_CFG_FLAG_DELTA_REFS (AD-022).
+ */
+typedef uint32_t (*netc_match_count_fn)(const uint8_t *a,
+                                        const uint8_t *b,
+                                        size_t         len);
+
+/**
+ * lzp_filter: dst[i] = src[i] ^ the LZP prediction for byte i, from a
+ * packed or dense table (netc_lzp_xor_filter without an overlay; order2 as
+ * there).  The
+ * contexts are all source bytes, so vector levels hash several positions
+ * per step.  dst must not alias src.
+ */
+typedef void (*netc_lzp_filter_fn)(const netc_lzp_table_t *table,
+                                   int                     order2,
+                                   const uint8_t          *src,
+                                   uint8_t                *dst,
+                                   size_t                  len);
+
+/**
+ * lzp_unfilter: inverse of lzp_filter; dst may alias src.  Each context is
+ * the byte just decoded, so the loop stays serial at every level.  hint,
+ * when not NULL, holds len bytes expected to resemble the output (the
+ * previous packet of the stream): the slots its bytes hash to are
+ * prefetched a few positions ahead.  A wrong hint only wastes prefetches.
+ */
+typedef void (*netc_lzp_unfilter_fn)(const netc_lzp_table_t *table,
+                                     int                     order2,
+                                     const uint8_t          *src,
+                                     const uint8_t          *hint,
+                                     uint8_t                *dst,
+                                     size_t                  len);
 
 /**
  * freq_count: accumulate byte frequency histogram.
@@ -76,12 +127,46 @@ typedef uint32_t (*netc_crc32_update_fn)(uint32_t crc,
                                           const uint8_t *data,
                                           size_t         len);
 
+/**
+ * tans_decode_x8: decode whole 8-symbol groups of an 8-state interleaved
+ * tANS stream (PCTX X8) that all use the same 12-bit decode table.
+ *
+ * decode is the table's netc_tans_decode_entry_t[4096] viewed as words:
+ * symbol | nb_bits << 8 | next_state_base << 16.  *bit_pos is the number of
+ * unread bits at the start of buf; lane k of a group takes its bits directly
+ * below those of lanes 0..k-1, exactly as the scalar reader would.  X holds
+ * the 8 states in [4096, 8192) and is updated in place.
+ *
+ * Decodes up to n_groups groups into dst[0 .. 8*n_groups) and returns how
+ * many were decoded.  Stops early once fewer than NETC_TANS_X8_KERNEL_MIN_BITS
+ * bits remain, so every load stays inside buf; the caller finishes the tail
+ * with the scalar reader.
+ *
+ * NULL in levels without a vector kernel and under NETC_SIMD_LEVEL_AUTO
+ * (callers use the scalar decoder); set when AVX2 is requested explicitly.
+ */
+typedef size_t (*netc_tans_decode_x8_fn)(const uint32_t *decode,
+                                         const uint8_t  *buf,
+                                         size_t         *bit_pos,
+                                         uint32_t       *X,
+                                         uint8_t        *dst,
+                                         size_t          n_groups);
+
+/* One group reads at most 8 * 12 bits plus a 32-bit window below them. */
+#define NETC_TANS_X8_KERNEL_MIN_BITS 128U
+
 typedef struct {
-    netc_delta_encode_fn  delta_encode;
-    netc_delta_decode_fn  delta_decode;
-    netc_freq_count_fn    freq_count;
-    netc_crc32_update_fn  crc32_update;
-    uint8_t               level;        /* actual level selected */
+    netc_delta_encode_fn   delta_encode;
+    netc_delta_decode_fn   delta_decode;
+    netc_delta_planes_fn   delta_planes_split;
+    netc_delta_planes_fn   delta_planes_merge;
+    netc_match_count_fn    match_count;
+    netc_lzp_filter_fn     lzp_filter;
+    netc_lzp_unfilter_fn   lzp_unfilter;
+    netc_freq_count_fn     freq_count;
+    netc_crc32_update_fn   crc32_update;
+    netc_tans_decode_x8_fn tans_decode_x8; /* NULL = scalar interleaved decode */
+    uint8_t                level;          /* actual level selected */
 } netc_simd_ops_t;
 
 /* =========================================================================
@@ -124,10 +209,20 @@ void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level);
  * Generic (C11) implementations — always available
  * ========================================================================= */
 
-void     netc_delta_encode_generic(const uint8_t *prev, const uint8_t *curr,
-                                    uint8_t *out, size_t len);
-void     netc_delta_decode_generic(const uint8_t *prev, const uint8_t *residual,
-                                    uint8_t *out, size_t len);
+void     netc_delta_encode_generic(const netc_delta_map_t *map,
+                                   const uint8_t *prev, const uint8_t *curr,
+                                   uint8_t *out, size_t len);
+void     netc_delta_decode_generic(const netc_delta_map_t *map,
+                                   const uint8_t *prev, const uint8_t *residual,
+                                   uint8_t *out, size_t len);
+void     netc_delta_planes_split_generic(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+void     netc_delta_planes_merge_generic(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+uint32_t netc_match_count_generic(const uint8_t *a, const uint8_t *b, size_t len);
+void     netc_lzp_filter_generic  (const netc_lzp_table_t *table, int order2,
+                                   const uint8_t *src, uint8_t *dst, size_t len);
+void     netc_lzp_unfilter_generic(const netc_lzp_table_t *table, int order2,
+                                   const uint8_t *src, const uint8_t *hint,
+                                   uint8_t *dst, size_t len);
 void     netc_freq_count_generic  (const uint8_t *data, size_t len, uint32_t *freq);
 uint32_t netc_crc32_update_generic(uint32_t crc, const uint8_t *data, size_t len);
 
@@ -136,10 +231,17 @@ uint32_t netc_crc32_update_generic(uint32_t crc, const uint8_t *data, size_t len
  * ========================================================================= */
 #if defined(NETC_SIMD_SSE42) || defined(NETC_SIMD_AVX2) || defined(_MSC_VER)
 /* On MSVC x64, SSE4.2 intrinsics are always available */
-void     netc_delta_encode_sse42(const uint8_t *prev, const uint8_t *curr,
-                                  uint8_t *out, size_t len);
-void     netc_delta_decode_sse42(const uint8_t *prev, const uint8_t *residual,
-                                  uint8_t *out, size_t len);
+void     netc_delta_encode_sse42(const netc_delta_map_t *map,
+                                 const uint8_t *prev, const uint8_t *curr,
+                                 uint8_t *out, size_t len);
+void     netc_delta_decode_sse42(const netc_delta_map_t *map,
+                                 const uint8_t *prev, const uint8_t *residual,
+                                 uint8_t *out, size_t len);
+void     netc_delta_planes_split_sse42(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+void     netc_delta_planes_merge_sse42(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+uint32_t netc_match_count_sse42(const uint8_t *a, const uint8_t *b, size_t len);
+void     netc_lzp_filter_sse42  (const netc_lzp_table_t *table, int order2,
+                                 const uint8_t *src, uint8_t *dst, size_t len);
 void     netc_freq_count_sse42  (const uint8_t *data, size_t len, uint32_t *freq);
 uint32_t netc_crc32_update_sse42(uint32_t crc, const uint8_t *data, size_t len);
 #endif
@@ -149,21 +251,36 @@ uint32_t netc_crc32_update_sse42(uint32_t crc, const uint8_t *data, size_t len);
  * ========================================================================= */
 #if defined(NETC_SIMD_AVX2) || defined(_MSC_VER)
 /* On MSVC x64, AVX2 intrinsics are available when CPU supports them */
-void netc_delta_encode_avx2(const uint8_t *prev, const uint8_t *curr,
-                              uint8_t *out, size_t len);
-void netc_delta_decode_avx2(const uint8_t *prev, const uint8_t *residual,
-                              uint8_t *out, size_t len);
+void netc_delta_encode_avx2(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *curr,
+                            uint8_t *out, size_t len);
+void netc_delta_decode_avx2(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *residual,
+                            uint8_t *out, size_t len);
+void netc_delta_planes_split_avx2(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+void netc_delta_planes_merge_avx2(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+uint32_t netc_match_count_avx2(const uint8_t *a, const uint8_t *b, size_t len);
+void netc_lzp_filter_avx2  (const netc_lzp_table_t *table, int order2,
+                            const uint8_t *src, uint8_t *dst, size_t len);
 void netc_freq_count_avx2  (const uint8_t *data, size_t len, uint32_t *freq);
+size_t netc_tans_decode_x8_avx2(const uint32_t *decode, const uint8_t *buf,
+                                size_t *bit_pos, uint32_t *X, uint8_t *dst,
+                                size_t n_groups);
 #endif
 
 /* =========================================================================
  * NEON implementations
  * ========================================================================= */
 #if defined(NETC_SIMD_NEON) || defined(__ARM_NEON)
-void     netc_delta_encode_neon(const uint8_t *prev, const uint8_t *curr,
-                                 uint8_t *out, size_t len);
-void     netc_delta_decode_neon(const uint8_t *prev, const uint8_t *residual,
-                                 uint8_t *out, size_t len);
+void     netc_delta_encode_neon(const netc_delta_map_t *map,
+                                const uint8_t *prev, const uint8_t *curr,
+                                uint8_t *out, size_t len);
+void     netc_delta_decode_neon(const netc_delta_map_t *map,
+                                const uint8_t *prev, const uint8_t *residual,
+                                uint8_t *out, size_t len);
+void     netc_delta_planes_split_neon(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+void     netc_delta_planes_merge_neon(const netc_delta_planes_t *pl, uint8_t *buf, size_t len);
+uint32_t netc_match_count_neon(const uint8_t *a, const uint8_t *b, size_t len);
 void     netc_freq_count_neon  (const uint8_t *data, size_t len, uint32_t *freq);
 uint32_t netc_crc32_update_neon(uint32_t crc, const uint8_t *data, size_t len);
 #endif
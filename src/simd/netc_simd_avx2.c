@@ -6,13 +6,21 @@
  *   _mm256_xor_si256 — 32 bytes of XOR per cycle
  *   _mm256_add_epi8  — 32 bytes of wrapping byte addition per cycle
  *
- * Delta throughput: 32 bytes/cycle vs 16 bytes/cycle for SSE4.2.
- * For a 512-byte game state packet this is ~16 cycles vs ~32 cycles
- * for the BODY+TAIL regions.
+ * Delta: 32 bytes per step with the map's operators selected per byte by
+ * _mm256_blendv_epi8 (AD-020), vs 16 bytes per step for SSE4.2. Byte planes
+ * (AD-021) transpose 8 u32 or 16 u16 lanes per step.
  *
  * For CRC32 we fall back to the SSE4.2 hardware CRC32C — AVX2 does not
  * add new CRC instructions.
  *
+ * The X8 interleaved tANS decoder fetches the 8 decode entries of a group
+ * with one _mm256_i32gather_epi32 and extracts the 8 lanes' bit fields from
+ * a single 16-byte bitstream window with _mm256_shuffle_epi8.
+ *
+ * The LZP XOR filter hashes 8 positions per step and gathers their table
+ * entries with _mm256_i32gather_epi32; for a packed table it gathers the
+ * occupancy blocks first and ranks each slot with a pshufb popcount.
+ *
  * Unaligned loads/stores (_mm256_loadu_si256 / _mm256_storeu_si256) are
  * used throughout to handle buffers at any alignment.
  */
@@ -20,6 +28,7 @@
 #include "netc_simd.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 #if defined(_MSC_VER)
 #  include <intrin.h>
@@ -28,13 +37,6 @@
 #  include <immintrin.h>
 #endif
 
-/* =========================================================================
- * Field-class boundaries (same as netc_delta.h and sse42)
- * ========================================================================= */
-#define HDR_END  16u
-#define SUB_END  64u
-#define BODY_END 256u
-
 /* =========================================================================
  * AVX2 helper: check if CPU actually supports AVX2 at runtime.
  * We use _xgetbv and CPUID — same checks as in netc_simd_generic.c.
@@ -44,147 +46,339 @@
 
 #if defined(_MSC_VER) || defined(__AVX2__)
 
-void netc_delta_encode_avx2(const uint8_t *prev, const uint8_t *curr,
-                              uint8_t *out, size_t len)
+/* =========================================================================
+ * AVX2 delta encode / decode
+ *
+ * Same scheme as the SSE4.2 kernels on 32-byte chunks: every map operator
+ * is computed and the result blended per byte on op == k masks. 32 divides
+ * NETC_DELTA_MAP_LEN, so chunks never straddle the end of the map and the
+ * 16/32-bit lanes stay aligned. One 16-byte step and the scalar reference
+ * finish the packet.
+ * ========================================================================= */
+
+static NETC_INLINE __m256i avx2_delta_pick(__m256i ops, __m256i x, __m256i s8,
+                                           __m256i none, __m256i s16, __m256i s32,
+                                           __m256i f32)
 {
+    __m256i r = x;
+    r = _mm256_blendv_epi8(r, s8,   _mm256_cmpeq_epi8(ops, _mm256_set1_epi8((char)NETC_DELTA_OP_SUB)));
+    r = _mm256_blendv_epi8(r, none, _mm256_cmpeq_epi8(ops, _mm256_set1_epi8((char)NETC_DELTA_OP_NONE)));
+    r = _mm256_blendv_epi8(r, s16,  _mm256_cmpeq_epi8(ops, _mm256_set1_epi8((char)NETC_DELTA_OP_SUB16)));
+    r = _mm256_blendv_epi8(r, s32,  _mm256_cmpeq_epi8(ops, _mm256_set1_epi8((char)NETC_DELTA_OP_SUB32)));
+    r = _mm256_blendv_epi8(r, f32,  _mm256_cmpeq_epi8(ops, _mm256_set1_epi8((char)NETC_DELTA_OP_FLT32)));
+    return r;
+}
+
+/* The same selection on one 16-byte step */
+static NETC_INLINE __m128i avx2_delta_pick128(__m128i ops, __m128i x, __m128i s8,
+                                              __m128i none, __m128i s16, __m128i s32,
+                                              __m128i f32)
+{
+    __m128i r = x;
+    r = _mm_blendv_epi8(r, s8,   _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_SUB)));
+    r = _mm_blendv_epi8(r, none, _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_NONE)));
+    r = _mm_blendv_epi8(r, s16,  _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_SUB16)));
+    r = _mm_blendv_epi8(r, s32,  _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_SUB32)));
+    r = _mm_blendv_epi8(r, f32,  _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_FLT32)));
+    return r;
+}
+
+/* FLT32 residual lanes: rotate the XOR left by one bit, and back */
+static NETC_INLINE __m256i avx2_rotl1(__m256i v) {
+    return _mm256_or_si256(_mm256_slli_epi32(v, 1), _mm256_srli_epi32(v, 31));
+}
+static NETC_INLINE __m256i avx2_rotr1(__m256i v) {
+    return _mm256_or_si256(_mm256_srli_epi32(v, 1), _mm256_slli_epi32(v, 31));
+}
+static NETC_INLINE __m128i avx2_rotl1_128(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi32(v, 1), _mm_srli_epi32(v, 31));
+}
+static NETC_INLINE __m128i avx2_rotr1_128(__m128i v) {
+    return _mm_or_si128(_mm_srli_epi32(v, 1), _mm_slli_epi32(v, 31));
+}
+
+/* Operators of the 32 bytes at offset i (i a multiple of 32) */
+static NETC_INLINE __m256i avx2_delta_ops(const netc_delta_map_t *map, size_t i) {
+    return (i < NETC_DELTA_MAP_LEN)
+         ? _mm256_loadu_si256((const __m256i *)(map->op + i))
+         : _mm256_set1_epi8((char)map->tail);
+}
+
+void netc_delta_encode_avx2(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *curr,
+                            uint8_t *out, size_t len)
+{
+    if (map == NULL) map = &netc_delta_map_default;
     size_t i = 0;
 
-    /* HEADER [0, 16): XOR — scalar (region < 32 bytes, vector not worth it) */
-    {
-        size_t end = len < HDR_END ? len : HDR_END;
-        while (i < end) {
-            out[i] = curr[i] ^ prev[i];
-            i++;
-        }
+    for (; i + 32u <= len; i += 32u) {
+        __m256i p   = _mm256_loadu_si256((const __m256i *)(prev + i));
+        __m256i c   = _mm256_loadu_si256((const __m256i *)(curr + i));
+        __m256i x   = _mm256_xor_si256(c, p);
+        __m256i r   = avx2_delta_pick(avx2_delta_ops(map, i),
+                                      x, _mm256_sub_epi8(c, p), c,
+                                      _mm256_sub_epi16(c, p), _mm256_sub_epi32(c, p),
+                                      avx2_rotl1(x));
+        _mm256_storeu_si256((__m256i *)(out + i), r);
+    }
+    if (i + 16u <= len) {
+        __m128i p   = _mm_loadu_si128((const __m128i *)(prev + i));
+        __m128i c   = _mm_loadu_si128((const __m128i *)(curr + i));
+        __m128i x   = _mm_xor_si128(c, p);
+        __m128i r   = avx2_delta_pick128(_mm256_castsi256_si128(avx2_delta_ops(map, i)),
+                                         x, _mm_sub_epi8(c, p), c,
+                                         _mm_sub_epi16(c, p), _mm_sub_epi32(c, p),
+                                         avx2_rotl1_128(x));
+        _mm_storeu_si128((__m128i *)(out + i), r);
+        i += 16u;
     }
 
-    /* SUBHEADER [16, 64): SUB — up to 3 × 16-byte SSE2 ops or scalar */
-    {
-        size_t end = len < SUB_END ? len : SUB_END;
-        /* 48-byte region — use SSE2 (128-bit), AVX2 would straddle boundary */
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
-            _mm_storeu_si128((__m128i *)(out + i), _mm_sub_epi8(c, p));
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-            i++;
-        }
+    netc_delta_encode_mapped(map, prev, curr, out, i, len);
+}
+
+void netc_delta_decode_avx2(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *residual,
+                            uint8_t *out, size_t len)
+{
+    if (map == NULL) map = &netc_delta_map_default;
+    size_t i = 0;
+
+    for (; i + 32u <= len; i += 32u) {
+        __m256i p   = _mm256_loadu_si256((const __m256i *)(prev + i));
+        __m256i r   = _mm256_loadu_si256((const __m256i *)(residual + i));
+        __m256i c   = avx2_delta_pick(avx2_delta_ops(map, i),
+                                      _mm256_xor_si256(r, p), _mm256_add_epi8(r, p), r,
+                                      _mm256_add_epi16(r, p), _mm256_add_epi32(r, p),
+                                      _mm256_xor_si256(avx2_rotr1(r), p));
+        _mm256_storeu_si256((__m256i *)(out + i), c);
+    }
+    if (i + 16u <= len) {
+        __m128i p   = _mm_loadu_si128((const __m128i *)(prev + i));
+        __m128i r   = _mm_loadu_si128((const __m128i *)(residual + i));
+        __m128i c   = avx2_delta_pick128(_mm256_castsi256_si128(avx2_delta_ops(map, i)),
+                                         _mm_xor_si128(r, p), _mm_add_epi8(r, p), r,
+                                         _mm_add_epi16(r, p), _mm_add_epi32(r, p),
+                                         _mm_xor_si128(avx2_rotr1_128(r), p));
+        _mm_storeu_si128((__m128i *)(out + i), c);
+        i += 16u;
     }
 
-    /* BODY [64, 256): XOR — up to 6 × 32-byte AVX2 ops */
-    {
-        size_t end = len < BODY_END ? len : BODY_END;
-        while (i + 32u <= end) {
-            __m256i p = _mm256_loadu_si256((const __m256i *)(prev + i));
-            __m256i c = _mm256_loadu_si256((const __m256i *)(curr + i));
-            _mm256_storeu_si256((__m256i *)(out + i), _mm256_xor_si256(c, p));
-            i += 32u;
-        }
-        /* 16-byte tail within BODY */
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
-            _mm_storeu_si128((__m128i *)(out + i), _mm_xor_si128(c, p));
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = curr[i] ^ prev[i];
-            i++;
+    netc_delta_decode_mapped(map, prev, residual, out, i, len);
+}
+
+/* =========================================================================
+ * AVX2 byte planes
+ *
+ * u32 runs: _mm256_shuffle_epi8 transposes each half's four lanes into four
+ * 4-byte planes, and _mm256_permutevar8x32_epi32 joins the halves so every
+ * plane is one 8-byte store (merge runs the same two steps backwards).
+ * u16 runs: the in-half shuffle splits low and high bytes and
+ * _mm256_permute4x64_epi64 makes each plane one 16-byte store; merge
+ * interleaves 16 lanes with _mm_unpack{lo,hi}_epi8. The scalar reference
+ * finishes the last lanes of a run.
+ * ========================================================================= */
+
+void netc_delta_planes_split_avx2(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    const __m256i t4 = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i t2 = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    const __m256i join4 = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        size_t   w   = pl->width[r];
+        uint8_t *run = buf + pl->start[r];
+        size_t   j   = 0;
+        memcpy(tmp, run, n * w);
+        if (w == 4U) {
+            for (; j + 8U <= n; j += 8U) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)(tmp + 4U * j));
+                v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, t4), join4);
+                __m128i lo = _mm256_castsi256_si128(v);
+                __m128i hi = _mm256_extracti128_si256(v, 1);
+                _mm_storel_epi64((__m128i *)(run + j),          lo);
+                _mm_storel_epi64((__m128i *)(run + n + j),      _mm_srli_si128(lo, 8));
+                _mm_storel_epi64((__m128i *)(run + 2U * n + j), hi);
+                _mm_storel_epi64((__m128i *)(run + 3U * n + j), _mm_srli_si128(hi, 8));
+            }
+        } else {
+            for (; j + 16U <= n; j += 16U) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)(tmp + 2U * j));
+                v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, t2), 0xD8);
+                _mm_storeu_si128((__m128i *)(run + j),     _mm256_castsi256_si128(v));
+                _mm_storeu_si128((__m128i *)(run + n + j), _mm256_extracti128_si256(v, 1));
+            }
         }
+        netc_delta_planes_split(run, tmp, w, n, j);
     }
+}
 
-    /* TAIL [256, len): SUB — 32 bytes/iter */
-    {
-        while (i + 32u <= len) {
-            __m256i p = _mm256_loadu_si256((const __m256i *)(prev + i));
-            __m256i c = _mm256_loadu_si256((const __m256i *)(curr + i));
-            _mm256_storeu_si256((__m256i *)(out + i), _mm256_sub_epi8(c, p));
-            i += 32u;
-        }
-        while (i + 16u <= len) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
-            _mm_storeu_si128((__m128i *)(out + i), _mm_sub_epi8(c, p));
-            i += 16u;
-        }
-        while (i < len) {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-            i++;
+void netc_delta_planes_merge_avx2(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    const __m256i t4 = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i part4 = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        size_t   w   = pl->width[r];
+        uint8_t *run = buf + pl->start[r];
+        size_t   j   = 0;
+        memcpy(tmp, run, n * w);
+        if (w == 4U) {
+            for (; j + 8U <= n; j += 8U) {
+                __m128i lo = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(tmp + j)),
+                                                _mm_loadl_epi64((const __m128i *)(tmp + n + j)));
+                __m128i hi = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(tmp + 2U * n + j)),
+                                                _mm_loadl_epi64((const __m128i *)(tmp + 3U * n + j)));
+                __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                v = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, part4), t4);
+                _mm256_storeu_si256((__m256i *)(run + 4U * j), v);
+            }
+        } else {
+            for (; j + 16U <= n; j += 16U) {
+                __m128i lo = _mm_loadu_si128((const __m128i *)(tmp + j));
+                __m128i hi = _mm_loadu_si128((const __m128i *)(tmp + n + j));
+                _mm_storeu_si128((__m128i *)(run + 2U * j),       _mm_unpacklo_epi8(lo, hi));
+                _mm_storeu_si128((__m128i *)(run + 2U * j + 16U), _mm_unpackhi_epi8(lo, hi));
+            }
         }
+        netc_delta_planes_merge(run, tmp, w, n, j);
     }
 }
 
-void netc_delta_decode_avx2(const uint8_t *prev, const uint8_t *residual,
-                              uint8_t *out, size_t len)
+/* =========================================================================
+ * AVX2 equal-byte count — 32-byte form of netc_match_count_sse42
+ * ========================================================================= */
+
+uint32_t netc_match_count_avx2(const uint8_t *a, const uint8_t *b, size_t len)
 {
-    size_t i = 0;
+    uint64_t n = 0;
+    size_t   i = 0;
 
-    /* HEADER [0, 16): XOR — scalar */
-    {
-        size_t end = len < HDR_END ? len : HDR_END;
-        while (i < end) {
-            out[i] = residual[i] ^ prev[i];
-            i++;
+    while (i + 32u <= len) {
+        __m256i acc = _mm256_setzero_si256();
+        size_t  end = len - ((len - i) % 32u);
+        if (end - i > 255u * 32u) end = i + 255u * 32u;
+        for (; i < end; i += 32u) {
+            __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(va, vb));
         }
+        __m256i sad = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+        n += (uint64_t)_mm256_extract_epi64(sad, 0)
+           + (uint64_t)_mm256_extract_epi64(sad, 1)
+           + (uint64_t)_mm256_extract_epi64(sad, 2)
+           + (uint64_t)_mm256_extract_epi64(sad, 3);
     }
-
-    /* SUBHEADER [16, 64): ADD */
-    {
-        size_t end = len < SUB_END ? len : SUB_END;
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i r = _mm_loadu_si128((const __m128i *)(residual + i));
-            _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi8(r, p));
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
-            i++;
-        }
+    for (; i < len; i++) {
+        n += (uint64_t)(a[i] == b[i]);
     }
+    return (uint32_t)n;
+}
 
-    /* BODY [64, 256): XOR */
-    {
-        size_t end = len < BODY_END ? len : BODY_END;
-        while (i + 32u <= end) {
-            __m256i p = _mm256_loadu_si256((const __m256i *)(prev + i));
-            __m256i r = _mm256_loadu_si256((const __m256i *)(residual + i));
-            _mm256_storeu_si256((__m256i *)(out + i), _mm256_xor_si256(r, p));
-            i += 32u;
-        }
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i r = _mm_loadu_si128((const __m128i *)(residual + i));
-            _mm_storeu_si128((__m128i *)(out + i), _mm_xor_si128(r, p));
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = residual[i] ^ prev[i];
-            i++;
-        }
+/* =========================================================================
+ * AVX2 LZP XOR filter
+ *
+ * 8 positions per step: the FNV context hashes with _mm256_mullo_epi32,
+ * then one _mm256_i32gather_epi32 per context order.  A dword gathered at
+ * entry h holds value | valid << 8 in its low half; the last slot of a
+ * dense table is read from h - 1 and shifted down, so no lane reads past
+ * the table.  A packed table takes two gathers of the blocks (bits and
+ * base, same 8 bytes) before the entry gather; the entry index of an empty
+ * slot is still inside ent[] (NETC_LZP_PACK_PAD) and its lane is zeroed.
+ * The order-2
+ * entry wins unless the order-1 one is strictly more confident, as in
+ * netc_lzp_pick.  Positions 0 and 1 and the last < 8 bytes are scalar.
+ * ========================================================================= */
+
+static NETC_INLINE __m256i avx2_fnv(__m256i h, __m256i x)
+{
+    return _mm256_mullo_epi32(_mm256_xor_si256(h, x), _mm256_set1_epi32(16777619));
+}
+
+/* Set bits per 32-bit lane: nibble lookup, then byte sums. */
+static NETC_INLINE __m256i avx2_popcount32(__m256i x)
+{
+    const __m256i lut  = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    __m256i c8 = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lut, _mm256_and_si256(x, low4)),
+        _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), low4)));
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(c8, _mm256_set1_epi8(1)),
+                             _mm256_set1_epi16(1));
+}
+
+static NETC_INLINE __m256i avx2_lzp_gather(const netc_lzp_table_t *table, __m256i h)
+{
+    const int *ent = (const int *)(const void *)table->ent;
+    if (table->blk == NULL) {
+        __m256i at = _mm256_min_epu32(h, _mm256_set1_epi32((int)(NETC_LZP_HT_MASK - 1U)));
+        __m256i g  = _mm256_i32gather_epi32(ent, at, 2);
+        return _mm256_srlv_epi32(g, _mm256_slli_epi32(_mm256_sub_epi32(h, at), 4));
     }
+    const int *blk   = (const int *)(const void *)table->blk;
+    __m256i    bi    = _mm256_srli_epi32(h, (int)NETC_LZP_BLK_SHIFT);
+    __m256i    bits  = _mm256_i32gather_epi32(blk, bi, 8);
+    __m256i    base  = _mm256_i32gather_epi32(blk + 1, bi, 8);
+    __m256i    bit   = _mm256_sllv_epi32(_mm256_set1_epi32(1),
+                                         _mm256_and_si256(h, _mm256_set1_epi32(31)));
+    __m256i    below = _mm256_and_si256(bits, _mm256_sub_epi32(bit, _mm256_set1_epi32(1)));
+    __m256i    idx   = _mm256_add_epi32(base, avx2_popcount32(below));
+    __m256i    g     = _mm256_i32gather_epi32(ent, idx, 2);
+    return _mm256_and_si256(g, _mm256_cmpeq_epi32(_mm256_and_si256(bits, bit), bit));
+}
 
-    /* TAIL [256, len): ADD */
-    {
-        while (i + 32u <= len) {
-            __m256i p = _mm256_loadu_si256((const __m256i *)(prev + i));
-            __m256i r = _mm256_loadu_si256((const __m256i *)(residual + i));
-            _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi8(r, p));
-            i += 32u;
-        }
-        while (i + 16u <= len) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i r = _mm_loadu_si128((const __m128i *)(residual + i));
-            _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi8(r, p));
-            i += 16u;
-        }
-        while (i < len) {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
-            i++;
+void netc_lzp_filter_avx2(const netc_lzp_table_t *table, int order2,
+                          const uint8_t *src, uint8_t *dst, size_t len)
+{
+    const __m256i mask     = _mm256_set1_epi32((int)NETC_LZP_HT_MASK);
+    const __m256i lo16     = _mm256_set1_epi32(0xFFFF);
+    const __m256i lo_byte  = _mm256_set1_epi32(0xFF);
+    const __m256i sym_shuf = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = (len < 2U) ? len : 2U;
+    netc_lzp_xor_filter(src, i, table, NULL, order2, dst);
+
+    for (; i + 8U <= len; i += 8U) {
+        __m256i prev  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i - 1U)));
+        __m256i prev2 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i - 2U)));
+        __m256i pos   = _mm256_add_epi32(_mm256_set1_epi32((int)i),
+                                         _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i lo    = _mm256_and_si256(pos, lo16);
+        __m256i hi    = _mm256_srli_epi32(pos, 16);
+
+        __m256i h = avx2_fnv(_mm256_set1_epi32((int)2166136261u), prev);
+        h = avx2_fnv(avx2_fnv(h, lo), hi);
+        __m256i e = avx2_lzp_gather(table, _mm256_and_si256(h, mask));
+        __m256i v = _mm256_and_si256(_mm256_srli_epi32(e, 8), lo_byte);
+        if (order2) {
+            h = avx2_fnv(avx2_fnv(_mm256_set1_epi32((int)0x9E3779B9u), prev2), prev);
+            h = avx2_fnv(avx2_fnv(h, lo), hi);
+            __m256i e2 = avx2_lzp_gather(table, _mm256_and_si256(h, mask));
+            __m256i v2 = _mm256_and_si256(_mm256_srli_epi32(e2, 8), lo_byte);
+            e = _mm256_blendv_epi8(e2, e, _mm256_cmpgt_epi32(v, v2));
+            v = _mm256_max_epi32(v, v2);
         }
+        __m256i pred = _mm256_andnot_si256(_mm256_cmpeq_epi32(v, _mm256_setzero_si256()),
+                                           _mm256_and_si256(e, lo_byte));
+        pred = _mm256_shuffle_epi8(pred, sym_shuf);
+        uint64_t p = (uint64_t)(uint32_t)_mm256_cvtsi256_si32(pred)
+                   | (uint64_t)(uint32_t)_mm256_extract_epi32(pred, 4) << 32;
+        uint64_t x;
+        memcpy(&x, src + i, 8);
+        x ^= p;
+        memcpy(dst + i, &x, 8);
+    }
+    for (; i < len; i++) {
+        dst[i] = src[i] ^ netc_lzp_guess(table, NULL, order2, src[i - 2U], src[i - 1U],
+                                         (uint32_t)i);
     }
 }
 
@@ -223,21 +417,130 @@ void netc_freq_count_avx2(const uint8_t *data, size_t len, uint32_t *freq)
     }
 }
 
+/* =========================================================================
+ * AVX2 X8 interleaved tANS decode
+ *
+ * The scalar reader hands lane 0 the topmost nb_0 unread bits, lane 1 the
+ * next nb_1, and so on.  With pos = unread bit count and s_k the inclusive
+ * prefix sum of nb over lanes 0..k, lane k's bits are [pos - s_k,
+ * pos - s_k + nb_k) counted from bit 0 of buf (LSB-first, as written).
+ *
+ * A group reads at most 8 * 12 = 96 bits, so all of them lie in the 16 bytes
+ * ending at the byte that holds bit pos - 1.  That window is loaded once and
+ * broadcast to both 128-bit halves; each lane then picks the 4 bytes ending
+ * at its field's top byte with _mm256_shuffle_epi8 instead of a second
+ * gather, and shifts its field down with _mm256_srlv_epi32:
+ *
+ *   e    = gather(decode, X - 4096)             8 entries, one per lane
+ *   nb   = (e >> 8) & 0xFF, s = prefix_sum(nb)  in-lane shifts + one cross-lane add
+ *   lo   = (pos - 8*win) - s                    field start within the window
+ *   w    = shuffle(window, (top >> 3) - 3 + {0,1,2,3})
+ *   X    = (e >> 16) + ((w >> (lo - 8*byte)) & ((1 << nb) - 1))
+ *
+ * The window load depends only on pos, not on the gathered entries, so it
+ * overlaps the gather.  pos >= NETC_TANS_X8_KERNEL_MIN_BITS keeps the window
+ * at or above buf[0].
+ * ========================================================================= */
+size_t netc_tans_decode_x8_avx2(const uint32_t *decode, const uint8_t *buf,
+                                size_t *bit_pos, uint32_t *X, uint8_t *dst,
+                                size_t n_groups)
+{
+    const __m256i table_size = _mm256_set1_epi32(4096);
+    const __m256i lo_byte    = _mm256_set1_epi32(0xFF);
+    const __m256i one        = _mm256_set1_epi32(1);
+    const __m256i three      = _mm256_set1_epi32(3);
+    const __m256i splat      = _mm256_setr_epi8(
+        0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+        0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+    const __m256i byte_seq   = _mm256_set1_epi32(0x03020100);
+    const __m256i sym_shuf   = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    __m256i x   = _mm256_loadu_si256((const __m256i *)X);
+    size_t  pos = *bit_pos;
+    size_t  g   = 0;
+
+    for (; g < n_groups && pos >= NETC_TANS_X8_KERNEL_MIN_BITS; g++) {
+        size_t  win = ((pos - 1U) >> 3) - 15U;
+        __m256i wnd = _mm256_broadcastsi128_si256(
+                          _mm_loadu_si128((const __m128i *)(buf + win)));
+
+        __m256i e  = _mm256_i32gather_epi32((const int *)decode,
+                                            _mm256_sub_epi32(x, table_size), 4);
+        __m256i nb = _mm256_and_si256(_mm256_srli_epi32(e, 8), lo_byte);
+
+        /* Inclusive prefix sum of nb across the 8 lanes */
+        __m256i s = _mm256_add_epi32(nb, _mm256_slli_si256(nb, 4));
+        s = _mm256_add_epi32(s, _mm256_slli_si256(s, 8));
+        s = _mm256_add_epi32(s, _mm256_shuffle_epi32(
+                _mm256_permute2x128_si256(s, s, 0x08), 0xFF));
+
+        __m256i lo   = _mm256_sub_epi32(_mm256_set1_epi32((int)(pos - 8U * win)), s);
+        __m256i top  = _mm256_sub_epi32(_mm256_add_epi32(lo, nb), one);
+        __m256i byte = _mm256_sub_epi32(_mm256_srli_epi32(top, 3), three);
+        __m256i w    = _mm256_shuffle_epi8(wnd, _mm256_add_epi32(
+                           _mm256_shuffle_epi8(byte, splat), byte_seq));
+        __m256i sh   = _mm256_sub_epi32(lo, _mm256_slli_epi32(byte, 3));
+        __m256i mask = _mm256_sub_epi32(_mm256_sllv_epi32(one, nb), one);
+        __m256i bits = _mm256_and_si256(_mm256_srlv_epi32(w, sh), mask);
+        x = _mm256_add_epi32(_mm256_srli_epi32(e, 16), bits);
+
+        __m256i  sym = _mm256_shuffle_epi8(e, sym_shuf);
+        uint32_t s03 = (uint32_t)_mm256_cvtsi256_si32(sym);
+        uint32_t s47 = (uint32_t)_mm256_extract_epi32(sym, 4);
+        memcpy(dst + 8u * g,      &s03, 4);
+        memcpy(dst + 8u * g + 4u, &s47, 4);
+
+        pos -= (uint32_t)_mm256_extract_epi32(s, 7);
+    }
+
+    _mm256_storeu_si256((__m256i *)X, x);
+    *bit_pos = pos;
+    return g;
+}
+
 #else /* AVX2 not available at compile time */
 
-void netc_delta_encode_avx2(const uint8_t *prev, const uint8_t *curr,
-                              uint8_t *out, size_t len)
+void netc_delta_encode_avx2(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *curr,
+                            uint8_t *out, size_t len)
+{
+    netc_delta_encode_generic(map, prev, curr, out, len);
+}
+void netc_delta_decode_avx2(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *residual,
+                            uint8_t *out, size_t len)
+{
+    netc_delta_decode_generic(map, prev, residual, out, len);
+}
+void netc_delta_planes_split_avx2(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
 {
-    netc_delta_encode_generic(prev, curr, out, len);
+    netc_delta_planes_split_generic(pl, buf, len);
 }
-void netc_delta_decode_avx2(const uint8_t *prev, const uint8_t *residual,
-                              uint8_t *out, size_t len)
+void netc_delta_planes_merge_avx2(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
 {
-    netc_delta_decode_generic(prev, residual, out, len);
+    netc_delta_planes_merge_generic(pl, buf, len);
+}
+uint32_t netc_match_count_avx2(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    return netc_match_count_generic(a, b, len);
+}
+void netc_lzp_filter_avx2(const netc_lzp_table_t *table, int order2,
+                          const uint8_t *src, uint8_t *dst, size_t len)
+{
+    netc_lzp_filter_generic(table, order2, src, dst, len);
 }
 void netc_freq_count_avx2(const uint8_t *data, size_t len, uint32_t *freq)
 {
     netc_freq_count_generic(data, len, freq);
 }
+size_t netc_tans_decode_x8_avx2(const uint32_t *decode, const uint8_t *buf,
+                                size_t *bit_pos, uint32_t *X, uint8_t *dst,
+                                size_t n_groups)
+{
+    (void)decode; (void)buf; (void)bit_pos; (void)X; (void)dst; (void)n_groups;
+    return 0;  /* nothing decoded: caller continues with the scalar reader */
+}
 
 #endif /* AVX2 */
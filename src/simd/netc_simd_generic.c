@@ -10,11 +10,8 @@
  * They also handle the scalar tail of SIMD paths (remainder after
  * processing full vector-width chunks).
  *
- * Note on delta field-class logic: the generic bulk ops apply a flat
- * XOR for the entire buffer. The field-class-aware logic (AD-002) is
- * applied at the pipeline level in netc_compress/netc_decompress via
- * netc_delta.h. The SIMD bulk ops here are used for the flat inner
- * loop; field-class boundary handling remains scalar.
+ * Delta kernels apply a per-offset operator map (AD-020); this file also
+ * defines netc_delta_map_default, the static field-class layout of AD-002.
  */
 
 #include "netc_simd.h"
@@ -117,6 +114,7 @@ uint8_t netc_simd_detect(void) {
  * ========================================================================= */
 
 void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level) {
+    const int forced = (level != NETC_SIMD_LEVEL_AUTO);
     if (level == NETC_SIMD_LEVEL_AUTO) {
         level = netc_simd_detect();
     }
@@ -125,8 +123,19 @@ void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level) {
     if (level >= NETC_SIMD_LEVEL_AVX2 && netc__has_avx2()) {
         ops->delta_encode = netc_delta_encode_avx2;
         ops->delta_decode = netc_delta_decode_avx2;
+        ops->delta_planes_split = netc_delta_planes_split_avx2;
+        ops->delta_planes_merge = netc_delta_planes_merge_avx2;
+        ops->match_count  = netc_match_count_avx2;
+        ops->lzp_filter   = netc_lzp_filter_avx2;
+        ops->lzp_unfilter = netc_lzp_unfilter_generic;
         ops->freq_count   = netc_freq_count_avx2;
         ops->crc32_update = netc_crc32_update_sse42; /* AVX2 doesn't add new CRC */
+        /* Opt-in: the X8 kernel is a dependency chain through one
+         * vpgatherdd per 8 symbols, and where gathers are microcoded
+         * (gather data sampling mitigation) it trails the scalar
+         * interleaved loop.  Auto-detect leaves it off; simd_level = AVX2
+         * selects it. */
+        ops->tans_decode_x8 = forced ? netc_tans_decode_x8_avx2 : NULL;
         ops->level        = NETC_SIMD_LEVEL_AVX2;
         return;
     }
@@ -136,8 +145,14 @@ void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level) {
     if (level >= NETC_SIMD_LEVEL_SSE42 && netc__has_sse42()) {
         ops->delta_encode = netc_delta_encode_sse42;
         ops->delta_decode = netc_delta_decode_sse42;
+        ops->delta_planes_split = netc_delta_planes_split_sse42;
+        ops->delta_planes_merge = netc_delta_planes_merge_sse42;
+        ops->match_count  = netc_match_count_sse42;
+        ops->lzp_filter   = netc_lzp_filter_sse42;
+        ops->lzp_unfilter = netc_lzp_unfilter_generic;
         ops->freq_count   = netc_freq_count_sse42;
         ops->crc32_update = netc_crc32_update_sse42;
+        ops->tans_decode_x8 = NULL;
         ops->level        = NETC_SIMD_LEVEL_SSE42;
         return;
     }
@@ -147,8 +162,14 @@ void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level) {
     if (level >= NETC_SIMD_LEVEL_NEON && netc__has_neon()) {
         ops->delta_encode = netc_delta_encode_neon;
         ops->delta_decode = netc_delta_decode_neon;
+        ops->delta_planes_split = netc_delta_planes_split_neon;
+        ops->delta_planes_merge = netc_delta_planes_merge_neon;
+        ops->match_count  = netc_match_count_neon;
+        ops->lzp_filter   = netc_lzp_filter_generic;
+        ops->lzp_unfilter = netc_lzp_unfilter_generic;
         ops->freq_count   = netc_freq_count_neon;
         ops->crc32_update = netc_crc32_update_neon;
+        ops->tans_decode_x8 = NULL;
         ops->level        = NETC_SIMD_LEVEL_NEON;
         return;
     }
@@ -157,8 +178,14 @@ void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level) {
     /* Generic fallback */
     ops->delta_encode = netc_delta_encode_generic;
     ops->delta_decode = netc_delta_decode_generic;
+    ops->delta_planes_split = netc_delta_planes_split_generic;
+    ops->delta_planes_merge = netc_delta_planes_merge_generic;
+    ops->match_count  = netc_match_count_generic;
+    ops->lzp_filter   = netc_lzp_filter_generic;
+    ops->lzp_unfilter = netc_lzp_unfilter_generic;
     ops->freq_count   = netc_freq_count_generic;
     ops->crc32_update = netc_crc32_update_generic;
+    ops->tans_decode_x8 = NULL;
     ops->level        = NETC_SIMD_LEVEL_GENERIC;
 }
 
@@ -166,40 +193,122 @@ void netc_simd_ops_init(netc_simd_ops_t *ops, uint8_t level) {
  * Generic C11 implementations
  * ========================================================================= */
 
-/* --- Delta encode (flat XOR for the bulk; field-class boundaries handled
- *     at the pipeline level in netc_compress via netc_delta.h) ---
+/* --- Delta operator map ---
  *
- * For the SIMD bulk path, we use a simple flat XOR across all bytes.
- * The pipeline in netc_compress applies field-class-aware encoding using
- * the scalar netc_delta_encode() which handles the boundary conditions.
- * These SIMD functions are used when the pipeline wants maximum throughput
- * on large uniform regions.
- *
- * For now, to maintain exact byte-for-byte compatibility with the scalar
- * pipeline, the generic bulk functions replicate the field-class logic. */
+ * The static field-class layout of netc_delta.h as an operator map: XOR for
+ * [0,16) and [64,256), byte SUB elsewhere. Kernels given a NULL map use it. */
+
+#define DM16(op) op, op, op, op, op, op, op, op, op, op, op, op, op, op, op, op
+#define DM_X NETC_DELTA_OP_XOR
+#define DM_S NETC_DELTA_OP_SUB
+const netc_delta_map_t netc_delta_map_default = {
+    {
+        DM16(DM_X), DM16(DM_S), DM16(DM_S), DM16(DM_S),   /* [0, 64)    */
+        DM16(DM_X), DM16(DM_X), DM16(DM_X), DM16(DM_X),   /* [64, 128)  */
+        DM16(DM_X), DM16(DM_X), DM16(DM_X), DM16(DM_X),   /* [128, 192) */
+        DM16(DM_X), DM16(DM_X), DM16(DM_X), DM16(DM_X),   /* [192, 256) */
+        DM16(DM_S), DM16(DM_S), DM16(DM_S), DM16(DM_S),   /* [256, 320) */
+        DM16(DM_S), DM16(DM_S), DM16(DM_S), DM16(DM_S),   /* [320, 384) */
+        DM16(DM_S), DM16(DM_S), DM16(DM_S), DM16(DM_S),   /* [384, 448) */
+        DM16(DM_S), DM16(DM_S), DM16(DM_S), DM16(DM_S),   /* [448, 512) */
+    },
+    NETC_DELTA_OP_SUB,  /* tail */
+    0                   /* no byte planes */
+};
+#undef DM_S
+#undef DM_X
+#undef DM16
+
+/* --- Delta encode / decode: the scalar reference loop of netc_delta.h --- */
+
+void netc_delta_encode_generic(const netc_delta_map_t *map,
+                               const uint8_t *prev, const uint8_t *curr,
+                               uint8_t *out, size_t len)
+{
+    if (map == NULL) map = &netc_delta_map_default;
+    netc_delta_encode_mapped(map, prev, curr, out, 0, len);
+}
+
+void netc_delta_decode_generic(const netc_delta_map_t *map,
+                               const uint8_t *prev, const uint8_t *residual,
+                               uint8_t *out, size_t len)
+{
+    if (map == NULL) map = &netc_delta_map_default;
+    netc_delta_decode_mapped(map, prev, residual, out, 0, len);
+}
+
+/* --- Byte planes: one run at a time through a copy of the run --- */
+
+void netc_delta_planes_split_generic(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        memcpy(tmp, buf + pl->start[r], n * pl->width[r]);
+        netc_delta_planes_split(buf + pl->start[r], tmp, pl->width[r], n, 0);
+    }
+}
 
-void netc_delta_encode_generic(const uint8_t *prev, const uint8_t *curr,
-                                uint8_t *out, size_t len)
+void netc_delta_planes_merge_generic(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
 {
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        memcpy(tmp, buf + pl->start[r], n * pl->width[r]);
+        netc_delta_planes_merge(buf + pl->start[r], tmp, pl->width[r], n, 0);
+    }
+}
+
+/* --- Equal-byte count --- */
+uint32_t netc_match_count_generic(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    uint32_t n = 0;
     for (size_t i = 0; i < len; i++) {
-        /* Replicate field-class logic from netc_delta.h */
-        if (i < 16u || (i >= 64u && i < 256u)) {
-            out[i] = curr[i] ^ prev[i];
-        } else {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-        }
+        n += (uint32_t)(a[i] == b[i]);
     }
+    return n;
+}
+
+/* --- LZP XOR filter --- */
+void netc_lzp_filter_generic(const netc_lzp_table_t *table, int order2,
+                             const uint8_t *src, uint8_t *dst, size_t len)
+{
+    netc_lzp_xor_filter(src, len, table, NULL, order2, dst);
 }
 
-void netc_delta_decode_generic(const uint8_t *prev, const uint8_t *residual,
-                                uint8_t *out, size_t len)
+/* Positions between the slot being read and the one being prefetched:
+ * enough to cover an L2 miss at a few cycles per byte. */
+#define NETC_LZP_PREFETCH_DIST 8U
+
+/* First line a lookup of slot h reads: its block of a packed table (the
+ * entry's address depends on it), or the entry itself. */
+static NETC_INLINE const void *lzp_slot_line(const netc_lzp_table_t *table, uint32_t h)
 {
+    if (table->blk != NULL) return &table->blk[h >> NETC_LZP_BLK_SHIFT];
+    return &table->ent[h];
+}
+
+void netc_lzp_unfilter_generic(const netc_lzp_table_t *table, int order2,
+                               const uint8_t *src, const uint8_t *hint,
+                               uint8_t *dst, size_t len)
+{
+    if (hint == NULL) {
+        netc_lzp_xor_unfilter(src, len, table, NULL, order2, dst);
+        return;
+    }
     for (size_t i = 0; i < len; i++) {
-        if (i < 16u || (i >= 64u && i < 256u)) {
-            out[i] = residual[i] ^ prev[i];
-        } else {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
+        size_t j = i + NETC_LZP_PREFETCH_DIST;
+        if (j < len) {
+            NETC_PREFETCH(lzp_slot_line(table, netc_lzp_hash(hint[j - 1], (uint32_t)j)));
+            if (order2)
+                NETC_PREFETCH(lzp_slot_line(table,
+                    netc_lzp_hash2(hint[j - 2], hint[j - 1], (uint32_t)j)));
         }
+        uint8_t prev  = (i > 0) ? dst[i - 1] : 0x00u;
+        uint8_t prev2 = (i > 1) ? dst[i - 2] : 0x00u;
+        dst[i] = src[i] ^ netc_lzp_guess(table, NULL, order2, prev2, prev, (uint32_t)i);
     }
 }
 
@@ -10,11 +10,9 @@
  * ARMv8.1+ CRC32 extension (when __ARM_FEATURE_CRC32 defined):
  *   - __crc32b / __crc32w / __crc32d — hardware CRC32 (ISO-HDLC polynomial)
  *
- * Delta encoding uses the same 4-region field-class strategy as SSE4.2:
- *   HEADER   [0, 16):   XOR  (scalar — only 16 bytes)
- *   SUBHEADER[16, 64):  SUB  (vsubq_u8, 16 bytes/iter)
- *   BODY     [64, 256): XOR  (veorq_u8, 16 bytes/iter)
- *   TAIL     [256+):    SUB  (vsubq_u8, 16 bytes/iter)
+ * Delta encoding applies the per-offset operator map (AD-020) 16 bytes per
+ * iteration, selecting each byte's operator with vbslq_u8. Byte planes
+ * (AD-021) are exactly the de-interleave of vld2q_u8 / vld4q_u8.
  */
 
 #include "netc_simd.h"
@@ -30,142 +28,184 @@
 #  include <arm_acle.h>
 #endif
 
-/* =========================================================================
- * Field-class boundaries (same as netc_delta.h and netc_simd_sse42.c)
- * ========================================================================= */
-#define HDR_END  16u   /* 0-15:   XOR */
-#define SUB_END  64u   /* 16-63:  SUB */
-#define BODY_END 256u  /* 64-255: XOR */
-/* 256+: SUB */
-
 /* =========================================================================
  * NEON implementations (when ARM NEON is available)
  * ========================================================================= */
 
 #if defined(__ARM_NEON)
 
-void netc_delta_encode_neon(const uint8_t *prev, const uint8_t *curr,
-                             uint8_t *out, size_t len)
+/* =========================================================================
+ * NEON delta encode / decode
+ *
+ * Same scheme as the SSE4.2 kernels: every map operator is computed per
+ * 16-byte chunk and the result selected per byte with vbslq_u8 on
+ * vceqq_u8(op, k) masks. The 16/32-bit lane operators reinterpret the
+ * chunk as u16/u32 lanes, which are little-endian on the targets built
+ * here (AArch64 / ARMv7 LE).
+ * ========================================================================= */
+
+static NETC_INLINE uint8x16_t neon_delta_pick(uint8x16_t ops, uint8x16_t x, uint8x16_t s8,
+                                              uint8x16_t none, uint8x16_t s16, uint8x16_t s32,
+                                              uint8x16_t f32)
 {
-    size_t i = 0;
+    uint8x16_t r = x;
+    r = vbslq_u8(vceqq_u8(ops, vdupq_n_u8(NETC_DELTA_OP_SUB)),   s8,   r);
+    r = vbslq_u8(vceqq_u8(ops, vdupq_n_u8(NETC_DELTA_OP_NONE)),  none, r);
+    r = vbslq_u8(vceqq_u8(ops, vdupq_n_u8(NETC_DELTA_OP_SUB16)), s16,  r);
+    r = vbslq_u8(vceqq_u8(ops, vdupq_n_u8(NETC_DELTA_OP_SUB32)), s32,  r);
+    r = vbslq_u8(vceqq_u8(ops, vdupq_n_u8(NETC_DELTA_OP_FLT32)), f32,  r);
+    return r;
+}
 
-    /* HEADER region [0, 16): XOR, scalar (only 16 bytes) */
-    {
-        size_t end = len < HDR_END ? len : HDR_END;
-        while (i < end) {
-            out[i] = curr[i] ^ prev[i];
-            i++;
-        }
-    }
+/* FLT32 residual lanes: rotate the XOR left by one bit, and back */
+static NETC_INLINE uint8x16_t neon_rotl1(uint8x16_t v) {
+    uint32x4_t u = vreinterpretq_u32_u8(v);
+    return vreinterpretq_u8_u32(vorrq_u32(vshlq_n_u32(u, 1), vshrq_n_u32(u, 31)));
+}
+static NETC_INLINE uint8x16_t neon_rotr1(uint8x16_t v) {
+    uint32x4_t u = vreinterpretq_u32_u8(v);
+    return vreinterpretq_u8_u32(vorrq_u32(vshrq_n_u32(u, 1), vshlq_n_u32(u, 31)));
+}
 
-    /* SUBHEADER region [16, 64): SUB, up to 3 × 16-byte vectors */
-    {
-        size_t end = len < SUB_END ? len : SUB_END;
-        while (i + 16u <= end) {
-            uint8x16_t p = vld1q_u8(prev + i);
-            uint8x16_t c = vld1q_u8(curr + i);
-            uint8x16_t r = vsubq_u8(c, p);
-            vst1q_u8(out + i, r);
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-            i++;
-        }
-    }
+static NETC_INLINE uint8x16_t neon_delta_ops(const netc_delta_map_t *map, size_t i) {
+    return (i < NETC_DELTA_MAP_LEN) ? vld1q_u8(map->op + i) : vdupq_n_u8(map->tail);
+}
 
-    /* BODY region [64, 256): XOR, up to 12 × 16-byte vectors */
-    {
-        size_t end = len < BODY_END ? len : BODY_END;
-        while (i + 16u <= end) {
-            uint8x16_t p = vld1q_u8(prev + i);
-            uint8x16_t c = vld1q_u8(curr + i);
-            uint8x16_t r = veorq_u8(c, p);
-            vst1q_u8(out + i, r);
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = curr[i] ^ prev[i];
-            i++;
-        }
-    }
+void netc_delta_encode_neon(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *curr,
+                            uint8_t *out, size_t len)
+{
+    if (map == NULL) map = &netc_delta_map_default;
+    size_t i = 0;
 
-    /* TAIL region [256, len): SUB */
-    {
-        while (i + 16u <= len) {
-            uint8x16_t p = vld1q_u8(prev + i);
-            uint8x16_t c = vld1q_u8(curr + i);
-            uint8x16_t r = vsubq_u8(c, p);
-            vst1q_u8(out + i, r);
-            i += 16u;
-        }
-        while (i < len) {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-            i++;
-        }
+    for (; i + 16u <= len; i += 16u) {
+        uint8x16_t p = vld1q_u8(prev + i);
+        uint8x16_t c = vld1q_u8(curr + i);
+        uint8x16_t s16 = vreinterpretq_u8_u16(vsubq_u16(vreinterpretq_u16_u8(c),
+                                                        vreinterpretq_u16_u8(p)));
+        uint8x16_t s32 = vreinterpretq_u8_u32(vsubq_u32(vreinterpretq_u32_u8(c),
+                                                        vreinterpretq_u32_u8(p)));
+        uint8x16_t x = veorq_u8(c, p);
+        vst1q_u8(out + i, neon_delta_pick(neon_delta_ops(map, i),
+                                          x, vsubq_u8(c, p), c, s16, s32, neon_rotl1(x)));
     }
+
+    netc_delta_encode_mapped(map, prev, curr, out, i, len);
 }
 
-void netc_delta_decode_neon(const uint8_t *prev, const uint8_t *residual,
-                             uint8_t *out, size_t len)
+void netc_delta_decode_neon(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *residual,
+                            uint8_t *out, size_t len)
 {
+    if (map == NULL) map = &netc_delta_map_default;
     size_t i = 0;
 
-    /* HEADER [0, 16): XOR */
-    {
-        size_t end = len < HDR_END ? len : HDR_END;
-        while (i < end) {
-            out[i] = residual[i] ^ prev[i];
-            i++;
-        }
+    for (; i + 16u <= len; i += 16u) {
+        uint8x16_t p = vld1q_u8(prev + i);
+        uint8x16_t r = vld1q_u8(residual + i);
+        uint8x16_t a16 = vreinterpretq_u8_u16(vaddq_u16(vreinterpretq_u16_u8(r),
+                                                        vreinterpretq_u16_u8(p)));
+        uint8x16_t a32 = vreinterpretq_u8_u32(vaddq_u32(vreinterpretq_u32_u8(r),
+                                                        vreinterpretq_u32_u8(p)));
+        vst1q_u8(out + i, neon_delta_pick(neon_delta_ops(map, i),
+                                          veorq_u8(r, p), vaddq_u8(r, p), r, a16, a32,
+                                          veorq_u8(neon_rotr1(r), p)));
     }
 
-    /* SUBHEADER [16, 64): ADD */
-    {
-        size_t end = len < SUB_END ? len : SUB_END;
-        while (i + 16u <= end) {
-            uint8x16_t p = vld1q_u8(prev + i);
-            uint8x16_t r = vld1q_u8(residual + i);
-            uint8x16_t c = vaddq_u8(r, p);
-            vst1q_u8(out + i, c);
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
-            i++;
+    netc_delta_decode_mapped(map, prev, residual, out, i, len);
+}
+
+/* =========================================================================
+ * NEON byte planes: 16 lanes per step through vld2q/vld4q (split) and
+ * vst2q/vst4q (merge); the scalar reference finishes a run.
+ * ========================================================================= */
+
+void netc_delta_planes_split_neon(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        size_t   w   = pl->width[r];
+        uint8_t *run = buf + pl->start[r];
+        size_t   j   = 0;
+        memcpy(tmp, run, n * w);
+        if (w == 4U) {
+            for (; j + 16U <= n; j += 16U) {
+                uint8x16x4_t v = vld4q_u8(tmp + 4U * j);
+                vst1q_u8(run + j,          v.val[0]);
+                vst1q_u8(run + n + j,      v.val[1]);
+                vst1q_u8(run + 2U * n + j, v.val[2]);
+                vst1q_u8(run + 3U * n + j, v.val[3]);
+            }
+        } else {
+            for (; j + 16U <= n; j += 16U) {
+                uint8x16x2_t v = vld2q_u8(tmp + 2U * j);
+                vst1q_u8(run + j,     v.val[0]);
+                vst1q_u8(run + n + j, v.val[1]);
+            }
         }
+        netc_delta_planes_split(run, tmp, w, n, j);
     }
+}
 
-    /* BODY [64, 256): XOR */
-    {
-        size_t end = len < BODY_END ? len : BODY_END;
-        while (i + 16u <= end) {
-            uint8x16_t p = vld1q_u8(prev + i);
-            uint8x16_t r = vld1q_u8(residual + i);
-            uint8x16_t c = veorq_u8(r, p);
-            vst1q_u8(out + i, c);
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = residual[i] ^ prev[i];
-            i++;
+void netc_delta_planes_merge_neon(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        size_t   w   = pl->width[r];
+        uint8_t *run = buf + pl->start[r];
+        size_t   j   = 0;
+        memcpy(tmp, run, n * w);
+        if (w == 4U) {
+            for (; j + 16U <= n; j += 16U) {
+                uint8x16x4_t v;
+                v.val[0] = vld1q_u8(tmp + j);
+                v.val[1] = vld1q_u8(tmp + n + j);
+                v.val[2] = vld1q_u8(tmp + 2U * n + j);
+                v.val[3] = vld1q_u8(tmp + 3U * n + j);
+                vst4q_u8(run + 4U * j, v);
+            }
+        } else {
+            for (; j + 16U <= n; j += 16U) {
+                uint8x16x2_t v;
+                v.val[0] = vld1q_u8(tmp + j);
+                v.val[1] = vld1q_u8(tmp + n + j);
+                vst2q_u8(run + 2U * j, v);
+            }
         }
+        netc_delta_planes_merge(run, tmp, w, n, j);
     }
+}
 
-    /* TAIL [256, len): ADD */
-    {
-        while (i + 16u <= len) {
-            uint8x16_t p = vld1q_u8(prev + i);
-            uint8x16_t r = vld1q_u8(residual + i);
-            uint8x16_t c = vaddq_u8(r, p);
-            vst1q_u8(out + i, c);
-            i += 16u;
-        }
-        while (i < len) {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
-            i++;
+/* =========================================================================
+ * NEON equal-byte count
+ *
+ * vceqq_u8 yields 0xFF per equal byte; subtracting it counts matches per
+ * lane in 8 bits, widened with pairwise adds every 255 blocks.
+ * ========================================================================= */
+
+uint32_t netc_match_count_neon(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    uint64_t n = 0;
+    size_t   i = 0;
+
+    while (i + 16u <= len) {
+        uint8x16_t acc = vdupq_n_u8(0);
+        size_t     end = len - ((len - i) % 16u);
+        if (end - i > 255u * 16u) end = i + 255u * 16u;
+        for (; i < end; i += 16u) {
+            acc = vsubq_u8(acc, vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
         }
+        uint64x2_t s = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(acc)));
+        n += vgetq_lane_u64(s, 0) + vgetq_lane_u64(s, 1);
     }
+    for (; i < len; i++) {
+        n += (uint64_t)(a[i] == b[i]);
+    }
+    return (uint32_t)n;
 }
 
 /* =========================================================================
@@ -247,16 +287,33 @@ uint32_t netc_crc32_update_neon(uint32_t crc, const uint8_t *data, size_t len)
 
 #else /* __ARM_NEON not defined — stubs that delegate to generic */
 
-void netc_delta_encode_neon(const uint8_t *prev, const uint8_t *curr,
-                             uint8_t *out, size_t len)
+void netc_delta_encode_neon(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *curr,
+                            uint8_t *out, size_t len)
+{
+    netc_delta_encode_generic(map, prev, curr, out, len);
+}
+
+void netc_delta_decode_neon(const netc_delta_map_t *map,
+                            const uint8_t *prev, const uint8_t *residual,
+                            uint8_t *out, size_t len)
+{
+    netc_delta_decode_generic(map, prev, residual, out, len);
+}
+
+void netc_delta_planes_split_neon(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    netc_delta_planes_split_generic(pl, buf, len);
+}
+
+void netc_delta_planes_merge_neon(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
 {
-    netc_delta_encode_generic(prev, curr, out, len);
+    netc_delta_planes_merge_generic(pl, buf, len);
 }
 
-void netc_delta_decode_neon(const uint8_t *prev, const uint8_t *residual,
-                             uint8_t *out, size_t len)
+uint32_t netc_match_count_neon(const uint8_t *a, const uint8_t *b, size_t len)
 {
-    netc_delta_decode_generic(prev, residual, out, len);
+    return netc_match_count_generic(a, b, len);
 }
 
 void netc_freq_count_neon(const uint8_t *data, size_t len, uint32_t *freq)
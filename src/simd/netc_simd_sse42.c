@@ -14,16 +14,19 @@
  * to the generic (software) IEEE implementation. Future PCLMULQDQ-based IEEE
  * CRC32 acceleration can replace this when added.
  *
- * Delta encoding: SSE4.2 does NOT change the field-class boundaries.
- * We process 16 bytes at a time in two phases:
- *   Phase A (HEADER+BODY): XOR — _mm_xor_si128
- *   Phase B (SUBHEADER+TAIL): SUB — _mm_sub_epi8
- * Scalar tail handles the last <16 bytes and exact boundary bytes.
+ * Delta encoding: 16 bytes at a time, every map operator computed and
+ * selected per byte with SSE4.1 _mm_blendv_epi8 (AD-020). Scalar tail
+ * handles the last <16 bytes. Byte planes (AD-021) transpose 4 u32 or 8 u16
+ * lanes per SSSE3 _mm_shuffle_epi8.
+ *
+ * LZP XOR filter: the context hashes of 4 positions per step, with
+ * SSE4.1 _mm_mullo_epi32.
  */
 
 #include "netc_simd.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 /* Include SSE4.2 intrinsics.
  * On MSVC x64: available by default (no flag needed).
@@ -38,148 +41,273 @@
 #endif
 
 /* =========================================================================
- * Field-class boundaries (same as netc_delta.h)
- * ========================================================================= */
-#define HDR_END  16u   /* 0-15:   XOR */
-#define SUB_END  64u   /* 16-63:  SUB */
-#define BODY_END 256u  /* 64-255: XOR */
-/* 256+: SUB */
-
-/* =========================================================================
- * SSE4.2 delta encode
+ * SSE4.2 delta encode / decode
  *
- * Strategy: for each 16-byte chunk entirely within a single field-class
- * region, apply the vector op. Chunks that straddle a boundary fall back
- * to scalar. This keeps branch overhead low for typical packet sizes.
+ * Every operator of the map is computed for each 16-byte chunk and the
+ * result is picked per byte with _mm_blendv_epi8 on op == k masks, so the
+ * map costs a load, five compares and five blends per chunk whatever it
+ * holds. Chunks start at multiples of 16, so the 16/32-bit lanes of
+ * _mm_sub_epi16/_mm_sub_epi32 line up with the map's aligned pairs and
+ * quads. Past NETC_DELTA_MAP_LEN every byte uses map->tail and a single
+ * operator runs. The scalar reference finishes the last < 16 bytes.
  * ========================================================================= */
 
 #if defined(_MSC_VER) || defined(__SSE4_2__)
 
-void netc_delta_encode_sse42(const uint8_t *prev, const uint8_t *curr,
-                              uint8_t *out, size_t len)
+static NETC_INLINE __m128i sse42_delta_pick(__m128i ops, __m128i x, __m128i s8,
+                                            __m128i none, __m128i s16, __m128i s32,
+                                            __m128i f32)
 {
-    size_t i = 0;
+    __m128i r = x;
+    r = _mm_blendv_epi8(r, s8,   _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_SUB)));
+    r = _mm_blendv_epi8(r, none, _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_NONE)));
+    r = _mm_blendv_epi8(r, s16,  _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_SUB16)));
+    r = _mm_blendv_epi8(r, s32,  _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_SUB32)));
+    r = _mm_blendv_epi8(r, f32,  _mm_cmpeq_epi8(ops, _mm_set1_epi8((char)NETC_DELTA_OP_FLT32)));
+    return r;
+}
 
-    /* HEADER region [0, 16): XOR, exactly one 16-byte vector if len >= 16 */
-    {
-        size_t end = len < HDR_END ? len : HDR_END;
-        /* scalar — region is only 16 bytes, no benefit from looping */
-        while (i < end) {
-            out[i] = curr[i] ^ prev[i];
-            i++;
-        }
-    }
+/* FLT32 residual lanes: rotate the XOR left by one bit, and back */
+static NETC_INLINE __m128i sse42_rotl1(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi32(v, 1), _mm_srli_epi32(v, 31));
+}
+static NETC_INLINE __m128i sse42_rotr1(__m128i v) {
+    return _mm_or_si128(_mm_srli_epi32(v, 1), _mm_slli_epi32(v, 31));
+}
 
-    /* SUBHEADER region [16, 64): SUB, up to 3 × 16-byte vectors */
-    {
-        size_t end = len < SUB_END ? len : SUB_END;
-        /* Process 16-byte chunks */
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
-            __m128i r = _mm_sub_epi8(c, p);
-            _mm_storeu_si128((__m128i *)(out + i), r);
-            i += 16u;
-        }
-        /* scalar tail */
-        while (i < end) {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-            i++;
-        }
-    }
+void netc_delta_encode_sse42(const netc_delta_map_t *map,
+                             const uint8_t *prev, const uint8_t *curr,
+                             uint8_t *out, size_t len)
+{
+    if (map == NULL) map = &netc_delta_map_default;
+    size_t i = 0;
+    size_t mapped = len < NETC_DELTA_MAP_LEN ? len : NETC_DELTA_MAP_LEN;
 
-    /* BODY region [64, 256): XOR, up to 12 × 16-byte vectors */
-    {
-        size_t end = len < BODY_END ? len : BODY_END;
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
-            __m128i r = _mm_xor_si128(c, p);
-            _mm_storeu_si128((__m128i *)(out + i), r);
-            i += 16u;
-        }
-        while (i < end) {
-            out[i] = curr[i] ^ prev[i];
-            i++;
-        }
+    for (; i + 16u <= mapped; i += 16u) {
+        __m128i p   = _mm_loadu_si128((const __m128i *)(prev + i));
+        __m128i c   = _mm_loadu_si128((const __m128i *)(curr + i));
+        __m128i ops = _mm_loadu_si128((const __m128i *)(map->op + i));
+        __m128i x   = _mm_xor_si128(c, p);
+        __m128i r   = sse42_delta_pick(ops, x, _mm_sub_epi8(c, p), c,
+                                       _mm_sub_epi16(c, p), _mm_sub_epi32(c, p),
+                                       sse42_rotl1(x));
+        _mm_storeu_si128((__m128i *)(out + i), r);
     }
 
-    /* TAIL region [256, len): SUB */
-    {
-        while (i + 16u <= len) {
+    if (i == NETC_DELTA_MAP_LEN) {
+        const uint32_t op = map->tail;
+        for (; i + 16u <= len; i += 16u) {
             __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
             __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
-            __m128i r = _mm_sub_epi8(c, p);
+            __m128i r = (op == NETC_DELTA_OP_XOR)   ? _mm_xor_si128(c, p)
+                      : (op == NETC_DELTA_OP_SUB)   ? _mm_sub_epi8(c, p)
+                      : (op == NETC_DELTA_OP_SUB16) ? _mm_sub_epi16(c, p)
+                      : (op == NETC_DELTA_OP_SUB32) ? _mm_sub_epi32(c, p)
+                      : (op == NETC_DELTA_OP_FLT32) ? sse42_rotl1(_mm_xor_si128(c, p))
+                      : c;
             _mm_storeu_si128((__m128i *)(out + i), r);
-            i += 16u;
-        }
-        while (i < len) {
-            out[i] = (uint8_t)(curr[i] - prev[i]);
-            i++;
         }
     }
+
+    netc_delta_encode_mapped(map, prev, curr, out, i, len);
 }
 
-void netc_delta_decode_sse42(const uint8_t *prev, const uint8_t *residual,
-                              uint8_t *out, size_t len)
+void netc_delta_decode_sse42(const netc_delta_map_t *map,
+                             const uint8_t *prev, const uint8_t *residual,
+                             uint8_t *out, size_t len)
 {
+    if (map == NULL) map = &netc_delta_map_default;
     size_t i = 0;
+    size_t mapped = len < NETC_DELTA_MAP_LEN ? len : NETC_DELTA_MAP_LEN;
 
-    /* HEADER [0, 16): XOR */
-    {
-        size_t end = len < HDR_END ? len : HDR_END;
-        while (i < end) {
-            out[i] = residual[i] ^ prev[i];
-            i++;
-        }
+    for (; i + 16u <= mapped; i += 16u) {
+        __m128i p   = _mm_loadu_si128((const __m128i *)(prev + i));
+        __m128i r   = _mm_loadu_si128((const __m128i *)(residual + i));
+        __m128i ops = _mm_loadu_si128((const __m128i *)(map->op + i));
+        __m128i c   = sse42_delta_pick(ops, _mm_xor_si128(r, p), _mm_add_epi8(r, p), r,
+                                       _mm_add_epi16(r, p), _mm_add_epi32(r, p),
+                                       _mm_xor_si128(sse42_rotr1(r), p));
+        _mm_storeu_si128((__m128i *)(out + i), c);
     }
 
-    /* SUBHEADER [16, 64): ADD */
-    {
-        size_t end = len < SUB_END ? len : SUB_END;
-        while (i + 16u <= end) {
+    if (i == NETC_DELTA_MAP_LEN) {
+        const uint32_t op = map->tail;
+        for (; i + 16u <= len; i += 16u) {
             __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
             __m128i r = _mm_loadu_si128((const __m128i *)(residual + i));
-            __m128i c = _mm_add_epi8(r, p);
+            __m128i c = (op == NETC_DELTA_OP_XOR)   ? _mm_xor_si128(r, p)
+                      : (op == NETC_DELTA_OP_SUB)   ? _mm_add_epi8(r, p)
+                      : (op == NETC_DELTA_OP_SUB16) ? _mm_add_epi16(r, p)
+                      : (op == NETC_DELTA_OP_SUB32) ? _mm_add_epi32(r, p)
+                      : (op == NETC_DELTA_OP_FLT32) ? _mm_xor_si128(sse42_rotr1(r), p)
+                      : r;
             _mm_storeu_si128((__m128i *)(out + i), c);
-            i += 16u;
         }
-        while (i < end) {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
-            i++;
+    }
+
+    netc_delta_decode_mapped(map, prev, residual, out, i, len);
+}
+
+/* =========================================================================
+ * SSE4.2 byte planes
+ *
+ * Each run is copied aside and rewritten in place. T4 transposes four u32
+ * lanes into four 4-byte planes (and is its own inverse); T2 separates the
+ * low and high bytes of eight u16 lanes, and _mm_unpacklo_epi8 interleaves
+ * them back. The scalar reference finishes the last lanes of a run.
+ * ========================================================================= */
+
+static NETC_INLINE int32_t sse42_ld32(const uint8_t *p) {
+    int32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+static NETC_INLINE void sse42_st32(uint8_t *p, int32_t v) {
+    memcpy(p, &v, 4);
+}
+
+void netc_delta_planes_split_sse42(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    const __m128i t4 = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m128i t2 = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        size_t   w   = pl->width[r];
+        uint8_t *run = buf + pl->start[r];
+        size_t   j   = 0;
+        memcpy(tmp, run, n * w);
+        if (w == 4U) {
+            for (; j + 4U <= n; j += 4U) {
+                __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(tmp + 4U * j)), t4);
+                sse42_st32(run + j,          _mm_cvtsi128_si32(v));
+                sse42_st32(run + n + j,      _mm_extract_epi32(v, 1));
+                sse42_st32(run + 2U * n + j, _mm_extract_epi32(v, 2));
+                sse42_st32(run + 3U * n + j, _mm_extract_epi32(v, 3));
+            }
+        } else {
+            for (; j + 8U <= n; j += 8U) {
+                __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(tmp + 2U * j)), t2);
+                _mm_storel_epi64((__m128i *)(run + j), v);
+                _mm_storel_epi64((__m128i *)(run + n + j), _mm_srli_si128(v, 8));
+            }
         }
+        netc_delta_planes_split(run, tmp, w, n, j);
     }
+}
 
-    /* BODY [64, 256): XOR */
-    {
-        size_t end = len < BODY_END ? len : BODY_END;
-        while (i + 16u <= end) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i r = _mm_loadu_si128((const __m128i *)(residual + i));
-            __m128i c = _mm_xor_si128(r, p);
-            _mm_storeu_si128((__m128i *)(out + i), c);
-            i += 16u;
+void netc_delta_planes_merge_sse42(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    const __m128i t4 = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    uint8_t tmp[NETC_DELTA_MAP_LEN];
+    for (uint32_t r = 0; r < pl->count; r++) {
+        size_t n = netc_delta_planes_lanes(pl, r, len);
+        if (n == 0) continue;
+        size_t   w   = pl->width[r];
+        uint8_t *run = buf + pl->start[r];
+        size_t   j   = 0;
+        memcpy(tmp, run, n * w);
+        if (w == 4U) {
+            for (; j + 4U <= n; j += 4U) {
+                __m128i v = _mm_setr_epi32(sse42_ld32(tmp + j), sse42_ld32(tmp + n + j),
+                                           sse42_ld32(tmp + 2U * n + j),
+                                           sse42_ld32(tmp + 3U * n + j));
+                _mm_storeu_si128((__m128i *)(run + 4U * j), _mm_shuffle_epi8(v, t4));
+            }
+        } else {
+            for (; j + 8U <= n; j += 8U) {
+                __m128i lo = _mm_loadl_epi64((const __m128i *)(tmp + j));
+                __m128i hi = _mm_loadl_epi64((const __m128i *)(tmp + n + j));
+                _mm_storeu_si128((__m128i *)(run + 2U * j), _mm_unpacklo_epi8(lo, hi));
+            }
         }
-        while (i < end) {
-            out[i] = residual[i] ^ prev[i];
-            i++;
+        netc_delta_planes_merge(run, tmp, w, n, j);
+    }
+}
+
+/* =========================================================================
+ * SSE4.2 equal-byte count
+ *
+ * _mm_cmpeq_epi8 yields 0xFF (-1) per equal byte; subtracting it counts
+ * matches per lane in 8 bits.  Lanes are folded with _mm_sad_epu8 every 255
+ * blocks, before any of them can wrap.
+ * ========================================================================= */
+
+uint32_t netc_match_count_sse42(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    uint64_t n = 0;
+    size_t   i = 0;
+
+    while (i + 16u <= len) {
+        __m128i acc = _mm_setzero_si128();
+        size_t  end = len - ((len - i) % 16u);
+        if (end - i > 255u * 16u) end = i + 255u * 16u;
+        for (; i < end; i += 16u) {
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(va, vb));
         }
+        __m128i sad = _mm_sad_epu8(acc, _mm_setzero_si128());
+        n += (uint64_t)_mm_cvtsi128_si32(sad)
+           + (uint64_t)_mm_extract_epi16(sad, 4);
+    }
+    for (; i < len; i++) {
+        n += (uint64_t)(a[i] == b[i]);
     }
+    return (uint32_t)n;
+}
 
-    /* TAIL [256, len): ADD */
-    {
-        while (i + 16u <= len) {
-            __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
-            __m128i r = _mm_loadu_si128((const __m128i *)(residual + i));
-            __m128i c = _mm_add_epi8(r, p);
-            _mm_storeu_si128((__m128i *)(out + i), c);
-            i += 16u;
+/* =========================================================================
+ * SSE4.2 LZP XOR filter
+ *
+ * The FNV context hashes of 4 positions are computed side by side with
+ * SSE4.1 _mm_mullo_epi32, then the entries are read one lane at a time
+ * (SSE has no gather).  Positions 0 and 1, whose contexts include the
+ * implicit 0x00 start bytes, and the last < 4 bytes take the scalar path.
+ * ========================================================================= */
+
+static NETC_INLINE __m128i sse42_fnv(__m128i h, __m128i x)
+{
+    return _mm_mullo_epi32(_mm_xor_si128(h, x), _mm_set1_epi32(16777619));
+}
+
+void netc_lzp_filter_sse42(const netc_lzp_table_t *table, int order2,
+                           const uint8_t *src, uint8_t *dst, size_t len)
+{
+    const __m128i mask = _mm_set1_epi32((int)NETC_LZP_HT_MASK);
+    const __m128i lo16 = _mm_set1_epi32(0xFFFF);
+    size_t i = (len < 2U) ? len : 2U;
+    netc_lzp_xor_filter(src, i, table, NULL, order2, dst);
+
+    for (; i + 4U <= len; i += 4U) {
+        uint32_t w1, w2, h1[4], h2[4];
+        memcpy(&w1, src + i - 1U, 4);
+        memcpy(&w2, src + i - 2U, 4);
+        __m128i prev  = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)w1));
+        __m128i prev2 = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)w2));
+        __m128i pos   = _mm_add_epi32(_mm_set1_epi32((int)i), _mm_setr_epi32(0, 1, 2, 3));
+        __m128i lo    = _mm_and_si128(pos, lo16);
+        __m128i hi    = _mm_srli_epi32(pos, 16);
+
+        __m128i h = sse42_fnv(_mm_set1_epi32((int)2166136261u), prev);
+        h = sse42_fnv(sse42_fnv(h, lo), hi);
+        _mm_storeu_si128((__m128i *)h1, _mm_and_si128(h, mask));
+        if (order2) {
+            h = sse42_fnv(sse42_fnv(_mm_set1_epi32((int)0x9E3779B9u), prev2), prev);
+            h = sse42_fnv(sse42_fnv(h, lo), hi);
+            _mm_storeu_si128((__m128i *)h2, _mm_and_si128(h, mask));
         }
-        while (i < len) {
-            out[i] = (uint8_t)(residual[i] + prev[i]);
-            i++;
+        for (size_t k = 0; k < 4U; k++) {
+            netc_lzp_entry_t e = netc_lzp_get(table, h1[k]);
+            dst[i + k] = src[i + k] ^
+                         netc_lzp_pick(e, order2 ? netc_lzp_get(table, h2[k]) : e, order2);
         }
     }
+    for (; i < len; i++) {
+        dst[i] = src[i] ^ netc_lzp_guess(table, NULL, order2, src[i - 2U], src[i - 1U],
+                                         (uint32_t)i);
+    }
 }
 
 /* =========================================================================
@@ -232,15 +360,34 @@ uint32_t netc_crc32_update_sse42(uint32_t crc, const uint8_t *data, size_t len)
 
 #else /* SSE4.2 not available at compile time — stubs that should never be called */
 
-void netc_delta_encode_sse42(const uint8_t *prev, const uint8_t *curr,
-                              uint8_t *out, size_t len)
+void netc_delta_encode_sse42(const netc_delta_map_t *map,
+                             const uint8_t *prev, const uint8_t *curr,
+                             uint8_t *out, size_t len)
+{
+    netc_delta_encode_generic(map, prev, curr, out, len);
+}
+void netc_delta_decode_sse42(const netc_delta_map_t *map,
+                             const uint8_t *prev, const uint8_t *residual,
+                             uint8_t *out, size_t len)
+{
+    netc_delta_decode_generic(map, prev, residual, out, len);
+}
+void netc_delta_planes_split_sse42(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    netc_delta_planes_split_generic(pl, buf, len);
+}
+void netc_delta_planes_merge_sse42(const netc_delta_planes_t *pl, uint8_t *buf, size_t len)
+{
+    netc_delta_planes_merge_generic(pl, buf, len);
+}
+uint32_t netc_match_count_sse42(const uint8_t *a, const uint8_t *b, size_t len)
 {
-    netc_delta_encode_generic(prev, curr, out, len);
+    return netc_match_count_generic(a, b, len);
 }
-void netc_delta_decode_sse42(const uint8_t *prev, const uint8_t *residual,
-                              uint8_t *out, size_t len)
+void netc_lzp_filter_sse42(const netc_lzp_table_t *table, int order2,
+                           const uint8_t *src, uint8_t *dst, size_t len)
 {
-    netc_delta_decode_generic(prev, residual, out, len);
+    netc_lzp_filter_generic(table, order2, src, dst, len);
 }
 void netc_freq_count_sse42(const uint8_t *data, size_t len, uint32_t *freq)
 {
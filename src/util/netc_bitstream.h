@@ -227,6 +227,72 @@ static NETC_INLINE int netc_bsr_read(netc_bsr_t *r, int nb, uint32_t *out) {
     return netc_bsr_consume(r, nb);
 }
 
+/**
+ * Top up the accumulator to at least 57 valid bits (fewer only near the
+ * start of the buffer).  Used by the interleaved decoders, which refill once
+ * and then take up to 4 symbols (4 × 12 bits) with netc_bsr_take.
+ *
+ * Loads one 8-byte word when at least 8 bytes remain instead of looping
+ * byte by byte.  Requires r->bits >= 0.
+ */
+static NETC_INLINE void netc_bsr_refill(netc_bsr_t *r) {
+    if (r->bits > 56) return;
+    if (NETC_LIKELY(r->ptr - r->start >= 8)) {
+        /* n whole bytes fit below the valid bits; ptr[-1] goes on top */
+        int n = (64 - r->bits) >> 3;
+        const uint8_t *p = r->ptr - 8;
+        uint64_t w = (uint64_t)netc_read_u32_le(p) |
+                     ((uint64_t)netc_read_u32_le(p + 4) << 32);
+        w >>= 64 - 8 * n;
+        r->accum |= w << (64 - r->bits - 8 * n);
+        r->ptr   -= n;
+        r->bits  += 8 * n;
+        return;
+    }
+    while (r->bits <= 56 && r->ptr > r->start) {
+        r->ptr--;
+        r->accum |= (uint64_t)(*r->ptr) << (56 - r->bits);
+        r->bits  += 8;
+    }
+}
+
+/**
+ * Take `nb` bits (0–32) without refilling.  nb == 0 is allowed and returns 0.
+ * r->bits goes negative on underflow; the caller checks it before the next
+ * netc_bsr_refill.
+ */
+static NETC_INLINE uint32_t netc_bsr_take(netc_bsr_t *r, int nb) {
+    uint32_t v = (uint32_t)((r->accum >> 1) >> (63 - nb));
+    r->accum <<= nb;
+    r->bits   -= nb;
+    return v;
+}
+
+/**
+ * Number of unread bits, counted from bit 0 of the buffer (LSB-first, as the
+ * writer laid them out).  The valid accumulator bits are the ones directly
+ * above r->ptr, so this is an absolute stream position.  Requires bits >= 0.
+ */
+static NETC_INLINE size_t netc_bsr_tell(const netc_bsr_t *r) {
+    return (size_t)(r->ptr - r->start) * 8U + (size_t)r->bits;
+}
+
+/**
+ * Reposition the reader so that exactly `pos` bits remain unread (the
+ * inverse of netc_bsr_tell).  Used to resume scalar decoding after a vector
+ * kernel consumed bits by position.  pos must not exceed the stream length.
+ */
+static NETC_INLINE void netc_bsr_seek(netc_bsr_t *r, size_t pos) {
+    size_t   byte = pos >> 3;
+    uint32_t rem  = (uint32_t)(pos & 7U);
+    r->ptr   = r->start + byte;
+    r->accum = 0;
+    r->bits  = (int)rem;
+    if (rem != 0U)
+        r->accum = (uint64_t)(r->start[byte] & ((1U << rem) - 1U)) << (64U - rem);
+    netc_bsr_refill(r);
+}
+
 /** Return 1 if the reader has reached or passed the start of the buffer. */
 static NETC_INLINE int netc_bsr_empty(const netc_bsr_t *r) {
     return (r->bits <= 0 && r->ptr <= r->start);
@@ -115,6 +115,24 @@
 #  define NETC_PREFETCH(ptr) ((void)(ptr))
 #endif
 
+/* =========================================================================
+ * netc_popcount32 — number of set bits
+ *
+ * The builtin is a single POPCNT when the build targets SSE4.2 or later.
+ * ========================================================================= */
+
+static NETC_INLINE uint32_t netc_popcount32(uint32_t x)
+{
+#if defined(NETC_COMPILER_GCC) || defined(NETC_COMPILER_CLANG)
+    return (uint32_t)__builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (x * 0x01010101u) >> 24;
+#endif
+}
+
 /* =========================================================================
  * NETC_STATIC_ASSERT — compile-time assertion
  * ========================================================================= */
@@ -0,0 +1,100 @@
+/**
+ * netc_thread.c — Minimal fork/join worker threads.
+ *
+ * Uses pthreads on Linux/macOS and Win32 threads on Windows.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#  define _POSIX_C_SOURCE 200809L  /* pthreads/sysconf under -std=c11 */
+#endif
+
+#include "netc_thread.h"
+#include <stdlib.h>
+
+/* =========================================================================
+ * Platform threads
+ * ========================================================================= */
+
+typedef struct {
+    netc_task_fn fn;
+    void        *arg;
+    uint32_t     tid;
+} netc_worker_t;
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+typedef HANDLE netc_thread_t;
+
+static DWORD WINAPI netc_worker_main(LPVOID p) {
+    netc_worker_t *w = (netc_worker_t *)p;
+    w->fn(w->arg, w->tid);
+    return 0;
+}
+static int netc_thread_start(netc_thread_t *t, netc_worker_t *w) {
+    *t = CreateThread(NULL, 0, netc_worker_main, w, 0, NULL);
+    return (*t == NULL) ? -1 : 0;
+}
+static void netc_thread_join(netc_thread_t t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+uint32_t netc_cpu_count(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (si.dwNumberOfProcessors > 0) ? (uint32_t)si.dwNumberOfProcessors : 1U;
+}
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+typedef pthread_t netc_thread_t;
+
+static void *netc_worker_main(void *p) {
+    netc_worker_t *w = (netc_worker_t *)p;
+    w->fn(w->arg, w->tid);
+    return NULL;
+}
+static int netc_thread_start(netc_thread_t *t, netc_worker_t *w) {
+    return pthread_create(t, NULL, netc_worker_main, w);
+}
+static void netc_thread_join(netc_thread_t t) {
+    pthread_join(t, NULL);
+}
+
+uint32_t netc_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (uint32_t)n : 1U;
+}
+#endif
+
+/* =========================================================================
+ * netc_parallel_run
+ * ========================================================================= */
+
+void netc_parallel_run(uint32_t n, netc_task_fn fn, void *arg) {
+    if (n > NETC_MAX_THREADS) n = NETC_MAX_THREADS;
+    if (n <= 1U) {
+        fn(arg, 0);
+        return;
+    }
+
+    netc_worker_t w[NETC_MAX_THREADS];
+    netc_thread_t t[NETC_MAX_THREADS];
+    uint8_t       started[NETC_MAX_THREADS];
+
+    for (uint32_t i = 1; i < n; i++) {
+        w[i].fn  = fn;
+        w[i].arg = arg;
+        w[i].tid = i;
+        started[i] = (uint8_t)(netc_thread_start(&t[i], &w[i]) == 0);
+    }
+    fn(arg, 0);
+    for (uint32_t i = 1; i < n; i++) {
+        if (started[i]) {
+            netc_thread_join(t[i]);
+        } else {
+            fn(arg, i);
+        }
+    }
+}
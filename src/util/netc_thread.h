@@ -0,0 +1,33 @@
+/**
+ * netc_thread.h — Minimal fork/join worker threads.
+ *
+ * INTERNAL HEADER — not part of the public API.
+ *
+ * pthreads on Linux/macOS, Win32 threads on Windows. Used by the dictionary
+ * trainer; the compress/decompress hot paths never create threads.
+ */
+
+#ifndef NETC_THREAD_H
+#define NETC_THREAD_H
+
+#include "netc_platform.h"
+#include <stdint.h>
+
+/** Upper bound on workers netc_parallel_run() starts. */
+#define NETC_MAX_THREADS 64U
+
+/** Worker body: tid is 0..n-1. */
+typedef void (*netc_task_fn)(void *arg, uint32_t tid);
+
+/**
+ * Run fn(arg, tid) for tid = 0..n-1 concurrently and wait for all of them.
+ * The caller runs tid 0 itself. A worker that cannot be started runs on the
+ * caller after tid 0, so the set of calls made never depends on thread
+ * availability — only their overlap does.
+ */
+void netc_parallel_run(uint32_t n, netc_task_fn fn, void *arg);
+
+/** Number of online CPUs (at least 1). */
+uint32_t netc_cpu_count(void);
+
+#endif /* NETC_THREAD_H */
@@ -10,6 +10,9 @@
  *   2. If netc_compress returns NETC_OK, the output size <= src_size + NETC_MAX_OVERHEAD.
  *   3. Round-trip: compress → decompress must reproduce the original bytes exactly.
  *   4. Stateless path round-trips identically.
+ *
+ * The first input byte selects the encoder's compression level (data[0] % 10),
+ * so every level's trial set is fuzzed.
  */
 
 #include "../include/netc.h"
@@ -18,9 +21,11 @@
 #include <string.h>
 #include <stdlib.h>
 
-static netc_ctx_t  *g_enc_ctx = NULL;
-static netc_ctx_t  *g_dec_ctx = NULL;
-static netc_dict_t *g_dict    = NULL;
+#define FUZZ_LEVELS 10
+
+static netc_ctx_t  *g_enc_ctx[FUZZ_LEVELS];
+static netc_ctx_t  *g_dec_ctx[FUZZ_LEVELS];
+static netc_dict_t *g_dict = NULL;
 
 int LLVMFuzzerInitialize(int *argc, char ***argv)
 {
@@ -44,8 +49,11 @@ int LLVMFuzzerInitialize(int *argc, char ***argv)
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
 
-    g_enc_ctx = netc_ctx_create(g_dict, &cfg);
-    g_dec_ctx = netc_ctx_create(g_dict, &cfg);
+    for (int lvl = 0; lvl < FUZZ_LEVELS; lvl++) {
+        cfg.compression_level = (uint8_t)lvl;
+        g_enc_ctx[lvl] = netc_ctx_create(g_dict, &cfg);
+        g_dec_ctx[lvl] = netc_ctx_create(g_dict, &cfg);
+    }
 
     return 0;
 }
@@ -58,13 +66,16 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
     static uint8_t comp_buf[NETC_MAX_PACKET_SIZE + NETC_MAX_OVERHEAD];
     static uint8_t decomp_buf[NETC_MAX_PACKET_SIZE];
 
+    netc_ctx_t *enc = g_enc_ctx[data[0] % FUZZ_LEVELS];
+    netc_ctx_t *dec = g_dec_ctx[data[0] % FUZZ_LEVELS];
+
     /* --- Stateful roundtrip --- */
-    if (g_enc_ctx && g_dec_ctx) {
-        netc_ctx_reset(g_enc_ctx);
-        netc_ctx_reset(g_dec_ctx);
+    if (enc && dec) {
+        netc_ctx_reset(enc);
+        netc_ctx_reset(dec);
 
         size_t comp_size = 0;
-        netc_result_t rc = netc_compress(g_enc_ctx, data, size,
+        netc_result_t rc = netc_compress(enc, data, size,
                                          comp_buf, sizeof(comp_buf), &comp_size);
         if (rc == NETC_OK) {
             /* Invariant: output bounded */
@@ -72,7 +83,7 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 
             /* Invariant: round-trip must reproduce original */
             size_t decomp_size = 0;
-            netc_result_t rc2 = netc_decompress(g_dec_ctx, comp_buf, comp_size,
+            netc_result_t rc2 = netc_decompress(dec, comp_buf, comp_size,
                                                  decomp_buf, sizeof(decomp_buf),
                                                  &decomp_size);
             if (rc2 == NETC_OK) {
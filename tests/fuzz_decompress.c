@@ -17,6 +17,10 @@
  *   2. netc_decompress never hangs (libFuzzer timeout enforces this).
  *   3. If netc_decompress returns NETC_OK, *dst_size <= dst_cap (cap respected).
  *   4. netc_decompress_stateless invariants hold identically.
+ *
+ * The first input byte selects the context's compression level (data[0] % 10):
+ * the decoder ignores it, but it decides whether the history ring exists
+ * before the first packet or is allocated by the decoder.
  */
 
 #include "../include/netc.h"
@@ -26,7 +30,9 @@
 #include <stdlib.h>
 
 /* Reuse a process-lifetime context and dictionary to avoid malloc pressure */
-static netc_ctx_t  *g_ctx  = NULL;
+#define FUZZ_LEVELS 10
+
+static netc_ctx_t  *g_ctx[FUZZ_LEVELS];
 static netc_dict_t *g_dict = NULL;
 
 /* libFuzzer initializer (called once before LLVMFuzzerTestOneInput) */
@@ -46,7 +52,10 @@ int LLVMFuzzerInitialize(int *argc, char ***argv)
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
-    g_ctx = netc_ctx_create(g_dict, &cfg);
+    for (int lvl = 0; lvl < FUZZ_LEVELS; lvl++) {
+        cfg.compression_level = (uint8_t)lvl;
+        g_ctx[lvl] = netc_ctx_create(g_dict, &cfg);
+    }
 
     return 0;
 }
@@ -59,9 +68,10 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
     size_t dst_size = 0;
 
     /* --- Stateful decompress --- */
-    if (g_ctx) {
-        netc_ctx_reset(g_ctx);
-        netc_result_t rc = netc_decompress(g_ctx, data, size,
+    netc_ctx_t *ctx = (size > 0) ? g_ctx[data[0] % FUZZ_LEVELS] : g_ctx[0];
+    if (ctx) {
+        netc_ctx_reset(ctx);
+        netc_result_t rc = netc_decompress(ctx, data, size,
                                            dst, sizeof(dst), &dst_size);
         if (rc == NETC_OK) {
             /* Invariant: dst_size must not exceed dst_cap */
@@ -7,15 +7,20 @@
  *   4.5 Mixed adaptive + non-adaptive contexts sharing same dict
  *   Additional:
  *     - Adaptive context creation requires STATEFUL
- *     - Adaptive context reset re-clones dict tables
+ *     - Adaptive context reset re-shares dict tables
+ *     - Copy-on-write: tables shared until the first rebuild, LZP updates in
+ *       a sparse overlay that matches a dense clone bit for bit
  *     - Frequency accumulators increment correctly
  *     - Table rebuild produces valid tANS tables
+ *     - Rebuilds are spread one bucket per packet, in step on both sides
+ *     - Count decay bounds the accumulators and tracks a distribution shift
  */
 
 #include "unity.h"
 #include "netc.h"
 #include "../src/core/netc_internal.h"
 #include "../src/algo/netc_tans.h"
+#include "../src/algo/netc_adaptive.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -105,6 +110,7 @@ void test_adaptive_context_creates(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE;
+    cfg.compression_level = 5;
 
     netc_ctx_t *ctx = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx);
@@ -121,6 +127,7 @@ void test_adaptive_roundtrip_sync_100_packets(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -171,6 +178,7 @@ void test_adaptive_roundtrip_500_packets(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -215,6 +223,7 @@ void test_adaptive_disabled_matches_static(void) {
     memset(&cfg_static, 0, sizeof(cfg_static));
     cfg_static.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
                      | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg_static.compression_level = 5;
 
     netc_ctx_t *enc_s = netc_ctx_create(s_dict, &cfg_static);
     netc_ctx_t *dec_s = netc_ctx_create(s_dict, &cfg_static);
@@ -276,11 +285,13 @@ void test_mixed_adaptive_and_static_same_dict(void) {
     cfg_adaptive.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
                        | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
                        | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg_adaptive.compression_level = 5;
 
     netc_cfg_t cfg_static;
     memset(&cfg_static, 0, sizeof(cfg_static));
     cfg_static.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
                      | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg_static.compression_level = 5;
 
     netc_ctx_t *enc_a = netc_ctx_create(s_dict, &cfg_adaptive);
     netc_ctx_t *dec_a = netc_ctx_create(s_dict, &cfg_adaptive);
@@ -343,6 +354,7 @@ void test_adaptive_reset_reinitializes(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -402,6 +414,7 @@ void test_adaptive_small_packets(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -442,6 +455,7 @@ void test_adaptive_large_packets(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -481,6 +495,7 @@ void test_adaptive_no_delta(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM
               | NETC_CFG_FLAG_ADAPTIVE | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
     /* Note: no DELTA flag */
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
@@ -521,6 +536,7 @@ void test_adaptive_no_bigram(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_ADAPTIVE | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
     /* Note: no BIGRAM flag */
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
@@ -562,6 +578,7 @@ void test_adaptive_rebuilt_tables_roundtrip(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(enc);
@@ -614,7 +631,7 @@ void test_adaptive_rebuilt_tables_roundtrip(void) {
         uint8_t cbuf[512];
         netc_bsw_t bsw;
         netc_bsw_init(&bsw, cbuf + 4, sizeof(cbuf) - 4);
-        uint32_t state = netc_tans_encode_pctx(enc->adapt_tables, test_data, 128,
+        uint32_t state = netc_tans_encode_pctx(enc->adapt_tables, NULL, test_data, 128,
                                                 &bsw, NETC_TANS_TABLE_SIZE);
         TEST_ASSERT_TRUE(state != 0);
         size_t bs = netc_bsw_flush(&bsw);
@@ -623,7 +640,7 @@ void test_adaptive_rebuilt_tables_roundtrip(void) {
         uint8_t dbuf[128];
         netc_bsr_t bsr;
         netc_bsr_init(&bsr, cbuf + 4, bs);
-        int drc = netc_tans_decode_pctx(enc->adapt_tables, &bsr, dbuf, 128, state);
+        int drc = netc_tans_decode_pctx(enc->adapt_tables, NULL, &bsr, dbuf, 128, state);
         TEST_ASSERT_EQUAL(0, drc);
         TEST_ASSERT_EQUAL_MEMORY(test_data, dbuf, 128);
     }
@@ -643,19 +660,31 @@ void test_adaptive_rebuilt_tables_roundtrip(void) {
  * (each 0x00 byte = a correct LZP prediction).
  * ========================================================================= */
 
-static int count_lzp_hits(const netc_lzp_entry_t *lzp, const uint8_t *data, size_t size) {
+static int count_lzp_hits(const netc_lzp_table_t *lzp, const netc_lzp_overlay_t *ovl,
+                          const uint8_t *data, size_t size) {
     int hits = 0;
     for (size_t i = 0; i < size; i++) {
         uint8_t prev = (i > 0) ? data[i - 1] : 0x00u;
-        uint32_t h = netc_lzp_hash(prev, (uint32_t)i);
-        if (lzp[h].valid && lzp[h].value == data[i])
+        netc_lzp_entry_t e = netc_lzp_at(lzp, ovl, netc_lzp_hash(prev, (uint32_t)i));
+        if (e.valid && e.value == data[i])
             hits++;
     }
     return hits;
 }
 
+/* Live LZP entries of two contexts agree in every slot */
+static void assert_lzp_in_sync(const netc_ctx_t *a, const netc_ctx_t *b) {
+    const netc_lzp_table_t    ta = netc_get_lzp_table(a), tb = netc_get_lzp_table(b);
+    const netc_lzp_overlay_t *oa = netc_get_lzp_overlay(a), *ob = netc_get_lzp_overlay(b);
+    for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
+        netc_lzp_entry_t ea = netc_lzp_at(&ta, oa, h), eb = netc_lzp_at(&tb, ob, h);
+        TEST_ASSERT_EQUAL_UINT8(ea.value, eb.value);
+        TEST_ASSERT_EQUAL_UINT8(ea.valid, eb.valid);
+    }
+}
+
 void test_adaptive_lzp_improves_hitrate(void) {
-    if (s_dict == NULL || s_dict->lzp_table == NULL) {
+    if (s_dict == NULL || s_dict->lzp_table.ent == NULL) {
         TEST_IGNORE_MESSAGE("No LZP table in dict — skipping LZP adaptive test");
         return;
     }
@@ -665,13 +694,15 @@ void test_adaptive_lzp_improves_hitrate(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(enc);
     TEST_ASSERT_NOT_NULL(dec);
-    TEST_ASSERT_NOT_NULL(enc->adapt_lzp);
-    TEST_ASSERT_NOT_NULL(dec->adapt_lzp);
+    /* Copy-on-write: both start on the dict table */
+    TEST_ASSERT_NULL(enc->adapt_lzp);
+    TEST_ASSERT_EQUAL_PTR(s_dict->lzp_table.ent, netc_get_lzp_table(enc).ent);
 
     /* Process 500 packets with a stable distribution */
     uint8_t pkt[128], comp[128 + NETC_MAX_OVERHEAD], decomp[128];
@@ -686,12 +717,16 @@ void test_adaptive_lzp_improves_hitrate(void) {
 
         /* Measure LZP hit rates at early packets (0-49) and late packets (450-499) */
         if (i < 50) {
-            dict_hits_early += count_lzp_hits(s_dict->lzp_table, pkt, 128);
-            adapt_hits_early += count_lzp_hits(enc->adapt_lzp, pkt, 128);
+            netc_lzp_table_t live = netc_get_lzp_table(enc);
+            dict_hits_early += count_lzp_hits(&s_dict->lzp_table, NULL, pkt, 128);
+            adapt_hits_early += count_lzp_hits(&live,
+                                               netc_get_lzp_overlay(enc), pkt, 128);
             early_count++;
         } else if (i >= 450) {
-            dict_hits_late += count_lzp_hits(s_dict->lzp_table, pkt, 128);
-            adapt_hits_late += count_lzp_hits(enc->adapt_lzp, pkt, 128);
+            netc_lzp_table_t live = netc_get_lzp_table(enc);
+            dict_hits_late += count_lzp_hits(&s_dict->lzp_table, NULL, pkt, 128);
+            adapt_hits_late += count_lzp_hits(&live,
+                                              netc_get_lzp_overlay(enc), pkt, 128);
             late_count++;
         }
 
@@ -712,8 +747,7 @@ void test_adaptive_lzp_improves_hitrate(void) {
         "Adaptive LZP should have >= dict hit rate after 500 packets");
 
     /* Verify enc and dec adaptive LZP tables are in sync */
-    TEST_ASSERT_EQUAL_MEMORY(enc->adapt_lzp, dec->adapt_lzp,
-                              NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+    assert_lzp_in_sync(enc, dec);
 
     netc_ctx_destroy(enc);
     netc_ctx_destroy(dec);
@@ -733,6 +767,7 @@ void test_order2_delta_roundtrip(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_ADAPTIVE | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -790,6 +825,7 @@ void test_sustained_10k_packets(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
               | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
@@ -867,11 +903,11 @@ void test_sustained_10k_packets(void) {
  * Test 4.7: Memory usage verification
  *
  * Verifies that context memory usage with all adaptive phases enabled
- * stays within documented bounds.  Computes the total allocation size
- * by summing known allocation sizes.
+ * stays within documented bounds.  Checks netc_ctx_memory_usage against
+ * the known allocation sizes.
  *
  * Note: The 512 KB target applies to contexts without LZP adaptive tables.
- * With adaptive LZP (~256 KB), total context memory is ~1 MB.
+ * With adaptive LZP (~256 KB), total context memory is ~0.9 MB.
  * ========================================================================= */
 
 void test_memory_usage_verification(void) {
@@ -884,32 +920,50 @@ void test_memory_usage_verification(void) {
     netc_ctx_t *ctx = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx);
 
-    /* Verify all expected allocations are non-NULL */
-    TEST_ASSERT_NOT_NULL(ctx->ring);
+    /* Verify the expected allocations; the delta history is allocated on
+     * the first packet, a level-0 compressor never tries LZ77X so it has no
+     * ring, and the dict tables are shared until the first rebuild */
+    TEST_ASSERT_NULL(ctx->ring);
     TEST_ASSERT_NOT_NULL(ctx->arena);
-    TEST_ASSERT_NOT_NULL(ctx->prev_pkt);
-    TEST_ASSERT_NOT_NULL(ctx->prev2_pkt);
+    TEST_ASSERT_NULL(ctx->prev_pkt);
+    TEST_ASSERT_NULL(ctx->prev2_pkt);
     TEST_ASSERT_NOT_NULL(ctx->adapt_freq);
     TEST_ASSERT_NOT_NULL(ctx->adapt_total);
-    TEST_ASSERT_NOT_NULL(ctx->adapt_tables);
+    TEST_ASSERT_NULL(ctx->adapt_tables);
+    TEST_ASSERT_NULL(ctx->adapt_lzp);
 
-    /* Calculate total memory footprint */
-    size_t mem = sizeof(netc_ctx_t);
-    mem += ctx->ring_size;                                 /* ring buffer */
-    mem += ctx->arena_size;                                /* working arena */
-    mem += NETC_MAX_PACKET_SIZE;                           /* prev_pkt */
-    mem += NETC_MAX_PACKET_SIZE;                           /* prev2_pkt */
-    mem += NETC_CTX_COUNT * 256 * sizeof(uint32_t);        /* adapt_freq */
-    mem += NETC_CTX_COUNT * sizeof(uint32_t);              /* adapt_total */
-    mem += NETC_CTX_COUNT * sizeof(netc_tans_table_t);     /* adapt_tables */
-    if (ctx->adapt_lzp) {
-        mem += NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t); /* adapt_lzp */
+    uint8_t pkt[512], cmp[512 + NETC_MAX_OVERHEAD];
+    size_t  csz = 0;
+    memset(pkt, 0x5A, sizeof(pkt));
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(ctx, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+    TEST_ASSERT_NOT_NULL(ctx->prev_pkt);
+    TEST_ASSERT_NOT_NULL(ctx->prev2_pkt);
+
+    /* Total memory footprint, as reported by the library */
+    netc_mem_usage_t mu;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_memory_usage(ctx, &mu));
+    TEST_ASSERT_EQUAL_size_t(0, mu.ring);
+    TEST_ASSERT_EQUAL_size_t(ctx->arena_size, mu.arena);
+    TEST_ASSERT_EQUAL_size_t(2u * 512u, mu.history);           /* prev + prev2 */
+    size_t adaptive = NETC_CTX_COUNT * 256 * sizeof(uint32_t)  /* adapt_freq */
+                    + NETC_CTX_COUNT * sizeof(uint32_t)        /* adapt_total */
+                    + sizeof(netc_adapt_bigram_t);             /* bigram slot counts */
+    TEST_ASSERT_NOT_NULL(ctx->adapt_bg);
+    TEST_ASSERT_NULL(ctx->adapt_bg->tables);
+    if (ctx->adapt_lzp_ovl.dirty) {
+        /* 512 bytes of updates: dirty bitmap + overlay slots at <= 1/2 load */
+        TEST_ASSERT_TRUE(ctx->adapt_lzp_ovl.cap >= 2u * ctx->adapt_lzp_ovl.count);
+        adaptive += NETC_LZP_HT_SIZE / 8u
+                  + ctx->adapt_lzp_ovl.cap * sizeof(netc_lzp_ovl_slot_t);
     }
+    TEST_ASSERT_EQUAL_size_t(adaptive, mu.adaptive);
+    TEST_ASSERT_TRUE(mu.adaptive < NETC_LZP_HT_SIZE * sizeof(netc_lzp_entry_t));
+    size_t mem = mu.total;
 
     /* Total memory should be <= 1.5 MB (reasonable for a game connection).
-     * Without adaptive LZP: ~760 KB.  With adaptive LZP: ~1020 KB.
-     * The 512 KB target from the task was aspirational and predates the
-     * addition of adaptive LZP (256 KB) and prev2_pkt (64 KB). */
+     * Fully diverged: ~600 KB without adaptive LZP, ~855 KB with it, plus
+     * ~460 KB of bigram slots and the 64 KB ring at level >= 2.  The delta history grows with the
+     * largest packet (2 x 64 KB at most). */
     size_t limit_bytes = 1536u * 1024u;  /* 1.5 MB hard limit */
     TEST_ASSERT_TRUE_MESSAGE(mem <= limit_bytes,
         "Total context memory exceeds 1.5 MB hard limit");
@@ -918,14 +972,405 @@ void test_memory_usage_verification(void) {
     TEST_ASSERT_EQUAL_UINT32(NETC_DEFAULT_RING_SIZE, ctx->ring_size);
     TEST_ASSERT_TRUE(ctx->arena_size >= NETC_MAX_PACKET_SIZE);
 
-    /* Adaptive tables should be initialized (valid) */
+    /* Active tables should be valid (the dict's until the first rebuild) */
     for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
-        TEST_ASSERT_TRUE(ctx->adapt_tables[b].valid);
+        TEST_ASSERT_TRUE(netc_get_tables(ctx)[b].valid);
     }
 
     netc_ctx_destroy(ctx);
 }
 
+/* =========================================================================
+ * Copy-on-write adaptive state
+ * ========================================================================= */
+
+static netc_ctx_t *make_adaptive_ctx(void) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
+              | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
+              | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 7;  /* tries LZP on every packet */
+    return netc_ctx_create(s_dict, &cfg);
+}
+
+void test_adaptive_cow_shares_dict_until_rebuild(void) {
+    netc_ctx_t *ctx = make_adaptive_ctx();
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ASSERT_EQUAL_PTR(s_dict->tables, netc_get_tables(ctx));
+    TEST_ASSERT_EQUAL_PTR(s_dict->lzp_table.ent, netc_get_lzp_table(ctx).ent);
+    TEST_ASSERT_NULL(netc_get_lzp_overlay(ctx));
+
+    netc_mem_usage_t mu;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_memory_usage(ctx, &mu));
+    TEST_ASSERT_EQUAL_size_t(NETC_CTX_COUNT * 257u * sizeof(uint32_t)
+                             + sizeof(netc_adapt_bigram_t), mu.adaptive);
+
+    uint8_t pkt[128], cmp[128 + NETC_MAX_OVERHEAD];
+    size_t  csz = 0;
+    s_prng_state = 4242ULL;
+    for (uint32_t i = 0; i + 1 < NETC_ADAPTIVE_INTERVAL; i++) {
+        fill_packet(pkt, sizeof(pkt), 0x41);
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(ctx, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+        if (i == 0 && s_dict->lzp_table.ent != NULL) {
+            /* First LZP updates land in the sparse overlay */
+            TEST_ASSERT_NOT_NULL(netc_get_lzp_overlay(ctx));
+            TEST_ASSERT_NULL(ctx->adapt_lzp);
+            TEST_ASSERT_TRUE(ctx->adapt_lzp_ovl.count <=
+                             (netc_lzp_order2(s_dict) ? 2u : 1u) * sizeof(pkt));
+        }
+    }
+    TEST_ASSERT_EQUAL_PTR(s_dict->tables, netc_get_tables(ctx));
+
+    /* The packet that completes the interval gets private tables */
+    fill_packet(pkt, sizeof(pkt), 0x41);
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(ctx, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+    TEST_ASSERT_NOT_NULL(ctx->adapt_tables);
+    TEST_ASSERT_EQUAL_PTR(ctx->adapt_tables, netc_get_tables(ctx));
+
+    /* Reset drops the copies and shares the dict again */
+    netc_ctx_reset(ctx);
+    TEST_ASSERT_NULL(ctx->adapt_tables);
+    TEST_ASSERT_NULL(ctx->adapt_lzp);
+    TEST_ASSERT_NULL(netc_get_lzp_overlay(ctx));
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_memory_usage(ctx, &mu));
+    TEST_ASSERT_EQUAL_size_t(NETC_CTX_COUNT * 257u * sizeof(uint32_t)
+                             + sizeof(netc_adapt_bigram_t), mu.adaptive);
+
+    netc_ctx_destroy(ctx);
+}
+
+void test_adaptive_lzp_overlay_matches_dense(void) {
+    if (s_dict == NULL || s_dict->lzp_table.ent == NULL) {
+        TEST_IGNORE_MESSAGE("No LZP table in dict — skipping LZP overlay test");
+        return;
+    }
+    /* sparse: overlay until it outgrows NETC_LZP_OVL_MAX; dense: cloned
+     * up front, as before copy-on-write.  Output must be bit-identical. */
+    netc_ctx_t *sparse = make_adaptive_ctx();
+    netc_ctx_t *dense  = make_adaptive_ctx();
+    netc_ctx_t *dec    = make_adaptive_ctx();
+    TEST_ASSERT_NOT_NULL(sparse);
+    TEST_ASSERT_NOT_NULL(dense);
+    TEST_ASSERT_NOT_NULL(dec);
+    TEST_ASSERT_EQUAL(NETC_OK, netc_adaptive_lzp_densify(dense));
+    TEST_ASSERT_NOT_NULL(dense->adapt_lzp);
+
+    static uint8_t pkt[1024], c1[1024 + NETC_MAX_OVERHEAD], c2[1024 + NETC_MAX_OVERHEAD];
+    static uint8_t back[1024];
+    int saw_overlay = 0;
+    s_prng_state = 777ULL;
+    for (int i = 0; i < 400; i++) {
+        /* Small packets first; wide noisy ones later force the fold */
+        size_t n = (i < 300) ? 128 : 1024;
+        fill_packet(pkt, n, (uint8_t)(0x44 + (i % 4)));
+        size_t s1 = 0, s2 = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(sparse, pkt, n, c1, sizeof(c1), &s1));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(dense, pkt, n, c2, sizeof(c2), &s2));
+        TEST_ASSERT_EQUAL_size_t(s2, s1);
+        TEST_ASSERT_EQUAL_MEMORY(c2, c1, s1);
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, c1, s1, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(n, dsz);
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, n);
+        if (netc_get_lzp_overlay(sparse) != NULL) {
+            saw_overlay = 1;
+            TEST_ASSERT_TRUE(sparse->adapt_lzp_ovl.count <= NETC_LZP_OVL_MAX);
+        }
+    }
+    TEST_ASSERT_TRUE(saw_overlay);
+    TEST_ASSERT_NOT_NULL(sparse->adapt_lzp);  /* folded into a dense clone */
+    assert_lzp_in_sync(sparse, dense);
+    assert_lzp_in_sync(sparse, dec);
+
+    netc_ctx_destroy(sparse);
+    netc_ctx_destroy(dense);
+    netc_ctx_destroy(dec);
+}
+
+/* =========================================================================
+ * Incremental rebuild: one bucket per packet, same packet on both sides
+ * ========================================================================= */
+
+static void snapshot_freqs(const netc_ctx_t *ctx, uint16_t out[NETC_CTX_COUNT][256]) {
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        memcpy(out[b], netc_get_tables(ctx)[b].freq.freq, 256 * sizeof(uint16_t));
+}
+
+void test_adaptive_incremental_rebuild(void) {
+    netc_ctx_t *enc = make_adaptive_ctx();
+    netc_ctx_t *dec = make_adaptive_ctx();
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    static uint16_t before[NETC_CTX_COUNT][256], after[NETC_CTX_COUNT][256];
+    static uint16_t dec_freq[NETC_CTX_COUNT][256];
+    uint8_t pkt[128], cmp[128 + NETC_MAX_OVERHEAD], back[128];
+    s_prng_state = 31337ULL;
+
+    for (uint32_t i = 1; i <= 2U * NETC_ADAPTIVE_INTERVAL; i++) {
+        /* Skewed toward one byte per interval so every rebuild changes */
+        fill_packet(pkt, sizeof(pkt), (uint8_t)(0x30 + i / NETC_ADAPTIVE_INTERVAL));
+        snapshot_freqs(enc, before);
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, sizeof(pkt));
+
+        /* The first rebuild is built behind the dict tables and switched
+         * in whole by the packet that completes the interval */
+        if (i < NETC_ADAPTIVE_INTERVAL) {
+            TEST_ASSERT_EQUAL_PTR(s_dict->tables, netc_get_tables(enc));
+            TEST_ASSERT_EQUAL_PTR(s_dict->tables, netc_get_tables(dec));
+            TEST_ASSERT_EQUAL(i > NETC_ADAPTIVE_REBUILD_START, enc->adapt_tables != NULL);
+            continue;
+        }
+        TEST_ASSERT_EQUAL_PTR(enc->adapt_tables, netc_get_tables(enc));
+        TEST_ASSERT_EQUAL_PTR(dec->adapt_tables, netc_get_tables(dec));
+
+        /* Both sides hold the same tables after every packet */
+        snapshot_freqs(enc, after);
+        snapshot_freqs(dec, dec_freq);
+        TEST_ASSERT_EQUAL_MEMORY(after, dec_freq, sizeof(after));
+        if (i == NETC_ADAPTIVE_INTERVAL) continue;
+
+        /* Afterwards only the bucket scheduled for this packet may change */
+        uint32_t k = i % NETC_ADAPTIVE_INTERVAL;
+        if (k == 0) k = NETC_ADAPTIVE_INTERVAL;
+        int changed = 0;
+        for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+            int differs = memcmp(before[b], after[b], sizeof(before[b])) != 0;
+            if (k > NETC_ADAPTIVE_REBUILD_START &&
+                b == k - NETC_ADAPTIVE_REBUILD_START - 1U) {
+                changed += differs;
+            } else {
+                TEST_ASSERT_FALSE(differs);
+            }
+        }
+        if (k > NETC_ADAPTIVE_REBUILD_START) TEST_ASSERT_EQUAL_INT(1, changed);
+    }
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+/* =========================================================================
+ * Count decay (netc_cfg_t.adaptive_decay)
+ * ========================================================================= */
+
+static netc_ctx_t *make_decay_ctx(uint8_t decay) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA
+              | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE
+              | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.adaptive_decay = decay;
+    cfg.compression_level = 5;
+    return netc_ctx_create(s_dict, &cfg);
+}
+
+/* Code n packets biased toward 'bias' through enc/dec; returns the
+ * compressed bytes. */
+static size_t run_phase(netc_ctx_t *enc, netc_ctx_t *dec, uint32_t n, uint8_t bias) {
+    uint8_t pkt[128], cmp[128 + NETC_MAX_OVERHEAD], back[128];
+    size_t total = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        fill_packet(pkt, sizeof(pkt), bias);
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, sizeof(pkt));
+        total += csz;
+    }
+    return total;
+}
+
+void test_adaptive_decay_bounds_counts(void) {
+    netc_ctx_t *enc  = make_decay_ctx(0);   /* default: halve per rebuild */
+    netc_ctx_t *dec  = make_decay_ctx(0);
+    netc_ctx_t *encn = make_decay_ctx(NETC_ADAPTIVE_DECAY_NONE);
+    netc_ctx_t *decn = make_decay_ctx(NETC_ADAPTIVE_DECAY_NONE);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(encn);
+    TEST_ASSERT_EQUAL_UINT8(NETC_ADAPTIVE_DECAY_DEFAULT, enc->adapt_decay);
+    TEST_ASSERT_EQUAL_UINT8(0, encn->adapt_decay);
+
+    s_prng_state = 2024ULL;
+    run_phase(enc, dec, 16U * NETC_ADAPTIVE_INTERVAL, 0x41);
+    s_prng_state = 2024ULL;
+    run_phase(encn, decn, 16U * NETC_ADAPTIVE_INTERVAL, 0x41);
+
+    /* Halving every interval keeps each bucket below twice one
+     * interval's bytes; without decay the counts keep every byte */
+    uint64_t sum = 0, sum_none = 0;
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        TEST_ASSERT_TRUE(enc->adapt_total[b] <= 2U * NETC_ADAPTIVE_INTERVAL * 128U);
+        TEST_ASSERT_EQUAL_UINT32(enc->adapt_total[b], dec->adapt_total[b]);
+        sum += enc->adapt_total[b];
+        sum_none += encn->adapt_total[b];
+    }
+    TEST_ASSERT_EQUAL_MEMORY(enc->adapt_freq, dec->adapt_freq,
+                             NETC_CTX_COUNT * 256 * sizeof(uint32_t));
+    TEST_ASSERT_EQUAL_UINT64(16ULL * NETC_ADAPTIVE_INTERVAL * 128U, sum_none);
+    TEST_ASSERT_TRUE(sum < sum_none);
+
+    /* Without decay, counts near overflow are halved at the rebuild */
+    encn->adapt_freq[0]  = NETC_ADAPTIVE_SAT;
+    encn->adapt_total[0] = NETC_ADAPTIVE_SAT;
+    for (int s = 1; s < 256; s++) encn->adapt_freq[s] = 0;
+    netc_adaptive_bucket_rebuild(encn, 0);
+    TEST_ASSERT_EQUAL_UINT32(NETC_ADAPTIVE_SAT / 2U, encn->adapt_total[0]);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    netc_ctx_destroy(encn);
+    netc_ctx_destroy(decn);
+}
+
+void test_adaptive_decay_tracks_drift(void) {
+    netc_ctx_t *enc  = make_decay_ctx(0);
+    netc_ctx_t *dec  = make_decay_ctx(0);
+    netc_ctx_t *encn = make_decay_ctx(NETC_ADAPTIVE_DECAY_NONE);
+    netc_ctx_t *decn = make_decay_ctx(NETC_ADAPTIVE_DECAY_NONE);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(encn);
+
+    /* A long first phase, then a shift to a different dominant byte */
+    s_prng_state = 555ULL;
+    run_phase(enc, dec, 24U * NETC_ADAPTIVE_INTERVAL, 0x41);
+    run_phase(enc, dec, 4U * NETC_ADAPTIVE_INTERVAL, 0xC3);
+    size_t decayed = run_phase(enc, dec, 2U * NETC_ADAPTIVE_INTERVAL, 0xC3);
+
+    s_prng_state = 555ULL;
+    run_phase(encn, decn, 24U * NETC_ADAPTIVE_INTERVAL, 0x41);
+    run_phase(encn, decn, 4U * NETC_ADAPTIVE_INTERVAL, 0xC3);
+    size_t frozen = run_phase(encn, decn, 2U * NETC_ADAPTIVE_INTERVAL, 0xC3);
+
+    TEST_ASSERT_TRUE(decayed < frozen);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    netc_ctx_destroy(encn);
+    netc_ctx_destroy(decn);
+}
+
+/* =========================================================================
+ * Adaptive bigram slots
+ * ========================================================================= */
+
+/* Fixed template with bursts of noise at random offsets: after the LZP
+ * filter the stream is runs of zeros and runs of misses, which only the
+ * previous-byte context sees.  'mask' bounds the noise. */
+static void fill_burst_packet(uint8_t *buf, size_t size, int bursts, uint8_t mask) {
+    for (size_t i = 0; i < size; i++)
+        buf[i] = (uint8_t)(i * 7U + 3U);
+    for (int b = 0; b < bursts; b++) {
+        uint64_t r = splitmix64();
+        size_t at = (size_t)(r % size);
+        for (size_t i = at; i < at + 12U && i < size; i++) {
+            r = splitmix64();
+            buf[i] ^= (uint8_t)(1U + (r & mask));
+        }
+    }
+}
+
+
+/* Pairs served by a slot table (the rest code with the dict); checks that
+ * dec resolves every pair to the same dict table or slot as enc. */
+static uint32_t assert_bigram_in_sync(const netc_dict_t *dict,
+                                      const netc_ctx_t *enc, const netc_ctx_t *dec) {
+    const netc_adapt_bigram_t *a = enc->adapt_bg, *b = dec->adapt_bg;
+    TEST_ASSERT_EQUAL_MEMORY(a->pair_total, b->pair_total, sizeof(a->pair_total));
+    TEST_ASSERT_EQUAL_MEMORY(a->pair_slot, b->pair_slot, sizeof(a->pair_slot));
+    TEST_ASSERT_EQUAL_MEMORY(a->freq, b->freq, sizeof(a->freq));
+    uint32_t adapted = 0;
+    for (uint32_t k = 0; k < NETC_CTX_COUNT; k++) {
+        for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c++) {
+            const netc_tans_table_t *ta = netc_get_bigram(enc)->t[k][c];
+            const netc_tans_table_t *tb = netc_get_bigram(dec)->t[k][c];
+            if (ta == &dict->bigram_tables[k][c]) {
+                TEST_ASSERT_EQUAL_PTR(ta, tb);
+                continue;
+            }
+            TEST_ASSERT_EQUAL_INT(ta - a->tables, tb - b->tables);
+            TEST_ASSERT_EQUAL_MEMORY(ta->freq.freq, tb->freq.freq, sizeof(ta->freq.freq));
+            adapted++;
+        }
+    }
+    return adapted;
+}
+
+static void run_burst_phase(netc_ctx_t *enc, netc_ctx_t *dec, uint32_t n,
+                            int bursts, uint8_t mask) {
+    uint8_t pkt[128], cmp[128 + NETC_MAX_OVERHEAD], back[128];
+    for (uint32_t i = 0; i < n; i++) {
+        fill_burst_packet(pkt, sizeof(pkt), bursts, mask);
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, sizeof(pkt));
+    }
+}
+
+void test_adaptive_bigram_slots_follow_drift(void) {
+    s_prng_state = 777ULL;
+    for (size_t i = 0; i < TRAIN_COUNT; i++)
+        fill_burst_packet(s_train_ptrs[i], TRAIN_PKT_SIZE, 3, 0xFE);
+    netc_dict_t *dict = NULL;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_dict_train((const uint8_t * const *)s_train_ptrs,
+                                               s_train_sizes, TRAIN_COUNT, 1, &dict));
+    TEST_ASSERT_TRUE(dict->bigram_tables[0][0].valid);
+
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    /* The ramp packets repeat all over the ring, where LZ77X would beat
+     * the bigram coder that feeds the slots */
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE |
+                NETC_CFG_FLAG_NO_LZ77X;
+    cfg.compression_level = 5;  /* bigram trials start at level 2 */
+    netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+    TEST_ASSERT_NOT_NULL(enc->adapt_bg);
+    TEST_ASSERT_NULL(enc->adapt_bg->tables);
+    TEST_ASSERT_EQUAL_MEMORY(&dict->bigram_set, netc_get_bigram(enc),
+                             sizeof(netc_bigram_set_t));
+
+    /* The first interval only ranks the pairs; slot tables are first
+     * rebuilt in the second */
+    run_burst_phase(enc, dec, NETC_ADAPTIVE_INTERVAL, 3, 0xFE);
+    TEST_ASSERT_EQUAL_UINT32(0, assert_bigram_in_sync(dict, enc, dec));
+
+    run_burst_phase(enc, dec, 8U * NETC_ADAPTIVE_INTERVAL, 6, 0x03);
+    uint32_t adapted = assert_bigram_in_sync(dict, enc, dec);
+    TEST_ASSERT_TRUE(adapted > 0);
+    TEST_ASSERT_TRUE(adapted <= NETC_ADAPTIVE_BG_SLOTS);
+
+    /* The budget is fixed: counts for the slots and one table per slot */
+    netc_mem_usage_t mu;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_memory_usage(enc, &mu));
+    TEST_ASSERT_NOT_NULL(enc->adapt_bg->tables);
+    TEST_ASSERT_TRUE(mu.adaptive >= sizeof(netc_adapt_bigram_t)
+                                  + NETC_ADAPTIVE_BG_SLOTS * sizeof(netc_tans_table_t));
+
+    /* Reset shares the dict bigram tables again */
+    netc_ctx_reset(enc);
+    TEST_ASSERT_NULL(enc->adapt_bg->tables);
+    TEST_ASSERT_EQUAL_MEMORY(&dict->bigram_set, netc_get_bigram(enc),
+                             sizeof(netc_bigram_set_t));
+
+    /* Without BIGRAM there is nothing to adapt */
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_ADAPTIVE;
+    netc_ctx_t *uni = netc_ctx_create(dict, &cfg);
+    TEST_ASSERT_NOT_NULL(uni);
+    TEST_ASSERT_NULL(uni->adapt_bg);
+
+    netc_ctx_destroy(uni);
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    netc_dict_free(dict);
+}
+
 /* =========================================================================
  * Unity main
  * ========================================================================= */
@@ -948,6 +1393,12 @@ int main(void) {
     RUN_TEST(test_order2_delta_roundtrip);
     RUN_TEST(test_sustained_10k_packets);
     RUN_TEST(test_memory_usage_verification);
+    RUN_TEST(test_adaptive_cow_shares_dict_until_rebuild);
+    RUN_TEST(test_adaptive_lzp_overlay_matches_dense);
+    RUN_TEST(test_adaptive_incremental_rebuild);
+    RUN_TEST(test_adaptive_decay_bounds_counts);
+    RUN_TEST(test_adaptive_decay_tracks_drift);
+    RUN_TEST(test_adaptive_bigram_slots_follow_drift);
 
     /* Cleanup shared dict */
     if (s_dict) { netc_dict_free(s_dict); s_dict = NULL; }
@@ -5,7 +5,7 @@
  * boundary conditions, and error paths.
  *
  * Coverage target: all netc_result_t codes, all NULL/invalid argument paths,
- * context lifecycle, dictionary lifecycle.
+ * context lifecycle and memory usage, dictionary lifecycle.
  */
 
 #include "unity.h"
@@ -207,6 +207,294 @@ void test_ctx_stats_with_flag(void) {
     netc_ctx_destroy(ctx);
 }
 
+/* =========================================================================
+ * netc_ctx_memory_usage
+ * ========================================================================= */
+
+static size_t mem_total(const netc_ctx_t *ctx, netc_mem_usage_t *mu) {
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_ctx_memory_usage(ctx, mu));
+    TEST_ASSERT_EQUAL_size_t(mu->ctx + mu->history + mu->ring + mu->arena +
+                             mu->adaptive, mu->total);
+    return mu->total;
+}
+
+static void roundtrip(netc_ctx_t *enc, netc_ctx_t *dec, size_t n, uint8_t fill) {
+    static uint8_t src[2048], cmp[2048 + NETC_MAX_OVERHEAD], out[2048];
+    for (size_t i = 0; i < n; i++) src[i] = (uint8_t)(fill + (i & 7u));
+    size_t csz = 0, dsz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_compress(enc, src, n, cmp, sizeof(cmp), &csz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_decompress(dec, cmp, csz, out, sizeof(out), &dsz));
+    TEST_ASSERT_EQUAL_size_t(n, dsz);
+    TEST_ASSERT_EQUAL_MEMORY(src, out, n);
+}
+
+void test_ctx_memory_usage_null_args(void) {
+    netc_mem_usage_t mu;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_CTX_NULL, netc_ctx_memory_usage(NULL, &mu));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_ctx_memory_usage(g_ctx, NULL));
+}
+
+void test_ctx_memory_usage_history_grows_on_demand(void) {
+    netc_cfg_t cfg = { .flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA,
+                       .compression_level = 5 };
+    netc_ctx_t *enc = netc_ctx_create(g_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(g_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    netc_mem_usage_t mu;
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(0, mu.history);
+    TEST_ASSERT_EQUAL_size_t(64u * 1024u, mu.ring);   /* level 5 tries LZ77X */
+    TEST_ASSERT_TRUE(mu.arena > 0);
+    TEST_ASSERT_EQUAL_size_t(0, mu.adaptive);
+
+    roundtrip(enc, dec, 100, 0x10);
+    roundtrip(enc, dec, 100, 0x11);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(128, mu.history);
+    mem_total(dec, &mu);
+    TEST_ASSERT_EQUAL_size_t(128, mu.history);
+
+    roundtrip(enc, dec, 1500, 0x20);
+    roundtrip(enc, dec, 1500, 0x21);
+    roundtrip(enc, dec, 40, 0x22);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(2048, mu.history);
+
+    /* Reset keeps the capacity */
+    netc_ctx_reset(enc);
+    netc_ctx_reset(dec);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(2048, mu.history);
+    roundtrip(enc, dec, 700, 0x30);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+void test_ctx_memory_usage_adaptive_history_pair(void) {
+    netc_cfg_t cfg = { .flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA |
+                                NETC_CFG_FLAG_ADAPTIVE };
+    netc_ctx_t *enc = netc_ctx_create(g_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(g_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    for (int i = 0; i < 8; i++)
+        roundtrip(enc, dec, 64, (uint8_t)i);
+    netc_mem_usage_t mu;
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(2u * 64u, mu.history);  /* prev + prev2 */
+    TEST_ASSERT_TRUE(mu.adaptive > 0);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+void test_ctx_ring_only_with_lz77x(void) {
+    netc_mem_usage_t mu;
+
+    /* Opt-out: no ring on either side, and nothing to allocate later */
+    netc_cfg_t off = { .flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_NO_LZ77X,
+                       .compression_level = 9 };
+    netc_ctx_t *enc = netc_ctx_create(g_dict, &off);
+    netc_ctx_t *dec = netc_ctx_create(g_dict, &off);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+    for (int i = 0; i < 4; i++)
+        roundtrip(enc, dec, 600, 0x40);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(0, mu.ring);
+    mem_total(dec, &mu);
+    TEST_ASSERT_EQUAL_size_t(0, mu.ring);
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+
+    /* Level 0 never tries LZ77X: the ring appears on first decompress only */
+    netc_cfg_t l0 = { .flags = NETC_CFG_FLAG_STATEFUL };
+    enc = netc_ctx_create(g_dict, &l0);
+    dec = netc_ctx_create(g_dict, &l0);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+    mem_total(dec, &mu);
+    TEST_ASSERT_EQUAL_size_t(0, mu.ring);
+    roundtrip(enc, dec, 200, 0x50);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(0, mu.ring);
+    mem_total(dec, &mu);
+    TEST_ASSERT_EQUAL_size_t(64u * 1024u, mu.ring);
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+void test_ctx_lzx_index_on_first_compress(void) {
+    netc_cfg_t cfg = { .flags = NETC_CFG_FLAG_STATEFUL, .compression_level = 5 };
+    netc_ctx_t *enc = netc_ctx_create(g_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(g_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+    const size_t ring  = 64u * 1024u;
+    const size_t index = 8192u * sizeof(uint32_t) + 65536u * sizeof(uint16_t);
+
+    /* The match index is compressor-only: added on the first compress */
+    netc_mem_usage_t mu;
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(ring, mu.ring);
+    roundtrip(enc, dec, 300, 0x60);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(ring + index, mu.ring);
+    mem_total(dec, &mu);
+    TEST_ASSERT_EQUAL_size_t(ring, mu.ring);
+
+    /* Reset keeps it; the stream still round-trips */
+    netc_ctx_reset(enc);
+    netc_ctx_reset(dec);
+    mem_total(enc, &mu);
+    TEST_ASSERT_EQUAL_size_t(ring + index, mu.ring);
+    roundtrip(enc, dec, 300, 0x60);
+    roundtrip(enc, dec, 300, 0x61);
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+void test_ctx_shared_arena(void) {
+    static uint8_t arena[2u * 65535u + 64u];
+    netc_cfg_t cfg = { .flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA,
+                       .compression_level = 5,
+                       .arena = arena, .arena_size = sizeof(arena) };
+    netc_ctx_t *ctx[4];
+    for (int k = 0; k < 4; k++) {
+        ctx[k] = netc_ctx_create(g_dict, &cfg);
+        TEST_ASSERT_NOT_NULL(ctx[k]);
+    }
+    netc_mem_usage_t mu;
+    mem_total(ctx[0], &mu);
+    TEST_ASSERT_EQUAL_size_t(0, mu.arena);
+
+    /* Two connections interleaved on one thread, all four contexts borrowing
+     * the same arena */
+    for (int i = 0; i < 16; i++) {
+        roundtrip(ctx[0], ctx[1], 300, (uint8_t)i);
+        roundtrip(ctx[2], ctx[3], 900, (uint8_t)(0x80 + i));
+    }
+    for (int k = 0; k < 4; k++)
+        netc_ctx_destroy(ctx[k]);
+
+    /* A borrowed arena needs its size */
+    netc_cfg_t bad = { .flags = NETC_CFG_FLAG_STATEFUL, .arena = arena };
+    TEST_ASSERT_NULL(netc_ctx_create(g_dict, &bad));
+}
+
+/* =========================================================================
+ * netc_scratch_t / netc_compress_ex / netc_decompress_ex
+ * ========================================================================= */
+
+void test_scratch_create_destroy(void) {
+    netc_scratch_t *s = netc_scratch_create(0);
+    TEST_ASSERT_NOT_NULL(s);
+    netc_scratch_destroy(s);
+    s = netc_scratch_create(4096);
+    TEST_ASSERT_NOT_NULL(s);
+    netc_scratch_destroy(s);
+    netc_scratch_destroy(NULL);
+}
+
+void test_ex_null_args(void) {
+    netc_scratch_t *s = netc_scratch_create(0);
+    uint8_t buf[128];
+    size_t n = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_CTX_NULL,
+        netc_compress_ex(NULL, s, SAMPLE_PACKET, 64, buf, sizeof(buf), &n));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_CTX_NULL,
+        netc_decompress_ex(NULL, s, buf, 8, buf, sizeof(buf), &n));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_compress_ex(g_ctx, s, NULL, 64, buf, sizeof(buf), &n));
+    /* A context with its own arena accepts a NULL scratch */
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_compress_ex(g_ctx, NULL, SAMPLE_PACKET, 64, buf, sizeof(buf), &n));
+    netc_scratch_destroy(s);
+}
+
+void test_external_scratch_requires_ex(void) {
+    netc_cfg_t cfg = { .flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_EXTERNAL_SCRATCH,
+                       .compression_level = 5 };
+    netc_ctx_t *ctx = netc_ctx_create(g_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+
+    netc_mem_usage_t mu;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_ctx_memory_usage(ctx, &mu));
+    TEST_ASSERT_EQUAL_size_t(0, mu.arena);
+
+    uint8_t buf[128];
+    size_t n = 0, off[2];
+    const void *srcs[1] = { SAMPLE_PACKET };
+    size_t      sizes[1] = { sizeof(SAMPLE_PACKET) };
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_compress(ctx, SAMPLE_PACKET, 64, buf, sizeof(buf), &n));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_compress_ex(ctx, NULL, SAMPLE_PACKET, 64, buf, sizeof(buf), &n));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_compress_batch(ctx, srcs, sizes, 1, buf, sizeof(buf), off, NULL));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_decompress(ctx, buf, 8, buf, sizeof(buf), &n));
+    netc_ctx_destroy(ctx);
+}
+
+void test_scratch_shared_output_identical(void) {
+    /* Three connections on one "worker": private-arena contexts vs
+     * external-scratch contexts sharing one scratch, interleaved */
+    enum { CONNS = 3, PKTS = 40 };
+    netc_cfg_t priv = { .flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA |
+                                 NETC_CFG_FLAG_COMPACT_HDR,
+                        .compression_level = 9 };
+    netc_cfg_t ext  = priv;
+    ext.flags |= NETC_CFG_FLAG_EXTERNAL_SCRATCH;
+
+    netc_scratch_t *s = netc_scratch_create(0);
+    TEST_ASSERT_NOT_NULL(s);
+    netc_ctx_t *pe[CONNS], *xe[CONNS], *xd[CONNS];
+    for (int c = 0; c < CONNS; c++) {
+        pe[c] = netc_ctx_create(g_dict, &priv);
+        xe[c] = netc_ctx_create(g_dict, &ext);
+        xd[c] = netc_ctx_create(g_dict, &ext);
+        TEST_ASSERT_NOT_NULL(pe[c]);
+        TEST_ASSERT_NOT_NULL(xe[c]);
+        TEST_ASSERT_NOT_NULL(xd[c]);
+    }
+
+    static uint8_t src[1200], a[1200 + NETC_MAX_OVERHEAD],
+                   b[1200 + NETC_MAX_OVERHEAD], out[1200];
+    uint32_t rng = 12345u;
+    for (int i = 0; i < PKTS; i++) {
+        for (int c = 0; c < CONNS; c++) {
+            size_t n = 64u + (size_t)c * 400u + (size_t)(i % 5) * 50u;
+            for (size_t k = 0; k < n; k++) {
+                rng = rng * 1103515245u + 12345u;
+                src[k] = (k % 8u < 5u) ? SAMPLE_PACKET[k % 64u]
+                                       : (uint8_t)(rng >> 24);
+            }
+            size_t na = 0, nb = 0, nd = 0;
+            TEST_ASSERT_EQUAL_INT(NETC_OK,
+                netc_compress(pe[c], src, n, a, sizeof(a), &na));
+            TEST_ASSERT_EQUAL_INT(NETC_OK,
+                netc_compress_ex(xe[c], s, src, n, b, sizeof(b), &nb));
+            TEST_ASSERT_EQUAL_size_t(na, nb);
+            TEST_ASSERT_EQUAL_MEMORY(a, b, na);
+            TEST_ASSERT_EQUAL_INT(NETC_OK,
+                netc_decompress_ex(xd[c], s, b, nb, out, sizeof(out), &nd));
+            TEST_ASSERT_EQUAL_size_t(n, nd);
+            TEST_ASSERT_EQUAL_MEMORY(src, out, n);
+        }
+    }
+    for (int c = 0; c < CONNS; c++) {
+        netc_ctx_destroy(pe[c]);
+        netc_ctx_destroy(xe[c]);
+        netc_ctx_destroy(xd[c]);
+    }
+    netc_scratch_destroy(s);
+}
+
 /* =========================================================================
  * netc_dict_train
  * ========================================================================= */
@@ -544,6 +832,16 @@ int main(void) {
     RUN_TEST(test_ctx_stats_null_ctx);
     RUN_TEST(test_ctx_stats_null_out);
     RUN_TEST(test_ctx_stats_with_flag);
+    RUN_TEST(test_ctx_memory_usage_null_args);
+    RUN_TEST(test_ctx_memory_usage_history_grows_on_demand);
+    RUN_TEST(test_ctx_memory_usage_adaptive_history_pair);
+    RUN_TEST(test_ctx_ring_only_with_lz77x);
+    RUN_TEST(test_ctx_lzx_index_on_first_compress);
+    RUN_TEST(test_ctx_shared_arena);
+    RUN_TEST(test_scratch_create_destroy);
+    RUN_TEST(test_ex_null_args);
+    RUN_TEST(test_external_scratch_requires_ex);
+    RUN_TEST(test_scratch_shared_output_identical);
 
     /* Dictionary */
     RUN_TEST(test_dict_train_basic);
@@ -0,0 +1,379 @@
+/**
+ * test_baseline.c -- Acknowledged-baseline mode (NETC_CFG_FLAG_BASELINE).
+ *
+ * Tests:
+ *   - In-order round trip with immediate acks (legacy and compact headers);
+ *     acked streams compress smaller than unacked ones
+ *   - Lossy, lagged-ack channel: every delivered packet decodes, and the
+ *     stream compresses smaller than netc_compress_stateless
+ *   - Reordered delivery decodes every packet
+ *   - A delta packet whose baseline the receiver never got fails with
+ *     NETC_ERR_CORRUPT and leaves the context usable
+ *   - netc_ack / netc_ctx_last_seq argument and window checks
+ *   - Flag interplay: ADAPTIVE / DELTA_REFS rejected, inert without DELTA
+ *   - netc_ctx_reset forgets acks and kept packets
+ */
+
+#include "unity.h"
+#include "netc.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * PRNG (splitmix64) for deterministic test data
+ * ========================================================================= */
+
+static uint64_t s_prng_state;
+
+static uint64_t splitmix64(void) {
+    uint64_t z = (s_prng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Snapshot of a slowly moving game state: most bytes follow the tick, a
+ * few change at random.  Packets a few ticks apart stay similar. */
+#define PKT_SIZE 128
+
+static void fill_snapshot(uint8_t *buf, uint32_t tick) {
+    for (size_t i = 0; i < PKT_SIZE; i++) {
+        buf[i] = (uint8_t)(i * 13u + ((i % 8u == 0) ? tick : tick / 16u));
+    }
+    for (int k = 0; k < 4; k++) {
+        uint64_t r = splitmix64();
+        buf[r % PKT_SIZE] = (uint8_t)(r >> 32);
+    }
+}
+
+/* =========================================================================
+ * Shared fixtures
+ * ========================================================================= */
+
+#define TRAIN_COUNT 256
+#define STREAM_N    400
+
+static netc_dict_t *s_dict = NULL;
+static uint8_t      s_pkts[STREAM_N][PKT_SIZE];
+
+void setUp(void) {
+    if (s_dict == NULL) {
+        static uint8_t  storage[TRAIN_COUNT][PKT_SIZE];
+        static uint8_t *ptrs[TRAIN_COUNT];
+        static size_t   sizes[TRAIN_COUNT];
+        s_prng_state = 0xBA5E1ULL;
+        for (size_t i = 0; i < TRAIN_COUNT; i++) {
+            fill_snapshot(storage[i], (uint32_t)i);
+            ptrs[i]  = storage[i];
+            sizes[i] = PKT_SIZE;
+        }
+        netc_result_t r = netc_dict_train((const uint8_t * const *)ptrs,
+                                          sizes, TRAIN_COUNT, 9, &s_dict);
+        TEST_ASSERT_EQUAL(NETC_OK, r);
+    }
+    s_prng_state = 0x5EEDULL;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        fill_snapshot(s_pkts[i], (uint32_t)(1000u + i));
+    }
+}
+
+void tearDown(void) {}
+
+static netc_ctx_t *make_ctx(uint32_t extra) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA |
+                NETC_CFG_FLAG_BASELINE | extra;
+    cfg.compression_level = 5;
+    return netc_ctx_create(s_dict, &cfg);
+}
+
+typedef struct {
+    uint8_t data[PKT_SIZE + NETC_MAX_OVERHEAD];
+    size_t  size;
+    size_t  index;  /* position in s_pkts */
+} wire_pkt_t;
+
+/* =========================================================================
+ * Round trips
+ * ========================================================================= */
+
+static size_t run_in_order(uint32_t extra, int ack) {
+    netc_ctx_t *enc = make_ctx(extra);
+    netc_ctx_t *dec = make_ctx(extra);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    size_t total = 0;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        wire_pkt_t w;
+        uint8_t out[PKT_SIZE];
+        size_t  out_size = 0;
+        uint8_t seq = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[i], PKT_SIZE,
+                                                 w.data, sizeof(w.data), &w.size));
+        TEST_ASSERT_TRUE(w.size <= netc_compress_bound(PKT_SIZE));
+        total += w.size;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, w.data, w.size,
+                                                   out, sizeof(out), &out_size));
+        TEST_ASSERT_EQUAL_size_t(PKT_SIZE, out_size);
+        TEST_ASSERT_EQUAL_MEMORY(s_pkts[i], out, PKT_SIZE);
+
+        TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_last_seq(dec, &seq));
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)i, seq);
+        if (ack) TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, seq));
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return total;
+}
+
+void test_baseline_in_order_roundtrip(void) {
+    size_t acked   = run_in_order(0, 1);
+    size_t unacked = run_in_order(0, 0);
+    TEST_ASSERT_TRUE(acked < unacked);
+}
+
+void test_baseline_in_order_roundtrip_compact(void) {
+    size_t acked   = run_in_order(NETC_CFG_FLAG_COMPACT_HDR, 1);
+    size_t unacked = run_in_order(NETC_CFG_FLAG_COMPACT_HDR, 0);
+    TEST_ASSERT_TRUE(acked < unacked);
+}
+
+/* 25% loss, acks arrive 3 packets late, and acks of lost packets never
+ * arrive.  Every delivered packet must decode. */
+static size_t run_lossy(uint32_t extra) {
+    netc_ctx_t *enc = make_ctx(extra);
+    netc_ctx_t *dec = make_ctx(extra);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    enum { LAG = 3 };
+    int     pending[STREAM_N];
+    uint8_t pending_seq[STREAM_N];
+    memset(pending, 0, sizeof(pending));
+
+    size_t total = 0;
+    uint64_t loss = 0x1055ULL;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        if (i >= LAG && pending[i - LAG]) {
+            TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, pending_seq[i - LAG]));
+        }
+        wire_pkt_t w;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[i], PKT_SIZE,
+                                                 w.data, sizeof(w.data), &w.size));
+        total += w.size;
+
+        loss = loss * 6364136223846793005ULL + 1442695040888963407ULL;
+        if ((loss >> 60) < 4u) continue;  /* lost: 4/16 */
+
+        uint8_t out[PKT_SIZE];
+        size_t  out_size = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, w.data, w.size,
+                                                   out, sizeof(out), &out_size));
+        TEST_ASSERT_EQUAL_MEMORY(s_pkts[i], out, PKT_SIZE);
+        TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_last_seq(dec, &pending_seq[i]));
+        pending[i] = 1;
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return total;
+}
+
+void test_baseline_lossy_channel(void) {
+    size_t stateless = 0;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        uint8_t buf[PKT_SIZE + NETC_MAX_OVERHEAD];
+        size_t  sz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress_stateless(s_dict, s_pkts[i], PKT_SIZE,
+                                                           buf, sizeof(buf), &sz));
+        stateless += sz;
+    }
+    size_t legacy  = run_lossy(0);
+    size_t compact = run_lossy(NETC_CFG_FLAG_COMPACT_HDR);
+    TEST_ASSERT_TRUE(legacy < stateless);
+    TEST_ASSERT_TRUE(compact < legacy);
+}
+
+void test_baseline_reordered_delivery(void) {
+    netc_ctx_t *enc = make_ctx(NETC_CFG_FLAG_COMPACT_HDR);
+    netc_ctx_t *dec = make_ctx(NETC_CFG_FLAG_COMPACT_HDR);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    /* Ack packet 0, then send 8 packets that all delta against it and
+     * deliver them back to front */
+    static wire_pkt_t w[9];
+    uint8_t out[PKT_SIZE];
+    size_t  out_size = 0;
+    uint8_t seq = 0;
+    for (size_t i = 0; i < 9; i++) {
+        w[i].index = i;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[i], PKT_SIZE,
+                                                 w[i].data, sizeof(w[i].data),
+                                                 &w[i].size));
+        if (i == 0) {
+            TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, w[0].data, w[0].size,
+                                                       out, sizeof(out), &out_size));
+            TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_last_seq(dec, &seq));
+            TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, seq));
+        }
+    }
+    for (size_t i = 8; i >= 1; i--) {
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, w[i].data, w[i].size,
+                                                   out, sizeof(out), &out_size));
+        TEST_ASSERT_EQUAL_MEMORY(s_pkts[w[i].index], out, PKT_SIZE);
+        TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_last_seq(dec, &seq));
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)i, seq);
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+void test_baseline_missing_reference_is_corrupt(void) {
+    netc_ctx_t *enc = make_ctx(0);
+    netc_ctx_t *dec = make_ctx(0);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    wire_pkt_t w0, w1, w2;
+    uint8_t out[PKT_SIZE];
+    size_t  out_size = 0;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[0], PKT_SIZE,
+                                             w0.data, sizeof(w0.data), &w0.size));
+    /* A misbehaving sender acks packet 0 although it was lost */
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, 0));
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[1], PKT_SIZE,
+                                             w1.data, sizeof(w1.data), &w1.size));
+    TEST_ASSERT_TRUE(w1.data[4] & NETC_PKT_FLAG_DELTA);
+    TEST_ASSERT_EQUAL_UINT8(0u, w1.data[w1.size - 1]);
+    TEST_ASSERT_EQUAL(NETC_ERR_CORRUPT, netc_decompress(dec, w1.data, w1.size,
+                                                        out, sizeof(out), &out_size));
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ctx_last_seq(dec, out));
+
+    /* The receiver is unchanged: the lost packet still decodes, and then
+     * packet 1 too */
+    TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, w0.data, w0.size,
+                                               out, sizeof(out), &out_size));
+    TEST_ASSERT_EQUAL_MEMORY(s_pkts[0], out, PKT_SIZE);
+    TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, w1.data, w1.size,
+                                               out, sizeof(out), &out_size));
+    TEST_ASSERT_EQUAL_MEMORY(s_pkts[1], out, PKT_SIZE);
+
+    /* A packet from a different size never deltas against packet 0 */
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[2], PKT_SIZE / 2,
+                                             w2.data, sizeof(w2.data), &w2.size));
+    TEST_ASSERT_FALSE(w2.data[4] & NETC_PKT_FLAG_DELTA);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+/* =========================================================================
+ * API checks
+ * ========================================================================= */
+
+void test_baseline_ack_window(void) {
+    netc_ctx_t *enc = make_ctx(0);
+    TEST_ASSERT_NOT_NULL(enc);
+    uint8_t seq = 0;
+
+    TEST_ASSERT_EQUAL(NETC_ERR_CTX_NULL, netc_ack(NULL, 0));
+    TEST_ASSERT_EQUAL(NETC_ERR_CTX_NULL, netc_ctx_last_seq(NULL, &seq));
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ack(enc, 0));  /* not sent */
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ctx_last_seq(enc, &seq));
+
+    for (size_t i = 0; i < 20; i++) {
+        uint8_t buf[PKT_SIZE + NETC_MAX_OVERHEAD];
+        size_t  sz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[i], PKT_SIZE,
+                                                 buf, sizeof(buf), &sz));
+    }
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_last_seq(enc, &seq));
+    TEST_ASSERT_EQUAL_UINT8(19u, seq);
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ctx_last_seq(enc, NULL));
+
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ack(enc, 20));  /* future */
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ack(enc, 3));   /* 17 old */
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, 4));                /* 16 old */
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, 19));
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, 10));  /* older: ignored */
+
+    /* The newest ack is the baseline */
+    uint8_t buf[PKT_SIZE + NETC_MAX_OVERHEAD];
+    size_t  sz = 0;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[20], PKT_SIZE,
+                                             buf, sizeof(buf), &sz));
+    TEST_ASSERT_TRUE(buf[4] & NETC_PKT_FLAG_DELTA);
+    TEST_ASSERT_EQUAL_UINT8(19u, buf[sz - 1]);
+
+    /* 16 packets later the ack has aged out and packets go whole */
+    for (size_t i = 21; i < 37; i++) {
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[i], PKT_SIZE,
+                                                 buf, sizeof(buf), &sz));
+    }
+    TEST_ASSERT_FALSE(buf[4] & NETC_PKT_FLAG_DELTA);
+    netc_ctx_destroy(enc);
+}
+
+void test_baseline_flag_interplay(void) {
+    TEST_ASSERT_NULL(make_ctx(NETC_CFG_FLAG_ADAPTIVE));
+    TEST_ASSERT_NULL(make_ctx(NETC_CFG_FLAG_DELTA_REFS));
+
+    /* Without DELTA the flag is inert */
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BASELINE;
+    cfg.compression_level = 5;
+    netc_ctx_t *ctx = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ASSERT_EQUAL(NETC_ERR_UNSUPPORTED, netc_ack(ctx, 0));
+    netc_ctx_destroy(ctx);
+
+    /* No LZ77X ring is allocated */
+    ctx = make_ctx(0);
+    TEST_ASSERT_NOT_NULL(ctx);
+    netc_mem_usage_t mem;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ctx_memory_usage(ctx, &mem));
+    TEST_ASSERT_EQUAL_size_t(0, mem.ring);
+    netc_ctx_destroy(ctx);
+}
+
+void test_baseline_reset(void) {
+    netc_ctx_t *enc = make_ctx(0);
+    TEST_ASSERT_NOT_NULL(enc);
+    uint8_t buf[PKT_SIZE + NETC_MAX_OVERHEAD];
+    size_t  sz = 0;
+    uint8_t seq = 0;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[0], PKT_SIZE,
+                                             buf, sizeof(buf), &sz));
+    TEST_ASSERT_EQUAL(NETC_OK, netc_ack(enc, 0));
+
+    netc_ctx_reset(enc);
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG, netc_ctx_last_seq(enc, &seq));
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[1], PKT_SIZE,
+                                             buf, sizeof(buf), &sz));
+    TEST_ASSERT_FALSE(buf[4] & NETC_PKT_FLAG_DELTA);
+    TEST_ASSERT_EQUAL_UINT8(0u, buf[7]);  /* sequence restarts at 0 */
+    netc_ctx_destroy(enc);
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_baseline_in_order_roundtrip);
+    RUN_TEST(test_baseline_in_order_roundtrip_compact);
+    RUN_TEST(test_baseline_lossy_channel);
+    RUN_TEST(test_baseline_reordered_delivery);
+    RUN_TEST(test_baseline_missing_reference_is_corrupt);
+    RUN_TEST(test_baseline_ack_window);
+    RUN_TEST(test_baseline_flag_interplay);
+    RUN_TEST(test_baseline_reset);
+    int rc = UNITY_END();
+    netc_dict_free(s_dict);
+    return rc;
+}
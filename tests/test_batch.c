@@ -0,0 +1,274 @@
+/**
+ * test_batch.c -- Batch compress/decompress API tests.
+ *
+ * Tests:
+ *   - Batch compress output is bit-identical to per-call netc_compress
+ *   - Batch round-trip over delta, compact-header and adaptive contexts
+ *   - Batch decompress accepts packets produced by per-call netc_compress
+ *   - Offsets array layout (offsets[0] = 0, offsets[count] = total)
+ *   - Empty batch, NULL ctx, NULL arrays, oversized packet, short arena
+ *   - n_done reports the packets written before an error
+ */
+
+#include "unity.h"
+#include "netc.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * PRNG (splitmix64) for deterministic test data
+ * ========================================================================= */
+
+static uint64_t s_prng_state;
+
+static uint64_t splitmix64(void) {
+    uint64_t z = (s_prng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Game-state-like packet: slowly changing fields plus some noise. */
+static void fill_packet(uint8_t *buf, size_t size, uint32_t tick) {
+    for (size_t i = 0; i < size; i++) {
+        uint64_t r = splitmix64();
+        if ((r & 3) != 0)
+            buf[i] = (uint8_t)(i * 7u + (tick >> 2));
+        else
+            buf[i] = (uint8_t)(r >> 8);
+    }
+}
+
+/* =========================================================================
+ * Shared fixtures
+ * ========================================================================= */
+
+#define TRAIN_COUNT  200
+#define BATCH_N      48
+#define MAX_PKT      600
+
+static netc_dict_t *s_dict = NULL;
+
+static uint8_t  s_pkts[BATCH_N][MAX_PKT];
+static size_t   s_sizes[BATCH_N];
+static const void *s_srcs[BATCH_N];
+
+void setUp(void) {
+    if (s_dict == NULL) {
+        static uint8_t  storage[TRAIN_COUNT][MAX_PKT];
+        static uint8_t *ptrs[TRAIN_COUNT];
+        static size_t   sizes[TRAIN_COUNT];
+        s_prng_state = 0xBA7C4ULL;
+        for (size_t i = 0; i < TRAIN_COUNT; i++) {
+            sizes[i] = 32u + (i % 5u) * 128u;
+            ptrs[i]  = storage[i];
+            fill_packet(ptrs[i], sizes[i], (uint32_t)i);
+        }
+        netc_result_t r = netc_dict_train((const uint8_t * const *)ptrs,
+                                          sizes, TRAIN_COUNT, 7, &s_dict);
+        TEST_ASSERT_EQUAL(NETC_OK, r);
+    }
+
+    /* Mix of sizes, with runs of equal sizes so delta kicks in */
+    s_prng_state = 0x5EEDULL;
+    for (size_t i = 0; i < BATCH_N; i++) {
+        s_sizes[i] = (i < 16) ? 64u : (i < 32) ? 300u : (size_t)(1u + (i * 37u) % MAX_PKT);
+        fill_packet(s_pkts[i], s_sizes[i], (uint32_t)i);
+        s_srcs[i] = s_pkts[i];
+    }
+}
+
+void tearDown(void) {}
+
+static netc_ctx_t *make_ctx(uint32_t flags) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | flags;
+    cfg.compression_level = 5;
+    netc_ctx_t *ctx = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    return ctx;
+}
+
+static size_t arena_bound(void) {
+    size_t total = 0;
+    for (size_t i = 0; i < BATCH_N; i++)
+        total += netc_compress_bound(s_sizes[i]);
+    return total;
+}
+
+/* Compress the fixture with per-call and batch APIs and compare bytes,
+ * then round-trip the batch output through netc_decompress_batch. */
+static void check_batch_matches_percall(uint32_t flags) {
+    size_t cap = arena_bound();
+    uint8_t *ref = (uint8_t *)malloc(cap);
+    uint8_t *bat = (uint8_t *)malloc(cap);
+    uint8_t *dec = (uint8_t *)malloc(BATCH_N * MAX_PKT);
+    TEST_ASSERT_NOT_NULL(ref);
+    TEST_ASSERT_NOT_NULL(bat);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    netc_ctx_t *c1 = make_ctx(flags);
+    size_t pos = 0;
+    size_t ref_off[BATCH_N + 1];
+    ref_off[0] = 0;
+    for (size_t i = 0; i < BATCH_N; i++) {
+        size_t n = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(c1, s_srcs[i], s_sizes[i],
+                                                 ref + pos, cap - pos, &n));
+        pos += n;
+        ref_off[i + 1] = pos;
+    }
+
+    netc_ctx_t *c2 = make_ctx(flags);
+    size_t off[BATCH_N + 1];
+    size_t done = 0;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress_batch(c2, s_srcs, s_sizes, BATCH_N,
+                                                   bat, cap, off, &done));
+    TEST_ASSERT_EQUAL_size_t(BATCH_N, done);
+    TEST_ASSERT_EQUAL_size_t(0, off[0]);
+    TEST_ASSERT_EQUAL_size_t(ref_off[BATCH_N], off[BATCH_N]);
+    for (size_t i = 0; i <= BATCH_N; i++)
+        TEST_ASSERT_EQUAL_size_t(ref_off[i], off[i]);
+    TEST_ASSERT_EQUAL_MEMORY(ref, bat, off[BATCH_N]);
+
+    const void *csrcs[BATCH_N];
+    size_t      csizes[BATCH_N];
+    for (size_t i = 0; i < BATCH_N; i++) {
+        csrcs[i]  = bat + off[i];
+        csizes[i] = off[i + 1] - off[i];
+    }
+    netc_ctx_t *d = make_ctx(flags);
+    size_t doff[BATCH_N + 1];
+    TEST_ASSERT_EQUAL(NETC_OK, netc_decompress_batch(d, csrcs, csizes, BATCH_N,
+                                                     dec, BATCH_N * MAX_PKT,
+                                                     doff, &done));
+    TEST_ASSERT_EQUAL_size_t(BATCH_N, done);
+    for (size_t i = 0; i < BATCH_N; i++) {
+        TEST_ASSERT_EQUAL_size_t(s_sizes[i], doff[i + 1] - doff[i]);
+        TEST_ASSERT_EQUAL_MEMORY(s_pkts[i], dec + doff[i], s_sizes[i]);
+    }
+
+    netc_ctx_destroy(c1);
+    netc_ctx_destroy(c2);
+    netc_ctx_destroy(d);
+    free(ref); free(bat); free(dec);
+}
+
+/* =========================================================================
+ * Equivalence and round-trip
+ * ========================================================================= */
+
+void test_batch_matches_percall_default(void) {
+    check_batch_matches_percall(0);
+}
+
+void test_batch_matches_percall_delta(void) {
+    check_batch_matches_percall(NETC_CFG_FLAG_DELTA);
+}
+
+void test_batch_matches_percall_compact(void) {
+    check_batch_matches_percall(NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR);
+}
+
+void test_batch_matches_percall_adaptive(void) {
+    check_batch_matches_percall(NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_ADAPTIVE |
+                                NETC_CFG_FLAG_BIGRAM);
+}
+
+void test_batch_decompress_of_percall_output(void) {
+    netc_ctx_t *enc = make_ctx(NETC_CFG_FLAG_DELTA);
+    netc_ctx_t *dec = make_ctx(NETC_CFG_FLAG_DELTA);
+    static uint8_t cmp[BATCH_N][MAX_PKT + NETC_MAX_OVERHEAD];
+    const void *csrcs[BATCH_N];
+    size_t      csizes[BATCH_N];
+    for (size_t i = 0; i < BATCH_N; i++) {
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_srcs[i], s_sizes[i],
+                                                 cmp[i], sizeof(cmp[i]),
+                                                 &csizes[i]));
+        csrcs[i] = cmp[i];
+    }
+    static uint8_t out[BATCH_N * MAX_PKT];
+    size_t off[BATCH_N + 1];
+    TEST_ASSERT_EQUAL(NETC_OK, netc_decompress_batch(dec, csrcs, csizes, BATCH_N,
+                                                     out, sizeof(out), off, NULL));
+    for (size_t i = 0; i < BATCH_N; i++)
+        TEST_ASSERT_EQUAL_MEMORY(s_pkts[i], out + off[i], s_sizes[i]);
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+/* =========================================================================
+ * Error paths
+ * ========================================================================= */
+
+void test_batch_empty(void) {
+    netc_ctx_t *ctx = make_ctx(0);
+    size_t off[1] = { 99 };
+    size_t done = 99;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_compress_batch(ctx, NULL, NULL, 0,
+                                                   NULL, 0, off, &done));
+    TEST_ASSERT_EQUAL_size_t(0, off[0]);
+    TEST_ASSERT_EQUAL_size_t(0, done);
+    netc_ctx_destroy(ctx);
+}
+
+void test_batch_null_args(void) {
+    uint8_t buf[64];
+    size_t off[BATCH_N + 1];
+    TEST_ASSERT_EQUAL(NETC_ERR_CTX_NULL,
+        netc_compress_batch(NULL, s_srcs, s_sizes, 1, buf, sizeof(buf), off, NULL));
+    TEST_ASSERT_EQUAL(NETC_ERR_CTX_NULL,
+        netc_decompress_batch(NULL, s_srcs, s_sizes, 1, buf, sizeof(buf), off, NULL));
+
+    netc_ctx_t *ctx = make_ctx(0);
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG,
+        netc_compress_batch(ctx, NULL, s_sizes, 1, buf, sizeof(buf), off, NULL));
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG,
+        netc_compress_batch(ctx, s_srcs, s_sizes, 1, buf, sizeof(buf), NULL, NULL));
+    TEST_ASSERT_EQUAL(NETC_ERR_INVALID_ARG,
+        netc_decompress_batch(ctx, s_srcs, NULL, 1, buf, sizeof(buf), off, NULL));
+    netc_ctx_destroy(ctx);
+}
+
+void test_batch_toobig_reports_progress(void) {
+    netc_ctx_t *ctx = make_ctx(0);
+    size_t sizes[3] = { s_sizes[0], s_sizes[1], NETC_MAX_PACKET_SIZE + 1u };
+    size_t off[4];
+    size_t done = 0;
+    static uint8_t out[3 * (MAX_PKT + NETC_MAX_OVERHEAD)];
+    TEST_ASSERT_EQUAL(NETC_ERR_TOOBIG,
+        netc_compress_batch(ctx, s_srcs, sizes, 3, out, sizeof(out), off, &done));
+    TEST_ASSERT_EQUAL_size_t(2, done);
+    TEST_ASSERT_TRUE(off[2] > off[1]);
+    netc_ctx_destroy(ctx);
+}
+
+void test_batch_arena_too_small(void) {
+    netc_ctx_t *ctx = make_ctx(0);
+    uint8_t out[NETC_HEADER_SIZE];
+    size_t off[BATCH_N + 1];
+    size_t done = 99;
+    netc_result_t r = netc_compress_batch(ctx, s_srcs, s_sizes, BATCH_N,
+                                          out, sizeof(out), off, &done);
+    TEST_ASSERT_EQUAL(NETC_ERR_BUF_SMALL, r);
+    TEST_ASSERT_EQUAL_size_t(0, done);
+    netc_ctx_destroy(ctx);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_matches_percall_default);
+    RUN_TEST(test_batch_matches_percall_delta);
+    RUN_TEST(test_batch_matches_percall_compact);
+    RUN_TEST(test_batch_matches_percall_adaptive);
+    RUN_TEST(test_batch_decompress_of_percall_output);
+    RUN_TEST(test_batch_empty);
+    RUN_TEST(test_batch_null_args);
+    RUN_TEST(test_batch_toobig_reports_progress);
+    RUN_TEST(test_batch_arena_too_small);
+    int result = UNITY_END();
+    netc_dict_free(s_dict);
+    return result;
+}
@@ -72,6 +72,7 @@ static netc_ctx_t *make_compact_ctx(const netc_dict_t *dict, uint32_t extra_flag
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR | extra_flags;
+    cfg.compression_level = 5;
     return netc_ctx_create(dict, &cfg);
 }
 
@@ -226,6 +227,10 @@ void test_pkt_type_lz77x(void)
 {
     uint8_t pt = netc_compact_type_encode(NETC_PKT_FLAG_DICT_ID, NETC_ALG_LZ77X);
     TEST_ASSERT_EQUAL_UINT8(0x0E, pt);
+
+    /* tANS-coded tokens */
+    pt = netc_compact_type_encode(NETC_PKT_FLAG_DICT_ID, NETC_ALG_LZ77X | NETC_LZ77X_TANS);
+    TEST_ASSERT_EQUAL_UINT8(0x0F, pt);
 }
 
 void test_pkt_type_decode_table_consistency(void)
@@ -235,7 +240,6 @@ void test_pkt_type_decode_table_consistency(void)
     for (unsigned i = 0; i < 0xB0; i++) {
         const netc_pkt_type_entry_t *e = &netc_pkt_type_table[i];
         if (e->flags == 0 && e->algorithm == 0 && i != 0x00) continue; /* unused slot */
-        if (i == 0x0F) continue; /* reserved */
 
         uint8_t re = netc_compact_type_encode(e->flags, e->algorithm);
         TEST_ASSERT_EQUAL_UINT8_MESSAGE((uint8_t)i, re,
@@ -339,8 +343,8 @@ void test_compact_hdr_invalid_type(void)
 
 void test_compact_hdr_reserved_slot(void)
 {
-    /* 0x0F is reserved (flags=0, algorithm=0 but index != 0x00) */
-    uint8_t buf[4] = { 0x0F, 0x00, 0x00, 0x00 };
+    /* 0xF6 is reserved (flags=0, algorithm=0 but index != 0x00) */
+    uint8_t buf[4] = { 0xF6, 0x00, 0x00, 0x00 };
     netc_pkt_header_t hdr;
     size_t sz = netc_hdr_read_compact(buf, 4, &hdr);
     TEST_ASSERT_EQUAL_UINT(0, sz);
@@ -477,6 +481,7 @@ void test_compact_header_saves_bytes_vs_legacy(void)
         netc_cfg_t cfg;
         memset(&cfg, 0, sizeof(cfg));
         cfg.flags = NETC_CFG_FLAG_STATEFUL;
+        cfg.compression_level = 5;
         legacy_ctx = netc_ctx_create(s_dict, &cfg);
     }
     netc_ctx_t *compact_ctx = make_compact_ctx(s_dict, 0);
@@ -683,6 +688,7 @@ void test_compact_ans_state_saves_2_bytes(void)
         netc_cfg_t cfg;
         memset(&cfg, 0, sizeof(cfg));
         cfg.flags = NETC_CFG_FLAG_STATEFUL;
+        cfg.compression_level = 5;
         legacy_ctx = netc_ctx_create(s_dict, &cfg);
     }
     netc_ctx_t *compact_ctx = make_compact_ctx(s_dict, 0);
@@ -23,6 +23,11 @@
  *   MREG multi-region round-trip:
  *     - MREG flag set when tANS compresses
  *     - 16-byte and 128-byte packets spanning multiple context buckets
+ *   Cross-packet LZ77X (AD-030):
+ *     - A packet repeating one older than the previous packet is coded
+ *       as ring back-refs; netc_ctx_reset forgets the ring
+ *     - With a dictionary trained on the traffic the tokens are tANS-coded
+ *       (AD-031); a bad initial state is rejected
  *   RLE pre-pass round-trip:
  *     - All-same-byte runs (128 bytes)
  *     - Mixed runs of different bytes
@@ -82,6 +87,7 @@ void setUp(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_STATS;
+    cfg.compression_level = 5;
     s_ctx = netc_ctx_create(s_dict, &cfg);
 }
 
@@ -138,6 +144,7 @@ void test_compress_no_dict_passthrough(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_nodict = netc_ctx_create(NULL, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_nodict);
 
@@ -221,6 +228,7 @@ void test_compress_uses_tans_for_compressible_data(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
 
     size_t bound = netc_compress_bound(sizeof(uniform));
@@ -314,6 +322,7 @@ void test_compress_mreg_flag_set_for_compressible(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
 
     size_t bound = netc_compress_bound(sizeof(uniform));
@@ -347,6 +356,7 @@ void test_compress_mreg_roundtrip_small_packet(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
 
     int ok = 0;
@@ -370,6 +380,7 @@ void test_compress_mreg_roundtrip_spans_multiple_buckets(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
 
     int ok = 0;
@@ -397,6 +408,7 @@ void test_compress_rle_roundtrip_all_same_byte(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
 
     int ok = 0;
@@ -423,6 +435,7 @@ void test_compress_rle_roundtrip_mixed_runs(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
 
     int ok = 0;
@@ -540,6 +553,7 @@ void test_decompress_wrong_model_id(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx2 = netc_ctx_create(d2, &cfg);
 
     uint8_t dst[128];
@@ -599,6 +613,7 @@ void test_compress_lz77_roundtrip_all_zeros(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_nd = netc_ctx_create(NULL, &cfg);
 
     TEST_ASSERT_EQUAL_INT(NETC_OK,
@@ -651,6 +666,7 @@ void test_compress_lz77_roundtrip_half_half(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_nd = netc_ctx_create(NULL, &cfg);
 
     TEST_ASSERT_EQUAL_INT(NETC_OK,
@@ -680,6 +696,7 @@ void test_compress_lz77_stateless_roundtrip(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_nodct = netc_ctx_create(NULL, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_nodct);
 
@@ -725,6 +742,153 @@ void test_compress_lz77_flag_set(void) {
     free(cbuf);
 }
 
+/* =========================================================================
+ * Cross-packet LZ77X over the whole ring (AD-030)
+ * ========================================================================= */
+
+#define LZX_MSGS     8
+#define LZX_MSG_SIZE 256
+
+static void lzx_fill_msgs(uint8_t msgs[LZX_MSGS][LZX_MSG_SIZE]) {
+    uint32_t x = 0x2545F491u;
+    for (size_t m = 0; m < LZX_MSGS; m++) {
+        for (size_t i = 0; i < LZX_MSG_SIZE; i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            msgs[m][i] = (uint8_t)(x >> 24);
+        }
+    }
+}
+
+/* Compress on enc, decompress on dec, check the bytes; returns the
+ * compressed size and the algorithm byte */
+static size_t lzx_send(netc_ctx_t *enc, netc_ctx_t *dec,
+                       const uint8_t *src, uint8_t *alg) {
+    uint8_t cbuf[LZX_MSG_SIZE + NETC_MAX_OVERHEAD];
+    uint8_t dbuf[LZX_MSG_SIZE];
+    size_t csz = 0, dsz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_compress(enc, src, LZX_MSG_SIZE, cbuf, sizeof(cbuf), &csz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_decompress(dec, cbuf, csz, dbuf, sizeof(dbuf), &dsz));
+    TEST_ASSERT_EQUAL_UINT(LZX_MSG_SIZE, dsz);
+    TEST_ASSERT_EQUAL_MEMORY(src, dbuf, LZX_MSG_SIZE);
+    *alg = cbuf[5];
+    return csz;
+}
+
+void test_lz77x_matches_older_packets(void) {
+    static uint8_t msgs[LZX_MSGS][LZX_MSG_SIZE];
+    lzx_fill_msgs(msgs);
+
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
+    netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    uint8_t alg = 0;
+    for (size_t m = 0; m < LZX_MSGS; m++) {
+        lzx_send(enc, dec, msgs[m], &alg);
+        TEST_ASSERT_NOT_EQUAL_UINT8(NETC_ALG_LZ77X, alg);  /* nothing to match */
+    }
+
+    /* Repeats of messages 6, 4 and 0 packets back: four 66-byte refs each */
+    for (size_t m = 1; m < LZX_MSGS; m += 3) {
+        size_t csz = lzx_send(enc, dec, msgs[m], &alg);
+        TEST_ASSERT_EQUAL_UINT8(NETC_ALG_LZ77X, alg);
+        TEST_ASSERT_TRUE(csz < 32);
+    }
+
+    /* Reset forgets the ring: the same message is new again */
+    netc_ctx_reset(enc);
+    netc_ctx_reset(dec);
+    lzx_send(enc, dec, msgs[0], &alg);
+    TEST_ASSERT_NOT_EQUAL_UINT8(NETC_ALG_LZ77X, alg);
+    lzx_send(enc, dec, msgs[2], &alg);
+    TEST_ASSERT_NOT_EQUAL_UINT8(NETC_ALG_LZ77X, alg);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+}
+
+/* Inventory updates: 4–11 eight-byte item records drawn from a fixed set
+ * of INV_RECORDS, so most of a packet repeats records of older packets */
+#define INV_TRAIN    600
+#define INV_SEND     300
+#define INV_RECORDS  32
+#define INV_MAX_SIZE (2 + 11 * 8)
+
+static uint32_t inv_next(uint32_t *x) {
+    *x ^= *x << 13; *x ^= *x >> 17; *x ^= *x << 5;
+    return *x;
+}
+
+static size_t inv_packet(uint32_t *x, const uint8_t *recs, uint8_t *b) {
+    size_t n = 0;
+    b[n++] = 0x30;
+    b[n++] = (uint8_t)inv_next(x);
+    uint32_t k = 4u + inv_next(x) % 8u;
+    for (uint32_t i = 0; i < k; i++, n += 8)
+        memcpy(b + n, recs + (inv_next(x) % INV_RECORDS) * 8u, 8);
+    return n;
+}
+
+void test_lz77x_tans_coded_tokens(void) {
+    static uint8_t train[INV_TRAIN][INV_MAX_SIZE];
+    uint8_t recs[INV_RECORDS * 8];
+    const uint8_t *pkts[INV_TRAIN];
+    size_t szs[INV_TRAIN];
+    uint32_t x = 0x9E3779B9u;
+    for (size_t r = 0; r < sizeof(recs); r++) recs[r] = (uint8_t)inv_next(&x);
+    for (size_t i = 0; i < INV_TRAIN; i++) {
+        szs[i]  = inv_packet(&x, recs, train[i]);
+        pkts[i] = train[i];
+    }
+    netc_dict_t *d = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train(pkts, szs, INV_TRAIN, 7, &d));
+
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 5;
+    netc_ctx_t *enc = netc_ctx_create(d, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(d, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    uint8_t src[INV_MAX_SIZE], cbuf[INV_MAX_SIZE + NETC_MAX_OVERHEAD], dbuf[INV_MAX_SIZE];
+    uint8_t last[INV_MAX_SIZE + NETC_MAX_OVERHEAD];
+    size_t last_sz = 0, coded = 0;
+    for (size_t i = 0; i < INV_SEND; i++) {
+        size_t n = inv_packet(&x, recs, src), csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL_INT(NETC_OK, netc_compress(enc, src, n, cbuf, sizeof(cbuf), &csz));
+        TEST_ASSERT_EQUAL_INT(NETC_OK,
+            netc_decompress(dec, cbuf, csz, dbuf, sizeof(dbuf), &dsz));
+        TEST_ASSERT_EQUAL_UINT(n, dsz);
+        TEST_ASSERT_EQUAL_MEMORY(src, dbuf, n);
+        if (cbuf[5] == (NETC_ALG_LZ77X | 0x10u)) {
+            coded++;
+            memcpy(last, cbuf, csz);
+            last_sz = csz;
+        }
+    }
+    TEST_ASSERT_TRUE(coded >= INV_SEND / 50);
+
+    /* An initial state outside [4096, 8192) is rejected */
+    last[8] = 0;
+    last[9] = 0;
+    size_t dsz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_CORRUPT,
+        netc_decompress(dec, last, last_sz, dbuf, sizeof(dbuf), &dsz));
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    netc_dict_free(d);
+}
+
 /* =========================================================================
  * Stateless delta rejection tests
  *
@@ -831,6 +995,7 @@ void test_bigram_flag_set_in_header(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx);
 
@@ -858,6 +1023,7 @@ void test_bigram_roundtrip_repetitive(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -887,6 +1053,7 @@ void test_bigram_roundtrip_skewed(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -913,6 +1080,7 @@ void test_bigram_roundtrip_multi_packet(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_DELTA;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -962,6 +1130,7 @@ void test_bigram_improves_ratio_on_structured_data(void) {
     netc_cfg_t cfg_uni;
     memset(&cfg_uni, 0, sizeof(cfg_uni));
     cfg_uni.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg_uni.compression_level = 5;
     netc_ctx_t *ctx_uni = netc_ctx_create(d, &cfg_uni);
     TEST_ASSERT_NOT_NULL(ctx_uni);
 
@@ -975,6 +1144,7 @@ void test_bigram_improves_ratio_on_structured_data(void) {
     netc_cfg_t cfg_bi;
     memset(&cfg_bi, 0, sizeof(cfg_bi));
     cfg_bi.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg_bi.compression_level = 5;
     netc_ctx_t *ctx_bi = netc_ctx_create(d, &cfg_bi);
     TEST_ASSERT_NOT_NULL(ctx_bi);
 
@@ -1029,6 +1199,7 @@ void test_bigram_non_bigram_packet_decompresses_on_bigram_ctx(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_d);
 
@@ -1047,6 +1218,7 @@ void test_bigram_mreg_roundtrip(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -1092,6 +1264,7 @@ void test_bigram_delta_repetitive_roundtrip(void)
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(d, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(d, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -1127,6 +1300,7 @@ void test_bigram_pctx_roundtrip_compact(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM
               | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -1166,6 +1340,7 @@ void test_bigram_pctx_delta_roundtrip(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM
               | NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -1210,6 +1385,7 @@ void test_bigram_pctx_multi_packet_roundtrip(void) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM
               | NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -1240,6 +1416,7 @@ void test_bigram_pctx_legacy_header_roundtrip(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx_c = netc_ctx_create(s_dict, &cfg);
     netc_ctx_t *ctx_d = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(ctx_c);
@@ -1305,6 +1482,10 @@ int main(void) {
     RUN_TEST(test_compress_lz77_stateless_roundtrip);
     RUN_TEST(test_compress_lz77_flag_set);
 
+    /* Cross-packet LZ77X */
+    RUN_TEST(test_lz77x_matches_older_packets);
+    RUN_TEST(test_lz77x_tans_coded_tokens);
+
     /* Edge cases */
     RUN_TEST(test_compress_one_byte_roundtrip);
     RUN_TEST(test_compress_max_size_roundtrip);
@@ -32,6 +32,19 @@
  * ## 5. Spec scenarios (from delta/spec.md)
  *   5.1 delta_encode/delta_decode: residual[i] = (C[i]-P[i]) mod 256 for SUB region
  *   5.2 Delta disabled for small packets (< NETC_DELTA_MIN_SIZE)
+ *
+ * ## 6. Operator maps (netc_delta_*_mapped, order-2)
+ *   6.1 Default map reproduces netc_delta_encode exactly
+ *   6.2 SUB16 / SUB32 lanes borrow across bytes; NONE stores curr
+ *   6.3 A lane cut short by the packet end codes the truncated integer
+ *   6.4 Order-2 with a mapped lane: u32 linear trend → zero residual
+ *   6.5 netc_delta_map_valid rejects split lanes and unknown operators
+ *
+ * ## 7. Reference history (NETC_CFG_FLAG_DELTA_REFS)
+ *   7.1 Interleaved same-size message types round-trip (legacy and compact
+ *       headers) and compress smaller than with single-reference delta
+ *   7.2 A reference index past the candidate count is rejected as corrupt
+ *   7.3 ctx_reset empties the reference history
  */
 
 #include "unity.h"
@@ -109,12 +122,14 @@ void setUp(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
+    cfg.compression_level = 5;
     s_ctx = netc_ctx_create(s_dict, &cfg);
 
     /* Context without delta */
     netc_cfg_t cfg2;
     memset(&cfg2, 0, sizeof(cfg2));
     cfg2.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg2.compression_level = 5;
     s_ctx_nodelta = netc_ctx_create(s_dict, &cfg2);
 }
 
@@ -446,6 +461,7 @@ void test_delta_size_mismatch_skips_delta(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
+    cfg.compression_level = 5;
     netc_ctx_t *dctx = netc_ctx_create(s_dict, &cfg);
     TEST_ASSERT_NOT_NULL(dctx);
 
@@ -557,6 +573,7 @@ void test_delta_spec_small_packet_no_delta(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
+    cfg.compression_level = 5;
     netc_ctx_t *tctx = netc_ctx_create(NULL, &cfg);  /* no dict → passthrough */
     TEST_ASSERT_NOT_NULL(tctx);
 
@@ -581,6 +598,7 @@ void test_delta_exact_min_size_boundary(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
+    cfg.compression_level = 5;
     netc_ctx_t *tctx = netc_ctx_create(NULL, &cfg); /* no dict: passthrough */
     TEST_ASSERT_NOT_NULL(tctx);
 
@@ -643,6 +661,344 @@ void test_delta_roundtrip_all_ones(void) {
     assert_bytes_equal(curr, recovered, 256, "all-ones prev, all-zero curr roundtrip");
 }
 
+/* =========================================================================
+ * 6. Operator maps
+ * ========================================================================= */
+
+static void map_fill(netc_delta_map_t *m, uint32_t op) {
+    memset(m->op, (int)op, sizeof(m->op));
+    m->tail = (uint8_t)op;
+    m->planes = 0;
+}
+
+void test_delta_map_default_matches_legacy(void) {
+    /* 6.1 */
+    uint8_t prev[600], curr[600], res_a[600], res_b[600];
+    for (int i = 0; i < 600; i++) {
+        prev[i] = (uint8_t)(i * 31);
+        curr[i] = (uint8_t)(i * 17 + 3);
+    }
+    netc_delta_encode(prev, curr, res_a, 600);
+    netc_delta_encode_mapped(&netc_delta_map_default, prev, curr, res_b, 0, 600);
+    assert_bytes_equal(res_a, res_b, 600, "default map vs legacy");
+}
+
+void test_delta_map_lane_borrow(void) {
+    /* 6.2 u16 0x01FF → 0x0200 is +1: SUB16 gives 01 00 where byte SUB
+     * would give 01 01 */
+    netc_delta_map_t m;
+    map_fill(&m, NETC_DELTA_OP_SUB16);
+    m.op[4] = m.op[5] = m.op[6] = m.op[7] = (uint8_t)NETC_DELTA_OP_SUB32;
+    m.op[8] = m.op[9] = (uint8_t)NETC_DELTA_OP_NONE;
+    TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+
+    uint8_t prev[12] = { 0xFF, 0x01, 0, 0, 0xFF, 0xFF, 0xFF, 0x00, 9, 9, 0, 0 };
+    uint8_t curr[12] = { 0x00, 0x02, 0, 0, 0x00, 0x00, 0x00, 0x01, 7, 8, 0, 0 };
+    uint8_t res[12], rec[12];
+    netc_delta_encode_mapped(&m, prev, curr, res, 0, 12);
+    TEST_ASSERT_EQUAL_HEX8(0x01, res[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, res[1]);
+    /* 0x00FFFFFF → 0x01000000 is +1 */
+    TEST_ASSERT_EQUAL_HEX8(0x01, res[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, res[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, res[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, res[7]);
+    TEST_ASSERT_EQUAL_HEX8(7, res[8]);
+    TEST_ASSERT_EQUAL_HEX8(8, res[9]);
+
+    netc_delta_decode_mapped(&m, prev, res, rec, 0, 12);
+    assert_bytes_equal(curr, rec, 12, "lane borrow roundtrip");
+}
+
+void test_delta_map_truncated_lane(void) {
+    /* 6.3 Three bytes of a SUB32 lane: the low three bytes of the u32 result */
+    netc_delta_map_t m;
+    map_fill(&m, NETC_DELTA_OP_SUB32);
+    uint8_t prev[7] = { 0, 0, 0, 0, 0xFF, 0xFF, 0x00 };
+    uint8_t curr[7] = { 0, 0, 0, 0, 0x00, 0x00, 0x01 };
+    uint8_t res[7], rec[7];
+    netc_delta_encode_mapped(&m, prev, curr, res, 0, 7);
+    TEST_ASSERT_EQUAL_HEX8(0x01, res[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, res[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, res[6]);
+    netc_delta_decode_mapped(&m, prev, res, rec, 0, 7);
+    assert_bytes_equal(curr, rec, 7, "truncated lane roundtrip");
+}
+
+void test_delta_map_order2_lane(void) {
+    /* 6.4 u32 counter stepping by 0x00818181: constant second difference */
+    netc_delta_map_t m;
+    map_fill(&m, NETC_DELTA_OP_XOR);
+    m.op[8] = m.op[9] = m.op[10] = m.op[11] = (uint8_t)NETC_DELTA_OP_SUB32;
+
+    uint8_t p2[16], p1[16], cur[16], res[16], rec[16];
+    memset(p2, 0x5A, 16);
+    memset(p1, 0x5A, 16);
+    memset(cur, 0x5A, 16);
+    for (int k = 0; k < 4; k++) {
+        p2[8 + k]  = (uint8_t)(0x12FFFFF0u >> (8 * k));
+        p1[8 + k]  = (uint8_t)((0x12FFFFF0u + 0x00818181u) >> (8 * k));
+        cur[8 + k] = (uint8_t)((0x12FFFFF0u + 2u * 0x00818181u) >> (8 * k));
+    }
+    netc_delta_encode_order2(&m, p2, p1, cur, res, 16);
+    for (int i = 0; i < 16; i++) TEST_ASSERT_EQUAL_HEX8(0, res[i]);
+
+    cur[3] ^= 0x40;
+    cur[9] += 1;
+    netc_delta_encode_order2(&m, p2, p1, cur, res, 16);
+    memcpy(rec, res, 16);
+    netc_delta_decode_order2(&m, p2, p1, rec, rec, 16);
+    assert_bytes_equal(cur, rec, 16, "order2 mapped roundtrip");
+}
+
+void test_delta_map_valid_rejects(void) {
+    /* 6.5 */
+    netc_delta_map_t m = netc_delta_map_default;
+    TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+    m.op[3] = NETC_DELTA_OP_COUNT;
+    TEST_ASSERT_FALSE(netc_delta_map_valid(&m));
+    m = netc_delta_map_default;
+    m.op[6] = (uint8_t)NETC_DELTA_OP_SUB16;           /* pair 6..7 split */
+    TEST_ASSERT_FALSE(netc_delta_map_valid(&m));
+    m.op[7] = (uint8_t)NETC_DELTA_OP_SUB16;
+    TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+    m.op[4] = m.op[5] = (uint8_t)NETC_DELTA_OP_SUB32; /* quad 4..7 mixed */
+    TEST_ASSERT_FALSE(netc_delta_map_valid(&m));
+    m = netc_delta_map_default;
+    m.tail = NETC_DELTA_OP_COUNT;
+    TEST_ASSERT_FALSE(netc_delta_map_valid(&m));
+    m = netc_delta_map_default;
+    m.planes = 2;
+    TEST_ASSERT_FALSE(netc_delta_map_valid(&m));
+}
+
+static void put_f32_bits(uint8_t *p, uint32_t v) {
+    for (int k = 0; k < 4; k++) p[k] = (uint8_t)(v >> (8 * k));
+}
+
+void test_delta_map_flt32(void) {
+    /* 6.6 FLT32: the sign lands in bit 0 and the exponent change in the top
+     * byte; a truncated lane is plain XOR */
+    netc_delta_map_t m;
+    map_fill(&m, NETC_DELTA_OP_FLT32);
+    TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+
+    uint8_t prev[15], curr[15], res[15], rec[15];
+    put_f32_bits(prev,     0x3F800000u);  /*  1.0f */
+    put_f32_bits(curr,     0xBF800000u);  /* -1.0f */
+    put_f32_bits(prev + 4, 0x3F800000u);  /*  1.0f */
+    put_f32_bits(curr + 4, 0x40000000u);  /*  2.0f */
+    put_f32_bits(prev + 8, 0x3F800000u);  /*  1.0f */
+    put_f32_bits(curr + 8, 0x3FC00000u);  /*  1.5f */
+    prev[12] = 0x11; prev[13] = 0x22; prev[14] = 0x80;
+    curr[12] = 0x10; curr[13] = 0x22; curr[14] = 0x00;
+
+    netc_delta_encode_mapped(&m, prev, curr, res, 0, 15);
+    static const uint8_t want[15] = {
+        0x01, 0x00, 0x00, 0x00,   /* sign flip only */
+        0x00, 0x00, 0x00, 0xFF,   /* exponent 0x7F → 0x80 */
+        0x00, 0x00, 0x80, 0x00,   /* top mantissa bit */
+        0x01, 0x00, 0x80          /* truncated: XOR */
+    };
+    assert_bytes_equal(want, res, 15, "flt32 residual");
+    netc_delta_decode_mapped(&m, prev, res, rec, 0, 15);
+    assert_bytes_equal(curr, rec, 15, "flt32 roundtrip");
+
+    uint8_t p2[15];
+    for (int i = 0; i < 15; i++) p2[i] = (uint8_t)(prev[i] * 7 + 1);
+    netc_delta_encode_order2(&m, p2, prev, curr, res, 15);
+    memcpy(rec, res, 15);
+    netc_delta_decode_order2(&m, p2, prev, rec, rec, 15);
+    assert_bytes_equal(curr, rec, 15, "flt32 order2 roundtrip");
+}
+
+void test_delta_planes_runs(void) {
+    /* 6.7 Runs are maximal same-operator stretches of >= 2 wide lanes */
+    netc_delta_map_t    m;
+    netc_delta_planes_t pl;
+    map_fill(&m, NETC_DELTA_OP_XOR);
+    memset(m.op + 8,  NETC_DELTA_OP_SUB32, 8);   /* 2 lanes */
+    memset(m.op + 16, NETC_DELTA_OP_FLT32, 8);   /* 2 lanes, own run */
+    memset(m.op + 28, NETC_DELTA_OP_SUB16, 2);   /* 1 lane: no run */
+    memset(m.op + 32, NETC_DELTA_OP_SUB16, 6);   /* 3 lanes */
+    TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+
+    netc_delta_planes_init(&pl, &m);
+    TEST_ASSERT_EQUAL_UINT32(0, pl.count);
+
+    m.planes = 1;
+    netc_delta_planes_init(&pl, &m);
+    TEST_ASSERT_EQUAL_UINT32(3, pl.count);
+    TEST_ASSERT_EQUAL_UINT16(8,  pl.start[0]);
+    TEST_ASSERT_EQUAL_UINT16(2,  pl.lanes[0]);
+    TEST_ASSERT_EQUAL_UINT8(4,   pl.width[0]);
+    TEST_ASSERT_EQUAL_UINT16(16, pl.start[1]);
+    TEST_ASSERT_EQUAL_UINT16(32, pl.start[2]);
+    TEST_ASSERT_EQUAL_UINT16(3,  pl.lanes[2]);
+    TEST_ASSERT_EQUAL_UINT8(2,   pl.width[2]);
+
+    /* Only whole lanes inside the packet, and at least two of them */
+    TEST_ASSERT_EQUAL_size_t(0, netc_delta_planes_lanes(&pl, 0, 15));
+    TEST_ASSERT_EQUAL_size_t(2, netc_delta_planes_lanes(&pl, 0, 16));
+    TEST_ASSERT_EQUAL_size_t(2, netc_delta_planes_lanes(&pl, 2, 37));
+    TEST_ASSERT_EQUAL_size_t(3, netc_delta_planes_lanes(&pl, 2, 600));
+}
+
+void test_delta_planes_split_merge(void) {
+    /* 6.8 Three u16 lanes become a low-byte plane and a high-byte plane */
+    uint8_t buf[6]  = { 0x10, 0xA0, 0x11, 0xA1, 0x12, 0xA2 };
+    uint8_t copy[6];
+    memcpy(copy, buf, 6);
+    netc_delta_planes_split(buf, copy, 2, 3, 0);
+    static const uint8_t want[6] = { 0x10, 0x11, 0x12, 0xA0, 0xA1, 0xA2 };
+    assert_bytes_equal(want, buf, 6, "split u16 planes");
+    memcpy(copy, buf, 6);
+    netc_delta_planes_merge(buf, copy, 2, 3, 0);
+    static const uint8_t orig[6] = { 0x10, 0xA0, 0x11, 0xA1, 0x12, 0xA2 };
+    assert_bytes_equal(orig, buf, 6, "merge u16 planes");
+}
+
+/* =========================================================================
+ * 7. Reference history (NETC_CFG_FLAG_DELTA_REFS)
+ * ========================================================================= */
+
+#define REFS_TYPES 3
+#define REFS_COUNT 24
+
+/* Packet p of an interleaved stream: REFS_TYPES unrelated message types of
+ * the same size, each drifting slowly from packet to packet */
+static void refs_packet(uint8_t *pkt, int p) {
+    uint32_t seed = 0x9E3779B9u * (uint32_t)(p % REFS_TYPES + 1);
+    for (int i = 0; i < PKT_SIZE; i++) {
+        seed = seed * 1103515245u + 12345u;
+        pkt[i] = (uint8_t)(0x41 + ((seed >> 16) & 0x0F));
+    }
+    for (int i = 0; i < PKT_SIZE; i += 32) {
+        pkt[i] = (uint8_t)(pkt[i] + p / REFS_TYPES);
+    }
+}
+
+/* Dictionary trained on the interleaved stream itself */
+static netc_dict_t *refs_dict(void) {
+    static uint8_t pkts[REFS_COUNT][PKT_SIZE];
+    const uint8_t *ptrs[REFS_COUNT];
+    size_t         szs[REFS_COUNT];
+    for (int p = 0; p < REFS_COUNT; p++) {
+        refs_packet(pkts[p], p);
+        ptrs[p] = pkts[p];
+        szs[p]  = PKT_SIZE;
+    }
+    netc_dict_t *d = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train(ptrs, szs, REFS_COUNT, 3, &d));
+    return d;
+}
+
+static netc_ctx_t *refs_ctx(const netc_dict_t *d, uint32_t extra) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA | extra;
+    return netc_ctx_create(d, &cfg);
+}
+
+void test_delta_refs_interleaved_roundtrip(void) {
+    /* 7.1 Each type is predicted from its own earlier packet */
+    netc_dict_t *d = refs_dict();
+    static const uint32_t hdr_modes[2] = { 0, NETC_CFG_FLAG_COMPACT_HDR };
+
+    for (int h = 0; h < 2; h++) {
+        netc_ctx_t *enc   = refs_ctx(d, NETC_CFG_FLAG_DELTA_REFS | hdr_modes[h]);
+        netc_ctx_t *dec   = refs_ctx(d, NETC_CFG_FLAG_DELTA_REFS | hdr_modes[h]);
+        netc_ctx_t *plain = refs_ctx(d, hdr_modes[h]);
+        TEST_ASSERT_NOT_NULL(enc);
+        TEST_ASSERT_NOT_NULL(dec);
+        TEST_ASSERT_NOT_NULL(plain);
+
+        size_t refs_total = 0, plain_total = 0;
+        for (int p = 0; p < REFS_COUNT; p++) {
+            uint8_t pkt[PKT_SIZE], cbuf[PKT_SIZE + NETC_MAX_OVERHEAD];
+            uint8_t dbuf[PKT_SIZE];
+            size_t  csz, dsz;
+            char    msg[64];
+            snprintf(msg, sizeof(msg), "hdr mode %d packet %d", h, p);
+
+            refs_packet(pkt, p);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(NETC_OK,
+                netc_compress(plain, pkt, PKT_SIZE, cbuf, sizeof(cbuf), &csz), msg);
+            plain_total += csz;
+
+            TEST_ASSERT_EQUAL_INT_MESSAGE(NETC_OK,
+                netc_compress(enc, pkt, PKT_SIZE, cbuf, sizeof(cbuf), &csz), msg);
+            refs_total += csz;
+            TEST_ASSERT_EQUAL_INT_MESSAGE(NETC_OK,
+                netc_decompress(dec, cbuf, csz, dbuf, sizeof(dbuf), &dsz), msg);
+            TEST_ASSERT_EQUAL_size_t_MESSAGE(PKT_SIZE, dsz, msg);
+            assert_bytes_equal(pkt, dbuf, PKT_SIZE, msg);
+        }
+        TEST_ASSERT_TRUE_MESSAGE(refs_total < plain_total,
+                                 "reference history should beat the previous packet");
+
+        netc_ctx_destroy(plain);
+        netc_ctx_destroy(dec);
+        netc_ctx_destroy(enc);
+    }
+    netc_dict_free(d);
+}
+
+void test_delta_refs_bad_index_corrupt(void) {
+    /* 7.2 Packet 3 (type 0) has three same-size candidates: it ends in an
+     * index, and an index of 3 or more names no candidate */
+    netc_dict_t *d = refs_dict();
+    netc_ctx_t *enc = refs_ctx(d, NETC_CFG_FLAG_DELTA_REFS);
+    netc_ctx_t *dec = refs_ctx(d, NETC_CFG_FLAG_DELTA_REFS);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    uint8_t pkt[PKT_SIZE], cbuf[PKT_SIZE + NETC_MAX_OVERHEAD], dbuf[PKT_SIZE];
+    size_t  csz, dsz;
+    for (int p = 0; p < 4; p++) {
+        refs_packet(pkt, p);
+        TEST_ASSERT_EQUAL_INT(NETC_OK,
+            netc_compress(enc, pkt, PKT_SIZE, cbuf, sizeof(cbuf), &csz));
+        if (p < 3) {
+            TEST_ASSERT_EQUAL_INT(NETC_OK,
+                netc_decompress(dec, cbuf, csz, dbuf, sizeof(dbuf), &dsz));
+        }
+    }
+    TEST_ASSERT_TRUE(cbuf[4] & NETC_PKT_FLAG_DELTA);
+    TEST_ASSERT_EQUAL_UINT8(2u, cbuf[csz - 1]);  /* oldest of the three */
+
+    cbuf[csz - 1] = 3u;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_CORRUPT,
+        netc_decompress(dec, cbuf, csz, dbuf, sizeof(dbuf), &dsz));
+
+    netc_ctx_destroy(dec);
+    netc_ctx_destroy(enc);
+    netc_dict_free(d);
+}
+
+void test_delta_refs_reset_clears_history(void) {
+    /* 7.3 After ctx_reset the next packet has nothing to predict from */
+    netc_dict_t *d = refs_dict();
+    netc_ctx_t *enc = refs_ctx(d, NETC_CFG_FLAG_DELTA_REFS);
+    TEST_ASSERT_NOT_NULL(enc);
+
+    uint8_t pkt[PKT_SIZE], cbuf[PKT_SIZE + NETC_MAX_OVERHEAD];
+    size_t  csz;
+    for (int p = 0; p < REFS_TYPES; p++) {
+        refs_packet(pkt, p);
+        TEST_ASSERT_EQUAL_INT(NETC_OK,
+            netc_compress(enc, pkt, PKT_SIZE, cbuf, sizeof(cbuf), &csz));
+    }
+    netc_ctx_reset(enc);
+    refs_packet(pkt, REFS_TYPES);
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_compress(enc, pkt, PKT_SIZE, cbuf, sizeof(cbuf), &csz));
+    TEST_ASSERT_FALSE(cbuf[4] & NETC_PKT_FLAG_DELTA);
+
+    netc_ctx_destroy(enc);
+    netc_dict_free(d);
+}
+
 /* =========================================================================
  * main
  * ========================================================================= */
@@ -681,5 +1037,20 @@ int main(void) {
     RUN_TEST(test_delta_roundtrip_all_zeros);
     RUN_TEST(test_delta_roundtrip_all_ones);
 
+    /* 6. Operator maps */
+    RUN_TEST(test_delta_map_default_matches_legacy);
+    RUN_TEST(test_delta_map_lane_borrow);
+    RUN_TEST(test_delta_map_truncated_lane);
+    RUN_TEST(test_delta_map_order2_lane);
+    RUN_TEST(test_delta_map_valid_rejects);
+    RUN_TEST(test_delta_map_flt32);
+    RUN_TEST(test_delta_planes_runs);
+    RUN_TEST(test_delta_planes_split_merge);
+
+    /* 7. Reference history */
+    RUN_TEST(test_delta_refs_interleaved_roundtrip);
+    RUN_TEST(test_delta_refs_bad_index_corrupt);
+    RUN_TEST(test_delta_refs_reset_clears_history);
+
     return UNITY_END();
 }
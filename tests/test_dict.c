@@ -23,6 +23,37 @@
  *     - Wrong version → NETC_ERR_VERSION
  *     - Corrupt checksum → NETC_ERR_DICT_INVALID
  *     - Round-trip: train → save → load → tables valid
+ *   Multi-threaded training (train_ex):
+ *     - 0 (auto), 1, 2, 4, 7 and over-cap thread counts → blob identical to netc_dict_train
+ *     - NULL cfg → defaults; same argument checks as netc_dict_train
+ *   Dictionary image (save_image / map_image / map):
+ *     - Mapped dict compresses identically to the loaded dict, both ways
+ *     - Mapped dict re-saves to the identical v5 blob
+ *     - Map from a file; missing file → NETC_ERR_INVALID_ARG
+ *     - Corrupt / truncated image → NETC_ERR_DICT_INVALID,
+ *       foreign byte order → NETC_ERR_VERSION
+ *     - Sparse LZP table is stored packed, maps and re-saves losslessly;
+ *       bad block ranks or entry count → NETC_ERR_DICT_INVALID
+ *     - Fully occupied LZP table falls back to the dense layout
+ *   Streaming trainer (netc_trainer_*):
+ *     - NULL / reserved args rejected; NULL and empty packets skipped
+ *     - Corpus that fits the reservoir → blob identical to netc_dict_train,
+ *       also after a second finish and after reset + re-feed
+ *     - Reservoir far smaller than the corpus → valid, round-tripping dict
+ *   Learned bucket boundaries:
+ *     - Empty corpus keeps the static layout (no bucket section)
+ *     - Field-structured corpus → bucket section; blob, image and
+ *       thread counts all agree and round-trip
+ *     - Non-ascending / short bucket ends → NETC_ERR_DICT_INVALID
+ *   Learned delta operator map:
+ *     - u16 / u32 counters → SUB16 / SUB32 lanes; blob, image, streaming
+ *       trainer and thread counts all agree and round-trip
+ *     - Unknown operator, split lane, nonzero reserved byte
+ *       → NETC_ERR_DICT_INVALID
+ *   LZ77X token tables:
+ *     - Record-repeating corpus → token section; blob, image and thread
+ *       counts agree and coded tokens round-trip
+ *     - Token table not summing to the table size → NETC_ERR_DICT_INVALID
  *   model_id accessor:
  *     - NULL dict → returns 0
  *     - Valid dict → returns correct model_id
@@ -30,9 +61,11 @@
 
 #include "unity.h"
 #include "netc.h"
+#include "../src/util/netc_crc32.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /* Match the blob size from netc_dict.c */
 #define NETC_CTX_COUNT            16U
@@ -41,6 +74,20 @@
 #define NETC_TANS_SYMBOLS        256U
 #define NETC_TANS_TABLE_SIZE     4096U
 #define NETC_LZP_HT_SIZE        131072U
+#define NETC_DICT_FLAG_BUCKETS     0x02U
+#define NETC_DICT_FLAG_DELTA_MAP   0x04U
+#define NETC_DICT_FLAG_LZP2        0x08U
+#define NETC_DICT_FLAG_LZX         0x10U
+#define EXPECTED_BUCKETS_SECTION   (NETC_CTX_COUNT * 2U)
+#define EXPECTED_DELTA_MAP_SECTION (512U + 4U)
+#define EXPECTED_LZP2_SECTION      4U
+#define EXPECTED_LZX_SECTION       (4U * NETC_TANS_SYMBOLS * 2U)
+/* Size of the optional trained sections a blob's dict_flags announce */
+#define EXPECTED_OPTIONAL_SECTIONS(flags) \
+    ((((flags) & NETC_DICT_FLAG_BUCKETS) ? EXPECTED_BUCKETS_SECTION : 0U) + \
+     (((flags) & NETC_DICT_FLAG_DELTA_MAP) ? EXPECTED_DELTA_MAP_SECTION : 0U) + \
+     (((flags) & NETC_DICT_FLAG_LZP2) ? EXPECTED_LZP2_SECTION : 0U) + \
+     (((flags) & NETC_DICT_FLAG_LZX) ? EXPECTED_LZX_SECTION : 0U))
 /* v5 no LZP: 8 + 256 + 16*256*2 + 16*8*256*2 + 4 = 73996 */
 #define EXPECTED_BLOB_SIZE_V5_NOLZP (8U + 256U + \
                                      NETC_CTX_COUNT * NETC_TANS_SYMBOLS * 2U + \
@@ -401,7 +448,8 @@ void test_roundtrip_with_training_data(void) {
     void *blob = NULL;
     size_t sz = 0;
     TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(src, &blob, &sz));
-    TEST_ASSERT_EQUAL_UINT(EXPECTED_BLOB_SIZE_V5_LZP, sz);
+    TEST_ASSERT_EQUAL_UINT(EXPECTED_BLOB_SIZE_V5_LZP +
+        EXPECTED_OPTIONAL_SECTIONS(((uint8_t *)blob)[7]), sz);
 
     netc_dict_t *loaded = NULL;
     TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, sz, &loaded));
@@ -531,6 +579,7 @@ void test_v5_8class_compress_decompress_roundtrip(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(loaded, &cfg);
     TEST_ASSERT_NOT_NULL(ctx);
 
@@ -586,6 +635,1082 @@ void test_v5_version_byte_in_trained_dict(void) {
     netc_dict_free_blob(blob);
 }
 
+/* =========================================================================
+ * Trained-blob fixtures
+ *
+ * The feature tests below each supply a corpus generator; these helpers
+ * train it, locate its optional sections and stream it through a codec.
+ * ========================================================================= */
+
+#define FIXTURE_MAX_SIZE 512U  /* largest fixture packet */
+
+/* netc_dict_train_ex on threads workers (model 9), saved as a blob */
+static void *train_blob(const uint8_t *const *pkts, const size_t *sizes, size_t count,
+                        uint32_t threads, size_t *blob_sz) {
+    netc_train_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads = threads;
+    netc_dict_t *d = NULL;
+    void *blob = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train_ex(pkts, sizes, count, 9, &cfg, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob, blob_sz));
+    netc_dict_free(d);
+    return blob;
+}
+
+/* netc_trainer_finish (model 9), saved as a blob */
+static void *trainer_blob(netc_trainer_t *t, size_t *blob_sz) {
+    netc_dict_t *d = NULL;
+    void *blob = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_finish(t, 9, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob, blob_sz));
+    netc_dict_free(d);
+    return blob;
+}
+
+/* The corpus fed in order to a streaming trainer with the given reservoir */
+static void *stream_blob(const uint8_t *const *pkts, const size_t *sizes, size_t count,
+                         uint32_t reservoir, size_t *blob_sz) {
+    netc_train_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reservoir = reservoir;
+    netc_trainer_t *t = netc_trainer_create(&cfg);
+    TEST_ASSERT_NOT_NULL(t);
+    for (size_t p = 0; p < count; p++) {
+        TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_feed(t, pkts[p], sizes[p]));
+    }
+    void *blob = trainer_blob(t, blob_sz);
+    netc_trainer_destroy(t);
+    return blob;
+}
+
+/* Optional section flag of a trained blob. The sections follow the LZP
+ * table in flag order, so those with lower flags come first. */
+static uint8_t *blob_section(uint8_t *b, size_t sz, uint32_t flag) {
+    TEST_ASSERT_NOT_EQUAL(0, b[7] & flag);
+    TEST_ASSERT_EQUAL_UINT(EXPECTED_BLOB_SIZE_V5_LZP + EXPECTED_OPTIONAL_SECTIONS(b[7]), sz);
+    return b + EXPECTED_BLOB_SIZE_V5_LZP - 4U + EXPECTED_OPTIONAL_SECTIONS(b[7] & (flag - 1U));
+}
+
+/* Recompute the trailing CRC32 after editing a blob */
+static void blob_fix_crc(uint8_t *b, size_t sz) {
+    uint32_t crc = netc_crc32(b, sz - 4U);
+    for (int i = 0; i < 4; i++) b[sz - 4U + (size_t)i] = (uint8_t)(crc >> (8 * i));
+}
+
+/* The corpus as one stream through enc_dict → dec_dict; returns the total
+ * compressed size */
+static size_t roundtrip(const netc_dict_t *enc_dict, const netc_dict_t *dec_dict,
+                        const uint8_t *const *pkts, const size_t *sizes, size_t count,
+                        uint32_t flags, uint8_t level) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = flags;
+    cfg.compression_level = level;
+    netc_ctx_t *enc = netc_ctx_create(enc_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(dec_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+    uint8_t comp[FIXTURE_MAX_SIZE + NETC_MAX_OVERHEAD], out[FIXTURE_MAX_SIZE];
+    size_t  total = 0;
+    for (size_t p = 0; p < count; p++) {
+        size_t comp_sz = 0, out_sz = 0;
+        TEST_ASSERT_TRUE(sizes[p] <= FIXTURE_MAX_SIZE);
+        TEST_ASSERT_EQUAL_INT(NETC_OK,
+            netc_compress(enc, pkts[p], sizes[p], comp, sizeof(comp), &comp_sz));
+        TEST_ASSERT_EQUAL_INT(NETC_OK,
+            netc_decompress(dec, comp, comp_sz, out, sizeof(out), &out_sz));
+        TEST_ASSERT_EQUAL_UINT(sizes[p], out_sz);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(pkts[p], out, out_sz);
+        total += comp_sz;
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return total;
+}
+
+/* =========================================================================
+ * Multi-threaded training — netc_dict_train_ex
+ * ========================================================================= */
+
+#define MT_PKT_COUNT 97U
+
+/* Structured packets of varying size, plus a NULL and an empty entry that
+ * the trainer must skip identically on every shard. */
+static uint8_t        mt_buf[MT_PKT_COUNT][300];
+static const uint8_t *mt_pkts[MT_PKT_COUNT];
+static size_t         mt_sizes[MT_PKT_COUNT];
+
+static void mt_corpus_init(void) {
+    uint32_t x = 0x1234567u;
+    for (uint32_t p = 0; p < MT_PKT_COUNT; p++) {
+        x = x * 1103515245u + 12345u;
+        mt_sizes[p] = 16u + (x >> 16) % 280u;
+        for (size_t i = 0; i < mt_sizes[p]; i++) {
+            x = x * 1103515245u + 12345u;
+            mt_buf[p][i] = (i % 4u == 0) ? (uint8_t)(p + i)
+                                         : (uint8_t)((x >> 24) & 0x0Fu);
+        }
+        mt_pkts[p] = mt_buf[p];
+    }
+    mt_pkts[10]  = NULL;
+    mt_sizes[11] = 0;
+}
+
+void test_train_ex_matches_serial(void) {
+    mt_corpus_init();
+    netc_dict_t *ref = NULL;
+    void *ref_blob = NULL;
+    size_t ref_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_dict_train(mt_pkts, mt_sizes, MT_PKT_COUNT, 9, &ref));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(ref, &ref_blob, &ref_sz));
+    netc_dict_free(ref);
+
+    /* 0 = auto; 200 exceeds both the packet count and NETC_MAX_THREADS */
+    static const uint32_t threads[] = { 0, 1, 2, 4, 7, 200 };
+    for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        size_t sz = 0;
+        void *blob = train_blob(mt_pkts, mt_sizes, MT_PKT_COUNT, threads[i], &sz);
+        TEST_ASSERT_EQUAL_UINT(ref_sz, sz);
+        TEST_ASSERT_EQUAL_MEMORY(ref_blob, blob, ref_sz);
+        netc_dict_free_blob(blob);
+    }
+    netc_dict_free_blob(ref_blob);
+}
+
+void test_train_ex_null_cfg(void) {
+    mt_corpus_init();
+    netc_dict_t *d = NULL;
+    void *a = NULL;
+    size_t sz_a = 0, sz_b = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_dict_train_ex(mt_pkts, mt_sizes, MT_PKT_COUNT, 9, NULL, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &a, &sz_a));
+    netc_dict_free(d);
+    void *b = train_blob(mt_pkts, mt_sizes, MT_PKT_COUNT, 1, &sz_b);
+    TEST_ASSERT_EQUAL_UINT(sz_b, sz_a);
+    TEST_ASSERT_EQUAL_MEMORY(b, a, sz_a);
+    netc_dict_free_blob(a);
+    netc_dict_free_blob(b);
+
+    d = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_dict_train_ex(mt_pkts, mt_sizes, MT_PKT_COUNT, 0, NULL, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train_ex(NULL, NULL, 0, 9, NULL, &d));
+    netc_dict_free(d);
+}
+
+/* =========================================================================
+ * Dictionary image — netc_dict_save_image / netc_dict_map_image / netc_dict_map
+ * ========================================================================= */
+
+static netc_dict_t *train_abc(void) {
+    netc_dict_t *d = NULL;
+    const uint8_t *pkts[] = { PKT_A, PKT_B, PKT_C };
+    size_t         szs[]  = { sizeof(PKT_A), sizeof(PKT_B), sizeof(PKT_C) };
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train(pkts, szs, 3, 21, &d));
+    return d;
+}
+
+/* Compress pkt with a and decompress with b; returns the compressed size. */
+static size_t cross_roundtrip(const netc_dict_t *a, const netc_dict_t *b,
+                              const uint8_t *pkt, size_t pkt_sz,
+                              uint8_t *comp, size_t comp_cap) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
+    netc_ctx_t *enc = netc_ctx_create(a, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(b, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    size_t comp_sz = 0, out_sz = 0;
+    uint8_t out[512];
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_compress(enc, pkt, pkt_sz, comp, comp_cap, &comp_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK,
+        netc_decompress(dec, comp, comp_sz, out, sizeof(out), &out_sz));
+    TEST_ASSERT_EQUAL_UINT(pkt_sz, out_sz);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pkt, out, pkt_sz);
+
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return comp_sz;
+}
+
+void test_image_null_args(void) {
+    netc_dict_t *d = train_abc();
+    void *img = NULL;
+    size_t sz = 0;
+    netc_dict_t *m = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_dict_save_image(NULL, &img, &sz));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_dict_save_image(d, NULL, &sz));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_dict_map_image(NULL, 0, &m));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_dict_map(NULL, &m));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_dict_map("test_dict_image.bin", NULL));
+    netc_dict_free(d);
+}
+
+void test_image_map_matches_load(void) {
+    netc_dict_t *d = train_abc();
+    void *blob = NULL, *img = NULL;
+    size_t blob_sz = 0, img_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob, &blob_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+
+    netc_dict_t *loaded = NULL, *mapped = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, blob_sz, &loaded));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &mapped));
+    TEST_ASSERT_EQUAL_UINT8(21, netc_dict_model_id(mapped));
+
+    /* Identical wire output from the built tables, decodable either way */
+    const uint8_t *pkts[] = { PKT_A, PKT_B, PKT_C };
+    size_t         szs[]  = { sizeof(PKT_A), sizeof(PKT_B), sizeof(PKT_C) };
+    for (int i = 0; i < 3; i++) {
+        uint8_t c1[1024], c2[1024];
+        size_t n1 = cross_roundtrip(loaded, mapped, pkts[i], szs[i], c1, sizeof(c1));
+        size_t n2 = cross_roundtrip(mapped, loaded, pkts[i], szs[i], c2, sizeof(c2));
+        TEST_ASSERT_EQUAL_UINT(n1, n2);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(c1, c2, n1);
+    }
+
+    /* The mapped dict still serializes to the identical v5 blob */
+    void *blob2 = NULL;
+    size_t blob2_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(mapped, &blob2, &blob2_sz));
+    TEST_ASSERT_EQUAL_UINT(blob_sz, blob2_sz);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob2, blob_sz);
+
+    netc_dict_free_blob(blob2);
+    netc_dict_free(mapped);  /* borrowed image: must not be freed here */
+    netc_dict_free(loaded);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob);
+}
+
+void test_image_map_file(void) {
+    static const char *path = "test_dict_image.bin";
+    netc_dict_t *d = train_abc();
+    void *img = NULL;
+    size_t img_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_UINT(img_sz, fwrite(img, 1, img_sz, f));
+    fclose(f);
+
+    netc_dict_t *mapped = NULL;
+    netc_result_t rc = netc_dict_map(path, &mapped);
+    remove(path);  /* the mapping stays valid after unlink on POSIX */
+    if (rc == NETC_ERR_UNSUPPORTED) {
+        netc_dict_free(d);
+        netc_dict_free_blob(img);
+        TEST_IGNORE_MESSAGE("no memory-mapped files on this platform");
+    }
+    TEST_ASSERT_EQUAL_INT(NETC_OK, rc);
+
+    uint8_t c1[1024], c2[1024];
+    size_t n1 = cross_roundtrip(d, mapped, PKT_C, sizeof(PKT_C), c1, sizeof(c1));
+    size_t n2 = cross_roundtrip(mapped, d, PKT_C, sizeof(PKT_C), c2, sizeof(c2));
+    TEST_ASSERT_EQUAL_UINT(n1, n2);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(c1, c2, n1);
+
+    netc_dict_free(mapped);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG,
+        netc_dict_map("test_dict_image_missing.bin", &mapped));
+}
+
+void test_image_corrupt_rejected(void) {
+    netc_dict_t *d = train_abc();
+    void *img = NULL, *blob = NULL;
+    size_t img_sz = 0, blob_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob, &blob_sz));
+    uint8_t *b = (uint8_t *)img;
+    netc_dict_t *m = NULL;
+
+    /* Truncated */
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_map_image(img, img_sz - 1, &m));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_map_image(img, 16, &m));
+
+    /* One flipped bit in the middle of the tables */
+    b[img_sz / 2] ^= 0x01;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_map_image(img, img_sz, &m));
+    b[img_sz / 2] ^= 0x01;
+
+    /* Written with a different byte order (byte_order field at offset 4) */
+    b[4] ^= 0xFF;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_VERSION, netc_dict_map_image(img, img_sz, &m));
+    b[4] ^= 0xFF;
+
+    /* Blob and image are not interchangeable */
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_map_image(blob, blob_sz, &m));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(img, img_sz, &m));
+
+    /* Restored image still maps */
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+    netc_dict_free(m);
+
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob);
+}
+
+/* =========================================================================
+ * Streaming trainer — netc_trainer_*
+ * ========================================================================= */
+
+void test_trainer_null_args(void) {
+    netc_dict_t *d = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_trainer_feed(NULL, PKT_A, sizeof(PKT_A)));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_trainer_finish(NULL, 9, &d));
+    TEST_ASSERT_EQUAL_UINT64(0, netc_trainer_count(NULL));
+    netc_trainer_destroy(NULL);
+    netc_trainer_reset(NULL);
+
+    netc_trainer_t *t = netc_trainer_create(NULL);
+    TEST_ASSERT_NOT_NULL(t);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_trainer_finish(t, 9, NULL));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_trainer_finish(t, 0, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_INVALID_ARG, netc_trainer_finish(t, 255, &d));
+    /* Skipped like netc_dict_train skips them */
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_feed(t, NULL, 10));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_feed(t, PKT_A, 0));
+    TEST_ASSERT_EQUAL_UINT64(0, netc_trainer_count(t));
+    netc_trainer_destroy(t);
+}
+
+void test_trainer_matches_train_when_reservoir_fits(void) {
+    mt_corpus_init();
+    size_t ref_sz = 0;
+    void *ref = train_blob(mt_pkts, mt_sizes, MT_PKT_COUNT, 0, &ref_sz);
+
+    netc_train_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads   = 3;
+    cfg.reservoir = MT_PKT_COUNT;
+    netc_trainer_t *t = netc_trainer_create(&cfg);
+    TEST_ASSERT_NOT_NULL(t);
+    for (uint32_t p = 0; p < MT_PKT_COUNT; p++) {
+        TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_feed(t, mt_pkts[p], mt_sizes[p]));
+    }
+    TEST_ASSERT_EQUAL_UINT64(MT_PKT_COUNT - 2U, netc_trainer_count(t));
+
+    size_t sz = 0;
+    void *blob = trainer_blob(t, &sz);
+    TEST_ASSERT_EQUAL_UINT(ref_sz, sz);
+    TEST_ASSERT_EQUAL_MEMORY(ref, blob, ref_sz);
+    netc_dict_free_blob(blob);
+
+    /* finish leaves the trainer intact; reset starts a fresh corpus */
+    blob = trainer_blob(t, &sz);
+    TEST_ASSERT_EQUAL_MEMORY(ref, blob, ref_sz);
+    netc_dict_free_blob(blob);
+    netc_trainer_reset(t);
+    TEST_ASSERT_EQUAL_UINT64(0, netc_trainer_count(t));
+    for (uint32_t p = 0; p < MT_PKT_COUNT; p++) {
+        TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_feed(t, mt_pkts[p], mt_sizes[p]));
+    }
+    blob = trainer_blob(t, &sz);
+    TEST_ASSERT_EQUAL_MEMORY(ref, blob, ref_sz);
+    netc_dict_free_blob(blob);
+
+    netc_trainer_destroy(t);
+    netc_dict_free_blob(ref);
+}
+
+void test_trainer_small_reservoir_roundtrip(void) {
+    mt_corpus_init();
+    netc_train_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reservoir = 8;
+    netc_trainer_t *t = netc_trainer_create(&cfg);
+    TEST_ASSERT_NOT_NULL(t);
+    /* Several passes over the corpus: far more packets than the reservoir */
+    for (int pass = 0; pass < 5; pass++) {
+        for (uint32_t p = 0; p < MT_PKT_COUNT; p++) {
+            TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_feed(t, mt_pkts[p], mt_sizes[p]));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT64(5U * (MT_PKT_COUNT - 2U), netc_trainer_count(t));
+
+    netc_dict_t *d = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_trainer_finish(t, 9, &d));
+    TEST_ASSERT_EQUAL_UINT8(9, netc_dict_model_id(d));
+    netc_trainer_destroy(t);
+
+    /* The dictionary must round-trip packets it never sampled */
+    uint8_t comp[512];
+    for (uint32_t p = 20; p < 30; p++) {
+        (void)cross_roundtrip(d, d, mt_pkts[p], mt_sizes[p], comp, sizeof(comp));
+    }
+    netc_dict_free(d);
+}
+
+/* =========================================================================
+ * Learned bucket boundaries
+ * ========================================================================= */
+
+#define FIELD_PKT_COUNT 64U
+#define FIELD_PKT_SIZE  128U
+static uint8_t        field_data[FIELD_PKT_COUNT][FIELD_PKT_SIZE];
+static const uint8_t *field_pkts[FIELD_PKT_COUNT];
+static size_t         field_sizes[FIELD_PKT_COUNT];
+
+/* Every 8-byte group draws from its own 4-symbol alphabet, so finer buckets
+ * than the static 16/32-byte bands beyond offset 32 code it smaller. */
+static void field_corpus_init(void) {
+    uint32_t x = 12345u;
+    for (uint32_t p = 0; p < FIELD_PKT_COUNT; p++) {
+        for (uint32_t i = 0; i < FIELD_PKT_SIZE; i++) {
+            x = x * 1103515245u + 12345u;
+            field_data[p][i] = (uint8_t)((i / 8u) * 16u + ((x >> 16) & 3u));
+        }
+        field_pkts[p]  = field_data[p];
+        field_sizes[p] = FIELD_PKT_SIZE;
+    }
+}
+
+void test_buckets_static_for_empty_corpus(void) {
+    netc_dict_t *d = NULL;
+    void *blob = NULL;
+    size_t sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train(NULL, NULL, 0, 9, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob, &sz));
+    TEST_ASSERT_EQUAL_UINT8(0, ((uint8_t *)blob)[7] & NETC_DICT_FLAG_BUCKETS);
+    TEST_ASSERT_EQUAL_UINT(EXPECTED_BLOB_SIZE_V5_LZP, sz);
+    netc_dict_free(d);
+    netc_dict_free_blob(blob);
+}
+
+void test_buckets_learned_roundtrip(void) {
+    field_corpus_init();
+    size_t sz = 0;
+    void *blob = train_blob(field_pkts, field_sizes, FIELD_PKT_COUNT, 1, &sz);
+    const uint8_t *b = (const uint8_t *)blob;
+    TEST_ASSERT_NOT_EQUAL(0, b[7] & NETC_DICT_FLAG_BUCKETS);
+    TEST_ASSERT_EQUAL_UINT(EXPECTED_BLOB_SIZE_V5_LZP + EXPECTED_OPTIONAL_SECTIONS(b[7]), sz);
+
+    /* Same boundaries for any thread count */
+    size_t sz3 = 0;
+    void *blob3 = train_blob(field_pkts, field_sizes, FIELD_PKT_COUNT, 3, &sz3);
+    TEST_ASSERT_EQUAL_UINT(sz, sz3);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob3, sz);
+    netc_dict_free_blob(blob3);
+
+    /* blob → load → save is lossless; loaded and mapped dicts interoperate */
+    netc_dict_t *d = NULL, *m = NULL;
+    void *blob2 = NULL, *img = NULL;
+    size_t sz2 = 0, img_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, sz, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob2, &sz2));
+    TEST_ASSERT_EQUAL_UINT(sz, sz2);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob2, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+
+    uint8_t comp[512];
+    for (uint32_t p = 0; p < 8; p++) {
+        size_t a = cross_roundtrip(d, m, field_pkts[p], FIELD_PKT_SIZE, comp, sizeof(comp));
+        size_t c = cross_roundtrip(m, d, field_pkts[p], FIELD_PKT_SIZE, comp, sizeof(comp));
+        TEST_ASSERT_EQUAL_UINT(a, c);
+        TEST_ASSERT_TRUE(a < FIELD_PKT_SIZE);
+    }
+
+    netc_dict_free(m);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob2);
+    netc_dict_free_blob(blob);
+}
+
+void test_buckets_bad_boundaries_rejected(void) {
+    field_corpus_init();
+    size_t sz = 0;
+    uint8_t *b = (uint8_t *)train_blob(field_pkts, field_sizes, FIELD_PKT_COUNT, 1, &sz);
+    uint8_t *ends = blob_section(b, sz, NETC_DICT_FLAG_BUCKETS);
+    netc_dict_t *d = NULL;
+
+    /* ends[2] == ends[1]: an empty bucket */
+    uint8_t saved[EXPECTED_BUCKETS_SECTION];
+    memcpy(saved, ends, sizeof(saved));
+    ends[4] = ends[2];
+    ends[5] = ends[3];
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Last bucket stops short of offset 65536 */
+    memcpy(ends, saved, sizeof(saved));
+    ends[EXPECTED_BUCKETS_SECTION - 1U] = 0x10;
+    ends[EXPECTED_BUCKETS_SECTION - 2U] = 0x00;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Restored section loads again */
+    memcpy(ends, saved, sizeof(saved));
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(b, sz, &d));
+    netc_dict_free(d);
+    netc_dict_free_blob(b);
+}
+
+/* =========================================================================
+ * Learned delta operator map
+ * ========================================================================= */
+
+#define CTR_PKT_COUNT 64U
+#define CTR_PKT_SIZE  128U
+static uint8_t        ctr_data[CTR_PKT_COUNT][CTR_PKT_SIZE];
+static const uint8_t *ctr_pkts[CTR_PKT_COUNT];
+static size_t         ctr_sizes[CTR_PKT_COUNT];
+
+/* Random 0x81 / 0x00 filler with a little-endian u16 counter at offset 64
+ * and a u32 counter at offset 96. The steps carry out of the low byte about
+ * half the time: byte-wise SUB leaves residuals 0x82 / 0x01 the tables have
+ * never seen, while the wide lane operators leave only 0x81 / 0x00. Eight
+ * more u32 counters at 32..63 form a run worth byte planes (AD-021). */
+static void ctr_corpus_init(void) {
+    uint32_t x = 777u;
+    for (uint32_t p = 0; p < CTR_PKT_COUNT; p++) {
+        for (uint32_t i = 0; i < CTR_PKT_SIZE; i++) {
+            x = x * 1103515245u + 12345u;
+            ctr_data[p][i] = (uint8_t)(((x >> 16) & 1u) ? 0x81u : 0x00u);
+        }
+        uint32_t c16 = 0x1234u + p * 0x0081u;
+        uint32_t c32 = 0x89ABCDEFu + p * 0x00818181u;
+        ctr_data[p][64] = (uint8_t)c16;
+        ctr_data[p][65] = (uint8_t)(c16 >> 8);
+        for (int k = 0; k < 4; k++) ctr_data[p][96 + k] = (uint8_t)(c32 >> (8 * k));
+        for (uint32_t j = 0; j < 8U; j++) {
+            uint32_t v = 0x89ABCDEFu * (j + 1U) + p * 0x00818181u;
+            for (int k = 0; k < 4; k++) ctr_data[p][32 + 4 * j + k] = (uint8_t)(v >> (8 * k));
+        }
+        ctr_pkts[p]  = ctr_data[p];
+        ctr_sizes[p] = CTR_PKT_SIZE;
+    }
+}
+
+void test_delta_map_learned_roundtrip(void) {
+    ctr_corpus_init();
+    size_t sz = 0;
+    void *blob = train_blob(ctr_pkts, ctr_sizes, CTR_PKT_COUNT, 1, &sz);
+    uint8_t *b = (uint8_t *)blob;
+
+    /* ops: 0 XOR, 1 SUB, 2 NONE, 3 SUB16, 4 SUB32; then tail, planes */
+    const uint8_t *ops = blob_section(b, sz, NETC_DICT_FLAG_DELTA_MAP);
+    TEST_ASSERT_EQUAL_UINT8(3U, ops[64]);
+    TEST_ASSERT_EQUAL_UINT8(3U, ops[65]);
+    for (int k = 0; k < 4; k++) TEST_ASSERT_EQUAL_UINT8(4U, ops[96 + k]);
+    for (int i = 32; i < 64; i++) TEST_ASSERT_EQUAL_UINT8(4U, ops[i]);
+    TEST_ASSERT_EQUAL_UINT8(1U, ops[512U + 1U]);
+
+    /* Same map for any thread count and for the streaming trainer */
+    size_t sz3 = 0;
+    void *blob3 = train_blob(ctr_pkts, ctr_sizes, CTR_PKT_COUNT, 3, &sz3);
+    TEST_ASSERT_EQUAL_UINT(sz, sz3);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob3, sz);
+    netc_dict_free_blob(blob3);
+
+    size_t tsz = 0;
+    void *tblob = stream_blob(ctr_pkts, ctr_sizes, CTR_PKT_COUNT, CTR_PKT_COUNT, &tsz);
+    TEST_ASSERT_EQUAL_UINT(sz, tsz);
+    TEST_ASSERT_EQUAL_MEMORY(blob, tblob, sz);
+    netc_dict_free_blob(tblob);
+
+    /* blob → load → save is lossless; loaded and mapped dicts interoperate */
+    netc_dict_t *d = NULL, *m = NULL;
+    void *blob2 = NULL, *img = NULL;
+    size_t sz2 = 0, img_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, sz, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob2, &sz2));
+    TEST_ASSERT_EQUAL_UINT(sz, sz2);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob2, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+
+    /* A stateful stream exercises the mapped delta */
+    (void)roundtrip(d, m, ctr_pkts, ctr_sizes, CTR_PKT_COUNT,
+                    NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA |
+                    NETC_CFG_FLAG_COMPACT_HDR, 5);
+
+    netc_dict_free(m);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob2);
+    netc_dict_free_blob(blob);
+}
+
+void test_delta_map_bad_ops_rejected(void) {
+    ctr_corpus_init();
+    size_t sz = 0;
+    uint8_t *b = (uint8_t *)train_blob(ctr_pkts, ctr_sizes, CTR_PKT_COUNT, 1, &sz);
+    uint8_t *ops = blob_section(b, sz, NETC_DICT_FLAG_DELTA_MAP);
+    uint8_t saved[EXPECTED_DELTA_MAP_SECTION];
+    memcpy(saved, ops, sizeof(saved));
+    netc_dict_t *d = NULL;
+
+    /* Unknown operator */
+    ops[10] = 7U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* SUB32 lane with one byte missing */
+    memcpy(ops, saved, sizeof(saved));
+    ops[97] = 1U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* SUB16 lane at an odd offset */
+    memcpy(ops, saved, sizeof(saved));
+    ops[1] = 3U;
+    ops[2] = 3U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Planes flag other than 0 / 1 */
+    memcpy(ops, saved, sizeof(saved));
+    ops[512U + 1U] = 2U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Reserved byte after the planes flag */
+    memcpy(ops, saved, sizeof(saved));
+    ops[EXPECTED_DELTA_MAP_SECTION - 1U] = 1U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Restored section loads again */
+    memcpy(ops, saved, sizeof(saved));
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(b, sz, &d));
+    netc_dict_free(d);
+    netc_dict_free_blob(b);
+}
+
+/* =========================================================================
+ * Dual-order LZP
+ * ========================================================================= */
+
+#define TAG_PKT_COUNT 256U
+#define TAG_PKT_SIZE  96U
+static uint8_t        tag_data[TAG_PKT_COUNT][TAG_PKT_SIZE];
+static const uint8_t *tag_pkts[TAG_PKT_COUNT];
+static size_t         tag_sizes[TAG_PKT_COUNT];
+/* Streams run at level 7, which tries LZP on every packet. A third of every
+ * packet is predicted, so a stream codes below TAG_BYTES. */
+#define TAG_LEVEL 7U
+#define TAG_BYTES ((size_t)TAG_PKT_COUNT * TAG_PKT_SIZE)
+
+/* Triples (a, b, value): two random tag bytes from {0..3} select the value.
+ * Given only b, the value is one of four equally likely bytes, below the
+ * 40% vote threshold; given (a, b) it is certain. */
+static void tag_corpus_init(void) {
+    uint32_t x = 4242u;
+    for (uint32_t p = 0; p < TAG_PKT_COUNT; p++) {
+        for (uint32_t i = 0; i + 2U < TAG_PKT_SIZE; i += 3U) {
+            x = x * 1103515245u + 12345u;
+            uint8_t a = (uint8_t)((x >> 16) & 3u);
+            uint8_t b = (uint8_t)((x >> 20) & 3u);
+            tag_data[p][i]     = a;
+            tag_data[p][i + 1] = b;
+            tag_data[p][i + 2] = (uint8_t)((a * 4u + b) * 17u + 1u);
+        }
+        tag_pkts[p]  = tag_data[p];
+        tag_sizes[p] = TAG_PKT_SIZE;
+    }
+}
+
+void test_lzp2_learned_roundtrip(void) {
+    tag_corpus_init();
+    size_t sz = 0;
+    void *blob = train_blob(tag_pkts, tag_sizes, TAG_PKT_COUNT, 1, &sz);
+    uint8_t *b = (uint8_t *)blob;
+    const uint8_t *sec = blob_section(b, sz, NETC_DICT_FLAG_LZP2);
+    TEST_ASSERT_EQUAL_UINT8(2U, sec[0]);
+
+    /* Same choice and table for any thread count and the streaming trainer */
+    size_t sz3 = 0;
+    void *blob3 = train_blob(tag_pkts, tag_sizes, TAG_PKT_COUNT, 3, &sz3);
+    TEST_ASSERT_EQUAL_UINT(sz, sz3);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob3, sz);
+    netc_dict_free_blob(blob3);
+
+    size_t tsz = 0;
+    void *tblob = stream_blob(tag_pkts, tag_sizes, TAG_PKT_COUNT, TAG_PKT_COUNT, &tsz);
+    TEST_ASSERT_EQUAL_UINT(sz, tsz);
+    TEST_ASSERT_EQUAL_MEMORY(blob, tblob, sz);
+    netc_dict_free_blob(tblob);
+
+    /* blob → load → save is lossless; loaded and mapped dicts interoperate */
+    netc_dict_t *d = NULL, *m = NULL;
+    void *blob2 = NULL, *img = NULL;
+    size_t sz2 = 0, img_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, sz, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob2, &sz2));
+    TEST_ASSERT_EQUAL_UINT(sz, sz2);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob2, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+
+    TEST_ASSERT_TRUE(roundtrip(d, m, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR,
+                               TAG_LEVEL) < TAG_BYTES);
+    TEST_ASSERT_TRUE(roundtrip(d, m, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_ADAPTIVE |
+                               NETC_CFG_FLAG_COMPACT_HDR, TAG_LEVEL) < TAG_BYTES);
+    TEST_ASSERT_TRUE(roundtrip(m, d, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATELESS, TAG_LEVEL) < TAG_BYTES);
+
+    uint8_t comp[TAG_PKT_SIZE + NETC_MAX_OVERHEAD], out[TAG_PKT_SIZE];
+    size_t comp_sz = 0, out_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_compress_stateless(d, tag_pkts[5], TAG_PKT_SIZE,
+                                                           comp, sizeof(comp), &comp_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_decompress_stateless(m, comp, comp_sz,
+                                                             out, sizeof(out), &out_sz));
+    TEST_ASSERT_EQUAL_UINT(TAG_PKT_SIZE, out_sz);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tag_pkts[5], out, TAG_PKT_SIZE);
+
+    netc_dict_free(m);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob2);
+    netc_dict_free_blob(blob);
+}
+
+void test_lzp2_bad_section_rejected(void) {
+    tag_corpus_init();
+    size_t sz = 0;
+    uint8_t *b = (uint8_t *)train_blob(tag_pkts, tag_sizes, TAG_PKT_COUNT, 1, &sz);
+    uint8_t *sec = blob_section(b, sz, NETC_DICT_FLAG_LZP2);
+    netc_dict_t *d = NULL;
+
+    /* Unknown context order */
+    sec[0] = 3U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Reserved byte */
+    sec[0] = 2U;
+    sec[3] = 1U;
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* A reader that does not know the flag sees a section too many */
+    sec[3] = 0U;
+    b[7] = (uint8_t)(b[7] & ~NETC_DICT_FLAG_LZP2);
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &d));
+
+    /* Restored section loads again */
+    b[7] = (uint8_t)(b[7] | NETC_DICT_FLAG_LZP2);
+    blob_fix_crc(b, sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(b, sz, &d));
+    netc_dict_free(d);
+    netc_dict_free_blob(b);
+}
+
+/* Game-state packets: an id, a counter and random fields between zero
+ * padding. Order-2 contexts memorise the random bytes of the training
+ * slice, so the dual-order table predicts more of it and less of the
+ * next slice. */
+#define GS_PKT_COUNT 1024U
+#define GS_PKT_SIZE  64U
+static uint8_t        gs_data[GS_PKT_COUNT][GS_PKT_SIZE];
+static const uint8_t *gs_pkts[GS_PKT_COUNT];
+static size_t         gs_sizes[GS_PKT_COUNT];
+
+static void gs_corpus_init(void) {
+    uint32_t x = 0x9E3779B9u;
+    memset(gs_data, 0, sizeof(gs_data));
+    for (uint32_t p = 0; p < GS_PKT_COUNT; p++) {
+        uint8_t *b = gs_data[p];
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        b[0] = (uint8_t)(x % 250u);
+        b[1] = (uint8_t)(x >> 29);
+        b[4] = (uint8_t)p;
+        b[5] = (uint8_t)(p >> 8);
+        b[16] = (uint8_t)(1u << ((x >> 8) % 8u));
+        for (uint32_t i = 32; i < 56; i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            b[i] = (i % 4u == 3u) ? (uint8_t)(0x40u + (x & 3u)) : (uint8_t)x;
+        }
+        gs_pkts[p]  = b;
+        gs_sizes[p] = GS_PKT_SIZE;
+    }
+}
+
+/* Bytes the second half of a corpus codes to (stateful, delta, level 5)
+ * with a dictionary trained on the first half at the given LZP order;
+ * *lzp2 receives whether that dictionary is dual-order. */
+static size_t lzp_slice_coded(const uint8_t *const *pkts, const size_t *sizes,
+                              size_t count, uint32_t lzp_order, int *lzp2) {
+    size_t half = count / 2U;
+    netc_train_cfg_t tcfg;
+    memset(&tcfg, 0, sizeof(tcfg));
+    tcfg.threads   = 1;
+    tcfg.lzp_order = lzp_order;
+    netc_dict_t *d = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_train_ex(pkts, sizes, half, 9, &tcfg, &d));
+    void *blob = NULL;
+    size_t sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob, &sz));
+    *lzp2 = (((const uint8_t *)blob)[7] & NETC_DICT_FLAG_LZP2) != 0;
+    netc_dict_free_blob(blob);
+    size_t coded = roundtrip(d, d, pkts + half, sizes + half, count - half,
+                             NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA, 5);
+    netc_dict_free(d);
+    return coded;
+}
+
+void test_lzp2_never_loses_held_out(void) {
+    int lzp2 = 0;
+
+    /* Forcing the dual-order table loses on the next slice; the trainer
+     * keeps order-1 */
+    gs_corpus_init();
+    size_t o1 = lzp_slice_coded(gs_pkts, gs_sizes, GS_PKT_COUNT, 1, &lzp2);
+    TEST_ASSERT_FALSE(lzp2);
+    size_t o2 = lzp_slice_coded(gs_pkts, gs_sizes, GS_PKT_COUNT, 2, &lzp2);
+    TEST_ASSERT_TRUE(lzp2);
+    TEST_ASSERT_TRUE(o2 > o1);
+    TEST_ASSERT_EQUAL_UINT(o1, lzp_slice_coded(gs_pkts, gs_sizes, GS_PKT_COUNT, 0, &lzp2));
+    TEST_ASSERT_FALSE(lzp2);
+
+    /* Tag pairs generalise: the trainer keeps the dual-order table */
+    tag_corpus_init();
+    o1 = lzp_slice_coded(tag_pkts, tag_sizes, TAG_PKT_COUNT, 1, &lzp2);
+    o2 = lzp_slice_coded(tag_pkts, tag_sizes, TAG_PKT_COUNT, 2, &lzp2);
+    TEST_ASSERT_TRUE(o2 < o1);
+    TEST_ASSERT_EQUAL_UINT(o2, lzp_slice_coded(tag_pkts, tag_sizes, TAG_PKT_COUNT, 0, &lzp2));
+    TEST_ASSERT_TRUE(lzp2);
+}
+
+/* =========================================================================
+ * LZ77X token tables (NETC_DICT_FLAG_LZX, AD-031)
+ *
+ * Inventory packets repeat 8-byte records of earlier packets, so the
+ * trainer's LZ77X parse yields references and the dictionary keeps token
+ * tables; the coded tokens then decode with loaded and mapped copies.
+ * ========================================================================= */
+
+#define REC_PKT_COUNT 400U
+#define REC_MAX_SIZE  (2U + 11U * 8U)
+static uint8_t        rec_data[REC_PKT_COUNT][REC_MAX_SIZE];
+static const uint8_t *rec_pkts[REC_PKT_COUNT];
+static size_t         rec_sizes[REC_PKT_COUNT];
+
+static void rec_corpus_init(void) {
+    uint8_t  recs[32 * 8];
+    uint32_t x = 0x2545F491u;
+    for (size_t r = 0; r < sizeof(recs); r++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        recs[r] = (uint8_t)x;
+    }
+    for (uint32_t p = 0; p < REC_PKT_COUNT; p++) {
+        uint8_t *b = rec_data[p];
+        size_t   n = 0;
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        b[n++] = 0x30;
+        b[n++] = (uint8_t)p;
+        for (uint32_t k = 4u + x % 8u; k > 0; k--, n += 8) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            memcpy(b + n, recs + (x % 32u) * 8u, 8);
+        }
+        rec_pkts[p]  = b;
+        rec_sizes[p] = n;
+    }
+}
+
+void test_lzx_tables_roundtrip(void) {
+    rec_corpus_init();
+    size_t sz = 0;
+    void *blob = train_blob(rec_pkts, rec_sizes, REC_PKT_COUNT, 1, &sz);
+    uint8_t *b = (uint8_t *)blob;
+    uint8_t *sec = blob_section(b, sz, NETC_DICT_FLAG_LZX);
+
+    /* The parse is serial: same tables for any thread count */
+    size_t sz3 = 0;
+    void *blob3 = train_blob(rec_pkts, rec_sizes, REC_PKT_COUNT, 3, &sz3);
+    TEST_ASSERT_EQUAL_UINT(sz, sz3);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob3, sz);
+    netc_dict_free_blob(blob3);
+
+    /* Loaded and mapped copies decode each other's tokens */
+    netc_dict_t *d = NULL, *m = NULL, *plain = NULL;
+    void *img = NULL;
+    size_t img_sz = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, sz, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+    size_t coded = roundtrip(d, m, rec_pkts, rec_sizes, REC_PKT_COUNT,
+                             NETC_CFG_FLAG_STATEFUL, 5);
+    TEST_ASSERT_EQUAL_UINT(coded, roundtrip(m, d, rec_pkts, rec_sizes, REC_PKT_COUNT,
+                                            NETC_CFG_FLAG_STATEFUL, 5));
+
+    /* The same dictionary without its token tables (the last section) codes
+     * the stream larger, so the tables were used */
+    size_t   plain_sz = sz - EXPECTED_LZX_SECTION;
+    uint8_t *pb       = (uint8_t *)malloc(plain_sz);
+    TEST_ASSERT_NOT_NULL(pb);
+    memcpy(pb, b, plain_sz - 4U);
+    pb[7] = (uint8_t)(pb[7] & ~NETC_DICT_FLAG_LZX);
+    blob_fix_crc(pb, plain_sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(pb, plain_sz, &plain));
+    TEST_ASSERT_TRUE(coded < roundtrip(plain, plain, rec_pkts, rec_sizes, REC_PKT_COUNT,
+                                       NETC_CFG_FLAG_STATEFUL, 5));
+
+    /* A token table whose frequencies do not sum to the table size */
+    sec[0] = (uint8_t)(sec[0] + 1U);
+    blob_fix_crc(b, sz);
+    netc_dict_t *bad = NULL;
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_load(b, sz, &bad));
+
+    free(pb);
+    netc_dict_free(plain);
+    netc_dict_free(m);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob);
+}
+
+/* The streaming trainer counts tokens as packets arrive, so a reservoir
+ * that reshuffles the corpus still yields the tables of the ordered parse */
+void test_lzx_trainer_arrival_order(void) {
+    rec_corpus_init();
+    size_t ref_sz = 0, sz = 0;
+    void *ref = train_blob(rec_pkts, rec_sizes, REC_PKT_COUNT, 1, &ref_sz);
+    void *blob = stream_blob(rec_pkts, rec_sizes, REC_PKT_COUNT, REC_PKT_COUNT, &sz);
+    TEST_ASSERT_EQUAL_UINT(ref_sz, sz);
+    TEST_ASSERT_EQUAL_MEMORY(ref, blob, ref_sz);
+    netc_dict_free_blob(blob);
+
+    blob = stream_blob(rec_pkts, rec_sizes, REC_PKT_COUNT, 16, &sz);
+    TEST_ASSERT_EQUAL_MEMORY(blob_section((uint8_t *)ref, ref_sz, NETC_DICT_FLAG_LZX),
+                             blob_section((uint8_t *)blob, sz, NETC_DICT_FLAG_LZX),
+                             EXPECTED_LZX_SECTION);
+    netc_dict_free_blob(blob);
+    netc_dict_free_blob(ref);
+}
+
+/* Blob LZP entries (value, valid) start after the base tables and lzp_ht_size */
+#define TAG_BLOB_LZP_ENTRIES 73996U
+/* Image header fields (netc_dict_image_hdr_t) */
+#define IMG_LZP_COUNT_OFF    36U
+#define IMG_LZP_OFFSET_OFF   48U
+
+static uint32_t img_u32(const uint8_t *b, size_t off) {
+    uint32_t v;
+    memcpy(&v, b + off, sizeof(v));
+    return v;
+}
+
+void test_image_lzp_packed(void) {
+    tag_corpus_init();
+    size_t sz = 0;
+    void *blob = train_blob(tag_pkts, tag_sizes, TAG_PKT_COUNT, 1, &sz);
+    netc_dict_t *d = NULL, *m = NULL;
+    void *img = NULL, *blob2 = NULL;
+    size_t img_sz = 0, sz2 = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(blob, sz, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    uint8_t *b = (uint8_t *)img;
+
+    /* A sparse table is stored packed: the last section, smaller than the
+     * dense entries alone */
+    uint32_t count = img_u32(b, IMG_LZP_COUNT_OFF);
+    uint64_t lzp_off;
+    memcpy(&lzp_off, b + IMG_LZP_OFFSET_OFF, sizeof(lzp_off));
+    TEST_ASSERT_TRUE(count > 0U && count < NETC_LZP_HT_SIZE / 2U);
+    TEST_ASSERT_TRUE(lzp_off > 0U && img_sz - lzp_off < (size_t)NETC_LZP_HT_SIZE * 2U);
+
+    /* The mapped packed table predicts and serializes like the dense one */
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+    TEST_ASSERT_TRUE(roundtrip(d, m, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR,
+                               TAG_LEVEL) < TAG_BYTES);
+    TEST_ASSERT_TRUE(roundtrip(m, d, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_ADAPTIVE |
+                               NETC_CFG_FLAG_COMPACT_HDR, TAG_LEVEL) < TAG_BYTES);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(m, &blob2, &sz2));
+    TEST_ASSERT_EQUAL_UINT(sz, sz2);
+    TEST_ASSERT_EQUAL_MEMORY(blob, blob2, sz);
+    netc_dict_free(m);
+
+    /* Inconsistent ranks or count are rejected even with a valid CRC */
+    uint8_t *base0 = b + lzp_off + 4U;  /* block 0: bits, then base */
+    base0[0] ^= 0x01;
+    blob_fix_crc(b, img_sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_map_image(img, img_sz, &m));
+    base0[0] ^= 0x01;
+
+    b[IMG_LZP_COUNT_OFF] ^= 0x01;
+    blob_fix_crc(b, img_sz);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_DICT_INVALID, netc_dict_map_image(img, img_sz, &m));
+    b[IMG_LZP_COUNT_OFF] ^= 0x01;
+
+    blob_fix_crc(b, img_sz);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+    netc_dict_free(m);
+
+    netc_dict_free(d);
+    netc_dict_free_blob(blob2);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(blob);
+}
+
+void test_image_lzp_dense_fallback(void) {
+    tag_corpus_init();
+    size_t sz = 0;
+    uint8_t *b = (uint8_t *)train_blob(tag_pkts, tag_sizes, TAG_PKT_COUNT, 1, &sz);
+
+    /* Occupy every empty slot: packing would no longer save space */
+    for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
+        uint8_t *e = b + TAG_BLOB_LZP_ENTRIES + 2U * h;
+        if (e[1] == 0U) {
+            e[0] = (uint8_t)(h * 7U);
+            e[1] = 1U;
+        }
+    }
+    blob_fix_crc(b, sz);
+
+    netc_dict_t *d = NULL, *m = NULL;
+    void *img = NULL, *blob2 = NULL;
+    size_t img_sz = 0, sz2 = 0;
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_load(b, sz, &d));
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(d, &blob2, &sz2));
+    TEST_ASSERT_EQUAL_UINT(sz, sz2);
+    TEST_ASSERT_EQUAL_MEMORY(b, blob2, sz);
+    netc_dict_free_blob(blob2);
+
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save_image(d, &img, &img_sz));
+    const uint8_t *ib = (const uint8_t *)img;
+    uint64_t lzp_off;
+    memcpy(&lzp_off, ib + IMG_LZP_OFFSET_OFF, sizeof(lzp_off));
+    TEST_ASSERT_EQUAL_UINT32(NETC_LZP_HT_SIZE, img_u32(ib, IMG_LZP_COUNT_OFF));
+    TEST_ASSERT_EQUAL_UINT((size_t)NETC_LZP_HT_SIZE * 2U + 4U, img_sz - lzp_off);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_map_image(img, img_sz, &m));
+    TEST_ASSERT_TRUE(roundtrip(d, m, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR,
+                               TAG_LEVEL) < TAG_BYTES);
+    TEST_ASSERT_TRUE(roundtrip(m, d, tag_pkts, tag_sizes, TAG_PKT_COUNT,
+                               NETC_CFG_FLAG_STATELESS, TAG_LEVEL) < TAG_BYTES);
+    TEST_ASSERT_EQUAL_INT(NETC_OK, netc_dict_save(m, &blob2, &sz2));
+    TEST_ASSERT_EQUAL_MEMORY(b, blob2, sz);
+
+    netc_dict_free_blob(blob2);
+    netc_dict_free(m);
+    netc_dict_free(d);
+    netc_dict_free_blob(img);
+    netc_dict_free_blob(b);
+}
+
 /* =========================================================================
  * model_id accessor
  * ========================================================================= */
@@ -660,6 +1785,39 @@ int main(void) {
     RUN_TEST(test_v5_8class_compress_decompress_roundtrip);
     RUN_TEST(test_v5_version_byte_in_trained_dict);
 
+    /* Multi-threaded training */
+    RUN_TEST(test_train_ex_matches_serial);
+    RUN_TEST(test_train_ex_null_cfg);
+
+    /* Dictionary image */
+    RUN_TEST(test_image_null_args);
+    RUN_TEST(test_image_map_matches_load);
+    RUN_TEST(test_image_map_file);
+    RUN_TEST(test_image_corrupt_rejected);
+
+    /* Streaming trainer */
+    RUN_TEST(test_trainer_null_args);
+    RUN_TEST(test_trainer_matches_train_when_reservoir_fits);
+    RUN_TEST(test_trainer_small_reservoir_roundtrip);
+
+    /* Learned bucket boundaries */
+    RUN_TEST(test_buckets_static_for_empty_corpus);
+    RUN_TEST(test_buckets_learned_roundtrip);
+    RUN_TEST(test_buckets_bad_boundaries_rejected);
+
+    /* Learned delta operator map */
+    RUN_TEST(test_delta_map_learned_roundtrip);
+    RUN_TEST(test_delta_map_bad_ops_rejected);
+
+    /* Dual-order LZP */
+    RUN_TEST(test_lzp2_learned_roundtrip);
+    RUN_TEST(test_lzp2_bad_section_rejected);
+    RUN_TEST(test_lzp2_never_loses_held_out);
+    RUN_TEST(test_lzx_tables_roundtrip);
+    RUN_TEST(test_lzx_trainer_arrival_order);
+    RUN_TEST(test_image_lzp_packed);
+    RUN_TEST(test_image_lzp_dense_fallback);
+
     /* model_id accessor */
     RUN_TEST(test_model_id_null_dict);
     RUN_TEST(test_model_id_valid_dict);
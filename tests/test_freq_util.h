@@ -0,0 +1,51 @@
+/**
+ * test_freq_util.h -- synthetic symbol distributions for the entropy-coder
+ * tests (test_tans_cost, test_tans_xn, test_rans).
+ *
+ * Each test file gets its own generator state. Define TEST_FREQ_SEED before
+ * including to draw a different sequence (default 0x5EED).
+ */
+
+#ifndef NETC_TEST_FREQ_UTIL_H
+#define NETC_TEST_FREQ_UTIL_H
+
+#include "../src/algo/netc_tans.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef TEST_FREQ_SEED
+#define TEST_FREQ_SEED 0x5EEDu
+#endif
+
+static uint32_t s_rng = TEST_FREQ_SEED;
+
+static uint32_t xorshift32(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/* Geometric-ish distribution over all 256 symbols, skew set by shift */
+static void make_skewed_freq(netc_freq_table_t *ft, uint32_t shift) {
+    uint32_t total = 0;
+    for (int s = 0; s < 256; s++) {
+        uint32_t f = 1u + ((512u >> shift) >> (s & 15)) / (1u + (uint32_t)s / 16u);
+        ft->freq[s] = (uint16_t)f;
+        total += f;
+    }
+    /* Largest symbol absorbs the remainder so the sum is exactly 4096 */
+    ft->freq[0] = (uint16_t)(ft->freq[0] + (NETC_TANS_TABLE_SIZE - total));
+}
+
+/* Draw symbols from the table's own distribution */
+static void sample_from(const netc_freq_table_t *ft, uint8_t *dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r = xorshift32() & (NETC_TANS_TABLE_SIZE - 1u);
+        int s = 0;
+        while (r >= ft->freq[s]) { r -= ft->freq[s]; s++; }
+        dst[i] = (uint8_t)s;
+    }
+}
+
+#endif /* NETC_TEST_FREQ_UTIL_H */
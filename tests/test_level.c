@@ -0,0 +1,182 @@
+/**
+ * test_level.c -- compression_level trial budget tests.
+ *
+ * Tests:
+ *   - Every level 0..9 round-trips a mixed stream (delta, compact, bigram)
+ *   - Level trial plan is monotone: each level enables a superset of trials
+ *   - NETC_CFG_FLAG_FAST_COMPRESS output equals level 3 output
+ *   - Levels above 9 behave exactly like level 9
+ *   - Higher levels never lose ratio against level 0 on structured data
+ */
+
+#include "unity.h"
+#include "netc.h"
+#include "../src/core/netc_internal.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* =========================================================================
+ * PRNG (splitmix64) for deterministic test data
+ * ========================================================================= */
+
+static uint64_t s_prng_state;
+
+static uint64_t splitmix64(void) {
+    uint64_t z = (s_prng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void fill_packet(uint8_t *buf, size_t size, uint32_t tick) {
+    for (size_t i = 0; i < size; i++) {
+        uint64_t r = splitmix64();
+        if ((r & 3) != 0)
+            buf[i] = (uint8_t)(i * 3u + (tick >> 3));
+        else
+            buf[i] = (uint8_t)(r >> 8);
+    }
+}
+
+/* =========================================================================
+ * Shared fixtures
+ * ========================================================================= */
+
+#define TRAIN_COUNT  200
+#define STREAM_N     200
+#define MAX_PKT      600
+
+static netc_dict_t *s_dict = NULL;
+
+static uint8_t s_pkts[STREAM_N][MAX_PKT];
+static size_t  s_sizes[STREAM_N];
+
+void setUp(void) {
+    if (s_dict == NULL) {
+        static uint8_t  storage[TRAIN_COUNT][MAX_PKT];
+        static uint8_t *ptrs[TRAIN_COUNT];
+        static size_t   sizes[TRAIN_COUNT];
+        s_prng_state = 0x1E7E1ULL;
+        for (size_t i = 0; i < TRAIN_COUNT; i++) {
+            sizes[i] = 32u + (i % 5u) * 128u;
+            ptrs[i]  = storage[i];
+            fill_packet(ptrs[i], sizes[i], (uint32_t)i);
+        }
+        netc_result_t r = netc_dict_train((const uint8_t * const *)ptrs,
+                                          sizes, TRAIN_COUNT, 3, &s_dict);
+        TEST_ASSERT_EQUAL(NETC_OK, r);
+    }
+
+    s_prng_state = 0xC0FFEEULL;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        /* Runs of equal sizes so delta is exercised, plus some odd sizes */
+        s_sizes[i] = (i % 40u < 20u) ? 64u : (i % 40u < 35u) ? 300u
+                   : (size_t)(1u + (i * 53u) % MAX_PKT);
+        fill_packet(s_pkts[i], s_sizes[i], (uint32_t)i);
+    }
+}
+
+void tearDown(void) {}
+
+/* Compress the fixture stream at one configuration; optionally keep the
+ * concatenated output for comparison.  Verifies the round-trip and returns
+ * the total compressed size. */
+static size_t run_stream(uint8_t level, uint32_t flags, uint8_t *out_all) {
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | flags;
+    cfg.compression_level = level;
+    netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    size_t total = 0;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        uint8_t cmp[MAX_PKT + NETC_MAX_OVERHEAD];
+        uint8_t back[MAX_PKT];
+        size_t  csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, s_pkts[i], s_sizes[i],
+                                                 cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz,
+                                                   back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(s_sizes[i], dsz);
+        TEST_ASSERT_EQUAL_MEMORY(s_pkts[i], back, dsz);
+        if (out_all != NULL) memcpy(out_all + total, cmp, csz);
+        total += csz;
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return total;
+}
+
+/* =========================================================================
+ * Tests
+ * ========================================================================= */
+
+void test_all_levels_roundtrip(void) {
+    static const uint32_t flag_sets[] = {
+        0,
+        NETC_CFG_FLAG_DELTA,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE,
+    };
+    for (size_t f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); f++) {
+        for (uint8_t lvl = 0; lvl <= NETC_LEVEL_MAX; lvl++) {
+            run_stream(lvl, flag_sets[f], NULL);
+        }
+    }
+}
+
+void test_level_plan_is_monotone(void) {
+    netc_level_plan_t prev, cur;
+    netc_level_plan_init(&prev, 0, 0);
+    for (uint8_t lvl = 1; lvl <= NETC_LEVEL_MAX; lvl++) {
+        netc_level_plan_init(&cur, lvl, 0);
+        TEST_ASSERT_EQUAL_HEX32(prev.trials, cur.trials & prev.trials);
+        TEST_ASSERT_TRUE(cur.lz77_min <= prev.lz77_min);
+        TEST_ASSERT_TRUE(cur.lzx_depth >= prev.lzx_depth);
+        prev = cur;
+    }
+}
+
+void test_fast_flag_equals_level3(void) {
+    static uint8_t a[STREAM_N * (MAX_PKT + NETC_MAX_OVERHEAD)];
+    static uint8_t b[STREAM_N * (MAX_PKT + NETC_MAX_OVERHEAD)];
+    uint32_t flags = NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR;
+    size_t na = run_stream(3, flags, a);
+    size_t nb = run_stream(7, flags | NETC_CFG_FLAG_FAST_COMPRESS, b);
+    TEST_ASSERT_EQUAL_size_t(na, nb);
+    TEST_ASSERT_EQUAL_MEMORY(a, b, na);
+}
+
+void test_level_above_max_clamps(void) {
+    static uint8_t a[STREAM_N * (MAX_PKT + NETC_MAX_OVERHEAD)];
+    static uint8_t b[STREAM_N * (MAX_PKT + NETC_MAX_OVERHEAD)];
+    size_t na = run_stream(9, NETC_CFG_FLAG_DELTA, a);
+    size_t nb = run_stream(200, NETC_CFG_FLAG_DELTA, b);
+    TEST_ASSERT_EQUAL_size_t(na, nb);
+    TEST_ASSERT_EQUAL_MEMORY(a, b, na);
+}
+
+void test_higher_levels_not_worse_than_level0(void) {
+    uint32_t flags = NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_BIGRAM;
+    size_t l0 = run_stream(0, flags, NULL);
+    size_t l5 = run_stream(5, flags, NULL);
+    size_t l9 = run_stream(9, flags, NULL);
+    TEST_ASSERT_TRUE(l5 <= l0);
+    TEST_ASSERT_TRUE(l9 <= l0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_all_levels_roundtrip);
+    RUN_TEST(test_level_plan_is_monotone);
+    RUN_TEST(test_fast_flag_equals_level3);
+    RUN_TEST(test_level_above_max_clamps);
+    RUN_TEST(test_higher_levels_not_worse_than_level0);
+    int result = UNITY_END();
+    netc_dict_free(s_dict);
+    return result;
+}
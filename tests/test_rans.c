@@ -0,0 +1,349 @@
+/**
+ * test_rans.c -- static interleaved rANS codec (NETC_ALG_RANS) tests.
+ *
+ * Tests cover:
+ *   1. netc_rans_build slot map / cumulative frequencies; bad sums rejected
+ *   2. netc_rans_encode/decode_pctx round-trip across bucket boundaries
+ *   3. Output size tracks the -log2(p) cost model (no spread loss)
+ *   4. Truncated, padded and corrupt payloads and absent symbols are rejected
+ *   5. Compact packet types 0xF0-0xF5
+ *   6. Level >= 6 contexts select rANS on wide packets and round-trip through
+ *      stateful, compact and delta paths; level 5 and adaptive never do
+ */
+
+#include "unity.h"
+#include "../include/netc.h"
+#include "../src/algo/netc_rans.h"
+#include "../src/core/netc_internal.h"
+#include <string.h>
+#include <stdlib.h>
+
+#include "test_freq_util.h"
+
+void setUp(void)    {}
+void tearDown(void) {}
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+#define MAX_SRC 5000u
+
+static netc_rans_table_t s_rans[NETC_CTX_COUNT];
+static netc_tans_table_t s_tans[NETC_CTX_COUNT];
+static netc_freq_table_t s_fts[4];
+static int s_built = 0;
+
+static void build_tables(void) {
+    if (s_built) return;
+    for (uint32_t k = 0; k < 4; k++) make_skewed_freq(&s_fts[k], k);
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        TEST_ASSERT_EQUAL_INT(0, netc_rans_build(&s_rans[b], &s_fts[b & 3u]));
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&s_tans[b], &s_fts[b & 3u]));
+    }
+    s_built = 1;
+}
+
+/* Sample each byte from the table of its own bucket */
+static void sample_pctx(uint8_t *dst, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        sample_from(&s_fts[netc_ctx_bucket((uint32_t)i) & 3u], &dst[i], 1);
+}
+
+static const size_t k_sizes[] = { 1, 3, 4, 5, 7, 8, 9, 63, 64, 65,
+                                  255, 256, 257, 1023, 1024, 1025,
+                                  4095, 4096, 4097, MAX_SRC };
+
+/* =========================================================================
+ * 1. Table build
+ * ========================================================================= */
+
+void test_build_slot_map(void) {
+    build_tables();
+    const netc_rans_table_t *t = &s_rans[1];
+    uint32_t cumul = 0;
+    for (uint32_t s = 0; s < 256; s++) {
+        TEST_ASSERT_EQUAL_UINT16(s_fts[1].freq[s], t->sym[s].freq);
+        TEST_ASSERT_EQUAL_UINT16(cumul, t->sym[s].cumul);
+        for (uint32_t k = 0; k < t->sym[s].freq; k++)
+            TEST_ASSERT_EQUAL_UINT8(s, t->slot_sym[cumul + k]);
+        cumul += t->sym[s].freq;
+    }
+    TEST_ASSERT_EQUAL_UINT32(NETC_RANS_PREC_SIZE, cumul);
+    TEST_ASSERT_TRUE(sizeof(netc_rans_table_t) < sizeof(netc_tans_table_t) / 4u);
+}
+
+void test_build_rejects_bad_sum(void) {
+    netc_freq_table_t ft;
+    make_skewed_freq(&ft, 0);
+    netc_rans_table_t t;
+    ft.freq[7]++;
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_build(&t, &ft));
+    TEST_ASSERT_EQUAL_UINT32(0, t.valid);
+    ft.freq[7] -= 2;
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_build(&t, &ft));
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_build(NULL, &ft));
+}
+
+/* =========================================================================
+ * 2-3. Codec round-trip and size
+ * ========================================================================= */
+
+void test_pctx_roundtrip_all_sizes(void) {
+    static uint8_t src[MAX_SRC], back[MAX_SRC], buf[2u * MAX_SRC + 64u];
+    build_tables();
+    for (size_t t = 0; t < sizeof(k_sizes) / sizeof(k_sizes[0]); t++) {
+        size_t n = k_sizes[t];
+        sample_pctx(src, n);
+        size_t cp = netc_rans_encode_pctx(s_rans, NULL, src, n, buf, sizeof(buf));
+        TEST_ASSERT_TRUE(cp != (size_t)-1);
+        TEST_ASSERT_TRUE(cp >= NETC_RANS_STATE_SIZE);
+        memset(back, 0xEE, n);
+        TEST_ASSERT_EQUAL_INT(0, netc_rans_decode_pctx(s_rans, NULL, buf, cp, back, n));
+        TEST_ASSERT_EQUAL_MEMORY(src, back, n);
+    }
+}
+
+void test_pctx_rare_symbols_roundtrip(void) {
+    /* Every byte a freq-1 symbol: two renorm bytes per symbol */
+    static uint8_t src[2048], back[2048], buf[8192];
+    build_tables();
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(0xF0u + (i & 15u));
+    size_t cp = netc_rans_encode_pctx(s_rans, NULL, src, sizeof(src), buf, sizeof(buf));
+    TEST_ASSERT_TRUE(cp != (size_t)-1);
+    TEST_ASSERT_EQUAL_INT(0, netc_rans_decode_pctx(s_rans, NULL, buf, cp, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_MEMORY(src, back, sizeof(src));
+}
+
+void test_size_matches_cost_model(void) {
+    static uint8_t src[4096], buf[8192];
+    build_tables();
+    sample_pctx(src, sizeof(src));
+    size_t cp   = netc_rans_encode_pctx(s_rans, NULL, src, sizeof(src), buf, sizeof(buf));
+    size_t cost = netc_tans_cost_bytes(netc_tans_cost_pctx(s_tans, NULL, src, sizeof(src)));
+    TEST_ASSERT_TRUE(cp != (size_t)-1);
+    /* States plus the ideal bitstream, within a byte per 512 symbols (the
+     * Q8 estimate rounds each symbol cost up, so it may overshoot) */
+    TEST_ASSERT_TRUE(cp + sizeof(src) / 512u >= NETC_RANS_STATE_SIZE + cost);
+    TEST_ASSERT_TRUE(cp <= NETC_RANS_STATE_SIZE + cost + sizeof(src) / 512u);
+}
+
+/* =========================================================================
+ * 4. Corrupt input and bad arguments
+ * ========================================================================= */
+
+void test_corrupt_payloads_rejected(void) {
+    static uint8_t src[1500], back[1500], buf[4096];
+    build_tables();
+    sample_pctx(src, sizeof(src));
+    size_t cp = netc_rans_encode_pctx(s_rans, NULL, src, sizeof(src), buf, sizeof(buf));
+    TEST_ASSERT_TRUE(cp != (size_t)-1 && cp > NETC_RANS_STATE_SIZE + 2u);
+
+    /* Truncated stream, truncated states */
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_decode_pctx(s_rans, NULL, buf, cp - 1u, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_decode_pctx(s_rans, NULL, buf, NETC_RANS_STATE_SIZE - 1u,
+                                                    back, sizeof(back)));
+    /* Trailing byte */
+    buf[cp] = 0x5A;
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_decode_pctx(s_rans, NULL, buf, cp + 1u, back, sizeof(back)));
+    /* Wrong length: states do not return to L */
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_decode_pctx(s_rans, NULL, buf, cp, back, sizeof(back) - 1u));
+    /* State out of range */
+    uint8_t saved = buf[3];
+    buf[3] = 0xFF;
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_decode_pctx(s_rans, NULL, buf, cp, back, sizeof(back)));
+    buf[3] = 0x00;
+    TEST_ASSERT_EQUAL_INT(-1, netc_rans_decode_pctx(s_rans, NULL, buf, cp, back, sizeof(back)));
+    buf[3] = saved;
+    TEST_ASSERT_EQUAL_INT(0, netc_rans_decode_pctx(s_rans, NULL, buf, cp, back, sizeof(back)));
+}
+
+void test_encode_rejects_absent_symbol_and_small_dst(void) {
+    static uint8_t src[300], buf[1024];
+    netc_freq_table_t ft;
+    memset(&ft, 0, sizeof(ft));
+    ft.freq['a'] = NETC_RANS_PREC_SIZE / 2u;
+    ft.freq['b'] = NETC_RANS_PREC_SIZE / 2u;
+    static netc_rans_table_t t[NETC_CTX_COUNT];
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        TEST_ASSERT_EQUAL_INT(0, netc_rans_build(&t[b], &ft));
+
+    memset(src, 'a', sizeof(src));
+    size_t cp = netc_rans_encode_pctx(t, NULL, src, sizeof(src), buf, sizeof(buf));
+    TEST_ASSERT_TRUE(cp != (size_t)-1);
+    /* One bit per symbol */
+    TEST_ASSERT_TRUE(cp <= NETC_RANS_STATE_SIZE + sizeof(src) / 8u + 1u);
+    TEST_ASSERT_EQUAL_size_t((size_t)-1,
+        netc_rans_encode_pctx(t, NULL, src, sizeof(src), buf, cp - 1u));
+
+    src[200] = 'z';
+    TEST_ASSERT_EQUAL_size_t((size_t)-1,
+        netc_rans_encode_pctx(t, NULL, src, sizeof(src), buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_size_t((size_t)-1,
+        netc_rans_encode_pctx(t, NULL, src, 0, buf, sizeof(buf)));
+}
+
+/* =========================================================================
+ * 5. Compact packet types
+ * ========================================================================= */
+
+void test_compact_rans_types_roundtrip(void) {
+    size_t n = 0;
+    for (uint32_t t = 0; t < 256; t++) {
+        const netc_pkt_type_entry_t *e = &netc_pkt_type_table[t];
+        if (e->flags == 0xFF || (e->algorithm & 0x0Fu) != NETC_ALG_RANS)
+            continue;
+        TEST_ASSERT_EQUAL_HEX8(t, netc_compact_type_encode(e->flags, e->algorithm));
+        TEST_ASSERT_TRUE(t >= 0xF0u && t <= 0xF5u);
+        n++;
+    }
+    TEST_ASSERT_EQUAL_size_t(6, n);
+    /* No bigram variant */
+    TEST_ASSERT_EQUAL_HEX8(0xFF, netc_compact_type_encode(
+        NETC_PKT_FLAG_DICT_ID | NETC_PKT_FLAG_BIGRAM, NETC_ALG_RANS));
+}
+
+/* =========================================================================
+ * 6. Codec selection through netc_compress
+ * ========================================================================= */
+
+#define TRAIN_COUNT 64
+#define STREAM_N    24
+
+static netc_dict_t *s_dict = NULL;
+
+/* Snapshot-like packet: repeated 32-byte entity records with slow drift */
+static void fill_snapshot(uint8_t *p, size_t n, uint32_t tick) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r = xorshift32();
+        size_t   f = i & 31u;
+        if (f < 4)        p[i] = (uint8_t)(i >> 5);              /* entity id */
+        else if (f < 8)   p[i] = (uint8_t)((tick + f) & 0x0Fu);  /* tick */
+        else if (f < 20)  p[i] = (uint8_t)(0x40u + (r & 7u));    /* position */
+        else if ((r & 3u) == 0) p[i] = (uint8_t)(r >> 8);        /* noise */
+        else              p[i] = 0;
+    }
+}
+
+static void ensure_dict(void) {
+    if (s_dict != NULL) return;
+    static uint8_t  storage[TRAIN_COUNT][MAX_SRC];
+    static uint8_t *ptrs[TRAIN_COUNT];
+    static size_t   sizes[TRAIN_COUNT];
+    for (size_t i = 0; i < TRAIN_COUNT; i++) {
+        sizes[i] = 512u + (i % 8u) * 512u;
+        ptrs[i]  = storage[i];
+        fill_snapshot(ptrs[i], sizes[i], (uint32_t)i);
+    }
+    TEST_ASSERT_EQUAL(NETC_OK, netc_dict_train((const uint8_t * const *)ptrs,
+                                               sizes, TRAIN_COUNT, 5, &s_dict));
+}
+
+static const size_t k_wide[] = { 1023, 1024, 1500, 2048, 3000, 4096, MAX_SRC };
+
+/* Returns the number of packets coded with rANS. */
+static size_t run_stream(uint32_t flags, uint8_t level) {
+    ensure_dict();
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | flags;
+    cfg.compression_level = level;
+    netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    int    compact = (flags & NETC_CFG_FLAG_COMPACT_HDR) != 0;
+    size_t used    = 0;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        static uint8_t pkt[MAX_SRC], cmp[MAX_SRC + NETC_MAX_OVERHEAD], back[MAX_SRC];
+        size_t n = k_wide[(i / 3u) % (sizeof(k_wide) / sizeof(k_wide[0]))];
+        fill_snapshot(pkt, n, (uint32_t)(i / 3u));
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, n, cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(n, dsz);
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, n);
+
+        uint8_t alg = compact ? netc_pkt_type_table[cmp[0]].algorithm : cmp[5];
+        if ((alg & 0x0Fu) == NETC_ALG_RANS) {
+            TEST_ASSERT_TRUE(n >= NETC_RANS_MIN);
+            used++;
+        }
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return used;
+}
+
+void test_level6_selects_rans_on_wide_packets(void) {
+    static const uint32_t flag_sets[] = {
+        0,
+        NETC_CFG_FLAG_DELTA,
+        NETC_CFG_FLAG_COMPACT_HDR,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR,
+    };
+    size_t used = 0;
+    for (size_t f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); f++)
+        used += run_stream(flag_sets[f], 6);
+    TEST_ASSERT_TRUE(used > 0);
+}
+
+void test_level5_and_adaptive_never_use_rans(void) {
+    TEST_ASSERT_EQUAL_size_t(0, run_stream(NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR, 5));
+    TEST_ASSERT_EQUAL_size_t(0, run_stream(NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_ADAPTIVE, 9));
+}
+
+void test_rans_packet_decodes_stateless(void) {
+    /* A level-6 packet without delta carries no history: the stateless
+     * decoder must accept it too */
+    static uint8_t pkt[4096], cmp[4096 + NETC_MAX_OVERHEAD], back[4096];
+    ensure_dict();
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL;
+    cfg.compression_level = 6;
+    netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+
+    size_t used = 0;
+    for (uint32_t t = 0; t < 8; t++) {
+        fill_snapshot(pkt, sizeof(pkt), t);
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, sizeof(pkt), cmp, sizeof(cmp), &csz));
+        if ((cmp[5] & 0x0Fu) != NETC_ALG_RANS) continue;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress_stateless(s_dict, cmp, csz,
+                                                             back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(sizeof(pkt), dsz);
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, sizeof(pkt));
+        used++;
+
+        /* Unknown algorithm-byte modifiers are rejected */
+        cmp[5] |= 0x40u;
+        TEST_ASSERT_EQUAL(NETC_ERR_CORRUPT, netc_decompress_stateless(
+            s_dict, cmp, csz, back, sizeof(back), &dsz));
+    }
+    TEST_ASSERT_TRUE(used > 0);
+    netc_ctx_destroy(enc);
+}
+
+/* ========================================================================= */
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_build_slot_map);
+    RUN_TEST(test_build_rejects_bad_sum);
+    RUN_TEST(test_pctx_roundtrip_all_sizes);
+    RUN_TEST(test_pctx_rare_symbols_roundtrip);
+    RUN_TEST(test_size_matches_cost_model);
+    RUN_TEST(test_corrupt_payloads_rejected);
+    RUN_TEST(test_encode_rejects_absent_symbol_and_small_dst);
+    RUN_TEST(test_compact_rans_types_roundtrip);
+    RUN_TEST(test_level6_selects_rans_on_wide_packets);
+    RUN_TEST(test_level5_and_adaptive_never_use_rans);
+    RUN_TEST(test_rans_packet_decodes_stateless);
+    int rc = UNITY_END();
+    netc_dict_free(s_dict);
+    return rc;
+}
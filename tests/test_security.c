@@ -424,8 +424,8 @@ void test_unknown_algorithm(void)
     netc_dict_free(dict);
 }
 
-/* rANS algorithm → NETC_ERR_UNSUPPORTED */
-void test_rans_algorithm_unsupported(void)
+/* rANS payload whose states are below L → NETC_ERR_CORRUPT */
+void test_rans_algorithm_bad_states(void)
 {
     uint8_t pkt[8 + 8];
     memset(pkt, 0, sizeof(pkt));
@@ -437,7 +437,7 @@ void test_rans_algorithm_unsupported(void)
     netc_ctx_t  *ctx  = netc_ctx_create(dict, NULL);
 
     netc_result_t rc = netc_decompress(ctx, pkt, sizeof(pkt), dst, 64, &dst_size);
-    TEST_ASSERT_EQUAL_INT(NETC_ERR_UNSUPPORTED, rc);
+    TEST_ASSERT_EQUAL_INT(NETC_ERR_CORRUPT, rc);
 
     netc_ctx_destroy(ctx);
     netc_dict_free(dict);
@@ -1050,6 +1050,7 @@ void test_ctx_create_custom_ring_size(void)
     cfg.ring_buffer_size = 4096;  /* non-zero custom size */
 
     netc_ctx_t *ctx = netc_ctx_create(NULL, &cfg);
+    cfg.compression_level = 5;
     TEST_ASSERT_NOT_NULL(ctx);
 
     /* Verify it works for basic compress */
@@ -1081,6 +1082,7 @@ void test_stats_tans_compress_path(void)
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_STATS;
+    cfg.compression_level = 5;
     netc_ctx_t *ctx = netc_ctx_create(d, &cfg);
     TEST_ASSERT_NOT_NULL(ctx);
 
@@ -1143,7 +1145,7 @@ int main(void)
 
     /* Algorithm validation */
     RUN_TEST(test_unknown_algorithm);
-    RUN_TEST(test_rans_algorithm_unsupported);
+    RUN_TEST(test_rans_algorithm_bad_states);
 
     /* Model ID mismatch */
     RUN_TEST(test_model_id_mismatch);
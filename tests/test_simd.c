@@ -41,6 +41,20 @@
  * ## 6. Spec scenarios
  *   6.1 Graceful fallback: forcing generic level always works
  *   6.2 Dispatch table level field matches selected level
+ *
+ * ## 8. Mapped delta operators
+ *   8.1 Random valid operator maps: SSE4.2 / AVX2 encode+decode == generic
+ *       for lengths around every chunk width and past the map end
+ *   8.2 In-place decode (residual buffer == output) with wide lanes
+ *   8.4 match_count: SSE4.2 / AVX2 == generic, past the 8-bit lane flush
+ *
+ * ## 9. LZP XOR filter
+ *   9.1 SSE4.2 / AVX2 filter == generic, order-1 and dual-order, lengths
+ *       around both vector widths, including the table's last slot, on
+ *       the dense and the packed layout
+ *   9.2 unfilter inverts the filter in place, with no hint, an exact hint
+ *       and a wrong hint
+ *   9.3 packed table lookups == dense table lookups in every slot
  */
 
 #include "unity.h"
@@ -98,6 +112,7 @@ static netc_ctx_t *make_ctx(uint8_t simd_level, int delta) {
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags      = NETC_CFG_FLAG_STATEFUL | (delta ? NETC_CFG_FLAG_DELTA : 0);
     cfg.simd_level = simd_level;
+    cfg.compression_level = 5;
     return netc_ctx_create(s_dict, &cfg);
 }
 
@@ -163,8 +178,8 @@ void test_generic_delta_roundtrip(void) {
     /* 2.1 generic delta encode/decode round-trip */
     uint8_t residual[PKT_SIZE], recovered[PKT_SIZE];
 
-    netc_delta_encode_generic(s_prev, s_curr, residual, PKT_SIZE);
-    netc_delta_decode_generic(s_prev, residual, recovered, PKT_SIZE);
+    netc_delta_encode_generic(NULL, s_prev, s_curr, residual, PKT_SIZE);
+    netc_delta_decode_generic(NULL, s_prev, residual, recovered, PKT_SIZE);
 
     for (int i = 0; i < PKT_SIZE; i++) {
         if (s_curr[i] != recovered[i]) {
@@ -235,8 +250,8 @@ static void assert_delta_paths_equal(
     uint8_t res_a[PKT_SIZE], res_b[PKT_SIZE];
     uint8_t rec_a[PKT_SIZE], rec_b[PKT_SIZE];
 
-    enc_a(s_prev, s_curr, res_a, PKT_SIZE);
-    enc_b(s_prev, s_curr, res_b, PKT_SIZE);
+    enc_a(NULL, s_prev, s_curr, res_a, PKT_SIZE);
+    enc_b(NULL, s_prev, s_curr, res_b, PKT_SIZE);
 
     for (int i = 0; i < PKT_SIZE; i++) {
         if (res_a[i] != res_b[i]) {
@@ -248,8 +263,8 @@ static void assert_delta_paths_equal(
         }
     }
 
-    dec_a(s_prev, res_a, rec_a, PKT_SIZE);
-    dec_b(s_prev, res_b, rec_b, PKT_SIZE);
+    dec_a(NULL, s_prev, res_a, rec_a, PKT_SIZE);
+    dec_b(NULL, s_prev, res_b, rec_b, PKT_SIZE);
 
     for (int i = 0; i < PKT_SIZE; i++) {
         if (rec_a[i] != rec_b[i]) {
@@ -426,11 +441,11 @@ void test_sse42_unaligned_encode(void) {
     memcpy(uc, s_curr, PKT_SIZE);
 
     /* Must not crash or fault */
-    netc_delta_encode_sse42(up, uc, out, PKT_SIZE);
+    netc_delta_encode_sse42(NULL, up, uc, out, PKT_SIZE);
 
     /* Verify output matches aligned reference */
     uint8_t ref[PKT_SIZE];
-    netc_delta_encode_generic(s_prev, s_curr, ref, PKT_SIZE);
+    netc_delta_encode_generic(NULL, s_prev, s_curr, ref, PKT_SIZE);
     TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, out, PKT_SIZE);
 
     free(heap); free(heap2); free(heap3);
@@ -440,7 +455,7 @@ void test_sse42_unaligned_encode(void) {
 void test_sse42_unaligned_decode(void) {
     /* 4.2 SSE4.2 delta decode on unaligned buffer */
     uint8_t residual[PKT_SIZE];
-    netc_delta_encode_generic(s_prev, s_curr, residual, PKT_SIZE);
+    netc_delta_encode_generic(NULL, s_prev, s_curr, residual, PKT_SIZE);
 
     uint8_t *heap_p = (uint8_t *)malloc(PKT_SIZE + ALIGN_OVERHEAD);
     uint8_t *heap_r = (uint8_t *)malloc(PKT_SIZE + ALIGN_OVERHEAD);
@@ -454,7 +469,7 @@ void test_sse42_unaligned_decode(void) {
     memcpy(up, s_prev,   PKT_SIZE);
     memcpy(ur, residual, PKT_SIZE);
 
-    netc_delta_decode_sse42(up, ur, out, PKT_SIZE);
+    netc_delta_decode_sse42(NULL, up, ur, out, PKT_SIZE);
 
     TEST_ASSERT_EQUAL_UINT8_ARRAY(s_curr, out, PKT_SIZE);
 
@@ -475,10 +490,10 @@ void test_avx2_unaligned_encode(void) {
     memcpy(up, s_prev, PKT_SIZE);
     memcpy(uc, s_curr, PKT_SIZE);
 
-    netc_delta_encode_avx2(up, uc, out, PKT_SIZE);
+    netc_delta_encode_avx2(NULL, up, uc, out, PKT_SIZE);
 
     uint8_t ref[PKT_SIZE];
-    netc_delta_encode_generic(s_prev, s_curr, ref, PKT_SIZE);
+    netc_delta_encode_generic(NULL, s_prev, s_curr, ref, PKT_SIZE);
     TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, out, PKT_SIZE);
 
     free(hp); free(hc);
@@ -589,8 +604,8 @@ void test_simd_graceful_fallback(void) {
     netc_simd_ops_init(&ops, NETC_SIMD_LEVEL_GENERIC);
 
     uint8_t res[PKT_SIZE], rec[PKT_SIZE];
-    ops.delta_encode(s_prev, s_curr, res, PKT_SIZE);
-    ops.delta_decode(s_prev, res,    rec, PKT_SIZE);
+    ops.delta_encode(NULL, s_prev, s_curr, res, PKT_SIZE);
+    ops.delta_decode(NULL, s_prev, res,    rec, PKT_SIZE);
 
     TEST_ASSERT_EQUAL_UINT8_ARRAY(s_curr, rec, PKT_SIZE);
 }
@@ -602,16 +617,16 @@ void test_simd_cross_path_small_packet(void) {
     uint8_t res_gen[8], res_sse[8], res_avx[8];
     uint8_t rec_gen[8], rec_sse[8], rec_avx[8];
 
-    netc_delta_encode_generic(prev8, curr8, res_gen, 8);
-    netc_delta_encode_sse42  (prev8, curr8, res_sse, 8);
-    netc_delta_encode_avx2   (prev8, curr8, res_avx, 8);
+    netc_delta_encode_generic(NULL, prev8, curr8, res_gen, 8);
+    netc_delta_encode_sse42  (NULL, prev8, curr8, res_sse, 8);
+    netc_delta_encode_avx2   (NULL, prev8, curr8, res_avx, 8);
 
     TEST_ASSERT_EQUAL_UINT8_ARRAY(res_gen, res_sse, 8);
     TEST_ASSERT_EQUAL_UINT8_ARRAY(res_gen, res_avx, 8);
 
-    netc_delta_decode_generic(prev8, res_gen, rec_gen, 8);
-    netc_delta_decode_sse42  (prev8, res_sse, rec_sse, 8);
-    netc_delta_decode_avx2   (prev8, res_avx, rec_avx, 8);
+    netc_delta_decode_generic(NULL, prev8, res_gen, rec_gen, 8);
+    netc_delta_decode_sse42  (NULL, prev8, res_sse, rec_sse, 8);
+    netc_delta_decode_avx2   (NULL, prev8, res_avx, rec_avx, 8);
 
     TEST_ASSERT_EQUAL_UINT8_ARRAY(curr8, rec_gen, 8);
     TEST_ASSERT_EQUAL_UINT8_ARRAY(curr8, rec_sse, 8);
@@ -626,9 +641,9 @@ void test_simd_cross_path_boundary_packet(void) {
         uint8_t res_gen[300], res_sse[300], res_avx[300];
         uint8_t rec_gen[300], rec_sse[300];
 
-        netc_delta_encode_generic(s_prev, s_curr, res_gen, n);
-        netc_delta_encode_sse42  (s_prev, s_curr, res_sse, n);
-        netc_delta_encode_avx2   (s_prev, s_curr, res_avx, n);
+        netc_delta_encode_generic(NULL, s_prev, s_curr, res_gen, n);
+        netc_delta_encode_sse42  (NULL, s_prev, s_curr, res_sse, n);
+        netc_delta_encode_avx2   (NULL, s_prev, s_curr, res_avx, n);
 
         for (size_t i = 0; i < n; i++) {
             if (res_gen[i] != res_sse[i]) {
@@ -647,8 +662,8 @@ void test_simd_cross_path_boundary_packet(void) {
             }
         }
 
-        netc_delta_decode_generic(s_prev, res_gen, rec_gen, n);
-        netc_delta_decode_sse42  (s_prev, res_sse, rec_sse, n);
+        netc_delta_decode_generic(NULL, s_prev, res_gen, rec_gen, n);
+        netc_delta_decode_sse42  (NULL, s_prev, res_sse, rec_sse, n);
         for (size_t i = 0; i < n; i++) {
             if (rec_gen[i] != (uint8_t)((s_curr[i]))) {
                 TEST_FAIL_MESSAGE("generic decode wrong");
@@ -698,6 +713,271 @@ void test_ctx_simd_level_generic_ctx(void) {
     netc_ctx_destroy(ctx);
 }
 
+/* =========================================================================
+ * 8. Mapped delta operators
+ * ========================================================================= */
+
+#define MAP_BUF 1100
+
+/* Valid map with every operator: wide lanes only where they fit aligned. */
+static void random_delta_map(netc_delta_map_t *m, uint32_t *seed) {
+    for (size_t i = 0; i < NETC_DELTA_MAP_LEN; ) {
+        *seed = *seed * 1103515245u + 12345u;
+        uint32_t op = (*seed >> 16) % NETC_DELTA_OP_COUNT;
+        size_t   w  = netc_delta_op_width(op);
+        if ((i & (w - 1U)) != 0) { op = NETC_DELTA_OP_SUB; w = 1; }
+        memset(m->op + i, (int)op, w);
+        i += w;
+    }
+    *seed = *seed * 1103515245u + 12345u;
+    m->tail = (uint8_t)((*seed >> 16) % NETC_DELTA_OP_COUNT);
+    m->planes = 0;
+}
+
+void test_mapped_delta_matches_generic(void) {
+    /* 8.1 SIMD paths == generic under random maps */
+    static const size_t lens[] = { 1, 15, 17, 31, 33, 100, 511, 512, 513, 530, MAP_BUF };
+    static uint8_t prev[MAP_BUF], curr[MAP_BUF];
+    static uint8_t res_g[MAP_BUF], res_s[MAP_BUF], res_a[MAP_BUF];
+    static uint8_t rec_g[MAP_BUF], rec_s[MAP_BUF], rec_a[MAP_BUF];
+    uint32_t seed = 99u;
+    for (size_t i = 0; i < MAP_BUF; i++) {
+        seed = seed * 1103515245u + 12345u;
+        prev[i] = (uint8_t)(seed >> 16);
+        curr[i] = (uint8_t)(seed >> 24);
+    }
+
+    netc_delta_map_t m;
+    for (int round = 0; round < 8; round++) {
+        random_delta_map(&m, &seed);
+        TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            size_t n = lens[l];
+            netc_delta_encode_generic(&m, prev, curr, res_g, n);
+            netc_delta_encode_sse42  (&m, prev, curr, res_s, n);
+            netc_delta_encode_avx2   (&m, prev, curr, res_a, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(res_g, res_s, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(res_g, res_a, n);
+
+            netc_delta_decode_generic(&m, prev, res_g, rec_g, n);
+            netc_delta_decode_sse42  (&m, prev, res_g, rec_s, n);
+            netc_delta_decode_avx2   (&m, prev, res_g, rec_a, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(curr, rec_g, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(curr, rec_s, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(curr, rec_a, n);
+        }
+    }
+}
+
+void test_mapped_delta_decode_in_place(void) {
+    /* 8.2 The decompressor decodes into the residual buffer */
+    static uint8_t prev[MAP_BUF], curr[MAP_BUF], buf[MAP_BUF];
+    netc_delta_map_t m;
+    memset(m.op, (int)NETC_DELTA_OP_SUB32, sizeof(m.op));
+    memset(m.op + 64, (int)NETC_DELTA_OP_SUB16, 64);
+    m.tail = (uint8_t)NETC_DELTA_OP_SUB32;
+    m.planes = 0;
+    for (size_t i = 0; i < MAP_BUF; i++) {
+        prev[i] = (uint8_t)(i * 7u);
+        curr[i] = (uint8_t)(i * 13u + 5u);
+    }
+
+    static const uint8_t levels[] = {
+        NETC_SIMD_LEVEL_GENERIC, NETC_SIMD_LEVEL_SSE42, NETC_SIMD_LEVEL_AVX2
+    };
+    for (int k = 0; k < 3; k++) {
+        netc_simd_ops_t ops;
+        netc_simd_ops_init(&ops, levels[k]);
+        memset(buf, 0, sizeof(buf));
+        ops.delta_encode(&m, prev, curr, buf, MAP_BUF - 3U);
+        ops.delta_decode(&m, prev, buf, buf, MAP_BUF - 3U);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(curr, buf, MAP_BUF - 3U);
+    }
+}
+
+/* Byte-planes map: runs of 1..80 lanes of a random operator */
+static void random_planes_map(netc_delta_map_t *m, uint32_t *seed) {
+    for (size_t i = 0; i < NETC_DELTA_MAP_LEN; ) {
+        *seed = *seed * 1103515245u + 12345u;
+        uint32_t op    = (*seed >> 16) % NETC_DELTA_OP_COUNT;
+        size_t   w     = netc_delta_op_width(op);
+        size_t   lanes = 1U + (*seed >> 8) % 80U;
+        if ((i & (w - 1U)) != 0) { op = NETC_DELTA_OP_XOR; w = 1; lanes = 1; }
+        size_t   n     = lanes * w;
+        if (n > NETC_DELTA_MAP_LEN - i) n = NETC_DELTA_MAP_LEN - i;
+        memset(m->op + i, (int)op, n);
+        i += n;
+    }
+    m->tail   = (uint8_t)NETC_DELTA_OP_XOR;
+    m->planes = 1;
+}
+
+void test_delta_planes_match_generic(void) {
+    /* 8.3 Byte-plane split/merge: SIMD == generic, and merge inverts split */
+    static const size_t lens[] = { 3, 16, 37, 100, 255, 511, 512, 600 };
+    static uint8_t src[600], buf_g[600], buf_s[600], buf_a[600];
+    uint32_t seed = 7u;
+    for (size_t i = 0; i < sizeof(src); i++) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (uint8_t)(seed >> 16);
+    }
+    for (int trial = 0; trial < 32; trial++) {
+        netc_delta_map_t    m;
+        netc_delta_planes_t pl;
+        random_planes_map(&m, &seed);
+        TEST_ASSERT_TRUE(netc_delta_map_valid(&m));
+        netc_delta_planes_init(&pl, &m);
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            size_t n = lens[l];
+            memcpy(buf_g, src, n);
+            memcpy(buf_s, src, n);
+            memcpy(buf_a, src, n);
+            netc_delta_planes_split_generic(&pl, buf_g, n);
+            netc_delta_planes_split_sse42  (&pl, buf_s, n);
+            netc_delta_planes_split_avx2   (&pl, buf_a, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(buf_g, buf_s, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(buf_g, buf_a, n);
+
+            netc_delta_planes_merge_generic(&pl, buf_g, n);
+            netc_delta_planes_merge_sse42  (&pl, buf_s, n);
+            netc_delta_planes_merge_avx2   (&pl, buf_a, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(src, buf_g, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(src, buf_s, n);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(src, buf_a, n);
+        }
+    }
+}
+
+void test_match_count_matches_generic(void) {
+    /* 8.4 Equal-byte count: SIMD == generic, including runs long enough to
+     * flush the 8-bit lane counters (255 blocks) more than once */
+    static const size_t lens[] = { 0, 1, 15, 16, 33, 100, 4080, 4096, 8161, 20000 };
+    static uint8_t a[20000], b[20000];
+    uint32_t seed = 11u;
+    for (size_t i = 0; i < sizeof(a); i++) {
+        seed = seed * 1103515245u + 12345u;
+        a[i] = (uint8_t)(seed >> 16);
+        b[i] = ((seed >> 8) & 3u) ? a[i] : (uint8_t)(a[i] ^ 0x5A);
+    }
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        size_t   n = lens[l];
+        uint32_t g = netc_match_count_generic(a, b, n);
+        TEST_ASSERT_EQUAL_UINT32(g, netc_match_count_sse42(a, b, n));
+        TEST_ASSERT_EQUAL_UINT32(g, netc_match_count_avx2(a, b, n));
+        TEST_ASSERT_EQUAL_UINT32((uint32_t)n, netc_match_count_avx2(a, a, n));
+    }
+}
+
+/* =========================================================================
+ * 9. LZP XOR filter
+ * ========================================================================= */
+
+#define LZP_BUF 1500U
+static netc_lzp_entry_t s_lzp[NETC_LZP_HT_SIZE];
+static netc_lzp_blk_t   s_lzp_blk[NETC_LZP_BLK_COUNT];
+static netc_lzp_entry_t s_lzp_ent[NETC_LZP_HT_SIZE + NETC_LZP_PACK_PAD];
+static uint8_t          s_lzp_src[LZP_BUF];
+
+/* The fixture as a dense table ([0]) and packed ([1]) */
+static netc_lzp_table_t s_lzp_views[2];
+
+/* Random table: a third of the slots empty, confidences over 1..255.
+ * Source bytes from a small alphabet so many contexts repeat; one
+ * (prev, pos) pair is planted that hashes to the last slot. */
+static void lzp_fixture_init(void) {
+    uint32_t seed = 2024u;
+    for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
+        seed = seed * 1103515245u + 12345u;
+        s_lzp[h].value = (uint8_t)(seed >> 16);
+        s_lzp[h].valid = ((seed >> 8) % 3u == 0u) ? 0u : (uint8_t)(1u + (seed >> 24) % 255u);
+    }
+    s_lzp[NETC_LZP_HT_MASK].value = 0xA5u;
+    s_lzp[NETC_LZP_HT_MASK].valid = 200u;
+    for (size_t i = 0; i < LZP_BUF; i++) {
+        seed = seed * 1103515245u + 12345u;
+        s_lzp_src[i] = (uint8_t)((seed >> 16) & 0x0Fu);
+    }
+    int planted = 0;
+    for (uint32_t pos = 2; pos < LZP_BUF && !planted; pos++) {
+        for (uint32_t prev = 0; prev < 256u; prev++) {
+            if (netc_lzp_hash((uint8_t)prev, pos) == NETC_LZP_HT_MASK) {
+                s_lzp_src[pos - 1] = (uint8_t)prev;
+                planted = 1;
+                break;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(planted);
+
+    memset(s_lzp_ent, 0, sizeof(s_lzp_ent));
+    netc_lzp_pack(s_lzp, s_lzp_blk, s_lzp_ent);
+    s_lzp_views[0].blk = NULL;
+    s_lzp_views[0].ent = s_lzp;
+    s_lzp_views[1].blk = s_lzp_blk;
+    s_lzp_views[1].ent = s_lzp_ent;
+}
+
+void test_lzp_filter_matches_generic(void) {
+    /* 9.1 SIMD filter == generic, on the dense and the packed table */
+    static const size_t lens[] = { 0, 1, 2, 3, 5, 6, 9, 10, 17, 100, 1023, LZP_BUF };
+    static uint8_t out_g[LZP_BUF], out_s[LZP_BUF], out_a[LZP_BUF], out_d[LZP_BUF];
+    lzp_fixture_init();
+    for (int v = 0; v < 2; v++) {
+        const netc_lzp_table_t *t = &s_lzp_views[v];
+        for (int order2 = 0; order2 <= 1; order2++) {
+            for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+                size_t n = lens[l];
+                netc_lzp_xor_filter(s_lzp_src, n, t, NULL, order2, out_g);
+                netc_lzp_filter_generic(t, order2, s_lzp_src, out_s, n);
+                netc_lzp_filter_generic(&s_lzp_views[0], order2, s_lzp_src, out_d, n);
+                if (n == 0) continue;  /* no bytes written; nothing to compare */
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(out_g, out_s, n);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(out_d, out_s, n);
+                netc_lzp_filter_sse42(t, order2, s_lzp_src, out_s, n);
+                netc_lzp_filter_avx2 (t, order2, s_lzp_src, out_a, n);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(out_g, out_s, n);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(out_g, out_a, n);
+            }
+        }
+    }
+}
+
+void test_lzp_unfilter_roundtrip(void) {
+    /* 9.2 unfilter(filter(x)) == x in place, for any hint and layout */
+    static uint8_t buf[LZP_BUF], wrong[LZP_BUF];
+    lzp_fixture_init();
+    for (size_t i = 0; i < LZP_BUF; i++) wrong[i] = (uint8_t)(s_lzp_src[i] ^ 0x3Cu);
+    const uint8_t *hints[] = { NULL, s_lzp_src, wrong };
+    for (int v = 0; v < 2; v++) {
+        const netc_lzp_table_t *t = &s_lzp_views[v];
+        for (int order2 = 0; order2 <= 1; order2++) {
+            for (size_t k = 0; k < sizeof(hints) / sizeof(hints[0]); k++) {
+                for (size_t n = 1; n <= LZP_BUF; n += (n < 20U) ? 1U : 371U) {
+                    netc_lzp_filter_generic(t, order2, s_lzp_src, buf, n);
+                    netc_lzp_unfilter_generic(t, order2, buf, hints[k], buf, n);
+                    TEST_ASSERT_EQUAL_UINT8_ARRAY(s_lzp_src, buf, n);
+                }
+            }
+        }
+    }
+}
+
+void test_lzp_packed_matches_dense(void) {
+    /* 9.3 packed lookup == dense lookup in every slot */
+    lzp_fixture_init();
+    uint32_t count = netc_lzp_count(s_lzp);
+    TEST_ASSERT_EQUAL_UINT32(count, netc_lzp_pack_count(&s_lzp_views[1]));
+    for (uint32_t h = 0; h < NETC_LZP_HT_SIZE; h++) {
+        netc_lzp_entry_t d = netc_lzp_get(&s_lzp_views[0], h);
+        netc_lzp_entry_t p = netc_lzp_get(&s_lzp_views[1], h);
+        TEST_ASSERT_EQUAL_UINT8(d.valid, p.valid);
+        TEST_ASSERT_EQUAL_UINT8(d.valid ? d.value : 0u, p.value);
+    }
+    /* Padding past the last entry stays zero for the gathers */
+    TEST_ASSERT_EQUAL_UINT8(0, s_lzp_ent[count].valid);
+    TEST_ASSERT_EQUAL_UINT8(0, s_lzp_ent[count + 1].valid);
+}
+
 /* =========================================================================
  * main
  * ========================================================================= */
@@ -749,5 +1029,16 @@ int main(void) {
     RUN_TEST(test_ctx_simd_level_null_returns_zero);
     RUN_TEST(test_ctx_simd_level_generic_ctx);
 
+    /* 8. Mapped delta operators */
+    RUN_TEST(test_mapped_delta_matches_generic);
+    RUN_TEST(test_mapped_delta_decode_in_place);
+    RUN_TEST(test_delta_planes_match_generic);
+    RUN_TEST(test_match_count_matches_generic);
+
+    /* 9. LZP XOR filter */
+    RUN_TEST(test_lzp_filter_matches_generic);
+    RUN_TEST(test_lzp_unfilter_roundtrip);
+    RUN_TEST(test_lzp_packed_matches_dense);
+
     return UNITY_END();
 }
@@ -652,6 +652,7 @@ void test_e2e_128B_packet_compact_mode(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
@@ -701,6 +702,7 @@ void test_e2e_256B_packet_no_10bit(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
@@ -748,6 +750,7 @@ void test_e2e_legacy_header_no_10bit(void) {
     cfg.flags = NETC_CFG_FLAG_STATEFUL; /* NO compact header */
 
     netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
+    cfg.compression_level = 5;
     netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
 
     uint8_t test_pkt[64];
@@ -792,6 +795,7 @@ void test_e2e_multiple_packets_sequential(void) {
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_COMPACT_HDR;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
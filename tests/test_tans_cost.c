@@ -0,0 +1,284 @@
+/**
+ * test_tans_cost.c -- tANS cost-model estimator tests.
+ *
+ * Tests cover:
+ *   1. netc_tans_log2_q8 fixed-point accuracy
+ *   2. Per-table cost LUT filled by netc_tans_build
+ *   3. netc_tans_cost / _pctx / _pctx_bigram predict the encoded size
+ *   4. Invalid tables are reported as NETC_TANS_COST_INVALID
+ *   5. End-to-end round-trip across the estimate-selected encodings
+ */
+
+#include "unity.h"
+#include "../include/netc.h"
+#include "../src/algo/netc_tans.h"
+#include "../src/util/netc_bitstream.h"
+#include "../src/core/netc_internal.h"
+#include <string.h>
+#include <stdlib.h>
+
+#include "test_freq_util.h"
+
+void setUp(void)    {}
+void tearDown(void) {}
+
+/* Predictions ignore the tANS spread loss, so they run slightly low: allow
+ * 2 bytes plus 1/16 of the encoded size. */
+static int cost_close(size_t est, size_t actual) {
+    return est <= actual + 2u && actual <= est + 2u + actual / 16u;
+}
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+/* =========================================================================
+ * 1. log2 fixed point
+ * ========================================================================= */
+
+void test_log2_q8_powers_of_two(void) {
+    for (uint32_t n = 0; n <= 12; n++) {
+        TEST_ASSERT_EQUAL_UINT32(n << NETC_TANS_COST_SHIFT,
+                                 netc_tans_log2_q8(1u << n));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, netc_tans_log2_q8(0));
+}
+
+void test_log2_q8_known_values(void) {
+    /* floor(log2(v) * 256) */
+    TEST_ASSERT_EQUAL_UINT32(405,  netc_tans_log2_q8(3));
+    TEST_ASSERT_EQUAL_UINT32(850,  netc_tans_log2_q8(10));
+    TEST_ASSERT_EQUAL_UINT32(2551, netc_tans_log2_q8(1000));
+    TEST_ASSERT_EQUAL_UINT32(3071, netc_tans_log2_q8(4095));
+}
+
+void test_log2_q8_monotone(void) {
+    uint32_t prev = 0;
+    for (uint32_t v = 1; v <= NETC_TANS_TABLE_SIZE; v++) {
+        uint32_t l = netc_tans_log2_q8(v);
+        TEST_ASSERT_TRUE(l >= prev);
+        prev = l;
+    }
+}
+
+/* =========================================================================
+ * 2. Cost LUT
+ * ========================================================================= */
+
+void test_build_fills_cost_lut(void) {
+    netc_freq_table_t ft;
+    memset(&ft, 0, sizeof(ft));
+    ft.freq['A'] = 2048;
+    ft.freq['B'] = 1024;
+    ft.freq['C'] = 1023;
+    ft.freq['D'] = 1;
+
+    static netc_tans_table_t tbl;
+    TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&tbl, &ft));
+    TEST_ASSERT_EQUAL_UINT16(1u << NETC_TANS_COST_SHIFT,  tbl.cost['A']);
+    TEST_ASSERT_EQUAL_UINT16(2u << NETC_TANS_COST_SHIFT,  tbl.cost['B']);
+    TEST_ASSERT_EQUAL_UINT16(12u << NETC_TANS_COST_SHIFT, tbl.cost['D']);
+    TEST_ASSERT_TRUE(tbl.cost['C'] > tbl.cost['B']);
+    TEST_ASSERT_EQUAL_UINT16(NETC_TANS_COST_ABSENT, tbl.cost['Z']);
+}
+
+/* =========================================================================
+ * 3. Estimators vs actual encode
+ * ========================================================================= */
+
+void test_cost_predicts_single_table_encode(void) {
+    static netc_tans_table_t tbl;
+    static const size_t sizes[] = { 16, 64, 200, 512, 1500, 8000 };
+    for (uint32_t shift = 0; shift < 4; shift++) {
+        netc_freq_table_t ft;
+        make_skewed_freq(&ft, shift);
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&tbl, &ft));
+
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            uint8_t src[8000];
+            uint8_t buf[16384];
+            sample_from(&ft, src, sizes[k]);
+
+            netc_bsw_t bsw;
+            netc_bsw_init(&bsw, buf, sizeof(buf));
+            TEST_ASSERT_NOT_EQUAL_UINT32(0, netc_tans_encode(
+                &tbl, src, sizes[k], &bsw, NETC_TANS_TABLE_SIZE));
+            size_t actual = netc_bsw_flush(&bsw);
+
+            size_t est = netc_tans_cost_bytes(netc_tans_cost(&tbl, src, sizes[k]));
+            TEST_ASSERT_TRUE_MESSAGE(cost_close(est, actual),
+                                     "single-table estimate off");
+        }
+    }
+}
+
+void test_cost_ranks_tables(void) {
+    /* Data drawn from the skewed table must be cheaper under it than under
+     * a uniform table, and vice versa. */
+    static netc_tans_table_t skew, flat;
+    netc_freq_table_t ft_skew, ft_flat;
+    make_skewed_freq(&ft_skew, 0);
+    for (int s = 0; s < 256; s++) ft_flat.freq[s] = 16;
+    TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&skew, &ft_skew));
+    TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&flat, &ft_flat));
+
+    uint8_t src[512];
+    sample_from(&ft_skew, src, sizeof(src));
+    TEST_ASSERT_TRUE(netc_tans_cost(&skew, src, sizeof(src)) <
+                     netc_tans_cost(&flat, src, sizeof(src)));
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)xorshift32();
+    TEST_ASSERT_TRUE(netc_tans_cost(&flat, src, sizeof(src)) <
+                     netc_tans_cost(&skew, src, sizeof(src)));
+}
+
+void test_cost_pctx_predicts_encode(void) {
+    static netc_tans_table_t tables[NETC_CTX_COUNT];
+    netc_freq_table_t fts[4];
+    for (uint32_t v = 0; v < 4; v++) make_skewed_freq(&fts[v], v);
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&tables[b], &fts[b & 3u]));
+
+    static const size_t sizes[] = { 9, 40, 100, 300, 1200, 5000 };
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        uint8_t src[5000];
+        uint8_t buf[8192];
+        for (size_t i = 0; i < sizes[k]; i++)
+            sample_from(&fts[netc_ctx_bucket((uint32_t)i) & 3u], &src[i], 1);
+
+        netc_bsw_t bsw;
+        netc_bsw_init(&bsw, buf, sizeof(buf));
+        TEST_ASSERT_NOT_EQUAL_UINT32(0, netc_tans_encode_pctx(
+            tables, NULL, src, sizes[k], &bsw, NETC_TANS_TABLE_SIZE));
+        size_t actual = netc_bsw_flush(&bsw);
+
+        size_t est = netc_tans_cost_bytes(netc_tans_cost_pctx(tables, NULL, src, sizes[k]));
+        TEST_ASSERT_TRUE_MESSAGE(cost_close(est, actual),
+                                 "PCTX estimate off");
+    }
+}
+
+void test_cost_pctx_bigram_predicts_encode(void) {
+    static netc_tans_table_t unigram[NETC_CTX_COUNT];
+    static netc_tans_table_t bigram[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
+    static netc_bigram_set_t set;
+    uint8_t class_map[256];
+    netc_freq_table_t fts[4];
+    for (uint32_t v = 0; v < 4; v++) make_skewed_freq(&fts[v], v);
+    for (int s = 0; s < 256; s++) class_map[s] = (uint8_t)(s & 7);
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&unigram[b], &fts[0]));
+        /* Odd classes stay unbuilt to exercise the unigram fallback */
+        for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c += 2)
+            TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&bigram[b][c], &fts[(b + c) & 3u]));
+        for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c++)
+            set.t[b][c] = &bigram[b][c];
+    }
+
+    uint8_t src[2000];
+    uint8_t buf[4096];
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(xorshift32() & 0x1Fu);
+
+    const netc_bigram_set_t *cbigram = &set;
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, buf, sizeof(buf));
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, netc_tans_encode_pctx_bigram(
+        cbigram, unigram, class_map, NULL, src, sizeof(src), &bsw, NETC_TANS_TABLE_SIZE));
+    size_t actual = netc_bsw_flush(&bsw);
+
+    size_t est = netc_tans_cost_bytes(netc_tans_cost_pctx_bigram(
+        cbigram, unigram, class_map, NULL, src, sizeof(src)));
+    TEST_ASSERT_TRUE(cost_close(est, actual));
+}
+
+/* =========================================================================
+ * 4. Invalid tables
+ * ========================================================================= */
+
+void test_cost_invalid_tables(void) {
+    static netc_tans_table_t tables[NETC_CTX_COUNT];
+    memset(tables, 0, sizeof(tables));
+    uint8_t src[32] = {0};
+
+    TEST_ASSERT_EQUAL_UINT32(NETC_TANS_COST_INVALID,
+                             netc_tans_cost(&tables[0], src, sizeof(src)));
+    TEST_ASSERT_EQUAL_UINT32(NETC_TANS_COST_INVALID,
+                             netc_tans_cost_pctx(tables, NULL, src, sizeof(src)));
+    TEST_ASSERT_EQUAL_UINT32(NETC_TANS_COST_INVALID,
+                             netc_tans_cost(NULL, src, sizeof(src)));
+
+    /* Only buckets 0..2 built: a 24B packet is fine, a 25B one is not */
+    netc_freq_table_t ft;
+    make_skewed_freq(&ft, 1);
+    for (uint32_t b = 0; b < 3; b++)
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&tables[b], &ft));
+    uint8_t pkt[25] = {0};
+    TEST_ASSERT_NOT_EQUAL_UINT32(NETC_TANS_COST_INVALID,
+                                 netc_tans_cost_pctx(tables, NULL, pkt, 24));
+    TEST_ASSERT_EQUAL_UINT32(NETC_TANS_COST_INVALID,
+                             netc_tans_cost_pctx(tables, NULL, pkt, 25));
+}
+
+/* =========================================================================
+ * 5. End-to-end: estimate-selected encodings round-trip at every level
+ * ========================================================================= */
+
+void test_e2e_estimate_selection_roundtrip(void) {
+    enum { N_TRAIN = 100, N_PKT = 60 };
+    static uint8_t  storage[N_TRAIN][512];
+    static uint8_t *ptrs[N_TRAIN];
+    static size_t   sizes[N_TRAIN];
+    for (size_t i = 0; i < N_TRAIN; i++) {
+        sizes[i] = 16u + (i * 37u) % 480u;
+        ptrs[i]  = storage[i];
+        for (size_t j = 0; j < sizes[i]; j++)
+            storage[i][j] = (xorshift32() & 3u) ? (uint8_t)(j * 5u) : (uint8_t)xorshift32();
+    }
+    netc_dict_t *dict = NULL;
+    TEST_ASSERT_EQUAL(NETC_OK, netc_dict_train((const uint8_t * const *)ptrs,
+                                               sizes, N_TRAIN, 7, &dict));
+
+    static const uint8_t levels[] = { 0, 5, 7, 9 };
+    for (size_t l = 0; l < sizeof(levels); l++) {
+        netc_cfg_t cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA |
+                    NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR;
+        cfg.compression_level = levels[l];
+        netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
+        netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
+        TEST_ASSERT_NOT_NULL(enc);
+        TEST_ASSERT_NOT_NULL(dec);
+
+        for (size_t i = 0; i < N_PKT; i++) {
+            uint8_t cmp[512 + NETC_MAX_OVERHEAD];
+            uint8_t back[512];
+            size_t  csz = 0, dsz = 0;
+            const uint8_t *pkt = storage[i % N_TRAIN];
+            size_t         len = sizes[i % N_TRAIN];
+            TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, len,
+                                                     cmp, sizeof(cmp), &csz));
+            TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz,
+                                                       back, sizeof(back), &dsz));
+            TEST_ASSERT_EQUAL_size_t(len, dsz);
+            TEST_ASSERT_EQUAL_MEMORY(pkt, back, len);
+        }
+        netc_ctx_destroy(enc);
+        netc_ctx_destroy(dec);
+    }
+    netc_dict_free(dict);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_log2_q8_powers_of_two);
+    RUN_TEST(test_log2_q8_known_values);
+    RUN_TEST(test_log2_q8_monotone);
+    RUN_TEST(test_build_fills_cost_lut);
+    RUN_TEST(test_cost_predicts_single_table_encode);
+    RUN_TEST(test_cost_ranks_tables);
+    RUN_TEST(test_cost_pctx_predicts_encode);
+    RUN_TEST(test_cost_pctx_bigram_predicts_encode);
+    RUN_TEST(test_cost_invalid_tables);
+    RUN_TEST(test_e2e_estimate_selection_roundtrip);
+    return UNITY_END();
+}
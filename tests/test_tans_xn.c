@@ -0,0 +1,490 @@
+/**
+ * test_tans_xn.c -- interleaved PCTX tANS (X4 / X8) tests.
+ *
+ * Tests cover:
+ *   1. netc_tans_encode/decode_pctx_xn round-trip (unigram and bigram)
+ *   2. Interleaving costs under a byte per state in the bitstream
+ *   3. Corrupt / truncated input and bad arguments are rejected
+ *   4. Packed state prefix and compact packet types 0xD8-0xEF
+ *   5. Wide packets (>= NETC_TANS_X4_MIN) select X4/X8 and round-trip
+ *      through stateful, compact and stateless paths
+ *   6. The AVX2 X8 kernel (simd_level = AVX2) matches the scalar decoder,
+ *      and netc_bsr_tell / netc_bsr_seek resume a reader exactly
+ */
+
+#include "unity.h"
+#include "../include/netc.h"
+#include "../src/algo/netc_tans.h"
+#include "../src/util/netc_bitstream.h"
+#include "../src/core/netc_internal.h"
+#include "../src/simd/netc_simd.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define TEST_FREQ_SEED 0xA11CEu
+#include "test_freq_util.h"
+
+void setUp(void)    {}
+void tearDown(void) {}
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+#define MAX_SRC 5000u
+
+static netc_tans_table_t s_tables[NETC_CTX_COUNT];
+static netc_tans_table_t s_bigram[NETC_CTX_COUNT][NETC_BIGRAM_CTX_COUNT];
+static netc_bigram_set_t s_bigram_set;
+static netc_freq_table_t s_fts[4];
+static int s_built = 0;
+
+static void build_tables(void) {
+    if (s_built) return;
+    for (uint32_t k = 0; k < 4; k++) make_skewed_freq(&s_fts[k], k);
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++) {
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&s_tables[b], &s_fts[b & 3u]));
+        for (uint32_t c = 0; c < NETC_BIGRAM_CTX_COUNT; c++) {
+            TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&s_bigram[b][c],
+                                                     &s_fts[(b + c) & 3u]));
+            s_bigram_set.t[b][c] = &s_bigram[b][c];
+        }
+    }
+    s_built = 1;
+}
+
+static const netc_bigram_set_t *cbigram(void) {
+    return &s_bigram_set;
+}
+
+static const size_t k_sizes[] = { 1, 3, 4, 5, 7, 8, 9, 63, 64, 65,
+                                  1000, 1024, 1031, 4096, MAX_SRC };
+
+/* Encode src with n_states interleaved states into buf; returns stream size */
+static size_t encode_xn(const uint8_t *src, size_t n, uint32_t n_states,
+                        int bigram, uint8_t *buf, size_t cap, uint32_t *states) {
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, buf, cap);
+    int rc = bigram
+        ? netc_tans_encode_pctx_bigram_xn(cbigram(), s_tables, NULL, NULL, src, n,
+                                          &bsw, n_states, states)
+        : netc_tans_encode_pctx_xn(s_tables, NULL, src, n, &bsw, n_states, states);
+    TEST_ASSERT_EQUAL_INT(0, rc);
+    size_t bs = netc_bsw_flush(&bsw);
+    TEST_ASSERT_NOT_EQUAL(0, (int)(bs != (size_t)-1));
+    return bs;
+}
+
+static int decode_xn(const uint8_t *buf, size_t bs, uint8_t *dst, size_t n,
+                     uint32_t n_states, int bigram, const uint32_t *states) {
+    netc_bsr_t bsr;
+    netc_bsr_init(&bsr, buf, bs);
+    return bigram
+        ? netc_tans_decode_pctx_bigram_xn(cbigram(), s_tables, NULL, NULL, &bsr,
+                                          dst, n, n_states, states)
+        : netc_tans_decode_pctx_xn(s_tables, NULL, &bsr, dst, n, n_states, states);
+}
+
+static void roundtrip_all_sizes(int bigram) {
+    static uint8_t src[MAX_SRC], dst[MAX_SRC], buf[MAX_SRC + 64];
+    build_tables();
+    for (uint32_t n_states = 4; n_states <= 8; n_states += 4) {
+        for (size_t t = 0; t < sizeof(k_sizes) / sizeof(k_sizes[0]); t++) {
+            size_t n = k_sizes[t];
+            sample_from(&s_fts[t & 3u], src, n);
+            uint32_t states[NETC_TANS_MAX_STATES];
+            size_t bs = encode_xn(src, n, n_states, bigram, buf, sizeof(buf), states);
+            memset(dst, 0xEE, n);
+            TEST_ASSERT_EQUAL_INT(0, decode_xn(buf, bs, dst, n, n_states,
+                                               bigram, states));
+            TEST_ASSERT_EQUAL_MEMORY(src, dst, n);
+        }
+    }
+}
+
+/* =========================================================================
+ * 1. Round-trip
+ * ========================================================================= */
+
+void test_xn_roundtrip_unigram(void) { roundtrip_all_sizes(0); }
+void test_xn_roundtrip_bigram(void)  { roundtrip_all_sizes(1); }
+
+/* =========================================================================
+ * 2. Size overhead
+ * ========================================================================= */
+
+void test_xn_bitstream_close_to_single_state(void) {
+    static uint8_t src[4096], buf[4096 + 64];
+    build_tables();
+    sample_from(&s_fts[1], src, sizeof(src));
+
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, buf, sizeof(buf));
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, netc_tans_encode_pctx(
+        s_tables, NULL, src, sizeof(src), &bsw, NETC_TANS_TABLE_SIZE));
+    size_t bs1 = netc_bsw_flush(&bsw);
+
+    for (uint32_t n_states = 4; n_states <= 8; n_states += 4) {
+        uint32_t states[NETC_TANS_MAX_STATES];
+        size_t bsn = encode_xn(src, sizeof(src), n_states, 0, buf, sizeof(buf), states);
+        /* Per-symbol cost is unchanged; only the ANS rounding of each
+         * chain differs, under a byte per state. */
+        TEST_ASSERT_TRUE(bsn <= bs1 + n_states);
+    }
+}
+
+/* =========================================================================
+ * 3. Corrupt input and bad arguments
+ * ========================================================================= */
+
+void test_xn_truncated_stream_rejected(void) {
+    static uint8_t src[2048], dst[2048], buf[2048 + 64];
+    build_tables();
+    sample_from(&s_fts[0], src, sizeof(src));
+    for (uint32_t n_states = 4; n_states <= 8; n_states += 4) {
+        uint32_t states[NETC_TANS_MAX_STATES];
+        size_t bs = encode_xn(src, sizeof(src), n_states, 0, buf, sizeof(buf), states);
+        /* Dropping the oldest half of the stream underflows the reader */
+        TEST_ASSERT_EQUAL_INT(-1, decode_xn(buf + bs / 2, bs - bs / 2, dst,
+                                            sizeof(src), n_states, 0, states));
+        TEST_ASSERT_EQUAL_INT(-1, decode_xn(buf, 0, dst, sizeof(src),
+                                            n_states, 1, states));
+    }
+}
+
+void test_xn_bad_arguments_rejected(void) {
+    uint8_t src[64] = {0}, dst[64], buf[128];
+    uint32_t states[NETC_TANS_MAX_STATES];
+    build_tables();
+
+    netc_bsw_t bsw;
+    netc_bsw_init(&bsw, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(-1, netc_tans_encode_pctx_xn(s_tables, NULL, src, sizeof(src),
+                                                       &bsw, 2, states));
+    TEST_ASSERT_EQUAL_INT(-1, netc_tans_encode_pctx_xn(s_tables, NULL, src, 0,
+                                                       &bsw, 4, states));
+
+    size_t bs = encode_xn(src, sizeof(src), 4, 0, buf, sizeof(buf), states);
+    TEST_ASSERT_EQUAL_INT(-1, decode_xn(buf, bs, dst, sizeof(dst), 3, 0, states));
+    states[2] = NETC_TANS_TABLE_SIZE - 1u;
+    TEST_ASSERT_EQUAL_INT(-1, decode_xn(buf, bs, dst, sizeof(dst), 4, 0, states));
+    states[2] = 2u * NETC_TANS_TABLE_SIZE;
+    TEST_ASSERT_EQUAL_INT(-1, decode_xn(buf, bs, dst, sizeof(dst), 4, 0, states));
+
+    /* A symbol absent from its table cannot be encoded */
+    netc_freq_table_t sparse;
+    memset(&sparse, 0, sizeof(sparse));
+    sparse.freq[0] = NETC_TANS_TABLE_SIZE;
+    netc_tans_table_t one[NETC_CTX_COUNT];
+    for (uint32_t b = 0; b < NETC_CTX_COUNT; b++)
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_build(&one[b], &sparse));
+    src[17] = 1;
+    netc_bsw_init(&bsw, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(-1, netc_tans_encode_pctx_xn(one, NULL, src, sizeof(src),
+                                                       &bsw, 8, states));
+}
+
+/* =========================================================================
+ * 4. Compact packet types
+ * ========================================================================= */
+
+void test_state_count_thresholds(void) {
+    TEST_ASSERT_EQUAL_UINT32(1, netc_tans_pctx_states(NETC_TANS_X4_MIN - 1u));
+    TEST_ASSERT_EQUAL_UINT32(4, netc_tans_pctx_states(NETC_TANS_X4_MIN));
+    TEST_ASSERT_EQUAL_UINT32(4, netc_tans_pctx_states(NETC_TANS_X8_MIN - 1u));
+    TEST_ASSERT_EQUAL_UINT32(8, netc_tans_pctx_states(NETC_TANS_X8_MIN));
+    TEST_ASSERT_EQUAL_UINT32(8, netc_tans_pctx_states(NETC_MAX_PACKET_SIZE));
+}
+
+void test_xn_state_packing(void) {
+    uint32_t in[NETC_TANS_MAX_STATES], out[NETC_TANS_MAX_STATES];
+    uint8_t  buf[NETC_TANS_XN_STATE_BYTES(NETC_TANS_MAX_STATES) + 1];
+    TEST_ASSERT_EQUAL_size_t(6, NETC_TANS_XN_STATE_BYTES(4));
+    TEST_ASSERT_EQUAL_size_t(12, NETC_TANS_XN_STATE_BYTES(8));
+    for (uint32_t r = 0; r < 1000; r++) {
+        for (uint32_t k = 0; k < NETC_TANS_MAX_STATES; k++)
+            in[k] = NETC_TANS_TABLE_SIZE + (xorshift32() & (NETC_TANS_TABLE_SIZE - 1u));
+        in[r & 7u] = (r & 8u) ? 2u * NETC_TANS_TABLE_SIZE - 1u : NETC_TANS_TABLE_SIZE;
+        buf[sizeof(buf) - 1] = 0xA5;
+        netc_tans_xn_states_write(buf, in, NETC_TANS_MAX_STATES);
+        netc_tans_xn_states_read(buf, out, NETC_TANS_MAX_STATES);
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(in, out, NETC_TANS_MAX_STATES);
+        TEST_ASSERT_EQUAL_HEX8(0xA5, buf[sizeof(buf) - 1]);
+    }
+}
+
+void test_compact_pctx_types_roundtrip(void) {
+    /* Every PCTX type (1, 4 and 8 states) re-encodes to itself */
+    for (uint32_t t = 0; t < 256; t++) {
+        const netc_pkt_type_entry_t *e = &netc_pkt_type_table[t];
+        if (e->flags == 0xFF || (e->algorithm & 0x0Fu) != NETC_ALG_TANS_PCTX)
+            continue;
+        TEST_ASSERT_EQUAL_HEX8(t, netc_compact_type_encode(e->flags, e->algorithm));
+        uint32_t n = netc_pctx_alg_states(e->algorithm);
+        uint32_t want = (t >= 0xE4u && t <= 0xEFu) ? 8u
+                      : (t >= 0xD8u && t <= 0xE3u) ? 4u : 1u;
+        TEST_ASSERT_EQUAL_UINT32(want, n);
+    }
+    /* 0xF6-0xFE stay reserved (0xF0-0xF5 are static rANS) */
+    for (uint32_t t = 0xF6u; t < 0xFFu; t++) {
+        TEST_ASSERT_EQUAL_HEX8(0, netc_pkt_type_table[t].algorithm);
+    }
+    /* X4 and X8 together is not a valid algorithm byte */
+    TEST_ASSERT_EQUAL_UINT32(0, netc_pctx_alg_states(
+        NETC_ALG_TANS_PCTX | NETC_PCTX_X4 | NETC_PCTX_X8));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, netc_compact_type_encode(
+        NETC_PKT_FLAG_DICT_ID, NETC_ALG_TANS_PCTX | NETC_PCTX_X4 | NETC_PCTX_X8));
+}
+
+/* =========================================================================
+ * 5. End-to-end wide packets
+ * ========================================================================= */
+
+#define TRAIN_COUNT 64
+#define STREAM_N    24
+
+static netc_dict_t *s_dict = NULL;
+
+/* Snapshot-like packet: repeated 32-byte entity records with slow drift */
+static void fill_snapshot(uint8_t *p, size_t n, uint32_t tick) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r = xorshift32();
+        size_t   f = i & 31u;
+        if (f < 4)        p[i] = (uint8_t)(i >> 5);              /* entity id */
+        else if (f < 8)   p[i] = (uint8_t)((tick + f) & 0x0Fu);  /* tick */
+        else if (f < 20)  p[i] = (uint8_t)(0x40u + (r & 7u));    /* position */
+        else if ((r & 3u) == 0) p[i] = (uint8_t)(r >> 8);        /* noise */
+        else              p[i] = 0;
+    }
+}
+
+static void ensure_dict(void) {
+    if (s_dict != NULL) return;
+    static uint8_t  storage[TRAIN_COUNT][MAX_SRC];
+    static uint8_t *ptrs[TRAIN_COUNT];
+    static size_t   sizes[TRAIN_COUNT];
+    for (size_t i = 0; i < TRAIN_COUNT; i++) {
+        sizes[i] = 512u + (i % 8u) * 512u;
+        ptrs[i]  = storage[i];
+        fill_snapshot(ptrs[i], sizes[i], (uint32_t)i);
+    }
+    TEST_ASSERT_EQUAL(NETC_OK, netc_dict_train((const uint8_t * const *)ptrs,
+                                               sizes, TRAIN_COUNT, 5, &s_dict));
+}
+
+static const size_t k_wide[] = { 1023, 1024, 1500, 2047, 2048, 3000, 4096 };
+
+/* Returns the number of packets that used an interleaved PCTX encoding. */
+static size_t run_wide_stream(uint32_t flags) {
+    ensure_dict();
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | flags;
+    cfg.compression_level = 5;
+    netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
+    netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    int    compact = (flags & NETC_CFG_FLAG_COMPACT_HDR) != 0;
+    size_t used_xn = 0;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        static uint8_t pkt[MAX_SRC], cmp[MAX_SRC + NETC_MAX_OVERHEAD], back[MAX_SRC];
+        size_t n = k_wide[(i / 3u) % (sizeof(k_wide) / sizeof(k_wide[0]))];
+        fill_snapshot(pkt, n, (uint32_t)(i / 3u));
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, n, cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(n, dsz);
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, n);
+
+        uint8_t alg = compact ? netc_pkt_type_table[cmp[0]].algorithm : cmp[5];
+        if ((alg & 0x0Fu) == NETC_ALG_TANS_PCTX) {
+            /* PCTX always follows the size rule */
+            TEST_ASSERT_EQUAL_UINT32(netc_tans_pctx_states(n), netc_pctx_alg_states(alg));
+            if (n >= NETC_TANS_X4_MIN) used_xn++;
+        }
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    return used_xn;
+}
+
+void test_wide_packets_roundtrip(void) {
+    static const uint32_t flag_sets[] = {
+        0,
+        NETC_CFG_FLAG_DELTA,
+        NETC_CFG_FLAG_COMPACT_HDR,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_COMPACT_HDR,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_COMPACT_HDR,
+        NETC_CFG_FLAG_DELTA | NETC_CFG_FLAG_BIGRAM | NETC_CFG_FLAG_ADAPTIVE,
+    };
+    size_t used = 0;
+    for (size_t f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); f++) {
+        used += run_wide_stream(flag_sets[f]);
+    }
+    TEST_ASSERT_TRUE(used > 0);
+}
+
+void test_wide_packets_stateless_roundtrip(void) {
+    static uint8_t pkt[MAX_SRC], cmp[MAX_SRC + NETC_MAX_OVERHEAD], back[MAX_SRC];
+    ensure_dict();
+    size_t used_xn = 0;
+    for (size_t t = 0; t < sizeof(k_wide) / sizeof(k_wide[0]); t++) {
+        size_t n = k_wide[t];
+        fill_snapshot(pkt, n, (uint32_t)t);
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress_stateless(s_dict, pkt, n,
+                                                           cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress_stateless(s_dict, cmp, csz,
+                                                             back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(n, dsz);
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, n);
+        if ((cmp[5] & 0x0Fu) == NETC_ALG_TANS_PCTX &&
+            netc_pctx_alg_states(cmp[5]) > 1u)
+            used_xn++;
+    }
+    TEST_ASSERT_TRUE(used_xn > 0);
+}
+
+/* =========================================================================
+ * 6. SIMD X8 kernel
+ * ========================================================================= */
+
+void test_bsr_tell_seek_resumes(void) {
+    static uint8_t buf[512];
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)xorshift32();
+    buf[sizeof(buf) - 1] |= 0x80u;  /* sentinel */
+
+    for (int skip = 0; skip < 200; skip += 13) {
+        netc_bsr_t a, b;
+        netc_bsr_init(&a, buf, sizeof(buf));
+        netc_bsr_init(&b, buf, sizeof(buf));
+        for (int k = 0; k < skip; k++) {
+            netc_bsr_refill(&a);
+            netc_bsr_refill(&b);
+            (void)netc_bsr_take(&a, 7);
+            (void)netc_bsr_take(&b, 7);
+        }
+        netc_bsr_seek(&b, netc_bsr_tell(&b));
+        TEST_ASSERT_EQUAL_size_t(netc_bsr_tell(&a), netc_bsr_tell(&b));
+        while (netc_bsr_tell(&a) >= 11U) {
+            netc_bsr_refill(&a);
+            netc_bsr_refill(&b);
+            TEST_ASSERT_EQUAL_UINT32(netc_bsr_take(&a, 11), netc_bsr_take(&b, 11));
+        }
+    }
+}
+
+static int avx2_ops(netc_simd_ops_t *ops) {
+    netc_simd_ops_init(ops, NETC_SIMD_LEVEL_AVX2);
+    return ops->tans_decode_x8 != NULL;
+}
+
+void test_x8_kernel_matches_scalar(void) {
+    static const size_t sizes[] = { 15, 16, 17, 24, 100, 511, 512, 777,
+                                    1024, 2048, 4095, 4096, 4100, MAX_SRC };
+    static uint8_t src[MAX_SRC], ref[MAX_SRC], out[MAX_SRC], buf[MAX_SRC + 64];
+    netc_simd_ops_t ops;
+    if (!avx2_ops(&ops)) TEST_IGNORE_MESSAGE("AVX2 not available");
+    build_tables();
+
+    for (size_t t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++) {
+        size_t n = sizes[t];
+        sample_from(&s_fts[t & 3u], src, n);
+        uint32_t states[NETC_TANS_MAX_STATES];
+        size_t bs = encode_xn(src, n, 8U, 0, buf, sizeof(buf), states);
+
+        TEST_ASSERT_EQUAL_INT(0, decode_xn(buf, bs, ref, n, 8U, 0, states));
+        netc_bsr_t bsr;
+        netc_bsr_init(&bsr, buf, bs);
+        memset(out, 0xEE, n);
+        TEST_ASSERT_EQUAL_INT(0, netc_tans_decode_pctx_xn_simd(
+            s_tables, NULL, &bsr, out, n, 8U, states, &ops));
+        TEST_ASSERT_EQUAL_MEMORY(ref, out, n);
+        TEST_ASSERT_EQUAL_MEMORY(src, out, n);
+
+        /* Truncation is still caught by the scalar tail */
+        netc_bsr_init(&bsr, buf + bs / 2, bs - bs / 2);
+        if (n >= 512)
+            TEST_ASSERT_EQUAL_INT(-1, netc_tans_decode_pctx_xn_simd(
+                s_tables, NULL, &bsr, out, n, 8U, states, &ops));
+    }
+}
+
+void test_x8_kernel_stops_near_stream_start(void) {
+    uint8_t  buf[32] = {0}, dst[8];
+    uint32_t X[8];
+    netc_simd_ops_t ops;
+    if (!avx2_ops(&ops)) TEST_IGNORE_MESSAGE("AVX2 not available");
+    build_tables();
+    for (uint32_t k = 0; k < 8; k++) X[k] = NETC_TANS_TABLE_SIZE;
+    size_t pos = NETC_TANS_X8_KERNEL_MIN_BITS - 1U;
+    TEST_ASSERT_EQUAL_size_t(0, ops.tans_decode_x8(
+        (const uint32_t *)s_tables[0].decode, buf, &pos, X, dst, 4));
+    TEST_ASSERT_EQUAL_size_t(NETC_TANS_X8_KERNEL_MIN_BITS - 1U, pos);
+}
+
+void test_x8_auto_level_uses_scalar(void) {
+    netc_simd_ops_t ops;
+    netc_simd_ops_init(&ops, NETC_SIMD_LEVEL_AUTO);
+    TEST_ASSERT_NULL(ops.tans_decode_x8);
+    netc_simd_ops_init(&ops, NETC_SIMD_LEVEL_GENERIC);
+    TEST_ASSERT_NULL(ops.tans_decode_x8);
+}
+
+/* Encoder on auto-detect, decoder forced to AVX2: identical output. */
+void test_wide_packets_avx2_decoder(void) {
+    static uint8_t pkt[MAX_SRC], cmp[MAX_SRC + NETC_MAX_OVERHEAD], back[MAX_SRC];
+    netc_simd_ops_t ops;
+    if (!avx2_ops(&ops)) TEST_IGNORE_MESSAGE("AVX2 not available");
+    ensure_dict();
+    netc_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = NETC_CFG_FLAG_STATEFUL | NETC_CFG_FLAG_DELTA;
+    cfg.compression_level = 5;
+    netc_ctx_t *enc = netc_ctx_create(s_dict, &cfg);
+    cfg.simd_level = NETC_SIMD_LEVEL_AVX2;
+    netc_ctx_t *dec = netc_ctx_create(s_dict, &cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+    TEST_ASSERT_NOT_NULL(dec);
+
+    size_t used_x8 = 0;
+    for (size_t i = 0; i < STREAM_N; i++) {
+        size_t n = (i & 1u) ? MAX_SRC : 4096u + (i * 37u) % 800u;
+        fill_snapshot(pkt, n, (uint32_t)(i / 3u));
+        size_t csz = 0, dsz = 0;
+        TEST_ASSERT_EQUAL(NETC_OK, netc_compress(enc, pkt, n, cmp, sizeof(cmp), &csz));
+        TEST_ASSERT_EQUAL(NETC_OK, netc_decompress(dec, cmp, csz, back, sizeof(back), &dsz));
+        TEST_ASSERT_EQUAL_size_t(n, dsz);
+        TEST_ASSERT_EQUAL_MEMORY(pkt, back, n);
+        if ((cmp[5] & 0x0Fu) == NETC_ALG_TANS_PCTX &&
+            netc_pctx_alg_states(cmp[5]) == 8u)
+            used_x8++;
+    }
+    netc_ctx_destroy(enc);
+    netc_ctx_destroy(dec);
+    TEST_ASSERT_TRUE(used_x8 > 0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_xn_roundtrip_unigram);
+    RUN_TEST(test_xn_roundtrip_bigram);
+    RUN_TEST(test_xn_bitstream_close_to_single_state);
+    RUN_TEST(test_xn_truncated_stream_rejected);
+    RUN_TEST(test_xn_bad_arguments_rejected);
+    RUN_TEST(test_state_count_thresholds);
+    RUN_TEST(test_xn_state_packing);
+    RUN_TEST(test_compact_pctx_types_roundtrip);
+    RUN_TEST(test_wide_packets_roundtrip);
+    RUN_TEST(test_wide_packets_stateless_roundtrip);
+    RUN_TEST(test_bsr_tell_seek_resumes);
+    RUN_TEST(test_x8_kernel_matches_scalar);
+    RUN_TEST(test_x8_kernel_stops_near_stream_start);
+    RUN_TEST(test_x8_auto_level_uses_scalar);
+    RUN_TEST(test_wide_packets_avx2_decoder);
+    int result = UNITY_END();
+    netc_dict_free(s_dict);
+    return result;
+}
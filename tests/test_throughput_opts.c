@@ -111,6 +111,18 @@ void test_bucket_boundaries_exact(void)
     TEST_ASSERT_EQUAL_UINT32(15U, netc_ctx_bucket(65535));
 }
 
+void test_bucket_start_inverts_bucket_of(void)
+{
+    const netc_bucket_map_t *m = &netc_bucket_map_default;
+    TEST_ASSERT_EQUAL_UINT32(0U, netc_bucket_start(m, 0));
+    TEST_ASSERT_EQUAL_UINT32(65536U, netc_bucket_start(m, NETC_CTX_COUNT));
+    for (uint32_t b = 1; b < NETC_CTX_COUNT; b++) {
+        uint32_t start = netc_bucket_start(m, b);
+        TEST_ASSERT_EQUAL_UINT32(b, netc_bucket_of(m, start));
+        TEST_ASSERT_EQUAL_UINT32(b - 1U, netc_bucket_of(m, start - 1U));
+    }
+}
+
 /* =========================================================================
  * T.3 — Round-trip after all optimisation changes
  *
@@ -139,6 +151,7 @@ static void do_roundtrip(const uint8_t *pkt, size_t pkt_sz,
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = cfg_flags;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
@@ -227,6 +240,7 @@ void test_roundtrip_with_delta(void)
     netc_cfg_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.flags = flags;
+    cfg.compression_level = 5;
 
     netc_ctx_t *enc = netc_ctx_create(dict, &cfg);
     netc_ctx_t *dec = netc_ctx_create(dict, &cfg);
@@ -343,6 +357,7 @@ void test_fast_compress_decompressor_ignores_flag(void)
     memset(&enc_cfg, 0, sizeof(enc_cfg));
     memset(&dec_cfg, 0, sizeof(dec_cfg));
     enc_cfg.flags = enc_flags;
+    enc_cfg.compression_level = 5;
     dec_cfg.flags = dec_flags;
 
     netc_ctx_t *enc = netc_ctx_create(dict, &enc_cfg);
@@ -378,6 +393,7 @@ int main(void)
     RUN_TEST(test_bucket_lut_matches_if_ladder_0_to_255);
     RUN_TEST(test_bucket_lut_matches_if_ladder_256_to_65535);
     RUN_TEST(test_bucket_boundaries_exact);
+    RUN_TEST(test_bucket_start_inverts_bucket_of);
 
     /* T.3 — round-trip after optimisations */
     RUN_TEST(test_roundtrip_32B_compact);